@@ -150,6 +150,28 @@ typedef struct {
     CdiAvmExtraData avm_extra_data;
 } CdiAvmTxPayloadConfig;
 
+/**
+ * @brief A structure used to describe a single payload transmitted by CdiAvmEndpointTxPayloads(). The members have the
+ * same meaning as the parameters of CdiAvmEndpointTxPayload().
+ */
+typedef struct {
+    /// @brief Endpoint handle returned by a previous call to CdiAvmTxStreamEndpointCreate().
+    CdiEndpointHandle endpoint_handle;
+
+    /// @brief Pointer to payload configuration data.
+    const CdiAvmTxPayloadConfig* payload_config_ptr;
+
+    /// @brief Optional pointer to configuration data that describes the contents of this payload and subsequent
+    /// payloads of the same stream.
+    const CdiAvmConfig* avm_config_ptr;
+
+    /// @brief Scatter-gather list containing the data to be transmitted.
+    const CdiSgList* sgl_ptr;
+
+    /// @brief Maximum latency in microseconds.
+    int max_latency_microsecs;
+} CdiAvmEndpointTxPayloadEntry;
+
 /**
  * @brief A structure of this type is passed as the parameter to CdiAvmRxCallback(). It contains a single payload sent
  * from a transmitter.
@@ -222,6 +244,14 @@ typedef struct {
     /// to this stream. If NULL, a name is internally generated. Length of name must not exceed
     /// CDI_MAX_STREAM_NAME_STRING_LENGTH.
     const char* stream_name_str;
+
+    /// @brief Priority of the stream relative to the other streams of the connection. Payloads of a stream with a
+    /// higher value are started before waiting payloads of streams with a lower value. They also interrupt a payload of
+    /// a lower priority stream that is being sent, so the packets of a small payload such as audio are interleaved with
+    /// those of a large video frame instead of waiting for the whole frame. The interrupted payload resumes once the
+    /// higher priority payload has been queued to the adapter. Use zero (default) for all streams to send payloads in
+    /// the order they are queued.
+    int priority;
 } CdiTxConfigDataStream;
 
 //*********************************************************************************************************************
@@ -401,4 +431,97 @@ CDI_INTERFACE CdiReturnStatus CdiAvmEndpointTxPayload(CdiEndpointHandle endpoint
                                                       const CdiAvmConfig* avm_config_ptr, const CdiSgList* sgl_ptr,
                                                       int max_latency_microsecs);
 
+/**
+ * Transmit a batch of payloads to one or more remote endpoints of the same connection. This is equivalent to calling
+ * CdiAvmEndpointTxPayload() for each entry in the array, but the payloads are validated in a single pass and are put in
+ * the connection's payload queue using a single queue operation, which wakes up the connection's transmit logic once
+ * for the whole batch. This reduces the per-payload overhead when many small payloads, such as audio, are sent at the
+ * same time across several streams. Payloads are sent in array order.
+ *
+ * The same MEMORY NOTE as for CdiAvmEndpointTxPayload() applies to each entry.
+ *
+ * @param entry_array Array of payloads to transmit. All of the endpoint handles must belong to the same connection.
+ * @param count Number of entries in entry_array.
+ * @param ret_status_array Optional array of count entries where the status of each payload is written. A payload was
+ *                         queued for transmission only if its status is kCdiStatusOk, in which case the registered
+ *                         CdiAvmTxCallback() will be invoked for it. Pass NULL if not needed.
+ *
+ * @return kCdiStatusOk if all of the payloads were queued for transmission, otherwise the status of the first payload
+ *         that was not.
+ */
+CDI_INTERFACE CdiReturnStatus CdiAvmEndpointTxPayloads(const CdiAvmEndpointTxPayloadEntry* entry_array, int count,
+                                                       CdiReturnStatus* ret_status_array);
+
+/**
+ * Open a payload whose data is provided in parts while it is being transmitted, such as a video frame that is produced
+ * in horizontal slices. The payload is queued for transmission right away and its packets are sent as soon as enough
+ * data has been appended with CdiAvmTxPayloadAppend(), instead of waiting for the whole payload. The connection must
+ * have been created with CdiAvmTxCreate(). Connections that were created by calling CdiAvmTxStreamConnectionCreate()
+ * must use CdiAvmEndpointTxPayloadOpen() instead.
+ *
+ * Other payloads of the connection are sent while an open payload is waiting for data, but a payload that is left
+ * waiting holds up the packets of other payloads of its stream, so all of its data must be appended promptly. The
+ * maximum latency is measured from the time the payload is opened.
+ *
+ * @param con_handle Connection handle returned by a previous call to CdiAvmTxCreate().
+ * @param payload_config_ptr Pointer to payload configuration data. See CdiAvmTxPayload().
+ * @param avm_config_ptr Pointer to configuration data that describes the contents of this payload. See
+ *                       CdiAvmTxPayload().
+ * @param total_data_size Size in bytes of the whole payload. Must be greater than zero.
+ * @param max_latency_microsecs Maximum latency in microseconds. See CdiAvmTxPayload().
+ * @param ret_payload_handle_ptr Pointer to returned payload handle, used with CdiAvmTxPayloadAppend().
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CDI_INTERFACE CdiReturnStatus CdiAvmTxPayloadOpen(CdiConnectionHandle con_handle,
+                                                  const CdiAvmTxPayloadConfig* payload_config_ptr,
+                                                  const CdiAvmConfig* avm_config_ptr, int total_data_size,
+                                                  int max_latency_microsecs,
+                                                  CdiTxPayloadHandle* ret_payload_handle_ptr);
+
+/**
+ * Open a payload whose data is provided in parts while it is being transmitted to a remote endpoint. This is the same
+ * as CdiAvmTxPayloadOpen() for endpoints obtained through CdiAvmTxStreamEndpointCreate().
+ *
+ * @param endpoint_handle Endpoint handle returned by a previous call to CdiAvmTxStreamEndpointCreate().
+ * @param payload_config_ptr Pointer to payload configuration data. See CdiAvmEndpointTxPayload().
+ * @param avm_config_ptr Pointer to configuration data that describes the contents of this payload. See
+ *                       CdiAvmEndpointTxPayload().
+ * @param total_data_size Size in bytes of the whole payload. Must be greater than zero.
+ * @param max_latency_microsecs Maximum latency in microseconds. See CdiAvmEndpointTxPayload().
+ * @param ret_payload_handle_ptr Pointer to returned payload handle, used with CdiAvmTxPayloadAppend().
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CDI_INTERFACE CdiReturnStatus CdiAvmEndpointTxPayloadOpen(CdiEndpointHandle endpoint_handle,
+                                                          const CdiAvmTxPayloadConfig* payload_config_ptr,
+                                                          const CdiAvmConfig* avm_config_ptr, int total_data_size,
+                                                          int max_latency_microsecs,
+                                                          CdiTxPayloadHandle* ret_payload_handle_ptr);
+
+/**
+ * Append data to the end of a payload opened with CdiAvmTxPayloadOpen() or CdiAvmEndpointTxPayloadOpen(). Data can be
+ * appended in parts of any size until the payload's total_data_size has been reached. Only one thread may append data
+ * to a given payload.
+ *
+ * MEMORY NOTE: The CdiSgList and SGL entries memory can be modified or released immediately after the function returns.
+ * However, the buffers pointed to in the SGL must not be modified or released until after the CdiAvmTxCallback() for
+ * the payload has occurred.
+ *
+ * Once the last part of the payload has been appended, or the payload was dropped or flushed (for example because its
+ * maximum latency was exceeded or the connection went down), appending more data through the handle fails with
+ * kCdiStatusInvalidHandle. The CdiAvmTxCallback() for the payload reports why it was not sent. The handle must not be
+ * used after the connection has been destroyed.
+ *
+ * @param payload_handle Payload handle returned by CdiAvmTxPayloadOpen() or CdiAvmEndpointTxPayloadOpen().
+ * @param sgl_ptr Scatter-gather list containing the next part of the payload's data. The addresses in the SGL must
+ *                point to locations that reside within the memory region specified in CdiAdapterData at
+ *                ret_tx_buffer_ptr.
+ *
+ * @return A value from the CdiReturnStatus enumeration. kCdiStatusInvalidParameter is returned if the data would
+ *         exceed the payload's total_data_size, in which case none of it is appended. kCdiStatusInvalidHandle is
+ *         returned if data can no longer be appended to the payload.
+ */
+CDI_INTERFACE CdiReturnStatus CdiAvmTxPayloadAppend(CdiTxPayloadHandle payload_handle, const CdiSgList* sgl_ptr);
+
 #endif // CDI_AVM_API_H__
@@ -0,0 +1,131 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+#ifndef CDI_COMPLETION_QUEUE_API_H__
+#define CDI_COMPLETION_QUEUE_API_H__
+
+/**
+ * @file
+ * @brief
+ * This file declares the public API data types, structures and functions of the CDI completion queue. A completion
+ * queue is an alternative to the registered user RX/TX payload callback functions. Instead of the SDK invoking a
+ * callback function from one of its own threads, events are pushed to the completion queue and the application drains
+ * them in batches from its own thread using CdiCompletionQueuePoll(). A file descriptor is provided so the queue can be
+ * added to an application's epoll() based event loop.
+ *
+ * A completion queue is associated with a connection by setting completion_queue_handle in CdiRxConfigData or
+ * CdiTxConfigData before creating the connection. Any number of Tx and Rx connections can share a single completion
+ * queue. The queue must not be destroyed until all of the connections that use it have been closed.
+ */
+
+#include "cdi_avm_api.h"
+#include "cdi_core_api.h"
+#include "cdi_raw_api.h"
+
+//*********************************************************************************************************************
+//***************************************** START OF DEFINITIONS AND TYPES ********************************************
+//*********************************************************************************************************************
+
+/// @brief Maximum length of the error message string that is returned with a completion event, including the
+/// terminating NUL character. Longer messages are truncated.
+#define CDI_COMPLETION_EVENT_MAX_ERROR_STRING_LENGTH    (256)
+
+/// @brief Default number of events that a completion queue can hold. Used if 0 is passed to
+/// CdiCompletionQueueCreate().
+#define CDI_COMPLETION_QUEUE_DEFAULT_DEPTH              (256)
+
+/**
+ * @brief Type of event returned by CdiCompletionQueuePoll(). The value determines which member of
+ * CdiCompletionEvent.cb_data is valid.
+ */
+typedef enum {
+    kCdiCompletionEventRawRx, ///< Payload received on a RAW connection. Use cb_data.raw_rx.
+    kCdiCompletionEventAvmRx, ///< Payload received on an AVM connection. Use cb_data.avm_rx.
+    kCdiCompletionEventRawTx, ///< Payload transmit completed on a RAW connection. Use cb_data.raw_tx.
+    kCdiCompletionEventAvmTx, ///< Payload transmit completed on an AVM connection. Use cb_data.avm_tx.
+} CdiCompletionEventType;
+
+/**
+ * @brief A single event returned by CdiCompletionQueuePoll(). The data in cb_data is the same data that would have
+ * been passed to the registered user callback function of the connection and the same rules apply to it. In
+ * particular, the scatter-gather list of a received payload must be freed using CdiCoreRxFreeBuffer().
+ */
+typedef struct {
+    /// @brief Type of event. Determines which member of cb_data is valid.
+    CdiCompletionEventType event_type;
+
+    /// @brief Callback data for the event.
+    union {
+        CdiRawRxCbData raw_rx; ///< Valid if event_type is kCdiCompletionEventRawRx.
+        CdiAvmRxCbData avm_rx; ///< Valid if event_type is kCdiCompletionEventAvmRx.
+        CdiRawTxCbData raw_tx; ///< Valid if event_type is kCdiCompletionEventRawTx.
+        CdiAvmTxCbData avm_tx; ///< Valid if event_type is kCdiCompletionEventAvmTx.
+    } cb_data;
+
+    /// @brief Storage for the AVM configuration structure of a kCdiCompletionEventAvmRx event. If a configuration
+    /// structure was received with the payload, cb_data.avm_rx.config_ptr points here.
+    CdiAvmConfig avm_config;
+
+    /// @brief Storage for the error message of the event. If the event has an error message, the err_msg_str member of
+    /// the event's core callback data points here.
+    char err_msg_array[CDI_COMPLETION_EVENT_MAX_ERROR_STRING_LENGTH];
+} CdiCompletionEvent;
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+/**
+ * Create a completion queue. The queue can be used by any number of connections (see completion_queue_handle in
+ * CdiRxConfigData and CdiTxConfigData).
+ *
+ * @param depth Maximum number of events the queue can hold. Use 0 for CDI_COMPLETION_QUEUE_DEFAULT_DEPTH. If the queue
+ *              is full when the SDK needs to push a Tx payload completion, the completion waits until the application
+ *              polls the queue. While completions wait, those of later payloads back up inside the connection, and
+ *              once that internal queue is full the connection's Tx payload functions return kCdiStatusQueueFull.
+ *              If the queue is full when the SDK needs to push a received payload, the event is dropped, an error is
+ *              logged and the payload's buffer is freed by the SDK.
+ * @param ret_handle_ptr Pointer to returned completion queue handle.
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CDI_INTERFACE CdiReturnStatus CdiCompletionQueueCreate(int depth, CdiCompletionQueueHandle* ret_handle_ptr);
+
+/**
+ * Destroy a completion queue. All connections that use the queue must have been closed first. Any events remaining in
+ * the queue are discarded. NOTE: Buffers of received payloads that were not polled are not freed.
+ *
+ * @param handle Completion queue handle returned by CdiCompletionQueueCreate().
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CDI_INTERFACE CdiReturnStatus CdiCompletionQueueDestroy(CdiCompletionQueueHandle handle);
+
+/**
+ * Get the file descriptor of a completion queue. The file descriptor becomes readable whenever the queue is not empty,
+ * so it can be added to an epoll() set. The application must not read from, write to or close it. It is cleared by
+ * CdiCompletionQueuePoll(). Only supported on Linux.
+ *
+ * @param handle Completion queue handle returned by CdiCompletionQueueCreate().
+ *
+ * @return The file descriptor or -1 if not supported.
+ */
+CDI_INTERFACE int CdiCompletionQueueGetFd(CdiCompletionQueueHandle handle);
+
+/**
+ * Remove up to max_events events from a completion queue without blocking. This function must only be called from a
+ * single thread at a time.
+ *
+ * @param handle Completion queue handle returned by CdiCompletionQueueCreate().
+ * @param event_array Pointer to array where the events are written.
+ * @param max_events Number of entries in event_array.
+ *
+ * @return The number of events written to event_array. Zero if the queue is empty and -1 if a parameter is invalid.
+ */
+CDI_INTERFACE int CdiCompletionQueuePoll(CdiCompletionQueueHandle handle, CdiCompletionEvent* event_array,
+                                         int max_events);
+
+#endif // CDI_COMPLETION_QUEUE_API_H__
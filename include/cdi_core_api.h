@@ -90,7 +90,8 @@
 /// For Protocol version 2.1 (CDI_PROTOCOL_VERSION.CDI_PROTOCOL_MAJOR_VERSION):
 /// 4: SDK 2.2.x. Supports bidirectional sockets for probe control interface. Logic added to maintain compatibility with
 ///               previous probe version that used unidirectional sockets.
-#define CDI_PROBE_VERSION                4
+/// 5: Supports the receive buffer slot command used for RMA direct placement. See kProbeCommandRmaSlots.
+#define CDI_PROBE_VERSION                5
 
 /// @brief Define to limit the max number of allowable Tx or Rx connections that can be created in the SDK.
 #define CDI_MAX_SIMULTANEOUS_CONNECTIONS                (30)
@@ -116,13 +117,27 @@
 /// NOTE: This value must be a power of two because it is used to mask the MSBs of array indices. @see RxPacketReceive
 #define CDI_MAX_SIMULTANEOUS_RX_PAYLOADS_PER_CONNECTION  (32)
 
-/// @brief Define to limit the max number of payloads that can arrive out of order and be put back in order. Value must
-/// be a power of 2.
+/// @brief Default max number of payloads that can arrive out of order and be put back in order. Value must be a power
+/// of 2. See CdiRxConfigData.payload_reorder_buffer_size.
 #define CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER          (4096)
 
-/// @brief Define to limit the max number packets of that can arrive out of order and be put back in order.
+/// @brief Largest value that can be used for CdiRxConfigData.payload_reorder_buffer_size. Payload numbers are at most
+/// 16 bits, so entries beyond this would never be used.
+#define CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER_LIMIT    (65536)
+
+/// @brief Default max number packets of that can arrive out of order and be put back in order. See
+/// CdiRxConfigData.packet_reorder_window.
 #define CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW           (4000)
 
+/// @brief Default initial number of entries used to track packets that arrive out of order. See
+/// CdiRxConfigData.reorder_list_pool_size.
+#define CDI_RX_REORDER_LIST_POOL_DEFAULT_SIZE           (128)
+
+/// @brief Maximum number of memory regions that can be registered with a single adapter. Besides the regions registered
+/// by the application using CdiCoreNetworkAdapterMemoryRegister(), each Tx frame allocator and each Tx connection that
+/// is configured with CdiTxConfigData.coalesce_small_fragments uses one.
+#define CDI_MAX_ADAPTER_MEMORY_REGIONS                  (16)
+
 /// @brief Maximum connection name string length.
 #define CDI_MAX_CONNECTION_NAME_STRING_LENGTH           (128)
 
@@ -140,14 +155,27 @@
 /// @brief Maximum Rx buffer delay in milliseconds. This is approximately 6 video frames at 60FPS (6*16.6ms= ~100ms).
 #define CDI_MAXIMUM_RX_BUFFER_DELAY_MS                  (100)
 
+/// @brief Default time budget in microseconds for the user-registered Rx payload callback function when the Rx
+/// connection is configured to run to completion (see CdiRxConfigData.run_to_completion).
+#define CDI_RX_RUN_TO_COMPLETION_DEFAULT_BUDGET_US      (100)
+
+/// @brief Default number of bytes by which the received part of a payload must grow between two invocations of the
+/// Rx progress callback function (see CdiRxConfigData.progress_cb_ptr).
+#define CDI_RX_PROGRESS_DEFAULT_STEP_BYTES              (64*1024)
+
 /// @brief The millisecond divisor used to calculate how many additional packet buffers to allocate for the Rx buffer.
 /// A value of 10 here corresponds to 100FPS (10ms).
 #define CDI_RX_BUFFER_DELAY_BUFFER_MS_DIVISOR           (10)
 
+/// @brief Number of buckets in the Tx batch size histogram (see CdiPayloadCounterStats.tx_batch_size_histogram).
+/// Bucket N counts batches of 2^N to 2^(N+1)-1 packets. The last bucket also counts all larger batches.
+#define CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS             (12)
+
 // Declare forward references for internal structures that are not directly available through the API.
 struct CdiAdapterState;
 struct CdiConnectionState;
 struct CdiMemoryState;
+struct CdiCompletionQueueState;
 /// @brief Forward structure declaration to create pointer to log data when used.
 typedef struct CdiLogMethodData CdiLogMethodData;
 
@@ -169,11 +197,30 @@ typedef struct CdiConnectionState* CdiConnectionHandle;
  */
 typedef struct CdiEndpointState* CdiEndpointHandle;
 
+/**
+ * @brief Type used as the handle for a Tx payload whose data is appended while it is being sent. See
+ * CdiAvmEndpointTxPayloadOpen(). Its members are private to the SDK. The SDK reuses a payload's state once the payload
+ * has been sent, dropped or flushed, so the handle identifies the payload as well as its state and appending data
+ * through a stale handle fails instead of modifying another payload.
+ */
+typedef struct {
+    CdiEndpointHandle endpoint_handle;         ///< Endpoint the payload is sent to.
+    struct TxPayloadState* payload_state_ptr;  ///< State of the payload while it is being sent.
+    uint64_t generation;                       ///< Identifies the payload among the ones that used payload_state_ptr.
+} CdiTxPayloadHandle;
+
 /**
  * @brief Type used as the handle (pointer to an opaque structure) for holding private SDK data that relates to memory.
  */
 typedef struct CdiMemoryState* CdiMemoryHandle;
 
+/**
+ * @brief Type used as the handle (pointer to an opaque structure) for a completion queue. A completion queue can be
+ * used by any number of connections as an alternative to the registered user RX/TX callback functions. See
+ * cdi_completion_queue_api.h.
+ */
+typedef struct CdiCompletionQueueState* CdiCompletionQueueHandle;
+
 /**
  * @brief Type used as user defined data that is passed to the registered user RX/TX callback functions.
  */
@@ -481,6 +528,17 @@ typedef struct {
 
     /// @brief The type of adapter to use/initialize.
     CdiAdapterTypeSelection adapter_type;
+
+    /// @brief Number of receive packet buffers in a pool that the EFA adapter types share between the Rx connections
+    /// that set CdiRxConfigData.shared_rx_packet_quota. The pool is allocated when the first such connection is
+    /// created. If zero, those connections reserve their own packet buffers as usual.
+    ///
+    /// NOTE: The whole pool is registered with libfabric once per libfabric domain that uses it, and each registration
+    /// pins its memory and counts it against the locked memory limit of the process (RLIMIT_MEMLOCK, see
+    /// "ulimit -l"). Each Rx endpoint has its own domain unless its connection sets
+    /// CdiRxConfigData.shared_completion_queue, in which case the endpoints of all such connections of a poll thread
+    /// share one. Size the limit for the pool times the number of domains.
+    int rx_shared_packet_buffers;
 } CdiAdapterData;
 
 /**
@@ -501,6 +559,46 @@ typedef struct {
 
     /// @brief Number of bytes that were transmitted since the connection was created.
     uint64_t num_bytes_transferred;
+
+    /// @brief Number of user-registered payload callback invocations that exceeded their time budget since the
+    /// connection was created. Only used by Rx connections that are configured to run to completion (see
+    /// CdiRxConfigData.run_to_completion).
+    uint64_t num_callbacks_over_budget;
+
+    /// @brief Number of payload bytes that were copied into bounce buffers before being transmitted since the
+    /// connection was created. Only used by Tx connections that are configured to coalesce small SGL fragments (see
+    /// CdiTxConfigData.coalesce_small_fragments).
+    uint64_t num_bytes_bounced;
+
+    /// @brief Number of payload bytes that were transmitted directly from the application's memory since the
+    /// connection was created. Only used by Tx connections that are configured to coalesce small SGL fragments.
+    uint64_t num_bytes_zero_copy;
+
+    /// @brief Histogram of the number of packets in each batch of packets that was handed to the adapter since the
+    /// connection was created. Only used by Tx connections. See CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS for the size range
+    /// of each bucket and CdiTxConfigData.batch_policy.
+    uint64_t tx_batch_size_histogram[CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS];
+
+    /// @brief Number of payloads that were dropped before any of their packets were sent, because they could no longer
+    /// be transmitted within their maximum latency, since the connection was created. These are not included in
+    /// num_payloads_dropped. Only used by Tx connections that schedule payloads by deadline (see
+    /// CdiTxConfigData.deadline_scheduling).
+    uint64_t num_payloads_dropped_early;
+
+    /// @brief Number of times the packet reorder window was exceeded since the connection was created, each of which
+    /// caused the oldest undelivered payloads to be flushed. Only used by Rx connections. See
+    /// CdiRxConfigData.packet_reorder_window.
+    uint64_t num_rx_reorder_window_flushes;
+
+    /// @brief Number of payloads that were still being received when they were flushed because the packet reorder
+    /// window was exceeded since the connection was created. They are delivered with an error status. Only used by Rx
+    /// connections.
+    uint64_t num_rx_reorder_payloads_flushed;
+
+    /// @brief Number of payloads that were written directly into a receive buffer by the transmitter since the
+    /// connection was created, so did not need to be copied. Only used by Rx connections that are configured for RMA
+    /// direct placement (see CdiRxConfigData.rma_direct_placement).
+    uint64_t num_payloads_rma_placed;
 } CdiPayloadCounterStats;
 
 /**
@@ -529,6 +627,21 @@ typedef struct {
 
     /// @brief The 99th percentile time to transfer a payload over the time interval.
     uint32_t transfer_time_P99;
+
+    /// @brief Number of payloads of this endpoint transferred over the time interval. The percentile values above, as
+    /// well as transfer_count, are computed from the payloads of all of the endpoints of the connection. This value
+    /// and endpoint_transfer_time_max are kept for each endpoint, so the latency of a small stream such as audio
+    /// is not hidden by the other streams of the connection. Use transfer_time_sum / endpoint_transfer_count for the
+    /// endpoint's average transfer time.
+    int endpoint_transfer_count;
+
+    /// @brief Maximum time to transfer a payload of this endpoint over the time interval.
+    uint32_t endpoint_transfer_time_max;
+
+    /// @brief Highest number of packets that were buffered by this endpoint while putting payloads back in order over
+    /// the time interval. Only used by Rx endpoints. When it reaches CdiRxConfigData.packet_reorder_window, payloads
+    /// are flushed.
+    int rx_reorder_window_packets_max;
 } CdiPayloadTimeIntervalStats;
 
 /**
@@ -604,6 +717,29 @@ typedef struct {
     bool disable_cloudwatch_stats;
 } CdiStatsConfigData;
 
+/**
+ * @brief Values used to select how a Tx connection groups the packets of a payload into batches that are handed to the
+ * adapter. Each batch costs a queue operation and a wake-up of the adapter's poll thread, but the packets of a batch
+ * can't be sent until the whole batch has been built.
+ */
+typedef enum {
+    /// @brief The first batch of each payload has one packet and each following batch is twice as large as the
+    /// previous one.
+    kCdiTxBatchPolicyDoubling = 0,
+
+    /// @brief Every packet is handed to the adapter as soon as it is built. Lowest latency, highest overhead.
+    kCdiTxBatchPolicyLatency,
+
+    /// @brief All batches are large, minimizing the overhead per packet at the cost of latency.
+    kCdiTxBatchPolicyThroughput,
+
+    /// @brief The size of each batch depends on the level of the adapter's transmit queue and on the deadline of the
+    /// payload. Packets are handed over one at a time while the adapter is idle, batches grow while it is busy, and
+    /// batches are kept small for payloads that are close to their deadline (see the max_latency_microsecs parameter
+    /// of the Cdi...TxPayload() API functions).
+    kCdiTxBatchPolicyAdaptive,
+} CdiTxBatchPolicy;
+
 /**
  * @brief Configuration data used by one of the Cdi...TxCreate() API functions.
  */
@@ -678,6 +814,61 @@ typedef struct {
     /// @brief Configuration data for gathering statistics. The data can be changed at runtime using the
     /// CdiCoreStatsReconfigure() API function.
     CdiStatsConfigData stats_config;
+
+    /// @brief If true, payloads are packetized by the connection's packet send poll thread instead of by a separate
+    /// payload thread. Packets are then built just-in-time as the adapter is able to accept them, which removes the
+    /// hand-off between threads and reduces the number of packets in flight. This is most useful when many connections
+    /// with small payloads share the same poll thread (see shared_thread_id).
+    bool run_to_completion;
+
+    /// @brief If not NULL, Tx payload completions for this connection are pushed to this completion queue as
+    /// kCdiCompletionEventRawTx or kCdiCompletionEventAvmTx events instead of invoking the user-registered Tx callback
+    /// function, which may then be NULL. Completions are never dropped: if the queue is full, they wait until the
+    /// application polls it. See cdi_completion_queue_api.h.
+    CdiCompletionQueueHandle completion_queue_handle;
+
+    /// @brief If true, runs of small payload SGL fragments are copied into bounce buffers that are registered with the
+    /// adapter, so every packet is filled up to the maximum packet size even though each packet can only reference a
+    /// few SGL entries. Large fragments are still sent without being copied. This is most useful for payloads made of
+    /// many small fragments, such as ANC data or video sent one line per SGL entry. See num_bytes_bounced and
+    /// num_bytes_zero_copy in CdiPayloadCounterStats. The bounce buffers use one of the adapter's memory regions (see
+    /// CDI_MAX_ADAPTER_MEMORY_REGIONS), so creating the connection fails with kCdiStatusArraySizeExceeded if none is
+    /// left.
+    bool coalesce_small_fragments;
+
+    /// @brief Number of SDK worker pool tasks that help the connection's packetizer build the packets of large
+    /// payloads (see CdiCoreConfigData.worker_pool_thread_count). Once a stream has sent a payload, the following
+    /// payloads of the same size and SGL layout are split into contiguous ranges of packets that are built concurrently
+    /// and then queued to the adapter in order. Ranges that no worker thread has started by the time the packetizer is
+    /// done with its own range are built by the packetizer, so busy worker threads delay the packetizer but never
+    /// block it. This is most useful for very large payloads, such as 8K or high frame rate video, where a single
+    /// thread can't build packets as fast as the adapter can send them. Use zero to disable. Ignored if the worker
+    /// pool is not enabled or coalesce_small_fragments is true. The maximum value is 8.
+    int packetizer_helper_count;
+
+    /// @brief Policy used to group packets into batches that are handed to the adapter. The batch sizes that result are
+    /// reported in CdiPayloadCounterStats.tx_batch_size_histogram.
+    CdiTxBatchPolicy batch_policy;
+
+    /// @brief If non-zero, the packets of each payload are spread evenly over this many microseconds, typically the
+    /// frame period, instead of being sent back to back as fast as the adapter allows. This avoids microbursts that
+    /// can overflow switch buffers. The socket adapter hands the launch time of each packet to the kernel (SO_TXTIME),
+    /// which requires the fq queuing discipline on the network interface (ie. "tc qdisc replace dev eth0 root fq").
+    /// Other adapters, and the socket adapter on systems that don't support SO_TXTIME or whose network interface uses
+    /// another queuing discipline, pace packets in the SDK's poll thread. The rate includes the packet headers, so the
+    /// packets of a payload are sent within the window. Use zero to disable pacing.
+    uint32_t pacing_window_microsecs;
+
+    /// @brief If true, payloads that are waiting to be transmitted are sent in order of their deadline (the time the
+    /// payload was queued plus its maximum latency) instead of the order in which they were queued. A payload that
+    /// can no longer meet its deadline, given the data already queued ahead of it and the rate at which the connection
+    /// has been sending, is dropped before any of its packets are sent. Its Tx callback is invoked with a
+    /// kCdiStatusMaxLatencyExceeded status and it is counted in CdiPayloadCounterStats.num_payloads_dropped_early.
+    /// Under overload this loses a stale payload instead of making every following payload late. Payloads without a
+    /// maximum latency are never dropped. They are ordered as if their maximum latency were 100 milliseconds, so
+    /// payloads with a deadline can't hold them back indefinitely. Stream priorities (see
+    /// CdiTxConfigDataStream.priority) take precedence over deadlines.
+    bool deadline_scheduling;
 } CdiTxConfigData;
 
 /**
@@ -735,6 +926,39 @@ typedef enum {
     kCdiSgl                = 1,
 } CdiBufferType;
 
+/**
+ * @brief A structure of this type is passed to the Rx progress callback function (see CdiRxConfigData.progress_cb_ptr)
+ * while a payload is being received.
+ */
+typedef struct {
+    /// @brief Core callback data of the payload. status_code is always kCdiStatusOk and err_msg_str is NULL. The extra
+    /// data is the one sent with the payload.
+    CdiCoreCbData core_cb_data;
+
+    /// @brief Total size in bytes of the payload being received.
+    int payload_size;
+
+    /// @brief Number of bytes from the start of the payload that have been received so far, with no gaps.
+    int received_byte_count;
+
+    /// @brief If the connection uses a linear receive buffer, pointer to the start of the payload's data in it.
+    /// Otherwise NULL.
+    const void* linear_buffer_ptr;
+
+    /// @brief If the connection uses scatter-gather receive buffers, pointer to the first of the SGL entries that hold
+    /// the received part of the payload, in order. The entries hold at least received_byte_count bytes; only that many
+    /// bytes may be used. Otherwise NULL.
+    const CdiSglEntry* sgl_head_ptr;
+} CdiCoreRxProgressCbData;
+
+/**
+ * @brief Prototype of Rx progress callback function. The user code must implement a function with this prototype and
+ * provide it in CdiRxConfigData to receive the first parts of payloads before the whole payloads have been received.
+ *
+ * @param data_ptr A pointer to an CdiCoreRxProgressCbData structure.
+ */
+typedef void (*CdiCoreRxProgressCallback)(const CdiCoreRxProgressCbData* data_ptr);
+
 /**
  * @brief Configuration data used by one of the Cdi...RxCreate() API functions.
  */
@@ -816,6 +1040,87 @@ typedef struct {
     /// @brief Configuration data for gathering statistics. The data can be changed at runtime using the
     /// CdiCoreStatsReconfigure() API function.
     CdiStatsConfigData stats_config;
+
+    /// @brief If true, the user-registered payload callback function is invoked directly from the connection's packet
+    /// receive poll thread as soon as a payload is complete, instead of being queued to a separate callback thread.
+    /// This removes a queue copy and a thread wake-up from every payload but stalls packet reception for the duration
+    /// of the callback, so the callback must be short and must not block. Cannot be used with buffer_delay_ms.
+    bool run_to_completion;
+
+    /// @brief Time budget in microseconds for the user-registered payload callback function when run_to_completion is
+    /// true. Callbacks that take longer are counted in CdiPayloadCounterStats.num_callbacks_over_budget. Use 0 for the
+    /// SDK default value (CDI_RX_RUN_TO_COMPLETION_DEFAULT_BUDGET_US).
+    int run_to_completion_budget_us;
+
+    /// @brief If not NULL, received payloads for this connection are pushed to this completion queue as
+    /// kCdiCompletionEventRawRx or kCdiCompletionEventAvmRx events instead of invoking the user-registered Rx callback
+    /// function, which may then be NULL. Combine with run_to_completion to push payloads directly from the packet
+    /// receive poll thread. See cdi_completion_queue_api.h.
+    CdiCompletionQueueHandle completion_queue_handle;
+
+    /// @brief If not NULL, this function is invoked while a payload is being received, each time the part received from
+    /// its start with no gaps has grown by at least progress_step_bytes. This allows processing the top of a video
+    /// frame while its bottom is still arriving. It is not invoked once the whole payload has been received; the
+    /// payload is then delivered as usual. The function is invoked from the connection's packet receive poll thread,
+    /// so it must be short and must not block. The payload's data must not be modified. The pointers to it are valid
+    /// until the payload is delivered, or an error is reported for it, through the Rx payload callback function.
+    CdiCoreRxProgressCallback progress_cb_ptr;
+
+    /// @brief Minimum number of bytes by which the received part of a payload must grow between two invocations of
+    /// progress_cb_ptr. Use 0 for the SDK default value (CDI_RX_PROGRESS_DEFAULT_STEP_BYTES).
+    int progress_step_bytes;
+
+    /// @brief Number of consecutive payload numbers that can be tracked while payloads are put back in order. Value
+    /// must be a power of 2, no larger than CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER_LIMIT and at least as large as
+    /// packet_reorder_window. If it's 0, the larger of CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER and the smallest valid
+    /// value for packet_reorder_window is used.
+    int payload_reorder_buffer_size;
+
+    /// @brief Max number of packets of each endpoint that can be buffered while payloads are put back in order. Once
+    /// reached, the oldest undelivered payloads are flushed, and the ones still being received are delivered with an
+    /// error status (see CdiPayloadCounterStats.num_rx_reorder_window_flushes). This must be larger than the number of
+    /// packets of the largest payload times the number of payloads that can be in flight, which for 8K video or high
+    /// frame rates is more than the default. If it's 0, CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW is used.
+    int packet_reorder_window;
+
+    /// @brief Initial number of entries used to track packets that arrive out of order. The pool grows as needed, so
+    /// this only needs to be increased to avoid growing it while receiving. NOTE: If it's 0, then
+    /// CDI_RX_REORDER_LIST_POOL_DEFAULT_SIZE will be used.
+    int reorder_list_pool_size;
+
+    /// @brief If true and rx_buffer_type is kCdiLinearBuffer, the receiver advertises a few registered receive buffers
+    /// of linear_buffer_size bytes to the transmitter, which then writes the data of each payload directly into one of
+    /// them using one-sided RMA writes and only sends a small completion message. This removes the copy of every packet
+    /// into the linear buffer. Payloads are received and copied as usual whenever no advertised buffer is free, or if
+    /// the adapter, its libfabric provider or the transmitter's SDK don't support RMA writes. Only used by the EFA
+    /// adapter types (kCdiAdapterTypeSocketLibfabric can be used to test it locally). See
+    /// CdiPayloadCounterStats.num_payloads_rma_placed.
+    bool rma_direct_placement;
+
+    /// @brief If true, the EFA adapter types post their receive packet memory to libfabric as a few large buffers using
+    /// FI_MULTI_RECV instead of one buffer per packet. Packets then land back-to-back in each buffer, which is only
+    /// posted again once all of its packets have been freed. This reduces the overhead of posting receive buffers and
+    /// keeps consecutive packets of a payload close together in memory. Buffers are posted one per packet as usual if
+    /// the libfabric provider doesn't support FI_MULTI_RECV.
+    bool multi_receive_buffers;
+
+    /// @brief If true, the Rx endpoints that the EFA adapter creates for the streams of this connection share a single
+    /// libfabric domain and completion queue with the Rx endpoints of the other connections that set this and use the
+    /// same poll thread (see shared_thread_id). The poll thread then reads the completions of all of those endpoints
+    /// with one call instead of polling a completion queue per endpoint. Up to 20 endpoints share a completion queue.
+    /// Only used by kCdiAdapterTypeEfa, since the sockets provider does not generate memory registration keys that are
+    /// unique within a domain.
+    bool shared_completion_queue;
+
+    /// @brief If not zero, the EFA adapter types receive the packets of this connection into buffers taken from a pool
+    /// that the adapter shares between connections (see CdiAdapterData.rx_shared_packet_buffers) instead of into
+    /// packet buffers reserved for the connection. The value is the quota of the connection: the maximum number of the
+    /// pool's buffers it may hold at once, counting both the buffers posted to libfabric and those holding packets that
+    /// have not been freed yet. Only a small number of buffers is kept posted per endpoint, so the memory needed for
+    /// many connections follows their combined bandwidth rather than their count. If the pool runs out, the
+    /// transmitter is held off by libfabric until buffers are freed. multi_receive_buffers is ignored when this is
+    /// used.
+    int shared_rx_packet_quota;
 } CdiRxConfigData;
 
 /**
@@ -853,6 +1158,17 @@ typedef struct {
     /// for each connection (see #CdiStatsConfigData.stats_period_seconds) when the connection is created and can be
     /// changed at any time using CdiCoreStatsReconfigure(). If this value is NULL, then CloudWatch will not be used.
     const CdiCloudWatchConfigData* cloudwatch_config_ptr;
+
+    /// @brief Number of threads in the SDK worker pool. If greater than zero, per-connection service loops that support
+    /// it (ie. the loop that invokes the user-registered payload callback functions) run as tasks on this fixed-size
+    /// pool of threads instead of on a dedicated thread for each connection. The work for each connection is always
+    /// processed in order by a single worker thread. The pool also runs the packetizer helpers of Tx connections (see
+    /// CdiTxConfigData.packetizer_helper_count). Use zero to disable the worker pool.
+    int worker_pool_thread_count;
+
+    /// @brief Optional pointer to an array of worker_pool_thread_count CPU core numbers used to pin the worker pool
+    /// threads. If NULL, the threads are not pinned. An array entry of -1 disables pinning for the related thread.
+    const int* worker_pool_core_array;
 } CdiCoreConfigData;
 
 //*********************************************************************************************************************
@@ -910,6 +1226,38 @@ CDI_INTERFACE CdiReturnStatus CdiCoreNetworkAdapterInitialize(CdiAdapterData* ad
  */
 CDI_INTERFACE CdiReturnStatus CdiCoreNetworkAdapterDestroy(CdiAdapterHandle handle);
 
+/**
+ * Register an application memory region with a network adapter. Once registered, the scatter-gather lists of Tx
+ * payloads sent on connections that use the adapter can reference memory anywhere in the region, in addition to the
+ * adapter's Tx payload buffer (see CdiAdapterData.ret_tx_buffer_ptr), and the data is transmitted without being copied.
+ * For the EFA adapter, the region is registered with libfabric by each endpoint the first time a payload uses it and
+ * the registration is cached until the region is unregistered or the endpoint is closed. The socket based adapters
+ * don't need the memory to be registered, so the region is only tracked. At most CDI_MAX_ADAPTER_MEMORY_REGIONS regions
+ * can be registered with an adapter, including the ones used by the SDK itself.
+ *
+ * @param handle Handle of the network adapter.
+ * @param address_ptr Starting address of the region. The region must not overlap the adapter's Tx payload buffer or
+ *                    any other region registered with the adapter.
+ * @param size_in_bytes Size of the region in bytes.
+ *
+ * @return kCdiStatusOk if successful, kCdiStatusArraySizeExceeded if CDI_MAX_ADAPTER_MEMORY_REGIONS regions are
+ *         already registered with the adapter, otherwise a value that indicates the nature of the failure.
+ */
+CDI_INTERFACE CdiReturnStatus CdiCoreNetworkAdapterMemoryRegister(CdiAdapterHandle handle, void* address_ptr,
+                                                                  uint64_t size_in_bytes);
+
+/**
+ * Unregister an application memory region that was registered using CdiCoreNetworkAdapterMemoryRegister(). The
+ * libfabric registrations made for the region by the EFA adapter's endpoints are released before this returns. The
+ * application must not unregister a region while payloads that use it are being transmitted.
+ *
+ * @param handle Handle of the network adapter.
+ * @param address_ptr Starting address of the region, as passed to CdiCoreNetworkAdapterMemoryRegister().
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CDI_INTERFACE CdiReturnStatus CdiCoreNetworkAdapterMemoryUnregister(CdiAdapterHandle handle, void* address_ptr);
+
 /**
  * Free the receive buffer that was used in one of the Cdi...RxCallback() API functions.
  *
@@ -919,6 +1267,19 @@ CDI_INTERFACE CdiReturnStatus CdiCoreNetworkAdapterDestroy(CdiAdapterHandle hand
  */
 CDI_INTERFACE CdiReturnStatus CdiCoreRxFreeBuffer(const CdiSgList* sgl_ptr);
 
+/**
+ * Free an array of receive buffers that were used in one of the Cdi...RxCallback() API functions. This is equivalent
+ * to calling CdiCoreRxFreeBuffer() for each entry, but consecutive buffers that were received on the same endpoint are
+ * returned to it with a single queue operation, so it is cheaper when many payloads are freed at once, such as all of
+ * the streams of a frame.
+ *
+ * @param sgl_ptr_array Array of pointers to the scatter-gather lists containing the memory to be freed.
+ * @param count Number of entries in sgl_ptr_array.
+ *
+ * @return A value from the CdiReturnStatus enumeration. If any list is invalid, none of them are freed.
+ */
+CDI_INTERFACE CdiReturnStatus CdiCoreRxFreeBuffers(const CdiSgList* sgl_ptr_array[], int count);
+
 /**
  * Gather received data represented by a scatter-gather list into a contiguous buffer. The caller is responsible for
  * ensuring that the destination buffer is large enough to hold the data.
@@ -114,6 +114,8 @@ struct iovec;
     #define CdiOsAtomicDec32(x) InterlockedDecrement(x)
     #define CdiOsAtomicRead32(x) InterlockedAdd((x), 0)
     #define CdiOsAtomicAdd32(x, b) InterlockedAdd((x), (b))
+    #define CdiOsAtomicCompareAndSwap32(x, old_v, new_v) \
+        (InterlockedCompareExchange((x), (new_v), (old_v)) == (old_v))
 
     // NOTE: These macros operate on 64-bit values.
     #define CdiOsAtomicInc64(x) InterlockedIncrement64(x)
@@ -213,6 +215,8 @@ struct iovec;
     #define CdiOsAtomicRead32(x) __sync_add_and_fetch((x), 0)
     /// Atomic add a 32-bit value by a 32-bit value sent (matches windows variant, which uses functions).
     #define CdiOsAtomicAdd32(x, b) __sync_add_and_fetch((x), (b))
+    /// Atomic compare and swap a 32-bit value. Returns true if the value was old_v and has been replaced by new_v.
+    #define CdiOsAtomicCompareAndSwap32(x, old_v, new_v) __sync_bool_compare_and_swap((x), (old_v), (new_v))
 
     /// Atomic increment a 64-bit value by 1 (matches windows variant, which uses functions).
     #define CdiOsAtomicInc64(x) __sync_add_and_fetch((x), 1)
@@ -615,6 +619,39 @@ CDI_INTERFACE bool CdiOsSignalWait(CdiSignalType signal_handle, uint32_t timeout
 CDI_INTERFACE bool CdiOsSignalsWait(CdiSignalType* signal_array, uint8_t num_signals, bool wait_all,
                                     uint32_t timeout_in_ms, uint32_t* ret_signal_index_ptr);
 
+/**
+ * This function creates a notification file descriptor. The descriptor becomes readable when it is set and stays
+ * readable until it is cleared, so it can be used with select(), poll() or epoll() to wait for a notification together
+ * with other file descriptors. The initial value is not set. NOTE: Only supported on Linux. On other platforms the
+ * returned descriptor is -1 and the other notification file descriptor functions do nothing.
+ *
+ * @param ret_fd_ptr Address where to write the returned file descriptor.
+ *
+ * @return true if successful, otherwise false.
+ */
+CDI_INTERFACE bool CdiOsNotificationFdCreate(int* ret_fd_ptr);
+
+/**
+ * This function deletes a notification file descriptor.
+ *
+ * @param fd File descriptor returned by CdiOsNotificationFdCreate().
+ */
+CDI_INTERFACE void CdiOsNotificationFdDelete(int fd);
+
+/**
+ * This function sets a notification file descriptor, making it readable.
+ *
+ * @param fd File descriptor returned by CdiOsNotificationFdCreate().
+ */
+CDI_INTERFACE void CdiOsNotificationFdSet(int fd);
+
+/**
+ * This function clears a notification file descriptor, so it is no longer readable.
+ *
+ * @param fd File descriptor returned by CdiOsNotificationFdCreate().
+ */
+CDI_INTERFACE void CdiOsNotificationFdClear(int fd);
+
 // -- Memory --
 
 /**
@@ -1006,6 +1043,49 @@ CDI_INTERFACE bool CdiOsSocketWrite(CdiSocket socket_handle, struct iovec* iov,
 CDI_INTERFACE bool CdiOsSocketWriteTo(CdiSocket socket_handle, struct iovec* iov, int iovcnt,
                                       const struct sockaddr_in* destination_address_ptr, int* byte_count_ptr);
 
+/**
+ * Enable scheduled transmission (SO_TXTIME) on a communications socket, so that datagrams written using
+ * CdiOsSocketWriteAt() leave the host at the requested time instead of immediately. The launch time is only honored if
+ * the network interface uses a queuing discipline that supports it, such as fq.
+ *
+ * @param socket_handle The handle for the socket to configure.
+ *
+ * @return true if scheduled transmission was enabled, false if the OS doesn't support it.
+ */
+CDI_INTERFACE bool CdiOsSocketTxTimeEnable(CdiSocket socket_handle);
+
+/**
+ * Check whether the launch times of datagrams written using CdiOsSocketWriteAt() are honored for a socket, which
+ * requires the network interface that its datagrams leave through to use the fq or etf queuing discipline. The
+ * interface is looked up from the address the socket was opened with.
+ *
+ * @param socket_handle The handle for the socket to check.
+ *
+ * @return false if the launch times are known to be ignored, otherwise true.
+ */
+CDI_INTERFACE bool CdiOsSocketTxTimeHonored(CdiSocket socket_handle);
+
+/**
+ * Synchronously write a datagram to a communications socket, to be sent by the kernel at a specified time. Otherwise
+ * the same as CdiOsSocketWriteTo(). If scheduled transmission was not enabled using CdiOsSocketTxTimeEnable(), the
+ * launch time is ignored.
+ *
+ * @param socket_handle  The handle for the socket through which the datagram will be written.
+ * @param iov            The address of an array of iovec structures which specify the data to be sent.
+ * @param iovcnt         The number of iovec structures contained in the iov array. This value is limited to
+ *                       CDI_OS_SOCKET_MAX_IOVCNT.
+ * @param destination_address_ptr Pointer to the destination (IP address and port number) to which to send the UDP
+ *                                packet. If NULL, the address the socket was opened with is used.
+ * @param launch_time_microsecs Time at which to send the datagram, in the time base of CdiOsGetMicroseconds().
+ * @param byte_count_ptr The address of a location into which the number of bytes written to the socket will be placed
+ *                       if the datagram was successfully sent.
+ *
+ * @return true if the datagram was successfully queued, false if not.
+ */
+CDI_INTERFACE bool CdiOsSocketWriteAt(CdiSocket socket_handle, struct iovec* iov, int iovcnt,
+                                      const struct sockaddr_in* destination_address_ptr,
+                                      uint64_t launch_time_microsecs, int* byte_count_ptr);
+
 /**
  * Set an environment variable for the currently running process. NOTE: Does not set the process's shell environment.
  *
@@ -136,6 +136,19 @@ CDI_INTERFACE bool CdiQueuePopWaitMultiple(CdiQueueHandle handle, int timeout_ms
  */
 CDI_INTERFACE bool CdiQueuePush(CdiQueueHandle handle, const void* item_ptr);
 
+/**
+ * Push an array of items on the queue. The items become visible to the reader together and the pop signal is set once,
+ * so this is cheaper than calling CdiQueuePush() for each item. If the queue becomes full, the remaining items are not
+ * pushed.
+ *
+ * @param handle Queue handle.
+ * @param item_array Pointer to array of items to copy. Each item is the size specified when the queue was created.
+ * @param item_count Number of items in item_array.
+ *
+ * @return The number of items pushed, starting from the first item in item_array.
+ */
+CDI_INTERFACE int CdiQueuePushBatch(CdiQueueHandle handle, const void* item_array, int item_count);
+
 /**
  * Push an item on the queue. If the queue is full, wait until the specified timeout expires or the optional signal gets
  * set.
@@ -36,6 +36,26 @@ typedef enum {
     kTestUnitRxPayloadReorder, ///< Test unit Rx payload reorderer.
     kTestUnitList, ///< Unit test for doubly linked list implementation.
     kTestUnitLogger, ///< Test logger functions.
+    kTestUnitWorkerPool, ///< Test worker pool functions.
+    kTestUnitStatsScheduler, ///< Test the stats scheduler shared by all connections.
+    kTestUnitRxRunToCompletion, ///< Test invoking Rx payload callbacks from the receive poll thread.
+    kTestUnitTxPoll, ///< Test packetizing Tx payloads from the poll thread.
+    kTestUnitCompletionQueue, ///< Test completion queue functions.
+    kTestUnitQueue, ///< Test queue batch functions.
+    kTestUnitMemoryRegion, ///< Test adapter memory region functions.
+    kTestUnitTxFrameAllocator, ///< Test Tx frame allocator.
+    kTestUnitPacketizer, ///< Test Tx payload packetizer.
+    kTestUnitTxBatchPolicy, ///< Test Tx batch policies.
+    kTestUnitTxScheduler, ///< Test Tx payload scheduler.
+    kTestUnitTxPreempt, ///< Test Tx payload preemption.
+    kTestUnitTxStream, ///< Test appending data to streaming Tx payloads.
+    kTestUnitRxProgress, ///< Rx payload progress unit test.
+    kTestUnitRxReorderWindow, ///< Test configurable Rx reorder windows.
+    kTestUnitEfaRma, ///< Test the receive buffer slots of EFA RMA direct placement.
+    kTestUnitEfaMultiRecv, ///< Test the FI_MULTI_RECV buffers and optional capabilities of EFA endpoints.
+    kTestUnitEfaSharedCq, ///< Test the completion queues shared by EFA Rx endpoints.
+    kTestUnitEfaSharedPool, ///< Test the receive packet buffers shared by EFA Rx connections.
+    kTestUnitEfaInject, ///< Test the completion of small packets that EFA Tx endpoints inject.
     kTestUnitLast, ///< End of list (for range checking, do no remove).
 } CdiTestUnitName;
 
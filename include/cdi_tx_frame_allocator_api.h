@@ -0,0 +1,104 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+#ifndef CDI_TX_FRAME_ALLOCATOR_API_H__
+#define CDI_TX_FRAME_ALLOCATOR_API_H__
+
+/**
+ * @file
+ * @brief
+ * This file declares the public API data types, structures and functions of the CDI Tx frame allocator. The allocator
+ * manages memory for Tx payloads so applications don't need to write their own allocator on top of the adapter's Tx
+ * payload buffer (see CdiAdapterData.ret_tx_buffer_ptr).
+ *
+ * Each stream of the allocator has a fixed number of fixed size frames. The memory for each stream starts on a huge
+ * page boundary and is registered with the adapter (see CdiCoreNetworkAdapterMemoryRegister()), so the frames are sent
+ * without being copied. Allocating a frame does not take a lock. A frame is returned to its stream automatically once
+ * the payload that uses it has been transmitted, right after the application's Tx payload callback function returns
+ * (or the completion event is pushed to the connection's completion queue).
+ */
+
+#include <stdint.h>
+
+#include "cdi_core_api.h"
+
+//*********************************************************************************************************************
+//***************************************** START OF DEFINITIONS AND TYPES ********************************************
+//*********************************************************************************************************************
+
+/// @brief Forward declaration to create pointer to Tx frame allocator state when used.
+typedef struct CdiTxFrameAllocatorState* CdiTxFrameAllocatorHandle;
+
+/**
+ * @brief Configuration data for a single stream of a Tx frame allocator.
+ */
+typedef struct {
+    /// @brief Size in bytes of each frame of the stream. Must be the size of the largest payload sent using it.
+    int frame_size_bytes;
+
+    /// @brief Number of frames of the stream. Should be at least one more than the number of payloads of the stream
+    /// that are in flight at the same time (see CdiTxConfigData.max_simultaneous_tx_payloads).
+    int frame_count;
+} CdiTxFrameAllocatorStreamConfig;
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+/**
+ * Create a Tx frame allocator. The memory for all of the streams is allocated and registered with the adapter as a
+ * single memory region, so each allocator uses one of the limited number of memory regions that can be registered with
+ * an adapter (see CdiCoreNetworkAdapterMemoryRegister()).
+ *
+ * @param adapter_handle Handle of the network adapter that is used to send the frames.
+ * @param stream_config_array Array of stream configurations. The index of an entry is the stream index used with
+ *                            CdiTxFrameAlloc().
+ * @param stream_count Number of entries in stream_config_array.
+ * @param ret_handle_ptr Pointer to returned allocator handle.
+ *
+ * @return kCdiStatusOk if successful, kCdiStatusArraySizeExceeded if all of the adapter's memory regions are in use,
+ *         otherwise a value that indicates the nature of the failure.
+ */
+CDI_INTERFACE CdiReturnStatus CdiTxFrameAllocatorCreate(CdiAdapterHandle adapter_handle,
+                                                        const CdiTxFrameAllocatorStreamConfig* stream_config_array,
+                                                        int stream_count, CdiTxFrameAllocatorHandle* ret_handle_ptr);
+
+/**
+ * Destroy a Tx frame allocator. All of the connections that sent frames from it must have been closed first.
+ *
+ * @param handle Allocator handle returned by CdiTxFrameAllocatorCreate().
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CDI_INTERFACE CdiReturnStatus CdiTxFrameAllocatorDestroy(CdiTxFrameAllocatorHandle handle);
+
+/**
+ * Allocate a frame from a stream of a Tx frame allocator. The returned scatter-gather list has a single entry that
+ * covers the whole frame. The application may reduce its size (both size_in_bytes of the entry and total_data_size of
+ * the list) before sending it, but must not change anything else, in particular internal_data_ptr of the list. This
+ * function does not block and must only be called by one thread at a time for a given stream.
+ *
+ * @param handle Allocator handle returned by CdiTxFrameAllocatorCreate().
+ * @param stream_index Index of the stream in the stream_config_array passed to CdiTxFrameAllocatorCreate().
+ * @param ret_sgl_ptr Pointer to returned scatter-gather list of the frame.
+ *
+ * @return kCdiStatusOk if successful, kCdiStatusAllocationFailed if all of the stream's frames are in use, otherwise
+ *         a value that indicates the nature of the failure.
+ */
+CDI_INTERFACE CdiReturnStatus CdiTxFrameAlloc(CdiTxFrameAllocatorHandle handle, int stream_index,
+                                              CdiSgList** ret_sgl_ptr);
+
+/**
+ * Return a frame to its stream without sending it. Only needed for frames that were allocated but not successfully
+ * passed to one of the Cdi...TxPayload() API functions. Frames that were sent are returned automatically.
+ *
+ * @param sgl_ptr Pointer to the scatter-gather list returned by CdiTxFrameAlloc().
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CDI_INTERFACE CdiReturnStatus CdiTxFrameFree(const CdiSgList* sgl_ptr);
+
+#endif // CDI_TX_FRAME_ALLOCATOR_API_H__
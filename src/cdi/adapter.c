@@ -15,6 +15,8 @@
 
 #include "adapter_api.h"
 
+#include <string.h>
+
 #include "endpoint_manager.h"
 #include "internal.h"
 #include "internal_log.h"
@@ -84,6 +86,54 @@ static Packet* GetNextPacket(AdapterEndpointState* endpoint_ptr, int num_signals
     return packet_ptr;
 }
 
+/**
+ * Check whether the software pacer of an endpoint allows the next packet to be sent now. The token bucket is refilled
+ * at the rate of the last packet that was sent, which is the rate of the next packet unless a new payload starts.
+ *
+ * @param endpoint_ptr Pointer to the endpoint's state.
+ *
+ * @return true if a packet may be sent now, false if the pacer is holding packets back.
+ */
+static bool TxPacerReady(AdapterEndpointState* endpoint_ptr)
+{
+    AdapterTxPacerState* pacer_ptr = &endpoint_ptr->tx_pacer;
+    if (endpoint_ptr->tx_pacing_offloaded || 0 == pacer_ptr->bytes_per_millisec) {
+        return true;
+    }
+
+    const uint64_t now = CdiOsGetMicroseconds();
+    // Microseconds times bytes per millisecond is thousandths of a byte.
+    pacer_ptr->credit_millibytes += (int64_t)(now - pacer_ptr->last_update_microsecs) * pacer_ptr->bytes_per_millisec;
+    pacer_ptr->credit_millibytes = CDI_MIN(pacer_ptr->credit_millibytes, (int64_t)TX_PACING_MAX_BURST_BYTES * 1000);
+    pacer_ptr->last_update_microsecs = now;
+
+    return pacer_ptr->credit_millibytes >= 0;
+}
+
+/**
+ * Charge a packet that was just handed to the adapter to the software pacer of an endpoint.
+ *
+ * @param endpoint_ptr Pointer to the endpoint's state.
+ * @param packet_ptr Pointer to the packet that was sent.
+ */
+static void TxPacerPacketSent(AdapterEndpointState* endpoint_ptr, const Packet* packet_ptr)
+{
+    AdapterTxPacerState* pacer_ptr = &endpoint_ptr->tx_pacer;
+    if (endpoint_ptr->tx_pacing_offloaded) {
+        return;
+    }
+
+    if (0 == pacer_ptr->bytes_per_millisec) {
+        // Start with an empty bucket, so a paced payload that follows idle time is not sent as a burst.
+        pacer_ptr->credit_millibytes = 0;
+        pacer_ptr->last_update_microsecs = CdiOsGetMicroseconds();
+    }
+    pacer_ptr->bytes_per_millisec = packet_ptr->tx_state.pacing_bytes_per_millisec;
+    if (pacer_ptr->bytes_per_millisec) {
+        pacer_ptr->credit_millibytes -= (int64_t)packet_ptr->sg_list.total_data_size * 1000;
+    }
+}
+
 /**
  * Update thread utilization statistics.
  *
@@ -280,13 +330,24 @@ static bool DataPoll(AdapterConnectionState* adapter_con_state_ptr)
             // Get Endpoint Manager notification signal.
             if (EndpointManagerPoll(&cdi_endpoint_handle) && adapter_endpoint_ptr) {
                 if (adapter_con_state_ptr->can_transmit) {
+                    // If the connection runs to completion, packetize its payloads here just before they are sent.
+                    if (TxPollProcess(adapter_con_state_ptr->data_state.cdi_connection_handle)) {
+                        idle = false;
+                        all_idle = false;
+                    }
                     Packet* packet_ptr = NULL;
                     bool last_packet = false;
                     EndpointTransmitQueueLevel queue_level = CdiAdapterGetTransmitQueueLevel(adapter_endpoint_ptr);
-                    bool got_packet = (kEndpointTransmitQueueFull != queue_level) &&
+                    bool pacer_ready = TxPacerReady(adapter_endpoint_ptr);
+                    bool got_packet = (kEndpointTransmitQueueFull != queue_level) && pacer_ready &&
                         (NULL != (packet_ptr = GetNextPacket(adapter_endpoint_ptr, 0, NULL, &last_packet)));
+                    if (!pacer_ready) {
+                        // Packets are being held back by the pacer, so don't want this poll thread to sleep.
+                        all_idle = false;
+                    }
                     if (got_packet) {
                         idle = false;
+                        TxPacerPacketSent(adapter_endpoint_ptr, packet_ptr);
                         // Use the adapter to send the packet.
                         adapter_con_state_ptr->adapter_state_ptr->functions_ptr->Send(adapter_endpoint_ptr, packet_ptr,
                                                                                       last_packet);
@@ -843,6 +904,7 @@ CdiReturnStatus CdiAdapterOpenEndpoint(CdiAdapterEndpointConfigData* config_data
         endpoint_state_ptr->cdi_endpoint_handle = config_data_ptr->cdi_endpoint_handle;
         endpoint_state_ptr->msg_from_endpoint_func_ptr = config_data_ptr->msg_from_endpoint_func_ptr;
         endpoint_state_ptr->msg_from_endpoint_param_ptr = config_data_ptr->msg_from_endpoint_param_ptr;
+        endpoint_state_ptr->msgs_from_endpoint_func_ptr = config_data_ptr->msgs_from_endpoint_func_ptr;
 
         if (kEndpointDirectionSend == adapter_con_state_ptr->direction ||
             kEndpointDirectionBidirectional == adapter_con_state_ptr->direction) {
@@ -940,6 +1002,7 @@ CdiReturnStatus CdiAdapterResetEndpoint(AdapterEndpointHandle handle, bool reope
             CdiOsAtomicStore32(&handle->tx_in_flight_ref_count, 0);
             CdiOsSignalClear(handle->adapter_con_state_ptr->tx_poll_do_work_signal);
         }
+        memset(&handle->tx_pacer, 0, sizeof(handle->tx_pacer));
     } else {
         rs = kCdiStatusInvalidHandle;
     }
@@ -1028,6 +1091,118 @@ CdiReturnStatus CdiAdapterGetPort(const AdapterEndpointHandle handle, int* port_
     return adapter_state_ptr->functions_ptr->GetPort(handle, port_number_ptr);
 }
 
+CdiReturnStatus CdiAdapterMemoryRegister(CdiAdapterHandle adapter, void* address_ptr, uint64_t size_in_bytes)
+{
+    // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
+    CdiReturnStatus rs = kCdiStatusOk;
+    const uint8_t* start_ptr = (const uint8_t*)address_ptr;
+    const uint8_t* end_ptr = start_ptr + size_in_bytes;
+
+    CdiOsCritSectionReserve(adapter->memory_region_lock);
+
+    const uint8_t* tx_buffer_ptr = (const uint8_t*)adapter->adapter_data.ret_tx_buffer_ptr;
+    if (tx_buffer_ptr && start_ptr < tx_buffer_ptr + adapter->tx_buffer_allocated_size && end_ptr > tx_buffer_ptr) {
+        SDK_LOG_GLOBAL(kLogError, "Memory region[%p] overlaps the adapter's Tx payload buffer.", address_ptr);
+        rs = kCdiStatusInvalidParameter;
+    }
+    for (int i = 0; kCdiStatusOk == rs && i < adapter->memory_region_count; i++) {
+        const AdapterMemoryRegion* region_ptr = &adapter->memory_region_array[i];
+        const uint8_t* region_start_ptr = (const uint8_t*)region_ptr->address_ptr;
+        if (start_ptr < region_start_ptr + region_ptr->size_in_bytes && end_ptr > region_start_ptr) {
+            SDK_LOG_GLOBAL(kLogError, "Memory region[%p] overlaps registered memory region[%p].", address_ptr,
+                           region_ptr->address_ptr);
+            rs = kCdiStatusInvalidParameter;
+        }
+    }
+    if (kCdiStatusOk == rs && CDI_MAX_ADAPTER_MEMORY_REGIONS == adapter->memory_region_count) {
+        SDK_LOG_GLOBAL(kLogError, "Cannot register more than [%d] memory regions with an adapter.",
+                       CDI_MAX_ADAPTER_MEMORY_REGIONS);
+        rs = kCdiStatusArraySizeExceeded;
+    }
+
+    if (kCdiStatusOk == rs) {
+        AdapterMemoryRegion* region_ptr = &adapter->memory_region_array[adapter->memory_region_count];
+        region_ptr->address_ptr = address_ptr;
+        region_ptr->size_in_bytes = size_in_bytes;
+        region_ptr->region_id = ++adapter->next_memory_region_id;
+        CdiOsAtomicStore32(&adapter->memory_region_count, adapter->memory_region_count + 1);
+    }
+
+    CdiOsCritSectionRelease(adapter->memory_region_lock);
+
+    return rs;
+}
+
+CdiReturnStatus CdiAdapterMemoryUnregister(CdiAdapterHandle adapter, void* address_ptr)
+{
+    CdiReturnStatus rs = kCdiStatusInvalidParameter;
+
+    CdiOsCritSectionReserve(adapter->memory_region_lock);
+
+    for (int i = 0; i < adapter->memory_region_count; i++) {
+        if (adapter->memory_region_array[i].address_ptr == address_ptr) {
+            // Let the users release their state for the region before it goes away.
+            CdiListIterator list_iterator;
+            CdiListIteratorInit(&adapter->memory_region_user_list, &list_iterator);
+            CdiListEntry* entry_ptr = NULL;
+            while (NULL != (entry_ptr = CdiListIteratorGetNext(&list_iterator))) {
+                AdapterMemoryRegionUser* user_ptr = CONTAINER_OF(entry_ptr, AdapterMemoryRegionUser, list_entry);
+                user_ptr->release_ptr(user_ptr, &adapter->memory_region_array[i]);
+            }
+
+            // Move the last entry into this one.
+            const int last_index = adapter->memory_region_count - 1;
+            adapter->memory_region_array[i] = adapter->memory_region_array[last_index];
+            CdiOsAtomicStore32(&adapter->memory_region_count, last_index);
+            rs = kCdiStatusOk;
+            break;
+        }
+    }
+
+    CdiOsCritSectionRelease(adapter->memory_region_lock);
+
+    return rs;
+}
+
+bool CdiAdapterMemoryRegionFind(CdiAdapterHandle adapter, const void* address_ptr, uint64_t size_in_bytes,
+                                AdapterMemoryRegion* ret_region_ptr)
+{
+    bool found = false;
+    const uint8_t* start_ptr = (const uint8_t*)address_ptr;
+
+    CdiOsCritSectionReserve(adapter->memory_region_lock);
+
+    for (int i = 0; !found && i < adapter->memory_region_count; i++) {
+        const AdapterMemoryRegion* region_ptr = &adapter->memory_region_array[i];
+        const uint8_t* region_start_ptr = (const uint8_t*)region_ptr->address_ptr;
+        if (start_ptr >= region_start_ptr &&
+            start_ptr + size_in_bytes <= region_start_ptr + region_ptr->size_in_bytes) {
+            *ret_region_ptr = *region_ptr;
+            found = true;
+        }
+    }
+
+    CdiOsCritSectionRelease(adapter->memory_region_lock);
+
+    return found;
+}
+
+void CdiAdapterMemoryRegionUserAdd(CdiAdapterHandle adapter, AdapterMemoryRegionUser* user_ptr)
+{
+    CdiOsCritSectionReserve(adapter->memory_region_lock);
+    CdiListAddTail(&adapter->memory_region_user_list, &user_ptr->list_entry);
+    CdiOsCritSectionRelease(adapter->memory_region_lock);
+}
+
+void CdiAdapterMemoryRegionUserRemove(CdiAdapterHandle adapter, AdapterMemoryRegionUser* user_ptr)
+{
+    CdiOsCritSectionReserve(adapter->memory_region_lock);
+    CdiListRemove(&adapter->memory_region_user_list, &user_ptr->list_entry);
+    // Mark the entry as not being in a list, so removing it again does nothing.
+    user_ptr->list_entry.next_ptr = NULL;
+    CdiOsCritSectionRelease(adapter->memory_region_lock);
+}
+
 CdiReturnStatus CdiAdapterShutdown(CdiAdapterHandle adapter)
 {
     // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
@@ -1057,3 +1232,18 @@ void CdiAdapterTxPacketComplete(AdapterEndpointHandle handle, const Packet* pack
         CdiOsAtomicDec32(&handle->tx_in_flight_ref_count);
     }
 }
+
+void CdiAdapterTxPacketsComplete(AdapterEndpointHandle handle, const CdiSinglyLinkedList* packet_list_ptr)
+{
+    // Same counts as CdiAdapterTxPacketComplete(), but taken off the in-flight count with a single atomic operation.
+    uint32_t ref_count = 0;
+    for (CdiSinglyLinkedListEntry* entry_ptr = CdiSinglyLinkedListGetHead(packet_list_ptr); NULL != entry_ptr;
+            entry_ptr = CdiSinglyLinkedListNextEntry(entry_ptr)) {
+        const Packet* packet_ptr = CONTAINER_OF(entry_ptr, Packet, list_entry);
+        ref_count += packet_ptr->payload_last_packet ? 2 : 1;
+    }
+    if (ref_count) {
+        assert(ref_count <= CdiOsAtomicLoad32(&handle->tx_in_flight_ref_count));
+        CdiOsAtomicAdd32(&handle->tx_in_flight_ref_count, (uint32_t)0 - ref_count);
+    }
+}
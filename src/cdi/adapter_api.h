@@ -31,7 +31,11 @@ typedef struct ControlInterfaceState* ControlInterfaceHandle;
  * @brief Values used for adapter packet acknowledgment status.
  */
 typedef enum {
-    kAdapterPacketStatusOk,           ///< The transmitted packet was acknowledged to have been received.
+    /// @brief The transmitted packet was acknowledged to have been received. NOTE: Packets that the EFA adapter sent
+    /// with fi_inject() have no completion of their own, so they get this status once libfabric has copied them, which
+    /// is before they are delivered. An error delivering such a packet is only seen through a later packet of the
+    /// endpoint, or through the probe resetting the connection.
+    kAdapterPacketStatusOk,
     kAdapterPacketStatusFailed,       ///< The packet transmission resulted in an error.
     kAdapterPacketStatusNotConnected, ///< The packet could not be sent because the adapter endpoint isn't connected.
 } AdapterPacketAckStatus;
@@ -43,9 +47,18 @@ typedef struct {
     CdiSinglyLinkedListEntry list_entry; ///< This member is needed for these to be members of a list.
     CdiSgList sg_list; ///< List of buffer fragments that comprise the packet's data.
     bool payload_last_packet; ///< True if last packet of a payload.
+
+    /// @brief Only used by received packets. If not NULL, the transmitter has already written all the data of the
+    /// packet's payload into the receive buffer slot described by this entry, so the packet only holds the CDI header
+    /// of packet #0 (see RxAdapterConnectionState.rma_slot_size). The entry must be freed using CdiAdapterFreeBuffer().
+    CdiSglEntry* rma_slot_entry_ptr;
+
     union {
         struct TxState {
             AdapterPacketAckStatus ack_status; ///< Status of the packet.
+            /// @brief Rate in bytes per millisecond at which the packets of the payload are sent. Zero if the packet
+            /// is not paced.
+            uint32_t pacing_bytes_per_millisec;
         } tx_state;
     };
 
@@ -104,6 +117,30 @@ typedef enum {
  */
 typedef void (*MessageFromEndpoint)(void* param_ptr, Packet* packet_ptr, EndpointMessageType message_type);
 
+/**
+ * @brief Prototype of function used to process the packet messages of several packets from the endpoint at once. It
+ * must have the same effect as calling the endpoint's MessageFromEndpoint function for each packet in the list.
+ *
+ * @param param_ptr A pointer to data used by the function.
+ * @param packet_list_ptr A pointer to the list of packets, linked through Packet.list_entry. The function may reuse
+ *                        the list entries of the packets, so the list is no longer valid once the function returns.
+ * @param message_type Endpoint message type of all of the packets.
+ */
+typedef void (*MessagesFromEndpoint)(void* param_ptr, CdiSinglyLinkedList* packet_list_ptr,
+                                     EndpointMessageType message_type);
+
+/**
+ * @brief State of the software token bucket used to pace the packets sent by a Tx adapter endpoint. Only accessed by
+ * the endpoint's poll thread.
+ */
+typedef struct {
+    /// @brief Bytes that may be sent right now, in thousandths of a byte. Sending a packet is allowed while it is not
+    /// negative, so the bucket can go into debt by up to one packet.
+    int64_t credit_millibytes;
+    uint64_t last_update_microsecs; ///< Time that credit_millibytes was last updated.
+    uint32_t bytes_per_millisec;    ///< Rate of the last packet sent. Zero if it was not paced.
+} AdapterTxPacerState;
+
 /**
  * @brief Structure used to hold adapter endpoint state.
  */
@@ -117,6 +154,9 @@ struct AdapterEndpointState {
     /// @brief Address of function used to queue packet messages from the endpoint.
     MessageFromEndpoint msg_from_endpoint_func_ptr;
     void* msg_from_endpoint_param_ptr;    ///< Parameter passed to queue message function.
+    /// @brief Address of function used to queue the messages of several packets from the endpoint at once. If NULL,
+    /// msg_from_endpoint_func_ptr is called for each packet. Also passed msg_from_endpoint_param_ptr.
+    MessagesFromEndpoint msgs_from_endpoint_func_ptr;
 
     /// @brief Current state of this endpoint. NOTE: Made volatile, since it is written to and read by different
     /// threads. The reader uses the value within a loop, so we don't want the value to be cached and held in a
@@ -145,6 +185,12 @@ struct AdapterEndpointState {
     /// packets of a payload have been ACKed.
     uint32_t tx_in_flight_ref_count;
 
+    AdapterTxPacerState tx_pacer; ///< Software pacer state. Not used if tx_pacing_offloaded is true.
+
+    /// @brief True if the adapter paces Tx packets itself (ie. using SO_TXTIME), so the poll thread must not hold them
+    /// back. Set by the adapter when the endpoint is opened.
+    bool tx_pacing_offloaded;
+
     void* type_specific_ptr; ///< Adapter specific endpoint data.
 };
 
@@ -157,6 +203,23 @@ typedef struct AdapterEndpointState* AdapterEndpointHandle;
 typedef struct {
     /// @brief Number of packet buffers to reserve for incoming payloads.
     int reserve_packet_buffers;
+
+    /// @brief Size in bytes of each receive buffer slot that the transmitter may write payloads into directly. Zero if
+    /// RMA direct placement is not used. See CdiRxConfigData.rma_direct_placement.
+    uint32_t rma_slot_size;
+
+    /// @brief True if packet buffers should be posted as FI_MULTI_RECV buffers if supported. See
+    /// CdiRxConfigData.multi_receive_buffers.
+    bool multi_receive_buffers;
+
+    /// @brief True if the endpoints of the connection should share a completion queue with the other connections of
+    /// its poll thread. See
+    /// CdiRxConfigData.shared_completion_queue.
+    bool shared_completion_queue;
+
+    /// @brief Maximum number of packet buffers of the adapter's shared receive pool that the connection may hold. Zero
+    /// if the connection reserves its own packet buffers. See CdiRxConfigData.shared_rx_packet_quota.
+    int shared_packet_quota;
 } RxAdapterConnectionState;
 
 /**
@@ -321,9 +384,10 @@ struct AdapterVirtualFunctionPtrTable {
     /// @see CdiAdapterGetTransmitQueueLevel
     EndpointTransmitQueueLevel (*GetTransmitQueueLevel)(AdapterEndpointHandle handle);
 
-    /// @brief Sends the data in memory specified by the SGL to the endpoint.
+    /// @brief Sends the data in memory specified by the SGL to the endpoint. The adapter owns the packet until it
+    /// has passed it back through the endpoint's message function, and may link it into lists of its own until then.
     /// @see CdiAdapterEnqueueSendPacket
-    CdiReturnStatus (*Send)(const AdapterEndpointHandle handle, const Packet* packet_ptr, bool flush_packets);
+    CdiReturnStatus (*Send)(const AdapterEndpointHandle handle, Packet* packet_ptr, bool flush_packets);
 
     /// @brief Returns a receive data buffer to the endpoint's free pool.
     /// @see CdiAdapterFreeBuffer
@@ -346,6 +410,37 @@ struct AdapterVirtualFunctionPtrTable {
     CdiReturnStatus (*Shutdown)(CdiAdapterHandle adapter);
 };
 
+/**
+ * @brief Structure used to hold an application memory region registered with an adapter using
+ * CdiCoreNetworkAdapterMemoryRegister().
+ */
+typedef struct {
+    void* address_ptr;      ///< Starting address of the region.
+    uint64_t size_in_bytes; ///< Size of the region in bytes.
+    uint32_t region_id;     ///< Identifier that is unique to each registration with the adapter. Never zero.
+} AdapterMemoryRegion;
+
+/// @brief Forward reference of structure to create pointers later.
+typedef struct AdapterMemoryRegionUser AdapterMemoryRegionUser;
+
+/**
+ * Prototype of function called by CdiAdapterMemoryUnregister() for each memory region user of the adapter, so it can
+ * release any state it holds for the region. Called with CdiAdapterState.memory_region_lock held.
+ *
+ * @param user_ptr Pointer to the memory region user.
+ * @param region_ptr Pointer to the region that is being unregistered.
+ */
+typedef void (*AdapterMemoryRegionRelease)(AdapterMemoryRegionUser* user_ptr, const AdapterMemoryRegion* region_ptr);
+
+/**
+ * @brief Structure used by an object that holds adapter specific state for registered application memory regions,
+ * such as a libfabric memory region for each region used by a Tx endpoint. See CdiAdapterMemoryRegionUserAdd().
+ */
+struct AdapterMemoryRegionUser {
+    CdiListEntry list_entry;                ///< Used to store this user in CdiAdapterState.memory_region_user_list.
+    AdapterMemoryRegionRelease release_ptr; ///< Function called when a region is unregistered.
+};
+
 /**
  * @brief Structure definition behind the handles shared with the user's application program. Its contents are opaque
  * to the user's program where it only has a pointer to a declared but not defined structure.
@@ -403,6 +498,23 @@ struct CdiAdapterState {
     /// @brief Size in bytes of Tx payload buffer allocated. Pointer to buffer is in CdiAdapterData.ret_tx_buffer_ptr.
     /// NOTE: The allocation may be larger than requested, due to rounding.
     uint64_t tx_buffer_allocated_size;
+
+    /// @brief Lock used to protect access to the memory region data below. Unlike adapter_lock, it is never held while
+    /// waiting for another thread, so poll threads can use it while sending packets.
+    CdiCsID memory_region_lock;
+
+    /// @brief Application memory regions that Tx payloads can use in addition to the Tx payload buffer. NOTE: Must
+    /// acquire memory_region_lock before using.
+    AdapterMemoryRegion memory_region_array[CDI_MAX_ADAPTER_MEMORY_REGIONS];
+
+    /// @brief Number of entries in memory_region_array. Only written with memory_region_lock held, so it can be read
+    /// atomically without the lock to skip looking for regions when none are registered.
+    int memory_region_count;
+    uint32_t next_memory_region_id;  ///< Identifier assigned to the next region that is registered.
+
+    /// @brief List of AdapterMemoryRegionUser objects that hold state for the regions. NOTE: Must acquire
+    /// memory_region_lock before using.
+    CdiList memory_region_user_list;
 };
 
 /**
@@ -454,6 +566,9 @@ typedef struct {
     /// @brief Address of function used to queue messages from this endpoint.
     MessageFromEndpoint msg_from_endpoint_func_ptr;
     void* msg_from_endpoint_param_ptr; ///< Pointer to parameter passed to queue message function.
+    /// @brief Optional address of function used to queue the messages of several packets from this endpoint at once.
+    /// See AdapterEndpointState.msgs_from_endpoint_func_ptr.
+    MessagesFromEndpoint msgs_from_endpoint_func_ptr;
 
     /// @brief Address where to write adapter endpoint statistics.
     CdiAdapterEndpointStats* endpoint_stats_ptr;
@@ -648,6 +763,64 @@ CdiReturnStatus CdiAdapterFreeBuffer(const AdapterEndpointHandle handle, const C
  */
 CdiReturnStatus CdiAdapterGetPort(const AdapterEndpointHandle handle, int* port_number_ptr);
 
+/**
+ * Register an application memory region with an adapter so Tx payloads can use it. The region must not overlap the
+ * adapter's Tx payload buffer or another registered region.
+ *
+ * @param adapter A handle to the adapter.
+ * @param address_ptr Starting address of the region.
+ * @param size_in_bytes Size of the region in bytes.
+ *
+ * @return kCdiStatusOk if successful, kCdiStatusArraySizeExceeded if CDI_MAX_ADAPTER_MEMORY_REGIONS regions are
+ *         already registered, otherwise a value that indicates the nature of the failure.
+ */
+CdiReturnStatus CdiAdapterMemoryRegister(CdiAdapterHandle adapter, void* address_ptr, uint64_t size_in_bytes);
+
+/**
+ * Unregister an application memory region that was registered using CdiAdapterMemoryRegister(). The adapter
+ * specific state of every memory region user for the region, such as libfabric memory regions, is released before
+ * this returns.
+ *
+ * @param adapter A handle to the adapter.
+ * @param address_ptr Starting address of the region.
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CdiReturnStatus CdiAdapterMemoryUnregister(CdiAdapterHandle adapter, void* address_ptr);
+
+/**
+ * Find the registered application memory region that contains a block of memory. If the caller holds
+ * CdiAdapterState.memory_region_lock, the region remains registered until it releases the lock.
+ *
+ * @param adapter A handle to the adapter.
+ * @param address_ptr Starting address of the block.
+ * @param size_in_bytes Size of the block in bytes.
+ * @param ret_region_ptr Address where to write a copy of the region data if found.
+ *
+ * @return true if the block is entirely within a registered region, otherwise false.
+ */
+bool CdiAdapterMemoryRegionFind(CdiAdapterHandle adapter, const void* address_ptr, uint64_t size_in_bytes,
+                                AdapterMemoryRegion* ret_region_ptr);
+
+/**
+ * Add a memory region user to an adapter. Its release function is called for every region that is unregistered from
+ * then on, until it is removed using CdiAdapterMemoryRegionUserRemove().
+ *
+ * @param adapter A handle to the adapter.
+ * @param user_ptr Pointer to the memory region user. Its release_ptr must be set.
+ */
+void CdiAdapterMemoryRegionUserAdd(CdiAdapterHandle adapter, AdapterMemoryRegionUser* user_ptr);
+
+/**
+ * Remove a memory region user that was added using CdiAdapterMemoryRegionUserAdd(). Once this returns, its release
+ * function is not called anymore. Does nothing if the user was never added or has already been removed, as long as its
+ * structure was zeroed before use.
+ *
+ * @param adapter A handle to the adapter.
+ * @param user_ptr Pointer to the memory region user.
+ */
+void CdiAdapterMemoryRegionUserRemove(CdiAdapterHandle adapter, AdapterMemoryRegionUser* user_ptr);
+
 /**
  * Shut down the adapter and free all of the resources associated with it. The caller must not use the adapter's handle
  * for any purpose after this function returns.
@@ -675,4 +848,12 @@ void CdiAdapterPollThreadFlushResources(AdapterEndpointHandle handle);
  */
 void CdiAdapterTxPacketComplete(AdapterEndpointHandle handle, const Packet* packet_ptr);
 
+/**
+ * A list of Tx packets has ACKed. Same as calling CdiAdapterTxPacketComplete() for each packet in the list.
+ *
+ * @param handle The handle of the endpoint that the Tx packets are related to.
+ * @param packet_list_ptr Pointer to list of packets, linked through Packet.list_entry.
+ */
+void CdiAdapterTxPacketsComplete(AdapterEndpointHandle handle, const CdiSinglyLinkedList* packet_list_ptr);
+
 #endif // ADAPTER_API_H__
@@ -82,6 +82,15 @@ typedef struct {
 
     /// @brief Lock used to protect access to libfabric for endpoint open/close.
     CdiCsID libfabric_lock;
+
+    /// @brief Receive packet buffers shared by Rx connections. Allocated by the first connection that uses them. See
+    /// CdiRxConfigData.shared_rx_packet_quota.
+    EfaRxSharedPacketPool* rx_shared_pool_ptr;
+
+    /// @brief List of the completion queues shared by the Rx connections of each poll thread (holds
+    /// EfaSharedCompletionQueue*). See CdiRxConfigData.shared_completion_queue. NOTE: Must acquire libfabric_lock
+    /// before using it.
+    CdiList rx_shared_cq_list;
 } EfaAdapterState;
 
 //*********************************************************************************************************************
@@ -115,10 +124,11 @@ static struct AdapterVirtualFunctionPtrTable efa_endpoint_functions = {
  * structure.
  *
  * @param is_socket_based Specifies whether the adapter is socket-based (true) or EFA-based (false).
+ * @param optional_caps Additional capabilities to require, such as for RMA direct placement. Use zero if not needed.
  *
  * @return Pointer to new hints structure. Returns NULL if unable to allocate memory.
  */
-static struct fi_info* CreateHints(bool is_socket_based)
+static struct fi_info* CreateHints(bool is_socket_based, uint64_t optional_caps)
 {
     char* provider_name = NULL;
     if (is_socket_based) {
@@ -133,7 +143,7 @@ static struct fi_info* CreateHints(bool is_socket_based)
         hints_ptr->fabric_attr->prov_name = provider_name;
         hints_ptr->ep_attr->type = FI_EP_RDM;
         hints_ptr->domain_attr->resource_mgmt = FI_RM_ENABLED;
-        hints_ptr->caps = FI_MSG;
+        hints_ptr->caps = FI_MSG | optional_caps;
         hints_ptr->mode = FI_CONTEXT;
         hints_ptr->domain_attr->mr_mode = FI_MR_LOCAL | FI_MR_ALLOCATED | FI_MR_VIRT_ADDR;
         if (!is_socket_based) {
@@ -221,16 +231,67 @@ static CdiReturnStatus LibFabricEndpointOpen(EfaEndpointState* endpoint_ptr)
         node_str = NULL;
     }
 
-    struct fi_info* hints_ptr = CreateHints(is_socket_based);
+    // A transmitter always asks for RMA writes, since it only learns whether the receiver wants payloads placed
+    // directly after connecting.
+    uint64_t rma_caps = 0;
+    uint64_t multi_recv_caps = 0;
+    if (is_transmitter) {
+        rma_caps = FI_RMA | FI_WRITE;
+    } else {
+        const RxAdapterConnectionState* rx_con_ptr =
+            &endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->rx_state;
+        if (0 != rx_con_ptr->rma_slot_size) {
+            rma_caps = FI_RMA | FI_REMOTE_WRITE;
+        }
+        const EfaConnectionState* efa_con_ptr =
+            (EfaConnectionState*)endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->type_specific_ptr;
+        // Buffers of the shared receive pool are posted one per packet.
+        if (rx_con_ptr->multi_receive_buffers && NULL == efa_con_ptr->shared_pool_ptr) {
+            multi_recv_caps = FI_MULTI_RECV;
+        }
+    }
+    struct fi_info* hints_ptr = CreateHints(is_socket_based, rma_caps | multi_recv_caps);
     if (NULL == hints_ptr) {
         rs = kCdiStatusAllocationFailed;
     }
 
     if (kCdiStatusOk == rs) {
-        int ret = fi_getinfo(FT_FIVERSION, node_str, service_str, flags, hints_ptr, &endpoint_ptr->fabric_info_ptr);
+        // If the provider does not support some of the optional capabilities, payloads are sent in packets instead of
+        // being placed with RMA writes, and one receive buffer is posted per packet instead of FI_MULTI_RECV buffers.
+        uint64_t optional_caps_array[EFA_OPTIONAL_CAPS_SET_COUNT];
+        const int optional_caps_count = EfaAdapterOptionalCapsGet(rma_caps, multi_recv_caps, optional_caps_array);
+        int ret = 0;
+        for (int i = 0; i < optional_caps_count; i++) {
+            hints_ptr->caps = (hints_ptr->caps & ~(rma_caps | multi_recv_caps)) | optional_caps_array[i];
+            ret = fi_getinfo(FT_FIVERSION, node_str, service_str, flags, hints_ptr, &endpoint_ptr->fabric_info_ptr);
+            if (0 == ret) {
+                break;
+            }
+        }
         CHECK_LIBFABRIC_RC(fi_getinfo, ret);
     }
 
+    if (kCdiStatusOk == rs) {
+        // The slot number of a payload placed with RMA is sent to the receiver as remote CQ data.
+        endpoint_ptr->rma_supported = 0 != rma_caps &&
+                                      rma_caps == (endpoint_ptr->fabric_info_ptr->caps & rma_caps) &&
+                                      endpoint_ptr->fabric_info_ptr->domain_attr->cq_data_size > 0;
+        if (0 != rma_caps && !endpoint_ptr->rma_supported) {
+            CDI_LOG_HANDLE(endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->log_handle, kLogInfo,
+                           "Provider[%s] does not support RMA writes. RMA direct placement is disabled.",
+                           endpoint_ptr->fabric_info_ptr->fabric_attr->prov_name);
+        }
+        if (!is_transmitter) {
+            endpoint_ptr->rx_state.multi_recv_supported =
+                0 != multi_recv_caps && 0 != (endpoint_ptr->fabric_info_ptr->caps & multi_recv_caps);
+            if (0 != multi_recv_caps && !endpoint_ptr->rx_state.multi_recv_supported) {
+                CDI_LOG_HANDLE(endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->log_handle, kLogInfo,
+                               "Provider[%s] does not support FI_MULTI_RECV. Posting one receive buffer per packet.",
+                               endpoint_ptr->fabric_info_ptr->fabric_attr->prov_name);
+            }
+        }
+    }
+
     if (kCdiStatusOk == rs && !is_socket_based) {
         // The SDK does not expect to receive packets in order. For best performance don't require packet ordering.
         endpoint_ptr->fabric_info_ptr->tx_attr->msg_order = FI_ORDER_NONE;
@@ -239,18 +300,55 @@ static CdiReturnStatus LibFabricEndpointOpen(EfaEndpointState* endpoint_ptr)
             endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->adapter_state_ptr->maximum_payload_bytes;
     }
 
-    if (kCdiStatusOk == rs) {
+    // The Rx endpoints of the connections that use the same poll thread may share the fabric, domain and completion
+    // queue of the first one opened. See CdiRxConfigData.shared_completion_queue.
+    EfaSharedCompletionQueue* shared_cq_ptr = NULL;
+    if (kCdiStatusOk == rs && !is_transmitter) {
+        EfaConnectionState* efa_con_ptr =
+            (EfaConnectionState*)endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->type_specific_ptr;
+        shared_cq_ptr = efa_con_ptr->shared_cq_ptr;
+    }
+    if (shared_cq_ptr) {
+        // Hold the lock until the endpoint has posted its receive buffers, since the shared objects are used with
+        // FI_THREAD_DOMAIN.
+        CdiOsCritSectionReserve(shared_cq_ptr->lock);
+        const char* domain_name_str = endpoint_ptr->fabric_info_ptr->domain_attr->name;
+        if (0 == shared_cq_ptr->endpoint_count) {
+            CdiOsStrCpy(shared_cq_ptr->domain_name_str, sizeof(shared_cq_ptr->domain_name_str),
+                        domain_name_str ? domain_name_str : "");
+        } else if (NULL == domain_name_str || 0 != strcmp(domain_name_str, shared_cq_ptr->domain_name_str)) {
+            CDI_LOG_HANDLE(endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->log_handle, kLogInfo,
+                           "Endpoint uses domain[%s] instead of[%s], so it can't share the completion queue.",
+                           domain_name_str ? domain_name_str : "", shared_cq_ptr->domain_name_str);
+            CdiOsCritSectionRelease(shared_cq_ptr->lock);
+            shared_cq_ptr = NULL;
+        } else if (EFA_SHARED_CQ_MAX_ENDPOINTS <= shared_cq_ptr->endpoint_count) {
+            CDI_LOG_HANDLE(endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->log_handle, kLogInfo,
+                           "Completion queue is already shared by [%d] endpoints, so the endpoint uses its own.",
+                           shared_cq_ptr->endpoint_count);
+            CdiOsCritSectionRelease(shared_cq_ptr->lock);
+            shared_cq_ptr = NULL;
+        } else {
+            endpoint_ptr->fabric_ptr = shared_cq_ptr->fabric_ptr;
+            endpoint_ptr->domain_ptr = shared_cq_ptr->domain_ptr;
+            endpoint_ptr->completion_queue_ptr = shared_cq_ptr->completion_queue_ptr;
+            endpoint_ptr->shared_cq_ptr = shared_cq_ptr;
+            shared_cq_ptr->endpoint_count++;
+        }
+    }
+
+    if (kCdiStatusOk == rs && NULL == endpoint_ptr->shared_cq_ptr) {
         int ret = fi_fabric(endpoint_ptr->fabric_info_ptr->fabric_attr, &endpoint_ptr->fabric_ptr, NULL);
         CHECK_LIBFABRIC_RC(fi_fabric, ret);
     }
 
-    if (kCdiStatusOk == rs) {
+    if (kCdiStatusOk == rs && NULL == endpoint_ptr->shared_cq_ptr) {
         int ret = fi_domain(endpoint_ptr->fabric_ptr, endpoint_ptr->fabric_info_ptr,
                         &endpoint_ptr->domain_ptr, NULL);
         CHECK_LIBFABRIC_RC(fi_domain, ret);
     }
 
-    if (kCdiStatusOk == rs) {
+    if (kCdiStatusOk == rs && NULL == endpoint_ptr->shared_cq_ptr) {
         struct fi_cq_attr completion_queue_attr = {
             .wait_obj = FI_WAIT_NONE,
             .format = FI_CQ_FORMAT_DATA
@@ -259,6 +357,9 @@ static CdiReturnStatus LibFabricEndpointOpen(EfaEndpointState* endpoint_ptr)
         if (is_transmitter) {
             // For transmitter.
             completion_queue_attr.size = endpoint_ptr->fabric_info_ptr->tx_attr->size;
+        } else if (shared_cq_ptr) {
+            // For receivers that share the completion queue.
+            completion_queue_attr.size = endpoint_ptr->fabric_info_ptr->rx_attr->size * EFA_SHARED_CQ_MAX_ENDPOINTS;
         } else {
             // For receiver.
             completion_queue_attr.size = endpoint_ptr->fabric_info_ptr->rx_attr->size;
@@ -267,6 +368,16 @@ static CdiReturnStatus LibFabricEndpointOpen(EfaEndpointState* endpoint_ptr)
         int ret = fi_cq_open(endpoint_ptr->domain_ptr, &completion_queue_attr,
                              &endpoint_ptr->completion_queue_ptr, &endpoint_ptr->completion_queue_ptr);
         CHECK_LIBFABRIC_RC(fi_cq_open, ret);
+
+        if (kCdiStatusOk == rs && shared_cq_ptr) {
+            // First endpoint of the poll thread, so the others will use its objects.
+            shared_cq_ptr->fabric_ptr = endpoint_ptr->fabric_ptr;
+            shared_cq_ptr->domain_ptr = endpoint_ptr->domain_ptr;
+            shared_cq_ptr->completion_queue_ptr = endpoint_ptr->completion_queue_ptr;
+            shared_cq_ptr->polls_since_read = 0;
+            endpoint_ptr->shared_cq_ptr = shared_cq_ptr;
+            shared_cq_ptr->endpoint_count = 1;
+        }
     }
 
     if (kCdiStatusOk == rs) {
@@ -315,13 +426,17 @@ static CdiReturnStatus LibFabricEndpointOpen(EfaEndpointState* endpoint_ptr)
                 rs = kCdiStatusInvalidParameter;
             } else {
                 // Register the Tx buffer with libfabric.
+                // Payload data may also be the source of RMA writes.
+                uint64_t access = FI_SEND | (endpoint_ptr->rma_supported ? FI_WRITE : 0);
                 int ret = fi_mr_reg(endpoint_ptr->domain_ptr, adapter_state_ptr->adapter_data.ret_tx_buffer_ptr,
-                                adapter_state_ptr->adapter_data.tx_buffer_size_bytes, FI_SEND, 0, 0, 0,
+                                adapter_state_ptr->adapter_data.tx_buffer_size_bytes, access, 0, 0, 0,
                                 &endpoint_ptr->tx_state.memory_region_ptr, NULL);
                 CHECK_LIBFABRIC_RC(fi_mr_reg, ret);
                 if (NULL == endpoint_ptr->tx_state.memory_region_ptr) {
                     SDK_LOG_GLOBAL(kLogError, "fi_mr_reg failed to register Tx memory.");
                     rs = kCdiStatusFatal;
+                } else {
+                    EfaTxMemoryRegionCacheInit(endpoint_ptr);
                 }
             }
         } else {
@@ -329,6 +444,9 @@ static CdiReturnStatus LibFabricEndpointOpen(EfaEndpointState* endpoint_ptr)
             // receiver-not-ready (RNR) logic in libfabric will prevent the transmitter from sending before the receiver
             // is ready.
             rs = EfaRxPacketPoolCreate(endpoint_ptr);
+            if (kCdiStatusOk == rs && endpoint_ptr->rma_supported) {
+                rs = EfaRxRmaSlotsRegister(endpoint_ptr);
+            }
         }
     }
 
@@ -354,6 +472,10 @@ static CdiReturnStatus LibFabricEndpointOpen(EfaEndpointState* endpoint_ptr)
         fi_freeinfo(hints_ptr);
     }
 
+    if (shared_cq_ptr) {
+        CdiOsCritSectionRelease(shared_cq_ptr->lock);
+    }
+
     CdiOsCritSectionRelease(efa_adapter_state_ptr->libfabric_lock);
 
     return rs;
@@ -378,6 +500,12 @@ static CdiReturnStatus LibFabricEndpointClose(EfaEndpointState* endpoint_ptr)
 
     bool is_transmitter = (kEndpointDirectionSend == endpoint_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->direction);
 
+    // Hold the lock of shared objects while closing, since PollThread() may be using them for other endpoints.
+    CdiCsID shared_cq_lock = endpoint_ptr->shared_cq_ptr ? endpoint_ptr->shared_cq_ptr->lock : NULL;
+    if (shared_cq_lock) {
+        CdiOsCritSectionReserve(shared_cq_lock);
+    }
+
     {
         char gid_name_str[MAX_IPV6_ADDRESS_STRING_LENGTH];
         DeviceGidToString(endpoint_ptr->local_ipv6_gid_array,
@@ -398,6 +526,24 @@ static CdiReturnStatus LibFabricEndpointClose(EfaEndpointState* endpoint_ptr)
         endpoint_ptr->address_vector_ptr = NULL;
     }
 
+    EfaSharedCompletionQueue* shared_cq_ptr = endpoint_ptr->shared_cq_ptr;
+    if (shared_cq_ptr) {
+        EfaRxSharedCompletionQueueDrain(endpoint_ptr);
+        if (0 == --shared_cq_ptr->endpoint_count) {
+            // Last endpoint using the shared objects, so close them below.
+            shared_cq_ptr->fabric_ptr = NULL;
+            shared_cq_ptr->domain_ptr = NULL;
+            shared_cq_ptr->completion_queue_ptr = NULL;
+            shared_cq_ptr->backlog_count = 0;
+        } else {
+            // Other endpoints still use them.
+            endpoint_ptr->completion_queue_ptr = NULL;
+            endpoint_ptr->domain_ptr = NULL;
+            endpoint_ptr->fabric_ptr = NULL;
+        }
+        endpoint_ptr->shared_cq_ptr = NULL;
+    }
+
     if (endpoint_ptr->completion_queue_ptr) {
         int ret = fi_close(&endpoint_ptr->completion_queue_ptr->fid);
         CHECK_LIBFABRIC_RC(fi_close, ret);
@@ -405,12 +551,14 @@ static CdiReturnStatus LibFabricEndpointClose(EfaEndpointState* endpoint_ptr)
     }
 
     if (is_transmitter) {
+        EfaTxMemoryRegionCacheFlush(endpoint_ptr);
         if (endpoint_ptr->tx_state.memory_region_ptr) {
             int ret = fi_close(&endpoint_ptr->tx_state.memory_region_ptr->fid);
             CHECK_LIBFABRIC_RC(fi_close, ret);
             endpoint_ptr->tx_state.memory_region_ptr = NULL;
         }
     } else {
+        EfaRxRmaSlotsUnregister(endpoint_ptr);
         EfaRxPacketPoolFree(endpoint_ptr);
     }
 
@@ -431,6 +579,10 @@ static CdiReturnStatus LibFabricEndpointClose(EfaEndpointState* endpoint_ptr)
         endpoint_ptr->fabric_info_ptr = NULL;
     }
 
+    if (shared_cq_lock) {
+        CdiOsCritSectionRelease(shared_cq_lock);
+    }
+
     CdiOsCritSectionRelease(efa_adapter_state_ptr->libfabric_lock);
 
     return rs;
@@ -489,6 +641,36 @@ static CdiReturnStatus EfaConnectionCreate(AdapterConnectionHandle handle, int p
         efa_con_ptr->adapter_con_ptr = handle;
     }
 
+    EfaAdapterState* efa_adapter_state_ptr = (EfaAdapterState*)handle->adapter_state_ptr->type_specific_ptr;
+    if (kCdiStatusOk == rs && kEndpointDirectionReceive == handle->direction &&
+        handle->rx_state.shared_completion_queue && !efa_adapter_state_ptr->is_socket_based) {
+        // Shared with the other Rx connections of the poll thread. See LibFabricEndpointOpen().
+        CdiOsCritSectionReserve(efa_adapter_state_ptr->libfabric_lock);
+        rs = EfaRxSharedCompletionQueueGet(&efa_adapter_state_ptr->rx_shared_cq_list, handle->poll_thread_state_ptr,
+                                           &efa_con_ptr->shared_cq_ptr);
+        CdiOsCritSectionRelease(efa_adapter_state_ptr->libfabric_lock);
+    }
+
+    if (kCdiStatusOk == rs && kEndpointDirectionReceive == handle->direction &&
+        0 < handle->rx_state.shared_packet_quota) {
+        const CdiAdapterState* adapter_state_ptr = handle->adapter_state_ptr;
+        const int pool_packet_count = adapter_state_ptr->adapter_data.rx_shared_packet_buffers;
+        if (0 >= pool_packet_count) {
+            SDK_LOG_GLOBAL(kLogWarning, "Adapter has no shared receive packet buffers (rx_shared_packet_buffers is "
+                           "zero). Reserving packet buffers for the connection.");
+        } else {
+            // The pool is kept until the adapter is shut down. See EfaAdapterShutdown().
+            CdiOsCritSectionReserve(efa_adapter_state_ptr->libfabric_lock);
+            if (NULL == efa_adapter_state_ptr->rx_shared_pool_ptr) {
+                const int packet_size = adapter_state_ptr->maximum_payload_bytes + adapter_state_ptr->msg_prefix_size;
+                rs = EfaRxSharedPacketPoolCreate(packet_size, pool_packet_count,
+                                                 &efa_adapter_state_ptr->rx_shared_pool_ptr);
+            }
+            efa_con_ptr->shared_pool_ptr = efa_adapter_state_ptr->rx_shared_pool_ptr;
+            CdiOsCritSectionRelease(efa_adapter_state_ptr->libfabric_lock);
+        }
+    }
+
     if (kCdiStatusOk == rs) {
         // Create a single control interface that will be shared across all endpoints associated with this
         // connection. Each control command that is received must contain data unique to each endpoint to ensure
@@ -535,6 +717,13 @@ static CdiReturnStatus EfaConnectionDestroy(AdapterConnectionHandle handle)
                 ControlInterfaceDestroy(adapter_con_ptr->control_interface_handle);
                 adapter_con_ptr->control_interface_handle = NULL;
             }
+            if (efa_con_ptr->shared_cq_ptr) {
+                EfaAdapterState* efa_adapter_state_ptr =
+                    (EfaAdapterState*)adapter_con_ptr->adapter_state_ptr->type_specific_ptr;
+                CdiOsCritSectionReserve(efa_adapter_state_ptr->libfabric_lock);
+                EfaRxSharedCompletionQueuePut(&efa_adapter_state_ptr->rx_shared_cq_list, efa_con_ptr->shared_cq_ptr);
+                CdiOsCritSectionRelease(efa_adapter_state_ptr->libfabric_lock);
+            }
             CdiOsMemFree(efa_con_ptr);
             adapter_con_ptr->type_specific_ptr = NULL;
         }
@@ -737,6 +926,8 @@ static CdiReturnStatus EfaAdapterShutdown(CdiAdapterHandle adapter_handle)
             if (efa_adapter_state_ptr->control_interface_adapter_handle) {
                 rs = NetworkAdapterDestroyInternal(efa_adapter_state_ptr->control_interface_adapter_handle);
             }
+            // All connections have been destroyed, so no packet buffers of the shared pool are in use.
+            EfaRxSharedPacketPoolDestroy(efa_adapter_state_ptr->rx_shared_pool_ptr);
             CdiOsCritSectionDelete(efa_adapter_state_ptr->libfabric_lock);
             CdiOsMemFree(efa_adapter_state_ptr);
             adapter_handle->type_specific_ptr = NULL;
@@ -861,6 +1052,7 @@ CdiReturnStatus EfaNetworkAdapterInitialize(CdiAdapterState* adapter_state_ptr,
         rs = kCdiStatusNotEnoughMemory;
     } else {
         efa_adapter_state_ptr->is_socket_based = is_socket_based;
+        CdiListInit(&efa_adapter_state_ptr->rx_shared_cq_list);
     }
 
     if (kCdiStatusOk == rs) {
@@ -921,7 +1113,7 @@ CdiReturnStatus EfaNetworkAdapterInitialize(CdiAdapterState* adapter_state_ptr,
             adapter_state_ptr->maximum_payload_bytes = MAX_TCP_PACKET_SIZE - adapter_state_ptr->msg_prefix_size;
 
         } else {
-            struct fi_info* hints_ptr = CreateHints(is_socket_based);
+            struct fi_info* hints_ptr = CreateHints(is_socket_based, 0);
             if (NULL == hints_ptr) {
                 rs = kCdiStatusNotEnoughMemory;
             } else {
@@ -990,3 +1182,21 @@ CdiAdapterHandle EfaAdapterGetAdapterControlInterface(AdapterConnectionState* ad
     EfaAdapterState* efa_adapter_ptr = (EfaAdapterState*)adapter_con_state_ptr->adapter_state_ptr->type_specific_ptr;
     return efa_adapter_ptr->control_interface_adapter_handle;
 }
+
+int EfaAdapterOptionalCapsGet(uint64_t rma_caps, uint64_t multi_recv_caps, uint64_t* ret_caps_array)
+{
+    const uint64_t candidate_array[EFA_OPTIONAL_CAPS_SET_COUNT] = {
+        rma_caps | multi_recv_caps, rma_caps, multi_recv_caps, 0
+    };
+    int count = 0;
+    for (int i = 0; i < EFA_OPTIONAL_CAPS_SET_COUNT; i++) {
+        bool is_duplicate = false;
+        for (int j = 0; j < count; j++) {
+            is_duplicate = is_duplicate || candidate_array[i] == ret_caps_array[j];
+        }
+        if (!is_duplicate) {
+            ret_caps_array[count++] = candidate_array[i];
+        }
+    }
+    return count;
+}
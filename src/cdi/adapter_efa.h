@@ -30,6 +30,62 @@
 //***************************************** START OF DEFINITIONS AND TYPES ********************************************
 //*********************************************************************************************************************
 
+/// Maximum length of a libfabric domain name that can share a completion queue, including the terminating NUL.
+#define EFA_MAX_DOMAIN_NAME_LENGTH  (64)
+
+/// Maximum number of sets of optional libfabric capabilities returned by EfaAdapterOptionalCapsGet().
+#define EFA_OPTIONAL_CAPS_SET_COUNT (4)
+
+/// Maximum number of Rx endpoints that share a completion queue. The completion queue is sized for this many endpoints.
+#define EFA_SHARED_CQ_MAX_ENDPOINTS (4 * CDI_MAX_ENDPOINTS_PER_CONNECTION)
+
+/**
+ * @brief Structure used to hold an application memory region that has been registered with libfabric by a Tx endpoint.
+ * See CdiCoreNetworkAdapterMemoryRegister().
+ */
+typedef struct {
+    AdapterMemoryRegion region;       ///< Copy of the adapter's data for the region.
+    struct fid_mr* memory_region_ptr; ///< Pointer to libfabric memory region.
+} EfaTxMemoryRegionCacheEntry;
+
+/**
+ * @brief Structure used to hold the state of a payload that a Tx endpoint writes into a receive buffer slot. Only used
+ * by PollThread().
+ */
+typedef struct {
+    bool active;                ///< True until the header of packet #0 has been sent.
+    int payload_num;            ///< Payload number of the payload.
+    uint64_t remote_address;    ///< Remote address of the slot.
+    uint64_t key;               ///< Remote memory region key of the slot.
+    const Packet* packet0_ptr;  ///< Packet #0 of the payload. Its header is sent once all the data has been written.
+    int writes_in_flight;       ///< Number of RMA writes of the payload that haven't completed yet.
+    bool last_packet_written;   ///< True once the RMA write of the payload's last packet has been posted.
+    /// @brief Context of the write of packet #0's data. Its completion is not reported to the SDK, since packet #0
+    /// completes when its header has been sent.
+    struct fi_context packet0_write_context;
+} EfaTxRmaPayload;
+
+/**
+ * @brief Structure used to hold the state of RMA direct placement for a Tx endpoint. The transmitter writes the data of
+ * a payload that fits into one of the receive buffer slots advertised by the receiver directly into it and then sends
+ * only the header of packet #0 with the slot number as remote CQ data. See CdiRxConfigData.rma_direct_placement.
+ */
+typedef struct {
+    CdiCsID lock;               ///< Protects the advertised slot data, which ProbeControlThread() updates.
+    bool slots_valid;           ///< True if a slot advertisement was received since the endpoint was reset.
+    uint64_t base_address;      ///< Remote address of the first slot.
+    uint64_t key;               ///< Remote memory region key of the slots.
+    uint32_t slot_size;         ///< Size of each slot in bytes.
+    int slot_count;             ///< Number of slots.
+    /// @brief Number of times the receiver has released each slot. A slot is free when its value matches the value in
+    /// use_count_array.
+    uint8_t release_count_array[CDI_MAX_RMA_SLOTS];
+    uint8_t use_count_array[CDI_MAX_RMA_SLOTS]; ///< Number of times each slot has been used by the transmitter.
+
+    // The members below are only used by PollThread().
+    EfaTxRmaPayload payload_array[CDI_MAX_RMA_SLOTS]; ///< State of the payload written into each slot.
+} EfaTxRmaState;
+
 /**
  * @brief This defines a structure that contains all of the state information that is specific to the Tx side of a
  * single EFA endpoint.
@@ -37,12 +93,85 @@
 typedef struct {
     CdiSignalType tx_start_signal;           ///< Signal used to wakeup the thread to do work.
     struct fid_mr* memory_region_ptr;        ///< Pointer to Tx memory region
+
+    /// @brief Application memory regions registered with libfabric by this endpoint. NOTE: Must acquire
+    /// CdiAdapterState.memory_region_lock before using, since entries are removed by CdiAdapterMemoryUnregister().
+    EfaTxMemoryRegionCacheEntry mr_cache_array[CDI_MAX_ADAPTER_MEMORY_REGIONS];
+    int mr_cache_count;                      ///< Number of entries in mr_cache_array.
+    AdapterMemoryRegionUser mr_user;         ///< Used to release mr_cache_array entries of unregistered regions.
     uint16_t tx_packets_sent_since_flush;    ///< Number of Tx packets that have been sent since last flush.
     /// Number of Tx packets that are in process (sent but haven't received ACK/error response). This member must be
     /// only written in the context of PollThread.
     int tx_packets_in_process;
+    EfaTxRmaState rma_state;                 ///< RMA direct placement state. Only used if rma_supported is true.
+
+    /// @brief Packets sent with fi_inject() that have not been completed yet, linked through Packet.list_entry. Holds
+    /// up to EFA_TX_INJECT_BATCH_SIZE packets. Only used by PollThread().
+    CdiSinglyLinkedList injected_packet_list;
 } EfaTxState;
 
+/**
+ * @brief Structure used to hold the receive buffer slots that an Rx endpoint advertises to the transmitter for RMA
+ * direct placement. See CdiRxConfigData.rma_direct_placement.
+ */
+typedef struct {
+    uint8_t* buffer_ptr;                ///< Address of the slots memory. NULL if not allocated.
+    int allocated_size;                 ///< Size of the slots memory in bytes; needed for freeing.
+    bool was_from_heap;                 ///< True if no huge pages were available; needed for freeing.
+    uint32_t slot_size;                 ///< Size of each slot in bytes.
+    int slot_count;                     ///< Number of slots.
+    struct fid_mr* memory_region_ptr;   ///< Pointer to memory region of the slots. NULL if not registered.
+    CdiCsID lock;                       ///< Protects the data below, which ProbeControlThread() reads.
+    uint8_t held_mask;                  ///< Bit set for each slot that holds a payload not yet freed.
+    uint8_t release_count_array[CDI_MAX_RMA_SLOTS]; ///< Number of times each slot has been freed.
+    bool advert_pending;                ///< True if the probe was asked to advertise the slots again.
+} EfaRxRmaSlots;
+
+/// Forward declaration of EFA endpoint state.
+typedef struct EfaEndpointState EfaEndpointState;
+
+/// Forward declaration of the libfabric objects shared by Rx endpoints.
+typedef struct EfaSharedCompletionQueue EfaSharedCompletionQueue;
+
+/**
+ * @brief Context of a receive buffer posted to libfabric. Identifies the endpoint of a completion read from a
+ * completion queue that several endpoints share.
+ */
+typedef struct {
+    struct fi_context fi_context;    ///< Reserved for libfabric, since the FI_CONTEXT mode is used.
+    EfaEndpointState* endpoint_ptr;  ///< Endpoint the receive buffer was posted to.
+} EfaRxCompletionContext;
+
+/**
+ * @brief Structure used to hold the state of a receive buffer posted with FI_MULTI_RECV. See
+ * CdiRxConfigData.multi_receive_buffers.
+ */
+typedef struct {
+    EfaRxCompletionContext context; ///< Context of the buffer. Must be the first member.
+    uint8_t* buffer_ptr; ///< Address of the buffer.
+    bool is_posted;      ///< True from the time the buffer is posted until libfabric releases it.
+    int packets_held;    ///< Number of packets received into the buffer that have not been freed yet.
+} EfaRxMultiRecvBuffer;
+
+/**
+ * @brief Structure used to hold the receive packet buffers that an adapter shares between its Rx connections. See
+ * CdiRxConfigData.shared_rx_packet_quota.
+ */
+typedef struct {
+    /// @brief Protects free_array_ptr, free_count and the shared_packets_held counts of the connections, since the
+    /// connections may be polled by different threads.
+    CdiCsID lock;
+    void* allocated_buffer_ptr;             ///< Address of the packets memory buffer; needed for freeing.
+    int allocated_buffer_size;              ///< Total size of allocated packets buffer; needed for freeing.
+    bool allocated_buffer_was_from_heap;    ///< True if no huge pages were available; needed for freeing.
+    uint8_t* buffer_ptr;                    ///< Address of the first packet buffer, aligned in allocated_buffer_ptr.
+    int packet_size;                        ///< Size of each packet buffer in bytes, including the message prefix.
+    int aligned_packet_size;                ///< Distance in bytes between consecutive packet buffers.
+    int packet_count;                       ///< Number of packet buffers.
+    uint8_t** free_array_ptr;               ///< Stack of the packet buffers that are not in use.
+    int free_count;                         ///< Number of packet buffers in free_array_ptr.
+} EfaRxSharedPacketPool;
+
 /**
  * @brief This defines a structure that contains all of the state information that is specific to the Rx side of a
  * single EFA endpoint.
@@ -54,12 +183,61 @@ typedef struct {
     int allocated_buffer_size;              ///< Total size of allocated packets buffer; needed for freeing.
     bool allocated_buffer_was_from_heap;    ///< True if no huge pages were available; needed for freeing.
     struct fid_mr* memory_region_ptr;       ///< Pointer to Rx memory region.
+    EfaRxRmaSlots rma_slots;                ///< Receive buffer slots. Only used if rma_supported is true.
+    EfaRxCompletionContext completion_context; ///< Context of the receive buffers posted one per packet.
+
+    /// @brief True if the receive packet memory is posted as FI_MULTI_RECV buffers instead of one buffer per packet.
+    bool multi_recv_supported;
+    int multi_recv_buffer_size;             ///< Size of each FI_MULTI_RECV buffer in bytes.
+    int multi_recv_buffer_count;            ///< Number of FI_MULTI_RECV buffers in multi_recv_buffer_array.
+    /// @brief FI_MULTI_RECV buffers. Only used by PollThread().
+    EfaRxMultiRecvBuffer multi_recv_buffer_array[EFA_RX_MULTI_RECV_BUFFER_COUNT];
+
+    /// @brief Adapter's shared pool that packet buffers are taken from. NULL if the endpoint uses its own packet
+    /// buffers. See CdiRxConfigData.shared_rx_packet_quota.
+    EfaRxSharedPacketPool* shared_pool_ptr;
+    int shared_posted_target;               ///< Number of buffers of the shared pool to keep posted to libfabric.
+    int shared_posted_count;                ///< Number of buffers of the shared pool posted. Used by PollThread().
+    /// @brief Bit set for each buffer of the shared pool that is posted to the endpoint. Used by PollThread().
+    uint64_t* shared_posted_bitmap_ptr;
+    /// @brief Shared completion queue whose domain registration of the shared pool memory is used as memory_region_ptr.
+    /// NULL if the endpoint registered the memory itself.
+    EfaSharedCompletionQueue* shared_pool_mr_owner_ptr;
+    int shared_refill_backoff;              ///< Polls to skip after a refill got no buffers. Zero if the last got some.
+    int shared_refill_skip_count;           ///< Polls left to skip before Poll() refills again.
 } EfaRxState;
 
+/**
+ * @brief Structure used to hold the libfabric objects shared by the Rx endpoints of the connections that use the same
+ * poll thread. See CdiRxConfigData.shared_completion_queue.
+ */
+struct EfaSharedCompletionQueue {
+    CdiListEntry list_entry;                  ///< Allows this structure to live in the list of the adapter.
+    const PollThreadState* poll_thread_state_ptr; ///< Poll thread of the connections that share the objects.
+    int connection_count;                     ///< Number of connections using this structure. Freed when zero.
+    /// @brief Serializes the use of the shared objects by PollThread() and by the threads that open and close
+    /// endpoints, since libfabric is used with FI_THREAD_DOMAIN.
+    CdiCsID lock;
+    int endpoint_count;                       ///< Number of endpoints using the objects. Closed when zero.
+    char domain_name_str[EFA_MAX_DOMAIN_NAME_LENGTH]; ///< Name of the libfabric domain.
+    struct fid_fabric* fabric_ptr;            ///< Pointer to fabric provider.
+    struct fid_domain* domain_ptr;            ///< Pointer to fabric access domain.
+    struct fid_cq* completion_queue_ptr;      ///< Pointer to the completion queue.
+    int polls_since_read;                     ///< Number of endpoint polls since the completion queue was read.
+    /// @brief Completions of open endpoints read from the completion queue while another endpoint was being closed.
+    struct fi_cq_data_entry* backlog_array_ptr;
+    int backlog_count;                        ///< Number of completions in backlog_array_ptr.
+    int backlog_size;                         ///< Number of completions that fit in backlog_array_ptr.
+    /// @brief Registration of the adapter's shared receive pool memory with the shared domain. Endpoints that use the
+    /// pool share it, so the locked memory of the pool is only counted once per domain. NULL if not registered.
+    struct fid_mr* shared_pool_memory_region_ptr;
+    int shared_pool_mr_count;                 ///< Number of endpoints using shared_pool_memory_region_ptr.
+};
+
 /**
  * @brief Structure used to hold EFA endpoint state data.
  */
-typedef struct {
+struct EfaEndpointState {
     AdapterEndpointState* adapter_endpoint_ptr; ///< Pointer to adapter endpoint data (here for convenience).
     union {
         /// The internal state of the structure if adapter_endpoint_ptr->direction is kEndpointDirectionSend.
@@ -82,18 +260,30 @@ typedef struct {
     struct fid_ep* endpoint_ptr;              ///< Pointer to fabric endpoint (transport level communication portal)
     struct fid_av* address_vector_ptr;        ///< Pointer to address vector map (high-level to fabric address map)
     fi_addr_t remote_fi_addr;                 ///< Remote memory address (we don't use so it is always FI_ADDR_UNSPEC)
+    /// @brief True if the libfabric provider supports the RMA writes and remote CQ data used for RMA direct placement.
+    bool rma_supported;
+    /// @brief If not NULL, fabric_ptr, domain_ptr and completion_queue_ptr are shared with other Rx endpoints that use
+    /// the same poll thread and owned by this object.
+    EfaSharedCompletionQueue* shared_cq_ptr;
 
     uint8_t local_ipv6_gid_array[MAX_IPV6_GID_LENGTH]; ///< Pointer to local device GID for this endpoint.
     uint8_t remote_ipv6_gid_array[MAX_IPV6_GID_LENGTH]; ///< Pointer to remote device GID related to this endpoint.
     int dest_control_port;                    ///< Destination control port. For socket-based we use the next higher
                                               /// port number for the data port.
-} EfaEndpointState;
+};
 
 /**
  * @brief Structure used to hold EFA connection state data.
  */
 typedef struct {
     AdapterConnectionState* adapter_con_ptr; ///< Pointer to adapter connection data.
+    /// @brief Objects shared with the other Rx connections of the poll thread. NULL if not used.
+    EfaSharedCompletionQueue* shared_cq_ptr;
+    /// @brief Adapter's shared receive packet pool. NULL if not used. See CdiRxConfigData.shared_rx_packet_quota.
+    EfaRxSharedPacketPool* shared_pool_ptr;
+    /// @brief Number of buffers of shared_pool_ptr that the endpoints of the connection have posted or hold packets
+    /// in. Protected by the lock of the pool.
+    int shared_packets_held;
 } EfaConnectionState;
 
 //*********************************************************************************************************************
@@ -130,6 +320,18 @@ CdiReturnStatus EfaAdapterEndpointStart(EfaEndpointState* endpoint_ptr);
  */
 CdiAdapterHandle EfaAdapterGetAdapterControlInterface(AdapterConnectionState* adapter_con_state_ptr);
 
+/**
+ * Get the sets of optional capabilities to ask fi_getinfo() for, in the order they are tried. Each optional capability
+ * is dropped on its own before both are dropped, so a provider that only lacks one of them keeps the other one.
+ *
+ * @param rma_caps Capabilities needed for RMA direct placement. Zero if not needed.
+ * @param multi_recv_caps Capabilities needed for FI_MULTI_RECV buffers. Zero if not needed.
+ * @param ret_caps_array Array of EFA_OPTIONAL_CAPS_SET_COUNT elements where to write the sets.
+ *
+ * @return Number of sets written to ret_caps_array. The last one is always zero.
+ */
+int EfaAdapterOptionalCapsGet(uint64_t rma_caps, uint64_t multi_recv_caps, uint64_t* ret_caps_array);
+
 // EFA Tx functions
 
 /// @see CdiAdapterOpenEndpoint
@@ -148,7 +350,7 @@ CdiReturnStatus EfaTxEndpointClose(EfaEndpointState* endpoint_ptr);
 EndpointTransmitQueueLevel EfaGetTransmitQueueLevel(const AdapterEndpointHandle handle);
 
 /// @see CdiAdapterEnqueueSendPacket
-CdiReturnStatus EfaTxEndpointSend(const AdapterEndpointHandle handle, const Packet* packet_ptr, bool flush_packets);
+CdiReturnStatus EfaTxEndpointSend(const AdapterEndpointHandle handle, Packet* packet_ptr, bool flush_packets);
 
 /// @see EfaAdapterEndpointStart
 CdiReturnStatus EfaTxEndpointStart(EfaEndpointState* endpoint_ptr);
@@ -156,6 +358,50 @@ CdiReturnStatus EfaTxEndpointStart(EfaEndpointState* endpoint_ptr);
 /// @see EfaAdapterEndpointStop
 void EfaTxEndpointStop(EfaEndpointState* endpoint_ptr);
 
+/**
+ * Update the receive buffer slots that the transmitter may write payloads into directly with a slot advertisement
+ * received from the receiver.
+ *
+ * NOTE: This function is called from ProbeControlThread().
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param rma_slots_ptr Pointer to the decoded slot advertisement.
+ */
+void EfaTxRmaSlotsUpdate(EfaEndpointState* endpoint_ptr, const CdiDecodedProbeRmaSlots* rma_slots_ptr);
+
+/**
+ * Get the receive buffer slot that the data of a packet must be written into. Packet #0 of a payload that fits into a
+ * free slot acquires it, and the later packets of that payload get the same slot until its last packet has been
+ * written. Packets of any other payload must be sent as usual.
+ *
+ * NOTE: This function is called from PollThread().
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param packet_ptr Pointer to the packet.
+ * @param header_ptr Pointer to the decoded CDI header of the packet.
+ * @param header_only_entry True if the first SGL entry of the packet only holds its header.
+ *
+ * @return Index of the slot. -1 if the packet must be sent.
+ */
+int EfaTxRmaSlotGet(EfaEndpointState* endpoint_ptr, const Packet* packet_ptr, const CdiDecodedPacketHeader* header_ptr,
+                    bool header_only_entry);
+
+/**
+ * Start tracking the application memory regions that are registered with the adapter, so the endpoint can send
+ * payloads from them.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ */
+void EfaTxMemoryRegionCacheInit(EfaEndpointState* endpoint_ptr);
+
+/**
+ * Stop tracking the application memory regions that are registered with the adapter and close all of the libfabric
+ * memory regions that the endpoint created for them.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ */
+void EfaTxMemoryRegionCacheFlush(EfaEndpointState* endpoint_ptr);
+
 // EFA Rx functions
 
 /// @see CdiAdapterOpenEndpoint
@@ -189,4 +435,143 @@ CdiReturnStatus EfaRxPacketPoolCreate(EfaEndpointState* endpoint_state_ptr);
  */
 void EfaRxPacketPoolFree(EfaEndpointState* endpoint_ptr);
 
+/**
+ * Register the receive buffer slots of the endpoint with libfabric for remote writes, allocating their memory the first
+ * time. Does nothing if the connection does not use RMA direct placement.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ *
+ * @return kCdiStatusOk if successful, otherwise a value that indicates the nature of the failure is returned.
+ */
+CdiReturnStatus EfaRxRmaSlotsRegister(EfaEndpointState* endpoint_ptr);
+
+/**
+ * Unregister the receive buffer slots of the endpoint from libfabric. Their memory is kept until the endpoint is
+ * closed, since the application may still hold payloads in them.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ */
+void EfaRxRmaSlotsUnregister(EfaEndpointState* endpoint_ptr);
+
+/**
+ * Get the current state of the receive buffer slots of the endpoint for sending to the transmitter.
+ *
+ * NOTE: This function is called from ProbeControlThread().
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param ret_rma_slots_ptr Address where to write the slot advertisement.
+ *
+ * @return true if the endpoint has registered slots, otherwise false is returned.
+ */
+bool EfaRxRmaSlotsGet(EfaEndpointState* endpoint_ptr, CdiDecodedProbeRmaSlots* ret_rma_slots_ptr);
+
+/**
+ * Get the shared completion queue of a poll thread for an Rx connection, creating it if the connection is the first of
+ * the poll thread to use one. The libfabric objects are created by the first endpoint that is opened. See
+ * CdiRxConfigData.shared_completion_queue. The caller must serialize the use of the list.
+ *
+ * @param list_ptr Pointer to the list of shared completion queues of the adapter.
+ * @param poll_thread_state_ptr Pointer to the poll thread of the connection.
+ * @param ret_shared_cq_ptr Address where to write the pointer to the shared completion queue.
+ *
+ * @return kCdiStatusOk if successful, otherwise a value that indicates the nature of the failure is returned.
+ */
+CdiReturnStatus EfaRxSharedCompletionQueueGet(CdiList* list_ptr, const PollThreadState* poll_thread_state_ptr,
+                                              EfaSharedCompletionQueue** ret_shared_cq_ptr);
+
+/**
+ * Release a shared completion queue got by EfaRxSharedCompletionQueueGet(). It is freed once the last connection that
+ * uses it has released it. All of the connection's endpoints must have been closed. The caller must serialize the use
+ * of the list.
+ *
+ * @param list_ptr Pointer to the list of shared completion queues of the adapter.
+ * @param shared_cq_ptr Pointer to the shared completion queue.
+ */
+void EfaRxSharedCompletionQueuePut(CdiList* list_ptr, EfaSharedCompletionQueue* shared_cq_ptr);
+
+/**
+ * Remove the completions of an endpoint that is being closed from a completion queue that it shares with other
+ * endpoints. Completions of the other endpoints are kept in the backlog of the shared completion queue, so they can be
+ * processed by the next poll. If the backlog can't hold them, their packets are dropped and their receive buffers are
+ * given back to their endpoints. Must be called after the libfabric endpoint has been closed and while holding the lock
+ * of the shared completion queue.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ */
+void EfaRxSharedCompletionQueueDrain(EfaEndpointState* endpoint_ptr);
+
+/**
+ * Allocate a pool of receive packet buffers that an adapter shares between its Rx connections. See
+ * CdiRxConfigData.shared_rx_packet_quota.
+ *
+ * @param packet_size Size of each packet buffer in bytes, including the message prefix.
+ * @param packet_count Number of packet buffers.
+ * @param ret_pool_ptr Address where to write the pointer to the new pool.
+ *
+ * @return kCdiStatusOk if successful, otherwise a value that indicates the nature of the failure is returned.
+ */
+CdiReturnStatus EfaRxSharedPacketPoolCreate(int packet_size, int packet_count, EfaRxSharedPacketPool** ret_pool_ptr);
+
+/**
+ * Free a pool created by EfaRxSharedPacketPoolCreate(). All of the connections that used it must have been destroyed.
+ *
+ * @param pool_ptr Pointer to the pool. Does nothing if NULL.
+ */
+void EfaRxSharedPacketPoolDestroy(EfaRxSharedPacketPool* pool_ptr);
+
+/**
+ * Take packet buffers from a shared receive pool for a connection, without going over the connection's quota.
+ *
+ * @param pool_ptr Pointer to the pool.
+ * @param quota Maximum number of the pool's buffers that the connection may hold.
+ * @param held_count_ptr Pointer to the number of the pool's buffers that the connection holds. Updated.
+ * @param ret_buffer_array Array where to write the addresses of the packet buffers.
+ * @param count Maximum number of packet buffers to take.
+ *
+ * @return Number of packet buffers taken. Zero if the pool is empty or the connection has used up its quota.
+ */
+int EfaRxSharedPacketPoolGet(EfaRxSharedPacketPool* pool_ptr, int quota, int* held_count_ptr,
+                             uint8_t** ret_buffer_array, int count);
+
+/**
+ * Return packet buffers taken with EfaRxSharedPacketPoolGet() to their pool.
+ *
+ * @param pool_ptr Pointer to the pool.
+ * @param held_count_ptr Pointer to the number of the pool's buffers that the connection holds. Updated.
+ * @param buffer_array Array of the addresses of the packet buffers.
+ * @param count Number of packet buffers in buffer_array.
+ */
+void EfaRxSharedPacketPoolPut(EfaRxSharedPacketPool* pool_ptr, int* held_count_ptr, uint8_t* const* buffer_array,
+                              int count);
+
+/**
+ * Check whether Poll() should refill the shared pool buffers posted to an endpoint. After a refill got no buffers,
+ * the following polls are skipped, since every refill takes the lock of the pool that all poll threads share. Buffers
+ * freed by the endpoint itself are posted again without waiting. See EfaRxSharedPoolRefillBackoff().
+ *
+ * @param rx_state_ptr Pointer to Rx state of the endpoint.
+ *
+ * @return true if the buffers should be refilled by this poll.
+ */
+bool EfaRxSharedPoolRefillDue(EfaRxState* rx_state_ptr);
+
+/**
+ * Update the number of polls to skip after a refill of the shared pool buffers posted to an endpoint. It doubles with
+ * each refill in a row that gets no buffers, up to EFA_RX_SHARED_POOL_MAX_REFILL_BACKOFF polls.
+ *
+ * @param rx_state_ptr Pointer to Rx state of the endpoint.
+ * @param got_buffers True if the refill got buffers from the pool.
+ */
+void EfaRxSharedPoolRefillBackoff(EfaRxState* rx_state_ptr, bool got_buffers);
+
+/**
+ * Find the FI_MULTI_RECV buffer that holds a packet.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param packet_ptr Address of the packet, including its message prefix.
+ *
+ * @return Pointer to the state of the buffer. NULL if the packet is not in any of the buffers.
+ */
+EfaRxMultiRecvBuffer* EfaRxMultiRecvBufferFind(EfaEndpointState* endpoint_ptr, const uint8_t* packet_ptr);
+
 #endif // ADAPTER_EFA_H__
@@ -125,6 +125,7 @@ CdiReturnStatus ProbeEndpointCreate(AdapterEndpointHandle app_adapter_endpoint_h
 
         probe_ptr->app_msg_from_endpoint_func_ptr = app_adapter_endpoint_handle->msg_from_endpoint_func_ptr;
         probe_ptr->app_msg_from_endpoint_param_ptr = app_adapter_endpoint_handle->msg_from_endpoint_param_ptr;
+        probe_ptr->app_msgs_from_endpoint_func_ptr = app_adapter_endpoint_handle->msgs_from_endpoint_func_ptr;
 
         probe_ptr->log_handle = log_handle;
     }
@@ -204,6 +205,18 @@ CdiReturnStatus ProbeEndpointError(ProbeEndpointHandle handle)
     return rs;
 }
 
+void ProbeEndpointRmaSlotsChanged(ProbeEndpointHandle handle)
+{
+    ProbeEndpointState* probe_ptr = (ProbeEndpointState*)handle;
+    if (probe_ptr) {
+        ControlCommand control_cmd = {
+            .command_type = kCommandTypeRmaSlotsChanged,
+        };
+        // Don't wait. This is called from PollThread().
+        CdiFifoWrite(probe_ptr->control_packet_fifo_handle, 0, NULL, &control_cmd);
+    }
+}
+
 CdiReturnStatus ProbeEndpointResetDone(ProbeEndpointHandle handle, bool reopen)
 {
     CdiReturnStatus rs = kCdiStatusOk;
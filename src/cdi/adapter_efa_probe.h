@@ -122,6 +122,7 @@ typedef struct ProbeEndpointState ProbeEndpointState;
 struct ProbeEndpointState {
     MessageFromEndpoint app_msg_from_endpoint_func_ptr; ///< Saved copy of original function pointer
     void* app_msg_from_endpoint_param_ptr; ///< Saved copy of original parameter
+    MessagesFromEndpoint app_msgs_from_endpoint_func_ptr; ///< Saved copy of original function pointer for packet lists
 
     AdapterEndpointHandle app_adapter_endpoint_handle; ///< Handle to the application's endpoint.
     union {
@@ -181,6 +182,7 @@ typedef struct {
 typedef enum {
     kCommandTypeStateChange, ///< Command contains a value from the ProbeState enumeration.
     kCommandTypeRxPacket,    ///< Command contains a packet SGL that was received using the control interface.
+    kCommandTypeRmaSlotsChanged, ///< Receive buffer slots were released and must be advertised. Command has no data.
 } ControlCommandType;
 
 /**
@@ -226,6 +228,16 @@ CdiReturnStatus ProbeEndpointCreate(AdapterEndpointHandle app_adapter_endpoint_h
  */
 CdiReturnStatus ProbeEndpointError(ProbeEndpointHandle handle);
 
+/**
+ * Have the probe advertise the receive buffer slots of an Rx endpoint to the transmitter, because one or more of them
+ * have been released. If the request can't be queued, the slots are advertised with the next ping ACK.
+ *
+ * NOTE: This function is called from PollThread().
+ *
+ * @param handle Handle of probe related to the endpoint.
+ */
+void ProbeEndpointRmaSlotsChanged(ProbeEndpointHandle handle);
+
 /**
  * Reset a probe endpoint.
  *
@@ -170,6 +170,7 @@ bool ProbeControlEfaConnectionStart(ProbeEndpointState* probe_ptr)
         probe_ptr->rx_probe_state.pings_received_count = 0;
     }
     endpoint_ptr->msg_from_endpoint_param_ptr = probe_ptr;
+    endpoint_ptr->msgs_from_endpoint_func_ptr = NULL; // Probe packets are completed one at a time.
 
     // Start the application's EFA connection.
     EfaEndpointState* efa_endpoint_state_ptr = (EfaEndpointState*)endpoint_ptr->type_specific_ptr;
@@ -216,6 +217,7 @@ void ProbeControlEfaConnectionEnableApplication(ProbeEndpointState* probe_ptr)
     // Setup message functions and related parameters to point to the application variants.
     endpoint_ptr->msg_from_endpoint_func_ptr = probe_ptr->app_msg_from_endpoint_func_ptr;
     endpoint_ptr->msg_from_endpoint_param_ptr = probe_ptr->app_msg_from_endpoint_param_ptr;
+    endpoint_ptr->msgs_from_endpoint_func_ptr = probe_ptr->app_msgs_from_endpoint_func_ptr;
 
     ProbeControlQueueStateChange(probe_ptr, kProbeStateEfaConnected);
 }
@@ -366,6 +368,36 @@ CdiReturnStatus ProbeControlSendAck(ProbeEndpointState* probe_ptr, ProbeCommand
     return rs;
 }
 
+CdiReturnStatus ProbeControlSendRmaSlots(ProbeEndpointState* probe_ptr, const CdiDecodedProbeRmaSlots* rma_slots_ptr)
+{
+    CdiReturnStatus rs = kCdiStatusOk;
+    AdapterEndpointState* endpoint_ptr = probe_ptr->app_adapter_endpoint_handle;
+    AdapterConnectionState* adapter_con_ptr = endpoint_ptr->adapter_con_state_ptr;
+
+    CdiDecodedProbeHeader header = { 0 };
+    CdiPoolHandle control_work_request_pool_handle =
+        ControlInterfaceGetWorkRequestPoolHandle(adapter_con_ptr->control_interface_handle);
+    ProbePacketWorkRequest* work_request_ptr = ProbeControlWorkRequestGet(control_work_request_pool_handle);
+    if (NULL == work_request_ptr) {
+        rs = kCdiStatusAllocationFailed;
+    } else {
+        header.rma_slots_packet = *rma_slots_ptr;
+        EncodeProbeHeader(probe_ptr, kProbeCommandRmaSlots, &header, work_request_ptr);
+
+        // Not logged, since the slots are advertised about as often as payloads are received.
+        rs = CdiAdapterEnqueueSendPacket(ControlInterfaceGetEndpoint(adapter_con_ptr->control_interface_handle),
+                                         EndpointManagerEndpointRemoteAddressGet(endpoint_ptr->cdi_endpoint_handle),
+                                         &work_request_ptr->packet);
+    }
+
+    if (kCdiStatusOk != rs && work_request_ptr) {
+        // Put back work request into the pool.
+        CdiPoolPut(control_work_request_pool_handle, work_request_ptr);
+    }
+
+    return rs;
+}
+
 void ProbeControlMessageFromBidirectionalEndpoint(void* param_ptr, Packet* packet_ptr, EndpointMessageType message_type)
 {
     AdapterConnectionState* adapter_con_ptr = (AdapterConnectionState*)param_ptr;
@@ -421,6 +453,9 @@ CDI_THREAD ProbeControlThread(void* ptr)
                                                       &probe_ptr->rx_probe_state.rx_state;
                 *current_probe_state_ptr = control_cmd.probe_state;
                 wait_timeout_ms = 0; // Set to zero so the state change is executed immediately in the code below.
+            } else if (kCommandTypeRmaSlotsChanged == control_cmd.command_type) {
+                // Receive buffer slots of the local Rx endpoint were released.
+                ProbeRxControlSendRmaSlots(probe_ptr);
             } else {
                 // Received a control packet.
                 if (ProcessPacket(probe_ptr, &control_cmd, &wait_timeout_ms)) {
@@ -110,6 +110,17 @@ CdiReturnStatus ProbeControlSendCommand(ProbeEndpointState* probe_ptr, ProbeComm
 CdiReturnStatus ProbeControlSendAck(ProbeEndpointState* probe_ptr, ProbeCommand ack_command,
                                     uint16_t ack_probe_packet_num);
 
+/**
+ * Send the receive buffer slots that the transmitter may write payloads into directly to an endpoint using the adapter
+ * control interface. No ACK is expected, since the slots are advertised again with every ping ACK.
+ *
+ * @param probe_ptr Pointer to probe endpoint state data.
+ * @param rma_slots_ptr Pointer to the slot advertisement to send.
+ *
+ * @return kCdiStatusOk if successful, otherwise a value that indicates the nature of the failure is returned.
+ */
+CdiReturnStatus ProbeControlSendRmaSlots(ProbeEndpointState* probe_ptr, const CdiDecodedProbeRmaSlots* rma_slots_ptr);
+
 /**
  * Process a control packet message from a probe control interface bidirectional endpoint.
  *
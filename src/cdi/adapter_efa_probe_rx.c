@@ -301,13 +301,16 @@ bool ProbeRxControlProcessPacket(ProbeEndpointState* probe_ptr,
             *wait_timeout_ms_ptr = RX_PING_MONITOR_TIMEOUT_MSEC;
             ret_new_state = true;
 
-            // Send an ACK back to the transmitter (client).
+            // Send an ACK back to the transmitter (client). Also advertise the receive buffer slots again, in case an
+            // earlier advertisement was lost.
             ProbeControlSendAck(probe_ptr, probe_hdr_ptr->command, probe_hdr_ptr->control_packet_num);
+            ProbeRxControlSendRmaSlots(probe_ptr);
             break;
 
         // Should never get these commands.
         case kProbeCommandAck:
         case kProbeCommandConnected:
+        case kProbeCommandRmaSlots:
         default:
             assert(false);
     }
@@ -315,6 +318,24 @@ bool ProbeRxControlProcessPacket(ProbeEndpointState* probe_ptr,
     return ret_new_state;
 }
 
+void ProbeRxControlSendRmaSlots(ProbeEndpointState* probe_ptr)
+{
+    AdapterEndpointHandle adapter_endpoint_handle = probe_ptr->app_adapter_endpoint_handle;
+    CdiProtocolHandle protocol_handle = adapter_endpoint_handle->protocol_handle;
+    const ProbeState rx_state = probe_ptr->rx_probe_state.rx_state;
+
+    // Only send while connected and if the transmitter's SDK knows the command.
+    if (NULL == protocol_handle || protocol_handle->negotiated_version.probe_version_num < 5 ||
+        (kProbeStateEfaConnected != rx_state && kProbeStateEfaConnectedPing != rx_state)) {
+        return;
+    }
+
+    CdiDecodedProbeRmaSlots rma_slots = { 0 };
+    if (EfaRxRmaSlotsGet((EfaEndpointState*)adapter_endpoint_handle->type_specific_ptr, &rma_slots)) {
+        ProbeControlSendRmaSlots(probe_ptr, &rma_slots);
+    }
+}
+
 uint64_t ProbeRxControlProcessProbeState(ProbeEndpointState* probe_ptr)
 {
     uint64_t wait_timeout_ms = DEFAULT_TIMEOUT_MSEC;
@@ -402,6 +423,7 @@ uint64_t ProbeRxControlProcessProbeState(ProbeEndpointState* probe_ptr)
             // communication, the transmitter could start sending a payload and packets for it might arrive before the
             // last probe packet arrives. NOTE: We will not expect an ACK back.
             ProbeControlSendCommand(probe_ptr, kProbeCommandConnected, false);
+            ProbeRxControlSendRmaSlots(probe_ptr);
             probe_ptr->rx_probe_state.send_reset_retry_count = 0; // Reset retry counter.
             // Save current total Rx packet count so we can use to determine if packets have arrived since it was
             // saved.
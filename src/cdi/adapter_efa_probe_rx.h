@@ -65,6 +65,16 @@ void ProbeRxControlMessageFromEndpoint(void* param_ptr, Packet* packet_ptr);
 bool ProbeRxControlProcessPacket(ProbeEndpointState* probe_ptr, const CdiDecodedProbeHeader* probe_hdr_ptr,
                                  const struct sockaddr_in* source_address_ptr, uint64_t* wait_timeout_ms_ptr);
 
+/**
+ * Advertise the receive buffer slots of the endpoint to the transmitter if RMA direct placement is in use and the
+ * connection is established with a transmitter that supports it.
+ *
+ * NOTE: This function is called from ProbeControlThread().
+ *
+ * @param probe_ptr Pointer to probe endpoint state data.
+ */
+void ProbeRxControlSendRmaSlots(ProbeEndpointState* probe_ptr);
+
 /**
  * Called when the wait timeout period has expired. Time to process the current Rx probe state.
  *
@@ -91,6 +91,7 @@ static bool EfaEnqueueSendProbePacket(ProbeEndpointState* probe_ptr)
         // the last packet of a payload is ACKed.
         work_request_ptr->packet.payload_last_packet =
             (packet_ptr->packet_sequence_num + 1 == EFA_PROBE_PACKET_COUNT);
+        work_request_ptr->packet.tx_state.pacing_bytes_per_millisec = 0; // Probe packets are never paced.
 
         CdiSinglyLinkedListPushTail(&packet_list, &work_request_ptr->packet.list_entry);
         // Increment in-flight reference counter once for each packet.
@@ -338,6 +339,15 @@ bool ProbeTxControlProcessPacket(ProbeEndpointState* probe_ptr, const CdiDecoded
                 ret_new_state = true;
             }
             break;
+        case kProbeCommandRmaSlots:
+            // Only accept the receiver's slots once it has reported the connection as established, so slots left over
+            // from before a reset are not used.
+            if (kProbeStateEfaTxProbeAcks == probe_ptr->tx_probe_state.tx_state ||
+                kProbeStateEfaConnected == probe_ptr->tx_probe_state.tx_state ||
+                kProbeStateEfaConnectedPing == probe_ptr->tx_probe_state.tx_state) {
+                EfaTxRmaSlotsUpdate(efa_endpoint_state_ptr, &probe_hdr_ptr->rma_slots_packet);
+            }
+            break;
 
         // Should never get these commands.
         case kProbeCommandPing:
@@ -15,6 +15,7 @@
 
 #include "adapter_efa.h"
 
+#include "adapter_efa_probe_rx.h"
 #include "endpoint_manager.h"
 #include "internal_log.h"
 #include "internal_tx.h"
@@ -31,6 +32,9 @@
 /// Align each receive buffer to start at an address evenly divisible by 8.
 static const int packet_buffer_alignment = 8;
 
+/// Maximum number of packet buffers moved to or from the adapter's shared receive pool while holding its lock.
+#define SHARED_POOL_BATCH_SIZE          (64)
+
 //*********************************************************************************************************************
 //*********************************************** START OF VARIABLES **************************************************
 //*********************************************************************************************************************
@@ -49,10 +53,12 @@ static const int packet_buffer_alignment = 8;
  *                    a receive packet buffer.
  * @param more_to_post Set this to true if this function will be immediately called again to post another packet buffer.
  *                     This allows libfabric to process packet buffers in an optimized fashion.
+ * @param multi_recv_buffer_ptr Pointer to the state of the buffer if it is posted with FI_MULTI_RECV, otherwise NULL.
  *
  * @return Returns true if no error, otherwise false is returned.
  */
-static bool PostRxBuffer(EfaEndpointState* endpoint_state_ptr, const struct iovec* msg_iov_ptr, bool more_to_post)
+static bool PostRxBuffer(EfaEndpointState* endpoint_state_ptr, const struct iovec* msg_iov_ptr, bool more_to_post,
+                         EfaRxMultiRecvBuffer* multi_recv_buffer_ptr)
 {
     void *desc = fi_mr_desc(endpoint_state_ptr->rx_state.memory_region_ptr);
     struct fi_msg msg = {
@@ -60,11 +66,16 @@ static bool PostRxBuffer(EfaEndpointState* endpoint_state_ptr, const struct iove
         .msg_iov = msg_iov_ptr,
         .iov_count = 1,
         .addr = FI_ADDR_UNSPEC,
-        .context = NULL, // Currently not used
+        // Identifies the endpoint and, for FI_MULTI_RECV, the buffer of the completion.
+        .context = multi_recv_buffer_ptr ? &multi_recv_buffer_ptr->context :
+                                           &endpoint_state_ptr->rx_state.completion_context,
         .data = 0
     };
 
-    const uint64_t flags = FI_RECV | (more_to_post ? FI_MORE : 0);
+    uint64_t flags = FI_RECV | (more_to_post ? FI_MORE : 0);
+    if (multi_recv_buffer_ptr) {
+        flags |= FI_MULTI_RECV;
+    }
     const int max_num_tries = 5;
     int num_tries = 0;
     ssize_t fi_ret = 0;
@@ -84,73 +95,523 @@ static bool PostRxBuffer(EfaEndpointState* endpoint_state_ptr, const struct iove
 }
 
 /**
- * Used to poll for any pending Rx completion events and process them.
+ * Post a FI_MULTI_RECV buffer again once libfabric has released it and all of the packets received into it have been
+ * freed.
  *
- * @param efa_endpoint_ptr Pointer to EFA endpoint state data.
+ * @param endpoint_state_ptr Pointer to endpoint state data.
+ * @param buffer_ptr Pointer to the state of the buffer.
  *
- * @return true if useful work was done, false if the function did nothing productive.
+ * @return Returns true if no error, otherwise false is returned.
  */
-static bool Poll(EfaEndpointState* efa_endpoint_ptr)
+static bool MultiRecvBufferRepost(EfaEndpointState* endpoint_state_ptr, EfaRxMultiRecvBuffer* buffer_ptr)
+{
+    if (buffer_ptr->is_posted || 0 != buffer_ptr->packets_held) {
+        return true;
+    }
+
+    struct iovec msg_iov = {
+        .iov_base = buffer_ptr->buffer_ptr,
+        .iov_len = endpoint_state_ptr->rx_state.multi_recv_buffer_size
+    };
+    buffer_ptr->is_posted = PostRxBuffer(endpoint_state_ptr, &msg_iov, false, buffer_ptr);
+    return buffer_ptr->is_posted;
+}
+
+/**
+ * Get the number of a packet buffer of the adapter's shared receive pool.
+ *
+ * @param pool_ptr Pointer to the shared pool.
+ * @param buffer_ptr Address of the packet buffer, including its message prefix.
+ *
+ * @return Number of the packet buffer.
+ */
+static int SharedPoolBufferIndex(const EfaRxSharedPacketPool* pool_ptr, const uint8_t* buffer_ptr)
+{
+    return (int)((uint64_t)(buffer_ptr - pool_ptr->buffer_ptr) / pool_ptr->aligned_packet_size);
+}
+
+/**
+ * Return packet buffers of the endpoint to the adapter's shared receive pool.
+ *
+ * @param endpoint_state_ptr Pointer to endpoint state data.
+ * @param buffer_array Array of the addresses of the packet buffers, including their message prefix.
+ * @param count Number of packet buffers in buffer_array.
+ */
+static void SharedPoolBuffersPut(EfaEndpointState* endpoint_state_ptr, uint8_t* const* buffer_array, int count)
+{
+    EfaConnectionState* efa_con_ptr =
+        (EfaConnectionState*)endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->type_specific_ptr;
+    EfaRxSharedPacketPoolPut(endpoint_state_ptr->rx_state.shared_pool_ptr, &efa_con_ptr->shared_packets_held,
+                             buffer_array, count);
+}
+
+/**
+ * Post packet buffers taken from the adapter's shared receive pool until the endpoint has its target number of buffers
+ * posted. Stops early if the connection has used up its quota or the pool is empty, in which case a later call posts
+ * the rest once buffers have been freed. See EfaRxSharedPoolRefillBackoff().
+ *
+ * @param endpoint_state_ptr Pointer to endpoint state data.
+ *
+ * @return Returns true if no error, otherwise false is returned.
+ */
+static bool SharedPoolRefill(EfaEndpointState* endpoint_state_ptr)
+{
+    EfaRxState* rx_state_ptr = &endpoint_state_ptr->rx_state;
+    if (rx_state_ptr->shared_posted_count >= rx_state_ptr->shared_posted_target ||
+        NULL == rx_state_ptr->memory_region_ptr) {
+        return true;
+    }
+
+    EfaRxSharedPacketPool* pool_ptr = rx_state_ptr->shared_pool_ptr;
+    AdapterConnectionState* adapter_con_ptr = endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr;
+    EfaConnectionState* efa_con_ptr = (EfaConnectionState*)adapter_con_ptr->type_specific_ptr;
+    const int quota = adapter_con_ptr->rx_state.shared_packet_quota;
+
+    // Buffers are posted to a domain that other endpoints share, so serialize access to it.
+    EfaSharedCompletionQueue* shared_cq_ptr = endpoint_state_ptr->shared_cq_ptr;
+    if (shared_cq_ptr) {
+        CdiOsCritSectionReserve(shared_cq_ptr->lock);
+    }
+
+    bool ret = true;
+    bool got_buffers = false;
+    struct iovec msg_iov = {
+        .iov_len = pool_ptr->packet_size
+    };
+    while (ret && rx_state_ptr->shared_posted_count < rx_state_ptr->shared_posted_target) {
+        uint8_t* buffer_array[SHARED_POOL_BATCH_SIZE];
+        const int count = EfaRxSharedPacketPoolGet(pool_ptr, quota, &efa_con_ptr->shared_packets_held, buffer_array,
+                                                   CDI_MIN(rx_state_ptr->shared_posted_target -
+                                                           rx_state_ptr->shared_posted_count, SHARED_POOL_BATCH_SIZE));
+        got_buffers = got_buffers || 0 < count;
+        if (0 == count) {
+            // The pool is empty or the connection has used up its quota. Until buffers are freed, libfabric holds off
+            // the transmitter when it runs out of posted buffers.
+            break;
+        }
+
+        int posted = 0;
+        while (ret && posted < count) {
+            msg_iov.iov_base = buffer_array[posted];
+            ret = PostRxBuffer(endpoint_state_ptr, &msg_iov, posted + 1 != count, NULL);
+            if (ret) {
+                const int index = SharedPoolBufferIndex(pool_ptr, buffer_array[posted]);
+                rx_state_ptr->shared_posted_bitmap_ptr[index / 64] |= 1ULL << (index % 64);
+                rx_state_ptr->shared_posted_count++;
+                posted++;
+            }
+        }
+        if (posted < count) {
+            SharedPoolBuffersPut(endpoint_state_ptr, &buffer_array[posted], count - posted);
+        }
+    }
+    EfaRxSharedPoolRefillBackoff(rx_state_ptr, got_buffers);
+
+    if (shared_cq_ptr) {
+        CdiOsCritSectionRelease(shared_cq_ptr->lock);
+    }
+
+    return ret;
+}
+
+/**
+ * Check whether an Rx SGL entry describes a receive buffer slot instead of a packet buffer.
+ *
+ * @param endpoint_state_ptr Pointer to endpoint state data.
+ * @param sgl_entry_ptr Pointer to the SGL entry.
+ *
+ * @return true if the entry describes a receive buffer slot.
+ */
+static bool IsRmaSlotEntry(const EfaEndpointState* endpoint_state_ptr, const CdiSglEntry* sgl_entry_ptr)
+{
+    const EfaRxRmaSlots* slots_ptr = &endpoint_state_ptr->rx_state.rma_slots;
+    const uint8_t* address_ptr = (const uint8_t*)sgl_entry_ptr->address_ptr;
+    return NULL != slots_ptr->buffer_ptr && address_ptr >= slots_ptr->buffer_ptr &&
+           address_ptr < slots_ptr->buffer_ptr + (uint64_t)slots_ptr->slot_size * slots_ptr->slot_count;
+}
+
+/**
+ * Mark a receive buffer slot that the transmitter has written a payload into as held and get an SGL entry that
+ * describes it.
+ *
+ * @param endpoint_state_ptr Pointer to endpoint state data.
+ * @param slot_index Slot number sent by the transmitter as remote CQ data.
+ *
+ * @return Pointer to the SGL entry. NULL is returned if the slot is not valid or already holds a payload.
+ */
+static CdiSglEntry* RmaSlotEntryGet(EfaEndpointState* endpoint_state_ptr, uint64_t slot_index)
+{
+    EfaRxRmaSlots* slots_ptr = &endpoint_state_ptr->rx_state.rma_slots;
+    bool is_free = false;
+    if (NULL != slots_ptr->memory_region_ptr && slot_index < (uint64_t)slots_ptr->slot_count) {
+        CdiOsCritSectionReserve(slots_ptr->lock);
+        is_free = 0 == (slots_ptr->held_mask & (1 << slot_index));
+        slots_ptr->held_mask |= 1 << slot_index;
+        CdiOsCritSectionRelease(slots_ptr->lock);
+    }
+    if (!is_free) {
+        CDI_LOG_THREAD(kLogError, "Payload placed in receive buffer slot[%llu] that is not valid or is in use.",
+                       (unsigned long long)slot_index);
+        return NULL;
+    }
+
+    CdiSglEntry* sgl_entry_ptr = NULL;
+    // NOTE: This pool is not thread-safe, so must ensure that only one thread is accessing it at a time.
+    if (!CdiPoolGet(endpoint_state_ptr->rx_state.packet_sgl_entries_pool_handle, (void**)&sgl_entry_ptr)) {
+        CdiOsCritSectionReserve(slots_ptr->lock);
+        slots_ptr->held_mask &= ~(1 << slot_index);
+        CdiOsCritSectionRelease(slots_ptr->lock);
+        return NULL;
+    }
+    sgl_entry_ptr->address_ptr = slots_ptr->buffer_ptr + slot_index * slots_ptr->slot_size;
+    sgl_entry_ptr->size_in_bytes = slots_ptr->slot_size;
+    sgl_entry_ptr->internal_data_ptr = NULL;
+    sgl_entry_ptr->next_ptr = NULL;
+
+    return sgl_entry_ptr;
+}
+
+/**
+ * Release a receive buffer slot that was freed by the SDK and have the probe advertise it to the transmitter again.
+ *
+ * @param endpoint_state_ptr Pointer to endpoint state data.
+ * @param sgl_entry_ptr Pointer to the SGL entry that describes the slot.
+ */
+static void RmaSlotRelease(EfaEndpointState* endpoint_state_ptr, const CdiSglEntry* sgl_entry_ptr)
+{
+    EfaRxRmaSlots* slots_ptr = &endpoint_state_ptr->rx_state.rma_slots;
+    const int slot_index = (int)(((const uint8_t*)sgl_entry_ptr->address_ptr - slots_ptr->buffer_ptr) /
+                                 slots_ptr->slot_size);
+
+    CdiOsCritSectionReserve(slots_ptr->lock);
+    slots_ptr->held_mask &= ~(1 << slot_index);
+    slots_ptr->release_count_array[slot_index]++;
+    // Only queue one advertisement at a time. It reports all the slots released until it is sent.
+    const bool queue_advert = !slots_ptr->advert_pending;
+    slots_ptr->advert_pending = true;
+    CdiOsCritSectionRelease(slots_ptr->lock);
+
+    if (queue_advert) {
+        ProbeEndpointRmaSlotsChanged(endpoint_state_ptr->probe_endpoint_handle);
+    }
+}
+
+/**
+ * Frees the memory of the receive buffer slots of the endpoint.
+ *
+ * @param endpoint_state_ptr Pointer to endpoint state data.
+ */
+static void RmaSlotsFree(EfaEndpointState* endpoint_state_ptr)
+{
+    EfaRxRmaSlots* slots_ptr = &endpoint_state_ptr->rx_state.rma_slots;
+    EfaRxRmaSlotsUnregister(endpoint_state_ptr);
+    if (NULL != slots_ptr->buffer_ptr) {
+        if (slots_ptr->was_from_heap) {
+            CdiOsMemFree(slots_ptr->buffer_ptr);
+        } else {
+            CdiOsMemFreeHugePage(slots_ptr->buffer_ptr, slots_ptr->allocated_size);
+        }
+        slots_ptr->buffer_ptr = NULL;
+        slots_ptr->allocated_size = 0;
+    }
+    if (slots_ptr->lock) {
+        CdiOsCritSectionDelete(slots_ptr->lock);
+        slots_ptr->lock = NULL;
+    }
+}
+
+/**
+ * Process a completion read from the completion queue of an Rx endpoint.
+ *
+ * @param efa_endpoint_ptr Pointer to EFA state data of the endpoint that the completion belongs to.
+ * @param comp_ptr Pointer to the completion.
+ * @param drop If true, the packet is dropped and its receive buffers are given back to the endpoint instead of the
+ *             packet being sent to the endpoint's message function.
+ */
+static void ProcessCompletion(EfaEndpointState* efa_endpoint_ptr, const struct fi_cq_data_entry* comp_ptr, bool drop)
 {
     AdapterEndpointState* aep_ptr = efa_endpoint_ptr->adapter_endpoint_ptr;
     const size_t msg_prefix_size = aep_ptr->adapter_con_state_ptr->adapter_state_ptr->msg_prefix_size;
 
-    struct fi_cq_data_entry comp_array[MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES];
-    int fi_ret = fi_cq_read(efa_endpoint_ptr->completion_queue_ptr, &comp_array,
-                            MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES);
-    // If the returned value is greater than zero, then the value is the number of completion queue messages that
-    // were returned in comp_array. If zero is returned, completion queue was empty. Otherwise a negative value
-    // represents an error or -FI_EAGAIN.
-    if (fi_ret > 0) {
-        for (int i = 0; i < fi_ret; i++) {
-            const size_t message_length = comp_array[i].len;
-            CdiSglEntry* sgl_entry_ptr = NULL;
-            // NOTE: This pool is not thread-safe, so must ensure that only one thread is accessing it at a time.
-            if (!CdiPoolGet(efa_endpoint_ptr->rx_state.packet_sgl_entries_pool_handle, (void**)&sgl_entry_ptr)) {
-                assert(false);
+    const size_t message_length = comp_ptr->len;
+    if (efa_endpoint_ptr->rx_state.multi_recv_supported) {
+        // Packets are received back-to-back into FI_MULTI_RECV buffers. Once libfabric releases a buffer, it is
+        // posted again when the last of its packets is freed. See EfaRxEndpointRxBuffersFree().
+        EfaRxMultiRecvBuffer* buffer_ptr = CONTAINER_OF(comp_ptr->op_context, EfaRxMultiRecvBuffer, context);
+        if (FI_MULTI_RECV & comp_ptr->flags) {
+            buffer_ptr->is_posted = false;
+        }
+        if (0 == message_length) {
+            // The provider released the buffer without receiving a packet.
+            if (!MultiRecvBufferRepost(efa_endpoint_ptr, buffer_ptr)) {
+                ProbeEndpointError(efa_endpoint_ptr->probe_endpoint_handle);
             }
+            return;
+        }
+        buffer_ptr->packets_held++;
+    } else if (efa_endpoint_ptr->rx_state.shared_pool_ptr) {
+        // The buffer is no longer posted. Poll() posts another one from the shared pool in its place.
+        EfaRxState* rx_state_ptr = &efa_endpoint_ptr->rx_state;
+        const int index = SharedPoolBufferIndex(rx_state_ptr->shared_pool_ptr, comp_ptr->buf);
+        rx_state_ptr->shared_posted_bitmap_ptr[index / 64] &= ~(1ULL << (index % 64));
+        rx_state_ptr->shared_posted_count--;
+    }
 
-            Packet packet = {
-                .sg_list = {
-                    .sgl_head_ptr = sgl_entry_ptr,
-                    .sgl_tail_ptr = sgl_entry_ptr,
-                    .total_data_size = message_length - msg_prefix_size,
-                    .internal_data_ptr = NULL,
-                },
-                .tx_state = {
-                    .ack_status = kAdapterPacketStatusOk
-                }
-            };
+    CdiSglEntry* sgl_entry_ptr = NULL;
+    // NOTE: This pool is not thread-safe, so must ensure that only one thread is accessing it at a time.
+    if (!CdiPoolGet(efa_endpoint_ptr->rx_state.packet_sgl_entries_pool_handle, (void**)&sgl_entry_ptr)) {
+        assert(false);
+    }
 
-            if (sgl_entry_ptr) {
-                sgl_entry_ptr->address_ptr = (char*)comp_array[i].buf + msg_prefix_size;
-                sgl_entry_ptr->size_in_bytes = message_length - msg_prefix_size;
-                sgl_entry_ptr->internal_data_ptr = NULL;
-                sgl_entry_ptr->next_ptr = NULL;
-            }
+    Packet packet = {
+        .sg_list = {
+            .sgl_head_ptr = sgl_entry_ptr,
+            .sgl_tail_ptr = sgl_entry_ptr,
+            .total_data_size = message_length - msg_prefix_size,
+            .internal_data_ptr = NULL,
+        },
+        .tx_state = {
+            .ack_status = kAdapterPacketStatusOk
+        }
+    };
+
+    if (sgl_entry_ptr) {
+        sgl_entry_ptr->address_ptr = (char*)comp_ptr->buf + msg_prefix_size;
+        sgl_entry_ptr->size_in_bytes = message_length - msg_prefix_size;
+        sgl_entry_ptr->internal_data_ptr = NULL;
+        sgl_entry_ptr->next_ptr = NULL;
+    }
+
+    if (FI_REMOTE_CQ_DATA & comp_ptr->flags) {
+        // The transmitter has written the payload of this packet into the receive buffer slot sent as remote CQ
+        // data. See EfaTxRmaSlotsUpdate(). Such a packet is stale if the probe is in use.
+        if (ProbeRxEfaMessageFromEndpoint != aep_ptr->msg_from_endpoint_func_ptr) {
+            packet.rma_slot_entry_ptr = RmaSlotEntryGet(efa_endpoint_ptr, comp_ptr->data);
+        }
+        if (NULL == packet.rma_slot_entry_ptr) {
+            // The packet can't be used without its payload data, so give its buffer back to libfabric.
+            EfaRxEndpointRxBuffersFree(aep_ptr, &packet.sg_list);
+            return;
+        }
+    }
+
+    if (drop) {
+        // The receive buffer slot that holds the packet's payload is released along with the packet's buffer.
+        if (packet.rma_slot_entry_ptr && sgl_entry_ptr) {
+            sgl_entry_ptr->next_ptr = packet.rma_slot_entry_ptr;
+            packet.sg_list.sgl_tail_ptr = packet.rma_slot_entry_ptr;
+        }
+        EfaRxEndpointRxBuffersFree(aep_ptr, &packet.sg_list);
+        return;
+    }
 
 #ifdef DEBUG_PACKET_SEQUENCES
-            CdiProtocolHandle protocol_handle = efa_endpoint_ptr->adapter_endpoint_ptr->protocol_handle;
-            CdiDecodedPacketHeader decoded_header = { 0 };
-            ProtocolPayloadHeaderDecode(protocol_handle, sgl_entry_ptr->address_ptr, sgl_entry_ptr->size_in_bytes,
-                                        &decoded_header);
-            CDI_LOG_THREAD(kLogInfo, "CQ T[%d] P[%d] S[%d] A[%p]", decoded_header.payload_type,
-                           decoded_header.payload_num, decoded_header.packet_sequence_num, sgl_entry_ptr->address_ptr);
+    CdiProtocolHandle protocol_handle = efa_endpoint_ptr->adapter_endpoint_ptr->protocol_handle;
+    CdiDecodedPacketHeader decoded_header = { 0 };
+    ProtocolPayloadHeaderDecode(protocol_handle, sgl_entry_ptr->address_ptr, sgl_entry_ptr->size_in_bytes,
+                                &decoded_header);
+    CDI_LOG_THREAD(kLogInfo, "CQ T[%d] P[%d] S[%d] A[%p]", decoded_header.payload_type,
+                   decoded_header.payload_num, decoded_header.packet_sequence_num, sgl_entry_ptr->address_ptr);
 #endif
 
-            // Send the completion message for the packet.
-            (aep_ptr->msg_from_endpoint_func_ptr)(aep_ptr->msg_from_endpoint_param_ptr, &packet,
-                                                  kEndpointMessageTypePacketReceived);
+    // Send the completion message for the packet.
+    (aep_ptr->msg_from_endpoint_func_ptr)(aep_ptr->msg_from_endpoint_param_ptr, &packet,
+                                          kEndpointMessageTypePacketReceived);
+
+    // NOTE: Instead of using PostRxBuffer() here to make a new Rx buffer available to libfabric, we will do
+    // it after the packet's buffer has been freed. See EfaRxEndpointRxBuffersFree(). This can be done
+    // because used PostRxBuffer() for all the Rx buffers when the endpoint was created in
+    // EfaRxEndpointOpen().
+}
+
+/**
+ * Used to poll a completion queue that is shared by several Rx endpoints for any pending completion events and process
+ * them. The completion queue is only read once per round of polls of the endpoints that share it.
+ *
+ * @param efa_endpoint_ptr Pointer to EFA endpoint state data.
+ *
+ * @return true if useful work was done, false if the function did nothing productive.
+ */
+static bool SharedPoll(EfaEndpointState* efa_endpoint_ptr)
+{
+    EfaSharedCompletionQueue* shared_cq_ptr = efa_endpoint_ptr->shared_cq_ptr;
+    if (++shared_cq_ptr->polls_since_read < shared_cq_ptr->endpoint_count) {
+        return false;
+    }
+    shared_cq_ptr->polls_since_read = 0;
 
-            // NOTE: Instead of using PostRxBuffer() here to make a new Rx buffer available to libfabric, we will do
-            // it after the packet's buffer has been freed. See EfaRxEndpointRxBuffersFree(). This can be done
-            // because used PostRxBuffer() for all the Rx buffers when the endpoint was created in
-            // EfaRxEndpointOpen().
+    CdiOsCritSectionReserve(shared_cq_ptr->lock);
+
+    // First process the completions that were read while another endpoint was being closed.
+    const int backlog_count = shared_cq_ptr->backlog_count;
+    shared_cq_ptr->backlog_count = 0;
+    for (int i = 0; i < backlog_count; i++) {
+        const struct fi_cq_data_entry* comp_ptr = &shared_cq_ptr->backlog_array_ptr[i];
+        ProcessCompletion(((EfaRxCompletionContext*)comp_ptr->op_context)->endpoint_ptr, comp_ptr, false);
+    }
+
+    struct fi_cq_data_entry comp_array[MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES];
+    int fi_ret = fi_cq_read(shared_cq_ptr->completion_queue_ptr, &comp_array, MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES);
+    if (fi_ret > 0) {
+        for (int i = 0; i < fi_ret; i++) {
+            // The context of the receive buffer identifies the endpoint that the completion belongs to.
+            ProcessCompletion(((EfaRxCompletionContext*)comp_array[i].op_context)->endpoint_ptr, &comp_array[i],
+                              false);
         }
     } else if (fi_ret < 0 && fi_ret != -FI_EAGAIN) {
         CDI_LOG_THREAD(kLogError, "Got[%d (%s)] from fi_cq_read().", fi_ret, fi_strerror(-fi_ret));
     }
-    return fi_ret > 0;
+
+    CdiOsCritSectionRelease(shared_cq_ptr->lock);
+
+    return fi_ret > 0 || backlog_count > 0;
+}
+
+/**
+ * Used to poll for any pending Rx completion events and process them.
+ *
+ * @param efa_endpoint_ptr Pointer to EFA endpoint state data.
+ *
+ * @return true if useful work was done, false if the function did nothing productive.
+ */
+static bool Poll(EfaEndpointState* efa_endpoint_ptr)
+{
+    bool did_work = false;
+    if (efa_endpoint_ptr->shared_cq_ptr) {
+        did_work = SharedPoll(efa_endpoint_ptr);
+    } else {
+        struct fi_cq_data_entry comp_array[MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES];
+        int fi_ret = fi_cq_read(efa_endpoint_ptr->completion_queue_ptr, &comp_array,
+                                MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES);
+        // If the returned value is greater than zero, then the value is the number of completion queue messages that
+        // were returned in comp_array. If zero is returned, completion queue was empty. Otherwise a negative value
+        // represents an error or -FI_EAGAIN.
+        if (fi_ret > 0) {
+            for (int i = 0; i < fi_ret; i++) {
+                ProcessCompletion(efa_endpoint_ptr, &comp_array[i], false);
+            }
+        } else if (fi_ret < 0 && fi_ret != -FI_EAGAIN) {
+            CDI_LOG_THREAD(kLogError, "Got[%d (%s)] from fi_cq_read().", fi_ret, fi_strerror(-fi_ret));
+        }
+        did_work = fi_ret > 0;
+    }
+
+    // Replace the shared pool buffers that packets were received into, or that could not be posted earlier because
+    // the pool was empty.
+    if (efa_endpoint_ptr->rx_state.shared_pool_ptr && EfaRxSharedPoolRefillDue(&efa_endpoint_ptr->rx_state) &&
+        !SharedPoolRefill(efa_endpoint_ptr)) {
+        ProbeEndpointError(efa_endpoint_ptr->probe_endpoint_handle);
+    }
+
+    return did_work;
+}
+
+/**
+ * Registers the memory of the adapter's shared receive pool with the domain of the endpoint and posts the first packet
+ * buffers of the endpoint from it.
+ *
+ * @param endpoint_state_ptr Pointer to endpoint.
+ *
+ * @return Returns true if no error, otherwise false is returned.
+ */
+static bool SharedPoolRegister(EfaEndpointState* endpoint_state_ptr)
+{
+    EfaRxState* rx_state_ptr = &endpoint_state_ptr->rx_state;
+    EfaRxSharedPacketPool* pool_ptr = rx_state_ptr->shared_pool_ptr;
+
+    if (NULL == rx_state_ptr->shared_posted_bitmap_ptr) {
+        // Kept until the endpoint is closed. See EfaRxEndpointClose().
+        rx_state_ptr->shared_posted_bitmap_ptr =
+            CdiOsMemAllocZero(((pool_ptr->packet_count + 63) / 64) * sizeof(uint64_t));
+        if (NULL == rx_state_ptr->shared_posted_bitmap_ptr) {
+            return false;
+        }
+    }
+    rx_state_ptr->shared_posted_count = 0;
+    // Use one less than the maximum size for the same reason as CreatePacketPool().
+    rx_state_ptr->shared_posted_target = CDI_MIN(EFA_RX_SHARED_POOL_POSTED_PACKETS,
+                                                 (int)endpoint_state_ptr->fabric_info_ptr->rx_attr->size - 1);
+
+    rx_state_ptr->shared_refill_backoff = 0;
+    rx_state_ptr->shared_refill_skip_count = 0;
+
+    // The memory is registered once per domain, since the pinned pages are counted against RLIMIT_MEMLOCK by each
+    // registration. Endpoints that share a completion queue share its domain and so the registration too.
+    EfaSharedCompletionQueue* shared_cq_ptr = endpoint_state_ptr->shared_cq_ptr;
+    if (shared_cq_ptr && shared_cq_ptr->shared_pool_memory_region_ptr) {
+        rx_state_ptr->memory_region_ptr = shared_cq_ptr->shared_pool_memory_region_ptr;
+    } else {
+        int fi_ret = fi_mr_reg(endpoint_state_ptr->domain_ptr, pool_ptr->buffer_ptr,
+                               (uint64_t)pool_ptr->aligned_packet_size * pool_ptr->packet_count, FI_RECV, 0, 0, 0,
+                               &rx_state_ptr->memory_region_ptr, NULL);
+        if (0 != fi_ret) {
+            CDI_LOG_THREAD(kLogError, "Libfabric failed to register shared receive pool memory [%d (%s)]. This could "
+                           "be caused by insufficient ulimit locked memory.", fi_ret, fi_strerror(-fi_ret));
+            rx_state_ptr->memory_region_ptr = NULL;
+            return false;
+        }
+        if (shared_cq_ptr) {
+            shared_cq_ptr->shared_pool_memory_region_ptr = rx_state_ptr->memory_region_ptr;
+        }
+    }
+    if (shared_cq_ptr) {
+        shared_cq_ptr->shared_pool_mr_count++;
+        rx_state_ptr->shared_pool_mr_owner_ptr = shared_cq_ptr;
+    }
+
+    return SharedPoolRefill(endpoint_state_ptr);
+}
+
+/**
+ * Returns the packet buffers that are still posted to the closed libfabric endpoint to the adapter's shared receive
+ * pool and unregisters the pool memory from the domain of the endpoint.
+ *
+ * @param endpoint_state_ptr Pointer to endpoint.
+ */
+static void SharedPoolUnregister(EfaEndpointState* endpoint_state_ptr)
+{
+    EfaRxState* rx_state_ptr = &endpoint_state_ptr->rx_state;
+    EfaRxSharedPacketPool* pool_ptr = rx_state_ptr->shared_pool_ptr;
+
+    if (rx_state_ptr->shared_posted_bitmap_ptr) {
+        uint8_t* buffer_array[SHARED_POOL_BATCH_SIZE];
+        int count = 0;
+        const int word_count = (pool_ptr->packet_count + 63) / 64;
+        for (int word = 0; word < word_count; word++) {
+            const uint64_t bits = rx_state_ptr->shared_posted_bitmap_ptr[word];
+            rx_state_ptr->shared_posted_bitmap_ptr[word] = 0;
+            for (int bit = 0; 0 != bits && bit < 64; bit++) {
+                if (bits & (1ULL << bit)) {
+                    buffer_array[count++] = pool_ptr->buffer_ptr +
+                                            (uint64_t)(word * 64 + bit) * pool_ptr->aligned_packet_size;
+                    if (SHARED_POOL_BATCH_SIZE == count) {
+                        SharedPoolBuffersPut(endpoint_state_ptr, buffer_array, count);
+                        count = 0;
+                    }
+                }
+            }
+        }
+        if (0 < count) {
+            SharedPoolBuffersPut(endpoint_state_ptr, buffer_array, count);
+        }
+    }
+    rx_state_ptr->shared_posted_count = 0;
+
+    // A registration shared with other endpoints of the domain is closed by the last one, before the domain is closed.
+    EfaSharedCompletionQueue* mr_owner_ptr = rx_state_ptr->shared_pool_mr_owner_ptr;
+    if (mr_owner_ptr && 0 < --mr_owner_ptr->shared_pool_mr_count) {
+        rx_state_ptr->memory_region_ptr = NULL;
+    } else if (mr_owner_ptr) {
+        mr_owner_ptr->shared_pool_memory_region_ptr = NULL;
+    }
+    rx_state_ptr->shared_pool_mr_owner_ptr = NULL;
+    if (NULL != rx_state_ptr->memory_region_ptr) {
+        int rs = fi_close(&rx_state_ptr->memory_region_ptr->fid);
+        if (0 != rs) {
+            CDI_LOG_THREAD(kLogError, "Got[%d (%s)] from fi_close().", rs, fi_strerror(-rs));
+        }
+        rx_state_ptr->memory_region_ptr = NULL;
+    }
 }
 
 /**
@@ -170,7 +631,28 @@ static bool CreatePacketPool(EfaEndpointState* endpoint_state_ptr, int packet_si
     // Ensure buffer was properly freed before allocating a new one. See FreePacketPool().
     assert(NULL == endpoint_state_ptr->rx_state.allocated_buffer_ptr);
 
-    if (packet_count >= (int)endpoint_state_ptr->fabric_info_ptr->rx_attr->size) {
+    EfaRxState* rx_state_ptr = &endpoint_state_ptr->rx_state;
+    rx_state_ptr->completion_context.endpoint_ptr = endpoint_state_ptr;
+    rx_state_ptr->multi_recv_buffer_count = 0;
+    if (rx_state_ptr->shared_pool_ptr) {
+        // Packet buffers are taken from the adapter's shared receive pool instead.
+        return SharedPoolRegister(endpoint_state_ptr);
+    }
+    if (rx_state_ptr->multi_recv_supported) {
+        // Have libfabric release a buffer once it can't hold another packet of the largest size.
+        size_t min_multi_recv = packet_size;
+        int fi_ret = fi_setopt(&endpoint_state_ptr->endpoint_ptr->fid, FI_OPT_ENDPOINT, FI_OPT_MIN_MULTI_RECV,
+                               &min_multi_recv, sizeof(min_multi_recv));
+        if (0 != fi_ret) {
+            CDI_LOG_THREAD(kLogWarning, "Got [%d (%s)] from fi_setopt(FI_OPT_MIN_MULTI_RECV). Posting one receive "
+                           "buffer per packet.", fi_ret, fi_strerror(-fi_ret));
+            rx_state_ptr->multi_recv_supported = false;
+        }
+    }
+
+    // Only a few FI_MULTI_RECV buffers are posted, so the limit of posted receive buffers doesn't apply to them.
+    if (!rx_state_ptr->multi_recv_supported &&
+        packet_count >= (int)endpoint_state_ptr->fabric_info_ptr->rx_attr->size) {
         CDI_LOG_THREAD(kLogWarning, "Requested Rx packet buffer count[%d] exceeds endpoint capability[%d]. Reducing.",
                        packet_count, endpoint_state_ptr->fabric_info_ptr->rx_attr->size);
         // Use one less than the maximum size so we never run out of buffers. For some providers, using the maximum
@@ -206,7 +688,24 @@ static bool CreatePacketPool(EfaEndpointState* endpoint_state_ptr, int packet_si
         int fi_ret = fi_mr_reg(endpoint_state_ptr->domain_ptr, mem_ptr, aligned_packet_size * packet_count,
                            FI_RECV, 0, 0, 0,
                            &endpoint_state_ptr->rx_state.memory_region_ptr, NULL);
-        if (0 == fi_ret) {
+        if (0 == fi_ret && rx_state_ptr->multi_recv_supported) {
+            // Split the allocated memory into FI_MULTI_RECV buffers that each hold at least two packets.
+            int buffer_count = CDI_MIN(EFA_RX_MULTI_RECV_BUFFER_COUNT, packet_count / 2);
+            buffer_count = CDI_MAX(buffer_count, 1);
+            rx_state_ptr->multi_recv_buffer_size = aligned_packet_size * (packet_count / buffer_count);
+            rx_state_ptr->multi_recv_buffer_count = buffer_count;
+
+            ret = true;
+            for (int i = 0; ret && i < buffer_count; i++) {
+                EfaRxMultiRecvBuffer* buffer_ptr = &rx_state_ptr->multi_recv_buffer_array[i];
+                buffer_ptr->context.endpoint_ptr = endpoint_state_ptr;
+                buffer_ptr->buffer_ptr = mem_ptr;
+                buffer_ptr->is_posted = false;
+                buffer_ptr->packets_held = 0;
+                ret = MultiRecvBufferRepost(endpoint_state_ptr, buffer_ptr);
+                mem_ptr += rx_state_ptr->multi_recv_buffer_size;
+            }
+        } else if (0 == fi_ret) {
             // Give fragments of allocated memory to libfabric for receiving packet data into.
             struct iovec msg_iov = {
                 .iov_len = packet_size
@@ -215,7 +714,7 @@ static bool CreatePacketPool(EfaEndpointState* endpoint_state_ptr, int packet_si
             ret = true;
             for (int i = 0; ret && i < packet_count; i++) {
                 msg_iov.iov_base = mem_ptr;
-                if (!PostRxBuffer(endpoint_state_ptr, &msg_iov, (i + 1 != packet_count))) {
+                if (!PostRxBuffer(endpoint_state_ptr, &msg_iov, (i + 1 != packet_count), NULL)) {
                     ret = false;
                 }
                 mem_ptr += aligned_packet_size;
@@ -249,7 +748,9 @@ static bool CreatePacketPool(EfaEndpointState* endpoint_state_ptr, int packet_si
  */
 static void FreePacketPool(EfaEndpointState* endpoint_state_ptr)
 {
-    if (NULL != endpoint_state_ptr->rx_state.allocated_buffer_ptr) {
+    if (endpoint_state_ptr->rx_state.shared_pool_ptr) {
+        SharedPoolUnregister(endpoint_state_ptr);
+    } else if (NULL != endpoint_state_ptr->rx_state.allocated_buffer_ptr) {
         // Unregister the region from libfabric.
         int rs = fi_close(&endpoint_state_ptr->rx_state.memory_region_ptr->fid);
         if (0 != rs) {
@@ -264,6 +765,7 @@ static void FreePacketPool(EfaEndpointState* endpoint_state_ptr)
         }
         endpoint_state_ptr->rx_state.allocated_buffer_ptr = NULL;
         endpoint_state_ptr->rx_state.allocated_buffer_size = 0;
+        endpoint_state_ptr->rx_state.multi_recv_buffer_count = 0;
     }
 }
 
@@ -333,6 +835,13 @@ CdiReturnStatus EfaRxEndpointClose(EfaEndpointState* endpoint_state_ptr)
     CdiPoolDestroy(endpoint_state_ptr->rx_state.packet_sgl_entries_pool_handle);
     endpoint_state_ptr->rx_state.packet_sgl_entries_pool_handle = NULL;
 
+    RmaSlotsFree(endpoint_state_ptr);
+
+    if (endpoint_state_ptr->rx_state.shared_posted_bitmap_ptr) {
+        CdiOsMemFree(endpoint_state_ptr->rx_state.shared_posted_bitmap_ptr);
+        endpoint_state_ptr->rx_state.shared_posted_bitmap_ptr = NULL;
+    }
+
     return kCdiStatusOk;
 }
 
@@ -348,14 +857,46 @@ CdiReturnStatus EfaRxEndpointRxBuffersFree(const AdapterEndpointHandle handle, c
                    msg_prefix_size
     };
 
+    // Buffers are posted to a domain that other endpoints share, so serialize access to it.
+    EfaSharedCompletionQueue* shared_cq_ptr = endpoint_state_ptr->shared_cq_ptr;
+    if (shared_cq_ptr) {
+        CdiOsCritSectionReserve(shared_cq_ptr->lock);
+    }
+
+    // Packet buffers of the adapter's shared receive pool are returned to it in batches.
+    uint8_t* put_array[SHARED_POOL_BATCH_SIZE];
+    int put_count = 0;
+
     // Free SGL data buffers and SGL entries.
     CdiSglEntry *sgl_entry_ptr = sgl_ptr->sgl_head_ptr;
     while (sgl_entry_ptr) {
         msg_iov.iov_base = (char*)sgl_entry_ptr->address_ptr - msg_prefix_size;
+        // Receive buffer slots are not posted to libfabric, so don't expect another post after a slot entry.
+        const bool more_to_post = NULL != sgl_entry_ptr->next_ptr &&
+                                  !IsRmaSlotEntry(endpoint_state_ptr, sgl_entry_ptr->next_ptr);
 
         // NOTE: This function is called from PollThread(), so no need to use libfabric's FI_THREAD_SAFE option.
         // Access to libfabric functions such as fi_recvmsg() and fi_cq_read() use PollThread().
-        if (!PostRxBuffer(endpoint_state_ptr, &msg_iov, NULL != sgl_entry_ptr->next_ptr)) {
+        if (IsRmaSlotEntry(endpoint_state_ptr, sgl_entry_ptr)) {
+            RmaSlotRelease(endpoint_state_ptr, sgl_entry_ptr);
+        } else if (endpoint_state_ptr->rx_state.multi_recv_supported) {
+            // The packet's FI_MULTI_RECV buffer is posted again once all of its packets have been freed.
+            EfaRxMultiRecvBuffer* buffer_ptr = EfaRxMultiRecvBufferFind(endpoint_state_ptr, msg_iov.iov_base);
+            if (buffer_ptr && 0 < buffer_ptr->packets_held) {
+                buffer_ptr->packets_held--;
+                if (!MultiRecvBufferRepost(endpoint_state_ptr, buffer_ptr)) {
+                    ProbeEndpointError(endpoint_state_ptr->probe_endpoint_handle);
+                    rs = kCdiStatusNotConnected;
+                }
+            }
+        } else if (endpoint_state_ptr->rx_state.shared_pool_ptr) {
+            // The buffer goes back to the shared pool. Buffers are posted from it again below and by Poll().
+            put_array[put_count++] = msg_iov.iov_base;
+            if (SHARED_POOL_BATCH_SIZE == put_count) {
+                SharedPoolBuffersPut(endpoint_state_ptr, put_array, put_count);
+                put_count = 0;
+            }
+        } else if (!PostRxBuffer(endpoint_state_ptr, &msg_iov, more_to_post, NULL)) {
             // Something went terribly wrong in libfabric. Notify the probe component so it can start the connection
             // reset process.
             ProbeEndpointError(endpoint_state_ptr->probe_endpoint_handle);
@@ -369,6 +910,18 @@ CdiReturnStatus EfaRxEndpointRxBuffersFree(const AdapterEndpointHandle handle, c
         sgl_entry_ptr = next_ptr; // Point to next SGL entry
     }
 
+    if (0 < put_count) {
+        SharedPoolBuffersPut(endpoint_state_ptr, put_array, put_count);
+    }
+    if (endpoint_state_ptr->rx_state.shared_pool_ptr && !SharedPoolRefill(endpoint_state_ptr)) {
+        ProbeEndpointError(endpoint_state_ptr->probe_endpoint_handle);
+        rs = kCdiStatusNotConnected;
+    }
+
+    if (shared_cq_ptr) {
+        CdiOsCritSectionRelease(shared_cq_ptr->lock);
+    }
+
     return rs;
 }
 
@@ -376,6 +929,10 @@ CdiReturnStatus EfaRxPacketPoolCreate(EfaEndpointState* endpoint_state_ptr)
 {
     CdiReturnStatus rs = kCdiStatusOk;
 
+    EfaConnectionState* efa_con_ptr =
+        (EfaConnectionState*)endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->type_specific_ptr;
+    endpoint_state_ptr->rx_state.shared_pool_ptr = efa_con_ptr->shared_pool_ptr;
+
     int reserve_packets =
         endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->rx_state.reserve_packet_buffers;
     int max_payload_size =
@@ -393,3 +950,359 @@ void EfaRxPacketPoolFree(EfaEndpointState* endpoint_state_ptr)
 {
     FreePacketPool(endpoint_state_ptr);
 }
+
+CdiReturnStatus EfaRxRmaSlotsRegister(EfaEndpointState* endpoint_state_ptr)
+{
+    CdiReturnStatus rs = kCdiStatusOk;
+    AdapterConnectionState* adapter_con_ptr = endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr;
+    EfaRxRmaSlots* slots_ptr = &endpoint_state_ptr->rx_state.rma_slots;
+    const uint32_t slot_size = adapter_con_ptr->rx_state.rma_slot_size;
+    if (0 == slot_size) {
+        return rs;
+    }
+
+    // The slots are allocated once for the life of the endpoint, since the application may still hold payloads in
+    // them while the endpoint is being reset.
+    if (NULL == slots_ptr->buffer_ptr) {
+        CDI_STATIC_ASSERT(EFA_RX_RMA_SLOT_COUNT <= CDI_MAX_RMA_SLOTS, "EFA_RX_RMA_SLOT_COUNT is too large.");
+        // Round up to next even-multiple of hugepages byte size.
+        uint64_t allocated_size = ((uint64_t)slot_size * EFA_RX_RMA_SLOT_COUNT + CDI_HUGE_PAGES_BYTE_SIZE - 1) /
+                                  CDI_HUGE_PAGES_BYTE_SIZE * CDI_HUGE_PAGES_BYTE_SIZE;
+        if (allocated_size > INT32_MAX) {
+            CDI_LOG_HANDLE(adapter_con_ptr->log_handle, kLogWarning, "Receive buffer slots of [%u] bytes are too large."
+                           " RMA direct placement is disabled.", slot_size);
+            return rs;
+        }
+        slots_ptr->buffer_ptr = CdiOsMemAllocHugePage((int32_t)allocated_size);
+        slots_ptr->was_from_heap = (NULL == slots_ptr->buffer_ptr);
+        if (slots_ptr->was_from_heap) {
+            // Fallback using heap memory.
+            slots_ptr->buffer_ptr = CdiOsMemAlloc((int32_t)allocated_size);
+        }
+        if (NULL == slots_ptr->buffer_ptr) {
+            rs = kCdiStatusNotEnoughMemory;
+        } else if (!CdiOsCritSectionCreate(&slots_ptr->lock)) {
+            rs = kCdiStatusNotEnoughMemory;
+        } else {
+            slots_ptr->allocated_size = (int)allocated_size;
+            slots_ptr->slot_size = slot_size;
+            slots_ptr->slot_count = EFA_RX_RMA_SLOT_COUNT;
+            slots_ptr->held_mask = 0;
+            memset(slots_ptr->release_count_array, 0, sizeof(slots_ptr->release_count_array));
+            slots_ptr->advert_pending = false;
+        }
+        if (kCdiStatusOk != rs) {
+            RmaSlotsFree(endpoint_state_ptr);
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        // The sockets provider does not generate keys and uses zero for the packet buffers, so request a different
+        // one. Providers that generate keys ignore it.
+        const uint64_t requested_key = 1;
+        int fi_ret = fi_mr_reg(endpoint_state_ptr->domain_ptr, slots_ptr->buffer_ptr,
+                               (uint64_t)slots_ptr->slot_size * slots_ptr->slot_count, FI_REMOTE_WRITE, 0,
+                               requested_key, 0, &slots_ptr->memory_region_ptr, NULL);
+        if (0 != fi_ret) {
+            // Payloads are still received in packets, so this is not fatal.
+            CDI_LOG_HANDLE(adapter_con_ptr->log_handle, kLogWarning, "Got [%d (%s)] from fi_mr_reg() of receive "
+                           "buffer slots. RMA direct placement is disabled.", fi_ret, fi_strerror(-fi_ret));
+            slots_ptr->memory_region_ptr = NULL;
+        }
+    }
+
+    return rs;
+}
+
+void EfaRxRmaSlotsUnregister(EfaEndpointState* endpoint_state_ptr)
+{
+    EfaRxRmaSlots* slots_ptr = &endpoint_state_ptr->rx_state.rma_slots;
+    if (NULL != slots_ptr->memory_region_ptr) {
+        int fi_ret = fi_close(&slots_ptr->memory_region_ptr->fid);
+        if (0 != fi_ret) {
+            CDI_LOG_THREAD(kLogError, "Got[%d (%s)] from fi_close().", fi_ret, fi_strerror(-fi_ret));
+        }
+        slots_ptr->memory_region_ptr = NULL;
+    }
+}
+
+bool EfaRxRmaSlotsGet(EfaEndpointState* endpoint_state_ptr, CdiDecodedProbeRmaSlots* ret_rma_slots_ptr)
+{
+    EfaRxRmaSlots* slots_ptr = &endpoint_state_ptr->rx_state.rma_slots;
+    if (NULL == slots_ptr->memory_region_ptr) {
+        return false;
+    }
+
+    // Remote writes address the slots by virtual address or by offset into the memory region, depending on the
+    // provider.
+    const bool use_virtual_address =
+        0 != (endpoint_state_ptr->fabric_info_ptr->domain_attr->mr_mode & FI_MR_VIRT_ADDR);
+    ret_rma_slots_ptr->base_address = use_virtual_address ? (uint64_t)slots_ptr->buffer_ptr : 0;
+    ret_rma_slots_ptr->key = fi_mr_key(slots_ptr->memory_region_ptr);
+    ret_rma_slots_ptr->slot_size = slots_ptr->slot_size;
+    ret_rma_slots_ptr->slot_count = (uint8_t)slots_ptr->slot_count;
+
+    CdiOsCritSectionReserve(slots_ptr->lock);
+    ret_rma_slots_ptr->held_mask = slots_ptr->held_mask;
+    memcpy(ret_rma_slots_ptr->release_count_array, slots_ptr->release_count_array,
+           sizeof(ret_rma_slots_ptr->release_count_array));
+    slots_ptr->advert_pending = false;
+    CdiOsCritSectionRelease(slots_ptr->lock);
+
+    return true;
+}
+
+CdiReturnStatus EfaRxSharedCompletionQueueGet(CdiList* list_ptr, const PollThreadState* poll_thread_state_ptr,
+                                              EfaSharedCompletionQueue** ret_shared_cq_ptr)
+{
+    EfaSharedCompletionQueue* shared_cq_ptr = NULL;
+    CdiListIterator list_iterator;
+    CdiListIteratorInit(list_ptr, &list_iterator);
+    while (NULL != (shared_cq_ptr = (EfaSharedCompletionQueue*)CdiListIteratorGetNext(&list_iterator))) {
+        if (poll_thread_state_ptr == shared_cq_ptr->poll_thread_state_ptr) {
+            break;
+        }
+    }
+
+    if (NULL == shared_cq_ptr) {
+        shared_cq_ptr = CdiOsMemAllocZero(sizeof(*shared_cq_ptr));
+        if (NULL == shared_cq_ptr) {
+            return kCdiStatusNotEnoughMemory;
+        }
+        if (!CdiOsCritSectionCreate(&shared_cq_ptr->lock)) {
+            CdiOsMemFree(shared_cq_ptr);
+            return kCdiStatusNotEnoughMemory;
+        }
+        shared_cq_ptr->poll_thread_state_ptr = poll_thread_state_ptr;
+        CdiListAddTail(list_ptr, &shared_cq_ptr->list_entry);
+    }
+    shared_cq_ptr->connection_count++;
+    *ret_shared_cq_ptr = shared_cq_ptr;
+
+    return kCdiStatusOk;
+}
+
+void EfaRxSharedCompletionQueuePut(CdiList* list_ptr, EfaSharedCompletionQueue* shared_cq_ptr)
+{
+    if (0 < --shared_cq_ptr->connection_count) {
+        return;
+    }
+
+    // All endpoints have been closed, so the shared libfabric objects have already been closed.
+    assert(0 == shared_cq_ptr->endpoint_count);
+    CdiListRemove(list_ptr, &shared_cq_ptr->list_entry);
+    CdiOsCritSectionDelete(shared_cq_ptr->lock);
+    if (shared_cq_ptr->backlog_array_ptr) {
+        CdiOsMemFree(shared_cq_ptr->backlog_array_ptr);
+    }
+    CdiOsMemFree(shared_cq_ptr);
+}
+
+void EfaRxSharedCompletionQueueDrain(EfaEndpointState* endpoint_ptr)
+{
+    EfaSharedCompletionQueue* shared_cq_ptr = endpoint_ptr->shared_cq_ptr;
+
+    // Remove the endpoint's completions from the backlog.
+    int count = 0;
+    for (int i = 0; i < shared_cq_ptr->backlog_count; i++) {
+        const struct fi_cq_data_entry* comp_ptr = &shared_cq_ptr->backlog_array_ptr[i];
+        if (endpoint_ptr != ((EfaRxCompletionContext*)comp_ptr->op_context)->endpoint_ptr) {
+            shared_cq_ptr->backlog_array_ptr[count++] = *comp_ptr;
+        }
+    }
+    shared_cq_ptr->backlog_count = count;
+
+    // Read all pending completions, since the ones of this endpoint can't be processed once it has been closed. Keep
+    // the others in the backlog.
+    struct fi_cq_data_entry comp_array[MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES];
+    while (true) {
+        int fi_ret = fi_cq_read(shared_cq_ptr->completion_queue_ptr, &comp_array,
+                                MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES);
+        if (-FI_EAVAIL == fi_ret) {
+            struct fi_cq_err_entry err_entry = { 0 };
+            fi_ret = fi_cq_readerr(shared_cq_ptr->completion_queue_ptr, &err_entry, 0);
+            if (fi_ret > 0) {
+                CDI_LOG_THREAD(kLogWarning, "Discarded error completion[%d (%s)] of shared completion queue.",
+                               err_entry.err, fi_strerror(err_entry.err));
+                continue;
+            }
+        }
+        if (fi_ret <= 0) {
+            break;
+        }
+        for (int i = 0; i < fi_ret; i++) {
+            EfaEndpointState* owner_ptr = ((EfaRxCompletionContext*)comp_array[i].op_context)->endpoint_ptr;
+            if (endpoint_ptr == owner_ptr) {
+                continue;
+            }
+            if (shared_cq_ptr->backlog_count == shared_cq_ptr->backlog_size) {
+                // Grow the backlog.
+                const int new_size = CDI_MAX(2 * shared_cq_ptr->backlog_size, MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES);
+                struct fi_cq_data_entry* new_array_ptr = CdiOsMemAlloc(new_size * sizeof(*new_array_ptr));
+                if (NULL == new_array_ptr) {
+                    // Don't lose the receive buffer of the other endpoint. Only its packet is dropped.
+                    CDI_LOG_THREAD(kLogWarning, "Failed to grow shared completion queue backlog. Packet dropped.");
+                    ProcessCompletion(owner_ptr, &comp_array[i], true);
+                    continue;
+                }
+                if (shared_cq_ptr->backlog_array_ptr) {
+                    memcpy(new_array_ptr, shared_cq_ptr->backlog_array_ptr,
+                           shared_cq_ptr->backlog_count * sizeof(*new_array_ptr));
+                    CdiOsMemFree(shared_cq_ptr->backlog_array_ptr);
+                }
+                shared_cq_ptr->backlog_array_ptr = new_array_ptr;
+                shared_cq_ptr->backlog_size = new_size;
+            }
+            shared_cq_ptr->backlog_array_ptr[shared_cq_ptr->backlog_count++] = comp_array[i];
+        }
+    }
+}
+
+CdiReturnStatus EfaRxSharedPacketPoolCreate(int packet_size, int packet_count, EfaRxSharedPacketPool** ret_pool_ptr)
+{
+    // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
+    CdiReturnStatus rs = kCdiStatusOk;
+
+    const int aligned_packet_size = (packet_size + packet_buffer_alignment - 1) & ~(packet_buffer_alignment - 1);
+    // Huge pages are not guaranteed to be aligned at all. Add enough padding to be able to shift the starting address
+    // to an aligned location, then round up to next even-multiple of hugepages byte size.
+    uint64_t allocated_size = (uint64_t)aligned_packet_size * packet_count + packet_buffer_alignment;
+    allocated_size = (allocated_size + CDI_HUGE_PAGES_BYTE_SIZE - 1) / CDI_HUGE_PAGES_BYTE_SIZE *
+                     CDI_HUGE_PAGES_BYTE_SIZE;
+    if (allocated_size > INT32_MAX) {
+        SDK_LOG_GLOBAL(kLogError, "Shared receive pool of [%d] packet buffers is too large.", packet_count);
+        rs = kCdiStatusInvalidParameter;
+    }
+
+    EfaRxSharedPacketPool* pool_ptr = NULL;
+    if (kCdiStatusOk == rs) {
+        pool_ptr = CdiOsMemAllocZero(sizeof(*pool_ptr));
+        if (NULL == pool_ptr) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        pool_ptr->free_array_ptr = CdiOsMemAlloc(packet_count * sizeof(*pool_ptr->free_array_ptr));
+        if (NULL == pool_ptr->free_array_ptr || !CdiOsCritSectionCreate(&pool_ptr->lock)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        pool_ptr->allocated_buffer_ptr = CdiOsMemAllocHugePage((int32_t)allocated_size);
+        pool_ptr->allocated_buffer_was_from_heap = (NULL == pool_ptr->allocated_buffer_ptr);
+        if (pool_ptr->allocated_buffer_was_from_heap) {
+            // Fallback using heap memory.
+            pool_ptr->allocated_buffer_ptr = CdiOsMemAlloc((int32_t)allocated_size);
+        }
+        if (NULL == pool_ptr->allocated_buffer_ptr) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        pool_ptr->allocated_buffer_size = (int)allocated_size;
+        // Move the address pointer up to the next aligned position.
+        pool_ptr->buffer_ptr = (uint8_t*)(((uint64_t)((uint8_t*)pool_ptr->allocated_buffer_ptr +
+                                                      packet_buffer_alignment - 1)) & ~(packet_buffer_alignment - 1));
+        pool_ptr->packet_size = packet_size;
+        pool_ptr->aligned_packet_size = aligned_packet_size;
+        pool_ptr->packet_count = packet_count;
+        for (int i = 0; i < packet_count; i++) {
+            pool_ptr->free_array_ptr[i] = pool_ptr->buffer_ptr + (uint64_t)i * aligned_packet_size;
+        }
+        pool_ptr->free_count = packet_count;
+        SDK_LOG_GLOBAL(kLogInfo, "Allocated shared receive pool of [%d] packet buffers.", packet_count);
+    } else {
+        EfaRxSharedPacketPoolDestroy(pool_ptr);
+        pool_ptr = NULL;
+    }
+
+    *ret_pool_ptr = pool_ptr;
+
+    return rs;
+}
+
+void EfaRxSharedPacketPoolDestroy(EfaRxSharedPacketPool* pool_ptr)
+{
+    if (NULL == pool_ptr) {
+        return;
+    }
+
+    if (pool_ptr->allocated_buffer_ptr) {
+        if (pool_ptr->allocated_buffer_was_from_heap) {
+            CdiOsMemFree(pool_ptr->allocated_buffer_ptr);
+        } else {
+            CdiOsMemFreeHugePage(pool_ptr->allocated_buffer_ptr, pool_ptr->allocated_buffer_size);
+        }
+    }
+    if (pool_ptr->free_array_ptr) {
+        CdiOsMemFree(pool_ptr->free_array_ptr);
+    }
+    if (pool_ptr->lock) {
+        CdiOsCritSectionDelete(pool_ptr->lock);
+    }
+    CdiOsMemFree(pool_ptr);
+}
+
+int EfaRxSharedPacketPoolGet(EfaRxSharedPacketPool* pool_ptr, int quota, int* held_count_ptr,
+                             uint8_t** ret_buffer_array, int count)
+{
+    CdiOsCritSectionReserve(pool_ptr->lock);
+    count = CDI_MIN(count, CDI_MIN(pool_ptr->free_count, quota - *held_count_ptr));
+    count = CDI_MAX(count, 0);
+    for (int i = 0; i < count; i++) {
+        ret_buffer_array[i] = pool_ptr->free_array_ptr[--pool_ptr->free_count];
+    }
+    *held_count_ptr += count;
+    CdiOsCritSectionRelease(pool_ptr->lock);
+
+    return count;
+}
+
+void EfaRxSharedPacketPoolPut(EfaRxSharedPacketPool* pool_ptr, int* held_count_ptr, uint8_t* const* buffer_array,
+                              int count)
+{
+    CdiOsCritSectionReserve(pool_ptr->lock);
+    for (int i = 0; i < count; i++) {
+        pool_ptr->free_array_ptr[pool_ptr->free_count++] = buffer_array[i];
+    }
+    *held_count_ptr -= count;
+    CdiOsCritSectionRelease(pool_ptr->lock);
+}
+
+bool EfaRxSharedPoolRefillDue(EfaRxState* rx_state_ptr)
+{
+    if (0 < rx_state_ptr->shared_refill_skip_count) {
+        rx_state_ptr->shared_refill_skip_count--;
+        return false;
+    }
+    return true;
+}
+
+void EfaRxSharedPoolRefillBackoff(EfaRxState* rx_state_ptr, bool got_buffers)
+{
+    if (got_buffers) {
+        rx_state_ptr->shared_refill_backoff = 0;
+    } else {
+        rx_state_ptr->shared_refill_backoff = CDI_MIN(CDI_MAX(2 * rx_state_ptr->shared_refill_backoff, 1),
+                                                      EFA_RX_SHARED_POOL_MAX_REFILL_BACKOFF);
+    }
+    rx_state_ptr->shared_refill_skip_count = rx_state_ptr->shared_refill_backoff;
+}
+
+EfaRxMultiRecvBuffer* EfaRxMultiRecvBufferFind(EfaEndpointState* endpoint_ptr, const uint8_t* packet_ptr)
+{
+    EfaRxState* rx_state_ptr = &endpoint_ptr->rx_state;
+    if (0 == rx_state_ptr->multi_recv_buffer_count) {
+        return NULL;
+    }
+    const uint8_t* first_buffer_ptr = rx_state_ptr->multi_recv_buffer_array[0].buffer_ptr;
+    if (packet_ptr < first_buffer_ptr) {
+        return NULL;
+    }
+    const uint64_t index = (uint64_t)(packet_ptr - first_buffer_ptr) / rx_state_ptr->multi_recv_buffer_size;
+    return (index < (uint64_t)rx_state_ptr->multi_recv_buffer_count) ? &rx_state_ptr->multi_recv_buffer_array[index] :
+                                                                       NULL;
+}
@@ -24,6 +24,7 @@
 
 #include "rdma/fabric.h"
 #include "rdma/fi_endpoint.h"
+#include "rdma/fi_rma.h"
 
 //*********************************************************************************************************************
 //***************************************** START OF DEFINITIONS AND TYPES ********************************************
@@ -37,6 +38,120 @@
 //******************************************* START OF STATIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
 
+/**
+ * Remove the entry from the endpoint's memory region cache for an application memory region that is being
+ * unregistered from the adapter and close its libfabric memory region. Called by CdiAdapterMemoryUnregister() from the
+ * application's thread with CdiAdapterState.memory_region_lock held.
+ *
+ * @param user_ptr Pointer to the memory region user of the endpoint (EfaTxState.mr_user).
+ * @param region_ptr Pointer to the region that is being unregistered.
+ */
+static void MemoryRegionCacheRelease(AdapterMemoryRegionUser* user_ptr, const AdapterMemoryRegion* region_ptr)
+{
+    // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
+    EfaTxState* tx_state_ptr = CONTAINER_OF(user_ptr, EfaTxState, mr_user);
+    for (int i = 0; i < tx_state_ptr->mr_cache_count; i++) {
+        EfaTxMemoryRegionCacheEntry* entry_ptr = &tx_state_ptr->mr_cache_array[i];
+        if (entry_ptr->region.region_id == region_ptr->region_id) {
+            int ret = fi_close(&entry_ptr->memory_region_ptr->fid);
+            if (0 != ret) {
+                SDK_LOG_GLOBAL(kLogError, "Got [%d (%s)] from fi_close() of memory region[%p].", ret,
+                               fi_strerror(-ret), entry_ptr->region.address_ptr);
+            }
+            // Move the last entry into this one.
+            *entry_ptr = tx_state_ptr->mr_cache_array[--tx_state_ptr->mr_cache_count];
+            break;
+        }
+    }
+}
+
+/**
+ * Get the libfabric memory descriptor to use for a block of memory that is being sent. Memory in the adapter's Tx
+ * payload buffer uses the endpoint's Tx memory region. Memory in an application memory region that was registered
+ * with the adapter uses a libfabric memory region that is registered with the endpoint's domain the first time it is
+ * needed and cached after that. Anything else, such as packet headers, uses the Tx memory region as before.
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ * @param iov_ptr Pointer to vector structure describing the memory.
+ *
+ * @return Memory descriptor to use.
+ */
+static void* GetTxMemoryDesc(EfaEndpointState* endpoint_state_ptr, const struct iovec* iov_ptr)
+{
+    EfaTxState* tx_state_ptr = &endpoint_state_ptr->tx_state;
+    CdiAdapterState* adapter_state_ptr =
+        endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->adapter_state_ptr;
+    const uint8_t* start_ptr = (const uint8_t*)iov_ptr->iov_base;
+    const uint8_t* end_ptr = start_ptr + iov_ptr->iov_len;
+    const uint8_t* tx_buffer_ptr = (const uint8_t*)adapter_state_ptr->adapter_data.ret_tx_buffer_ptr;
+
+    if (start_ptr >= tx_buffer_ptr && end_ptr <= tx_buffer_ptr + adapter_state_ptr->adapter_data.tx_buffer_size_bytes) {
+        return fi_mr_desc(tx_state_ptr->memory_region_ptr);
+    }
+
+    // Don't take the lock when no application memory regions are registered.
+    if (0 == CdiOsAtomicLoad32(&adapter_state_ptr->memory_region_count)) {
+        return fi_mr_desc(tx_state_ptr->memory_region_ptr);
+    }
+
+    // The lock keeps the cache entries from being released by CdiAdapterMemoryUnregister() while they are used here.
+    // It is never held while waiting for this thread, so taking it here cannot deadlock.
+    void* desc_ptr = NULL;
+    CdiOsCritSectionReserve(adapter_state_ptr->memory_region_lock);
+
+    for (int i = 0; NULL == desc_ptr && i < tx_state_ptr->mr_cache_count; i++) {
+        const EfaTxMemoryRegionCacheEntry* entry_ptr = &tx_state_ptr->mr_cache_array[i];
+        const uint8_t* region_start_ptr = (const uint8_t*)entry_ptr->region.address_ptr;
+        if (start_ptr >= region_start_ptr && end_ptr <= region_start_ptr + entry_ptr->region.size_in_bytes) {
+            desc_ptr = fi_mr_desc(entry_ptr->memory_region_ptr);
+        }
+    }
+
+    // If every region registered with the adapter is already in the cache, don't bother searching the adapter's list.
+    AdapterMemoryRegion region;
+    if (NULL == desc_ptr && tx_state_ptr->mr_cache_count != adapter_state_ptr->memory_region_count &&
+            tx_state_ptr->mr_cache_count < CDI_MAX_ADAPTER_MEMORY_REGIONS &&
+            CdiAdapterMemoryRegionFind(adapter_state_ptr, iov_ptr->iov_base, iov_ptr->iov_len, &region)) {
+        EfaTxMemoryRegionCacheEntry* entry_ptr = &tx_state_ptr->mr_cache_array[tx_state_ptr->mr_cache_count];
+        uint64_t access = FI_SEND | (endpoint_state_ptr->rma_supported ? FI_WRITE : 0);
+        int ret = fi_mr_reg(endpoint_state_ptr->domain_ptr, region.address_ptr, region.size_in_bytes, access, 0, 0, 0,
+                            &entry_ptr->memory_region_ptr, NULL);
+        if (0 == ret && entry_ptr->memory_region_ptr) {
+            entry_ptr->region = region;
+            tx_state_ptr->mr_cache_count++;
+            desc_ptr = fi_mr_desc(entry_ptr->memory_region_ptr);
+        } else {
+            CDI_LOG_THREAD(kLogError, "Got [%d (%s)] from fi_mr_reg() of memory region[%p].", ret, fi_strerror(-ret),
+                           region.address_ptr);
+        }
+    }
+
+    CdiOsCritSectionRelease(adapter_state_ptr->memory_region_lock);
+
+    return desc_ptr ? desc_ptr : fi_mr_desc(tx_state_ptr->memory_region_ptr);
+}
+
+/**
+ * Get the FI_MORE flag to use for the next Tx operation posted to libfabric.
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ * @param flush_packets True to flush any cached Tx packets, otherwise cache them as libfabric allows.
+ *
+ * @return FI_MORE or zero.
+ */
+static uint64_t GetTxMoreFlag(EfaEndpointState* endpoint_state_ptr, bool flush_packets)
+{
+    // If we have reached our limit of caching sending the Tx packet or we don't have more to immediately send, then
+    // don't use the FI_MORE flag so libfabric will update the NIC hardware registers with all the cached requests in an
+    // optimized operation.
+    uint64_t flags = FI_MORE;
+    if (++endpoint_state_ptr->tx_state.tx_packets_sent_since_flush >= EFA_TX_PACKET_CACHE_SIZE || flush_packets) {
+        flags = 0; // Clear the FI_MORE flag.
+        endpoint_state_ptr->tx_state.tx_packets_sent_since_flush = 0; // Reset counter.
+    }
+    return flags;
+}
+
 /**
  * This function sends the packet using the libfabric fi_sendmsg function.
  *
@@ -45,28 +160,24 @@
  * @param iov_count     A count value to identify which msg_iov_ptr.
  * @param context_ptr   A pointer to a data structure holding packet context information.
  * @param flush_packets True to flush any cached Tx packets, otherwise cache them as libfabric allows.
+ * @param cq_data_ptr   Pointer to the remote CQ data to send with the packet. NULL if none.
  *
  * @return True if successful, otherwise false is returned.
  */
 static bool PostTxData(EfaEndpointState* endpoint_state_ptr, const struct iovec *msg_iov_ptr,
-                       int iov_count, const void* context_ptr, bool flush_packets)
+                       int iov_count, const void* context_ptr, bool flush_packets, const uint64_t* cq_data_ptr)
 {
     struct fid_ep *endpoint_ptr = endpoint_state_ptr->endpoint_ptr;
 
-    // If we have reached our limit of caching sending the Tx packet or we don't have more to immediately send, then
-    // don't use the FI_MORE flag so libfabric will update the NIC hardware registers with all the cached requests in an
-    // optimized operation.
-    uint64_t flags = FI_MORE;
-    if (++endpoint_state_ptr->tx_state.tx_packets_sent_since_flush >= EFA_TX_PACKET_CACHE_SIZE || flush_packets) {
-        flags = 0; // Clear the FI_MORE flag.
-        endpoint_state_ptr->tx_state.tx_packets_sent_since_flush = 0; // Reset counter.
+    uint64_t flags = GetTxMoreFlag(endpoint_state_ptr, flush_packets);
+    if (cq_data_ptr) {
+        flags |= FI_REMOTE_CQ_DATA;
     }
 
     assert(NULL != endpoint_state_ptr->tx_state.memory_region_ptr);
     void* descs[MAX_TX_SGL_PACKET_ENTRIES];
-    void *desc = fi_mr_desc(endpoint_state_ptr->tx_state.memory_region_ptr);
     for (int i = 0; i < iov_count; ++i) {
-        descs[i] = desc;
+        descs[i] = GetTxMemoryDesc(endpoint_state_ptr, &msg_iov_ptr[i]);
     }
     struct fi_msg msg = {
         .msg_iov = msg_iov_ptr,
@@ -74,7 +185,7 @@ static bool PostTxData(EfaEndpointState* endpoint_state_ptr, const struct iovec
         .iov_count = iov_count,
         .addr = 0,
         .context = (void*)context_ptr,  // cast needed to override constness
-        .data = 0
+        .data = cq_data_ptr ? *cq_data_ptr : 0
     };
 
     const int max_num_tries = 5;
@@ -94,6 +205,340 @@ static bool PostTxData(EfaEndpointState* endpoint_state_ptr, const struct iovec
     return 0 == fi_ret;
 }
 
+/**
+ * Send a small packet using the libfabric fi_inject function if it fits into the provider's inject size. libfabric
+ * copies the packet before the call returns and does not generate a completion for it, so the packet is completed by
+ * the next Poll() together with the others that were injected since. See InjectedPacketsComplete().
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ * @param packet_ptr Pointer to the packet. If it is injected, it is linked into the endpoint's list of injected packets.
+ * @param msg_iov_array Array of vector structures describing the packet.
+ * @param iov_count Number of elements in msg_iov_array.
+ * @param ret_is_handled_ptr Address where to write true if the packet was injected. If false is written, the packet
+ *                           must be sent as usual.
+ *
+ * @return False if an error occurred, otherwise true is returned.
+ */
+static bool InjectSend(EfaEndpointState* endpoint_state_ptr, Packet* packet_ptr,
+                       const struct iovec* msg_iov_array, int iov_count, bool* ret_is_handled_ptr)
+{
+    EfaTxState* tx_state_ptr = &endpoint_state_ptr->tx_state;
+    *ret_is_handled_ptr = false;
+
+    if (EFA_TX_INJECT_BATCH_SIZE == CdiSinglyLinkedListSize(&tx_state_ptr->injected_packet_list)) {
+        return true;
+    }
+    const size_t inject_size = CDI_MIN(endpoint_state_ptr->fabric_info_ptr->tx_attr->inject_size,
+                                       (size_t)EFA_TX_INJECT_MAX_BYTES);
+    size_t byte_count = 0;
+    for (int i = 0; i < iov_count; i++) {
+        byte_count += msg_iov_array[i].iov_len;
+    }
+    if (byte_count > inject_size) {
+        return true;
+    }
+
+    // fi_inject() takes a single buffer, so gather the packet's SGL entries.
+    uint8_t buffer[EFA_TX_INJECT_MAX_BYTES];
+    byte_count = 0;
+    for (int i = 0; i < iov_count; i++) {
+        memcpy(buffer + byte_count, msg_iov_array[i].iov_base, msg_iov_array[i].iov_len);
+        byte_count += msg_iov_array[i].iov_len;
+    }
+
+    const int max_num_tries = 5;
+    int num_tries = 0;
+    ssize_t fi_ret = 0;
+    do {
+        fi_ret = fi_inject(endpoint_state_ptr->endpoint_ptr, buffer, byte_count, 0);
+        if (0 == fi_ret || -FI_EAGAIN != fi_ret) {
+            break;
+        }
+    } while (++num_tries != max_num_tries);
+
+    if (-FI_EAGAIN == fi_ret) {
+        // No inject resources are available right now, so send the packet as usual.
+        return true;
+    }
+    if (0 != fi_ret) {
+        CDI_LOG_THREAD(kLogError, "Got [%ld (%s)] from fi_inject(), tried [%d] times.",
+            fi_ret, fi_strerror(-fi_ret), num_tries);
+        return false;
+    }
+
+    // fi_inject() is never deferred like operations posted with FI_MORE, so it also flushes any cached Tx packets.
+    tx_state_ptr->tx_packets_sent_since_flush = 0;
+    CdiSinglyLinkedListPushTail(&tx_state_ptr->injected_packet_list, &packet_ptr->list_entry);
+    tx_state_ptr->tx_packets_in_process++;
+    *ret_is_handled_ptr = true;
+
+    return true;
+}
+
+/**
+ * Complete the packets that were sent with fi_inject() since the last poll. See InjectSend(). They are passed to the
+ * endpoint's message function for several packets in one call, if it has one.
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ *
+ * @return Number of packets completed.
+ */
+static int InjectedPacketsComplete(EfaEndpointState* endpoint_state_ptr)
+{
+    EfaTxState* tx_state_ptr = &endpoint_state_ptr->tx_state;
+    AdapterEndpointState* adapter_endpoint_ptr = endpoint_state_ptr->adapter_endpoint_ptr;
+    const int count = CdiSinglyLinkedListSize(&tx_state_ptr->injected_packet_list);
+    if (0 == count) {
+        return 0;
+    }
+
+    // Take the packets off the endpoint first, since the message functions may reuse their list entries.
+    CdiSinglyLinkedList packet_list = tx_state_ptr->injected_packet_list;
+    CdiSinglyLinkedListInit(&tx_state_ptr->injected_packet_list);
+    tx_state_ptr->tx_packets_in_process -= count;
+
+    // libfabric reports errors of injected packets through later operations, so the packets themselves succeeded. See
+    // kAdapterPacketStatusOk.
+    for (CdiSinglyLinkedListEntry* entry_ptr = CdiSinglyLinkedListGetHead(&packet_list); NULL != entry_ptr;
+            entry_ptr = CdiSinglyLinkedListNextEntry(entry_ptr)) {
+        Packet* packet_ptr = CONTAINER_OF(entry_ptr, Packet, list_entry);
+        packet_ptr->tx_state.ack_status = kAdapterPacketStatusOk;
+    }
+
+    if (adapter_endpoint_ptr->msgs_from_endpoint_func_ptr) {
+        (adapter_endpoint_ptr->msgs_from_endpoint_func_ptr)(adapter_endpoint_ptr->msg_from_endpoint_param_ptr,
+                                                            &packet_list, kEndpointMessageTypePacketSent);
+    } else {
+        CdiSinglyLinkedListEntry* entry_ptr = NULL;
+        while (NULL != (entry_ptr = CdiSinglyLinkedListPopHead(&packet_list))) {
+            (adapter_endpoint_ptr->msg_from_endpoint_func_ptr)(adapter_endpoint_ptr->msg_from_endpoint_param_ptr,
+                                                               CONTAINER_OF(entry_ptr, Packet, list_entry),
+                                                               kEndpointMessageTypePacketSent);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * This function writes the data of a packet directly into a receive buffer slot using the libfabric fi_writemsg
+ * function. The write completes once the data has been placed at the receiver, so the header of packet #0 that tells
+ * the receiver about the payload can't overtake it.
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ * @param msg_iov_ptr   Pointer to vector structure containing the data to be written.
+ * @param iov_count     Number of elements in msg_iov_ptr.
+ * @param remote_address Remote address to write the data to.
+ * @param key           Remote memory region key.
+ * @param context_ptr   A pointer to a data structure holding packet context information.
+ * @param flush_packets True to flush any cached Tx packets, otherwise cache them as libfabric allows.
+ *
+ * @return True if successful, otherwise false is returned.
+ */
+static bool PostTxWrite(EfaEndpointState* endpoint_state_ptr, const struct iovec *msg_iov_ptr, int iov_count,
+                        uint64_t remote_address, uint64_t key, const void* context_ptr, bool flush_packets)
+{
+    const uint64_t flags = FI_DELIVERY_COMPLETE | GetTxMoreFlag(endpoint_state_ptr, flush_packets);
+
+    void* descs[MAX_TX_SGL_PACKET_ENTRIES];
+    size_t byte_count = 0;
+    for (int i = 0; i < iov_count; ++i) {
+        descs[i] = GetTxMemoryDesc(endpoint_state_ptr, &msg_iov_ptr[i]);
+        byte_count += msg_iov_ptr[i].iov_len;
+    }
+    struct fi_rma_iov rma_iov = {
+        .addr = remote_address,
+        .len = byte_count,
+        .key = key
+    };
+    struct fi_msg_rma msg = {
+        .msg_iov = msg_iov_ptr,
+        .desc = descs,
+        .iov_count = iov_count,
+        .addr = 0,
+        .rma_iov = &rma_iov,
+        .rma_iov_count = 1,
+        .context = (void*)context_ptr,  // cast needed to override constness
+        .data = 0
+    };
+
+    const int max_num_tries = 5;
+    int num_tries = 0;
+    ssize_t fi_ret = 0;
+    do {
+        fi_ret = fi_writemsg(endpoint_state_ptr->endpoint_ptr, &msg, flags);
+        if (0 == fi_ret || -FI_EAGAIN != fi_ret) {
+            break;
+        }
+    } while (++num_tries != max_num_tries);
+
+    if (0 != fi_ret) {
+        CDI_LOG_THREAD(kLogError, "Got [%ld (%s)] from fi_writemsg(), tried [%d] times.",
+            fi_ret, fi_strerror(-fi_ret), num_tries);
+    }
+    return 0 == fi_ret;
+}
+
+/**
+ * Find a free receive buffer slot that can hold a payload and mark it as used.
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ * @param payload_size Size of the payload in bytes.
+ *
+ * @return Index of the slot. -1 if no slot is free or the payload doesn't fit.
+ */
+static int RmaSlotAcquire(EfaEndpointState* endpoint_state_ptr, int payload_size)
+{
+    EfaTxRmaState* rma_ptr = &endpoint_state_ptr->tx_state.rma_state;
+    int slot_index = -1;
+
+    CdiOsCritSectionReserve(rma_ptr->lock);
+    if (rma_ptr->slots_valid && payload_size >= 0 && (uint32_t)payload_size <= rma_ptr->slot_size) {
+        for (int i = 0; i < rma_ptr->slot_count && -1 == slot_index; i++) {
+            if (rma_ptr->use_count_array[i] == rma_ptr->release_count_array[i]) {
+                rma_ptr->use_count_array[i]++;
+                slot_index = i;
+                // Save the slot's location, since the advertised data may change once the lock is released.
+                EfaTxRmaPayload* payload_ptr = &rma_ptr->payload_array[i];
+                payload_ptr->remote_address = rma_ptr->base_address + (uint64_t)i * rma_ptr->slot_size;
+                payload_ptr->key = rma_ptr->key;
+            }
+        }
+    }
+    CdiOsCritSectionRelease(rma_ptr->lock);
+
+    return slot_index;
+}
+
+/**
+ * Send the header of packet #0 of a payload written into a receive buffer slot once all of the payload's data has been
+ * written. The slot number is sent as remote CQ data.
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ * @param slot_index Slot the payload was written into.
+ *
+ * @return True if successful, otherwise false is returned.
+ */
+static bool RmaPayloadFinish(EfaEndpointState* endpoint_state_ptr, int slot_index)
+{
+    EfaTxRmaPayload* payload_ptr = &endpoint_state_ptr->tx_state.rma_state.payload_array[slot_index];
+    if (!payload_ptr->active || !payload_ptr->last_packet_written || 0 != payload_ptr->writes_in_flight) {
+        return true;
+    }
+    payload_ptr->active = false;
+
+    const CdiSglEntry* header_entry_ptr = payload_ptr->packet0_ptr->sg_list.sgl_head_ptr;
+    struct iovec msg_iov = {
+        .iov_base = header_entry_ptr->address_ptr,
+        .iov_len = header_entry_ptr->size_in_bytes
+    };
+    const uint64_t cq_data = (uint64_t)slot_index;
+    // NOTE: Packet #0 was already counted in tx_packets_in_process when its slot was acquired.
+    return PostTxData(endpoint_state_ptr, &msg_iov, 1, payload_ptr->packet0_ptr, true, &cq_data);
+}
+
+/**
+ * If the receiver has advertised receive buffer slots, write the data of the packet directly into the slot of its
+ * payload instead of sending it. The header of packet #0 is held back until all of the payload's data has been written.
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ * @param packet_ptr Pointer to the packet.
+ * @param msg_iov_array Array of vector structures describing the packet's SGL entries.
+ * @param iov_count Number of elements in msg_iov_array.
+ * @param flush_packets True to flush any cached Tx packets, otherwise cache them as libfabric allows.
+ * @param ret_handled_ptr Address where to write true if the packet was handled here, or false if it must be sent.
+ *
+ * @return True if successful, otherwise false is returned.
+ */
+static bool RmaSend(EfaEndpointState* endpoint_state_ptr, const Packet* packet_ptr, const struct iovec* msg_iov_array,
+                    int iov_count, bool flush_packets, bool* ret_handled_ptr)
+{
+    AdapterEndpointState* adapter_endpoint_ptr = endpoint_state_ptr->adapter_endpoint_ptr;
+    EfaTxRmaState* rma_ptr = &endpoint_state_ptr->tx_state.rma_state;
+    *ret_handled_ptr = false;
+
+    CdiProtocolHandle protocol_handle = adapter_endpoint_ptr->protocol_handle;
+    const int msg_prefix_size = adapter_endpoint_ptr->adapter_con_state_ptr->adapter_state_ptr->msg_prefix_size;
+    if (NULL == protocol_handle || (int)msg_iov_array[0].iov_len < msg_prefix_size) {
+        return true;
+    }
+    CdiDecodedPacketHeader header = { 0 };
+    ProtocolPayloadHeaderDecode(protocol_handle, (uint8_t*)msg_iov_array[0].iov_base + msg_prefix_size,
+                                (int)msg_iov_array[0].iov_len - msg_prefix_size, &header);
+    // The data of a packet is written separately from its header, so the first SGL entry must only hold the header.
+    const bool header_only_entry = (int)msg_iov_array[0].iov_len == msg_prefix_size + header.encoded_header_size;
+
+    // Packets of several payloads may be interleaved, so the slot is looked up from the payload of each packet.
+    const int slot_index = EfaTxRmaSlotGet(endpoint_state_ptr, packet_ptr, &header, header_only_entry);
+    if (-1 == slot_index) {
+        return true; // The payload is sent in packets.
+    }
+    uint64_t payload_data_offset = 0;
+    if (kPayloadTypeDataOffset == header.payload_type) {
+        if (!header_only_entry || 1 == iov_count) {
+            CDI_LOG_THREAD(kLogError, "Packet[%d] of payload[%d] written into a receive buffer slot has no separate "
+                           "data.", header.packet_sequence_num, header.payload_num);
+            return false;
+        }
+        payload_data_offset = header.data_offset_info.payload_data_offset;
+    }
+    *ret_handled_ptr = true;
+
+    bool ret = true;
+    EfaTxRmaPayload* payload_ptr = &rma_ptr->payload_array[slot_index];
+    if (iov_count > 1) {
+        const void* context_ptr = (packet_ptr == payload_ptr->packet0_ptr) ?
+                                  (const void*)&payload_ptr->packet0_write_context : (const void*)packet_ptr;
+        ret = PostTxWrite(endpoint_state_ptr, &msg_iov_array[1], iov_count - 1,
+                          payload_ptr->remote_address + payload_data_offset, payload_ptr->key, context_ptr,
+                          flush_packets);
+        if (ret) {
+            payload_ptr->writes_in_flight++;
+            endpoint_state_ptr->tx_state.tx_packets_in_process++;
+        }
+    }
+    if (ret && packet_ptr->payload_last_packet) {
+        payload_ptr->last_packet_written = true;
+        ret = RmaPayloadFinish(endpoint_state_ptr, slot_index);
+    }
+
+    return ret;
+}
+
+/**
+ * Find the receive buffer slot that a completed RMA write was for.
+ *
+ * @param endpoint_state_ptr Pointer to EFA endpoint state structure.
+ * @param context_ptr Context of the write.
+ *
+ * @return Index of the slot. -1 if not found.
+ */
+static int RmaWriteSlotFind(EfaEndpointState* endpoint_state_ptr, const void* context_ptr)
+{
+    EfaTxRmaState* rma_ptr = &endpoint_state_ptr->tx_state.rma_state;
+    for (int i = 0; i < CDI_MAX_RMA_SLOTS; i++) {
+        if (context_ptr == &rma_ptr->payload_array[i].packet0_write_context) {
+            return i;
+        }
+    }
+
+    // The context of any other write is its packet, whose header identifies the payload.
+    const Packet* packet_ptr = (const Packet*)context_ptr;
+    const int msg_prefix_size =
+        endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->adapter_state_ptr->msg_prefix_size;
+    CdiDecodedPacketHeader header = { 0 };
+    ProtocolPayloadHeaderDecode(endpoint_state_ptr->adapter_endpoint_ptr->protocol_handle,
+                                (uint8_t*)packet_ptr->sg_list.sgl_head_ptr->address_ptr + msg_prefix_size,
+                                packet_ptr->sg_list.sgl_head_ptr->size_in_bytes - msg_prefix_size, &header);
+    for (int i = 0; i < CDI_MAX_RMA_SLOTS; i++) {
+        if (rma_ptr->payload_array[i].active && header.payload_num == rma_ptr->payload_array[i].payload_num) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
 /**
  * Poll libfabric for completion queue events.
  *
@@ -169,20 +614,38 @@ static bool Poll(EfaEndpointState* efa_endpoint_ptr)
     bool ret = false;
     AdapterEndpointState* adapter_endpoint_ptr = efa_endpoint_ptr->adapter_endpoint_ptr;
 
+    // Injected packets have no completion queue entries.
+    const int injected_count = InjectedPacketsComplete(efa_endpoint_ptr);
+
     struct fi_cq_data_entry comp_array[MAX_TX_BULK_COMPLETION_QUEUE_MESSAGES];
     int packet_ack_count = CDI_ARRAY_ELEMENT_COUNT(comp_array);
     bool status = GetCompletions(efa_endpoint_ptr->completion_queue_ptr, comp_array, &packet_ack_count);
 
     // Capture whether any useful work was done this time.
-    ret = packet_ack_count > 0;
+    ret = packet_ack_count > 0 || injected_count > 0;
 
     // Account for the packets acknowleged.
     efa_endpoint_ptr->tx_state.tx_packets_in_process -= packet_ack_count;
 
     // Process any completions that were received.
+    uint32_t finished_slot_mask = 0;
     for (int i = 0; i < packet_ack_count; i++) {
         Packet* packet_ptr = comp_array[i].op_context;
         assert(packet_ptr);
+
+        if (FI_WRITE & comp_array[i].flags) {
+            // Data written into a receive buffer slot. Once all of a payload's writes are done, its packet #0 header
+            // can be sent.
+            const int slot_index = RmaWriteSlotFind(efa_endpoint_ptr, packet_ptr);
+            if (-1 != slot_index) {
+                EfaTxRmaPayload* payload_ptr = &efa_endpoint_ptr->tx_state.rma_state.payload_array[slot_index];
+                payload_ptr->writes_in_flight--;
+                finished_slot_mask |= 1 << slot_index;
+                if ((void*)packet_ptr == &payload_ptr->packet0_write_context) {
+                    continue; // Not a packet. Packet #0 completes when its header has been sent.
+                }
+            }
+        }
         packet_ptr->tx_state.ack_status = status ? kAdapterPacketStatusOk : kAdapterPacketStatusFailed;
 
         // Send the completion message for the packet.
@@ -201,6 +664,12 @@ static bool Poll(EfaEndpointState* efa_endpoint_ptr)
 #endif
     }
 
+    for (int i = 0; status && 0 != finished_slot_mask; i++, finished_slot_mask >>= 1) {
+        if ((finished_slot_mask & 1) && !RmaPayloadFinish(efa_endpoint_ptr, i)) {
+            status = false;
+        }
+    }
+
     if (!status && kCdiConnectionStatusConnected == adapter_endpoint_ptr->connection_status_code) {
         // Must assume the connection to the receiver has gone down and must reset it. Notify the probe component so
         // it can start the connection reset process.
@@ -218,6 +687,10 @@ CdiReturnStatus EfaTxEndpointOpen(EfaEndpointState* endpoint_state_ptr, const ch
     (void)remote_address_str;
     (void)dest_port;
 
+    if (!CdiOsCritSectionCreate(&endpoint_state_ptr->tx_state.rma_state.lock)) {
+        return kCdiStatusNotEnoughMemory;
+    }
+
     // Setup additional Tx specific resources.
     return EfaAdapterProbeEndpointCreate(endpoint_state_ptr, &endpoint_state_ptr->probe_endpoint_handle);
 }
@@ -233,6 +706,16 @@ CdiReturnStatus EfaTxEndpointReset(EfaEndpointState* endpoint_state_ptr)
 
     endpoint_state_ptr->tx_state.tx_packets_in_process = 0;
     endpoint_state_ptr->tx_state.tx_packets_sent_since_flush = 0;
+    CdiSinglyLinkedListInit(&endpoint_state_ptr->tx_state.injected_packet_list);
+
+    // Wait for the receiver to advertise its receive buffer slots again once reconnected.
+    EfaTxRmaState* rma_ptr = &endpoint_state_ptr->tx_state.rma_state;
+    CdiOsCritSectionReserve(rma_ptr->lock);
+    rma_ptr->slots_valid = false;
+    CdiOsCritSectionRelease(rma_ptr->lock);
+    for (int i = 0; i < CDI_MAX_RMA_SLOTS; i++) {
+        rma_ptr->payload_array[i].active = false;
+    }
 
     return kCdiStatusOk;
 }
@@ -245,6 +728,11 @@ CdiReturnStatus EfaTxEndpointClose(EfaEndpointState* endpoint_state_ptr)
     ProbeEndpointDestroy(endpoint_state_ptr->probe_endpoint_handle);
     endpoint_state_ptr->probe_endpoint_handle = NULL;
 
+    if (endpoint_state_ptr->tx_state.rma_state.lock) {
+        CdiOsCritSectionDelete(endpoint_state_ptr->tx_state.rma_state.lock);
+        endpoint_state_ptr->tx_state.rma_state.lock = NULL;
+    }
+
     return kCdiStatusOk;
 }
 
@@ -260,7 +748,7 @@ EndpointTransmitQueueLevel EfaGetTransmitQueueLevel(const AdapterEndpointHandle
     }
 }
 
-CdiReturnStatus EfaTxEndpointSend(const AdapterEndpointHandle handle, const Packet* packet_ptr, bool flush_packets)
+CdiReturnStatus EfaTxEndpointSend(const AdapterEndpointHandle handle, Packet* packet_ptr, bool flush_packets)
 {
     CdiReturnStatus rs = kCdiStatusOk;
     EfaEndpointState* endpoint_state_ptr = (EfaEndpointState*)handle->type_specific_ptr;
@@ -284,7 +772,18 @@ CdiReturnStatus EfaTxEndpointSend(const AdapterEndpointHandle handle, const Pack
                    decoded_header.packet_sequence_num);
 #endif
 
-    if (!PostTxData(endpoint_state_ptr, msg_iov_array, iov_count, packet_ptr, flush_packets)) {
+    // Probe packets are always sent. See ProbeControlEfaConnectionStart().
+    bool is_handled = false;
+    if (endpoint_state_ptr->rma_supported && ProbeTxEfaMessageFromEndpoint != handle->msg_from_endpoint_func_ptr &&
+        !RmaSend(endpoint_state_ptr, packet_ptr, msg_iov_array, iov_count, flush_packets, &is_handled)) {
+        rs = kCdiStatusSendFailed;
+    } else if (is_handled) {
+        // The packet's data was written into a receive buffer slot. In process counts were updated by RmaSend().
+    } else if (!InjectSend(endpoint_state_ptr, packet_ptr, msg_iov_array, iov_count, &is_handled)) {
+        rs = kCdiStatusSendFailed;
+    } else if (is_handled) {
+        // The packet was injected. In process counts were updated by InjectSend().
+    } else if (!PostTxData(endpoint_state_ptr, msg_iov_array, iov_count, packet_ptr, flush_packets, NULL)) {
         rs = kCdiStatusSendFailed;
     } else {
         // Increment the Tx packets in progress count.
@@ -338,3 +837,98 @@ void EfaTxEndpointStop(EfaEndpointState* endpoint_state_ptr)
         endpoint_state_ptr->remote_fi_addr = FI_ADDR_UNSPEC;
     }
 }
+
+void EfaTxMemoryRegionCacheInit(EfaEndpointState* endpoint_state_ptr)
+{
+    CdiAdapterState* adapter_state_ptr =
+        endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->adapter_state_ptr;
+    endpoint_state_ptr->tx_state.mr_user.release_ptr = MemoryRegionCacheRelease;
+    CdiAdapterMemoryRegionUserAdd(adapter_state_ptr, &endpoint_state_ptr->tx_state.mr_user);
+}
+
+void EfaTxMemoryRegionCacheFlush(EfaEndpointState* endpoint_state_ptr)
+{
+    CdiAdapterState* adapter_state_ptr =
+        endpoint_state_ptr->adapter_endpoint_ptr->adapter_con_state_ptr->adapter_state_ptr;
+    EfaTxState* tx_state_ptr = &endpoint_state_ptr->tx_state;
+
+    // Once removed, CdiAdapterMemoryUnregister() no longer uses the cache, so it can be flushed without the lock.
+    CdiAdapterMemoryRegionUserRemove(adapter_state_ptr, &tx_state_ptr->mr_user);
+    for (int i = 0; i < tx_state_ptr->mr_cache_count; i++) {
+        int ret = fi_close(&tx_state_ptr->mr_cache_array[i].memory_region_ptr->fid);
+        if (0 != ret) {
+            CDI_LOG_THREAD(kLogError, "Got [%d (%s)] from fi_close() of memory region[%p].", ret, fi_strerror(-ret),
+                           tx_state_ptr->mr_cache_array[i].region.address_ptr);
+        }
+    }
+    tx_state_ptr->mr_cache_count = 0;
+}
+
+void EfaTxRmaSlotsUpdate(EfaEndpointState* endpoint_state_ptr, const CdiDecodedProbeRmaSlots* rma_slots_ptr)
+{
+    EfaTxRmaState* rma_ptr = &endpoint_state_ptr->tx_state.rma_state;
+    if (!endpoint_state_ptr->rma_supported || NULL == rma_ptr->lock) {
+        return;
+    }
+    const int slot_count = CDI_MIN((int)rma_slots_ptr->slot_count, CDI_MAX_RMA_SLOTS);
+
+    CdiOsCritSectionReserve(rma_ptr->lock);
+    if (!rma_ptr->slots_valid || rma_ptr->base_address != rma_slots_ptr->base_address ||
+        rma_ptr->key != rma_slots_ptr->key || rma_ptr->slot_size != rma_slots_ptr->slot_size ||
+        rma_ptr->slot_count != slot_count) {
+        // First advertisement since the endpoint was reset. Slots that still hold a payload are in use until the
+        // receiver releases them.
+        rma_ptr->base_address = rma_slots_ptr->base_address;
+        rma_ptr->key = rma_slots_ptr->key;
+        rma_ptr->slot_size = rma_slots_ptr->slot_size;
+        rma_ptr->slot_count = slot_count;
+        for (int i = 0; i < slot_count; i++) {
+            rma_ptr->release_count_array[i] = rma_slots_ptr->release_count_array[i];
+            rma_ptr->use_count_array[i] = rma_slots_ptr->release_count_array[i] + ((rma_slots_ptr->held_mask >> i) & 1);
+        }
+        rma_ptr->slots_valid = true;
+        CDI_LOG_THREAD(kLogInfo, "Using [%d] receive buffer slots of [%u] bytes for RMA direct placement.", slot_count,
+                       rma_slots_ptr->slot_size);
+    } else {
+        // Advertisements may arrive out of order, so only move release counts forward.
+        for (int i = 0; i < slot_count; i++) {
+            if ((int8_t)(rma_slots_ptr->release_count_array[i] - rma_ptr->release_count_array[i]) > 0) {
+                rma_ptr->release_count_array[i] = rma_slots_ptr->release_count_array[i];
+            }
+        }
+    }
+    CdiOsCritSectionRelease(rma_ptr->lock);
+}
+
+int EfaTxRmaSlotGet(EfaEndpointState* endpoint_ptr, const Packet* packet_ptr, const CdiDecodedPacketHeader* header_ptr,
+                    bool header_only_entry)
+{
+    EfaTxRmaState* rma_ptr = &endpoint_ptr->tx_state.rma_state;
+
+    if (kPayloadTypeDataOffset == header_ptr->payload_type) {
+        for (int i = 0; i < CDI_MAX_RMA_SLOTS; i++) {
+            const EfaTxRmaPayload* payload_ptr = &rma_ptr->payload_array[i];
+            if (payload_ptr->active && !payload_ptr->last_packet_written &&
+                header_ptr->payload_num == payload_ptr->payload_num) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    if (!header_only_entry || kPayloadTypeData != header_ptr->payload_type || 0 != header_ptr->packet_sequence_num) {
+        return -1;
+    }
+    const int slot_index = RmaSlotAcquire(endpoint_ptr, header_ptr->num0_info.total_payload_size);
+    if (-1 != slot_index) {
+        EfaTxRmaPayload* payload_ptr = &rma_ptr->payload_array[slot_index];
+        payload_ptr->active = true;
+        payload_ptr->payload_num = header_ptr->payload_num;
+        payload_ptr->packet0_ptr = packet_ptr;
+        payload_ptr->writes_in_flight = 0;
+        payload_ptr->last_packet_written = false;
+        // The header of packet #0 is sent later, but it is in process from now on.
+        endpoint_ptr->tx_state.tx_packets_in_process++;
+    }
+    return slot_index;
+}
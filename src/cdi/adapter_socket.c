@@ -37,7 +37,7 @@ static CdiReturnStatus SocketEndpointOpen(AdapterEndpointHandle endpoint, const
 /// Forward declaration of function.
 static CdiReturnStatus SocketEndpointClose(AdapterEndpointHandle handle);
 /// Forward declaration of function.
-static CdiReturnStatus SocketEndpointSend(const AdapterEndpointHandle handle, const Packet* packet_ptr,
+static CdiReturnStatus SocketEndpointSend(const AdapterEndpointHandle handle, Packet* packet_ptr,
                                           bool flush_packets);
 /// Forward declaration of function.
 static CdiReturnStatus SocketEndpointRxBuffersFree(const AdapterEndpointHandle handle, const CdiSgList* sgl_ptr);
@@ -76,6 +76,8 @@ typedef struct {
     CdiSignalType shutdown;  ///< This is set to cause the receive thread to exit.
     CdiThreadID receive_thread_id;  ///< The receive thread's id needed for joining.
     CdiPoolHandle receive_buffer_pool;  ///< Pool of ReceiveBufferRecords used for received packets.
+    /// @brief Earliest time that the kernel may send the next paced packet. Only used if SO_TXTIME is enabled.
+    uint64_t next_launch_time_microsecs;
 } SocketEndpointState;
 
 //*********************************************************************************************************************
@@ -291,6 +293,16 @@ static CdiReturnStatus SocketEndpointOpen(AdapterEndpointHandle endpoint_handle,
         // synchronizing between the transmitting and receiving connections is available so delaying the transmitter
         // helps give the receiver a better chance of being ready before packets start flowing to it.
         CdiOsSleep(50);
+
+        // Let the kernel pace Tx packets if it can, instead of holding them back in the poll thread.
+        SocketEndpointState* private_state_ptr = (SocketEndpointState*)endpoint_handle->type_specific_ptr;
+        endpoint_handle->tx_pacing_offloaded = CdiOsSocketTxTimeEnable(private_state_ptr->socket);
+        if (endpoint_handle->tx_pacing_offloaded && !CdiOsSocketTxTimeHonored(private_state_ptr->socket)) {
+            CDI_LOG_HANDLE(endpoint_handle->adapter_con_state_ptr->log_handle, kLogInfo,
+                           "SO_TXTIME is enabled, but the network interface doesn't use the fq queuing discipline. "
+                           "Paced packets are held back by the poll thread instead.");
+            endpoint_handle->tx_pacing_offloaded = false;
+        }
     }
 
     if (kCdiStatusOk == ret) {
@@ -382,7 +394,7 @@ static CdiReturnStatus SocketEndpointClose(AdapterEndpointHandle endpoint_handle
  * @return CdiReturnStatus kCdiStatusOk if the packet was sent or kCdiStatusSendFailed if the writing to the
  *         socket failed.
  */
-static CdiReturnStatus SocketEndpointSend(const AdapterEndpointHandle handle, const Packet* packet_ptr,
+static CdiReturnStatus SocketEndpointSend(const AdapterEndpointHandle handle, Packet* packet_ptr,
                                           bool flush_packets)
 {
     (void)flush_packets; // Not used.
@@ -407,7 +419,20 @@ static CdiReturnStatus SocketEndpointSend(const AdapterEndpointHandle handle, co
         }
     }
 
-    if (kCdiStatusOk == ret) {
+    const uint32_t bytes_per_millisec = packet_ptr->tx_state.pacing_bytes_per_millisec;
+    if (kCdiStatusOk == ret && handle->tx_pacing_offloaded && bytes_per_millisec) {
+        // Schedule the packet right after the previous paced one, or now if the endpoint has fallen behind or was idle.
+        const uint64_t launch_time = CDI_MAX(CdiOsGetMicroseconds(), state_ptr->next_launch_time_microsecs);
+        state_ptr->next_launch_time_microsecs =
+            launch_time + (uint64_t)packet_ptr->sg_list.total_data_size * 1000 / bytes_per_millisec;
+
+        int byte_count = 0;
+        const struct sockaddr_in* address_ptr = (0 == packet_ptr->socket_adapter_state.address.sin_addr.s_addr) ?
+                                                NULL : &packet_ptr->socket_adapter_state.address;
+        if (!CdiOsSocketWriteAt(state_ptr->socket, vectors, iovcnt, address_ptr, launch_time, &byte_count)) {
+            ret = kCdiStatusSendFailed;
+        }
+    } else if (kCdiStatusOk == ret) {
         int byte_count = 0;
         if (0 == packet_ptr->socket_adapter_state.address.sin_addr.s_addr) {
             if (!CdiOsSocketWrite(state_ptr->socket, vectors, iovcnt, &byte_count)) {
@@ -37,6 +37,29 @@
 //******************************************* START OF STATIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
 
+/**
+ * Set the AVM extra data that is sent along with a payload.
+ *
+ * @param payload_config_ptr Pointer to payload configuration data.
+ * @param avm_config_ptr Optional pointer to AVM configuration data.
+ * @param packet_avm_data_ptr Address where to write the AVM extra data.
+ *
+ * @return The size in bytes of the AVM extra data.
+ */
+static int SetAvmExtraData(const CdiAvmTxPayloadConfig* payload_config_ptr, const CdiAvmConfig* avm_config_ptr,
+                           CDIPacketAvmUnion* packet_avm_data_ptr)
+{
+    memset((void*)packet_avm_data_ptr, 0, sizeof(*packet_avm_data_ptr));
+
+    packet_avm_data_ptr->common_header.avm_extra_data = payload_config_ptr->avm_extra_data;
+
+    if (NULL != avm_config_ptr) {
+        packet_avm_data_ptr->with_config.config = *avm_config_ptr;
+    }
+
+    return (NULL == avm_config_ptr) ? sizeof(packet_avm_data_ptr->no_config) : sizeof(packet_avm_data_ptr->with_config);
+}
+
 //*********************************************************************************************************************
 //******************************************* START OF PUBLIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
@@ -108,17 +131,130 @@ CdiReturnStatus CdiAvmEndpointTxPayload(CdiEndpointHandle endpoint_handle,
     }
 
     CDIPacketAvmUnion packet_avm_data;
-    memset((void*)&packet_avm_data, 0, sizeof(packet_avm_data));
+    int avm_data_size = SetAvmExtraData(payload_config_ptr, avm_config_ptr, &packet_avm_data);
 
-    packet_avm_data.common_header.avm_extra_data = payload_config_ptr->avm_extra_data;
+    return TxPayloadInternal(endpoint_handle, &payload_config_ptr->core_config_data, sgl_ptr, max_latency_microsecs,
+                             avm_data_size, (uint8_t*)&packet_avm_data);
+}
 
-    if (NULL != avm_config_ptr) {
-        packet_avm_data.with_config.config = *avm_config_ptr;
+CdiReturnStatus CdiAvmEndpointTxPayloads(const CdiAvmEndpointTxPayloadEntry* entry_array, int count,
+                                         CdiReturnStatus* ret_status_array)
+{
+    if (NULL == entry_array || count <= 0) {
+        return kCdiStatusInvalidParameter;
     }
 
-    int avm_data_size =
-        (NULL == avm_config_ptr) ? sizeof(packet_avm_data.no_config) : sizeof(packet_avm_data.with_config);
+    // Validate all of the entries in a single pass. Every payload must use the same connection, since the payloads are
+    // put in that connection's payload queue using a single queue operation.
+    CdiReturnStatus rs = kCdiStatusOk;
+    CdiConnectionState* con_state_ptr = NULL;
+    for (int i = 0; i < count && kCdiStatusOk == rs; i++) {
+        const CdiAvmEndpointTxPayloadEntry* entry_ptr = &entry_array[i];
+        if (!IsValidEndpointHandle(entry_ptr->endpoint_handle)) {
+            rs = kCdiStatusInvalidHandle;
+        } else if (NULL == con_state_ptr) {
+            con_state_ptr = entry_ptr->endpoint_handle->connection_state_ptr;
+        } else if (con_state_ptr != entry_ptr->endpoint_handle->connection_state_ptr) {
+            rs = kCdiStatusInvalidHandle;
+        }
+        if (kCdiStatusOk == rs && (NULL == entry_ptr->payload_config_ptr || NULL == entry_ptr->sgl_ptr ||
+                                   entry_ptr->sgl_ptr->total_data_size <= 0)) {
+            rs = kCdiStatusInvalidParameter;
+        }
+    }
+    if (kCdiStatusOk != rs) {
+        // Nothing is sent if any entry is invalid.
+        if (ret_status_array) {
+            for (int i = 0; i < count; i++) {
+                ret_status_array[i] = rs;
+            }
+        }
+        return rs;
+    }
 
-    return TxPayloadInternal(endpoint_handle, &payload_config_ptr->core_config_data, sgl_ptr, max_latency_microsecs,
-                             avm_data_size, (uint8_t*)&packet_avm_data);
+    // Prepare and enqueue the payloads in batches of up to MAX_TX_PAYLOAD_BATCH_SIZE.
+    CdiReturnStatus first_error_rs = kCdiStatusOk;
+    for (int batch_start = 0; batch_start < count; batch_start += MAX_TX_PAYLOAD_BATCH_SIZE) {
+        int batch_end = batch_start + MAX_TX_PAYLOAD_BATCH_SIZE;
+        if (batch_end > count) {
+            batch_end = count;
+        }
+
+        TxPayloadState* payload_state_array[MAX_TX_PAYLOAD_BATCH_SIZE];
+        int entry_index_array[MAX_TX_PAYLOAD_BATCH_SIZE];
+        int prepared_count = 0;
+        for (int i = batch_start; i < batch_end; i++) {
+            const CdiAvmEndpointTxPayloadEntry* entry_ptr = &entry_array[i];
+            CDIPacketAvmUnion packet_avm_data;
+            int avm_data_size = SetAvmExtraData(entry_ptr->payload_config_ptr, entry_ptr->avm_config_ptr,
+                                                &packet_avm_data);
+            rs = TxPayloadPrepare(entry_ptr->endpoint_handle, &entry_ptr->payload_config_ptr->core_config_data,
+                                  entry_ptr->sgl_ptr, entry_ptr->max_latency_microsecs, avm_data_size,
+                                  (uint8_t*)&packet_avm_data, &payload_state_array[prepared_count]);
+            if (kCdiStatusOk == rs) {
+                entry_index_array[prepared_count++] = i;
+            } else if (kCdiStatusOk == first_error_rs) {
+                first_error_rs = rs;
+            }
+            if (ret_status_array) {
+                ret_status_array[i] = rs;
+            }
+        }
+
+        int pushed_count = TxPayloadEnqueue(con_state_ptr, payload_state_array, prepared_count);
+        if (pushed_count < prepared_count) {
+            if (kCdiStatusOk == first_error_rs) {
+                first_error_rs = kCdiStatusQueueFull;
+            }
+            if (ret_status_array) {
+                for (int i = pushed_count; i < prepared_count; i++) {
+                    ret_status_array[entry_index_array[i]] = kCdiStatusQueueFull;
+                }
+            }
+        }
+    }
+
+    return first_error_rs;
+}
+
+CdiReturnStatus CdiAvmTxPayloadOpen(CdiConnectionHandle con_handle, const CdiAvmTxPayloadConfig* payload_config_ptr,
+                                    const CdiAvmConfig* avm_config_ptr, int total_data_size, int max_latency_microsecs,
+                                    CdiTxPayloadHandle* ret_payload_handle_ptr)
+{
+    if (!IsValidTxHandle(con_handle)) {
+        return kCdiStatusInvalidHandle;
+    }
+    return CdiAvmEndpointTxPayloadOpen(con_handle->default_tx_endpoint_ptr, payload_config_ptr, avm_config_ptr,
+                                       total_data_size, max_latency_microsecs, ret_payload_handle_ptr);
+}
+
+CdiReturnStatus CdiAvmEndpointTxPayloadOpen(CdiEndpointHandle endpoint_handle,
+                                            const CdiAvmTxPayloadConfig* payload_config_ptr,
+                                            const CdiAvmConfig* avm_config_ptr, int total_data_size,
+                                            int max_latency_microsecs, CdiTxPayloadHandle* ret_payload_handle_ptr)
+{
+    if (!IsValidEndpointHandle(endpoint_handle)) {
+        return kCdiStatusInvalidHandle;
+    }
+    if (NULL == payload_config_ptr || total_data_size <= 0 || NULL == ret_payload_handle_ptr) {
+        return kCdiStatusInvalidParameter;
+    }
+
+    CDIPacketAvmUnion packet_avm_data;
+    int avm_data_size = SetAvmExtraData(payload_config_ptr, avm_config_ptr, &packet_avm_data);
+
+    return TxPayloadOpenInternal(endpoint_handle, &payload_config_ptr->core_config_data, total_data_size,
+                                 max_latency_microsecs, avm_data_size, (uint8_t*)&packet_avm_data,
+                                 ret_payload_handle_ptr);
+}
+
+CdiReturnStatus CdiAvmTxPayloadAppend(CdiTxPayloadHandle payload_handle, const CdiSgList* sgl_ptr)
+{
+    if (!IsValidEndpointHandle(payload_handle.endpoint_handle) || NULL == payload_handle.payload_state_ptr) {
+        return kCdiStatusInvalidHandle;
+    }
+    if (NULL == sgl_ptr) {
+        return kCdiStatusInvalidParameter;
+    }
+    return TxPayloadAppendInternal(payload_handle, sgl_ptr);
 }
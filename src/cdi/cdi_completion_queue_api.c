@@ -0,0 +1,248 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains the definitions of the functions that comprise the CDI completion queue API. Events are stored in
+ * a fixed size, multiple writer queue. A notification file descriptor is set whenever an event is pushed and cleared
+ * when the application polls the queue. Writers that must not lose their event wait for the application to poll the
+ * queue when it is full.
+ */
+
+// Include headers in the following order: Related header, C system headers, other libraries' headers, your project's
+// headers.
+
+#include "cdi_completion_queue_api.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "completion_queue.h"
+#include "cdi_os_api.h"
+#include "cdi_queue_api.h"
+#include "internal_log.h"
+
+//*********************************************************************************************************************
+//***************************************** START OF DEFINITIONS AND TYPES ********************************************
+//*********************************************************************************************************************
+
+/// @brief Forward reference of structure to create pointers later.
+typedef struct CdiCompletionQueueState CdiCompletionQueueState;
+
+/**
+ * @brief State data for a completion queue.
+ */
+struct CdiCompletionQueueState {
+    CdiQueueHandle event_queue_handle; ///< Queue of CdiCompletionEvent structures.
+    int notification_fd;               ///< File descriptor that is readable while the queue is not empty.
+};
+
+//*********************************************************************************************************************
+//*********************************************** START OF VARIABLES **************************************************
+//*********************************************************************************************************************
+
+//*********************************************************************************************************************
+//******************************************* START OF STATIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+/**
+ * Return a pointer to the core callback data of an event.
+ *
+ * @param event_ptr Pointer to event.
+ *
+ * @return Pointer to core callback data.
+ */
+static CdiCoreCbData* EventCoreCbData(CdiCompletionEvent* event_ptr)
+{
+    CdiCoreCbData* core_cb_data_ptr = NULL;
+    switch (event_ptr->event_type) {
+        case kCdiCompletionEventRawRx:
+            core_cb_data_ptr = &event_ptr->cb_data.raw_rx.core_cb_data;
+            break;
+        case kCdiCompletionEventAvmRx:
+            core_cb_data_ptr = &event_ptr->cb_data.avm_rx.core_cb_data;
+            break;
+        case kCdiCompletionEventRawTx:
+            core_cb_data_ptr = &event_ptr->cb_data.raw_tx.core_cb_data;
+            break;
+        case kCdiCompletionEventAvmTx:
+            core_cb_data_ptr = &event_ptr->cb_data.avm_tx.core_cb_data;
+            break;
+    }
+    return core_cb_data_ptr;
+}
+
+/**
+ * Initialize an event with a copy of callback data, including the error message string and AVM configuration structure
+ * it may point to.
+ *
+ * @param event_ptr Pointer to event to initialize.
+ * @param event_type Type of event. Determines the type of structure pointed to by cb_data_ptr.
+ * @param cb_data_ptr Pointer to the callback data.
+ */
+static void EventInit(CdiCompletionEvent* event_ptr, CdiCompletionEventType event_type, const void* cb_data_ptr)
+{
+    event_ptr->event_type = event_type;
+    switch (event_type) {
+        case kCdiCompletionEventRawRx:
+            event_ptr->cb_data.raw_rx = *(const CdiRawRxCbData*)cb_data_ptr;
+            break;
+        case kCdiCompletionEventAvmRx:
+            event_ptr->cb_data.avm_rx = *(const CdiAvmRxCbData*)cb_data_ptr;
+            if (event_ptr->cb_data.avm_rx.config_ptr) {
+                event_ptr->avm_config = *event_ptr->cb_data.avm_rx.config_ptr;
+            }
+            break;
+        case kCdiCompletionEventRawTx:
+            event_ptr->cb_data.raw_tx = *(const CdiRawTxCbData*)cb_data_ptr;
+            break;
+        case kCdiCompletionEventAvmTx:
+            event_ptr->cb_data.avm_tx = *(const CdiAvmTxCbData*)cb_data_ptr;
+            break;
+    }
+
+    const CdiCoreCbData* core_cb_data_ptr = EventCoreCbData(event_ptr);
+    if (core_cb_data_ptr->err_msg_str) {
+        CdiOsStrCpy(event_ptr->err_msg_array, sizeof(event_ptr->err_msg_array), core_cb_data_ptr->err_msg_str);
+    }
+}
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+// Doxygen commenting for these functions is in cdi_completion_queue_api.h.
+////////////////////////////////////////////////////////////////////////////////
+
+CdiReturnStatus CdiCompletionQueueCreate(int depth, CdiCompletionQueueHandle* ret_handle_ptr)
+{
+    // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
+    CdiReturnStatus rs = kCdiStatusOk;
+
+    if (NULL == ret_handle_ptr || depth < 0) {
+        return kCdiStatusInvalidParameter;
+    }
+    if (0 == depth) {
+        depth = CDI_COMPLETION_QUEUE_DEFAULT_DEPTH;
+    }
+
+    CdiCompletionQueueState* state_ptr = CdiOsMemAllocZero(sizeof(CdiCompletionQueueState));
+    if (NULL == state_ptr) {
+        rs = kCdiStatusNotEnoughMemory;
+    }
+
+    if (kCdiStatusOk == rs) {
+        state_ptr->notification_fd = -1;
+        // Events are pushed by any number of SDK threads, so the queue needs multiple writer support. Some of them
+        // wait for room in the queue (see CompletionQueuePushWait()).
+        if (!CdiQueueCreate("CompletionQueue", depth, CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE,
+                            sizeof(CdiCompletionEvent), kQueueSignalPushWait | kQueueMultipleWritersFlag,
+                            &state_ptr->event_queue_handle)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        if (!CdiOsNotificationFdCreate(&state_ptr->notification_fd)) {
+            SDK_LOG_GLOBAL(kLogError, "Failed to create completion queue notification file descriptor.");
+            rs = kCdiStatusFatal;
+        }
+    }
+
+    if (kCdiStatusOk != rs) {
+        CdiCompletionQueueDestroy(state_ptr);
+        state_ptr = NULL;
+    }
+
+    *ret_handle_ptr = state_ptr;
+
+    return rs;
+}
+
+CdiReturnStatus CdiCompletionQueueDestroy(CdiCompletionQueueHandle handle)
+{
+    if (NULL == handle) {
+        return kCdiStatusInvalidHandle;
+    }
+
+    CdiQueueFlush(handle->event_queue_handle);
+    CdiQueueDestroy(handle->event_queue_handle);
+    if (-1 != handle->notification_fd) {
+        CdiOsNotificationFdDelete(handle->notification_fd);
+    }
+    CdiOsMemFree(handle);
+
+    return kCdiStatusOk;
+}
+
+int CdiCompletionQueueGetFd(CdiCompletionQueueHandle handle)
+{
+    return handle ? handle->notification_fd : -1;
+}
+
+int CdiCompletionQueuePoll(CdiCompletionQueueHandle handle, CdiCompletionEvent* event_array, int max_events)
+{
+    if (NULL == handle || NULL == event_array || max_events < 0) {
+        return -1;
+    }
+
+    // Clear the notification before popping so that an event pushed after the last pop always leaves it set.
+    if (-1 != handle->notification_fd) {
+        CdiOsNotificationFdClear(handle->notification_fd);
+    }
+
+    int count = 0;
+    while (count < max_events && CdiQueuePop(handle->event_queue_handle, &event_array[count])) {
+        // The pointers within the event were copied along with it, so point them at the caller's copy of the data.
+        CdiCompletionEvent* event_ptr = &event_array[count];
+        CdiCoreCbData* core_cb_data_ptr = EventCoreCbData(event_ptr);
+        if (core_cb_data_ptr->err_msg_str) {
+            core_cb_data_ptr->err_msg_str = event_ptr->err_msg_array;
+        }
+        if (kCdiCompletionEventAvmRx == event_ptr->event_type && event_ptr->cb_data.avm_rx.config_ptr) {
+            event_ptr->cb_data.avm_rx.config_ptr = &event_ptr->avm_config;
+        }
+        count++;
+    }
+
+    // If events were left behind, keep the notification set so the application polls again.
+    if (-1 != handle->notification_fd && !CdiQueueIsEmpty(handle->event_queue_handle)) {
+        CdiOsNotificationFdSet(handle->notification_fd);
+    }
+
+    return count;
+}
+
+bool CompletionQueuePush(CdiCompletionQueueHandle handle, CdiCompletionEventType event_type, const void* cb_data_ptr)
+{
+    CdiCompletionEvent event;
+    EventInit(&event, event_type, cb_data_ptr);
+
+    bool ret = CdiQueuePush(handle->event_queue_handle, &event);
+    if (ret && -1 != handle->notification_fd) {
+        CdiOsNotificationFdSet(handle->notification_fd);
+    }
+
+    return ret;
+}
+
+bool CompletionQueuePushWait(CdiCompletionQueueHandle handle, CdiCompletionEventType event_type,
+                             const void* cb_data_ptr, CdiSignalType abort_wait_signal)
+{
+    CdiCompletionEvent event;
+    EventInit(&event, event_type, cb_data_ptr);
+
+    // Popping an event in CdiCompletionQueuePoll() wakes up the wait.
+    bool ret = CdiQueuePushWait(handle->event_queue_handle, CDI_INFINITE, abort_wait_signal, &event);
+    if (ret && -1 != handle->notification_fd) {
+        CdiOsNotificationFdSet(handle->notification_fd);
+    }
+
+    return ret;
+}
@@ -84,6 +84,39 @@ CdiReturnStatus CdiCoreNetworkAdapterDestroy(CdiAdapterHandle handle)
     return rs;
 }
 
+CdiReturnStatus CdiCoreNetworkAdapterMemoryRegister(CdiAdapterHandle handle, void* address_ptr,
+                                                    uint64_t size_in_bytes)
+{
+    CdiReturnStatus rs = kCdiStatusOk;
+
+    if (!IsValidAdapterHandle(handle)) {
+        rs = kCdiStatusInvalidHandle;
+    } else if (NULL == address_ptr || 0 == size_in_bytes) {
+        rs = kCdiStatusInvalidParameter;
+    }
+
+    if (rs == kCdiStatusOk) {
+        rs = CdiAdapterMemoryRegister(handle, address_ptr, size_in_bytes);
+    }
+
+    return rs;
+}
+
+CdiReturnStatus CdiCoreNetworkAdapterMemoryUnregister(CdiAdapterHandle handle, void* address_ptr)
+{
+    CdiReturnStatus rs = kCdiStatusOk;
+
+    if (!IsValidAdapterHandle(handle)) {
+        rs = kCdiStatusInvalidHandle;
+    }
+
+    if (rs == kCdiStatusOk) {
+        rs = CdiAdapterMemoryUnregister(handle, address_ptr);
+    }
+
+    return rs;
+}
+
 CdiReturnStatus CdiCoreRxFreeBuffer(const CdiSgList* sgl_ptr)
 {
     CdiReturnStatus rs = kCdiStatusOk;
@@ -105,6 +138,29 @@ CdiReturnStatus CdiCoreRxFreeBuffer(const CdiSgList* sgl_ptr)
     return rs;
 }
 
+CdiReturnStatus CdiCoreRxFreeBuffers(const CdiSgList* sgl_ptr_array[], int count)
+{
+    if (NULL == sgl_ptr_array || count < 0) {
+        return kCdiStatusInvalidParameter;
+    }
+
+    // Validate all of the lists before freeing any of them.
+    for (int i = 0; i < count; i++) {
+        const CdiSgList* sgl_ptr = sgl_ptr_array[i];
+        if (NULL == sgl_ptr) {
+            return kCdiStatusInvalidParameter;
+        }
+        // Don't process an internally generated empty SGL.
+        if (sgl_ptr->sgl_head_ptr != &cdi_global_context.empty_sgl_entry &&
+            !IsValidMemoryHandle(sgl_ptr->internal_data_ptr)) {
+            return kCdiStatusInvalidHandle;
+        }
+    }
+
+    // Return the packet buffers and SGL entries to the endpoints.
+    return RxEnqueueFreeBuffers(sgl_ptr_array, count);
+}
+
 int CdiCoreGather(const CdiSgList* sgl_ptr, int offset, void* dest_data, int byte_count)
 {
     if (NULL == sgl_ptr) {
@@ -40,6 +40,46 @@ extern CdiReturnStatus TestUnitRxReorderPayloads(void);
 extern CdiReturnStatus TestUnitList(void);
 /// External declarations.
 extern CdiReturnStatus TestUnitLogger(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitWorkerPool(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitStatsScheduler(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitRxRunToCompletion(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitTxPoll(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitCompletionQueue(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitQueue(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitMemoryRegion(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitTxFrameAllocator(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitPacketizer(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitTxBatchPolicy(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitTxScheduler(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitTxPreempt(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitTxStream(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitRxProgress(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitRxReorderWindow(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitEfaRma(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitEfaMultiRecv(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitEfaSharedCq(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitEfaSharedPool(void);
+/// External declarations.
+extern CdiReturnStatus TestUnitEfaInject(void);
 
 /// Type used as a pointer to function that runs a unit test.
 typedef CdiReturnStatus (*RunTestAPI)(void);
@@ -66,6 +106,26 @@ static const RunTestParams tests[] = {
     { kTestUnitRxPayloadReorder,    "RxPayloadReorder", TestUnitRxReorderPayloads },
     { kTestUnitList,                "List",             TestUnitList },
     { kTestUnitLogger,              "Logger",           TestUnitLogger },
+    { kTestUnitWorkerPool,          "WorkerPool",       TestUnitWorkerPool },
+    { kTestUnitStatsScheduler,      "StatsScheduler",   TestUnitStatsScheduler },
+    { kTestUnitRxRunToCompletion,   "RxRunToCompletion",TestUnitRxRunToCompletion },
+    { kTestUnitTxPoll,              "TxPoll",           TestUnitTxPoll },
+    { kTestUnitCompletionQueue,     "CompletionQueue",  TestUnitCompletionQueue },
+    { kTestUnitQueue,               "Queue",            TestUnitQueue },
+    { kTestUnitMemoryRegion,        "MemoryRegion",     TestUnitMemoryRegion },
+    { kTestUnitTxFrameAllocator,    "TxFrameAllocator", TestUnitTxFrameAllocator },
+    { kTestUnitPacketizer,          "Packetizer",       TestUnitPacketizer },
+    { kTestUnitTxBatchPolicy,       "TxBatchPolicy",    TestUnitTxBatchPolicy },
+    { kTestUnitTxScheduler,         "TxScheduler",      TestUnitTxScheduler },
+    { kTestUnitTxPreempt,           "TxPreempt",        TestUnitTxPreempt },
+    { kTestUnitTxStream,            "TxStream",         TestUnitTxStream },
+    { kTestUnitRxProgress,          "RxProgress",       TestUnitRxProgress },
+    { kTestUnitRxReorderWindow,     "RxReorderWindow",  TestUnitRxReorderWindow },
+    { kTestUnitEfaRma,              "EfaRma",           TestUnitEfaRma },
+    { kTestUnitEfaMultiRecv,        "EfaMultiRecv",     TestUnitEfaMultiRecv },
+    { kTestUnitEfaSharedCq,         "EfaSharedCq",      TestUnitEfaSharedCq },
+    { kTestUnitEfaSharedPool,       "EfaSharedPool",    TestUnitEfaSharedPool },
+    { kTestUnitEfaInject,           "EfaInject",        TestUnitEfaInject },
     { CDI_INVALID_ENUM_VALUE, NULL, NULL } // End of the array
 };
 
@@ -0,0 +1,398 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains the definitions of the functions that comprise the CDI Tx frame allocator API. All of the frames
+ * are carved out of a single allocation that is registered with the adapter. The free frames of each stream are kept
+ * in a queue of frame pointers. The application's thread is the only reader, so allocating a frame is lock-free. Frames
+ * are pushed back by the connection's payload callback thread when the payload that used them has been transmitted.
+ *
+ * The internal_data_ptr of a Tx payload's scatter-gather list belongs to the application unless the list came from
+ * CdiTxFrameAlloc(), so it is only dereferenced once it has been found within the frame array of a stream of one of the
+ * allocators in cdi_global_context.tx_frame_allocator_list. Payloads whose lists can't be frames don't keep their
+ * internal_data_ptr (see TxFrameAllocatorSglIsFrame()), so they are released without taking the list's lock.
+ */
+
+// Include headers in the following order: Related header, C system headers, other libraries' headers, your project's
+// headers.
+
+#include "cdi_tx_frame_allocator_api.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "adapter_api.h"
+#include "cdi_os_api.h"
+#include "cdi_queue_api.h"
+#include "internal.h"
+#include "internal_log.h"
+#include "internal_utility.h"
+#include "tx_frame_allocator.h"
+
+//*********************************************************************************************************************
+//***************************************** START OF DEFINITIONS AND TYPES ********************************************
+//*********************************************************************************************************************
+
+/// @brief Alignment in bytes of each frame within a stream.
+#define TX_FRAME_ALIGNMENT_BYTES        (64)
+
+/// @brief Forward reference of structure to create pointers later.
+typedef struct CdiTxFrameAllocatorState CdiTxFrameAllocatorState;
+
+/**
+ * @brief State data for a single frame. The frame's scatter-gather list points to this structure through its
+ * internal_data_ptr member, which is how the Tx logic finds the frame once the payload has been transmitted.
+ */
+typedef struct {
+    /// Set to kMagicTxFrame when created, checked whenever a frame is returned to help ensure validity.
+    uint32_t magic;
+    CdiQueueHandle free_queue_handle; ///< Queue of the stream that the frame belongs to.
+    CdiSgList sgl;                    ///< Scatter-gather list returned to the application.
+    CdiSglEntry entry;                ///< The single entry of sgl.
+    int frame_size_bytes;             ///< Size of the frame in bytes.
+} TxFrameState;
+
+/**
+ * @brief State data for a single stream of an allocator.
+ */
+typedef struct {
+    CdiQueueHandle free_queue_handle; ///< Queue of TxFrameState pointers of the frames that are free.
+    TxFrameState* frame_array;        ///< Array of all of the frames of the stream.
+    int frame_count;                  ///< Number of entries in frame_array.
+} TxFrameStreamState;
+
+/**
+ * @brief State data for a Tx frame allocator.
+ */
+struct CdiTxFrameAllocatorState {
+    CdiListEntry list_entry;         ///< Allow these structures to live in cdi_global_context.tx_frame_allocator_list.
+    CdiAdapterHandle adapter_handle; ///< Adapter that buffer_ptr is registered with.
+    void* buffer_ptr;                ///< Memory used by the frames of all of the streams, on a huge page boundary.
+    int buffer_size;                 ///< Size of buffer_ptr in bytes.
+    bool buffer_is_hugepages;        ///< True if buffer_ptr was allocated using huge pages.
+    void* heap_buffer_ptr;           ///< Heap memory that buffer_ptr is aligned within if not using huge pages.
+    bool is_listed;                  ///< True if in cdi_global_context.tx_frame_allocator_list.
+    bool buffer_is_registered;       ///< True if buffer_ptr is registered with the adapter.
+    int stream_count;                ///< Number of entries in stream_array.
+    TxFrameStreamState* stream_array; ///< Array of stream state data.
+};
+
+//*********************************************************************************************************************
+//*********************************************** START OF VARIABLES **************************************************
+//*********************************************************************************************************************
+
+//*********************************************************************************************************************
+//******************************************* START OF STATIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+/**
+ * Get the size in bytes of the memory used by a stream. Each stream starts on a huge page boundary.
+ *
+ * @param stream_config_ptr Pointer to stream configuration.
+ *
+ * @return Size in bytes or -1 if the size does not fit in an int.
+ */
+static int StreamBufferSize(const CdiTxFrameAllocatorStreamConfig* stream_config_ptr)
+{
+    int64_t frame_size = NextMultipleOf(stream_config_ptr->frame_size_bytes, TX_FRAME_ALIGNMENT_BYTES);
+    int64_t size = frame_size * stream_config_ptr->frame_count;
+    if (size > INT32_MAX - CDI_HUGE_PAGES_BYTE_SIZE) {
+        return -1;
+    }
+    return NextMultipleOf((int)size, CDI_HUGE_PAGES_BYTE_SIZE);
+}
+
+/**
+ * Return a frame to the queue of free frames of its stream.
+ *
+ * @param frame_ptr Pointer to frame.
+ *
+ * @return true if successful, false if the queue is full, which means the frame was returned more than once.
+ */
+static bool FramePut(TxFrameState* frame_ptr)
+{
+    return CdiQueuePush(frame_ptr->free_queue_handle, &frame_ptr);
+}
+
+/**
+ * Find the frame that a scatter-gather list's internal_data_ptr points to. The pointer is only compared against the
+ * addresses of the frames of the allocator's streams, never dereferenced.
+ *
+ * @param state_ptr Pointer to allocator state.
+ * @param internal_data_ptr Value of the internal_data_ptr member of the list.
+ *
+ * @return Pointer to the frame or NULL if internal_data_ptr is not a frame of the allocator.
+ */
+static TxFrameState* FrameFind(CdiTxFrameAllocatorState* state_ptr, const void* internal_data_ptr)
+{
+    const uintptr_t address = (uintptr_t)internal_data_ptr;
+    for (int i = 0; i < state_ptr->stream_count; i++) {
+        const TxFrameStreamState* stream_ptr = &state_ptr->stream_array[i];
+        const uintptr_t start_address = (uintptr_t)stream_ptr->frame_array;
+        const uintptr_t end_address = (uintptr_t)(stream_ptr->frame_array + stream_ptr->frame_count);
+        if (stream_ptr->frame_array && address >= start_address && address < end_address) {
+            if (0 != (address - start_address) % sizeof(TxFrameState)) {
+                return NULL; // Points into the middle of a frame.
+            }
+            return (TxFrameState*)internal_data_ptr;
+        }
+    }
+    return NULL;
+}
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+// Doxygen commenting for these functions is in cdi_tx_frame_allocator_api.h.
+////////////////////////////////////////////////////////////////////////////////
+
+CdiReturnStatus CdiTxFrameAllocatorCreate(CdiAdapterHandle adapter_handle,
+                                          const CdiTxFrameAllocatorStreamConfig* stream_config_array,
+                                          int stream_count, CdiTxFrameAllocatorHandle* ret_handle_ptr)
+{
+    // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
+    CdiReturnStatus rs = kCdiStatusOk;
+
+    if (!IsValidAdapterHandle(adapter_handle)) {
+        return kCdiStatusInvalidHandle;
+    }
+    if (NULL == stream_config_array || stream_count <= 0 || NULL == ret_handle_ptr) {
+        return kCdiStatusInvalidParameter;
+    }
+
+    // Validate the stream configurations and total up the memory needed.
+    int64_t buffer_size = 0;
+    for (int i = 0; i < stream_count; i++) {
+        const CdiTxFrameAllocatorStreamConfig* stream_config_ptr = &stream_config_array[i];
+        if (stream_config_ptr->frame_size_bytes <= 0 || stream_config_ptr->frame_count <= 0) {
+            SDK_LOG_GLOBAL(kLogError, "Stream[%d] frame size[%d] and frame count[%d] must be greater than zero.", i,
+                           stream_config_ptr->frame_size_bytes, stream_config_ptr->frame_count);
+            return kCdiStatusInvalidParameter;
+        }
+        int stream_size = StreamBufferSize(stream_config_ptr);
+        buffer_size += stream_size;
+        if (stream_size < 0 || buffer_size > INT32_MAX - CDI_HUGE_PAGES_BYTE_SIZE) {
+            SDK_LOG_GLOBAL(kLogError, "Tx frame allocator size exceeds [%d] bytes.", INT32_MAX);
+            return kCdiStatusInvalidParameter;
+        }
+    }
+
+    CdiTxFrameAllocatorState* state_ptr = CdiOsMemAllocZero(sizeof(CdiTxFrameAllocatorState));
+    if (NULL == state_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    state_ptr->adapter_handle = adapter_handle;
+
+    state_ptr->stream_array = CdiOsMemAllocZero(sizeof(TxFrameStreamState) * stream_count);
+    if (NULL == state_ptr->stream_array) {
+        rs = kCdiStatusNotEnoughMemory;
+    } else {
+        state_ptr->stream_count = stream_count;
+    }
+
+    if (kCdiStatusOk == rs) {
+        state_ptr->buffer_size = (int)buffer_size;
+        state_ptr->buffer_ptr = CdiOsMemAllocHugePage(state_ptr->buffer_size);
+        // Set flag so we know how to later free the buffer.
+        state_ptr->buffer_is_hugepages = NULL != state_ptr->buffer_ptr;
+        if (NULL == state_ptr->buffer_ptr) {
+            // Fallback using heap memory. Allocate an extra huge page so the streams still start on huge page
+            // boundaries.
+            state_ptr->heap_buffer_ptr = CdiOsMemAlloc(state_ptr->buffer_size + CDI_HUGE_PAGES_BYTE_SIZE);
+            if (NULL == state_ptr->heap_buffer_ptr) {
+                rs = kCdiStatusNotEnoughMemory;
+            } else {
+                uintptr_t address = (uintptr_t)state_ptr->heap_buffer_ptr;
+                address = (address + CDI_HUGE_PAGES_BYTE_SIZE - 1) & ~((uintptr_t)CDI_HUGE_PAGES_BYTE_SIZE - 1);
+                state_ptr->buffer_ptr = (void*)address;
+            }
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        // The allocator uses one of the adapter's memory regions (see CDI_MAX_ADAPTER_MEMORY_REGIONS).
+        rs = CdiAdapterMemoryRegister(adapter_handle, state_ptr->buffer_ptr, state_ptr->buffer_size);
+        state_ptr->buffer_is_registered = kCdiStatusOk == rs;
+        if (kCdiStatusArraySizeExceeded == rs) {
+            SDK_LOG_GLOBAL(kLogError, "Cannot create Tx frame allocator. All [%d] memory regions of the adapter are in"
+                           " use.", CDI_MAX_ADAPTER_MEMORY_REGIONS);
+        }
+    }
+
+    uint8_t* stream_buffer_ptr = state_ptr->buffer_ptr;
+    for (int i = 0; kCdiStatusOk == rs && i < stream_count; i++) {
+        const CdiTxFrameAllocatorStreamConfig* stream_config_ptr = &stream_config_array[i];
+        TxFrameStreamState* stream_ptr = &state_ptr->stream_array[i];
+        const int frame_count = stream_config_ptr->frame_count;
+
+        stream_ptr->frame_array = CdiOsMemAllocZero(sizeof(TxFrameState) * frame_count);
+        if (NULL == stream_ptr->frame_array) {
+            rs = kCdiStatusNotEnoughMemory;
+            break;
+        }
+        stream_ptr->frame_count = frame_count;
+
+        // Frames are returned by the connection's payload callback thread and by CdiTxFrameFree(), so the queue needs
+        // multiple writer support. Allow one extra entry so all of the frames fit in the queue at once.
+        char queue_name_str[MAX_POOL_NAME_LENGTH];
+        snprintf(queue_name_str, sizeof(queue_name_str), "TxFrames Stream[%d]", i);
+        if (!CdiQueueCreate(queue_name_str, frame_count + 1, CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE,
+                            sizeof(TxFrameState*), kQueueSignalNone | kQueueMultipleWritersFlag,
+                            &stream_ptr->free_queue_handle)) {
+            rs = kCdiStatusNotEnoughMemory;
+            break;
+        }
+
+        const int frame_stride = NextMultipleOf(stream_config_ptr->frame_size_bytes, TX_FRAME_ALIGNMENT_BYTES);
+        for (int j = 0; j < frame_count; j++) {
+            TxFrameState* frame_ptr = &stream_ptr->frame_array[j];
+            frame_ptr->magic = kMagicTxFrame;
+            frame_ptr->free_queue_handle = stream_ptr->free_queue_handle;
+            frame_ptr->frame_size_bytes = stream_config_ptr->frame_size_bytes;
+            frame_ptr->entry.address_ptr = stream_buffer_ptr + (j * frame_stride);
+            frame_ptr->sgl.sgl_head_ptr = &frame_ptr->entry;
+            frame_ptr->sgl.sgl_tail_ptr = &frame_ptr->entry;
+            frame_ptr->sgl.internal_data_ptr = frame_ptr;
+            FramePut(frame_ptr);
+        }
+        stream_buffer_ptr += StreamBufferSize(stream_config_ptr);
+    }
+
+    if (kCdiStatusOk == rs) {
+        // Frames can only be returned by TxFrameAllocatorRelease() once the allocator is in the list.
+        CdiOsCritSectionReserve(cdi_global_context.tx_frame_allocator_list_lock);
+        CdiListAddTail(&cdi_global_context.tx_frame_allocator_list, &state_ptr->list_entry);
+        state_ptr->is_listed = true;
+        CdiOsCritSectionRelease(cdi_global_context.tx_frame_allocator_list_lock);
+    } else {
+        CdiTxFrameAllocatorDestroy(state_ptr);
+        state_ptr = NULL;
+    }
+
+    *ret_handle_ptr = state_ptr;
+
+    return rs;
+}
+
+CdiReturnStatus CdiTxFrameAllocatorDestroy(CdiTxFrameAllocatorHandle handle)
+{
+    if (NULL == handle) {
+        return kCdiStatusInvalidHandle;
+    }
+
+    if (handle->is_listed) {
+        CdiOsCritSectionReserve(cdi_global_context.tx_frame_allocator_list_lock);
+        CdiListRemove(&cdi_global_context.tx_frame_allocator_list, &handle->list_entry);
+        CdiOsCritSectionRelease(cdi_global_context.tx_frame_allocator_list_lock);
+    }
+
+    for (int i = 0; i < handle->stream_count; i++) {
+        TxFrameStreamState* stream_ptr = &handle->stream_array[i];
+        if (stream_ptr->free_queue_handle) {
+            CdiQueueFlush(stream_ptr->free_queue_handle);
+            CdiQueueDestroy(stream_ptr->free_queue_handle);
+        }
+        if (stream_ptr->frame_array) {
+            CdiOsMemFree(stream_ptr->frame_array);
+        }
+    }
+    if (handle->stream_array) {
+        CdiOsMemFree(handle->stream_array);
+    }
+
+    if (handle->buffer_is_registered) {
+        CdiAdapterMemoryUnregister(handle->adapter_handle, handle->buffer_ptr);
+    }
+    if (handle->buffer_ptr) {
+        if (handle->buffer_is_hugepages) {
+            CdiOsMemFreeHugePage(handle->buffer_ptr, handle->buffer_size);
+        } else {
+            CdiOsMemFree(handle->heap_buffer_ptr);
+        }
+    }
+    CdiOsMemFree(handle);
+
+    return kCdiStatusOk;
+}
+
+CdiReturnStatus CdiTxFrameAlloc(CdiTxFrameAllocatorHandle handle, int stream_index, CdiSgList** ret_sgl_ptr)
+{
+    if (NULL == handle) {
+        return kCdiStatusInvalidHandle;
+    }
+    if (stream_index < 0 || stream_index >= handle->stream_count || NULL == ret_sgl_ptr) {
+        return kCdiStatusInvalidParameter;
+    }
+
+    TxFrameState* frame_ptr = NULL;
+    if (!CdiQueuePop(handle->stream_array[stream_index].free_queue_handle, &frame_ptr)) {
+        return kCdiStatusAllocationFailed;
+    }
+
+    // The application may have reduced the size the last time the frame was used, so restore the full size.
+    frame_ptr->entry.size_in_bytes = frame_ptr->frame_size_bytes;
+    frame_ptr->entry.next_ptr = NULL;
+    frame_ptr->sgl.total_data_size = frame_ptr->frame_size_bytes;
+    *ret_sgl_ptr = &frame_ptr->sgl;
+
+    return kCdiStatusOk;
+}
+
+CdiReturnStatus CdiTxFrameFree(const CdiSgList* sgl_ptr)
+{
+    if (NULL == sgl_ptr) {
+        return kCdiStatusInvalidParameter;
+    }
+
+    return TxFrameAllocatorRelease(sgl_ptr) ? kCdiStatusOk : kCdiStatusInvalidHandle;
+}
+
+bool TxFrameAllocatorSglIsFrame(const CdiSgList* sgl_ptr)
+{
+    // Only compare addresses, since internal_data_ptr may point to anything if the list belongs to the application.
+    const uintptr_t frame_address = (uintptr_t)sgl_ptr->internal_data_ptr;
+    return 0 != frame_address &&
+           frame_address + offsetof(TxFrameState, entry) == (uintptr_t)sgl_ptr->sgl_head_ptr &&
+           sgl_ptr->sgl_head_ptr == sgl_ptr->sgl_tail_ptr;
+}
+
+bool TxFrameAllocatorRelease(const CdiSgList* sgl_ptr)
+{
+    if (NULL == sgl_ptr->internal_data_ptr) {
+        return false;
+    }
+
+    // The lock keeps the allocator from being destroyed while the frame is returned to it.
+    TxFrameState* frame_ptr = NULL;
+    CdiOsCritSectionReserve(cdi_global_context.tx_frame_allocator_list_lock);
+
+    CdiListIterator list_iterator;
+    CdiListIteratorInit(&cdi_global_context.tx_frame_allocator_list, &list_iterator);
+    CdiListEntry* entry_ptr = NULL;
+    while (NULL == frame_ptr && NULL != (entry_ptr = CdiListIteratorGetNext(&list_iterator))) {
+        CdiTxFrameAllocatorState* state_ptr = CONTAINER_OF(entry_ptr, CdiTxFrameAllocatorState, list_entry);
+        frame_ptr = FrameFind(state_ptr, sgl_ptr->internal_data_ptr);
+    }
+
+    if (frame_ptr) {
+        assert(kMagicTxFrame == frame_ptr->magic);
+        if (!FramePut(frame_ptr)) {
+            CDI_LOG_THREAD(kLogError, "Tx frame[%p] was returned to its allocator more than once.",
+                           frame_ptr->entry.address_ptr);
+        }
+    }
+
+    CdiOsCritSectionRelease(cdi_global_context.tx_frame_allocator_list_lock);
+
+    return NULL != frame_ptr;
+}
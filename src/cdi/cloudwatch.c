@@ -85,6 +85,7 @@ static void FifoFullCallback(const CdiFifoFullCbData* cb_data_ptr)
     // Accumulate time-interval based stats. Update the counters.
     dest_ptr->transfer_count += src_ptr->transfer_count;
     dest_ptr->transfer_time_sum += src_ptr->transfer_time_sum;
+    dest_ptr->endpoint_transfer_count += src_ptr->endpoint_transfer_count;
 
     // When dealing with percentiles, when the fifo is full, replace the last element with our new results only if the
     // new results are higher. That way, in the event of data loss, we preserve the worst-case numbers. The only case
@@ -104,6 +105,12 @@ static void FifoFullCallback(const CdiFifoFullCbData* cb_data_ptr)
     if (src_ptr->transfer_time_max > dest_ptr->transfer_time_max) {
         dest_ptr->transfer_time_max = src_ptr->transfer_time_max;
     }
+    if (src_ptr->endpoint_transfer_time_max > dest_ptr->endpoint_transfer_time_max) {
+        dest_ptr->endpoint_transfer_time_max = src_ptr->endpoint_transfer_time_max;
+    }
+    if (src_ptr->rx_reorder_window_packets_max > dest_ptr->rx_reorder_window_packets_max) {
+        dest_ptr->rx_reorder_window_packets_max = src_ptr->rx_reorder_window_packets_max;
+    }
 }
 
 /**
@@ -0,0 +1,54 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * The declarations in this header file correspond to the internal definitions in cdi_completion_queue_api.c. They are
+ * used by the Rx and Tx logic to push events to an application's completion queue in place of invoking its
+ * registered callback functions.
+ */
+
+#ifndef CDI_COMPLETION_QUEUE_H__
+#define CDI_COMPLETION_QUEUE_H__
+
+#include <stdbool.h>
+
+#include "cdi_completion_queue_api.h"
+#include "cdi_os_api.h"
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+/**
+ * Push an event to a completion queue. The callback data, including the error message string and AVM configuration
+ * structure it may point to, is copied so it does not need to remain valid after this function returns. This function
+ * can be called from any number of threads.
+ *
+ * @param handle Completion queue handle.
+ * @param event_type Type of event. Determines the type of structure pointed to by cb_data_ptr.
+ * @param cb_data_ptr Pointer to the callback data (CdiRawRxCbData, CdiAvmRxCbData, CdiRawTxCbData or CdiAvmTxCbData).
+ *
+ * @return true if successful, false if the queue is full.
+ */
+bool CompletionQueuePush(CdiCompletionQueueHandle handle, CdiCompletionEventType event_type, const void* cb_data_ptr);
+
+/**
+ * Push an event to a completion queue like CompletionQueuePush(), but if the queue is full, wait until the application
+ * makes room for the event by polling the queue. Used for events that must not be lost.
+ *
+ * @param handle Completion queue handle.
+ * @param event_type Type of event. Determines the type of structure pointed to by cb_data_ptr.
+ * @param cb_data_ptr Pointer to the callback data (CdiRawRxCbData, CdiAvmRxCbData, CdiRawTxCbData or CdiAvmTxCbData).
+ * @param abort_wait_signal Signal used to abort waiting.
+ *
+ * @return true if successful, false if the wait was aborted.
+ */
+bool CompletionQueuePushWait(CdiCompletionQueueHandle handle, CdiCompletionEventType event_type,
+                             const void* cb_data_ptr, CdiSignalType abort_wait_signal);
+
+#endif // CDI_COMPLETION_QUEUE_H__
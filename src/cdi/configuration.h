@@ -77,11 +77,28 @@
 #define NO_GROW_COUNT (0) ///< @brief This is used for pools that will not grow when they become empty.
 #define NO_GROW_SIZE (0)  ///< @brief This is used for pools that will not grow when they become empty.
 
-/// @brief Maximum number of out of order packets that can be received.
-#define MAX_RX_OUT_OF_ORDER                 (128)
-/// @brief Maximum number out of order packets buffer can be increased by.
+/// @brief Maximum number out of order packets buffer can be increased by. The initial size is set by
+/// CdiRxConfigData.reorder_list_pool_size.
 #define MAX_RX_OUT_OF_ORDER_GROW            (8)
 
+/// @brief Maximum number of packets in a payload that can be put in order using a bitmap (see RxReorderBitmap). Must be
+/// a multiple of RX_REORDER_BITMAP_BLOCK_PACKETS. Payloads with more packets fall back to the reorder lists once a
+/// packet beyond this is received.
+#define RX_REORDER_BITMAP_MAX_PACKETS       (4096)
+/// @brief Initial number of payloads per Rx connection that can be put in order using a bitmap at the same time.
+#define RX_REORDER_BITMAP_POOL_SIZE         (8)
+/// @brief Number of payload reorder bitmaps the pool can be increased by.
+#define RX_REORDER_BITMAP_POOL_GROW         (2)
+/// @brief Number of packet slots in each block of a reorder bitmap (see RxReorderBitmapBlock). A block covers the
+/// sequence numbers of one word of the bitmap.
+#define RX_REORDER_BITMAP_BLOCK_PACKETS     (64)
+/// @brief Initial number of reorder bitmap blocks per Rx connection. Blocks are only taken for the sequence numbers a
+/// payload actually has, so the memory used by a bitmap follows the size of its payload. If none is available, the
+/// payload falls back to the reorder lists.
+#define RX_REORDER_BITMAP_BLOCK_POOL_SIZE   (64)
+/// @brief Number of reorder bitmap blocks the pool can be increased by.
+#define RX_REORDER_BITMAP_BLOCK_POOL_GROW   (16)
+
 /// @brief Maximum length of error string message.
 #define MAX_ERROR_STRING_LENGTH             (1024)
 
@@ -138,9 +155,59 @@
 /// corresponding completion event (ACK or error).
 #define SIMULTANEOUS_TX_PACKET_LIMIT                   (50)
 
+/// @brief Maximum number of packets that are created each time the poll thread polls a Tx connection that is
+/// configured to run to completion.
+#define TX_RUN_TO_COMPLETION_PACKETS_PER_POLL          (SIMULTANEOUS_TX_PACKET_LIMIT/2)
+
 /// @brief Maximum number of completion queue messages to process in a single Tx poll call.
 #define MAX_TX_BULK_COMPLETION_QUEUE_MESSAGES          (SIMULTANEOUS_TX_PACKET_LIMIT)
 
+/// @brief Maximum number of payloads put in a Tx connection's payload queue with a single queue operation by
+/// CdiAvmEndpointTxPayloads(). Larger batches are split into multiple queue operations.
+#define MAX_TX_PAYLOAD_BATCH_SIZE                      (32)
+
+/// @brief Number of bounce buffers per Tx connection that is configured to coalesce small SGL fragments (see
+/// CdiTxConfigData.coalesce_small_fragments). Each buffer holds the payload data of one packet.
+#define TX_BOUNCE_BUFFER_COUNT_PER_CONNECTION          (512)
+
+/// @brief Source SGL fragments smaller than this number of bytes are copied into a bounce buffer instead of being sent
+/// directly when a Tx connection is configured to coalesce small SGL fragments.
+#define TX_COALESCE_FRAGMENT_MAX_BYTES                 (512)
+
+/// @brief Maximum number of source SGL entries, packets and packet SGL entries that a single Tx stream's cached
+/// packetization plan can hold. Payloads that need more are packetized without a plan.
+#define TX_PACKETIZATION_PLAN_MAX_ITEMS                (32768)
+
+/// @brief Maximum number of packetizer helpers of a Tx connection (see CdiTxConfigData.packetizer_helper_count).
+#define TX_PACKETIZER_MAX_HELPERS                      (8)
+
+/// @brief Payloads are only packetized by packetizer helpers if at least this number of their packets are left to be
+/// built once their first two packets have been built. Smaller payloads are not worth the hand-off to other threads.
+#define TX_PARALLEL_PACKETIZE_MIN_PACKETS              (512)
+
+/// @brief Maximum number of packets built concurrently by a Tx connection's packetizer and its helpers before they are
+/// queued to the adapter.
+#define TX_PARALLEL_PACKETIZE_CHUNK_PACKETS            (1024)
+
+/// @brief Number of packets in each batch of a Tx connection that uses kCdiTxBatchPolicyThroughput.
+#define TX_BATCH_THROUGHPUT_PACKETS                    (128)
+
+/// @brief Maximum number of packets in a batch of a Tx connection that uses kCdiTxBatchPolicyAdaptive.
+#define TX_BATCH_ADAPTIVE_MAX_PACKETS                  (128)
+
+/// @brief Maximum number of packets in a batch of a Tx connection that uses kCdiTxBatchPolicyAdaptive once half of the
+/// payload's maximum latency has elapsed.
+#define TX_BATCH_ADAPTIVE_URGENT_MAX_PACKETS           (4)
+
+/// @brief Maximum latency in microseconds assumed when ordering Tx payloads that have none, on a connection that
+/// schedules payloads by deadline (see CdiTxConfigData.deadline_scheduling). Bounds how long such payloads wait behind
+/// payloads that have a deadline.
+#define TX_SCHEDULER_NO_LATENCY_MAX_WAIT_MICROSECS     (100000)
+
+/// @brief Maximum number of bytes a paced Tx endpoint can send back to back after it has been idle (see
+/// CdiTxConfigData.pacing_window_microsecs).
+#define TX_PACING_MAX_BURST_BYTES                      (9000)
+
 /// @brief Maximum number of completion queue messages to process in a single Rx poll call.
 #define MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES          (50)
 
@@ -175,12 +242,40 @@
 /// @brief Number of Tx packets to cache before notifying libfabric to ring the NIC's doorbell.
 #define EFA_TX_PACKET_CACHE_SIZE                (16)
 
+/// @brief Largest Tx packet in bytes that is sent with fi_inject() instead of fi_sendmsg(), if the libfabric provider's
+/// inject size allows it. Injected packets are gathered into a buffer of this size on the stack.
+#define EFA_TX_INJECT_MAX_BYTES                 (512)
+
+/// @brief Maximum number of injected Tx packets that wait to be completed by the next Tx poll. libfabric does not
+/// generate completions for injected packets, so they are completed together. Packets are sent with fi_sendmsg() while
+/// this many are waiting.
+#define EFA_TX_INJECT_BATCH_SIZE                (64)
+
 /// @brief Number of Rx buffer posts to cache before notifying libfabric to ring the NIC's doorbell.
 #define EFA_RX_PACKET_BUFFER_CACHE_SIZE         (16)
 
 /// @brief Number of read completion queue entries. Current libfabric default is 50.
 #define EFA_CQ_READ_SIZE                        (50)
 
+/// @brief Number of receive buffer slots an Rx endpoint advertises to the transmitter for RMA direct placement (see
+/// CdiRxConfigData.rma_direct_placement). Each slot holds one payload of linear_buffer_size bytes from the time the
+/// transmitter starts writing it until the application frees it. Must not exceed CDI_MAX_RMA_SLOTS.
+#define EFA_RX_RMA_SLOT_COUNT                   (4)
+
+/// @brief Number of FI_MULTI_RECV buffers that the receive packet memory of an Rx endpoint is split into (see
+/// CdiRxConfigData.multi_receive_buffers). A buffer is only posted again once all of its packets have been freed, so
+/// using more buffers lets libfabric receive into the others while a payload still holds packets in one of them.
+#define EFA_RX_MULTI_RECV_BUFFER_COUNT          (8)
+
+/// @brief Number of packet buffers taken from the adapter's shared receive pool that an Rx endpoint keeps posted to
+/// libfabric (see CdiRxConfigData.shared_rx_packet_quota). Buffers are replaced each time the endpoint is polled, so
+/// this only needs to cover the packets that arrive between polls.
+#define EFA_RX_SHARED_POOL_POSTED_PACKETS       (512)
+
+/// @brief Maximum number of polls that an Rx endpoint skips before it tries again to take buffers from the adapter's
+/// shared receive pool, after it found the pool empty or its connection's quota used up.
+#define EFA_RX_SHARED_POOL_MAX_REFILL_BACKOFF   (64)
+
 //*********************************************************************************************************************
 //********************************************** SETTINGS FOR EFA PROBE ***********************************************
 //*********************************************************************************************************************
@@ -253,6 +348,19 @@
 /// CdiCoreRxFreeBuffer() function.
 #define RX_LINEAR_BUFFER_COUNT                  (5)
 
+/// Maximum number of buffers put in an endpoint's Rx free buffer queue with a single queue operation by
+/// CdiCoreRxFreeBuffers().
+#define MAX_RX_FREE_BUFFER_BATCH_SIZE           (32)
+
+/// @brief Number of Rx payload callbacks that exceed their time budget between each warning that is logged for a
+/// connection configured to run to completion. The first one is always logged.
+#define RX_RUN_TO_COMPLETION_WARNING_INTERVAL   (1000)
+
+/// @brief Maximum number of ranges of payload data received ahead of a gap that are remembered for each payload in
+/// order to track the part of the payload that has been received with no gaps (see CdiRxConfigData.progress_cb_ptr).
+/// If packets arrive further out of order, progress is only reported again once the payload is complete.
+#define RX_PROGRESS_MAX_PENDING_RANGES          (32)
+
 //*********************************************************************************************************************
 //****************************************** SETTINGS FOR SYSTEM MONITORING *******************************************
 //*********************************************************************************************************************
@@ -263,6 +371,26 @@
 /// The maximum number of milliseconds that system monitoring thread should have slept for before waking up.
 #define SYSTEM_MONITORING_SLEEP_TIME_TOLERANCE_MS (SYSTEM_MONITORING_SLEEP_TIME_MS + 200)
 
+//*********************************************************************************************************************
+//********************************************* SETTINGS FOR WORKER POOL **********************************************
+//*********************************************************************************************************************
+
+/// The maximum number of threads that can be configured for the SDK worker pool.
+#define MAX_WORKER_POOL_THREADS                 (64)
+
+/// Initial number of entries in each worker thread's queue of tasks that are ready to run.
+#define WORKER_POOL_READY_QUEUE_SIZE            (64)
+
+/// Number of entries a worker thread's ready task queue grows by each time it becomes full.
+#define WORKER_POOL_READY_QUEUE_GROW            (64)
+
+/// Number of microseconds to sleep between checks while waiting for a stopped task to drain.
+#define WORKER_POOL_STOP_POLL_MICROSECONDS      (100)
+
+/// @brief Maximum number of payload messages processed each time a connection's application callback task runs on the
+/// worker pool. Once reached, the task is re-queued behind the other tasks bound to the same worker thread.
+#define WORKER_POOL_APP_CALLBACK_BATCH_SIZE     (8)
+
 //*********************************************************************************************************************
 //********************************************* SETTINGS FOR CLOUDWATCH ***********************************************
 //*********************************************************************************************************************
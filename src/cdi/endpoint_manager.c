@@ -812,6 +812,12 @@ bool EndpointManagerIsConnectionShuttingDown(EndpointManagerHandle handle)
     return mgr_ptr->got_shutdown;
 }
 
+bool EndpointManagerIsPollThreadWaiting(EndpointManagerHandle handle)
+{
+    EndpointManagerState* mgr_ptr = (EndpointManagerState*)handle;
+    return mgr_ptr->poll_thread_waiting || mgr_ptr->thread_done;
+}
+
 CdiSignalType EndpointManagerGetNotificationSignal(EndpointManagerHandle handle)
 {
     EndpointManagerState* mgr_ptr = (EndpointManagerState*)handle;
@@ -971,6 +977,13 @@ CdiReturnStatus EndpointManagerTxCreateEndpoint(EndpointManagerHandle handle, bo
             }
         }
 
+        if (kCdiStatusOk == rs) {
+            endpoint_ptr->tx_state.packetization_plan_handle = PayloadPacketizationPlanCreate();
+            if (NULL == endpoint_ptr->tx_state.packetization_plan_handle) {
+                rs = kCdiStatusNotEnoughMemory;
+            }
+        }
+
         if (kCdiStatusOk == rs) {
             // Open an endpoint to send packets to a remote host. Do this last since doing so will open the flood gates
             // for callbacks to begin.
@@ -980,6 +993,7 @@ CdiReturnStatus EndpointManagerTxCreateEndpoint(EndpointManagerHandle handle, bo
 
                 .msg_from_endpoint_func_ptr = TxPacketWorkRequestComplete,
                 .msg_from_endpoint_param_ptr = endpoint_ptr,
+                .msgs_from_endpoint_func_ptr = TxPacketWorkRequestsComplete,
 
                 .remote_address_str = dest_ip_addr_str,
                 .port_number = dest_port,
@@ -1041,6 +1055,17 @@ CdiReturnStatus EndpointManagerRxCreateEndpoint(EndpointManagerHandle handle, in
         }
     }
 
+    if (kCdiStatusOk == rs) {
+        // Size the payload state array used to put payloads back in order as configured for the connection.
+        int array_size = con_ptr->rx_state.config_data.payload_reorder_buffer_size;
+        endpoint_ptr->rx_state.payload_state_array_ptr = CdiOsMemAllocZero(array_size * sizeof(RxPayloadState*));
+        if (NULL == endpoint_ptr->rx_state.payload_state_array_ptr) {
+            rs = kCdiStatusNotEnoughMemory;
+        } else {
+            endpoint_ptr->rx_state.payload_state_array_size = array_size;
+        }
+    }
+
     // Since this endpoint can be created dynamically as part of a control command received from a remote transmitter,
     // we need to save the remote address before creating the adapter endpoint. The adapter endpoint's control interface
     // can start using it immediately.
@@ -319,6 +319,17 @@ void EndpointManagerShutdownConnection(EndpointManagerHandle handle);
  */
 bool EndpointManagerIsConnectionShuttingDown(EndpointManagerHandle handle);
 
+/**
+ * Return true if the poll thread is waiting for the Endpoint Manager to process a state change or the Endpoint Manager
+ * thread has exited. While waiting, the poll thread must not use any connection level resources, since they may be
+ * being flushed. NOTE: Must only be called from the poll thread.
+ *
+ * @param handle Handle of Endpoint Manager.
+ *
+ * @return Returns true if the poll thread is waiting, otherwise false is returned.
+ */
+bool EndpointManagerIsPollThreadWaiting(EndpointManagerHandle handle);
+
 /**
  * Notify the application of a connection state change using the user registered connection callback function, if the
  * state has actually changed.
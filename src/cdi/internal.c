@@ -31,6 +31,7 @@
 #include "internal_tx.h"
 #include "internal_rx.h"
 #include "statistics.h"
+#include "tx_frame_allocator.h"
 
 //*********************************************************************************************************************
 //***************************************** START OF DEFINITIONS AND TYPES ********************************************
@@ -77,6 +78,40 @@ static CDI_THREAD SystemMonitorThread(void* ptr)
     return 0; // Return code not used.
 }
 
+/**
+ * Process a single payload message from a connection's app_payload_message_queue_handle by invoking the application's
+ * payload callback function.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param app_cb_data_ptr Pointer to the payload message.
+ */
+static void ProcessAppPayloadMessage(CdiConnectionState* con_state_ptr, AppPayloadCallbackData* app_cb_data_ptr)
+{
+    // Invoke application payload callback function.
+    if (con_state_ptr->handle_type == kHandleTypeTx) {
+        // Tx connection. All packets in the payload have been acknowledged as being received by the receiver. Put the
+        // Tx payload entries and payload state data back in the pool. We do this here on this thread to reduce the
+        // amount of work on the Tx Poll() thread.
+        CdiSglEntry* entry_ptr = app_cb_data_ptr->tx_source_sgl.sgl_head_ptr;
+        while (entry_ptr) {
+            CdiSglEntry* next_ptr = entry_ptr->next_ptr; // Save next entry, since Put() will free its memory.
+            CdiPoolPut(con_state_ptr->tx_state.payload_sgl_entry_pool_handle, entry_ptr);
+            entry_ptr = next_ptr;
+        }
+        // Notify the application.
+        TxInvokeAppPayloadCallback(con_state_ptr, app_cb_data_ptr);
+        CdiOsAtomicDec32(&con_state_ptr->tx_state.app_payload_message_count);
+        // If the payload was sent from a frame of a Tx frame allocator, the application is done with it, so return it.
+        TxFrameAllocatorRelease(&app_cb_data_ptr->tx_source_sgl);
+    } else {
+        // Rx connection. The SGL from the queue represents a received packet. Need to reassemble it into a payload and
+        // send the payload SGL to the application.
+        RxInvokeAppPayloadCallback(con_state_ptr, app_cb_data_ptr);
+    }
+    // If error message exists, return it to pool.
+    PayloadErrorFreeBuffer(con_state_ptr->error_message_pool, app_cb_data_ptr);
+}
+
 /**
  * Payload thread used to notify application that payload has been transmitted and acknowledged as being received by the
  * receiver.
@@ -97,32 +132,37 @@ static CDI_THREAD AppCallbackPayloadThread(void* ptr)
         AppPayloadCallbackData app_cb_data;
         if (CdiQueuePopWait(con_state_ptr->app_payload_message_queue_handle, CDI_INFINITE,
                             con_state_ptr->shutdown_signal, (void**)&app_cb_data)) {
-            // Invoke application payload callback function.
-            if (con_state_ptr->handle_type == kHandleTypeTx) {
-                // Tx connection. All packets in the payload have been acknowledged as being received by the
-                // receiver. Put the Tx payload entries and payload state data back in the pool. We do this here on
-                // this thread to reduce the amount of work on the Tx Poll() thread.
-                CdiSglEntry* entry_ptr = app_cb_data.tx_source_sgl.sgl_head_ptr;
-                while (entry_ptr) {
-                    CdiSglEntry* next_ptr = entry_ptr->next_ptr; // Save next entry, since Put() will free its memory.
-                    CdiPoolPut(con_state_ptr->tx_state.payload_sgl_entry_pool_handle, entry_ptr);
-                    entry_ptr = next_ptr;
-                }
-                // Notify the application.
-                TxInvokeAppPayloadCallback(con_state_ptr, &app_cb_data);
-            } else {
-                // Rx connection. The SGL from the queue represents a received packet. Need to reassemble it into a
-                // payload and send the payload SGL to the application.
-                RxInvokeAppPayloadCallback(con_state_ptr, &app_cb_data);
-            }
-            // If error message exists, return it to pool.
-            PayloadErrorFreeBuffer(con_state_ptr->error_message_pool, &app_cb_data);
+            ProcessAppPayloadMessage(con_state_ptr, &app_cb_data);
         }
     }
 
     return 0; // Return code not used.
 }
 
+/**
+ * Worker pool task used instead of AppCallbackPayloadThread() when the worker pool is enabled. Processes the payload
+ * messages that are currently in the connection's queue without blocking.
+ *
+ * @param arg_ptr Pointer to task specific data. In this case, a pointer to CdiConnectionState.
+ *
+ * @return true if more messages may be waiting in the queue, otherwise false.
+ */
+static bool AppCallbackPayloadTask(void* arg_ptr)
+{
+    CdiConnectionState* con_state_ptr = (CdiConnectionState*)arg_ptr;
+
+    // Limit the number of messages processed at a time so other connections using the same worker thread get a turn.
+    for (int i = 0; i < WORKER_POOL_APP_CALLBACK_BATCH_SIZE; i++) {
+        AppPayloadCallbackData app_cb_data;
+        if (!CdiQueuePop(con_state_ptr->app_payload_message_queue_handle, (void**)&app_cb_data)) {
+            return false;
+        }
+        ProcessAppPayloadMessage(con_state_ptr, &app_cb_data);
+    }
+
+    return !CdiQueueIsEmpty(con_state_ptr->app_payload_message_queue_handle);
+}
+
 /**
  * Function to shutdown connection.
  *
@@ -137,6 +177,9 @@ static void ConnectionShutdownInternal(CdiConnectionHandle handle)
     // Clean-up thread resources. We will wait for them to exit using thread join.
     SdkThreadJoin(handle->app_payload_message_thread_id, handle->shutdown_signal);
     handle->app_payload_message_thread_id = NULL;
+    // If the worker pool is servicing the payload messages, wait for the task to stop. NOTE: The task is embedded in
+    // the connection's state data, so it remains valid for any late scheduling requests until the state is freed below.
+    WorkerPoolTaskStop(&handle->app_payload_message_task);
 
     // Now that the connection and adapter threads have stopped, it is safe to clean up the remaining resources.
     if (kHandleTypeTx == handle->handle_type) {
@@ -179,6 +222,8 @@ static void AdapterShutdownInternal(CdiAdapterHandle handle)
     CdiOsCritSectionRelease(handle->adapter_lock);
     CdiOsCritSectionDelete(handle->adapter_lock);
     handle->adapter_lock = NULL;
+    CdiOsCritSectionDelete(handle->memory_region_lock);
+    handle->memory_region_lock = NULL;
 
     // Free the memory holding the adapter's state.
     CdiOsMemFree(handle);
@@ -205,6 +250,13 @@ static void FifoDebugCallback(const CdiFifoCbData* cb_ptr)
  */
 static void CleanupGlobalResources(void)
 {
+    // All connections have been destroyed, so no tasks remain on the worker pool.
+    WorkerPoolDestroy(cdi_global_context.worker_pool_handle);
+    cdi_global_context.worker_pool_handle = NULL;
+
+    StatsSchedulerDestroy(cdi_global_context.stats_scheduler_handle);
+    cdi_global_context.stats_scheduler_handle = NULL;
+
     if (cdi_global_context.system_monitor_thread_id) {
         // Clean-up thread resources. We will wait for them to exit using thread join.
         SdkThreadJoin(cdi_global_context.system_monitor_thread_id, cdi_global_context.shutdown_signal);
@@ -226,6 +278,15 @@ static void CleanupGlobalResources(void)
         CdiOsCritSectionDelete(cdi_global_context.adapter_handle_list_lock);
     }
 
+    // Tx frame allocator list should be empty here.
+    if (!CdiListIsEmpty(&cdi_global_context.tx_frame_allocator_list)) {
+        SDK_LOG_GLOBAL(kLogError,
+                       "Tx frame allocator list is not empty. Must use CdiTxFrameAllocatorDestroy() for each allocator"
+                       " before shutting down the SDK.");
+    }
+    CdiOsCritSectionDelete(cdi_global_context.tx_frame_allocator_list_lock);
+    cdi_global_context.tx_frame_allocator_list_lock = NULL;
+
 #ifdef CLOUDWATCH_METRICS_ENABLED
 #ifdef METRICS_GATHERING_SERVICE_ENABLED
     MetricsGathererDestroy(cdi_global_context.metrics_gathering_sdk_handle);
@@ -271,6 +332,17 @@ CdiReturnStatus CdiGlobalInitialization(const CdiCoreConfigData* core_config_ptr
         CdiListInit(&cdi_global_context.adapter_handle_list);
     }
 
+    if (kCdiStatusOk == rs) {
+        // Create a critical section used to protect access to tx_frame_allocator_list.
+        if (!CdiOsCritSectionCreate(&cdi_global_context.tx_frame_allocator_list_lock)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        CdiListInit(&cdi_global_context.tx_frame_allocator_list);
+    }
+
     // Ensure the logger has been initialized.
     if (!CdiLoggerInitialize()) {
         rs = kCdiStatusFatal;
@@ -354,6 +426,16 @@ CdiReturnStatus CdiGlobalInitialization(const CdiCoreConfigData* core_config_ptr
         rs = kCdiStatusNotEnoughMemory;
     }
 
+    // Create the stats scheduler that is shared by all connections.
+    if (kCdiStatusOk == rs) {
+        rs = StatsSchedulerCreate(&cdi_global_context.stats_scheduler_handle);
+    }
+
+    // Create the worker pool, if enabled.
+    if (kCdiStatusOk == rs && core_config_ptr->worker_pool_thread_count > 0) {
+        rs = WorkerPoolCreate(core_config_ptr->worker_pool_thread_count, core_config_ptr->worker_pool_core_array,
+                              &cdi_global_context.worker_pool_handle);
+    }
 
     if (kCdiStatusOk == rs) {
         cdi_global_context.sdk_initialized = true;
@@ -505,6 +587,14 @@ CdiReturnStatus AdapterInitializeInternal(CdiAdapterData* adapter_data_ptr, CdiA
             }
         }
 
+        if (rs == kCdiStatusOk) {
+            // Create a critical section used to protect access to the registered memory regions.
+            if (!CdiOsCritSectionCreate(&state_ptr->memory_region_lock)) {
+                rs = kCdiStatusNotEnoughMemory;
+            }
+            CdiListInit(&state_ptr->memory_region_user_list);
+        }
+
         if (rs == kCdiStatusOk) {
             // Initialize the list of poll threads using this adapter.
             CdiListInit(&state_ptr->poll_thread_list);
@@ -514,6 +604,7 @@ CdiReturnStatus AdapterInitializeInternal(CdiAdapterData* adapter_data_ptr, CdiA
     if (rs != kCdiStatusOk) {
         if (state_ptr) {
             CdiOsCritSectionDelete(state_ptr->adapter_lock);
+            CdiOsCritSectionDelete(state_ptr->memory_region_lock);
             CdiOsCritSectionDelete(state_ptr->connection_list_lock);
             CdiOsMemFree(state_ptr);
             state_ptr = NULL;
@@ -576,11 +667,17 @@ CdiReturnStatus ConnectionCommonResourcesCreate(CdiConnectionHandle handle, CdiC
     }
 
     if (kCdiStatusOk == rs) {
+        // Queue can block on pops. Tx connections that schedule payloads by deadline also push messages for the
+        // payloads they drop from the thread that packetizes them, in addition to the adapter's poll thread.
+        CdiQueueSignalMode signal_mode = kQueueSignalPopWait;
+        if (kHandleTypeTx == handle->handle_type && handle->tx_state.config_data.deadline_scheduling &&
+            !handle->tx_state.config_data.run_to_completion) {
+            signal_mode |= kQueueMultipleWritersFlag;
+        }
         // Create payload receive message queue that is used to send messages to the application callback thread.
         if (!CdiQueueCreate("PayloadRequests AppPayloadCallbackData Queue", MAX_PAYLOADS_PER_CONNECTION,
                             CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE, sizeof(AppPayloadCallbackData),
-                            kQueueSignalPopWait, // Queue can block on pops.
-                            &handle->app_payload_message_queue_handle)) {
+                            signal_mode, &handle->app_payload_message_queue_handle)) {
             rs = kCdiStatusNotEnoughMemory;
         }
     }
@@ -640,9 +737,14 @@ CdiReturnStatus ConnectionCommonPacketMessageThreadCreate(CdiConnectionHandle ha
 {
     CdiReturnStatus rs = kCdiStatusOk;
 
-    // Start the thread which will service items from the queue.
-    if (!CdiOsThreadCreate(AppCallbackPayloadThread, &handle->app_payload_message_thread_id, thread_name,
-                           handle, handle->start_signal)) {
+    if (cdi_global_context.worker_pool_handle) {
+        // Let the worker pool service items from the queue. The task only runs once items are pushed to the queue,
+        // which cannot happen before the connection has been started.
+        WorkerPoolTaskInit(cdi_global_context.worker_pool_handle, &handle->app_payload_message_task,
+                           AppCallbackPayloadTask, handle, handle->log_handle);
+    } else if (!CdiOsThreadCreate(AppCallbackPayloadThread, &handle->app_payload_message_thread_id, thread_name,
+                                  handle, handle->start_signal)) {
+        // Start the thread which will service items from the queue.
         rs = kCdiStatusNotEnoughMemory;
     }
 
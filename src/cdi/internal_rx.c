@@ -14,11 +14,13 @@
 // headers.
 #include "internal_rx.h"
 
+#include <inttypes.h>
 #include <string.h>
 
 #include "adapter_api.h"
 #include "cdi_logger_api.h"
 #include "cdi_pool_api.h"
+#include "completion_queue.h"
 #include "endpoint_manager.h"
 #include "internal.h"
 #include "private.h"
@@ -96,6 +98,34 @@ static void UpdatePayloadStats(CdiEndpointState* endpoint_ptr, RxPayloadWorkRequ
     StatsGatherPayloadStatsFromConnection(endpoint_ptr, kCdiStatusOk == app_payload_cb_data_ptr->payload_status_code,
                                           work_request_ptr->start_time, work_request_ptr->max_latency_microsecs,
                                           app_payload_cb_data_ptr->payload_sgl.total_data_size);
+
+    // Add the peak occupancy of the packet reorder window since the previous payload.
+    StatsGatherRxReorderWindowStats(endpoint_ptr, endpoint_ptr->rx_state.rxreorder_buffered_packet_count_max);
+    endpoint_ptr->rx_state.rxreorder_buffered_packet_count_max = endpoint_ptr->rx_state.rxreorder_buffered_packet_count;
+}
+
+/**
+ * Push a received payload to the completion queue configured for the connection. If the queue is full, the payload is
+ * dropped and its buffer is freed through RxEnqueueFreeBuffer(), just as if the application had freed it.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param event_type Type of event (kCdiCompletionEventRawRx or kCdiCompletionEventAvmRx).
+ * @param cb_data_ptr Pointer to the callback data that would otherwise be passed to the user-registered callback.
+ * @param payload_sgl_ptr Pointer to the payload SGL within the callback data.
+ */
+static void PushPayloadToCompletionQueue(CdiConnectionState* con_state_ptr, CdiCompletionEventType event_type,
+                                         const void* cb_data_ptr, const CdiSgList* payload_sgl_ptr)
+{
+    if (!CompletionQueuePush(con_state_ptr->rx_state.config_data.completion_queue_handle, event_type, cb_data_ptr)) {
+        CDI_LOG_THREAD(kLogError, "Completion queue full. Dropping payload.");
+        if (payload_sgl_ptr->internal_data_ptr) {
+            CdiReturnStatus rs = RxEnqueueFreeBuffer(payload_sgl_ptr);
+            if (kCdiStatusOk != rs) {
+                CDI_LOG_THREAD(kLogError, "Failed to free buffer of dropped payload. Reason[%s].",
+                               CdiCoreStatusToString(rs));
+            }
+        }
+    }
 }
 
 /**
@@ -119,8 +149,12 @@ static void InvokeRawPayloadCallback(CdiConnectionState* con_state_ptr, AppPaylo
     cb_data.core_cb_data = *core_cb_data_ptr;
     cb_data.sgl = app_cb_data_ptr->payload_sgl;
 
-    CdiRawRxCallback rx_raw_cb_ptr = (CdiRawRxCallback)con_state_ptr->rx_state.cb_ptr;
-    (rx_raw_cb_ptr)(&cb_data); // Call the user-registered Rx RAW callback function.
+    if (con_state_ptr->rx_state.config_data.completion_queue_handle) {
+        PushPayloadToCompletionQueue(con_state_ptr, kCdiCompletionEventRawRx, &cb_data, &cb_data.sgl);
+    } else {
+        CdiRawRxCallback rx_raw_cb_ptr = (CdiRawRxCallback)con_state_ptr->rx_state.cb_ptr;
+        (rx_raw_cb_ptr)(&cb_data); // Call the user-registered Rx RAW callback function.
+    }
 }
 
 /**
@@ -164,8 +198,12 @@ static void InvokeAvmPayloadCallback(CdiConnectionState* con_state_ptr, AppPaylo
     cb_data.core_cb_data = *core_cb_data_ptr;
     cb_data.sgl = app_cb_data_ptr->payload_sgl;
 
-    CdiAvmRxCallback rx_avm_cb_ptr = (CdiAvmRxCallback)con_state_ptr->rx_state.cb_ptr;
-    (rx_avm_cb_ptr)(&cb_data); // Call the user-registered Rx AVM callback function.
+    if (con_state_ptr->rx_state.config_data.completion_queue_handle) {
+        PushPayloadToCompletionQueue(con_state_ptr, kCdiCompletionEventAvmRx, &cb_data, &cb_data.sgl);
+    } else {
+        CdiAvmRxCallback rx_avm_cb_ptr = (CdiAvmRxCallback)con_state_ptr->rx_state.cb_ptr;
+        (rx_avm_cb_ptr)(&cb_data); // Call the user-registered Rx AVM callback function.
+    }
 }
 
 /**
@@ -277,6 +315,10 @@ static bool InitializePayloadState(CdiProtocolHandle protocol_handle, CdiEndpoin
         payload_state_ptr->data_bytes_received = 0;
         payload_state_ptr->expected_payload_data_size = 0;
         payload_state_ptr->reorder_list_ptr = NULL;
+        payload_state_ptr->reorder_bitmap_ptr = NULL;
+        payload_state_ptr->progress_byte_count = 0;
+        payload_state_ptr->progress_reported_byte_count = 0;
+        payload_state_ptr->progress_range_count = 0;
 
         if (0 == packet_sequence_num) {
             UpdatePayloadStateDataFromCDIPacket0(payload_state_ptr, header_ptr);
@@ -287,7 +329,14 @@ static bool InitializePayloadState(CdiProtocolHandle protocol_handle, CdiEndpoin
             payload_state_ptr->payload_num = header_ptr->payload_num;
         }
 
-        if (kCdiLinearBuffer == con_state_ptr->rx_state.config_data.rx_buffer_type) {
+        memory_state_ptr->linear_state.rma_slot = false;
+        if (kCdiLinearBuffer == con_state_ptr->rx_state.config_data.rx_buffer_type &&
+            NULL != packet_ptr->rma_slot_entry_ptr && 0 == packet_sequence_num) {
+            // The transmitter has already written the payload's data into a receive buffer slot of the adapter, so use
+            // the slot as the payload's linear buffer. See RxPacketReceive().
+            payload_state_ptr->linear_buffer_ptr = packet_ptr->rma_slot_entry_ptr->address_ptr;
+            memory_state_ptr->linear_state.rma_slot = true;
+        } else if (kCdiLinearBuffer == con_state_ptr->rx_state.config_data.rx_buffer_type) {
             if (!CdiPoolGet(con_state_ptr->linear_buffer_pool, (void*)&payload_state_ptr->linear_buffer_ptr)) {
                 payload_state_ptr->linear_buffer_ptr = NULL;
                 BACK_PRESSURE_ERROR(con_state_ptr->back_pressure_state, kLogError,
@@ -303,6 +352,8 @@ static bool InitializePayloadState(CdiProtocolHandle protocol_handle, CdiEndpoin
             ret = RxReorderPacketPayloadStateInit(protocol_handle,
                                                   con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
                                                   con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                                  con_state_ptr->rx_state.reorder_bitmap_pool_handle,
+                                                  con_state_ptr->rx_state.reorder_bitmap_block_pool_handle,
                                                   payload_state_ptr, &packet_ptr->sg_list,
                                                   header_ptr->encoded_header_size, packet_sequence_num);
         }
@@ -355,6 +406,52 @@ static bool CopyToLinearBuffer(CdiConnectionState* con_state_ptr, const Packet*
     return ret;
 }
 
+/**
+ * Account for the data of a payload that the transmitter wrote directly into the receive buffer slot being used as its
+ * linear buffer. The packet itself only contains the CDI header of packet #0 and is sent once all of the payload's
+ * data has been written.
+ *
+ * @param endpoint_ptr Pointer to endpoint state structure.
+ * @param payload_state_ptr Pointer to payload structure being updated.
+ *
+ * @return true if the function completed successfully, false if a problem was encountered.
+ */
+static bool PlacedInLinearBuffer(CdiEndpointState* endpoint_ptr, RxPayloadState* payload_state_ptr)
+{
+    bool ret = true;
+    CdiConnectionState* con_state_ptr = endpoint_ptr->connection_state_ptr;
+
+    uint64_t linear_buffer_size = con_state_ptr->rx_state.config_data.linear_buffer_size;
+    if (payload_state_ptr->expected_payload_data_size < 0 ||
+        (uint64_t)payload_state_ptr->expected_payload_data_size > linear_buffer_size) {
+        PAYLOAD_ERROR(con_state_ptr, &payload_state_ptr->work_request_state.app_payload_cb_data,
+                      kCdiStatusBufferOverflow, "Placed payload data size[%d] exceeds linear buffer size[%d].",
+                      payload_state_ptr->expected_payload_data_size, linear_buffer_size);
+        ret = false;
+    } else {
+        payload_state_ptr->data_bytes_received = payload_state_ptr->expected_payload_data_size;
+        CdiOsAtomicInc64(&endpoint_ptr->transfer_stats.payload_counter_stats.num_payloads_rma_placed);
+    }
+
+    return ret;
+}
+
+/**
+ * Return the receive buffer slot entry of a packet to the adapter if it was not taken over by a payload.
+ *
+ * @param endpoint_ptr Pointer to endpoint state structure.
+ * @param packet_ptr Pointer to the packet that was received.
+ */
+static void FreeRmaSlotEntry(CdiEndpointState* endpoint_ptr, Packet* packet_ptr)
+{
+    if (packet_ptr->rma_slot_entry_ptr) {
+        CdiSgList slot_sgl = { 0 };
+        SglAppend(&slot_sgl, packet_ptr->rma_slot_entry_ptr);
+        CdiAdapterFreeBuffer(endpoint_ptr->adapter_endpoint_ptr, &slot_sgl);
+        packet_ptr->rma_slot_entry_ptr = NULL;
+    }
+}
+
 /**
  * Free payload memory state.
  *
@@ -390,9 +487,12 @@ static void FreePayloadBuffer(CdiSgList* sgl_ptr)
         CdiConnectionState* con_state_ptr = memory_state_ptr->cdi_endpoint_handle->connection_state_ptr;
 
         if (kCdiLinearBuffer == memory_state_ptr->buffer_type) {
-            // Return the linear buffer to its pool; its address is in the singular SGL entry.
+            // Return the linear buffer to its pool; its address is in the singular SGL entry. An RMA slot is returned
+            // to the adapter along with the payload's packet buffers instead.
             if (sgl_ptr->sgl_head_ptr && sgl_ptr->sgl_head_ptr->address_ptr) {
-                CdiPoolPut(con_state_ptr->linear_buffer_pool, sgl_ptr->sgl_head_ptr->address_ptr);
+                if (!memory_state_ptr->linear_state.rma_slot) {
+                    CdiPoolPut(con_state_ptr->linear_buffer_pool, sgl_ptr->sgl_head_ptr->address_ptr);
+                }
                 sgl_ptr->sgl_head_ptr->address_ptr = NULL; // Pointer is no longer valid, so clear it.
             }
         }
@@ -446,38 +546,29 @@ static bool FinalizePayload(CdiConnectionState* con_state_ptr, RxPayloadState* p
     // If the above logic fails, we still want to execute this logic to provide possible additional error information
     // and to free resources used.
     if (kCdiSgl == con_state_ptr->rx_state.config_data.rx_buffer_type) {
-        // If all data received, then there can only be one list and the next and prev pointers must be NULL.
-        if (payload_state_ptr->reorder_list_ptr->next_ptr || payload_state_ptr->reorder_list_ptr->prev_ptr) {
-            CDI_LOG_THREAD(kLogError, "All payload data received but there are unattached lists present.");
+        // If all data received, then the packets must form a single SGL.
+        CdiSgList* sgl_ptr = &app_payload_cb_data_ptr->payload_sgl;
+        if (!RxReorderPacketPayloadSglGet(con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                          con_state_ptr->rx_state.reorder_bitmap_pool_handle,
+                                          con_state_ptr->rx_state.reorder_bitmap_block_pool_handle, payload_state_ptr,
+                                          sgl_ptr)) {
+            CDI_LOG_THREAD(kLogError, "All payload data received but there are unattached packets present.");
             CDI_LOG_THREAD(kLogError, "Throwing away this payload[%d]. Timestamp[%u:%u] Expected Size[%d] Received[%d]",
                            payload_state_ptr->payload_num,
                            app_payload_cb_data_ptr->core_extra_data.origination_ptp_timestamp.seconds,
                            app_payload_cb_data_ptr->core_extra_data.origination_ptp_timestamp.nanoseconds,
                            payload_state_ptr->expected_payload_data_size, payload_state_ptr->data_bytes_received);
-#ifdef DEBUG_RX_REORDER_ERROR
-             CdiReorderList* reorder_list_ptr = payload_state_ptr->reorder_list_ptr;
-             while (reorder_list_ptr) {
-                 CDI_LOG_THREAD(kLogError, "Unattached list [%d-%d].", reorder_list_ptr->top_sequence_num,
-                                reorder_list_ptr->bot_sequence_num);
-                 reorder_list_ptr = reorder_list_ptr->next_ptr;
-             }
-#endif
             // Return the memory space back to the respective pools.
-            RxReorderPacketFreeLists(payload_state_ptr->reorder_list_ptr,
-                                     con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
-                                     con_state_ptr->rx_state.reorder_entries_pool_handle);
+            RxReorderPacketPayloadStateFree(con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
+                                            con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                            con_state_ptr->rx_state.reorder_bitmap_pool_handle,
+                                            con_state_ptr->rx_state.reorder_bitmap_block_pool_handle,
+                                            payload_state_ptr);
             ret = false;
         } else {
-            // Update SGL's total data size and pointers.
-            CdiSgList* sgl_ptr = &app_payload_cb_data_ptr->payload_sgl;
+            // Update SGL's total data size.
             sgl_ptr->total_data_size = payload_state_ptr->data_bytes_received;
-            sgl_ptr->sgl_head_ptr = payload_state_ptr->reorder_list_ptr->sglist.sgl_head_ptr;
-            sgl_ptr->sgl_tail_ptr = payload_state_ptr->reorder_list_ptr->sglist.sgl_tail_ptr;
-
-            // Free the reorder list memory entry.
-            CdiPoolPut(con_state_ptr->rx_state.reorder_entries_pool_handle, payload_state_ptr->reorder_list_ptr);
         }
-        payload_state_ptr->reorder_list_ptr = NULL; // List freed by both cases above and no longer valid, so clear it.
     } else {
         // If the linear buffer pointer is NULL, the packets for this payload were dropped into the bit bucket.
         // Send this condition on through the pipeline.
@@ -543,9 +634,13 @@ static void QueueBackPressurePayloadToApp(CdiConnectionState* con_state_ptr, Cdi
     CdiOsAtomicInc64(&endpoint_ptr->transfer_stats.payload_counter_stats.num_payloads_dropped);
 
     // Place the callback data in the queue to be sent to the application.
-    if (!CdiQueuePush(con_state_ptr->rx_state.active_payload_complete_queue_handle, (void*)&cb_data)) {
+    if (con_state_ptr->rx_state.config_data.run_to_completion) {
+        RxInvokeAppPayloadCallbackInline(endpoint_ptr, &cb_data);
+    } else if (!CdiQueuePush(con_state_ptr->rx_state.active_payload_complete_queue_handle, (void*)&cb_data)) {
         CDI_LOG_THREAD(kLogError, "Queue[%s] full, push failed.",
                        CdiQueueGetName(con_state_ptr->rx_state.active_payload_complete_queue_handle));
+    } else {
+        WorkerPoolTaskSchedule(&con_state_ptr->app_payload_message_task); // Does nothing if worker pool not in use.
     }
 }
 
@@ -591,6 +686,28 @@ CdiReturnStatus RxCreateInternal(CdiConnectionProtocolType protocol_type, CdiRxC
         }
     }
 
+    if (NULL == rx_cb_ptr && NULL == config_data_ptr->completion_queue_handle) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Either an Rx callback function or a completion queue must be specified.");
+        rs = kCdiStatusInvalidParameter;
+    }
+
+    if (kCdiStatusOk != RxRunToCompletionConfigResolve(&con_state_ptr->rx_state.config_data)) {
+        rs = kCdiStatusInvalidParameter;
+    }
+
+    if (config_data_ptr->progress_step_bytes < 0) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Progress step specified[%d] bytes is a negative value.", config_data_ptr->progress_step_bytes);
+        rs = kCdiStatusInvalidParameter;
+    } else if (0 == config_data_ptr->progress_step_bytes) {
+        con_state_ptr->rx_state.config_data.progress_step_bytes = CDI_RX_PROGRESS_DEFAULT_STEP_BYTES;
+    }
+
+    if (kCdiStatusOk == rs) {
+        rs = RxReorderConfigResolve(&con_state_ptr->rx_state.config_data);
+    }
+
     // This log will be used by all the threads created for this connection.
     if (kCdiStatusOk == rs) {
         if (kLogMethodFile == config_data_ptr->connection_log_method_data_ptr->log_method) {
@@ -612,6 +729,10 @@ CdiReturnStatus RxCreateInternal(CdiConnectionProtocolType protocol_type, CdiRxC
             CDI_LOG_HANDLE(con_state_ptr->log_handle, kLogInfo, "Using Rx buffer delay[%d]ms.",
                            con_state_ptr->rx_state.config_data.buffer_delay_ms);
         }
+        if (con_state_ptr->rx_state.config_data.run_to_completion) {
+            CDI_LOG_HANDLE(con_state_ptr->log_handle, kLogInfo, "Using Rx run to completion. Callback budget[%d]us.",
+                           con_state_ptr->rx_state.config_data.run_to_completion_budget_us);
+        }
     }
 
     // Copy the name for the connection from the config data or generate one. NOTE: Do this here, since other logic
@@ -654,7 +775,8 @@ CdiReturnStatus RxCreateInternal(CdiConnectionProtocolType protocol_type, CdiRxC
     }
 
     if (kCdiStatusOk == rs) {
-        if (!CdiPoolCreate("Rx CdiReorderList Out of Order Pool", MAX_RX_OUT_OF_ORDER,
+        if (!CdiPoolCreate("Rx CdiReorderList Out of Order Pool",
+                           con_state_ptr->rx_state.config_data.reorder_list_pool_size,
                            MAX_RX_OUT_OF_ORDER_GROW, MAX_POOL_GROW_COUNT,
                            sizeof(CdiReorderList), true, // true= Make thread-safe
                            &con_state_ptr->rx_state.reorder_entries_pool_handle)) {
@@ -662,6 +784,23 @@ CdiReturnStatus RxCreateInternal(CdiConnectionProtocolType protocol_type, CdiRxC
         }
     }
 
+    if (kCdiStatusOk == rs && kCdiSgl == config_data_ptr->rx_buffer_type) {
+        if (!CdiPoolCreate("Rx RxReorderBitmap Pool", RX_REORDER_BITMAP_POOL_SIZE, RX_REORDER_BITMAP_POOL_GROW,
+                           MAX_POOL_GROW_COUNT, sizeof(RxReorderBitmap), true, // true= Make thread-safe
+                           &con_state_ptr->rx_state.reorder_bitmap_pool_handle)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs && kCdiSgl == config_data_ptr->rx_buffer_type) {
+        if (!CdiPoolCreate("Rx RxReorderBitmapBlock Pool", RX_REORDER_BITMAP_BLOCK_POOL_SIZE,
+                           RX_REORDER_BITMAP_BLOCK_POOL_GROW, MAX_POOL_GROW_COUNT, sizeof(RxReorderBitmapBlock),
+                           true, // true= Make thread-safe
+                           &con_state_ptr->rx_state.reorder_bitmap_block_pool_handle)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
     if (kCdiStatusOk == rs && kCdiLinearBuffer == config_data_ptr->rx_buffer_type) {
         // Allocate an extra couple of buffers for payloads being reassembled.
         if (!CdiPoolCreate("Rx Linear Buffer Pool", RX_LINEAR_BUFFER_COUNT + 2, NO_GROW_SIZE, NO_GROW_COUNT,
@@ -676,6 +815,7 @@ CdiReturnStatus RxCreateInternal(CdiConnectionProtocolType protocol_type, CdiRxC
             rs = RxBufferInit(con_state_ptr->log_handle, con_state_ptr->error_message_pool,
                               con_state_ptr->rx_state.config_data.buffer_delay_ms, max_rx_payloads,
                               con_state_ptr->app_payload_message_queue_handle,
+                              &con_state_ptr->app_payload_message_task,
                               &con_state_ptr->rx_state.receive_buffer_handle,
                               &con_state_ptr->rx_state.active_payload_complete_queue_handle);
         } else {
@@ -688,8 +828,9 @@ CdiReturnStatus RxCreateInternal(CdiConnectionProtocolType protocol_type, CdiRxC
     // NOTE: The pools at rx_state.rx_payload_state_pool_handle and rx_state.payload_memory_state_pool_handle are
     // created dynamically in RxEndpointCreateDynamicPools() based on the protocol version being used.
 
-    if (kCdiStatusOk == rs) {
-        // Create a packet message thread that is used by both Tx and Rx connections.
+    if (kCdiStatusOk == rs && !con_state_ptr->rx_state.config_data.run_to_completion) {
+        // Create a packet message thread that is used by both Tx and Rx connections. Not needed when running to
+        // completion, since payloads are then sent to the application directly from the poll thread.
         rs = ConnectionCommonPacketMessageThreadCreate(con_state_ptr, "Rx:PayloadMessage");
     }
 
@@ -710,6 +851,13 @@ CdiReturnStatus RxCreateInternal(CdiConnectionProtocolType protocol_type, CdiRxC
 
             .direction = kEndpointDirectionReceive,
             .rx_state.reserve_packet_buffers = reserve_packet_buffers,
+            .rx_state.rma_slot_size = (kCdiLinearBuffer == config_data_ptr->rx_buffer_type &&
+                                       config_data_ptr->rma_direct_placement &&
+                                       config_data_ptr->linear_buffer_size <= UINT32_MAX) ?
+                                      (uint32_t)config_data_ptr->linear_buffer_size : 0,
+            .rx_state.multi_receive_buffers = config_data_ptr->multi_receive_buffers,
+            .rx_state.shared_completion_queue = config_data_ptr->shared_completion_queue,
+            .rx_state.shared_packet_quota = CDI_MAX(config_data_ptr->shared_rx_packet_quota, 0),
 
             // This endpoint is used for normal data transmission (not used for control). This means that the Endpoint
             // Manager is used for managing threads related to the connection.
@@ -793,7 +941,7 @@ void RxEndpointFlushResources(CdiEndpointState* endpoint_ptr)
     if (endpoint_ptr) {
         // Walk through the list of payload state data and see if any payloads were in the process of being received. If
         // so, set an error.
-        for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(endpoint_ptr->rx_state.payload_state_array_ptr); i++) {
+        for (int i = 0; i < endpoint_ptr->rx_state.payload_state_array_size; i++) {
             RxPayloadState* payload_state_ptr = endpoint_ptr->rx_state.payload_state_array_ptr[i];
             if (payload_state_ptr) {
                 if (kPayloadIdle != payload_state_ptr->payload_state &&
@@ -808,10 +956,13 @@ void RxEndpointFlushResources(CdiEndpointState* endpoint_ptr)
             }
         }
         endpoint_ptr->rx_state.rxreorder_buffered_packet_count = 0; // Reset packet count window.
+        endpoint_ptr->rx_state.rxreorder_buffered_packet_count_max = 0;
 
         // Entries used by the connection pools below are not freed here. They are either freed in the logic above or
         // by the application:
         //   rx_state.reorder_entries_pool_handle
+        //   rx_state.reorder_bitmap_pool_handle
+        //   rx_state.reorder_bitmap_block_pool_handle
         //   rx_state.payload_sgl_entry_pool_handle
         //   rx_state.payload_memory_state_pool_handle
 
@@ -845,6 +996,16 @@ void RxConnectionDestroyInternal(CdiConnectionHandle con_handle)
         CdiPoolDestroy(con_state_ptr->linear_buffer_pool);
         con_state_ptr->linear_buffer_pool = NULL;
 
+        // Destroying the connection, so ensure all pool entries are freed.
+        CdiPoolPutAll(con_state_ptr->rx_state.reorder_bitmap_pool_handle);
+        CdiPoolDestroy(con_state_ptr->rx_state.reorder_bitmap_pool_handle);
+        con_state_ptr->rx_state.reorder_bitmap_pool_handle = NULL;
+
+        // Destroying the connection, so ensure all pool entries are freed.
+        CdiPoolPutAll(con_state_ptr->rx_state.reorder_bitmap_block_pool_handle);
+        CdiPoolDestroy(con_state_ptr->rx_state.reorder_bitmap_block_pool_handle);
+        con_state_ptr->rx_state.reorder_bitmap_block_pool_handle = NULL;
+
         // Destroying the connection, so ensure all pool entries are freed.
         CdiPoolPutAll(con_state_ptr->rx_state.reorder_entries_pool_handle);
         CdiPoolDestroy(con_state_ptr->rx_state.reorder_entries_pool_handle);
@@ -870,6 +1031,12 @@ void RxEndpointDestroy(CdiEndpointHandle handle)
     if (endpoint_ptr) {
         CdiQueueDestroy(endpoint_ptr->rx_state.free_buffer_queue_handle);
         endpoint_ptr->rx_state.free_buffer_queue_handle = NULL;
+
+        if (endpoint_ptr->rx_state.payload_state_array_ptr) {
+            CdiOsMemFree(endpoint_ptr->rx_state.payload_state_array_ptr);
+            endpoint_ptr->rx_state.payload_state_array_ptr = NULL;
+            endpoint_ptr->rx_state.payload_state_array_size = 0;
+        }
     }
 }
 
@@ -888,6 +1055,7 @@ void RxPacketReceive(void* param_ptr, Packet* packet_ptr, EndpointMessageType me
                        con_state_ptr->saved_connection_name_str);
         // Free the buffer and return. No need to flow through all the logic below.
         CdiAdapterFreeBuffer(endpoint_ptr->adapter_endpoint_ptr, &packet_ptr->sg_list);
+        FreeRmaSlotEntry(endpoint_ptr, packet_ptr);
         return;
     }
 
@@ -930,7 +1098,7 @@ void RxPacketReceive(void* param_ptr, Packet* packet_ptr, EndpointMessageType me
         }
 
         // If we have received a packet for a payload that is marked ignore, we will ignore incoming packets for it
-        // until we have received CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW packets since the payload was set to ignore.
+        // until we have received packet_reorder_window packets since the payload was set to ignore.
         if (kPayloadIgnore == payload_state_ptr->payload_state &&
             RxReorderPayloadIsStale(endpoint_ptr, payload_state_ptr)) {
             // Payload state data is stale, so ok to re-use it now.
@@ -943,6 +1111,14 @@ void RxPacketReceive(void* param_ptr, Packet* packet_ptr, EndpointMessageType me
         still_ok = (kPayloadIdle == payload_state_ptr->payload_state ||
                     kPayloadInProgress == payload_state_ptr->payload_state ||
                     kPayloadPacketZeroPending == payload_state_ptr->payload_state);
+
+        // The data of a payload placed in a receive buffer slot is never sent in packets, so packets of the payload
+        // can't have been received before the one that completes it.
+        if (still_ok && packet_ptr->rma_slot_entry_ptr && kPayloadIdle != payload_state_ptr->payload_state) {
+            CDI_LOG_THREAD(kLogError, "Connection[%s] Received placed payload[%d] that is already in progress.",
+                           con_state_ptr->saved_connection_name_str, payload_num);
+            still_ok = false;
+        }
     }
 
     // Check if we are receiving a new payload.
@@ -952,6 +1128,12 @@ void RxPacketReceive(void* param_ptr, Packet* packet_ptr, EndpointMessageType me
             // Create state data for a new payload.
             still_ok = InitializePayloadState(protocol_handle, endpoint_ptr, packet_ptr, payload_state_ptr,
                                               &decoded_header, &payload_memory_state_ptr);
+            if (still_ok && payload_memory_state_ptr->linear_state.rma_slot) {
+                // The slot is the payload's linear buffer now. Keep its entry with the payload's packet buffers, so it
+                // is returned to the adapter when the payload is freed.
+                SglAppend(&payload_memory_state_ptr->endpoint_packet_buffer_sgl, packet_ptr->rma_slot_entry_ptr);
+                packet_ptr->rma_slot_entry_ptr = NULL;
+            }
         } else {
             if (kPayloadPacketZeroPending == payload_state_ptr->payload_state &&
                 0 == packet_sequence_num) {
@@ -965,7 +1147,9 @@ void RxPacketReceive(void* param_ptr, Packet* packet_ptr, EndpointMessageType me
                 // The packet reordering logic does not need to be invoked if the connection was configured for a linear
                 // receive buffer.
                 still_ok = RxReorderPacket(protocol_handle, con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
-                                           con_state_ptr->rx_state.reorder_entries_pool_handle, payload_state_ptr,
+                                           con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                           con_state_ptr->rx_state.reorder_bitmap_pool_handle,
+                                           con_state_ptr->rx_state.reorder_bitmap_block_pool_handle, payload_state_ptr,
                                            &packet_ptr->sg_list, cdi_header_size, packet_sequence_num);
             }
         }
@@ -973,8 +1157,16 @@ void RxPacketReceive(void* param_ptr, Packet* packet_ptr, EndpointMessageType me
 
     if (still_ok && kCdiLinearBuffer == con_state_ptr->rx_state.config_data.rx_buffer_type) {
         assert(NULL != payload_state_ptr->linear_buffer_ptr);
-        // Gather this packet into the linear receive buffer.
-        still_ok = CopyToLinearBuffer(con_state_ptr, packet_ptr, payload_state_ptr, &decoded_header);
+        if (payload_memory_state_ptr->linear_state.rma_slot) {
+            still_ok = PlacedInLinearBuffer(endpoint_ptr, payload_state_ptr);
+        } else {
+            // Gather this packet into the linear receive buffer.
+            still_ok = CopyToLinearBuffer(con_state_ptr, packet_ptr, payload_state_ptr, &decoded_header);
+        }
+    }
+
+    if (still_ok && con_state_ptr->rx_state.config_data.progress_cb_ptr) {
+        RxProgressUpdate(con_state_ptr, packet_ptr, payload_state_ptr, &decoded_header);
     }
 
     if (!still_ok && payload_state_ptr &&
@@ -1013,13 +1205,17 @@ void RxPacketReceive(void* param_ptr, Packet* packet_ptr, EndpointMessageType me
         // The SGL passed in to the function was not consumed. Send it back to the adapter now.
         CdiAdapterFreeBuffer(endpoint_ptr->adapter_endpoint_ptr, &packet_ptr->sg_list);
     }
+    FreeRmaSlotEntry(endpoint_ptr, packet_ptr);
 
     if (still_ok) {
         payload_state_ptr->last_total_packet_count = endpoint_ptr->rx_state.total_packet_count;
         payload_state_ptr->packet_count++;
 
         // Packet is ok (no errors), so increment Rx reorder buffered packet counter.
-        endpoint_ptr->rx_state.rxreorder_buffered_packet_count++;
+        int buffered_packet_count = ++endpoint_ptr->rx_state.rxreorder_buffered_packet_count;
+        if (buffered_packet_count > endpoint_ptr->rx_state.rxreorder_buffered_packet_count_max) {
+            endpoint_ptr->rx_state.rxreorder_buffered_packet_count_max = buffered_packet_count;
+        }
     } else if (kCdiBackPressureActive == con_state_ptr->back_pressure_state) {
         QueueBackPressurePayloadToApp(con_state_ptr, endpoint_ptr, &decoded_header);
     }
@@ -1037,8 +1233,15 @@ void RxSendPayload(CdiEndpointState* endpoint_ptr, RxPayloadState* payload_state
     // Update payload statistics data.
     UpdatePayloadStats(endpoint_ptr, &payload_state_ptr->work_request_state);
 
-    // Add the Rx payload SGL message to the AppCallbackPayloadThread() queue.
-    if (!CdiQueuePush(con_state_ptr->rx_state.active_payload_complete_queue_handle,
+    // Add the Rx payload SGL message to the AppCallbackPayloadThread() queue or, if running to completion, send it to
+    // the application directly from this thread.
+    if (con_state_ptr->rx_state.config_data.run_to_completion) {
+        // Send the payload to the application from this thread. Pass a copy of app_payload_cb_data, like the queue
+        // does, and set the error message pointer to NULL here since the buffer is freed after the callback returns.
+        AppPayloadCallbackData app_cb_data = payload_state_ptr->work_request_state.app_payload_cb_data;
+        payload_state_ptr->work_request_state.app_payload_cb_data.error_message_str = NULL;
+        RxInvokeAppPayloadCallbackInline(endpoint_ptr, &app_cb_data);
+    } else if (!CdiQueuePush(con_state_ptr->rx_state.active_payload_complete_queue_handle,
                       (void*)&payload_state_ptr->work_request_state.app_payload_cb_data)) {
         CDI_LOG_THREAD(kLogError, "[%s] full, payload push failed.  Application callback might be too slow.",
                        CdiQueueGetName(con_state_ptr->rx_state.active_payload_complete_queue_handle));
@@ -1054,6 +1257,7 @@ void RxSendPayload(CdiEndpointState* endpoint_ptr, RxPayloadState* payload_state
         // Queue passes a copy of app_payload_cb_data to AppCallbackPayloadThread(), which frees the buffer. So
         // set the pointer to NULL here, so it doesn't get re-used.
         payload_state_ptr->work_request_state.app_payload_cb_data.error_message_str = NULL;
+        WorkerPoolTaskSchedule(&con_state_ptr->app_payload_message_task); // Does nothing if worker pool not in use.
     }
 }
 
@@ -1079,11 +1283,11 @@ void RxFreePayloadResources(CdiEndpointState* endpoint_ptr, RxPayloadState* payl
         memory_state_ptr = NULL;
     }
 
-    // Free Rx-reorder lists.
-    RxReorderPacketFreeLists(payload_state_ptr->reorder_list_ptr,
-                             con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
-                             con_state_ptr->rx_state.reorder_entries_pool_handle);
-    payload_state_ptr->reorder_list_ptr = NULL; // List freed and no longer valid, so clear it.
+    // Free Rx-reorder lists or bitmap.
+    RxReorderPacketPayloadStateFree(con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
+                                    con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                    con_state_ptr->rx_state.reorder_bitmap_pool_handle,
+                                    con_state_ptr->rx_state.reorder_bitmap_block_pool_handle, payload_state_ptr);
 
     // Clear SGL sent to application's Rx callback. Don't clear internal_data_ptr here (see logic above).
     app_payload_cb_data_ptr->payload_sgl.sgl_head_ptr = NULL;
@@ -1112,37 +1316,84 @@ void RxInvokeAppPayloadCallback(CdiConnectionState* con_state_ptr, AppPayloadCal
     }
 }
 
+void RxInvokeAppPayloadCallbackInline(CdiEndpointState* endpoint_ptr, AppPayloadCallbackData* app_cb_data_ptr)
+{
+    CdiConnectionState* con_state_ptr = endpoint_ptr->connection_state_ptr;
+    uint64_t start_time_us = CdiOsGetMicroseconds();
+
+    RxInvokeAppPayloadCallback(con_state_ptr, app_cb_data_ptr);
+    // If error message exists, return it to pool.
+    PayloadErrorFreeBuffer(con_state_ptr->error_message_pool, app_cb_data_ptr);
+
+    uint64_t elapsed_time_us = CdiOsGetMicroseconds() - start_time_us;
+    if (elapsed_time_us > (uint64_t)con_state_ptr->rx_state.config_data.run_to_completion_budget_us) {
+        // Only this thread writes the counter, but the stats thread reads it so use an atomic operation.
+        uint64_t over_budget_count =
+            CdiOsAtomicInc64(&endpoint_ptr->transfer_stats.payload_counter_stats.num_callbacks_over_budget);
+        if (1 == over_budget_count % RX_RUN_TO_COMPLETION_WARNING_INTERVAL) {
+            CDI_LOG_THREAD(kLogWarning, "Rx payload callback took[%"PRIu64"]us exceeding budget[%d]us. "
+                           "Count[%"PRIu64"].", elapsed_time_us,
+                           con_state_ptr->rx_state.config_data.run_to_completion_budget_us, over_budget_count);
+        }
+    }
+}
+
 CdiReturnStatus RxEnqueueFreeBuffer(const CdiSgList* sgl_ptr)
+{
+    return RxEnqueueFreeBuffers(&sgl_ptr, 1);
+}
+
+CdiReturnStatus RxEnqueueFreeBuffers(const CdiSgList* sgl_ptr_array[], int count)
 {
     // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
 
     CdiReturnStatus rs = kCdiStatusOk;
-    CdiMemoryState* memory_state_ptr = (CdiMemoryState*)sgl_ptr->internal_data_ptr;
-    CdiConnectionState* con_state_ptr = memory_state_ptr->cdi_connection_handle;
-
-    // Get thread-safe access to endpoint resources. Users can free buffers here while internally an endpoint is being
-    // destroyed via DestroyEndpoint().
-    CdiOsCritSectionReserve(con_state_ptr->adapter_connection_ptr->endpoint_lock);
-
-    // Only use the endpoint if it is valid (has not been dynamically deleted).
-    CdiEndpointState* endpoint_ptr = memory_state_ptr->cdi_endpoint_handle;
-    if (EndpointManagerIsEndpoint(con_state_ptr->endpoint_manager_handle, endpoint_ptr)) {
-        if (kCdiConnectionStatusConnected != endpoint_ptr->adapter_endpoint_ptr->connection_status_code) {
-            // Currently not connected, so no need to free pending resources. All resources have already been freed
-            // internally when the connection was disconnected.
-            return kCdiStatusOk;
+    int index = 0;
+    while (index < count) {
+        // Skip internally generated empty SGLs.
+        if (sgl_ptr_array[index]->sgl_head_ptr == &cdi_global_context.empty_sgl_entry) {
+            index++;
+            continue;
         }
-        if (kHandleTypeRx != endpoint_ptr->connection_state_ptr->handle_type) {
-            return kCdiStatusWrongDirection;
+
+        // Gather consecutive SGLs that belong to the same endpoint, so they can be pushed using a single queue
+        // operation.
+        CdiMemoryState* memory_state_ptr = (CdiMemoryState*)sgl_ptr_array[index]->internal_data_ptr;
+        CdiConnectionState* con_state_ptr = memory_state_ptr->cdi_connection_handle;
+        CdiEndpointState* endpoint_ptr = memory_state_ptr->cdi_endpoint_handle;
+        CdiSgList sgl_array[MAX_RX_FREE_BUFFER_BATCH_SIZE];
+        int sgl_count = 0;
+        while (index < count && sgl_count < MAX_RX_FREE_BUFFER_BATCH_SIZE) {
+            const CdiSgList* sgl_ptr = sgl_ptr_array[index];
+            if (sgl_ptr->sgl_head_ptr != &cdi_global_context.empty_sgl_entry) {
+                if (endpoint_ptr != ((CdiMemoryState*)sgl_ptr->internal_data_ptr)->cdi_endpoint_handle) {
+                    break;
+                }
+                sgl_array[sgl_count++] = *sgl_ptr;
+            }
+            index++;
         }
 
-        // Add the free buffer message into the Rx free buffer queue processing by PollThread().
-        if (!CdiQueuePush(endpoint_ptr->rx_state.free_buffer_queue_handle, sgl_ptr)) {
-            rs = kCdiStatusQueueFull;
+        // Get thread-safe access to endpoint resources. Users can free buffers here while internally an endpoint is
+        // being destroyed via DestroyEndpoint().
+        CdiOsCritSectionReserve(con_state_ptr->adapter_connection_ptr->endpoint_lock);
+
+        // Only use the endpoint if it is valid (has not been dynamically deleted).
+        if (EndpointManagerIsEndpoint(con_state_ptr->endpoint_manager_handle, endpoint_ptr)) {
+            if (kCdiConnectionStatusConnected != endpoint_ptr->adapter_endpoint_ptr->connection_status_code) {
+                // Currently not connected, so no need to free pending resources. All resources have already been
+                // freed internally when the connection was disconnected.
+            } else if (kHandleTypeRx != endpoint_ptr->connection_state_ptr->handle_type) {
+                rs = (kCdiStatusOk == rs) ? kCdiStatusWrongDirection : rs;
+            } else if (CdiQueuePushBatch(endpoint_ptr->rx_state.free_buffer_queue_handle, sgl_array, sgl_count) <
+                       sgl_count) {
+                // Add the free buffer messages into the Rx free buffer queue processed by PollThread().
+                rs = (kCdiStatusOk == rs) ? kCdiStatusQueueFull : rs;
+            }
         }
-    }
 
-    CdiOsCritSectionRelease(con_state_ptr->adapter_connection_ptr->endpoint_lock);
+        CdiOsCritSectionRelease(con_state_ptr->adapter_connection_ptr->endpoint_lock);
+    }
 
     return rs;
 }
@@ -1179,3 +1430,127 @@ bool RxPollFreeBuffer(void* param_ptr, CdiSgList* ret_packet_buffer_sgl_ptr)
 
     return ret;
 }
+
+void RxProgressUpdate(CdiConnectionState* con_state_ptr, const Packet* packet_ptr,
+                      RxPayloadState* payload_state_ptr, const CdiDecodedPacketHeader* header_ptr)
+{
+    // Packet #0 is the only one without a data offset and it is always at the start of the payload.
+    const int start_offset = (kPayloadTypeDataOffset == header_ptr->payload_type) ?
+                             (int)header_ptr->data_offset_info.payload_data_offset : 0;
+    const int end_offset = start_offset + packet_ptr->sg_list.total_data_size - header_ptr->encoded_header_size;
+
+    if (start_offset == payload_state_ptr->progress_byte_count) {
+        // The packet extends the part received with no gaps. So may ranges that were received ahead of it.
+        payload_state_ptr->progress_byte_count = end_offset;
+        RxProgressRange* range_array = payload_state_ptr->progress_range_array;
+        int i = 0;
+        while (i < payload_state_ptr->progress_range_count) {
+            if (range_array[i].start_offset == payload_state_ptr->progress_byte_count) {
+                payload_state_ptr->progress_byte_count = range_array[i].end_offset;
+                range_array[i] = range_array[--payload_state_ptr->progress_range_count];
+                i = 0; // The range that was moved here or an earlier one may follow now.
+            } else {
+                i++;
+            }
+        }
+    } else if (start_offset > payload_state_ptr->progress_byte_count &&
+               payload_state_ptr->progress_range_count < RX_PROGRESS_MAX_PENDING_RANGES) {
+        RxProgressRange* range_ptr =
+            &payload_state_ptr->progress_range_array[payload_state_ptr->progress_range_count++];
+        range_ptr->start_offset = start_offset;
+        range_ptr->end_offset = end_offset;
+    }
+
+    // Progress is only reported once the size of the payload is known from packet #0 and until the payload is complete,
+    // at which point it is delivered as usual.
+    const int byte_count = payload_state_ptr->progress_byte_count;
+    if (kPayloadInProgress != payload_state_ptr->payload_state ||
+        byte_count >= payload_state_ptr->expected_payload_data_size ||
+        byte_count - payload_state_ptr->progress_reported_byte_count <
+            con_state_ptr->rx_state.config_data.progress_step_bytes) {
+        return;
+    }
+    payload_state_ptr->progress_reported_byte_count = byte_count;
+
+    const AppPayloadCallbackData* app_cb_data_ptr = &payload_state_ptr->work_request_state.app_payload_cb_data;
+    CdiCoreRxProgressCbData cb_data = {
+        .core_cb_data.status_code = kCdiStatusOk,
+        .core_cb_data.connection_handle = (CdiConnectionHandle)con_state_ptr,
+        .core_cb_data.core_extra_data = app_cb_data_ptr->core_extra_data,
+        .core_cb_data.user_cb_param = con_state_ptr->rx_state.config_data.user_cb_param,
+        .payload_size = payload_state_ptr->expected_payload_data_size,
+        .received_byte_count = byte_count,
+        .linear_buffer_ptr = payload_state_ptr->linear_buffer_ptr,
+        .sgl_head_ptr = RxReorderPacketInOrderSglGet(payload_state_ptr)
+    };
+    (con_state_ptr->rx_state.config_data.progress_cb_ptr)(&cb_data);
+}
+
+CdiReturnStatus RxReorderConfigResolve(CdiRxConfigData* config_data_ptr)
+{
+    if (config_data_ptr->packet_reorder_window < 0 || config_data_ptr->payload_reorder_buffer_size < 0 ||
+        config_data_ptr->reorder_list_pool_size < 0) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Reorder packet window[%d], payload buffer size[%d] and list pool size[%d] cannot be negative.",
+                       config_data_ptr->packet_reorder_window, config_data_ptr->payload_reorder_buffer_size,
+                       config_data_ptr->reorder_list_pool_size);
+        return kCdiStatusInvalidParameter;
+    }
+
+    if (0 == config_data_ptr->packet_reorder_window) {
+        config_data_ptr->packet_reorder_window = CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW;
+    }
+    if (0 == config_data_ptr->reorder_list_pool_size) {
+        config_data_ptr->reorder_list_pool_size = CDI_RX_REORDER_LIST_POOL_DEFAULT_SIZE;
+    }
+    if (0 == config_data_ptr->payload_reorder_buffer_size) {
+        // A payload has at least one packet, so the payload buffer must cover the packet window to ensure that an
+        // entry is stale before its payload number is reused. Use the smallest power of 2 that does.
+        int buffer_size = CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER;
+        while (buffer_size < config_data_ptr->packet_reorder_window &&
+               buffer_size < CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER_LIMIT) {
+            buffer_size *= 2;
+        }
+        config_data_ptr->payload_reorder_buffer_size = buffer_size;
+    }
+
+    const int buffer_size = config_data_ptr->payload_reorder_buffer_size;
+    if (buffer_size > CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER_LIMIT || 0 != (buffer_size & (buffer_size - 1))) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Reorder payload buffer size[%d] must be a power of 2 no larger than [%d].", buffer_size,
+                       CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER_LIMIT);
+        return kCdiStatusInvalidParameter;
+    }
+    if (config_data_ptr->packet_reorder_window > buffer_size) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Reorder packet window[%d] cannot be larger than the payload buffer size[%d].",
+                       config_data_ptr->packet_reorder_window, buffer_size);
+        return kCdiStatusInvalidParameter;
+    }
+    return kCdiStatusOk;
+}
+
+CdiReturnStatus RxRunToCompletionConfigResolve(CdiRxConfigData* config_data_ptr)
+{
+    if (!config_data_ptr->run_to_completion) {
+        return kCdiStatusOk;
+    }
+
+    if (0 != config_data_ptr->buffer_delay_ms) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Run to completion cannot be used with Rx buffer delay[%d]ms.",
+                       config_data_ptr->buffer_delay_ms);
+        return kCdiStatusInvalidParameter;
+    }
+    if (config_data_ptr->run_to_completion_budget_us < 0) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Run to completion budget specified[%d]us is a negative value.",
+                       config_data_ptr->run_to_completion_budget_us);
+        return kCdiStatusInvalidParameter;
+    }
+    if (0 == config_data_ptr->run_to_completion_budget_us) {
+        config_data_ptr->run_to_completion_budget_us = CDI_RX_RUN_TO_COMPLETION_DEFAULT_BUDGET_US;
+    }
+
+    return kCdiStatusOk;
+}
@@ -16,6 +16,7 @@
 #include "adapter_api.h"
 #include "cdi_core_api.h"
 #include "cdi_raw_api.h"
+#include "protocol.h"
 
 //*********************************************************************************************************************
 //***************************************** START OF DEFINITIONS AND TYPES ********************************************
@@ -99,6 +100,17 @@ void RxFreePayloadResources(CdiEndpointState* endpoint_ptr, RxPayloadState* payl
  */
 void RxInvokeAppPayloadCallback(CdiConnectionState* con_state_ptr, AppPayloadCallbackData* app_cb_data_ptr);
 
+/**
+ * Invoke the application's payload callback function directly from the current thread, which is the connection's
+ * packet receive poll thread. Used instead of the payload message queue when the connection is configured to run to
+ * completion. Callbacks that take longer than the configured budget are counted in the endpoint's
+ * num_callbacks_over_budget statistic.
+ *
+ * @param endpoint_ptr Pointer to endpoint data.
+ * @param app_cb_data_ptr Pointer to the payload message.
+ */
+void RxInvokeAppPayloadCallbackInline(CdiEndpointState* endpoint_ptr, AppPayloadCallbackData* app_cb_data_ptr);
+
 /**
  * Enqueue to free the receive buffer.
  *
@@ -108,6 +120,17 @@ void RxInvokeAppPayloadCallback(CdiConnectionState* con_state_ptr, AppPayloadCal
  */
 CdiReturnStatus RxEnqueueFreeBuffer(const CdiSgList* sgl_ptr);
 
+/**
+ * Enqueue to free an array of receive buffers. Consecutive buffers that belong to the same endpoint are put in the
+ * endpoint's free buffer queue using a single queue operation.
+ *
+ * @param sgl_ptr_array Array of pointers to the scatter-gather lists containing the memory to be freed.
+ * @param count Number of entries in sgl_ptr_array.
+ *
+ * @return kCdiStatusOk if all of the buffers were enqueued, otherwise the status of the first failure.
+ */
+CdiReturnStatus RxEnqueueFreeBuffers(const CdiSgList* sgl_ptr_array[], int count);
+
 /**
  * Called from PollThread() in the adapter to poll if any Rx buffers need to be freed. If there are any, this function
  * will free payload level resources and then return a list of adapter packet buffer SGLs that need to be freed by the
@@ -129,4 +152,37 @@ bool RxPollFreeBuffer(void* param_ptr, CdiSgList* ret_packet_buffer_sgl_ptr);
  */
 void RxEndpointFlushResources(CdiEndpointState* endpoint_ptr);
 
+/**
+ * Record the range of payload data of a packet that has been received and invoke the application's progress callback
+ * function if the part of the payload received with no gaps has grown enough (see CdiRxConfigData.progress_cb_ptr).
+ * Must only be called for connections that have a progress callback.
+ *
+ * @param con_state_ptr Pointer to connection state structure.
+ * @param packet_ptr Pointer to the packet that was received.
+ * @param payload_state_ptr Pointer to the state data of the packet's payload.
+ * @param header_ptr Pointer to the packet's decoded CDI header.
+ */
+void RxProgressUpdate(CdiConnectionState* con_state_ptr, const Packet* packet_ptr,
+                      RxPayloadState* payload_state_ptr, const CdiDecodedPacketHeader* header_ptr);
+
+/**
+ * Apply the defaults of the packet reorder window, payload reorder buffer and reorder list pool sizes of an Rx
+ * configuration that are zero, then check that the resulting sizes can be used together.
+ *
+ * @param config_data_ptr Pointer to the configuration to update.
+ *
+ * @return kCdiStatusOk if the sizes are valid, otherwise kCdiStatusInvalidParameter.
+ */
+CdiReturnStatus RxReorderConfigResolve(CdiRxConfigData* config_data_ptr);
+
+/**
+ * Check the run to completion settings of an Rx configuration and apply the default callback budget if it is zero.
+ * Must be called after buffer_delay_ms has been resolved, since run to completion cannot be used with a buffer delay.
+ *
+ * @param config_data_ptr Pointer to the configuration to update.
+ *
+ * @return kCdiStatusOk if the settings are valid, otherwise kCdiStatusInvalidParameter.
+ */
+CdiReturnStatus RxRunToCompletionConfigResolve(CdiRxConfigData* config_data_ptr);
+
 #endif  // CDI_INTERNAL_RX_H__
@@ -15,19 +15,98 @@
 
 #include "internal_tx.h"
 
+#include <inttypes.h>
+#include <limits.h>
 #include <string.h>
 
 #include "cdi_queue_api.h"
+#include "completion_queue.h"
 #include "endpoint_manager.h"
 #include "internal.h"
 #include "payload.h"
 #include "private.h"
+#include "protocol.h"
 #include "statistics.h"
 
 //*********************************************************************************************************************
 //***************************************** START OF DEFINITIONS AND TYPES ********************************************
 //*********************************************************************************************************************
 
+/**
+ * @brief States used to packetize a payload. See TxPacketizerRun() for the state diagram.
+ */
+typedef enum {
+    kPayloadStateIdle,           ///< No payload is in process: wait for payload from queue.
+    kPayloadStateWorkReceived,   ///< A payload was received to be transmitted: initialize for first packet.
+    kPayloadStateGetWorkRequest, ///< Payload and packetizer initialized: get a work request from pool.
+    kPayloadStatePacketizing,    ///< Have work request: build SGL.
+    kPayloadStateEnqueuing       ///< Have completed list of work requests: queued to the adapter.
+} TxPayloadProcessingState;
+
+/**
+ * @brief State data of a range of packets built by TxPacketizerRangeBuild(). The packetizer builds the first range of
+ * each chunk of packets itself and its helpers build the other ones concurrently using worker pool join tasks.
+ */
+typedef struct {
+    WorkerPoolJoinTask join_task;         ///< Join task of the helper. Not used for the packetizer's own range.
+    CdiProtocolHandle protocol_handle;    ///< Handle of the protocol used to build the packet headers.
+    PacketizationPlanHandle plan_handle;  ///< Handle of the packetization plan of the payload's stream.
+    TxPayloadState payload_state;         ///< Private copy of the state of the payload being packetized.
+    int first_packet_index;               ///< Index in the payload of the first packet of the range.
+    int packet_count;                     ///< Number of packets in the range.
+    uint32_t first_packet_id;             ///< Packet ID of the first packet of the range.
+    TxPacketWorkRequest** work_request_array; ///< Work requests of the packets of the range.
+} TxPacketizerRange;
+
+/**
+ * @brief State of a payload whose packetizing was suspended so packets of a higher priority stream could be sent.
+ */
+typedef struct {
+    TxPayloadState* payload_state_ptr;         ///< Pointer to the suspended payload. NULL if none.
+    /// @brief Handle of the suspended payload's packetizer state tracker. Kept while no payload is suspended, to be
+    /// reused by the next payload that interrupts another one.
+    CdiPacketizerStateHandle packetizer_state_handle;
+    int batch_size;                            ///< See TxPacketizerState.batch_size.
+    int parallel_next_packet_index;            ///< See TxPacketizerState.parallel_next_packet_index.
+    int parallel_end_packet_index;             ///< See TxPacketizerState.parallel_end_packet_index.
+} TxPacketizerSuspendedPayload;
+
+/**
+ * @brief State data used to packetize payloads. This state must persist between calls, since packetizing a payload is
+ * suspended whenever a pool runs dry or the adapter's queue is full and is resumed when resources are available.
+ */
+struct TxPacketizerState {
+    CdiPacketizerStateHandle packetizer_state_handle; ///< Handle of the packetizer's state tracker object.
+    TxPayloadProcessingState processing_state; ///< Current state of the state machine.
+    TxPayloadState* payload_state_ptr;         ///< Pointer to the payload in process. NULL if idle.
+    TxPacketWorkRequest* work_request_ptr;     ///< Pointer to the work request being packetized.
+    CdiSinglyLinkedList packet_list;           ///< List of packets to enqueue to the adapter.
+    int batch_size;                            ///< Number of packets to enqueue in the next batch.
+    bool last_packet;                          ///< True if the last packet of the payload has been created.
+
+    /// @brief Ranges of packets built concurrently. The first entry is used by the packetizer itself, the others by its
+    /// helpers. NULL if the connection has no packetizer helpers.
+    TxPacketizerRange* range_array;
+    int helper_count;                          ///< Number of helpers (entries in range_array after the first one).
+    WorkerPoolJoin helpers_join;               ///< Used to wait for the helpers to build their ranges of packets.
+    /// @brief Work requests of the chunk of packets being built concurrently, in packet order. Holds
+    /// TX_PARALLEL_PACKETIZE_CHUNK_PACKETS entries.
+    TxPacketWorkRequest** parallel_work_request_array;
+    /// @brief Index of the next packet of the payload to be built concurrently. Zero if the payload is packetized by
+    /// PayloadPacketizerPacketGet().
+    int parallel_next_packet_index;
+    int parallel_end_packet_index;             ///< One more than the index of the last packet of the payload.
+
+    /// @brief Payloads taken from the payload queue that are waiting to be started, in the order they were queued.
+    /// NULL if the payload scheduler could not be created.
+    TxPayloadState** pending_payload_array;
+    int pending_payload_capacity;              ///< Number of entries in pending_payload_array.
+    int pending_payload_count;                 ///< Number of payloads waiting in pending_payload_array.
+    /// @brief Payload interrupted by the one in process. It is resumed when no payloads of higher priority streams are
+    /// waiting.
+    TxPacketizerSuspendedPayload suspended;
+};
+
 //*********************************************************************************************************************
 //*********************************************** START OF VARIABLES **************************************************
 //*********************************************************************************************************************
@@ -121,6 +200,9 @@ static void ProcessWorkRequestCompletionQueue(CdiConnectionState* con_state_ptr)
             // Put back SGL entry for each one in the list.
             FreeSglEntries(con_state_ptr->tx_state.packet_sgl_entry_pool_handle, packet_entry_hdr_ptr);
 #endif
+            if (work_request_ptr->bounce_buffer_ptr) {
+                CdiPoolPut(con_state_ptr->tx_state.bounce_buffer_pool_handle, work_request_ptr->bounce_buffer_ptr);
+            }
 
             // Put back work request into the pool.
             // NOTE: This pool is not thread-safe, so must ensure that only one thread is accessing it at a time.
@@ -130,7 +212,798 @@ static void ProcessWorkRequestCompletionQueue(CdiConnectionState* con_state_ptr)
 }
 
 /**
- * Payload thread used to transmit a payload.
+ * Create the pool of bounce buffers used to coalesce small payload SGL fragments. The memory is registered with the
+ * adapter, so packets can reference it in the same way as the application's Tx payload buffer.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+static CdiReturnStatus BounceBufferPoolCreate(CdiConnectionState* con_state_ptr)
+{
+    CdiReturnStatus rs = kCdiStatusOk;
+    TxConState* tx_state_ptr = &con_state_ptr->tx_state;
+    const uint32_t buffer_size = con_state_ptr->adapter_state_ptr->maximum_payload_bytes;
+
+    tx_state_ptr->bounce_buffer_memory_size = CdiPoolGetSizeNeeded(TX_BOUNCE_BUFFER_COUNT_PER_CONNECTION,
+                                                                   buffer_size);
+    tx_state_ptr->bounce_buffer_memory_ptr = CdiOsMemAlloc(tx_state_ptr->bounce_buffer_memory_size);
+    if (NULL == tx_state_ptr->bounce_buffer_memory_ptr) {
+        rs = kCdiStatusNotEnoughMemory;
+    }
+
+    if (kCdiStatusOk == rs) {
+        uint32_t size_needed = 0;
+        if (!CdiPoolCreateUsingExistingBuffer("Connection Tx Bounce Buffer Pool", TX_BOUNCE_BUFFER_COUNT_PER_CONNECTION,
+                                              buffer_size, false, // false= Not thread-safe (no resource locks)
+                                              tx_state_ptr->bounce_buffer_memory_ptr,
+                                              tx_state_ptr->bounce_buffer_memory_size, &size_needed,
+                                              &tx_state_ptr->bounce_buffer_pool_handle)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        rs = CdiAdapterMemoryRegister(con_state_ptr->adapter_state_ptr, tx_state_ptr->bounce_buffer_memory_ptr,
+                                      tx_state_ptr->bounce_buffer_memory_size);
+        if (kCdiStatusArraySizeExceeded == rs) {
+            CDI_LOG_HANDLE(con_state_ptr->log_handle, kLogError, "Cannot coalesce small fragments. All [%d] memory"
+                           " regions of the adapter are in use (see CDI_MAX_ADAPTER_MEMORY_REGIONS).",
+                           CDI_MAX_ADAPTER_MEMORY_REGIONS);
+        }
+        if (kCdiStatusOk != rs) {
+            // Clear the pool handle, so BounceBufferPoolDestroy() won't unregister memory that was never registered.
+            CdiPoolDestroy(tx_state_ptr->bounce_buffer_pool_handle);
+            tx_state_ptr->bounce_buffer_pool_handle = NULL;
+        }
+    }
+
+    return rs;
+}
+
+/**
+ * Destroy the pool of bounce buffers created by BounceBufferPoolCreate(), if any.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ */
+static void BounceBufferPoolDestroy(CdiConnectionState* con_state_ptr)
+{
+    TxConState* tx_state_ptr = &con_state_ptr->tx_state;
+
+    if (tx_state_ptr->bounce_buffer_pool_handle) {
+        CdiPoolPutAll(tx_state_ptr->bounce_buffer_pool_handle);
+        CdiPoolDestroy(tx_state_ptr->bounce_buffer_pool_handle);
+        tx_state_ptr->bounce_buffer_pool_handle = NULL;
+        CdiAdapterMemoryUnregister(con_state_ptr->adapter_state_ptr, tx_state_ptr->bounce_buffer_memory_ptr);
+    }
+    if (tx_state_ptr->bounce_buffer_memory_ptr) {
+        CdiOsMemFree(tx_state_ptr->bounce_buffer_memory_ptr);
+        tx_state_ptr->bounce_buffer_memory_ptr = NULL;
+    }
+}
+
+/**
+ * Reset the packetizer state so it is ready to start a new payload.
+ *
+ * @param state_ptr Pointer to packetizer state data.
+ */
+static void TxPacketizerStateReset(TxPacketizerState* state_ptr)
+{
+    state_ptr->processing_state = kPayloadStateIdle;
+    state_ptr->payload_state_ptr = NULL;
+    state_ptr->work_request_ptr = NULL;
+    state_ptr->last_packet = false;
+    state_ptr->batch_size = 1;
+    state_ptr->parallel_next_packet_index = 0;
+    state_ptr->pending_payload_count = 0;
+    state_ptr->suspended.payload_state_ptr = NULL;
+    state_ptr->suspended.parallel_next_packet_index = 0;
+    CdiSinglyLinkedListInit(&state_ptr->packet_list);
+}
+
+/**
+ * Build a range of packets of a payload from its stream's packetization plan. The work requests of the packets must
+ * already hold the SGL entries needed by the packets. This function does not use any pools, so several ranges of the
+ * same payload can be built concurrently.
+ *
+ * @param range_ptr Pointer to the range of packets to build.
+ */
+static void TxPacketizerRangeBuild(TxPacketizerRange* range_ptr)
+{
+    TxPayloadState* payload_state_ptr = &range_ptr->payload_state;
+
+    PayloadPacketizationPlanSeek(range_ptr->plan_handle, range_ptr->first_packet_index, payload_state_ptr);
+    payload_state_ptr->payload_packet_state.packet_id = range_ptr->first_packet_id;
+    for (int i = 0; i < range_ptr->packet_count; i++) {
+        TxPacketWorkRequest* work_request_ptr = range_ptr->work_request_array[i];
+        PayloadPacketizationPlanPacketBuild(range_ptr->protocol_handle, range_ptr->plan_handle,
+                                            range_ptr->first_packet_index + i, (char*)&work_request_ptr->header,
+                                            payload_state_ptr, &work_request_ptr->packet.sg_list);
+        work_request_ptr->packet_payload_size = payload_state_ptr->payload_packet_state.packet_payload_data_size;
+    }
+}
+
+/**
+ * Join task function of a packetizer helper. Run by a worker thread or, if none has started it when the packetizer is
+ * done with its own range, by the packetizer.
+ *
+ * @param arg_ptr Pointer to the helper's TxPacketizerRange.
+ */
+static void TxPacketizerHelperTask(void* arg_ptr)
+{
+    TxPacketizerRangeBuild((TxPacketizerRange*)arg_ptr);
+}
+
+/**
+ * Free the resources of the packetizer helpers created by TxPacketizerHelpersCreate(), if any. Helpers are not busy
+ * when this function is called, since the packetizer waits for them after starting them.
+ *
+ * @param state_ptr Pointer to packetizer state data.
+ */
+static void TxPacketizerHelpersDestroy(TxPacketizerState* state_ptr)
+{
+    if (state_ptr->range_array) {
+        for (int i = 1; i <= state_ptr->helper_count; i++) {
+            WorkerPoolJoinTaskStop(&state_ptr->range_array[i].join_task);
+        }
+        CdiOsMemFree(state_ptr->range_array);
+        state_ptr->range_array = NULL;
+    }
+    state_ptr->helper_count = 0;
+    if (state_ptr->parallel_work_request_array) {
+        CdiOsMemFree(state_ptr->parallel_work_request_array);
+        state_ptr->parallel_work_request_array = NULL;
+    }
+    WorkerPoolJoinDestroy(&state_ptr->helpers_join);
+}
+
+/**
+ * Create the packetizer helpers of a connection, if it is configured to use them and the SDK worker pool is enabled.
+ * If they can't be created, payloads are packetized without them.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data.
+ */
+static void TxPacketizerHelpersCreate(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr)
+{
+    const int helper_count = con_state_ptr->tx_state.config_data.packetizer_helper_count;
+    // Packetization plans, which the helpers build from, are not used when coalescing small fragments.
+    if (0 == helper_count || NULL == cdi_global_context.worker_pool_handle ||
+        con_state_ptr->tx_state.config_data.coalesce_small_fragments) {
+        return;
+    }
+
+    bool ok = WorkerPoolJoinCreate(&state_ptr->helpers_join);
+    if (ok) {
+        state_ptr->range_array = CdiOsMemAllocZero((helper_count + 1) * sizeof(TxPacketizerRange));
+        state_ptr->parallel_work_request_array =
+            CdiOsMemAlloc(TX_PARALLEL_PACKETIZE_CHUNK_PACKETS * sizeof(TxPacketWorkRequest*));
+        ok = state_ptr->range_array && state_ptr->parallel_work_request_array;
+    }
+
+    if (ok) {
+        for (int i = 1; i <= helper_count; i++) {
+            TxPacketizerRange* range_ptr = &state_ptr->range_array[i];
+            WorkerPoolJoinTaskInit(cdi_global_context.worker_pool_handle, &state_ptr->helpers_join,
+                                   &range_ptr->join_task, TxPacketizerHelperTask, range_ptr, con_state_ptr->log_handle);
+        }
+        state_ptr->helper_count = helper_count;
+    } else {
+        CDI_LOG_HANDLE(con_state_ptr->log_handle, kLogWarning,
+                       "Failed to create packetizer helpers. Payloads are packetized by a single thread.");
+        TxPacketizerHelpersDestroy(state_ptr);
+    }
+}
+
+/**
+ * Build the next chunk of packets of a payload that is packetized concurrently by the packetizer and its helpers and
+ * add them to the list of packets to enqueue, in order. The resources of the packets are taken from the connection's
+ * pools by this thread before the packets are built, since the pools are not thread-safe.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data.
+ * @param max_packets Maximum number of packets to build.
+ *
+ * @return The number of packets built. Zero if a pool is empty.
+ */
+static int TxPacketizerParallelRun(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr, int max_packets)
+{
+    TxPayloadState* payload_state_ptr = state_ptr->payload_state_ptr;
+    CdiEndpointState* endpoint_ptr = payload_state_ptr->cdi_endpoint_handle;
+    PacketizationPlanHandle plan_handle = endpoint_ptr->tx_state.packetization_plan_handle;
+    const int first_packet_index = state_ptr->parallel_next_packet_index;
+    int count = CDI_MIN(state_ptr->parallel_end_packet_index - first_packet_index, TX_PARALLEL_PACKETIZE_CHUNK_PACKETS);
+    count = CDI_MIN(count, max_packets);
+
+    // Get a work request and the SGL entries of each packet.
+    int reserved_count = 0;
+    while (reserved_count < count) {
+        TxPacketWorkRequest* work_request_ptr = NULL;
+        if (!CdiPoolGet(con_state_ptr->tx_state.work_request_pool_handle, (void**)&work_request_ptr)) {
+            break;
+        }
+        const int packet_index = first_packet_index + reserved_count;
+        CdiSgList* packet_sgl_ptr = &work_request_ptr->packet.sg_list;
+        memset((void*)packet_sgl_ptr, 0, sizeof(*packet_sgl_ptr));
+        bool ok = true;
+        for (int i = PayloadPacketizationPlanPacketEntryCount(plan_handle, packet_index); ok && i > 0; i--) {
+            CdiSglEntry* packet_entry_ptr = NULL;
+            ok = CdiPoolGet(con_state_ptr->tx_state.packet_sgl_entry_pool_handle, (void**)&packet_entry_ptr);
+            if (ok) {
+                packet_entry_ptr->next_ptr = NULL;
+                packet_entry_ptr->internal_data_ptr = NULL;
+                packet_entry_ptr->size_in_bytes = 0;
+                SglAppend(packet_sgl_ptr, packet_entry_ptr);
+            }
+        }
+        if (!ok) {
+            FreeSglEntries(con_state_ptr->tx_state.packet_sgl_entry_pool_handle, packet_sgl_ptr->sgl_head_ptr);
+            CdiPoolPut(con_state_ptr->tx_state.work_request_pool_handle, work_request_ptr);
+            break;
+        }
+
+        work_request_ptr->bounce_buffer_ptr = NULL;
+        work_request_ptr->payload_state_ptr = payload_state_ptr;
+        work_request_ptr->payload_num = payload_state_ptr->payload_packet_state.payload_num;
+        packet_sgl_ptr->internal_data_ptr = work_request_ptr;
+        work_request_ptr->packet.payload_last_packet = packet_index + 1 == state_ptr->parallel_end_packet_index;
+        work_request_ptr->packet.tx_state.pacing_bytes_per_millisec = payload_state_ptr->pacing_bytes_per_millisec;
+        state_ptr->parallel_work_request_array[reserved_count++] = work_request_ptr;
+    }
+    if (0 == reserved_count) {
+        return 0;
+    }
+
+    // Split the packets into contiguous ranges, one for each helper and one for this thread. Start the helpers first so
+    // they run while this thread builds its own range. The wait below builds the ranges of helpers that no worker
+    // thread has started, so it never depends on a worker thread becoming free (ie. while the pool is shutting down).
+    const int range_count = CDI_MIN(state_ptr->helper_count + 1, reserved_count);
+    const uint32_t first_packet_id = endpoint_ptr->tx_state.packet_id;
+    for (int i = range_count - 1; i >= 0; i--) {
+        TxPacketizerRange* range_ptr = &state_ptr->range_array[i];
+        const int range_start = i * reserved_count / range_count;
+        const int range_end = (i + 1) * reserved_count / range_count;
+        range_ptr->protocol_handle = endpoint_ptr->adapter_endpoint_ptr->protocol_handle;
+        range_ptr->plan_handle = plan_handle;
+        range_ptr->payload_state = *payload_state_ptr;
+        range_ptr->first_packet_index = first_packet_index + range_start;
+        range_ptr->packet_count = range_end - range_start;
+        range_ptr->first_packet_id = first_packet_id + range_start;
+        range_ptr->work_request_array = &state_ptr->parallel_work_request_array[range_start];
+        if (i) {
+            WorkerPoolJoinTaskStart(&range_ptr->join_task);
+        } else {
+            TxPacketizerRangeBuild(range_ptr);
+        }
+    }
+    WorkerPoolJoinWait(&state_ptr->helpers_join);
+
+    // Merge the packets in order.
+    for (int i = 0; i < reserved_count; i++) {
+        TxPacketWorkRequest* work_request_ptr = state_ptr->parallel_work_request_array[i];
+        CdiSinglyLinkedListPushTail(&state_ptr->packet_list, &work_request_ptr->packet.list_entry);
+        payload_state_ptr->payload_packet_state.zero_copy_byte_count += work_request_ptr->packet_payload_size;
+    }
+    CdiOsAtomicAdd32(&endpoint_ptr->adapter_endpoint_ptr->tx_in_flight_ref_count, reserved_count);
+    endpoint_ptr->tx_state.packet_id += reserved_count;
+    payload_state_ptr->payload_packet_state.packet_sequence_num += reserved_count;
+
+    state_ptr->parallel_next_packet_index += reserved_count;
+    state_ptr->last_packet = state_ptr->parallel_next_packet_index == state_ptr->parallel_end_packet_index;
+    if (state_ptr->last_packet) {
+        state_ptr->parallel_next_packet_index = 0;
+    }
+
+    return reserved_count;
+}
+
+/**
+ * Get the rate at which the packets of a payload must be sent so they are spread over the connection's pacing window.
+ * The rate is based on the bytes the adapter sends, so it includes the message prefix and the protocol header of each
+ * packet. Since the header sizes are only known once the packets are built, the largest data packet header is assumed,
+ * which makes the packets of a payload end slightly before the window rather than after it.
+ *
+ * @param adapter_state_ptr Pointer to the state data of the adapter that sends the payload.
+ * @param payload_state_ptr Pointer to payload state data.
+ * @param pacing_window_us Pacing window in microseconds. Must not be zero.
+ *
+ * @return The rate in bytes per millisecond.
+ */
+static uint32_t TxPacingRateGet(const CdiAdapterState* adapter_state_ptr, const TxPayloadState* payload_state_ptr,
+                                uint32_t pacing_window_us)
+{
+    const int header_bytes = adapter_state_ptr->msg_prefix_size +
+                             CDI_MAX(CDI_RAW_PACKET_HEADER_SIZE_V1, CDI_RAW_PACKET_HEADER_SIZE_V2);
+    const int data_bytes_per_packet = CDI_MAX(1, adapter_state_ptr->maximum_payload_bytes - header_bytes);
+    // The first packet also carries the extra data of the payload.
+    const uint64_t data_bytes = (uint64_t)payload_state_ptr->source_sgl.total_data_size +
+                                payload_state_ptr->app_payload_cb_data.extra_data_size;
+    const uint64_t packet_count = CDI_MAX(1, (data_bytes + data_bytes_per_packet - 1) / data_bytes_per_packet);
+    const uint64_t wire_bytes = data_bytes + packet_count * header_bytes;
+
+    const uint64_t rate = wire_bytes * 1000 / pacing_window_us;
+    return (uint32_t)CDI_MAX(1, CDI_MIN(rate, UINT32_MAX));
+}
+
+/**
+ * Get the number of packets to put in the next batch of packets that is handed to the adapter, according to the
+ * connection's batch policy (see CdiTxConfigData.batch_policy).
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data. The payload in process must be set.
+ * @param first_batch True if the batch is the first one of the payload.
+ *
+ * @return The number of packets of the next batch.
+ */
+static int TxBatchSizeNext(CdiConnectionState* con_state_ptr, const TxPacketizerState* state_ptr, bool first_batch)
+{
+    const CdiTxBatchPolicy policy = con_state_ptr->tx_state.config_data.batch_policy;
+    const TxPayloadState* payload_state_ptr = state_ptr->payload_state_ptr;
+    EndpointTransmitQueueLevel queue_level = kEndpointTransmitQueueNa;
+    uint64_t elapsed_us = 0;
+    if (kCdiTxBatchPolicyAdaptive == policy) {
+        queue_level = CdiAdapterGetTransmitQueueLevel(
+            EndpointManagerEndpointToAdapterEndpoint(payload_state_ptr->cdi_endpoint_handle));
+        elapsed_us = CdiOsGetMicroseconds() - payload_state_ptr->start_time;
+    }
+
+    return TxBatchSizeGet(policy, state_ptr->batch_size, first_batch, queue_level, elapsed_us,
+                          payload_state_ptr->max_latency_microsecs);
+}
+
+/**
+ * Add a batch of packets that was handed to the adapter to the batch size histogram of an endpoint.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param batch_size Number of packets in the batch.
+ */
+static void TxBatchSizeRecord(CdiEndpointState* endpoint_ptr, int batch_size)
+{
+    TxBatchSizeHistogramAdd(endpoint_ptr->transfer_stats.payload_counter_stats.tx_batch_size_histogram, batch_size);
+}
+
+/**
+ * Free the resources of the payload scheduler created by TxSchedulerCreate(), if any.
+ *
+ * @param state_ptr Pointer to packetizer state data.
+ */
+static void TxSchedulerDestroy(TxPacketizerState* state_ptr)
+{
+    if (state_ptr->pending_payload_array) {
+        CdiOsMemFree(state_ptr->pending_payload_array);
+        state_ptr->pending_payload_array = NULL;
+    }
+    state_ptr->pending_payload_capacity = 0;
+    state_ptr->pending_payload_count = 0;
+    PayloadPacketizerDestroy(state_ptr->suspended.packetizer_state_handle);
+    state_ptr->suspended.packetizer_state_handle = NULL;
+}
+
+/**
+ * Create the payload scheduler of a connection. It orders waiting payloads by stream priority and, if the connection
+ * is configured to, by deadline. If it can't be created, payloads are sent in the order they were queued.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data.
+ */
+static void TxSchedulerCreate(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr)
+{
+    const CdiTxConfigData* config_data_ptr = &con_state_ptr->tx_state.config_data;
+
+    // Every payload of the connection holds a payload state, so no more than this can be waiting.
+    int capacity = config_data_ptr->max_simultaneous_tx_payloads ? config_data_ptr->max_simultaneous_tx_payloads :
+                   CDI_MAX_SIMULTANEOUS_TX_PAYLOADS_PER_CONNECTION;
+    state_ptr->pending_payload_array = CdiOsMemAlloc(capacity * sizeof(TxPayloadState*));
+    if (NULL == state_ptr->pending_payload_array) {
+        CDI_LOG_HANDLE(con_state_ptr->log_handle, kLogWarning,
+                       "Failed to create payload scheduler. Payloads are sent in the order they are queued.");
+    } else {
+        state_ptr->pending_payload_capacity = capacity;
+        state_ptr->pending_payload_count = 0;
+    }
+}
+
+/**
+ * Return the time by which a payload must have been transmitted.
+ *
+ * @param payload_state_ptr Pointer to payload state data.
+ *
+ * @return The deadline in microseconds, or UINT64_MAX if the payload has no maximum latency.
+ */
+static uint64_t TxPayloadDeadlineGet(const TxPayloadState* payload_state_ptr)
+{
+    return payload_state_ptr->max_latency_microsecs ?
+           payload_state_ptr->start_time + payload_state_ptr->max_latency_microsecs : UINT64_MAX;
+}
+
+/**
+ * Return the deadline used to order a payload among the waiting ones. A payload without a maximum latency is ordered as
+ * if it had TX_SCHEDULER_NO_LATENCY_MAX_WAIT_MICROSECS, so a steady stream of payloads that have a deadline can't hold
+ * it back indefinitely.
+ *
+ * @param payload_state_ptr Pointer to payload state data.
+ *
+ * @return The deadline in microseconds.
+ */
+static uint64_t TxPayloadScheduleDeadlineGet(const TxPayloadState* payload_state_ptr)
+{
+    uint32_t max_latency_us = payload_state_ptr->max_latency_microsecs;
+    if (0 == max_latency_us) {
+        max_latency_us = TX_SCHEDULER_NO_LATENCY_MAX_WAIT_MICROSECS;
+    }
+    return payload_state_ptr->start_time + max_latency_us;
+}
+
+/**
+ * Add a payload taken from the payload queue to the payloads waiting to be scheduled.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data.
+ * @param payload_state_ptr Pointer to payload state data.
+ */
+static void TxSchedulerPayloadAdd(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr,
+                                  TxPayloadState* payload_state_ptr)
+{
+    assert(state_ptr->pending_payload_count < state_ptr->pending_payload_capacity);
+    state_ptr->pending_payload_array[state_ptr->pending_payload_count++] = payload_state_ptr;
+
+    if (NULL == con_state_ptr->tx_state.poll_packetizer_state_ptr) {
+        // Increment reference counter once at the start of each payload. This will keep the PollThread() working as
+        // long as we have payloads and their related packets to send. When running to completion, it was incremented
+        // by TxPayloadEnqueue().
+        CdiOsAtomicInc32(&payload_state_ptr->cdi_endpoint_handle->adapter_endpoint_ptr->tx_in_flight_ref_count);
+        CdiOsSignalSet(con_state_ptr->adapter_connection_ptr->tx_poll_do_work_signal);
+    }
+}
+
+/**
+ * Return the priority of the stream that a payload belongs to.
+ *
+ * @param payload_state_ptr Pointer to payload state data.
+ *
+ * @return The stream's priority. See CdiTxConfigDataStream.priority.
+ */
+static int TxPayloadPriorityGet(const TxPayloadState* payload_state_ptr)
+{
+    return payload_state_ptr->cdi_endpoint_handle->tx_state.priority;
+}
+
+/**
+ * Take all payloads from the payload queue and choose the one to packetize next among those of streams with a
+ * priority above min_priority. If the connection schedules payloads by deadline, payloads that can no longer meet
+ * their deadline are dropped along the way. While a payload is suspended, payloads sent through its adapter endpoint
+ * are not chosen, since the packets of two payloads must not be interleaved on one endpoint.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data. On return, payload_state_ptr is set to the chosen payload.
+ * @param min_priority Only payloads of streams with a higher priority than this are chosen. Use INT_MIN for all.
+ *
+ * @return true if a payload was chosen, false if no such payloads are waiting.
+ */
+static bool TxSchedulerPayloadSelect(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr,
+                                     int min_priority)
+{
+    TxPayloadState* payload_state_ptr = NULL;
+    while (state_ptr->pending_payload_count < state_ptr->pending_payload_capacity &&
+           CdiQueuePop(con_state_ptr->tx_state.payload_queue_handle, (void**)&payload_state_ptr)) {
+        TxSchedulerPayloadAdd(con_state_ptr, state_ptr, payload_state_ptr);
+    }
+
+    const TxPayloadState* suspended_payload_state_ptr = state_ptr->suspended.payload_state_ptr;
+    const AdapterEndpointState* busy_adapter_endpoint_ptr = suspended_payload_state_ptr ?
+        suspended_payload_state_ptr->cdi_endpoint_handle->adapter_endpoint_ptr : NULL;
+    state_ptr->payload_state_ptr = NULL;
+    while (NULL == state_ptr->payload_state_ptr) {
+        // Payloads are kept in queue order and ties go to the first one, so otherwise equal payloads are sent in the
+        // order they were queued.
+        TxPayloadState** pending_array = state_ptr->pending_payload_array;
+        int first_index = -1;
+        for (int i = 0; i < state_ptr->pending_payload_count; i++) {
+            if (TxPayloadPriorityGet(pending_array[i]) > min_priority &&
+                busy_adapter_endpoint_ptr != pending_array[i]->cdi_endpoint_handle->adapter_endpoint_ptr &&
+                (-1 == first_index || TxSchedulerPayloadIsBefore(con_state_ptr, pending_array[i],
+                                                                 pending_array[first_index]))) {
+                first_index = i;
+            }
+        }
+        if (-1 == first_index) {
+            break;
+        }
+        payload_state_ptr = pending_array[first_index];
+        state_ptr->pending_payload_count--;
+        memmove(&pending_array[first_index], &pending_array[first_index + 1],
+                (state_ptr->pending_payload_count - first_index) * sizeof(TxPayloadState*));
+
+        if (con_state_ptr->tx_state.config_data.deadline_scheduling &&
+            TxPayloadIsHopeless(con_state_ptr, payload_state_ptr)) {
+            TxPayloadDropEarly(con_state_ptr, payload_state_ptr);
+        } else {
+            state_ptr->payload_state_ptr = payload_state_ptr;
+        }
+    }
+
+    return NULL != state_ptr->payload_state_ptr;
+}
+
+/**
+ * Initialize the packetizer state for the first packet of the payload that was just received.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data.
+ */
+static void TxPacketizerPayloadStart(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr)
+{
+    TxPayloadState* payload_state_ptr = state_ptr->payload_state_ptr;
+
+    // Increment payload number. NOTE: This is done here on the read side of the queue rather than on the write side of
+    // the queue because the write side fails if the queue is full. This would cause payload_num to increment
+    // erroneously. By incrementing here on the read side, this problem is avoided.
+    payload_state_ptr->payload_packet_state.payload_num = GetNextPayloadNum(payload_state_ptr->cdi_endpoint_handle);
+
+    if (CdiLogComponentIsEnabled(con_state_ptr, kLogComponentPayloadConfig)) {
+        // Dump payload configuration to log or stdout.
+        DumpPayloadConfiguration(&payload_state_ptr->app_payload_cb_data.core_extra_data,
+                                 payload_state_ptr->app_payload_cb_data.extra_data_size,
+                                 payload_state_ptr->app_payload_cb_data.extra_data_array,
+                                 con_state_ptr->protocol_type);
+    }
+
+    // Prepare packetizer for first packet. The stream's packetization plan is not used when coalescing small fragments,
+    // since the way fragments are copied into bounce buffers is not recorded in the plan, nor for streaming payloads,
+    // whose SGL is not complete yet.
+    PacketizationPlanHandle plan_handle =
+        (con_state_ptr->tx_state.bounce_buffer_pool_handle || payload_state_ptr->streaming) ? NULL :
+        payload_state_ptr->cdi_endpoint_handle->tx_state.packetization_plan_handle;
+    PayloadPacketizerStateInit(state_ptr->packetizer_state_handle, plan_handle, payload_state_ptr);
+
+    payload_state_ptr->packetize_start_time = CdiOsGetMicroseconds();
+    if (con_state_ptr->tx_state.config_data.deadline_scheduling) {
+        CdiOsAtomicAdd32(&con_state_ptr->tx_state.deadline_in_flight_bytes,
+                         payload_state_ptr->source_sgl.total_data_size);
+    }
+
+    // Spread the packets of the payload evenly over the pacing window.
+    const uint32_t pacing_window_us = con_state_ptr->tx_state.config_data.pacing_window_microsecs;
+    payload_state_ptr->pacing_bytes_per_millisec = 0;
+    if (pacing_window_us) {
+        payload_state_ptr->pacing_bytes_per_millisec =
+            TxPacingRateGet(con_state_ptr->adapter_state_ptr, payload_state_ptr, pacing_window_us);
+    }
+
+    CdiSinglyLinkedListInit(&state_ptr->packet_list);
+    state_ptr->batch_size = TxBatchSizeNext(con_state_ptr, state_ptr, true);
+    state_ptr->last_packet = false;
+    state_ptr->parallel_next_packet_index = 0;
+
+    state_ptr->processing_state = kPayloadStateGetWorkRequest;  // Advance the state machine.
+}
+
+/**
+ * Check whether enough data of a payload is available to build its next packet. This is always the case unless the
+ * payload is a streaming one (see TxPayloadState.streaming), whose next packet can only be built once the data of a
+ * whole packet has been appended after what has been packetized so far, or else the rest of the payload.
+ *
+ * @param payload_state_ptr Pointer to payload state data.
+ *
+ * @return true if the next packet can be built.
+ */
+static bool TxPayloadDataReady(TxPayloadState* payload_state_ptr)
+{
+    if (!payload_state_ptr->streaming) {
+        return true;
+    }
+
+    CdiPayloadPacketState* packet_state_ptr = &payload_state_ptr->payload_packet_state;
+    const uint32_t appended_bytes = CdiOsAtomicLoad32(&payload_state_ptr->stream_appended_bytes);
+    // A packet never holds as many data bytes as maximum_packet_byte_size, since its header uses some of them. So the
+    // packetizer never reaches the end of the appended SGL entries unless the whole payload has been appended.
+    const bool ready = appended_bytes == (uint32_t)payload_state_ptr->source_sgl.total_data_size ||
+                       appended_bytes - packet_state_ptr->payload_data_offset >=
+                       packet_state_ptr->maximum_packet_byte_size;
+    if (ready && NULL == packet_state_ptr->source_entry_ptr) {
+        // No data had been appended yet when the payload was initialized.
+        packet_state_ptr->source_entry_ptr = payload_state_ptr->source_sgl.sgl_head_ptr;
+    }
+    return ready;
+}
+
+/**
+ * Resume packetizing the payload that is in process, enqueuing the packets to the adapter. Returns when the payload has
+ * been completely enqueued, when resources run dry or when max_packets packets have been created.
+ *
+ * The state machine goes through the states like:
+ *
+ *   +-----> idle -+
+ *   |             |
+ *   |     +-------+
+ *   |     |
+ *   |     +-> work received ->+
+ *   |                         |
+ *   |     +-------------------+
+ *   |     |
+ *   |  +->+-> get work request ->+
+ *   |  |                         |
+ *   |  |     +-------------------+
+ *   |  |     |
+ *   |  |     +-> packetizing ->+
+ *   |  |                       |
+ *   |  +<----------------------+  <-- list of packets to enqueue is incomplete
+ *   |  ^                       |
+ *   |  |  +--------------------+  <-- list of packets to enqueue is complete
+ *   |  |  |
+ *   |  |  +-> enqueueing ->+
+ *   |  |                   |
+ *   |  +-------------------+  <-- not last packet of payload
+ *   |                      |
+ *   +----------------------+  <-- last packet of the payload has been successfully queued
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data.
+ * @param max_packets Maximum number of packets to create before returning.
+ *
+ * @return true if any packets were created, otherwise false.
+ */
+static bool TxPacketizerRun(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr, int max_packets)
+{
+    int packet_count = 0;
+
+    bool keep_going = kPayloadStateGetWorkRequest == state_ptr->processing_state ||
+                      kPayloadStatePacketizing == state_ptr->processing_state ||
+                      kPayloadStateEnqueuing == state_ptr->processing_state;
+    while (keep_going) {
+        TxPayloadState* payload_state_ptr = state_ptr->payload_state_ptr;
+
+        // When the connection goes down, no need to use resources to continue creating packets or adding them to the
+        // adapter's queue. If the adapter's queue gets full it will start generating queue full log message errors.
+        AdapterEndpointHandle adapter_endpoint_handle =
+            EndpointManagerEndpointToAdapterEndpoint(payload_state_ptr->cdi_endpoint_handle);
+        if (kCdiConnectionStatusConnected != adapter_endpoint_handle->connection_status_code) {
+            break;
+        }
+        if (kPayloadStateGetWorkRequest == state_ptr->processing_state && state_ptr->parallel_next_packet_index) {
+            // The rest of the payload is built concurrently from the stream's packetization plan.
+            const int count = TxPacketizerParallelRun(con_state_ptr, state_ptr, max_packets - packet_count);
+            if (0 == count) {
+                // Pool is empty; suspend processing the payload for now, retry after resources are freed.
+                keep_going = false;
+            } else {
+                packet_count += count;
+                state_ptr->processing_state = kPayloadStateEnqueuing;
+            }
+        } else if (kPayloadStateGetWorkRequest == state_ptr->processing_state &&
+                   !TxPayloadDataReady(payload_state_ptr)) {
+            // Waiting for the application to append more data to a streaming payload. Send the packets built so far
+            // and meanwhile let any waiting payload of another endpoint use the packetizer.
+            TxPayloadState* suspended_payload_state_ptr = state_ptr->suspended.payload_state_ptr;
+            if (!CdiSinglyLinkedListIsEmpty(&state_ptr->packet_list)) {
+                state_ptr->processing_state = kPayloadStateEnqueuing;
+            } else if (TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, INT_MIN)) {
+                // Started a waiting payload.
+            } else if (suspended_payload_state_ptr && TxPayloadDataReady(suspended_payload_state_ptr)) {
+                TxPacketizerPayloadSwap(state_ptr); // Resume the suspended payload while this one waits.
+            } else {
+                keep_going = false;
+            }
+        } else if (kPayloadStateGetWorkRequest == state_ptr->processing_state) {
+            // NOTE: This pool is not thread-safe, so must ensure that only one thread is accessing it at a time.
+            if (!CdiPoolGet(con_state_ptr->tx_state.work_request_pool_handle, (void**)&state_ptr->work_request_ptr)) {
+                keep_going = false;
+            } else {
+                state_ptr->work_request_ptr->bounce_buffer_ptr = NULL; // Set once the packet has been built.
+                state_ptr->processing_state = kPayloadStatePacketizing;
+            }
+        }
+
+        if (keep_going && kPayloadStatePacketizing == state_ptr->processing_state) {
+            TxPacketWorkRequest* work_request_ptr = state_ptr->work_request_ptr;
+            // NOTE: These pools are not thread-safe, so must ensure that only one thread is accessing them at a time.
+            if (!PayloadPacketizerPacketGet(adapter_endpoint_handle->protocol_handle,
+                                            state_ptr->packetizer_state_handle, (char*)&work_request_ptr->header,
+                                            con_state_ptr->tx_state.packet_sgl_entry_pool_handle,
+                                            con_state_ptr->tx_state.bounce_buffer_pool_handle,
+                                            payload_state_ptr, &work_request_ptr->packet.sg_list,
+                                            &work_request_ptr->bounce_buffer_ptr, &state_ptr->last_packet))
+            {
+                // Pool is empty; suspend processing the payload for now, retry after resources are freed.
+                keep_going = false;
+            } else {
+#ifdef DEBUG_TX_PACKET_SGL_ENTRIES
+                DebugTxPacketSglEntries(adapter_endpoint_handle->protocol_handle, work_request_ptr);
+#endif
+                // Fill in the work request with the specifics of the packet.
+                work_request_ptr->payload_state_ptr = payload_state_ptr;
+                work_request_ptr->payload_num = payload_state_ptr->payload_packet_state.payload_num;
+                work_request_ptr->packet_payload_size =
+                    payload_state_ptr->payload_packet_state.packet_payload_data_size;
+
+                // This pointer will be used later by TxPacketWorkRequestComplete() to get access to work_request_ptr (a
+                // pointer to a TxPacketWorkRequest structure).
+                work_request_ptr->packet.sg_list.internal_data_ptr = work_request_ptr;
+
+                // Set flag for last packet of the payload so ACKs received can keep track of the number of in-flight
+                // payloads.
+                work_request_ptr->packet.payload_last_packet = state_ptr->last_packet;
+                work_request_ptr->packet.tx_state.pacing_bytes_per_millisec =
+                    payload_state_ptr->pacing_bytes_per_millisec;
+
+                // Add the packet to a list to be enqueued to the adapter.
+                CdiSinglyLinkedListPushTail(&state_ptr->packet_list, &work_request_ptr->packet.list_entry);
+                // Increment reference counter once for each packet.
+                CdiOsAtomicInc32(&payload_state_ptr->cdi_endpoint_handle->adapter_endpoint_ptr->tx_in_flight_ref_count);
+                packet_count++;
+
+                // Hand the rest of a large payload over to the helpers once the packetizer knows it can be built from
+                // the stream's packetization plan.
+                if (!state_ptr->last_packet && state_ptr->helper_count) {
+                    const int packets_left = PayloadPacketizerParallelPacketsLeft(state_ptr->packetizer_state_handle);
+                    if (packets_left >= TX_PARALLEL_PACKETIZE_MIN_PACKETS) {
+                        state_ptr->parallel_next_packet_index =
+                            payload_state_ptr->payload_packet_state.packet_sequence_num;
+                        state_ptr->parallel_end_packet_index = state_ptr->parallel_next_packet_index + packets_left;
+                    }
+                }
+
+                state_ptr->processing_state = (state_ptr->last_packet || packet_count >= max_packets ||
+                                    CdiSinglyLinkedListSize(&state_ptr->packet_list) >= state_ptr->batch_size) ?
+                                    kPayloadStateEnqueuing : kPayloadStateGetWorkRequest;
+            }
+        }
+
+        if (kPayloadStateEnqueuing == state_ptr->processing_state) {
+            // Enqueue packets. packet_list is copied so it can simply be initialized here to start fresh.
+            if (kCdiStatusOk != CdiAdapterEnqueueSendPackets(adapter_endpoint_handle, &state_ptr->packet_list)) {
+                keep_going = false;
+            } else {
+                TxBatchSizeRecord(payload_state_ptr->cdi_endpoint_handle,
+                                  CdiSinglyLinkedListSize(&state_ptr->packet_list));
+                CdiSinglyLinkedListInit(&state_ptr->packet_list);
+                state_ptr->batch_size = TxBatchSizeNext(con_state_ptr, state_ptr, false);
+
+                if (state_ptr->last_packet && state_ptr->suspended.payload_state_ptr) {
+                    // Start the next payload of a stream with a higher priority than the suspended one, if any, or
+                    // else resume the suspended payload.
+                    const int priority = TxPayloadPriorityGet(state_ptr->suspended.payload_state_ptr);
+                    if (TxSchedulerPayloadSelect(con_state_ptr, state_ptr, priority)) {
+                        TxPacketizerPayloadStart(con_state_ptr, state_ptr);
+                    } else {
+                        TxPacketizerPayloadSwap(state_ptr);
+                        state_ptr->suspended.payload_state_ptr = NULL;
+                        state_ptr->last_packet = false;
+                        state_ptr->processing_state = kPayloadStateGetWorkRequest;
+                    }
+                    keep_going = packet_count < max_packets;
+                    con_state_ptr->back_pressure_state = kCdiBackPressureNone;
+                } else if (state_ptr->last_packet) {
+                    // The last packet of the payload has been sent; reset to start a new one.
+                    state_ptr->processing_state = kPayloadStateIdle;
+                    state_ptr->payload_state_ptr = NULL;
+                    keep_going = false;
+                    // Successfully put all packets for a payload into Tx queue, so reset the back pressure state.
+                    con_state_ptr->back_pressure_state = kCdiBackPressureNone;
+                } else {
+                    // Packets of higher priority streams are interleaved with the rest of the payload. A streaming
+                    // payload that was suspended while waiting for data is resumed as soon as it has some.
+                    TxPayloadState* suspended_payload_state_ptr = state_ptr->suspended.payload_state_ptr;
+                    if (suspended_payload_state_ptr && suspended_payload_state_ptr->streaming &&
+                        TxPayloadPriorityGet(suspended_payload_state_ptr) >= TxPayloadPriorityGet(payload_state_ptr) &&
+                        TxPayloadDataReady(suspended_payload_state_ptr)) {
+                        TxPacketizerPayloadSwap(state_ptr);
+                    } else {
+                        TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, TxPayloadPriorityGet(payload_state_ptr));
+                    }
+                    state_ptr->processing_state = kPayloadStateGetWorkRequest;
+                    keep_going = packet_count < max_packets;
+                }
+            }
+        }
+    }
+
+    return 0 != packet_count;
+}
+
+/**
+ * Payload thread used to transmit a payload. Not used when the connection is configured to run to completion, in
+ * which case TxPollProcess() does the same work on the adapter's poll thread.
  *
  * @param ptr Pointer to thread specific data. In this case, a pointer to CdiConnectionState.
  *
@@ -141,8 +1014,8 @@ static CDI_THREAD TxPayloadThread(void* ptr)
     CdiConnectionState* con_state_ptr = (CdiConnectionState*)ptr;
 
     // Get a state tracker object for the packetizer.
-    CdiPacketizerStateHandle packetizer_state_handle = PayloadPacketizerCreate();
-    if (NULL == packetizer_state_handle) {
+    TxPacketizerState* packetizer_state_ptr = TxPacketizerStateCreate(con_state_ptr);
+    if (NULL == packetizer_state_ptr) {
         CDI_LOG_THREAD(kLogError, "Failed to create packetizer state.");
         return 0;
     }
@@ -158,68 +1031,30 @@ static CDI_THREAD TxPayloadThread(void* ptr)
 
     CdiSignalType comp_queue_signal = CdiQueueGetPopWaitSignal(con_state_ptr->tx_state.work_req_comp_queue_handle);
 
-    CdiSignalType signal_array[2] = { notification_signal, comp_queue_signal };
+    CdiSignalType payload_data_signal = con_state_ptr->tx_state.payload_data_signal;
 
-    // Packets are sent to the endpoint in batches starting with a single packet. The number is doubled with each
-    // batch. This gives a quick start but as the queue backs up, the larger batch sizes lead to higher efficiency
-    // per batch.
-    int batch_size = 1;
-
-    // These variable are used only within the scope of the while loop below but they must be declared outside of it
-    // since their values need to start initialized but not get reinitialized every time through.
-    bool last_packet = false;
-    TxPacketWorkRequest* work_request_ptr = NULL;
-    CdiSinglyLinkedList packet_list;
-    CdiSinglyLinkedListInit(&packet_list);
-
-    // The state machine goes through the states like:
-    //
-    //   +-----> idle -+
-    //   |             |
-    //   |     +-------+
-    //   |     |
-    //   |     +-> work received ->+
-    //   |                         |
-    //   |     +-------------------+
-    //   |     |
-    //   |  +->+-> get work request ->+
-    //   |  |                         |
-    //   |  |     +-------------------+
-    //   |  |     |
-    //   |  |     +-> packetizing ->+
-    //   |  |                       |
-    //   |  +<----------------------+  <-- list of packets to enqueue is incomplete
-    //   |  ^                       |
-    //   |  |  +--------------------+  <-- list of packets to enqueue is complete
-    //   |  |  |
-    //   |  |  +-> enqueueing ->+
-    //   |  |                   |
-    //   |  +-------------------+  <-- not last packet of payload
-    //   |                      |
-    //   +----------------------+  <-- last packet of the payload has been successfully queued
-    enum {
-        kPayloadStateIdle,           // No payload is in process: wait for payload from queue.
-        kPayloadStateWorkReceived,   // A payload was received to be transmitted: initialize for first packet.
-        kPayloadStateGetWorkRequest, // Payload and packetizer initialized: get a work request from pool.
-        kPayloadStatePacketizing,    // Have work request: build SGL.
-        kPayloadStateEnqueuing       // Have completed list of work requests: queued to the adapter.
-    } payload_processing_state = kPayloadStateIdle;
+    CdiSignalType signal_array[3] = { notification_signal, comp_queue_signal, payload_data_signal };
 
     // This loop should only block at the call to CdiQueuePopWaitMultiple(). If a pool runs dry or the output queue is
     // full, the logic inside of the loop should maintain enough state to suspend the process of packetizing the current
     // payload and resume when resources are available.
-    TxPayloadState* payload_state_ptr = NULL;
     while (!CdiOsSignalGet(con_state_ptr->shutdown_signal) && !EndpointManagerIsConnectionShuttingDown(mgr_handle)) {
         uint32_t signal_index = 0;
         bool payload_received = false;
-        if (kPayloadStateIdle == payload_processing_state) {
+        if (kPayloadStateIdle == packetizer_state_ptr->processing_state &&
+                packetizer_state_ptr->pending_payload_count && !CdiOsSignalReadState(notification_signal)) {
+            // Payloads are already waiting to be scheduled, so don't wait for more.
+            payload_received = true;
+        } else if (kPayloadStateIdle == packetizer_state_ptr->processing_state) {
             // Wait for work from the payload queue, the work request complete queue, or a signal from the endpoint
             // manager.
             payload_received = CdiQueuePopWaitMultiple(con_state_ptr->tx_state.payload_queue_handle, CDI_INFINITE,
-                                                       signal_array, 2, &signal_index, (void**)&payload_state_ptr);
+                                                       signal_array, 3, &signal_index,
+                                                       (void**)&packetizer_state_ptr->payload_state_ptr);
         } else {
-            // A payload is currently in process. Wait for completion requests or a signal from the Endpoint Manager.
-            CdiOsSignalsWait(signal_array, 2, false, CDI_INFINITE, &signal_index);
+            // A payload is currently in process. Wait for completion requests, more data for a streaming payload or a
+            // signal from the Endpoint Manager.
+            CdiOsSignalsWait(signal_array, 3, false, CDI_INFINITE, &signal_index);
         }
         if (!payload_received) {
             // Either processing an existing payload or did not get a new one. Got a signal from either the Endpoint
@@ -230,14 +1065,23 @@ static CDI_THREAD TxPayloadThread(void* ptr)
                 // An Endpoint Manager state change means that Tx resources have been flushed or queued to be flushed,
                 // including the current Tx payload that we could be processing. Reset our current payload state back to
                 // idle. Allow the logic to drop below so if needed ProcessWorkRequestCompletionQueue() is invoked.
-                payload_processing_state = kPayloadStateIdle;
-                payload_state_ptr = NULL;
+                // Waiting and suspended payloads were flushed too.
+                TxPacketizerStateReset(packetizer_state_ptr);
+            }
+        } else if (packetizer_state_ptr->pending_payload_array) {
+            // The payload just received (if any) waits with the others and the most urgent one is started instead.
+            if (packetizer_state_ptr->payload_state_ptr) {
+                TxSchedulerPayloadAdd(con_state_ptr, packetizer_state_ptr, packetizer_state_ptr->payload_state_ptr);
+            }
+            if (TxSchedulerPayloadSelect(con_state_ptr, packetizer_state_ptr, INT_MIN)) {
+                packetizer_state_ptr->processing_state = kPayloadStateWorkReceived;
             }
         } else {
-            payload_processing_state = kPayloadStateWorkReceived;
+            packetizer_state_ptr->processing_state = kPayloadStateWorkReceived;
             // Increment reference counter once at the start of each payload. This will keep the PollThread() working as
             // long as we have payloads and their related packets to send.
-            CdiOsAtomicInc32(&payload_state_ptr->cdi_endpoint_handle->adapter_endpoint_ptr->tx_in_flight_ref_count);
+            CdiOsAtomicInc32(&packetizer_state_ptr->payload_state_ptr->cdi_endpoint_handle->adapter_endpoint_ptr->
+                             tx_in_flight_ref_count);
             CdiOsSignalSet(con_state_ptr->adapter_connection_ptr->tx_poll_do_work_signal);
         }
 
@@ -247,119 +1091,19 @@ static CDI_THREAD TxPayloadThread(void* ptr)
             ProcessWorkRequestCompletionQueue(con_state_ptr);
         }
 
+        // Data appended to a streaming payload from now on sets the signal again, so none is missed.
+        CdiOsSignalClear(payload_data_signal);
+
         // Either resume work on a payload in progress or start a new one.
-        if (kPayloadStateWorkReceived == payload_processing_state) {
+        if (kPayloadStateWorkReceived == packetizer_state_ptr->processing_state) {
             // No packet was in progress so start by initializing for the first one.
-
-            // Increment payload number. NOTE: This is done here on the read side of the queue rather than on the write
-            // side of the queue because the write side fails if the queue is full. This would cause payload_num to
-            // increment erroneously. By incrementing here on the read side, this problem is avoided.
-            payload_state_ptr->payload_packet_state.payload_num =
-                GetNextPayloadNum(payload_state_ptr->cdi_endpoint_handle);
-
-            if (CdiLogComponentIsEnabled(con_state_ptr, kLogComponentPayloadConfig)) {
-                // Dump payload configuration to log or stdout.
-                DumpPayloadConfiguration(&payload_state_ptr->app_payload_cb_data.core_extra_data,
-                                         payload_state_ptr->app_payload_cb_data.extra_data_size,
-                                         payload_state_ptr->app_payload_cb_data.extra_data_array,
-                                         con_state_ptr->protocol_type);
-            }
-
-            // Prepare packetizer for first packet.
-            PayloadPacketizerStateInit(packetizer_state_handle);
-
-            CdiSinglyLinkedListInit(&packet_list);
-            batch_size = 1;
-            last_packet = false;
-
-            payload_processing_state = kPayloadStateGetWorkRequest;  // Advance the state machine.
-        }
-
-        bool keep_going = kPayloadStateGetWorkRequest == payload_processing_state ||
-                          kPayloadStatePacketizing == payload_processing_state ||
-                          kPayloadStateEnqueuing == payload_processing_state;
-        while (keep_going) {
-            // When the connection goes down, no need to use resources to continue creating packets or adding them to
-            // the adapter's queue. If the adapter's queue gets full it will start generating queue full log message
-            // errors.
-            AdapterEndpointHandle adapter_endpoint_handle =
-                EndpointManagerEndpointToAdapterEndpoint(payload_state_ptr->cdi_endpoint_handle);
-            if (kCdiConnectionStatusConnected != adapter_endpoint_handle->connection_status_code) {
-                break;
-            }
-            if (kPayloadStateGetWorkRequest == payload_processing_state) {
-                // NOTE: This pool is not thread-safe, so must ensure that only one thread is accessing it at a time.
-                if (!CdiPoolGet(con_state_ptr->tx_state.work_request_pool_handle, (void**)&work_request_ptr)) {
-                    keep_going = false;
-                } else {
-                    payload_processing_state = kPayloadStatePacketizing;
-                }
-            }
-
-            if (keep_going && kPayloadStatePacketizing == payload_processing_state) {
-                // NOTE: These pools are not thread-safe, so must ensure that only one thread is accessing them at a
-                // time.
-                if (!PayloadPacketizerPacketGet(adapter_endpoint_handle->protocol_handle,
-                                                packetizer_state_handle, (char*)&work_request_ptr->header,
-                                                con_state_ptr->tx_state.packet_sgl_entry_pool_handle,
-                                                payload_state_ptr, &work_request_ptr->packet.sg_list, &last_packet))
-                {
-                    // Pool is empty; suspend processing the payload for now, retry after resources are freed.
-                    keep_going = false;
-                } else {
-#ifdef DEBUG_TX_PACKET_SGL_ENTRIES
-                    DebugTxPacketSglEntries(adapter_endpoint_handle->protocol_handle, work_request_ptr);
-#endif
-                    // Fill in the work request with the specifics of the packet.
-                    work_request_ptr->payload_state_ptr = payload_state_ptr;
-                    work_request_ptr->payload_num = payload_state_ptr->payload_packet_state.payload_num;
-                    work_request_ptr->packet_payload_size =
-                        payload_state_ptr->payload_packet_state.packet_payload_data_size;
-
-                    // This pointer will be used later by TxPacketWorkRequestComplete() to get access to
-                    // work_request_ptr (a pointer to a TxPacketWorkRequest structure).
-                    work_request_ptr->packet.sg_list.internal_data_ptr = work_request_ptr;
-
-                    // Set flag for last packet of the payload so ACKs received can keep track of the number of
-                    // in-flight payloads.
-                    work_request_ptr->packet.payload_last_packet = last_packet;
-
-                    // Add the packet to a list to be enqueued to the adapter.
-                    CdiSinglyLinkedListPushTail(&packet_list, &work_request_ptr->packet.list_entry);
-                    // Increment reference counter once for each packet.
-                    CdiOsAtomicInc32(&payload_state_ptr->cdi_endpoint_handle->adapter_endpoint_ptr->tx_in_flight_ref_count);
-
-                    payload_processing_state = (last_packet || CdiSinglyLinkedListSize(&packet_list) >= batch_size) ?
-                        kPayloadStateEnqueuing : kPayloadStateGetWorkRequest;
-                }
-            }
-
-            if (kPayloadStateEnqueuing == payload_processing_state) {
-                // Enqueue packets. packet_list is copied so it can simply be initialized here to start fresh.
-                if (kCdiStatusOk != CdiAdapterEnqueueSendPackets(
-                        EndpointManagerEndpointToAdapterEndpoint(payload_state_ptr->cdi_endpoint_handle),
-                        &packet_list)) {
-                    keep_going = false;
-                } else {
-                    CdiSinglyLinkedListInit(&packet_list);
-                    batch_size *= 2;
-
-                    if (last_packet) {
-                        // The last packet of the payload has been sent; reset to start a new one.
-                        payload_processing_state = kPayloadStateIdle;
-                        payload_state_ptr = NULL;
-                        keep_going = false;
-                        // Successfully put all packets for a payload into Tx queue, so reset the back pressure state.
-                        con_state_ptr->back_pressure_state = kCdiBackPressureNone;
-                    } else {
-                        payload_processing_state = kPayloadStateGetWorkRequest;
-                    }
-                }
-            }
+            TxPacketizerPayloadStart(con_state_ptr, packetizer_state_ptr);
         }
+
+        TxPacketizerRun(con_state_ptr, packetizer_state_ptr, INT_MAX);
     }
 
-    PayloadPacketizerDestroy(packetizer_state_handle);
+    TxPacketizerStateDestroy(packetizer_state_ptr);
     if (EndpointManagerIsConnectionShuttingDown(mgr_handle)) {
         // Since this thread was registered with the Endpoint Manager using EndpointManagerThreadRegister(), need to
         // wait for the Endpoint Manager to complete the shutdown.
@@ -426,6 +1170,25 @@ static CdiReturnStatus TxCreateConnection(CdiConnectionProtocolType protocol_typ
         // Save callback address.
         con_state_ptr->tx_state.cb_ptr = tx_cb_ptr;
     }
+
+    if (kCdiStatusOk == rs && NULL == tx_cb_ptr && NULL == config_data_ptr->completion_queue_handle) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Either a Tx callback function or a completion queue must be specified.");
+        rs = kCdiStatusInvalidParameter;
+    }
+    if (kCdiStatusOk == rs && (config_data_ptr->batch_policy < kCdiTxBatchPolicyDoubling ||
+                               config_data_ptr->batch_policy > kCdiTxBatchPolicyAdaptive)) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError, "Invalid batch_policy[%d].",
+                       config_data_ptr->batch_policy);
+        rs = kCdiStatusInvalidParameter;
+    }
+    if (kCdiStatusOk == rs && (config_data_ptr->packetizer_helper_count < 0 ||
+                               config_data_ptr->packetizer_helper_count > TX_PACKETIZER_MAX_HELPERS)) {
+        CDI_LOG_HANDLE(cdi_global_context.global_log_handle, kLogError,
+                       "Invalid packetizer_helper_count[%d]. Must be between 0 and %d.",
+                       config_data_ptr->packetizer_helper_count, TX_PACKETIZER_MAX_HELPERS);
+        rs = kCdiStatusInvalidParameter;
+    }
     // Now that we have a connection logger, we can use the CDI_LOG_HANDLE() macro to add log messages to it. Since this
     // thread is from the application, we cannot use the CDI_LOG_THEAD() macro.
 
@@ -489,8 +1252,21 @@ static CdiReturnStatus TxCreateConnection(CdiConnectionProtocolType protocol_typ
             rs = kCdiStatusNotEnoughMemory;
         }
     }
+    if (kCdiStatusOk == rs && !CdiOsSignalCreate(&con_state_ptr->tx_state.payload_data_signal)) {
+        rs = kCdiStatusNotEnoughMemory;
+    }
+    if (kCdiStatusOk == rs && !CdiOsCritSectionCreate(&con_state_ptr->tx_state.stream_lock)) {
+        rs = kCdiStatusNotEnoughMemory;
+    }
 
-    if (kCdiStatusOk == rs) {
+    if (kCdiStatusOk == rs && config_data_ptr->run_to_completion) {
+        // Payloads are packetized by TxPollProcess() on the adapter's poll thread, so create its packetizer state
+        // instead of a worker thread.
+        con_state_ptr->tx_state.poll_packetizer_state_ptr = TxPacketizerStateCreate(con_state_ptr);
+        if (NULL == con_state_ptr->tx_state.poll_packetizer_state_ptr) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    } else if (kCdiStatusOk == rs) {
         // Create worker thread.
         if (!CdiOsThreadCreate(TxPayloadThread, &con_state_ptr->payload_thread_id, "TxPayload", con_state_ptr,
                                 con_state_ptr->start_signal)) {
@@ -499,8 +1275,8 @@ static CdiReturnStatus TxCreateConnection(CdiConnectionProtocolType protocol_typ
     }
 
     // Create memory pools. NOTE: These pools do not use any resource locks and are therefore not thread-safe.
-    // TxPayloadThread() is the only user of the pools, except when restarting/shutting down the connection which is
-    // done by EndpointManagerThread() while TxPayloadThread() is blocked.
+    // TxPayloadThread() (or the poll thread when running to completion) is the only user of the pools, except when
+    // restarting/shutting down the connection which is done by EndpointManagerThread() while that thread is blocked.
     if (kCdiStatusOk == rs) {
         if (!CdiPoolCreate("Connection Tx TxPacketWorkRequest Pool", MAX_TX_PACKET_WORK_REQUESTS_PER_CONNECTION,
                            MAX_TX_PACKET_WORK_REQUESTS_PER_CONNECTION_GROW, MAX_POOL_GROW_COUNT,
@@ -516,6 +1292,9 @@ static CdiReturnStatus TxCreateConnection(CdiConnectionProtocolType protocol_typ
             rs = kCdiStatusNotEnoughMemory;
         }
     }
+    if (kCdiStatusOk == rs && config_data_ptr->coalesce_small_fragments) {
+        rs = BounceBufferPoolCreate(con_state_ptr);
+    }
     if (kCdiStatusOk == rs) {
         // There is a limit on the number of simultaneous Tx payloads per connection, so don't allow this pool to grow.
         if (!CdiPoolCreate("Connection Tx Payload State Pool", max_tx_payloads,
@@ -581,6 +1360,26 @@ static CdiReturnStatus TxCreateConnection(CdiConnectionProtocolType protocol_typ
     return rs;
 }
 
+/**
+ * Post a payload's message to the queue of the thread that notifies the application. TxPayloadPrepare() makes sure the
+ * queue has room for it.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param payload_state_ptr Pointer to payload state data.
+ */
+static void AppPayloadMessagePost(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr)
+{
+    // Count the message before it can be popped, so the count is never lower than the number of queued messages.
+    CdiOsAtomicInc32(&con_state_ptr->tx_state.app_payload_message_count);
+    if (!CdiQueuePush(con_state_ptr->app_payload_message_queue_handle, &payload_state_ptr->app_payload_cb_data)) {
+        CDI_LOG_THREAD(kLogError, "Queue[%s] full, push failed.",
+                       CdiQueueGetName(con_state_ptr->app_payload_message_queue_handle));
+        CdiOsAtomicDec32(&con_state_ptr->tx_state.app_payload_message_count);
+    } else {
+        WorkerPoolTaskSchedule(&con_state_ptr->app_payload_message_task); // Does nothing if worker pool not in use.
+    }
+}
+
 /**
  * Payload transfer has completed either successfully or in error. Update stats and queue payload message to
  * application.
@@ -596,17 +1395,42 @@ static void PayloadTransferComplete(CdiEndpointState* endpoint_ptr, TxPayloadSta
         kCdiStatusOk == payload_state_ptr->app_payload_cb_data.payload_status_code,
         payload_state_ptr->start_time, payload_state_ptr->max_latency_microsecs,
         payload_state_ptr->data_bytes_transferred);
+    if (con_state_ptr->tx_state.bounce_buffer_pool_handle) {
+        CdiPayloadCounterStats* counter_stats_ptr = &endpoint_ptr->transfer_stats.payload_counter_stats;
+        CdiOsAtomicAdd64(&counter_stats_ptr->num_bytes_bounced,
+                         payload_state_ptr->payload_packet_state.bounced_byte_count);
+        CdiOsAtomicAdd64(&counter_stats_ptr->num_bytes_zero_copy,
+                         payload_state_ptr->payload_packet_state.zero_copy_byte_count);
+    }
+    if (con_state_ptr->tx_state.config_data.deadline_scheduling) {
+        TxConState* tx_state_ptr = &con_state_ptr->tx_state;
+        const uint32_t payload_size = payload_state_ptr->source_sgl.total_data_size;
+        CdiOsAtomicAdd32(&tx_state_ptr->deadline_in_flight_bytes, -(int32_t)payload_size);
+        if (kCdiStatusOk == payload_state_ptr->app_payload_cb_data.payload_status_code) {
+            // Only count the time the payload was actually being sent, not the time it waited for the one ahead of it,
+            // and keep a running average of the rate.
+            const uint64_t now = CdiOsGetMicroseconds();
+            const uint64_t send_time = now - CDI_MAX(payload_state_ptr->packetize_start_time,
+                                                     tx_state_ptr->deadline_last_complete_time);
+            tx_state_ptr->deadline_last_complete_time = now;
+            if (send_time) {
+                const uint64_t rate = CDI_MIN((uint64_t)payload_size * 1000 / send_time, UINT32_MAX);
+                const uint32_t average = CdiOsAtomicLoad32(&tx_state_ptr->deadline_bytes_per_millisec);
+                CdiOsAtomicStore32(&tx_state_ptr->deadline_bytes_per_millisec,
+                                   average ? (uint32_t)((average * 7ULL + rate) / 8) : (uint32_t)rate);
+            }
+        }
+    }
 
     // Copy the payload's source SGL to the callback data, so we can free the SGL entries in AppCallbackPayloadThread()
     // to reduce the amount of work required here by the Tx Poll() thread. This also allows the payload_state_ptr to
-    // be freed in this function, since it is no longer needed.
+    // be freed in this function, since it is no longer needed. A streaming payload that failed may still have data
+    // appended to it, so stop that first.
+    TxPayloadStreamClose(con_state_ptr, payload_state_ptr);
     payload_state_ptr->app_payload_cb_data.tx_source_sgl = payload_state_ptr->source_sgl;
 
     // Post message to notify application that payload transfer has completed.
-    if (!CdiQueuePush(con_state_ptr->app_payload_message_queue_handle, &payload_state_ptr->app_payload_cb_data)) {
-        CDI_LOG_THREAD(kLogError, "Queue[%s] full, push failed.",
-                        CdiQueueGetName(con_state_ptr->app_payload_message_queue_handle));
-    }
+    AppPayloadMessagePost(con_state_ptr, payload_state_ptr);
 
     // Done with payload state data, so free it.
     CdiPoolPut(con_state_ptr->tx_state.payload_state_pool_handle, payload_state_ptr);
@@ -625,11 +1449,68 @@ static void FlushFailedPayload(CdiEndpointState* endpoint_ptr, TxPayloadState* p
         payload_state_ptr->app_payload_cb_data.payload_status_code = kCdiStatusSendFailed;
     }
 
-    // Clear this list. It will be cleared by TxPayloadThreadFlushResources(). See packet_sgl_entry_pool_handle pool.
-    CdiSinglyLinkedListInit(&payload_state_ptr->completed_packets_list);
+    // Clear this list. It will be cleared by TxPayloadThreadFlushResources(). See packet_sgl_entry_pool_handle pool.
+    CdiSinglyLinkedListInit(&payload_state_ptr->completed_packets_list);
+
+    // Queue message to the application.
+    PayloadTransferComplete(endpoint_ptr, payload_state_ptr);
+}
+
+/**
+ * Free the work request of a packet that has been acknowledged, and determine whether its payload has been completely
+ * sent. The adapter endpoint's in-flight count must already have been updated for the packet.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param packet_ptr Pointer to packet state data. Its list entry is reused.
+ */
+static void WorkRequestComplete(CdiEndpointState* endpoint_ptr, Packet* packet_ptr)
+{
+    CdiConnectionState* con_state_ptr = endpoint_ptr->connection_state_ptr;
+
+    if (kAdapterPacketStatusNotConnected == packet_ptr->tx_state.ack_status) {
+        return;
+    }
+
+    // The internal_data_ptr contains a work request pointer that was set in TxPayloadThread().
+    TxPacketWorkRequest* work_request_ptr = (TxPacketWorkRequest*)packet_ptr->sg_list.internal_data_ptr;
+
+    // Now that we have our work request, we can setup additional state data pointers.
+    TxPayloadState* payload_state_ptr = work_request_ptr->payload_state_ptr;
+
+    // Check if the packet is from the payload that we are currently processing.
+    if (payload_state_ptr->payload_packet_state.payload_num != work_request_ptr->payload_num) {
+        CDI_LOG_THREAD(kLogWarning, "Connection[%s] packet for payload[%d] not from current payload[%d]",
+                       endpoint_ptr->connection_state_ptr->saved_connection_name_str,
+                       payload_state_ptr->payload_packet_state.payload_num, work_request_ptr->payload_num);
+    } else {
+        payload_state_ptr->data_bytes_transferred += work_request_ptr->packet_payload_size;
+
+        if (kPayloadTypeKeepAlive == payload_state_ptr->payload_packet_state.payload_type) {
+            // Payload type is keep alive. Keep it internal and do not use the application callback. Nothing special to
+            // do here, unless payload data was allocated dynamically using a pool. If so, will need to free it here.
+        } else {
+            CdiSinglyLinkedListPushTail(&payload_state_ptr->completed_packets_list,
+                                        (void*)&work_request_ptr->packet.list_entry);
 
-    // Queue message to the application.
-    PayloadTransferComplete(endpoint_ptr, payload_state_ptr);
+            if (payload_state_ptr->data_bytes_transferred >= payload_state_ptr->source_sgl.total_data_size) {
+                // Payload transfer complete. Pointer is freed below in PayloadTransferComplete(). Clear it now so it
+                // cannot be accidentally used later.
+                work_request_ptr->payload_state_ptr = NULL;
+
+                // Put list of work requests in queue so TxPayloadThread() can free the allocated resources.
+                if (!CdiQueuePush(con_state_ptr->tx_state.work_req_comp_queue_handle,
+                                  &payload_state_ptr->completed_packets_list)) {
+                    CDI_LOG_THREAD(kLogError, "Queue[%s] full, push failed.",
+                                   CdiQueueGetName(con_state_ptr->tx_state.work_req_comp_queue_handle));
+                }
+                work_request_ptr = NULL; // Pointer may no longer be valid, so clear it now.
+
+                // Updates stats and puts message in queue to call the user registered Tx callback function.
+                PayloadTransferComplete(endpoint_ptr, payload_state_ptr);
+                payload_state_ptr = NULL; // Pointer is no longer valid.
+            }
+        }
+    }
 }
 
 //*********************************************************************************************************************
@@ -659,16 +1540,21 @@ CdiReturnStatus TxStreamConnectionCreateInternal(CdiTxConfigData* config_data_pt
 CdiReturnStatus TxStreamEndpointCreateInternal(CdiConnectionHandle handle, CdiTxConfigDataStream* stream_config_ptr,
                                                CdiEndpointHandle* ret_handle_ptr)
 {
-    return EndpointManagerTxCreateEndpoint(handle->endpoint_manager_handle, true,
-                                           stream_config_ptr->dest_ip_addr_str, stream_config_ptr->dest_port,
-                                           stream_config_ptr->stream_name_str, ret_handle_ptr);
+    CdiReturnStatus rs = EndpointManagerTxCreateEndpoint(handle->endpoint_manager_handle, true,
+                                                         stream_config_ptr->dest_ip_addr_str,
+                                                         stream_config_ptr->dest_port,
+                                                         stream_config_ptr->stream_name_str, ret_handle_ptr);
+    if (kCdiStatusOk == rs) {
+        (*ret_handle_ptr)->tx_state.priority = stream_config_ptr->priority;
+    }
+    return rs;
 }
 
-CdiReturnStatus TxPayloadInternal(CdiEndpointState* endpoint_ptr, const CdiCoreTxPayloadConfig* core_payload_config_ptr,
-                                  const CdiSgList* sgl_ptr, int max_latency_microsecs, int extra_data_size,
-                                  uint8_t* extra_data_ptr)
+CdiReturnStatus TxPayloadPrepare(CdiEndpointState* endpoint_ptr, const CdiCoreTxPayloadConfig* core_payload_config_ptr,
+                                 const CdiSgList* sgl_ptr, int max_latency_microsecs, int extra_data_size,
+                                 uint8_t* extra_data_ptr, TxPayloadState** ret_payload_state_ptr)
 {
-    assert(sgl_ptr->total_data_size > 0);
+    assert(NULL == sgl_ptr || sgl_ptr->total_data_size > 0);
 
     uint64_t start_time = CdiOsGetMicroseconds();
     CdiReturnStatus rs = kCdiStatusOk;
@@ -686,6 +1572,15 @@ CdiReturnStatus TxPayloadInternal(CdiEndpointState* endpoint_ptr, const CdiCoreT
         // No free entries are available. Since this pool does not dynamically grow the queue used below must be full,
         // so return the queue full status here.
         rs = kCdiStatusQueueFull;
+    } else if (CdiPoolGetTotalItemCount(con_state_ptr->tx_state.payload_state_pool_handle) -
+               CdiPoolGetFreeItemCount(con_state_ptr->tx_state.payload_state_pool_handle) +
+               (int)CdiOsAtomicLoad32(&con_state_ptr->tx_state.app_payload_message_count) >
+               MAX_PAYLOADS_PER_CONNECTION) {
+        // Every payload in flight posts a message to app_payload_message_queue_handle when it completes. The messages
+        // back up while the application is slow to take completions (see TxInvokeAppPayloadCallback()), so don't
+        // accept the payload unless there is room for its message.
+        CdiPoolPut(con_state_ptr->tx_state.payload_state_pool_handle, payload_state_ptr);
+        rs = kCdiStatusQueueFull;
     } else {
         memset((void*)payload_state_ptr, 0, sizeof(TxPayloadState));
 
@@ -725,31 +1620,395 @@ CdiReturnStatus TxPayloadInternal(CdiEndpointState* endpoint_ptr, const CdiCoreT
 
         payload_state_ptr->cdi_endpoint_handle = endpoint_ptr; // Save the endpoint used to send this payload.
 
-        if (!PayloadInit(con_state_ptr, sgl_ptr, payload_state_ptr)) {
+        const CdiSgList empty_sgl = { 0 };
+        if (!PayloadInit(con_state_ptr, sgl_ptr ? sgl_ptr : &empty_sgl, payload_state_ptr)) {
             rs = kCdiStatusAllocationFailed;
-        } else {
-            // Put Tx payload message into the payload queue. The TxPayloadThread() thread will then process the
-            // message. Don't block here and wait if the queue is full, return an error.
-            if (!CdiQueuePush(con_state_ptr->tx_state.payload_queue_handle, &payload_state_ptr)) {
-                // Queue was full, put the allocated memory back in the pools.
-                rs = kCdiStatusQueueFull;
-            }
+            TxPayloadRelease(con_state_ptr, payload_state_ptr);
+            payload_state_ptr = NULL;
         }
+    }
 
-        if (kCdiStatusOk != rs) {
-            // An error occurred, so free pool buffers reserved here and in CdiPayloadInit().
-            CdiSglEntry* entry_ptr = payload_state_ptr->source_sgl.sgl_head_ptr;
-            while (entry_ptr) {
-                CdiSglEntry* next_ptr = entry_ptr->next_ptr; // Save next entry, since Put() will free its memory.
-                CdiPoolPut(con_state_ptr->tx_state.payload_sgl_entry_pool_handle, entry_ptr);
-                entry_ptr = next_ptr;
+    *ret_payload_state_ptr = payload_state_ptr;
+
+    return rs;
+}
+
+TxPacketizerState* TxPacketizerStateCreate(CdiConnectionState* con_state_ptr)
+{
+    TxPacketizerState* state_ptr = CdiOsMemAllocZero(sizeof(TxPacketizerState));
+    if (state_ptr) {
+        TxPacketizerStateReset(state_ptr);
+        state_ptr->packetizer_state_handle = PayloadPacketizerCreate();
+        if (NULL == state_ptr->packetizer_state_handle) {
+            CdiOsMemFree(state_ptr);
+            state_ptr = NULL;
+        }
+    }
+    if (state_ptr) {
+        TxPacketizerHelpersCreate(con_state_ptr, state_ptr);
+        TxSchedulerCreate(con_state_ptr, state_ptr);
+    }
+
+    return state_ptr;
+}
+
+void TxPacketizerStateDestroy(TxPacketizerState* state_ptr)
+{
+    if (state_ptr) {
+        TxSchedulerDestroy(state_ptr);
+        TxPacketizerHelpersDestroy(state_ptr);
+        PayloadPacketizerDestroy(state_ptr->packetizer_state_handle);
+        CdiOsMemFree(state_ptr);
+    }
+}
+
+TxPayloadState* TxPacketizerPayloadGet(const TxPacketizerState* state_ptr, bool suspended)
+{
+    return suspended ? state_ptr->suspended.payload_state_ptr : state_ptr->payload_state_ptr;
+}
+
+void TxPacketizerPayloadSwap(TxPacketizerState* state_ptr)
+{
+    const TxPacketizerSuspendedPayload active = {
+        .payload_state_ptr = state_ptr->payload_state_ptr,
+        .packetizer_state_handle = state_ptr->packetizer_state_handle,
+        .batch_size = state_ptr->batch_size,
+        .parallel_next_packet_index = state_ptr->parallel_next_packet_index,
+        .parallel_end_packet_index = state_ptr->parallel_end_packet_index
+    };
+    state_ptr->payload_state_ptr = state_ptr->suspended.payload_state_ptr;
+    state_ptr->packetizer_state_handle = state_ptr->suspended.packetizer_state_handle;
+    state_ptr->batch_size = state_ptr->suspended.batch_size;
+    state_ptr->parallel_next_packet_index = state_ptr->suspended.parallel_next_packet_index;
+    state_ptr->parallel_end_packet_index = state_ptr->suspended.parallel_end_packet_index;
+    state_ptr->suspended = active;
+}
+
+bool TxPacketizerPayloadPreempt(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr,
+                                int min_priority)
+{
+    if (NULL == state_ptr->pending_payload_array || state_ptr->suspended.payload_state_ptr ||
+        (0 == state_ptr->pending_payload_count && CdiQueueIsEmpty(con_state_ptr->tx_state.payload_queue_handle))) {
+        return false;
+    }
+    if (NULL == state_ptr->suspended.packetizer_state_handle) {
+        // The interrupting payload needs its own packetizer state tracker. Created the first time it is needed.
+        state_ptr->suspended.packetizer_state_handle = PayloadPacketizerCreate();
+        if (NULL == state_ptr->suspended.packetizer_state_handle) {
+            return false;
+        }
+    }
+
+    TxPacketizerPayloadSwap(state_ptr);
+    if (!TxSchedulerPayloadSelect(con_state_ptr, state_ptr, min_priority)) {
+        TxPacketizerPayloadSwap(state_ptr); // Nothing more urgent is waiting, so carry on with the current payload.
+        return false;
+    }
+    TxPacketizerPayloadStart(con_state_ptr, state_ptr);
+
+    return true;
+}
+
+int TxBatchSizeGet(CdiTxBatchPolicy policy, int previous_batch_size, bool first_batch,
+                   EndpointTransmitQueueLevel queue_level, uint64_t elapsed_us, uint32_t max_latency_us)
+{
+    int batch_size = 1;
+
+    switch (policy) {
+        case kCdiTxBatchPolicyDoubling:
+            batch_size = first_batch ? 1 : previous_batch_size * 2;
+            break;
+        case kCdiTxBatchPolicyLatency:
+            batch_size = 1;
+            break;
+        case kCdiTxBatchPolicyThroughput:
+            batch_size = TX_BATCH_THROUGHPUT_PACKETS;
+            break;
+        case kCdiTxBatchPolicyAdaptive:
+            switch (queue_level) {
+                case kEndpointTransmitQueueEmpty:
+                    // The adapter is idle, so don't make it wait for a batch to be built.
+                    batch_size = 1;
+                    break;
+                case kEndpointTransmitQueueFull:
+                    // The adapter can't take more packets right now, so build a large batch while it is busy.
+                    batch_size = TX_BATCH_ADAPTIVE_MAX_PACKETS;
+                    break;
+                case kEndpointTransmitQueueIntermediate:
+                case kEndpointTransmitQueueNa:
+                    batch_size = first_batch ? 1 : CDI_MIN(previous_batch_size * 2, TX_BATCH_ADAPTIVE_MAX_PACKETS);
+                    break;
             }
-            CdiPoolPut(con_state_ptr->tx_state.payload_state_pool_handle, payload_state_ptr);
+            // Don't hold back the packets of a payload that is close to its deadline.
+            if (max_latency_us && elapsed_us >= max_latency_us / 2) {
+                batch_size = CDI_MIN(batch_size, TX_BATCH_ADAPTIVE_URGENT_MAX_PACKETS);
+            }
+            break;
+    }
+
+    return batch_size;
+}
+
+void TxBatchSizeHistogramAdd(uint64_t* histogram_array, int batch_size)
+{
+    int bucket = 0;
+    while (bucket < CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS - 1 && (batch_size >> (bucket + 1))) {
+        bucket++;
+    }
+    CdiOsAtomicInc64(&histogram_array[bucket]);
+}
+
+bool TxPayloadIsHopeless(CdiConnectionState* con_state_ptr, const TxPayloadState* payload_state_ptr)
+{
+    const uint64_t deadline = TxPayloadDeadlineGet(payload_state_ptr);
+    if (UINT64_MAX == deadline) {
+        return false;
+    }
+
+    uint64_t finish_time = CdiOsGetMicroseconds();
+    const uint32_t bytes_per_millisec = CdiOsAtomicLoad32(&con_state_ptr->tx_state.deadline_bytes_per_millisec);
+    if (bytes_per_millisec) {
+        const uint64_t byte_count = (uint64_t)CdiOsAtomicLoad32(&con_state_ptr->tx_state.deadline_in_flight_bytes) +
+                                    payload_state_ptr->source_sgl.total_data_size;
+        finish_time += byte_count * 1000 / bytes_per_millisec;
+    }
+
+    return finish_time > deadline;
+}
+
+void TxPayloadDropEarly(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr)
+{
+    CdiEndpointState* endpoint_ptr = payload_state_ptr->cdi_endpoint_handle;
+
+    CDI_LOG_THREAD(kLogWarning,
+                   "Connection[%s] Stream[%s] dropped payload that can't meet its [%"PRIu32"]us maximum latency.",
+                   con_state_ptr->saved_connection_name_str, endpoint_ptr->stream_name_str,
+                   payload_state_ptr->max_latency_microsecs);
+    CdiOsAtomicInc64(&endpoint_ptr->transfer_stats.payload_counter_stats.num_payloads_dropped_early);
+
+    // Post message to notify application, which also frees the payload's source SGL. See PayloadTransferComplete().
+    TxPayloadStreamClose(con_state_ptr, payload_state_ptr);
+    payload_state_ptr->app_payload_cb_data.payload_status_code = kCdiStatusMaxLatencyExceeded;
+    payload_state_ptr->app_payload_cb_data.tx_source_sgl = payload_state_ptr->source_sgl;
+    AppPayloadMessagePost(con_state_ptr, payload_state_ptr);
+
+    // No packets of the payload will be acknowledged, so release the reference taken for it when it was queued.
+    CdiOsAtomicDec32(&endpoint_ptr->adapter_endpoint_ptr->tx_in_flight_ref_count);
+    CdiPoolPut(con_state_ptr->tx_state.payload_state_pool_handle, payload_state_ptr);
+}
+
+bool TxSchedulerPayloadIsBefore(const CdiConnectionState* con_state_ptr, const TxPayloadState* payload_state_ptr,
+                                const TxPayloadState* other_payload_state_ptr)
+{
+    const int priority = TxPayloadPriorityGet(payload_state_ptr);
+    const int other_priority = TxPayloadPriorityGet(other_payload_state_ptr);
+    if (priority != other_priority) {
+        return priority > other_priority;
+    }
+    return con_state_ptr->tx_state.config_data.deadline_scheduling &&
+           TxPayloadScheduleDeadlineGet(payload_state_ptr) < TxPayloadScheduleDeadlineGet(other_payload_state_ptr);
+}
+
+void TxPayloadRelease(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr)
+{
+    TxPayloadStreamClose(con_state_ptr, payload_state_ptr);
+
+    // Free pool buffers reserved in TxPayloadPrepare() and in PayloadInit().
+    CdiSglEntry* entry_ptr = payload_state_ptr->source_sgl.sgl_head_ptr;
+    while (entry_ptr) {
+        CdiSglEntry* next_ptr = entry_ptr->next_ptr; // Save next entry, since Put() will free its memory.
+        CdiPoolPut(con_state_ptr->tx_state.payload_sgl_entry_pool_handle, entry_ptr);
+        entry_ptr = next_ptr;
+    }
+    CdiPoolPut(con_state_ptr->tx_state.payload_state_pool_handle, payload_state_ptr);
+}
+
+int TxPayloadEnqueue(CdiConnectionState* con_state_ptr, TxPayloadState** payload_state_array, int count)
+{
+    // Put Tx payload messages into the payload queue. The TxPayloadThread() thread will then process them. Don't block
+    // here and wait if the queue is full, the caller returns an error for the payloads that did not fit.
+    bool run_to_completion = NULL != con_state_ptr->tx_state.poll_packetizer_state_ptr;
+    if (run_to_completion) {
+        // The poll thread processes the queue, so increment the reference counters before pushing the payloads. This
+        // keeps the poll thread from going to sleep once a payload is in the queue. See TxPollProcess().
+        for (int i = 0; i < count; i++) {
+            CdiEndpointState* endpoint_ptr = payload_state_array[i]->cdi_endpoint_handle;
+            CdiOsAtomicInc32(&endpoint_ptr->adapter_endpoint_ptr->tx_in_flight_ref_count);
+        }
+    }
+
+    int pushed_count = CdiQueuePushBatch(con_state_ptr->tx_state.payload_queue_handle, payload_state_array, count);
+
+    for (int i = pushed_count; i < count; i++) {
+        // Queue was full, put the allocated memory back in the pools.
+        if (run_to_completion) {
+            CdiEndpointState* endpoint_ptr = payload_state_array[i]->cdi_endpoint_handle;
+            CdiOsAtomicDec32(&endpoint_ptr->adapter_endpoint_ptr->tx_in_flight_ref_count);
+        }
+        TxPayloadRelease(con_state_ptr, payload_state_array[i]);
+    }
+
+    if (run_to_completion && pushed_count) {
+        CdiOsSignalSet(con_state_ptr->adapter_connection_ptr->tx_poll_do_work_signal);
+    }
+
+    return pushed_count;
+}
+
+CdiReturnStatus TxPayloadInternal(CdiEndpointState* endpoint_ptr, const CdiCoreTxPayloadConfig* core_payload_config_ptr,
+                                  const CdiSgList* sgl_ptr, int max_latency_microsecs, int extra_data_size,
+                                  uint8_t* extra_data_ptr)
+{
+    TxPayloadState* payload_state_ptr = NULL;
+    CdiReturnStatus rs = TxPayloadPrepare(endpoint_ptr, core_payload_config_ptr, sgl_ptr, max_latency_microsecs,
+                                          extra_data_size, extra_data_ptr, &payload_state_ptr);
+    if (kCdiStatusOk == rs) {
+        if (0 == TxPayloadEnqueue(endpoint_ptr->connection_state_ptr, &payload_state_ptr, 1)) {
+            rs = kCdiStatusQueueFull;
+        }
+    }
+    return rs;
+}
+
+CdiReturnStatus TxPayloadOpenInternal(CdiEndpointState* endpoint_ptr,
+                                      const CdiCoreTxPayloadConfig* core_payload_config_ptr, int total_data_size,
+                                      int max_latency_microsecs, int extra_data_size, uint8_t* extra_data_ptr,
+                                      CdiTxPayloadHandle* ret_payload_handle_ptr)
+{
+    TxPayloadState* payload_state_ptr = NULL;
+    CdiReturnStatus rs = TxPayloadPrepare(endpoint_ptr, core_payload_config_ptr, NULL, max_latency_microsecs,
+                                          extra_data_size, extra_data_ptr, &payload_state_ptr);
+    CdiTxPayloadHandle payload_handle = { 0 };
+    if (kCdiStatusOk == rs) {
+        // The handle must be valid before the payload is queued, since the payload may be dropped right away.
+        payload_handle = TxPayloadStreamOpen(endpoint_ptr->connection_state_ptr, payload_state_ptr, total_data_size);
+        if (0 == TxPayloadEnqueue(endpoint_ptr->connection_state_ptr, &payload_state_ptr, 1)) {
+            payload_handle = (CdiTxPayloadHandle){ 0 };
+            rs = kCdiStatusQueueFull;
         }
     }
+    *ret_payload_handle_ptr = payload_handle;
     return rs;
 }
 
+CdiReturnStatus TxPayloadAppendInternal(CdiTxPayloadHandle payload_handle, const CdiSgList* sgl_ptr)
+{
+    // The payload state may have been released and reused already, so nothing is read from it until the handle has
+    // been checked.
+    TxPayloadState* payload_state_ptr = payload_handle.payload_state_ptr;
+    CdiConnectionState* con_state_ptr = payload_handle.endpoint_handle->connection_state_ptr;
+
+    // Copy the SGL entries first, so none are appended if the pool runs dry.
+    CdiReturnStatus rs = kCdiStatusOk;
+    CdiSgList sgl_copy = { 0 };
+    for (const CdiSglEntry* entry_ptr = sgl_ptr->sgl_head_ptr; kCdiStatusOk == rs && entry_ptr;
+         entry_ptr = entry_ptr->next_ptr) {
+        CdiSglEntry* new_entry_ptr = NULL;
+        if (0 == entry_ptr->size_in_bytes) {
+            // Skip empty entries. The packetizer expects every entry of a streaming payload to hold some data.
+        } else if (!CdiPoolGet(con_state_ptr->tx_state.payload_sgl_entry_pool_handle, (void**)&new_entry_ptr)) {
+            rs = kCdiStatusAllocationFailed;
+        } else {
+            *new_entry_ptr = *entry_ptr;
+            new_entry_ptr->next_ptr = NULL;
+            SglAppend(&sgl_copy, new_entry_ptr);
+        }
+    }
+    if (kCdiStatusOk == rs && sgl_copy.total_data_size != sgl_ptr->total_data_size) {
+        CDI_LOG_HANDLE(con_state_ptr->log_handle, kLogError,
+                       "Mismatch between sgl total_data_size [%d] and sum of entries size_in_bytes [%d].",
+                       sgl_ptr->total_data_size, sgl_copy.total_data_size);
+        rs = kCdiStatusInvalidParameter;
+    }
+
+    // Hold the lock while appending, so the payload can't be released meanwhile.
+    CdiOsCritSectionReserve(con_state_ptr->tx_state.stream_lock);
+    if (kCdiStatusOk == rs && (0 == payload_handle.generation ||
+                               payload_handle.generation != payload_state_ptr->stream_generation ||
+                               payload_handle.generation <= con_state_ptr->tx_state.stream_flushed_generation)) {
+        // The payload was completely appended, dropped or flushed.
+        rs = kCdiStatusInvalidHandle;
+    }
+    if (kCdiStatusOk == rs) {
+        // Only this thread appends data, so the number of bytes appended can't change while the data is checked.
+        const uint32_t appended_bytes = CdiOsAtomicLoad32(&payload_state_ptr->stream_appended_bytes);
+        const int64_t total_bytes = appended_bytes + (int64_t)sgl_copy.total_data_size;
+        if (total_bytes > payload_state_ptr->source_sgl.total_data_size) {
+            rs = kCdiStatusInvalidParameter;
+        } else if (sgl_copy.sgl_head_ptr) {
+            // Link the entries to the payload's SGL before publishing the new number of bytes appended. The packetizer
+            // only follows links up to that number of bytes, so it never sees a partially linked entry.
+            // source_sgl.total_data_size already holds the size of the whole payload, so it is not updated here.
+            CdiSgList* source_sgl_ptr = &payload_state_ptr->source_sgl;
+            if (NULL == source_sgl_ptr->sgl_head_ptr) {
+                source_sgl_ptr->sgl_head_ptr = sgl_copy.sgl_head_ptr;
+            } else {
+                source_sgl_ptr->sgl_tail_ptr->next_ptr = sgl_copy.sgl_head_ptr;
+            }
+            source_sgl_ptr->sgl_tail_ptr = sgl_copy.sgl_tail_ptr;
+            CdiOsAtomicAdd32(&payload_state_ptr->stream_appended_bytes, sgl_copy.total_data_size);
+            if (total_bytes == payload_state_ptr->source_sgl.total_data_size) {
+                payload_state_ptr->stream_generation = 0; // The whole payload has been appended.
+            }
+        }
+    }
+    CdiOsCritSectionRelease(con_state_ptr->tx_state.stream_lock);
+
+    if (kCdiStatusOk != rs) {
+        FreeSglEntries(con_state_ptr->tx_state.payload_sgl_entry_pool_handle, sgl_copy.sgl_head_ptr);
+        return rs;
+    }
+    if (NULL == sgl_copy.sgl_head_ptr) {
+        return kCdiStatusOk;
+    }
+
+    // Wake up whichever thread is packetizing the connection's payloads.
+    if (con_state_ptr->tx_state.poll_packetizer_state_ptr) {
+        CdiOsSignalSet(con_state_ptr->adapter_connection_ptr->tx_poll_do_work_signal);
+    } else {
+        CdiOsSignalSet(con_state_ptr->tx_state.payload_data_signal);
+    }
+
+    return kCdiStatusOk;
+}
+
+CdiTxPayloadHandle TxPayloadStreamOpen(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr,
+                                       int total_data_size)
+{
+    // The size of the whole payload is sent in the header of its first packet, before all of its data is known.
+    payload_state_ptr->streaming = true;
+    payload_state_ptr->source_sgl.total_data_size = total_data_size;
+
+    CdiOsCritSectionReserve(con_state_ptr->tx_state.stream_lock);
+    const uint64_t generation = ++con_state_ptr->tx_state.stream_generation;
+    payload_state_ptr->stream_generation = generation;
+    CdiOsCritSectionRelease(con_state_ptr->tx_state.stream_lock);
+
+    return (CdiTxPayloadHandle){
+        .endpoint_handle = payload_state_ptr->cdi_endpoint_handle,
+        .payload_state_ptr = payload_state_ptr,
+        .generation = generation
+    };
+}
+
+void TxPayloadStreamClose(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr)
+{
+    if (payload_state_ptr->streaming) {
+        CdiOsCritSectionReserve(con_state_ptr->tx_state.stream_lock);
+        payload_state_ptr->stream_generation = 0;
+        CdiOsCritSectionRelease(con_state_ptr->tx_state.stream_lock);
+    }
+}
+
+void TxPayloadStreamFlush(CdiConnectionState* con_state_ptr)
+{
+    // The flushed payloads can't be found, since they are not tracked once they have been queued. So invalidate all of
+    // the handles given out so far.
+    CdiOsCritSectionReserve(con_state_ptr->tx_state.stream_lock);
+    con_state_ptr->tx_state.stream_flushed_generation = con_state_ptr->tx_state.stream_generation;
+    CdiOsCritSectionRelease(con_state_ptr->tx_state.stream_lock);
+}
+
 void TxPayloadThreadFlushResources(CdiEndpointState* endpoint_ptr)
 {
     CdiConnectionState* con_state_ptr = (CdiConnectionState*)endpoint_ptr->connection_state_ptr;
@@ -784,6 +2043,9 @@ void TxPayloadThreadFlushResources(CdiEndpointState* endpoint_ptr)
             // Put back SGL entry for each one in the list.
             FreeSglEntries(con_state_ptr->tx_state.packet_sgl_entry_pool_handle, packet_entry_hdr_ptr);
         }
+        if (work_request_ptr->bounce_buffer_ptr) {
+            CdiPoolPut(con_state_ptr->tx_state.bounce_buffer_pool_handle, work_request_ptr->bounce_buffer_ptr);
+        }
 
         // Put back work request into the pool.
         CdiPoolPut(con_state_ptr->tx_state.work_request_pool_handle, work_request_ptr);
@@ -796,6 +2058,8 @@ void TxPayloadThreadFlushResources(CdiEndpointState* endpoint_ptr)
         payload_state_ptr = NULL; // Pointer is no longer valid, so clear it.
     }
 
+    // Data must no longer be appended to the streaming payloads whose states are returned to the pool below.
+    TxPayloadStreamFlush(con_state_ptr);
     CdiPoolPutAll(con_state_ptr->tx_state.payload_state_pool_handle);
     // Don't free tx_state.payload_sgl_entry_pool_handle here. AppCallbackPayloadThread() frees them. When a connection
     // is destroyed, the pool is flushed in TxConnectionDestroyInternal().
@@ -803,15 +2067,78 @@ void TxPayloadThreadFlushResources(CdiEndpointState* endpoint_ptr)
     CdiPoolPutAll(con_state_ptr->tx_state.work_request_pool_handle);
     CdiQueueFlush(con_state_ptr->tx_state.work_req_comp_queue_handle);
     CdiPoolPutAll(con_state_ptr->tx_state.packet_sgl_entry_pool_handle);
+    if (con_state_ptr->tx_state.bounce_buffer_pool_handle) {
+        // Also returns the bounce buffer of a packet that was being built.
+        CdiPoolPutAll(con_state_ptr->tx_state.bounce_buffer_pool_handle);
+    }
 
     // NOTE: Don't flush app_payload_message_queue_handle here. Entries are popped using AppCallbackPayloadThread().
     // When a connection is destroyed, they are flushed in TxConnectionDestroyInternal().
 
+    if (con_state_ptr->tx_state.poll_packetizer_state_ptr) {
+        // The poll thread is not using its packetizer state while the Endpoint Manager is flushing resources, and the
+        // payload it was processing (if any) has been flushed above.
+        TxPacketizerStateReset(con_state_ptr->tx_state.poll_packetizer_state_ptr);
+    }
+
+    // Payloads that were started but not completed have been flushed.
+    CdiOsAtomicStore32(&con_state_ptr->tx_state.deadline_in_flight_bytes, 0);
+
     con_state_ptr->back_pressure_state = kCdiBackPressureNone; // Reset the back pressure state.
     endpoint_ptr->tx_state.payload_num = 0; // Clear payload number so receiver can expect payload zero first.
     endpoint_ptr->tx_state.packet_id = 0; // Reset packet ID to zero.
 }
 
+bool TxPollProcess(CdiConnectionHandle con_handle)
+{
+    CdiConnectionState* con_state_ptr = (CdiConnectionState*)con_handle;
+
+    // Nothing to do unless running to completion. Also don't touch any resources while the Endpoint Manager is
+    // processing a state change, since it may be flushing them.
+    if (NULL == con_state_ptr->tx_state.poll_packetizer_state_ptr ||
+        EndpointManagerIsPollThreadWaiting(con_state_ptr->endpoint_manager_handle)) {
+        return false;
+    }
+
+    return TxPollPacketize(con_state_ptr);
+}
+
+bool TxPollPacketize(CdiConnectionState* con_state_ptr)
+{
+    TxPacketizerState* state_ptr = con_state_ptr->tx_state.poll_packetizer_state_ptr;
+    bool productive = false;
+
+    // Free resources of packets that have completed, making them available to build the next packets.
+    if (!CdiQueueIsEmpty(con_state_ptr->tx_state.work_req_comp_queue_handle)) {
+        ProcessWorkRequestCompletionQueue(con_state_ptr);
+        productive = true;
+    }
+
+    if (kPayloadStateIdle == state_ptr->processing_state && state_ptr->pending_payload_array) {
+        if (TxSchedulerPayloadSelect(con_state_ptr, state_ptr, INT_MIN)) {
+            TxPacketizerPayloadStart(con_state_ptr, state_ptr);
+            productive = true;
+        }
+    } else if (kPayloadStateIdle == state_ptr->processing_state &&
+        CdiQueuePop(con_state_ptr->tx_state.payload_queue_handle, (void**)&state_ptr->payload_state_ptr)) {
+        // NOTE: The reference counter for the payload was incremented by TxPayloadInternal().
+        TxPacketizerPayloadStart(con_state_ptr, state_ptr);
+        productive = true;
+    }
+
+    if (kPayloadStateIdle != state_ptr->processing_state) {
+        // Only build packets when the adapter can accept them, so packets are created just before they are sent.
+        AdapterEndpointHandle adapter_endpoint_handle =
+            EndpointManagerEndpointToAdapterEndpoint(state_ptr->payload_state_ptr->cdi_endpoint_handle);
+        if (kEndpointTransmitQueueFull != CdiAdapterGetTransmitQueueLevel(adapter_endpoint_handle) &&
+            TxPacketizerRun(con_state_ptr, state_ptr, TX_RUN_TO_COMPLETION_PACKETS_PER_POLL)) {
+            productive = true;
+        }
+    }
+
+    return productive;
+}
+
 CdiReturnStatus TxConnectionThreadJoin(CdiConnectionHandle con_handle)
 {
     CdiConnectionState* con_state_ptr = (CdiConnectionState*)con_handle;
@@ -855,12 +2182,24 @@ void TxConnectionDestroyInternal(CdiConnectionHandle con_handle)
         CdiPoolDestroy(con_state_ptr->tx_state.packet_sgl_entry_pool_handle);
         con_state_ptr->tx_state.packet_sgl_entry_pool_handle = NULL;
 
+        BounceBufferPoolDestroy(con_state_ptr);
+
         CdiPoolDestroy(con_state_ptr->tx_state.work_request_pool_handle);
         con_state_ptr->tx_state.work_request_pool_handle = NULL;
 
         CdiQueueDestroy(con_state_ptr->tx_state.payload_queue_handle);
         con_state_ptr->tx_state.payload_queue_handle = NULL;
 
+        if (con_state_ptr->tx_state.payload_data_signal) {
+            CdiOsSignalDelete(con_state_ptr->tx_state.payload_data_signal);
+            con_state_ptr->tx_state.payload_data_signal = NULL;
+        }
+        CdiOsCritSectionDelete(con_state_ptr->tx_state.stream_lock);
+        con_state_ptr->tx_state.stream_lock = NULL;
+
+        TxPacketizerStateDestroy(con_state_ptr->tx_state.poll_packetizer_state_ptr);
+        con_state_ptr->tx_state.poll_packetizer_state_ptr = NULL;
+
         // NOTE: con_state_ptr is freed by the caller.
     }
 }
@@ -871,6 +2210,8 @@ void TxEndpointDestroy(CdiEndpointHandle handle)
 
     CdiOsCritSectionDelete(endpoint_ptr->tx_state.payload_num_lock);
     endpoint_ptr->tx_state.payload_num_lock = NULL;
+    PayloadPacketizationPlanDestroy(endpoint_ptr->tx_state.packetization_plan_handle);
+    endpoint_ptr->tx_state.packetization_plan_handle = NULL;
 }
 
 void TxPacketWorkRequestComplete(void* param_ptr, Packet* packet_ptr, EndpointMessageType message_type)
@@ -878,53 +2219,24 @@ void TxPacketWorkRequestComplete(void* param_ptr, Packet* packet_ptr, EndpointMe
     assert(kEndpointMessageTypePacketSent == message_type);
     (void)message_type;
     CdiEndpointState* endpoint_ptr = (CdiEndpointState*)param_ptr;
-    CdiConnectionState* con_state_ptr = endpoint_ptr->connection_state_ptr;
 
     CdiAdapterTxPacketComplete(endpoint_ptr->adapter_endpoint_ptr, packet_ptr);
+    WorkRequestComplete(endpoint_ptr, packet_ptr);
+}
 
-    if (kAdapterPacketStatusNotConnected == packet_ptr->tx_state.ack_status) {
-        return;
-    }
-
-    // The internal_data_ptr contains a work request pointer that was set in TxPayloadThread().
-    TxPacketWorkRequest* work_request_ptr = (TxPacketWorkRequest*)packet_ptr->sg_list.internal_data_ptr;
-
-    // Now that we have our work request, we can setup additional state data pointers.
-    TxPayloadState* payload_state_ptr = work_request_ptr->payload_state_ptr;
-
-    // Check if the packet is from the payload that we are currently processing.
-    if (payload_state_ptr->payload_packet_state.payload_num != work_request_ptr->payload_num) {
-        CDI_LOG_THREAD(kLogWarning, "Connection[%s] packet for payload[%d] not from current payload[%d]",
-                       endpoint_ptr->connection_state_ptr->saved_connection_name_str,
-                       payload_state_ptr->payload_packet_state.payload_num, work_request_ptr->payload_num);
-    } else {
-        payload_state_ptr->data_bytes_transferred += work_request_ptr->packet_payload_size;
-
-        if (kPayloadTypeKeepAlive == payload_state_ptr->payload_packet_state.payload_type) {
-            // Payload type is keep alive. Keep it internal and do not use the application callback. Nothing special to
-            // do here, unless payload data was allocated dynamically using a pool. If so, will need to free it here.
-        } else {
-            CdiSinglyLinkedListPushTail(&payload_state_ptr->completed_packets_list,
-                                        (void*)&work_request_ptr->packet.list_entry);
-
-            if (payload_state_ptr->data_bytes_transferred >= payload_state_ptr->source_sgl.total_data_size) {
-                // Payload transfer complete. Pointer is freed below in PayloadTransferComplete(). Clear it now so it
-                // cannot be accidentally used later.
-                work_request_ptr->payload_state_ptr = NULL;
+void TxPacketWorkRequestsComplete(void* param_ptr, CdiSinglyLinkedList* packet_list_ptr,
+                                  EndpointMessageType message_type)
+{
+    assert(kEndpointMessageTypePacketSent == message_type);
+    (void)message_type;
+    CdiEndpointState* endpoint_ptr = (CdiEndpointState*)param_ptr;
 
-                // Put list of work requests in queue so TxPayloadThread() can free the allocated resources.
-                if (!CdiQueuePush(con_state_ptr->tx_state.work_req_comp_queue_handle,
-                                  &payload_state_ptr->completed_packets_list)) {
-                    CDI_LOG_THREAD(kLogError, "Queue[%s] full, push failed.",
-                                   CdiQueueGetName(con_state_ptr->tx_state.work_req_comp_queue_handle));
-                }
-                work_request_ptr = NULL; // Pointer may no longer be valid, so clear it now.
+    CdiAdapterTxPacketsComplete(endpoint_ptr->adapter_endpoint_ptr, packet_list_ptr);
 
-                // Updates stats and puts message in queue to call the user registered Tx callback function.
-                PayloadTransferComplete(endpoint_ptr, payload_state_ptr);
-                payload_state_ptr = NULL; // Pointer is no longer valid.
-            }
-        }
+    // Pop each packet before completing it, since WorkRequestComplete() reuses its list entry.
+    CdiSinglyLinkedListEntry* entry_ptr = NULL;
+    while (NULL != (entry_ptr = CdiSinglyLinkedListPopHead(packet_list_ptr))) {
+        WorkRequestComplete(endpoint_ptr, CONTAINER_OF(entry_ptr, Packet, list_entry));
     }
 }
 
@@ -937,6 +2249,7 @@ void TxInvokeAppPayloadCallback(CdiConnectionState* con_state_ptr, AppPayloadCal
         .core_extra_data = app_cb_data_ptr->core_extra_data,
         .user_cb_param = app_cb_data_ptr->tx_payload_user_cb_param,
     };
+    CdiCompletionQueueHandle completion_queue_handle = con_state_ptr->tx_state.config_data.completion_queue_handle;
 
     if (kProtocolTypeRaw == con_state_ptr->protocol_type) {
         // Raw protocol so calling CdiRawTxCallback().
@@ -944,8 +2257,16 @@ void TxInvokeAppPayloadCallback(CdiConnectionState* con_state_ptr, AppPayloadCal
             .core_cb_data = core_cb_data
         };
 
-        CdiRawTxCallback raw_tx_cb_ptr = (CdiRawTxCallback)con_state_ptr->tx_state.cb_ptr;
-        (raw_tx_cb_ptr)(&cb_data); // Call the user-registered callback function.
+        if (completion_queue_handle) {
+            // Wait for the application to make room in the queue rather than lose the completion.
+            if (!CompletionQueuePushWait(completion_queue_handle, kCdiCompletionEventRawTx, &cb_data,
+                                         con_state_ptr->shutdown_signal)) {
+                CDI_LOG_THREAD(kLogError, "Connection shutting down. Dropping Tx completion.");
+            }
+        } else {
+            CdiRawTxCallback raw_tx_cb_ptr = (CdiRawTxCallback)con_state_ptr->tx_state.cb_ptr;
+            (raw_tx_cb_ptr)(&cb_data); // Call the user-registered callback function.
+        }
     } else {
         // AVM protocol so calling CdiAvmTxCallback().
         CDIPacketAvmCommonHeader* avm_common_header_ptr =
@@ -956,7 +2277,14 @@ void TxInvokeAppPayloadCallback(CdiConnectionState* con_state_ptr, AppPayloadCal
             .avm_extra_data = avm_common_header_ptr->avm_extra_data
         };
 
-        CdiAvmTxCallback avm_tx_cb_ptr = (CdiAvmTxCallback)con_state_ptr->tx_state.cb_ptr;
-        (avm_tx_cb_ptr)(&cb_data); // Call the user-registered callback function.
+        if (completion_queue_handle) {
+            if (!CompletionQueuePushWait(completion_queue_handle, kCdiCompletionEventAvmTx, &cb_data,
+                                         con_state_ptr->shutdown_signal)) {
+                CDI_LOG_THREAD(kLogError, "Connection shutting down. Dropping Tx completion.");
+            }
+        } else {
+            CdiAvmTxCallback avm_tx_cb_ptr = (CdiAvmTxCallback)con_state_ptr->tx_state.cb_ptr;
+            (avm_tx_cb_ptr)(&cb_data); // Call the user-registered callback function.
+        }
     }
 }
@@ -32,6 +32,7 @@ typedef struct {
     uint16_t payload_num;              ///< Packet payload number.
     uint16_t packet_payload_size;      ///< Size of payload, not including the packet header.
     Packet packet;                     ///< The top level packet structure for the data in this work request.
+    void* bounce_buffer_ptr;           ///< Bounce buffer used by the packet, if any. See bounce_buffer_pool_handle.
     /// @brief The data for the packet header, entry zero in packet_sgl. Includes space for message prefix.
     char header[MAX_MSG_PREFIX_SIZE + sizeof(CdiRawPacketHeader)];
 } TxPacketWorkRequest;
@@ -57,6 +58,196 @@ CdiReturnStatus TxPayloadInternal(CdiEndpointState* endpoint_ptr, const CdiCoreT
                                   const CdiSgList* sgl_ptr, int max_latency_microsecs, int extra_data_size,
                                   uint8_t* extra_data_ptr);
 
+/**
+ * Validate a Tx payload and prepare its state data so it can be put in the connection's payload queue using
+ * TxPayloadEnqueue(). The parameters are the same as for TxPayloadInternal().
+ *
+ * @param endpoint_ptr Pointer to endpoint used to send the payload.
+ * @param core_payload_config_ptr Pointer to payload configuration data.
+ * @param sgl_ptr Scatter-gather list containing the payload to be transmitted. NULL if the payload's data is appended
+ *                later using TxPayloadAppendInternal().
+ * @param max_latency_microsecs Maximum latency in microseconds.
+ * @param extra_data_size Size in bytes of extra data to send with the payload.
+ * @param extra_data_ptr Pointer to extra data to send with the payload.
+ * @param ret_payload_state_ptr Address where to write the pointer to the payload state data. NULL is written if an
+ *                              error occurred.
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CdiReturnStatus TxPayloadPrepare(CdiEndpointState* endpoint_ptr, const CdiCoreTxPayloadConfig* core_payload_config_ptr,
+                                 const CdiSgList* sgl_ptr, int max_latency_microsecs, int extra_data_size,
+                                 uint8_t* extra_data_ptr, TxPayloadState** ret_payload_state_ptr);
+
+/**
+ * Return the resources of a payload prepared by TxPayloadPrepare() that will not be sent to their pools.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param payload_state_ptr Pointer to payload state data.
+ */
+void TxPayloadRelease(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr);
+
+/**
+ * Put payloads prepared by TxPayloadPrepare() in the connection's payload queue using a single queue operation and a
+ * single wake-up of the thread that processes them. Payloads that do not fit in the queue are released using
+ * TxPayloadRelease().
+ *
+ * @param con_state_ptr Pointer to connection state data. All of the payloads must use endpoints of this connection.
+ * @param payload_state_array Array of pointers to payload state data.
+ * @param count Number of entries in payload_state_array.
+ *
+ * @return The number of payloads put in the queue, starting from the first entry of payload_state_array.
+ */
+int TxPayloadEnqueue(CdiConnectionState* con_state_ptr, TxPayloadState** payload_state_array, int count);
+
+/**
+ * Create the state data used to packetize the payloads of a connection, including its packetizer helpers and payload
+ * scheduler if the connection is configured to use them.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ *
+ * @return Pointer to the new packetizer state data, or NULL if there is not enough memory.
+ */
+TxPacketizerState* TxPacketizerStateCreate(CdiConnectionState* con_state_ptr);
+
+/**
+ * Free packetizer state data created by TxPacketizerStateCreate().
+ *
+ * @param state_ptr Pointer to packetizer state data. May be NULL.
+ */
+void TxPacketizerStateDestroy(TxPacketizerState* state_ptr);
+
+/**
+ * Get the payload that a packetizer is packetizing or the one it suspended.
+ *
+ * @param state_ptr Pointer to packetizer state data.
+ * @param suspended If true, get the suspended payload, otherwise the payload in process.
+ *
+ * @return Pointer to the payload state data, or NULL if none.
+ */
+TxPayloadState* TxPacketizerPayloadGet(const TxPacketizerState* state_ptr, bool suspended);
+
+/**
+ * Exchange the payload in process with the suspended one. Must only be called between batches of packets, when the
+ * packetizer holds no packets or work requests of the payload in process.
+ *
+ * @param state_ptr Pointer to packetizer state data.
+ */
+void TxPacketizerPayloadSwap(TxPacketizerState* state_ptr);
+
+/**
+ * Interrupt the payload in process if a payload of a stream with a priority above min_priority is waiting. The
+ * interrupted payload is suspended and resumed once no payloads of streams with a higher priority than its own are
+ * waiting. Must only be called between batches of packets. Only one payload can be suspended at a time, and payloads
+ * sent through the same adapter endpoint as the interrupted payload are not started.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param state_ptr Pointer to packetizer state data.
+ * @param min_priority Only payloads of streams with a higher priority than this interrupt the payload in process.
+ *
+ * @return true if another payload was started, otherwise false.
+ */
+bool TxPacketizerPayloadPreempt(CdiConnectionState* con_state_ptr, TxPacketizerState* state_ptr, int min_priority);
+
+/**
+ * Get the number of packets to put in the next batch of packets of a payload that is handed to the adapter, according
+ * to a batch policy (see CdiTxConfigData.batch_policy).
+ *
+ * @param policy Batch policy of the connection.
+ * @param previous_batch_size Number of packets of the previous batch of the payload. Ignored for the first batch.
+ * @param first_batch True if the batch is the first one of the payload.
+ * @param queue_level Level of the adapter's transmit queue. Only used by kCdiTxBatchPolicyAdaptive.
+ * @param elapsed_us Microseconds since the payload was queued. Only used by kCdiTxBatchPolicyAdaptive.
+ * @param max_latency_us Maximum latency of the payload in microseconds, zero if none. Only used by
+ *                       kCdiTxBatchPolicyAdaptive.
+ *
+ * @return The number of packets of the next batch.
+ */
+int TxBatchSizeGet(CdiTxBatchPolicy policy, int previous_batch_size, bool first_batch,
+                   EndpointTransmitQueueLevel queue_level, uint64_t elapsed_us, uint32_t max_latency_us);
+
+/**
+ * Add a batch of packets to a batch size histogram (see CdiPayloadCounterStats.tx_batch_size_histogram).
+ *
+ * @param histogram_array Array of CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS counters.
+ * @param batch_size Number of packets in the batch.
+ */
+void TxBatchSizeHistogramAdd(uint64_t* histogram_array, int batch_size);
+
+/**
+ * Check whether a payload can still be transmitted before its deadline if it is started now. The estimate assumes the
+ * payload has to wait for the data of all payloads already in flight and that data is sent at the rate the connection
+ * has been achieving.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param payload_state_ptr Pointer to payload state data.
+ *
+ * @return true if the payload can't meet its deadline, false if it can or there is not enough data to tell.
+ */
+bool TxPayloadIsHopeless(CdiConnectionState* con_state_ptr, const TxPayloadState* payload_state_ptr);
+
+/**
+ * Drop a payload that can't meet its deadline before any of its packets are sent. The application's Tx callback is
+ * invoked for it with kCdiStatusMaxLatencyExceeded and it is counted in
+ * CdiPayloadCounterStats.num_payloads_dropped_early.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param payload_state_ptr Pointer to payload state data. The pointer is no longer valid after function returns.
+ */
+void TxPayloadDropEarly(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr);
+
+/**
+ * Check whether a waiting payload should be started before another one. Payloads of streams with a higher priority go
+ * first, then, if the connection schedules payloads by deadline, the ones with the earliest deadline. Payloads without
+ * a maximum latency are ordered as if they had TX_SCHEDULER_NO_LATENCY_MAX_WAIT_MICROSECS.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param payload_state_ptr Pointer to payload state data.
+ * @param other_payload_state_ptr Pointer to payload state data of the payload to compare with.
+ *
+ * @return true if payload_state_ptr should be started first.
+ */
+bool TxSchedulerPayloadIsBefore(const CdiConnectionState* con_state_ptr, const TxPayloadState* payload_state_ptr,
+                                const TxPayloadState* other_payload_state_ptr);
+
+/// @see CdiAvmEndpointTxPayloadOpen
+CdiReturnStatus TxPayloadOpenInternal(CdiEndpointState* endpoint_ptr,
+                                      const CdiCoreTxPayloadConfig* core_payload_config_ptr, int total_data_size,
+                                      int max_latency_microsecs, int extra_data_size, uint8_t* extra_data_ptr,
+                                      CdiTxPayloadHandle* ret_payload_handle_ptr);
+
+/// @see CdiAvmTxPayloadAppend
+CdiReturnStatus TxPayloadAppendInternal(CdiTxPayloadHandle payload_handle, const CdiSgList* sgl_ptr);
+
+/**
+ * Make a payload prepared by TxPayloadPrepare() a streaming one, whose data is appended using TxPayloadAppendInternal()
+ * while it is being sent. Must be called before the payload is put in the payload queue.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param payload_state_ptr Pointer to payload state data.
+ * @param total_data_size Size in bytes of the whole payload.
+ *
+ * @return Handle used to append data to the payload.
+ */
+CdiTxPayloadHandle TxPayloadStreamOpen(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr,
+                                       int total_data_size);
+
+/**
+ * Stop accepting data for a streaming payload, because it is being released. Appending data through its handle fails
+ * from then on. Does nothing if the payload is not a streaming one.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ * @param payload_state_ptr Pointer to payload state data.
+ */
+void TxPayloadStreamClose(CdiConnectionState* con_state_ptr, TxPayloadState* payload_state_ptr);
+
+/**
+ * Stop accepting data for all of the streaming payloads of a connection that have been opened so far, because their
+ * payload states are being flushed.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ */
+void TxPayloadStreamFlush(CdiConnectionState* con_state_ptr);
+
 /**
  * Join Tx connection threads as part of shutting down a connection. This function waits for them to stop.
  *
@@ -85,7 +276,20 @@ void TxEndpointDestroy(CdiEndpointHandle handle);
 void TxPacketWorkRequestComplete(void* param_ptr, Packet* packet_ptr, EndpointMessageType message_type);
 
 /**
- * Invoke the user registered Tx callback function for a payload.
+ * A list of packets has been acknowledged as being received by the receiver. Same as calling
+ * TxPacketWorkRequestComplete() for each packet in the list, but the in-flight count of the adapter endpoint is only
+ * updated once.
+ *
+ * @param param_ptr Pointer to connection that the packets were transmitted on as a void*.
+ * @param packet_list_ptr Pointer to list of packets. The list is empty when the function returns.
+ * @param message_type Endpoint message type.
+ */
+void TxPacketWorkRequestsComplete(void* param_ptr, CdiSinglyLinkedList* packet_list_ptr,
+                                  EndpointMessageType message_type);
+
+/**
+ * Invoke the user registered Tx callback function for a payload. If the connection uses a completion queue, the
+ * payload's event is pushed to it instead, waiting for room in the queue until the connection is shut down.
  *
  * @param con_state_ptr Pointer to connection state data.
  * @param app_cb_data_ptr Pointer to application callback data.
@@ -100,4 +304,26 @@ void TxInvokeAppPayloadCallback(CdiConnectionState* con_state_ptr, AppPayloadCal
  */
 void TxPayloadThreadFlushResources(CdiEndpointState* endpoint_ptr);
 
+/**
+ * Packetize payloads and free completed packet resources for a Tx connection that is configured to run to completion.
+ * Called by the adapter's poll thread each time it polls the connection, so packets are built just-in-time as the
+ * adapter is able to accept them. Does nothing if the connection is not configured to run to completion.
+ *
+ * @param con_handle Handle of the connection.
+ *
+ * @return true if useful work was done, false if the function did nothing productive.
+ */
+bool TxPollProcess(CdiConnectionHandle con_handle);
+
+/**
+ * Do the work of TxPollProcess() for a connection that is configured to run to completion, without checking whether the
+ * Endpoint Manager is processing a state change. The caller must ensure that the connection's resources are not being
+ * flushed.
+ *
+ * @param con_state_ptr Pointer to connection state data.
+ *
+ * @return true if useful work was done, false if the function did nothing productive.
+ */
+bool TxPollPacketize(CdiConnectionState* con_state_ptr);
+
 #endif  // CDI_INTERNAL_TX_H__
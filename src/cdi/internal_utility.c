@@ -55,6 +55,7 @@ static const CdiEnumStringKey probe_command_key_array[] = {
     { kProbeCommandConnected, "Connected" },
     { kProbeCommandAck,       "Ack" },
     { kProbeCommandProtocolVersion, "Protocol Version" },
+    { kProbeCommandRmaSlots,  "RMA Slots" },
     { CDI_INVALID_ENUM_VALUE, NULL } // End of the array
 };
 
@@ -23,11 +23,48 @@
 #include "internal.h"
 #include "internal_utility.h"
 #include "private.h"
+#include "tx_frame_allocator.h"
 
 //*********************************************************************************************************************
 //***************************************** START OF DEFINITIONS AND TYPES ********************************************
 //*********************************************************************************************************************
 
+/**
+ * @brief A packet of a packetization plan.
+ */
+typedef struct {
+    int header_size;         ///< Size of the packet's header, including the adapter's message prefix.
+    int first_piece_index;   ///< Index in piece_size_array of the packet's first payload SGL entry.
+    int piece_count;         ///< Number of payload SGL entries of the packet.
+    int first_entry_index;   ///< Index of the source SGL entry that holds the packet's first payload byte.
+    int payload_data_offset; ///< Offset in the payload of the packet's first payload byte.
+} PacketizationPlanPacket;
+
+/// @brief Forward reference of structure to create pointers later.
+typedef struct PacketizationPlan PacketizationPlan;
+
+/**
+ * @brief The packetization plan of a Tx stream. The first group of members is the shape of the payload the plan was
+ * recorded for, the second group is the way that payload was split into packets.
+ */
+struct PacketizationPlan {
+    bool valid;                    ///< True if the whole payload was recorded, so the plan can be used.
+
+    int group_size_bytes;          ///< TxPayloadState.group_size_bytes of the recorded payload.
+    int maximum_packet_byte_size;  ///< CdiPayloadPacketState.maximum_packet_byte_size of the recorded payload.
+    int maximum_tx_sgl_entries;    ///< CdiPayloadPacketState.maximum_tx_sgl_entries of the recorded payload.
+    int* entry_size_array;         ///< Sizes of the source SGL entries of the recorded payload.
+    int entry_count;               ///< Number of entries used in entry_size_array.
+    int entry_capacity;            ///< Number of entries allocated for entry_size_array.
+
+    PacketizationPlanPacket* packet_array; ///< Packets of the recorded payload.
+    int packet_count;              ///< Number of entries used in packet_array.
+    int packet_capacity;           ///< Number of entries allocated for packet_array.
+    int* piece_size_array;         ///< Sizes of the payload SGL entries of all of the packets, in order.
+    int piece_count;               ///< Number of entries used in piece_size_array.
+    int piece_capacity;            ///< Number of entries allocated for piece_size_array.
+};
+
 /**
  * @brief Structure to store the current state of a packet being constructed. Its purpose is to allow for the suspension
  * of the creation of a packet if a pool from which items need to be allocated is empty. A state object is passed in to
@@ -48,6 +85,21 @@ typedef struct {
     int sgl_entry_count;               ///< The number of SGL entries used so far to represent the current packet.
     uint8_t* data_addr_ptr;            ///< The current address in the payload buffer.
     int max_payload_bytes;             ///< The maximum number of payload bytes that can be put into this packet.
+
+    uint8_t* bounce_buffer_ptr;        ///< Bounce buffer of the current packet. NULL if none has been needed yet.
+    int bounce_buffer_used_bytes;      ///< Number of bytes of bounce_buffer_ptr used so far.
+    /// @brief The packet SGL entry that data is currently being copied into. NULL if the tail of the packet SGL is not
+    /// in the bounce buffer.
+    CdiSglEntry* bounce_entry_ptr;
+
+    /// @brief Packetization plan of the payload's stream. NULL if the payload is packetized without a plan.
+    PacketizationPlan* plan_ptr;
+    bool plan_replaying;               ///< True if packets are built from plan_ptr, false if they are recorded to it.
+    int plan_packet_index;             ///< Index of the current packet in the plan.
+    int plan_piece_index;              ///< Index of the next payload SGL entry of the current packet in the plan.
+    int source_entry_index;            ///< Index of the source SGL entry that source_entry_ptr points to.
+    int packet_first_entry_index;      ///< Value of source_entry_index when the current packet was started.
+    int packet_payload_data_offset;    ///< Payload data offset when the current packet was started.
 } CdiPacketizerState;
 
 //*********************************************************************************************************************
@@ -58,6 +110,135 @@ typedef struct {
 //******************************************* START OF STATIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
 
+/**
+ * Make sure that an array of a packetization plan has room for at least the specified number of items, growing it if
+ * necessary. The contents of the array are preserved.
+ *
+ * @param array_ptr Address of the pointer to the array.
+ * @param capacity_ptr Address of the number of items allocated for the array.
+ * @param item_count Number of items needed.
+ * @param item_size Size in bytes of each item.
+ *
+ * @return true if the array has room for item_count items, false if it would exceed TX_PACKETIZATION_PLAN_MAX_ITEMS or
+ *         memory could not be allocated.
+ */
+static bool PlanArrayReserve(void** array_ptr, int* capacity_ptr, int item_count, int item_size)
+{
+    if (item_count <= *capacity_ptr) {
+        return true;
+    }
+    if (item_count > TX_PACKETIZATION_PLAN_MAX_ITEMS) {
+        return false;
+    }
+
+    int new_capacity = *capacity_ptr ? *capacity_ptr : 64;
+    while (new_capacity < item_count) {
+        new_capacity *= 2;
+    }
+    new_capacity = CDI_MIN(new_capacity, TX_PACKETIZATION_PLAN_MAX_ITEMS);
+
+    void* new_array_ptr = CdiOsMemAlloc(new_capacity * item_size);
+    if (NULL == new_array_ptr) {
+        return false;
+    }
+    if (*array_ptr) {
+        memcpy(new_array_ptr, *array_ptr, *capacity_ptr * item_size);
+        CdiOsMemFree(*array_ptr);
+    }
+    *array_ptr = new_array_ptr;
+    *capacity_ptr = new_capacity;
+
+    return true;
+}
+
+/**
+ * Check whether a payload has the same shape as the payload that a packetization plan was recorded for.
+ *
+ * @param plan_ptr Pointer to the plan.
+ * @param payload_state_ptr Pointer to payload state data.
+ *
+ * @return true if the plan can be used to packetize the payload.
+ */
+static bool PlanMatches(const PacketizationPlan* plan_ptr, const TxPayloadState* payload_state_ptr)
+{
+    const CdiPayloadPacketState* packet_state_ptr = &payload_state_ptr->payload_packet_state;
+    if (!plan_ptr->valid || plan_ptr->group_size_bytes != payload_state_ptr->group_size_bytes ||
+        plan_ptr->maximum_packet_byte_size != packet_state_ptr->maximum_packet_byte_size ||
+        plan_ptr->maximum_tx_sgl_entries != packet_state_ptr->maximum_tx_sgl_entries) {
+        return false;
+    }
+
+    int i = 0;
+    for (const CdiSglEntry* entry_ptr = payload_state_ptr->source_sgl.sgl_head_ptr; entry_ptr;
+         entry_ptr = entry_ptr->next_ptr) {
+        if (i >= plan_ptr->entry_count || plan_ptr->entry_size_array[i] != entry_ptr->size_in_bytes) {
+            return false;
+        }
+        i++;
+    }
+
+    return i == plan_ptr->entry_count;
+}
+
+/**
+ * Discard the contents of a packetization plan and store the shape of a payload in it, so the payload's packets can be
+ * recorded to it.
+ *
+ * @param plan_ptr Pointer to the plan.
+ * @param payload_state_ptr Pointer to payload state data.
+ *
+ * @return true if successful, false if the payload can't be recorded because the plan would be too large.
+ */
+static bool PlanRecordStart(PacketizationPlan* plan_ptr, const TxPayloadState* payload_state_ptr)
+{
+    const CdiPayloadPacketState* packet_state_ptr = &payload_state_ptr->payload_packet_state;
+
+    plan_ptr->valid = false;
+    plan_ptr->group_size_bytes = payload_state_ptr->group_size_bytes;
+    plan_ptr->maximum_packet_byte_size = packet_state_ptr->maximum_packet_byte_size;
+    plan_ptr->maximum_tx_sgl_entries = packet_state_ptr->maximum_tx_sgl_entries;
+    plan_ptr->entry_count = 0;
+    plan_ptr->packet_count = 0;
+    plan_ptr->piece_count = 0;
+
+    for (const CdiSglEntry* entry_ptr = payload_state_ptr->source_sgl.sgl_head_ptr; entry_ptr;
+         entry_ptr = entry_ptr->next_ptr) {
+        if (!PlanArrayReserve((void**)&plan_ptr->entry_size_array, &plan_ptr->entry_capacity,
+                              plan_ptr->entry_count + 1, sizeof(int))) {
+            return false;
+        }
+        plan_ptr->entry_size_array[plan_ptr->entry_count++] = entry_ptr->size_in_bytes;
+    }
+
+    return true;
+}
+
+/**
+ * Advance the packetizer's position in the source SGL after data has been added to the current packet.
+ *
+ * @param packetizer_state_ptr Pointer to packetizer state.
+ * @param packet_state_ptr Pointer to the packet state of the payload.
+ * @param size Number of bytes that were added to the packet.
+ */
+static void SourceAdvance(CdiPacketizerState* packetizer_state_ptr, CdiPayloadPacketState* packet_state_ptr, int size)
+{
+    packetizer_state_ptr->accumulated_payload_bytes += size;
+    packetizer_state_ptr->data_addr_ptr += size;
+    packet_state_ptr->payload_data_offset += size;
+
+    packet_state_ptr->source_entry_address_offset += size;
+    if (packet_state_ptr->source_entry_address_offset >= packet_state_ptr->source_entry_ptr->size_in_bytes) {
+        packet_state_ptr->source_entry_ptr = packet_state_ptr->source_entry_ptr->next_ptr;
+        packet_state_ptr->source_entry_address_offset = 0;
+        packetizer_state_ptr->source_entry_index++;
+        if (NULL != packet_state_ptr->source_entry_ptr) {
+            packetizer_state_ptr->data_addr_ptr = packet_state_ptr->source_entry_ptr->address_ptr;
+        }
+    }
+
+    packet_state_ptr->packet_payload_data_size = packetizer_state_ptr->accumulated_payload_bytes;
+}
+
 //*********************************************************************************************************************
 //******************************************* START OF PUBLIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
@@ -77,7 +258,10 @@ bool PayloadInit(CdiConnectionState* con_state_ptr, const CdiSgList* source_sgl_
     // NOTE: source_entry_ptr is set below to point to the head of the copy of the SGL.
     packet_state_ptr->source_entry_address_offset = 0;
 
-    payload_state_ptr->source_sgl.internal_data_ptr = source_sgl_ptr->internal_data_ptr;
+    // Only keep internal_data_ptr for frames of a Tx frame allocator. It is not used otherwise, and leaving it NULL
+    // lets TxFrameAllocatorRelease() skip the allocator lookup for all other payloads.
+    payload_state_ptr->source_sgl.internal_data_ptr =
+        TxFrameAllocatorSglIsFrame(source_sgl_ptr) ? source_sgl_ptr->internal_data_ptr : NULL;
     payload_state_ptr->source_sgl.total_data_size = 0;
     payload_state_ptr->source_sgl.sgl_head_ptr = NULL;
     payload_state_ptr->source_sgl.sgl_tail_ptr = NULL;
@@ -116,9 +300,47 @@ CdiPacketizerStateHandle PayloadPacketizerCreate(void)
     return (CdiPacketizerStateHandle)CdiOsMemAllocZero(sizeof(CdiPacketizerState));
 }
 
-void PayloadPacketizerStateInit(CdiPacketizerStateHandle packetizer_state_handle)
+PacketizationPlanHandle PayloadPacketizationPlanCreate(void)
 {
-    ((CdiPacketizerState*)packetizer_state_handle)->state = kStateInactive;
+    return (PacketizationPlanHandle)CdiOsMemAllocZero(sizeof(PacketizationPlan));
+}
+
+void PayloadPacketizationPlanDestroy(PacketizationPlanHandle plan_handle)
+{
+    if (plan_handle) {
+        if (plan_handle->entry_size_array) {
+            CdiOsMemFree(plan_handle->entry_size_array);
+        }
+        if (plan_handle->packet_array) {
+            CdiOsMemFree(plan_handle->packet_array);
+        }
+        if (plan_handle->piece_size_array) {
+            CdiOsMemFree(plan_handle->piece_size_array);
+        }
+        CdiOsMemFree(plan_handle);
+    }
+}
+
+void PayloadPacketizerStateInit(CdiPacketizerStateHandle packetizer_state_handle, PacketizationPlanHandle plan_handle,
+                                const TxPayloadState* payload_state_ptr)
+{
+    CdiPacketizerState* packetizer_state_ptr = (CdiPacketizerState*)packetizer_state_handle;
+    packetizer_state_ptr->state = kStateInactive;
+    // A bounce buffer that is still held here belongs to a packet that was abandoned when the connection's resources
+    // were flushed, in which case the bounce buffer pool was flushed too.
+    packetizer_state_ptr->bounce_buffer_ptr = NULL;
+
+    // Use the stream's plan if this payload has the same shape as the last one, otherwise record a new plan.
+    packetizer_state_ptr->plan_ptr = plan_handle;
+    packetizer_state_ptr->plan_packet_index = 0;
+    packetizer_state_ptr->plan_replaying = false;
+    packetizer_state_ptr->source_entry_index = 0;
+    if (plan_handle) {
+        packetizer_state_ptr->plan_replaying = PlanMatches(plan_handle, payload_state_ptr);
+        if (!packetizer_state_ptr->plan_replaying && !PlanRecordStart(plan_handle, payload_state_ptr)) {
+            packetizer_state_ptr->plan_ptr = NULL;
+        }
+    }
 }
 
 void PayloadPacketizerDestroy(CdiPacketizerStateHandle packetizer_state_handle)
@@ -130,8 +352,8 @@ void PayloadPacketizerDestroy(CdiPacketizerStateHandle packetizer_state_handle)
 
 bool PayloadPacketizerPacketGet(CdiProtocolHandle protocol_handle, CdiPacketizerStateHandle packetizer_state_handle,
                                 char* header_ptr, CdiPoolHandle packet_sgl_entry_pool_handle,
-                                TxPayloadState* payload_state_ptr, CdiSgList* packet_sgl_ptr,
-                                bool* ret_is_last_packet_ptr)
+                                CdiPoolHandle bounce_buffer_pool_handle, TxPayloadState* payload_state_ptr,
+                                CdiSgList* packet_sgl_ptr, void** ret_bounce_buffer_ptr, bool* ret_is_last_packet_ptr)
 {
     bool ret = true;
 
@@ -193,8 +415,28 @@ bool PayloadPacketizerPacketGet(CdiProtocolHandle protocol_handle, CdiPacketizer
                 }
             }
 
+            if (packetizer_state_ptr->plan_replaying) {
+                // The header size only depends on the payload's shape and protocol, so it is not expected to differ
+                // from the plan. If it does anyway (for example the protocol version changed), stop using the plan; it
+                // is re-recorded with the next payload.
+                const PacketizationPlan* plan_ptr = packetizer_state_ptr->plan_ptr;
+                const int i = packetizer_state_ptr->plan_packet_index;
+                if (i < plan_ptr->packet_count &&
+                    packetizer_state_ptr->header_size == plan_ptr->packet_array[i].header_size) {
+                    packetizer_state_ptr->plan_piece_index = plan_ptr->packet_array[i].first_piece_index;
+                } else {
+                    packetizer_state_ptr->plan_ptr->valid = false;
+                    packetizer_state_ptr->plan_ptr = NULL;
+                    packetizer_state_ptr->plan_replaying = false;
+                }
+            }
+
+            packetizer_state_ptr->packet_first_entry_index = packetizer_state_ptr->source_entry_index;
+            packetizer_state_ptr->packet_payload_data_offset = packet_state_ptr->payload_data_offset;
             packetizer_state_ptr->accumulated_payload_bytes = 0;
             packetizer_state_ptr->sgl_entry_count = 1; // Allow for CDI header created above.
+            packetizer_state_ptr->bounce_buffer_used_bytes = 0;
+            packetizer_state_ptr->bounce_entry_ptr = NULL;
             packetizer_state_ptr->data_addr_ptr = (uint8_t*)packet_state_ptr->source_entry_ptr->address_ptr +
                                                   packet_state_ptr->source_entry_address_offset;
 
@@ -202,55 +444,130 @@ bool PayloadPacketizerPacketGet(CdiProtocolHandle protocol_handle, CdiPacketizer
         }
     }
 
-    if (kStateAddingEntries == packetizer_state_ptr->state) {
+    if (kStateAddingEntries == packetizer_state_ptr->state && packetizer_state_ptr->plan_replaying) {
+        // The packet boundaries and SGL splits were computed for an earlier payload of the same shape, so just create
+        // the packet's SGL entries from the plan.
+        const PacketizationPlan* plan_ptr = packetizer_state_ptr->plan_ptr;
+        const PacketizationPlanPacket* plan_packet_ptr =
+            &plan_ptr->packet_array[packetizer_state_ptr->plan_packet_index];
+        const int end_piece_index = plan_packet_ptr->first_piece_index + plan_packet_ptr->piece_count;
+        while (ret && packetizer_state_ptr->plan_piece_index < end_piece_index) {
+            const int sgl_data_size = plan_ptr->piece_size_array[packetizer_state_ptr->plan_piece_index];
+            CdiSglEntry *packet_entry_ptr = NULL;
+            ret = CdiPoolGet(packet_sgl_entry_pool_handle, (void**)&packet_entry_ptr);
+            if (ret) {
+                packet_entry_ptr->next_ptr = NULL;
+                packet_entry_ptr->internal_data_ptr = NULL;
+                packet_entry_ptr->address_ptr = packetizer_state_ptr->data_addr_ptr;
+                packet_entry_ptr->size_in_bytes = sgl_data_size;
+                SglAppend(packet_sgl_ptr, packet_entry_ptr); // NOTE: SGL list size is updated in this call.
+                packet_state_ptr->zero_copy_byte_count += sgl_data_size;
+                SourceAdvance(packetizer_state_ptr, packet_state_ptr, sgl_data_size);
+                packetizer_state_ptr->plan_piece_index++;
+            }
+        }
+    } else if (kStateAddingEntries == packetizer_state_ptr->state) {
         // Break out of this loop if we filled the packet, or we ran out of source SGL entries, or we have reached the
         // maximum number of SGL entries supported by the underlying adapter.
         while (ret &&
                packetizer_state_ptr->accumulated_payload_bytes < packetizer_state_ptr->max_payload_bytes &&
-               packetizer_state_ptr->sgl_entry_count < packet_state_ptr->maximum_tx_sgl_entries &&
                NULL != packet_state_ptr->source_entry_ptr) {
-            // Create new SGL entry for the payload data and add it to the packet SGL.
-            CdiSglEntry *packet_entry_ptr = NULL;
+            const int packet_bytes_left = packetizer_state_ptr->max_payload_bytes -
+                                          packetizer_state_ptr->accumulated_payload_bytes;
+            const int sgl_data_size = CDI_MIN(packet_state_ptr->source_entry_ptr->size_in_bytes -
+                                              packet_state_ptr->source_entry_address_offset, packet_bytes_left);
+            const bool entry_available =
+                packetizer_state_ptr->sgl_entry_count < packet_state_ptr->maximum_tx_sgl_entries;
+
+            // When coalescing, copy small fragments into the packet's bounce buffer. Also copy a fragment that would
+            // otherwise use the last SGL entry of the packet while leaving room for more data, so the packet is filled.
+            bool bounce = false;
+            if (bounce_buffer_pool_handle) {
+                const bool last_entry =
+                    packetizer_state_ptr->sgl_entry_count + 1 >= packet_state_ptr->maximum_tx_sgl_entries;
+                bounce = sgl_data_size < TX_COALESCE_FRAGMENT_MAX_BYTES ||
+                         (last_entry && sgl_data_size < packet_bytes_left &&
+                          NULL != packet_state_ptr->source_entry_ptr->next_ptr);
+                // Once the SGL entries are used up, data can only be added by copying it to the open bounce entry.
+                bounce = (bounce && (entry_available || packetizer_state_ptr->bounce_entry_ptr)) ||
+                         (!entry_available && packetizer_state_ptr->bounce_entry_ptr);
+            }
+            if (!bounce && !entry_available) {
+                break;
+            }
+
+            if (bounce && NULL == packetizer_state_ptr->bounce_entry_ptr) {
+                // Start a new run of copied data. It needs a bounce buffer if this is the first run of the packet.
+                if (NULL == packetizer_state_ptr->bounce_buffer_ptr) {
+                    ret = CdiPoolGet(bounce_buffer_pool_handle, (void**)&packetizer_state_ptr->bounce_buffer_ptr);
+                }
+                CdiSglEntry* packet_entry_ptr = NULL;
+                if (ret) {
+                    ret = CdiPoolGet(packet_sgl_entry_pool_handle, (void**)&packet_entry_ptr);
+                }
+                if (ret) {
+                    packet_entry_ptr->next_ptr = NULL;
+                    packet_entry_ptr->internal_data_ptr = NULL;
+                    packet_entry_ptr->address_ptr =
+                        packetizer_state_ptr->bounce_buffer_ptr + packetizer_state_ptr->bounce_buffer_used_bytes;
+                    packet_entry_ptr->size_in_bytes = 0;
+                    SglAppend(packet_sgl_ptr, packet_entry_ptr); // NOTE: SGL list size is updated in this call.
+                    packetizer_state_ptr->sgl_entry_count++;
+                    packetizer_state_ptr->bounce_entry_ptr = packet_entry_ptr;
+                }
+            }
+
+            if (ret && bounce) {
+                // Copy the data to the end of the open bounce entry.
+                memcpy(packetizer_state_ptr->bounce_buffer_ptr + packetizer_state_ptr->bounce_buffer_used_bytes,
+                       packetizer_state_ptr->data_addr_ptr, sgl_data_size);
+                packetizer_state_ptr->bounce_buffer_used_bytes += sgl_data_size;
+                packetizer_state_ptr->bounce_entry_ptr->size_in_bytes += sgl_data_size;
+                packet_sgl_ptr->total_data_size += sgl_data_size;
+                packet_state_ptr->bounced_byte_count += sgl_data_size;
+            } else if (ret) {
+                // Create new SGL entry for the payload data and add it to the packet SGL.
+                CdiSglEntry *packet_entry_ptr = NULL;
 #ifdef USE_MEMORY_POOL_APPENDED_LISTS
-            ret = CdiPoolGetAndAppend(packet_sgl_entry_pool_handle, packet_sgl_ptr->sgl_tail_ptr,
-                                        (void**)&packet_entry_data_ptr);
+                ret = CdiPoolGetAndAppend(packet_sgl_entry_pool_handle, packet_sgl_ptr->sgl_tail_ptr,
+                                            (void**)&packet_entry_data_ptr);
 #else
-            ret = CdiPoolGet(packet_sgl_entry_pool_handle, (void**)&packet_entry_ptr);
+                ret = CdiPoolGet(packet_sgl_entry_pool_handle, (void**)&packet_entry_ptr);
 #endif
-            if (ret) {
-                const int sgl_data_size = CDI_MIN(packet_state_ptr->source_entry_ptr->size_in_bytes -
-                                                  packet_state_ptr->source_entry_address_offset,
-                                                  packetizer_state_ptr->max_payload_bytes -
-                                                  packetizer_state_ptr->accumulated_payload_bytes);
-
-                // Initialize SGL entry.
-                packet_entry_ptr->next_ptr = NULL;
-                packet_entry_ptr->internal_data_ptr = NULL;
+                if (ret) {
+                    // Initialize SGL entry.
+                    packet_entry_ptr->next_ptr = NULL;
+                    packet_entry_ptr->internal_data_ptr = NULL;
+
+                    // Set SGL entry data and add it to the SGL list.
+                    packet_entry_ptr->address_ptr = packetizer_state_ptr->data_addr_ptr;
+                    packet_entry_ptr->size_in_bytes = sgl_data_size;
+                    SglAppend(packet_sgl_ptr, packet_entry_ptr); // NOTE: SGL list size is updated in this call.
+                    packetizer_state_ptr->sgl_entry_count++;
+                    packetizer_state_ptr->bounce_entry_ptr = NULL; // Any run of copied data has ended.
+                    packet_state_ptr->zero_copy_byte_count += sgl_data_size;
+                }
 
-                // Set SGL entry data and add it to the SGL list.
-                packet_entry_ptr->address_ptr = packetizer_state_ptr->data_addr_ptr;
-                packet_entry_ptr->size_in_bytes = sgl_data_size;
-                SglAppend(packet_sgl_ptr, packet_entry_ptr); // NOTE: SGL list size is updated in this call.
-                packetizer_state_ptr->sgl_entry_count++;
-
-                packetizer_state_ptr->accumulated_payload_bytes += sgl_data_size;
-                packetizer_state_ptr->data_addr_ptr += sgl_data_size;
-                packet_state_ptr->payload_data_offset += sgl_data_size;
-
-                packet_state_ptr->source_entry_address_offset += sgl_data_size;
-                if (packet_state_ptr->source_entry_address_offset >=
-                    packet_state_ptr->source_entry_ptr->size_in_bytes) {
-                    packet_state_ptr->source_entry_ptr = packet_state_ptr->source_entry_ptr->next_ptr;
-                    packet_state_ptr->source_entry_address_offset = 0;
-                    if (NULL != packet_state_ptr->source_entry_ptr) {
-                        packetizer_state_ptr->data_addr_ptr = packet_state_ptr->source_entry_ptr->address_ptr;
+                // Record the SGL entry in the plan. Plans are not used when coalescing, so this is the only kind of
+                // entry that needs recording.
+                PacketizationPlan* plan_ptr = packetizer_state_ptr->plan_ptr;
+                if (ret && plan_ptr) {
+                    if (PlanArrayReserve((void**)&plan_ptr->piece_size_array, &plan_ptr->piece_capacity,
+                                         plan_ptr->piece_count + 1, sizeof(int))) {
+                        plan_ptr->piece_size_array[plan_ptr->piece_count++] = sgl_data_size;
+                    } else {
+                        packetizer_state_ptr->plan_ptr = NULL; // Too large to record; packetize without a plan.
                     }
                 }
+            }
 
-                packet_state_ptr->packet_payload_data_size = packetizer_state_ptr->accumulated_payload_bytes;
+            if (ret) {
+                SourceAdvance(packetizer_state_ptr, packet_state_ptr, sgl_data_size);
             }
         }
+    }
 
+    if (kStateAddingEntries == packetizer_state_ptr->state) {
         *ret_is_last_packet_ptr = false;
         if (ret) {
             // Packet was successfully obtained, so update returned last state flag, increment packet counters and
@@ -267,8 +584,117 @@ bool PayloadPacketizerPacketGet(CdiProtocolHandle protocol_handle, CdiPacketizer
             packet_state_ptr->packet_sequence_num++;
             payload_state_ptr->cdi_endpoint_handle->tx_state.packet_id++;
             packetizer_state_ptr->state = kStateInactive;
+
+            PacketizationPlan* plan_ptr = packetizer_state_ptr->plan_ptr;
+            if (packetizer_state_ptr->plan_replaying) {
+                packetizer_state_ptr->plan_packet_index++;
+            } else if (plan_ptr) {
+                // Record the packet in the plan. The plan can be used once the last packet has been recorded.
+                if (PlanArrayReserve((void**)&plan_ptr->packet_array, &plan_ptr->packet_capacity,
+                                     plan_ptr->packet_count + 1, sizeof(PacketizationPlanPacket))) {
+                    const int first_piece_index = plan_ptr->packet_count ?
+                        plan_ptr->packet_array[plan_ptr->packet_count - 1].first_piece_index +
+                        plan_ptr->packet_array[plan_ptr->packet_count - 1].piece_count : 0;
+                    PacketizationPlanPacket* plan_packet_ptr = &plan_ptr->packet_array[plan_ptr->packet_count++];
+                    plan_packet_ptr->header_size = packetizer_state_ptr->header_size;
+                    plan_packet_ptr->first_piece_index = first_piece_index;
+                    plan_packet_ptr->piece_count = plan_ptr->piece_count - first_piece_index;
+                    plan_packet_ptr->first_entry_index = packetizer_state_ptr->packet_first_entry_index;
+                    plan_packet_ptr->payload_data_offset = packetizer_state_ptr->packet_payload_data_offset;
+                    plan_ptr->valid = *ret_is_last_packet_ptr;
+                } else {
+                    packetizer_state_ptr->plan_ptr = NULL;
+                }
+            }
+
+            // The packet owns the bounce buffer now.
+            *ret_bounce_buffer_ptr = packetizer_state_ptr->bounce_buffer_ptr;
+            packetizer_state_ptr->bounce_buffer_ptr = NULL;
         }
     }
 
     return ret;
 }
+
+int PayloadPacketizerParallelPacketsLeft(CdiPacketizerStateHandle packetizer_state_handle)
+{
+    const CdiPacketizerState* packetizer_state_ptr = (CdiPacketizerState*)packetizer_state_handle;
+
+    // Only packet #0 can have a header of a different size than in the plan (its extra data can change from payload to
+    // payload) and all other packets use the same header as packet #1. So once these two have been checked against the
+    // plan, the rest of the payload can be built from it without checking.
+    if (!packetizer_state_ptr->plan_replaying || kStateInactive != packetizer_state_ptr->state ||
+        packetizer_state_ptr->plan_packet_index < 2) {
+        return 0;
+    }
+
+    return packetizer_state_ptr->plan_ptr->packet_count - packetizer_state_ptr->plan_packet_index;
+}
+
+int PayloadPacketizationPlanPacketEntryCount(PacketizationPlanHandle plan_handle, int packet_index)
+{
+    return plan_handle->packet_array[packet_index].piece_count + 1; // Add one for the header.
+}
+
+void PayloadPacketizationPlanSeek(PacketizationPlanHandle plan_handle, int packet_index,
+                                  TxPayloadState* payload_state_ptr)
+{
+    const PacketizationPlanPacket* plan_packet_ptr = &plan_handle->packet_array[packet_index];
+    CdiPayloadPacketState* packet_state_ptr = &payload_state_ptr->payload_packet_state;
+
+    const CdiSglEntry* entry_ptr = payload_state_ptr->source_sgl.sgl_head_ptr;
+    int entry_payload_offset = 0;
+    for (int i = 0; i < plan_packet_ptr->first_entry_index; i++) {
+        entry_payload_offset += entry_ptr->size_in_bytes;
+        entry_ptr = entry_ptr->next_ptr;
+    }
+
+    packet_state_ptr->source_entry_ptr = entry_ptr;
+    packet_state_ptr->source_entry_address_offset = plan_packet_ptr->payload_data_offset - entry_payload_offset;
+    packet_state_ptr->payload_data_offset = plan_packet_ptr->payload_data_offset;
+    packet_state_ptr->packet_sequence_num = packet_index;
+    packet_state_ptr->payload_type = packet_index ? kPayloadTypeDataOffset : kPayloadTypeData;
+}
+
+void PayloadPacketizationPlanPacketBuild(CdiProtocolHandle protocol_handle, PacketizationPlanHandle plan_handle,
+                                         int packet_index, char* header_ptr, TxPayloadState* payload_state_ptr,
+                                         CdiSgList* packet_sgl_ptr)
+{
+    CdiPayloadPacketState* packet_state_ptr = &payload_state_ptr->payload_packet_state;
+    const PacketizationPlanPacket* plan_packet_ptr = &plan_handle->packet_array[packet_index];
+
+    // Build the header in the first SGL entry.
+    int msg_prefix_size = payload_state_ptr->cdi_endpoint_handle->adapter_endpoint_ptr->adapter_con_state_ptr->\
+                          adapter_state_ptr->msg_prefix_size;
+    int header_size = msg_prefix_size + ProtocolPayloadHeaderInit(protocol_handle,
+        (CdiRawPacketHeader*)(header_ptr + msg_prefix_size), payload_state_ptr);
+    assert(header_size == plan_packet_ptr->header_size);
+    CdiSglEntry* packet_entry_ptr = packet_sgl_ptr->sgl_head_ptr;
+    packet_entry_ptr->address_ptr = header_ptr;
+    packet_entry_ptr->size_in_bytes = header_size;
+
+    // Point the remaining SGL entries at the source data.
+    int payload_bytes = 0;
+    const int end_piece_index = plan_packet_ptr->first_piece_index + plan_packet_ptr->piece_count;
+    for (int i = plan_packet_ptr->first_piece_index; i < end_piece_index; i++) {
+        const int sgl_data_size = plan_handle->piece_size_array[i];
+        packet_entry_ptr = packet_entry_ptr->next_ptr;
+        packet_entry_ptr->address_ptr =
+            (uint8_t*)packet_state_ptr->source_entry_ptr->address_ptr + packet_state_ptr->source_entry_address_offset;
+        packet_entry_ptr->size_in_bytes = sgl_data_size;
+        payload_bytes += sgl_data_size;
+
+        packet_state_ptr->source_entry_address_offset += sgl_data_size;
+        if (packet_state_ptr->source_entry_address_offset >= packet_state_ptr->source_entry_ptr->size_in_bytes) {
+            packet_state_ptr->source_entry_ptr = packet_state_ptr->source_entry_ptr->next_ptr;
+            packet_state_ptr->source_entry_address_offset = 0;
+        }
+    }
+
+    packet_sgl_ptr->total_data_size = header_size + payload_bytes;
+    packet_state_ptr->packet_payload_data_size = payload_bytes;
+    packet_state_ptr->payload_data_offset += payload_bytes;
+    packet_state_ptr->packet_sequence_num++;
+    packet_state_ptr->packet_id++;
+    packet_state_ptr->payload_type = kPayloadTypeDataOffset;
+}
@@ -55,11 +55,18 @@ typedef struct {
                                          ///  data size of the source SGL entry is larger than the CDI packet data
                                          ///  size (the SGL entry spans more than 1 CDI packet).
     uint32_t payload_data_offset;        ///< Current offset of payload data.
+
+    int bounced_byte_count;              ///< Number of payload bytes copied into bounce buffers.
+    int zero_copy_byte_count;            ///< Number of payload bytes sent directly from the source SGL.
 } CdiPayloadPacketState;
 
 /// An opaque type for the packetizer to keep track of its progress in case it must be suspended for lack of resources.
 typedef struct CdiPacketizerState* CdiPacketizerStateHandle;
 
+/// @brief An opaque type for the packetization plan of a Tx stream. The plan caches the packet boundaries and SGL
+/// splits of the stream's last payload so payloads with the same shape are packetized without recomputing them.
+typedef struct PacketizationPlan* PacketizationPlanHandle;
+
 /// Forward reference of structure to create pointers later.
 typedef struct CdiConnectionState CdiConnectionState;
 /// Forward reference of structure to create pointers later.
@@ -103,13 +110,34 @@ CdiPacketizerStateHandle PayloadPacketizerCreate(void);
  */
 void PayloadPacketizerDestroy(CdiPacketizerStateHandle packetizer_state_handle);
 
+/**
+ * Creates a packetization plan object for a Tx stream. This must be destroyed with PayloadPacketizationPlanDestroy()
+ * when the stream's endpoint is destroyed.
+ *
+ * @return Handle for the created plan or NULL if the creation failed.
+ */
+PacketizationPlanHandle PayloadPacketizationPlanCreate(void);
+
+/**
+ * Frees the memory previously allocated for a packetization plan object through PayloadPacketizationPlanCreate().
+ *
+ * @param plan_handle The handle of the plan to be destroyed.
+ */
+void PayloadPacketizationPlanDestroy(PacketizationPlanHandle plan_handle);
+
 /**
  * Initializes a packetizer state object. This function should be called before calling CdiPayloadPacketizerPacketGet()
- * the first time for a given payload.
+ * the first time for a given payload. If the payload has the same shape (SGL entry sizes, group size and packet limits)
+ * as the last payload recorded in plan_handle, its packets are built from the plan. Otherwise the plan is replaced by
+ * the one of this payload while it is being packetized.
  *
  * @param packetizer_state_handle Handle of packetizer object.
+ * @param plan_handle Handle of the packetization plan of the payload's stream. NULL to packetize without a plan, which
+ *                    is required when coalescing small fragments into bounce buffers.
+ * @param payload_state_ptr Pointer to payload state data, initialized by PayloadInit().
  */
-void PayloadPacketizerStateInit(CdiPacketizerStateHandle packetizer_state_handle);
+void PayloadPacketizerStateInit(CdiPacketizerStateHandle packetizer_state_handle, PacketizationPlanHandle plan_handle,
+                                const TxPayloadState* payload_state_ptr);
 
 /**
  * Get the next packet for a payload. Must use CdiPayloadPacketizerStateInit() for a new payload before using this
@@ -123,15 +151,72 @@ void PayloadPacketizerStateInit(CdiPacketizerStateHandle packetizer_state_handle
  * @param packetizer_state_handle Handle of the packetizer state for this connection.
  * @param header_ptr Pointer to the header data structure to be filled in for the new packet.
  * @param packet_sgl_entry_pool_handle CDI packet SGL list entry pool.
+ * @param bounce_buffer_pool_handle Pool of bounce buffers used to coalesce small source SGL fragments. If NULL, all
+ *                                  data is sent directly from the source SGL.
  * @param payload_state_ptr Pointer to payload state data.
  * @param packet_sgl_ptr Pointer to returned packet SGL list
+ * @param ret_bounce_buffer_ptr Pointer to returned bounce buffer used by the packet. NULL if none was used. It must be
+ *                              returned to bounce_buffer_pool_handle once the packet has been sent.
  * @param ret_is_last_packet_ptr Pointer to returned last packet state. True if last packet, otherwise false.
  *
  * @return true if packet returned, otherwise a pool was empty so false is returned.
  */
 bool PayloadPacketizerPacketGet(CdiProtocolHandle protocol_handle, CdiPacketizerStateHandle packetizer_state_handle,
                                 char* header_ptr, CdiPoolHandle packet_sgl_entry_pool_handle,
-                                TxPayloadState* payload_state_ptr, CdiSgList* packet_sgl_ptr,
-                                bool* ret_is_last_packet_ptr);
+                                CdiPoolHandle bounce_buffer_pool_handle, TxPayloadState* payload_state_ptr,
+                                CdiSgList* packet_sgl_ptr, void** ret_bounce_buffer_ptr, bool* ret_is_last_packet_ptr);
+
+/**
+ * Get the number of packets of the current payload that are left to be built and can be built concurrently using
+ * PayloadPacketizationPlanPacketBuild() instead of PayloadPacketizerPacketGet(). This is only possible when the payload
+ * is being packetized from its stream's plan (see PayloadPacketizerStateInit()) and its first two packets have been
+ * obtained from PayloadPacketizerPacketGet(). Once this function returns a non-zero value, the rest of the payload must
+ * be built using PayloadPacketizationPlanPacketBuild().
+ *
+ * @param packetizer_state_handle Handle of packetizer object.
+ *
+ * @return The number of packets left, or zero if the packets must be obtained from PayloadPacketizerPacketGet().
+ */
+int PayloadPacketizerParallelPacketsLeft(CdiPacketizerStateHandle packetizer_state_handle);
+
+/**
+ * Get the number of SGL entries, including the one for the header, needed by a packet of a packetization plan.
+ *
+ * @param plan_handle Handle of the packetization plan.
+ * @param packet_index Index of the packet in the payload.
+ *
+ * @return The number of SGL entries.
+ */
+int PayloadPacketizationPlanPacketEntryCount(PacketizationPlanHandle plan_handle, int packet_index);
+
+/**
+ * Set the packet state of a payload so the next packet built by PayloadPacketizationPlanPacketBuild() is the specified
+ * packet of the plan.
+ *
+ * @param plan_handle Handle of the packetization plan of the payload's stream.
+ * @param packet_index Index of the packet in the payload.
+ * @param payload_state_ptr Pointer to payload state data. This is normally a private copy of the payload's state, so
+ *                          several threads can build packets of the same payload concurrently.
+ */
+void PayloadPacketizationPlanSeek(PacketizationPlanHandle plan_handle, int packet_index,
+                                  TxPayloadState* payload_state_ptr);
+
+/**
+ * Build a packet from a packetization plan and advance the packet state of the payload to the next packet. Neither the
+ * plan nor the payload's source SGL are modified, so this function can be called concurrently from several threads for
+ * different packets of the same payload as long as each thread uses its own copy of the payload state.
+ *
+ * @param protocol_handle Handle of protocol to use.
+ * @param plan_handle Handle of the packetization plan of the payload's stream.
+ * @param packet_index Index of the packet in the payload. Must match the position set by
+ *                     PayloadPacketizationPlanSeek().
+ * @param header_ptr Pointer to the header data structure to be filled in for the packet.
+ * @param payload_state_ptr Pointer to payload state data. Its packet_id must be set to the packet's ID.
+ * @param packet_sgl_ptr Pointer to the packet SGL list. It must already hold the number of linked SGL entries
+ *                       returned by PayloadPacketizationPlanPacketEntryCount() for the packet, which are filled in.
+ */
+void PayloadPacketizationPlanPacketBuild(CdiProtocolHandle protocol_handle, PacketizationPlanHandle plan_handle,
+                                         int packet_index, char* header_ptr, TxPayloadState* payload_state_ptr,
+                                         CdiSgList* packet_sgl_ptr);
 
 #endif  // CDI_PAYLOAD_H__
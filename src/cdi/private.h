@@ -29,6 +29,7 @@
 #include "list_api.h"
 #include "payload.h"
 #include "singly_linked_list_api.h"
+#include "worker_pool.h"
 
 //*********************************************************************************************************************
 //***************************************** START OF DEFINITIONS AND TYPES ********************************************
@@ -37,6 +38,9 @@
 /// @brief Forward reference of structure to create pointers later.
 typedef struct EndpointManagerGlobalState* EndpointManagerGlobalHandle;
 
+/// @brief Forward reference of structure to create pointers later.
+typedef struct StatsSchedulerState* StatsSchedulerHandle;
+
 /**
  * @brief Structure to hold variables that would otherwise be global in order to keep them contained in one manageable
  * location. All members will be explicitly zeroed at program startup.
@@ -52,6 +56,10 @@ typedef struct {
     CdiSglEntry empty_sgl_entry;              ///< Empty scatter-gather-list entry.
     CdiSignalType shutdown_signal;            ///< Signal used to shutdown global threads.
     CdiThreadID system_monitor_thread_id;     ///< The ID of the global system monitor thread.
+    WorkerPoolHandle worker_pool_handle;      ///< Handle of the SDK worker pool. NULL if the pool is not enabled.
+    StatsSchedulerHandle stats_scheduler_handle; ///< Handle of the stats scheduler shared by all connections.
+    CdiCsID tx_frame_allocator_list_lock;     ///< Lock used to protect access to the Tx frame allocator list.
+    CdiList tx_frame_allocator_list;          ///< List of CdiTxFrameAllocatorHandle objects.
 
     // NOTE: Add initialization to global_context variable's definition in internal.c for any new members added to this
     // structure.
@@ -146,6 +154,22 @@ struct TxPayloadState {
     /// units are not split between packets within a payload.
     int group_size_bytes;
 
+    /// @brief Rate in bytes per millisecond at which the packets of the payload are sent. Zero if the payload is not
+    /// paced (see CdiTxConfigData.pacing_window_microsecs).
+    uint32_t pacing_bytes_per_millisec;
+
+    uint64_t packetize_start_time;              ///< Time the packetizer started the payload.
+
+    /// @brief True if the payload was opened with CdiAvmEndpointTxPayloadOpen() and its data is appended while it is
+    /// being sent. source_sgl.total_data_size is the size of the whole payload in that case.
+    bool streaming;
+    /// @brief Number of bytes of a streaming payload that have been appended to source_sgl so far. Written by the
+    /// application thread that appends the data, so only accessed atomically.
+    uint32_t stream_appended_bytes;
+    /// @brief Generation of the CdiTxPayloadHandle of a streaming payload while data can be appended to it, zero once
+    /// it can't. Only accessed while holding TxConState.stream_lock.
+    uint64_t stream_generation;
+
     AppPayloadCallbackData app_payload_cb_data; ///< Used to hold data for application payload callback.
 
     CdiPayloadPacketState payload_packet_state; ///< CDI packet state data.
@@ -163,6 +187,9 @@ struct TxPayloadState {
  */
 typedef void (*CdiCallback)(const void* param_ptr);
 
+/// @brief Forward reference of structure to create pointers later.
+typedef struct TxPacketizerState TxPacketizerState;
+
 /**
  * @brief This defines a structure that contains all of the state information for the sending side of a single flow.
  */
@@ -189,6 +216,42 @@ typedef struct {
 
     /// @brief Queue of completed work requests that need their resources freed (TxPacketWorkRequest*).
     CdiQueueHandle work_req_comp_queue_handle;
+
+    /// @brief Memory pool for bounce buffers used to coalesce small payload SGL fragments. NULL unless the connection
+    /// is configured to coalesce them. Not thread-safe.
+    CdiPoolHandle bounce_buffer_pool_handle;
+    void* bounce_buffer_memory_ptr;   ///< Memory used by bounce_buffer_pool_handle. Registered with the adapter.
+    uint32_t bounce_buffer_memory_size; ///< Size in bytes of bounce_buffer_memory_ptr.
+
+    /// @brief Pointer to the packetizer state used by the adapter's poll thread when the connection is configured to
+    /// run to completion. NULL otherwise, in which case TxPayloadThread() uses its own packetizer state.
+    TxPacketizerState* poll_packetizer_state_ptr;
+
+    /// @brief Number of payload bytes of the payloads that have been started by the packetizer but have not completed.
+    /// Only used if config_data.deadline_scheduling is true. Only accessed atomically.
+    uint32_t deadline_in_flight_bytes;
+    /// @brief Estimate of the rate in bytes per millisecond at which the connection sends payloads. Zero until the
+    /// first payload has completed. Only used if config_data.deadline_scheduling is true. Only accessed atomically.
+    uint32_t deadline_bytes_per_millisec;
+    /// @brief Time the last payload completed. Only used by the adapter's poll thread to measure the rate.
+    uint64_t deadline_last_complete_time;
+
+    /// @brief Set whenever data is appended to a streaming payload (see TxPayloadState.streaming), so TxPayloadThread()
+    /// can resume packetizing a payload that ran out of data.
+    CdiSignalType payload_data_signal;
+    /// @brief Lock used to serialize appending data to streaming payloads with closing them, so data is never appended
+    /// to a payload state that has been released.
+    CdiCsID stream_lock;
+    /// @brief Generation given to the last streaming payload that was opened. Only accessed while holding stream_lock.
+    uint64_t stream_generation;
+    /// @brief Streaming payloads with this generation or a lower one were flushed, so no more data can be appended to
+    /// them. Only accessed while holding stream_lock.
+    uint64_t stream_flushed_generation;
+
+    /// @brief Number of payload messages that have been posted to app_payload_message_queue_handle and not yet
+    /// delivered to the application. Used by TxPayloadPrepare() to make sure the queue always has room for the
+    /// messages of the payloads in flight. Only accessed atomically.
+    uint32_t app_payload_message_count;
 } TxConState;
 
 /// Forward reference of structure to create pointers later.
@@ -225,6 +288,39 @@ struct CdiReorderList {
     CdiSgList sglist;          ///< Sgl in this reorder list.
 };
 
+/**
+ * @brief The payload SGL entries created from a single Rx packet, held in a slot of RxReorderBitmap.
+ */
+typedef struct {
+    CdiSglEntry* sgl_head_ptr; ///< First payload SGL entry of the packet.
+    CdiSglEntry* sgl_tail_ptr; ///< Last payload SGL entry of the packet.
+    int size_in_bytes;         ///< Number of payload data bytes in the packet.
+} RxReorderSlot;
+
+/**
+ * @brief A block of RX_REORDER_BITMAP_BLOCK_PACKETS consecutive packet slots of RxReorderBitmap.
+ */
+typedef struct {
+    RxReorderSlot slot_array[RX_REORDER_BITMAP_BLOCK_PACKETS]; ///< Slots, addressed by sequence number in the block.
+} RxReorderBitmapBlock;
+
+/**
+ * @brief State used to put the packets of a payload in order using a bitmap of the received packet sequence numbers and
+ * an array of packet slots indexed by sequence number, instead of the doubly linked CdiReorderList lists. The packets
+ * received without a gap from sequence number zero are linked together as they arrive, so once all of the packets of a
+ * payload have been received they form a single SGL. The slots are held in blocks that are only taken from their pool
+ * once a packet of the block has been received.
+ */
+typedef struct {
+    int contiguous_count;     ///< Number of packets received from sequence number zero without a gap.
+    int highest_sequence_num; ///< Highest sequence number received so far, or -1 if none.
+    /// @brief One bit per packet sequence number, set when the packet has been received.
+    uint64_t received_bitmap[RX_REORDER_BITMAP_MAX_PACKETS / RX_REORDER_BITMAP_BLOCK_PACKETS];
+    /// @brief Blocks holding the payload SGL entries of each packet, one for each word of received_bitmap. NULL until
+    /// the block is needed. A slot is only valid if the packet's bit in received_bitmap is set.
+    RxReorderBitmapBlock* block_ptr_array[RX_REORDER_BITMAP_MAX_PACKETS / RX_REORDER_BITMAP_BLOCK_PACKETS];
+} RxReorderBitmap;
+
 /**
  * @brief Enumeration used to maintain payload state.
  */
@@ -237,6 +333,14 @@ typedef enum {
     kPayloadComplete,          ///< Payload has completed but has not been sent; transition to Idle when sent.
 } CdiPayloadState;
 
+/**
+ * @brief A range of payload data that has been received, used to track the progress of a payload.
+ */
+typedef struct {
+    int start_offset; ///< Offset in the payload of the first byte of the range.
+    int end_offset;   ///< Offset in the payload of the byte that follows the range.
+} RxProgressRange;
+
 /**
  * @brief This defines a structure that contains all of the state information for the receiving side of a payload. The
  * data is only required internally by the RxPacketReceive() function and not used elsewhere.
@@ -256,8 +360,19 @@ typedef struct {
     int expected_payload_data_size;   ///< Expected total payload size in bytes obtained from CDI packet #0 header.
     int data_bytes_received;          ///< Number of payload bytes received.
     CdiReorderList* reorder_list_ptr; ///< Pointer to what will end up being the single SGL that comprises the payload
+    /// @brief Pointer to the bitmap reorder state of the payload. If not NULL it is used instead of reorder_list_ptr.
+    RxReorderBitmap* reorder_bitmap_ptr;
     uint32_t last_total_packet_count; ///< Value of total_packet_count when most recent packet of the payload was received.
     uint8_t* linear_buffer_ptr;       ///< Address to be used if assembling into a linear buffer.
+
+    /// @brief Number of bytes from the start of the payload that have been received with no gaps. Only used if the
+    /// connection has a progress callback (see CdiRxConfigData.progress_cb_ptr).
+    int progress_byte_count;
+    int progress_reported_byte_count; ///< Value of progress_byte_count when progress was last reported.
+    int progress_range_count;         ///< Number of entries in progress_range_array.
+    /// @brief Ranges of data received after the first gap in the payload, in no particular order. Ranges that don't
+    /// fit are not remembered, so progress stops at their start until the payload is complete.
+    RxProgressRange progress_range_array[RX_PROGRESS_MAX_PENDING_RANGES];
 } RxPayloadState;
 
 /**
@@ -275,6 +390,14 @@ typedef struct {
     /// @brief Memory pool for payload SGL entries that arrive out of order (CdiReorderList).
     CdiPoolHandle reorder_entries_pool_handle;
 
+    /// @brief Memory pool for the bitmap reorder state of payloads (RxReorderBitmap). NULL if the connection uses a
+    /// linear receive buffer.
+    CdiPoolHandle reorder_bitmap_pool_handle;
+
+    /// @brief Memory pool for the blocks of packet slots of the reorder bitmaps (RxReorderBitmapBlock). NULL if the
+    /// connection uses a linear receive buffer.
+    CdiPoolHandle reorder_bitmap_block_pool_handle;
+
     /// @brief Pool used to hold state data while receiving payloads.
     CdiPoolHandle rx_payload_state_pool_handle;
 
@@ -300,6 +423,9 @@ typedef struct {
     CdiCsID payload_num_lock;                   ///< Lock used to protect incrementing the payload number.
     uint16_t payload_num;                       ///< Payload number. Increments by 1 for each payload sent.
     uint32_t packet_id;                         ///< Packet ID. Increments by 1 for each packet sent (wraps at 0).
+    /// @brief Packetization plan of the stream's payloads. Only accessed by the connection's packetizer.
+    PacketizationPlanHandle packetization_plan_handle;
+    int priority; ///< Priority of the stream. See CdiTxConfigDataStream.priority.
 } TxEndpointState;
 
 /**
@@ -314,13 +440,17 @@ typedef struct {
     CdiQueueHandle free_buffer_queue_handle; ///< Circular queue of CdiSgList structures.
 
     /// @brief Current state of the payload number being processed. Array is addressed by payload_num, masked by
-    /// CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER-1.
-    RxPayloadState* payload_state_array_ptr[CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER];
+    /// payload_state_array_size-1.
+    RxPayloadState** payload_state_array_ptr;
+    /// @brief Number of entries in payload_state_array_ptr. Copy of CdiRxConfigData.payload_reorder_buffer_size.
+    int payload_state_array_size;
     /// @brief The current payload_state_array_ptr index that is pending completion or an error state, waiting to be
     /// sent in payload sequence order.
     int rxreorder_current_index;
     /// @brief The number of packets that are currently buffered in the Rx payload reorder process.
     int rxreorder_buffered_packet_count;
+    /// @brief Highest value of rxreorder_buffered_packet_count since it was last added to the endpoint's statistics.
+    int rxreorder_buffered_packet_count_max;
 } RxEndpointState;
 
 /**
@@ -395,6 +525,9 @@ struct CdiConnectionState {
     /// The ID of the thread that services payload messages from the related adapter.
     CdiThreadID app_payload_message_thread_id;
 
+    /// Task used instead of app_payload_message_thread_id to service payload messages when the worker pool is enabled.
+    WorkerPoolTask app_payload_message_task;
+
     /// Queue of payload AppPayloadCallbackData structures.
     CdiQueueHandle app_payload_message_queue_handle;
 
@@ -437,6 +570,7 @@ enum {
     kMagicConnection = 0xf98b0b0d,
     kMagicEndpoint   = 0x725c4e3a,
     kMagicMemory     = 0xdcf693e4,
+    kMagicTxFrame    = 0x3b8e17c6,
 };
 
 /**
@@ -446,6 +580,7 @@ typedef struct {
     void* virtual_address;      ///< Pointer to structure to free buffer(s).
     uint64_t physical_address;  ///< Physical address.
     uint32_t byte_size;         ///< Size of buffer in bytes.
+    bool rma_slot;              ///< True if the buffer is an adapter RMA slot instead of from the linear buffer pool.
 } MemoryLinearState;
 
 /**
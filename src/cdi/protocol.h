@@ -136,6 +136,7 @@ typedef enum {
     kProbeCommandConnected, ///< Notification that connection has been established (probe has completed).
     kProbeCommandAck,       ///< Packet is an ACK response to a previously sent command.
     kProbeCommandProtocolVersion, ///< Packet contains protocol version of sender.
+    kProbeCommandRmaSlots,  ///< Packet contains the receive buffer slots that the transmitter may write payloads into.
 } ProbeCommand;
 
 /**
@@ -153,6 +154,26 @@ typedef struct {
     uint16_t ack_control_packet_num;    ///< Command's control packet number that ACK corresponds to.
 } CdiDecodedProbeAck;
 
+/// @brief Maximum number of receive buffer slots that can be advertised using the kProbeCommandRmaSlots command.
+#define CDI_MAX_RMA_SLOTS               (8)
+
+/**
+ * @brief Receive buffer slots that a receiver advertises to the transmitter, so the transmitter can write payloads
+ * directly into them using RMA (see CdiRxConfigData.rma_direct_placement). A slot is free for the transmitter to use
+ * when the number of times it has written to the slot matches the number of times the receiver has freed it.
+ */
+typedef struct {
+    uint64_t base_address; ///< Remote address of the first slot, as used by RMA writes.
+    uint64_t key;          ///< Remote key of the memory region that holds the slots.
+    uint32_t slot_size;    ///< Size of each slot in bytes.
+    uint8_t slot_count;    ///< Number of slots. Not larger than CDI_MAX_RMA_SLOTS.
+    /// @brief Bit set for each slot that holds a payload the receiver has not freed yet. Used by the transmitter to
+    /// initialize its state once connected.
+    uint8_t held_mask;
+    /// @brief Number of times that the receiver has freed each slot. The value wraps at 256.
+    uint8_t release_count_array[CDI_MAX_RMA_SLOTS];
+} CdiDecodedProbeRmaSlots;
+
 /**
  * @brief Union of decoded probe headers. Use to reserve memory that can be used to hold any type of decoded CDI probe
  * header. Decoded headers are protocol independent.
@@ -166,6 +187,8 @@ typedef struct {
         CdiDecodedProbeCommand command_packet;
         ///< Valid if command is kProbeCommandAck. ACK packet transmitted over the control interface.
         CdiDecodedProbeAck ack_packet;
+        ///< Valid if command is kProbeCommandRmaSlots. Receive buffer slots advertised by the receiver.
+        CdiDecodedProbeRmaSlots rma_slots_packet;
     };
 
     const char* senders_ip_str;          ///< Pointer to sender's IP address.
@@ -192,7 +215,7 @@ typedef struct {
  * @brief Define the size of the ProbeHeaderUnion structure used in protocol V2. This is done so the size of the
  * structure is known at compile time without having to expose the contents of it in a header file.
  */
-#define CDI_RAW_PROBE_HEADER_SIZE_V2   (253)
+#define CDI_RAW_PROBE_HEADER_SIZE_V2   (277)
 
 /**
  * @brief Packet format used by probe when sending probe packets over the EFA interface.
@@ -373,6 +373,9 @@ static CdiReturnStatus ProbeHeaderDecode(const void* encoded_data_ptr, int encod
             case kProbeCommandProtocolVersion:
                 valid = true;
                 break;
+            case kProbeCommandRmaSlots:
+                // Only supported by protocol version 2 and later.
+                break;
         }
         if (!valid) {
             // We got here because none of the cases matched, so the command is invalid.
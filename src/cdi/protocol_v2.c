@@ -103,7 +103,7 @@ CDI_STATIC_ASSERT(CDI_RAW_PACKET_HEADER_SIZE_V2 == sizeof(PacketHeaderUnion), "T
 
 /**
  * @brief Common header for all probe control packets. NOTE: Last digit of Protocol Version is the probe version. This
- * file supports probe version 4.
+ * file supports probe version 5.
  *
  * SDK     Protocol Command    Raw Packet
  * Version Version  Header     Header     Comments
@@ -112,6 +112,7 @@ CDI_STATIC_ASSERT(CDI_RAW_PACKET_HEADER_SIZE_V2 == sizeof(PacketHeaderUnion), "T
  * 2.3.0    2.1.4   252 bytes  47 bytes
  * 2.3.1    2.1.4   252 bytes  47 bytes   Not supported (must upgrade)
  * 2.3.2    2.1.4   252 bytes  47 bytes
+ *          2.1.5   276 bytes  47 bytes   Adds kProbeCommandRmaSlots
  */
 typedef struct {
     CdiProtocolVersionNumber senders_version; ///< Sender's CDI protocol version number.
@@ -146,6 +147,18 @@ typedef struct {
     uint16_t ack_control_packet_num;    ///< Command's control packet number that ACK corresponds to.
 } ControlPacketAck;
 
+/**
+ * @brief Control packet that advertises the receive buffer slots of a receiver. See CdiDecodedProbeRmaSlots.
+ */
+typedef struct {
+    uint64_t base_address; ///< Remote address of the first slot, as used by RMA writes.
+    uint64_t key;          ///< Remote key of the memory region that holds the slots.
+    uint32_t slot_size;    ///< Size of each slot in bytes.
+    uint8_t slot_count;    ///< Number of slots.
+    uint8_t held_mask;     ///< Bit set for each slot that holds a payload the receiver has not freed yet.
+    uint8_t release_count_array[CDI_MAX_RMA_SLOTS]; ///< Number of times that the receiver has freed each slot.
+} ControlPacketRmaSlots;
+
 /**
  * @brief Structure used to hold a union of packets that are transmitted over the control or EFA interface.
  */
@@ -154,6 +167,7 @@ typedef struct {
     union {
         ControlPacketCommand command_packet; ///< Command packet transmitted over the control interface.
         ControlPacketAck ack_packet;         ///< ACK packet transmitted over the control interface.
+        ControlPacketRmaSlots rma_slots_packet; ///< Receive buffer slots packet transmitted over the control interface.
     };
 } ProbePacketUnion;
 
@@ -346,7 +360,19 @@ static CdiReturnStatus ProbeHeaderDecode(const void* encoded_data_ptr, int encod
         dest_header_ptr->command = common_hdr_ptr->command;
 
         header_size = (int)sizeof(ControlPacketCommonHeader);
-        if (common_hdr_ptr->command != kProbeCommandAck) {
+        if (common_hdr_ptr->command == kProbeCommandRmaSlots) {
+            // Decode receive buffer slots data.
+            const ControlPacketRmaSlots* slots_ptr = &union_ptr->rma_slots_packet;
+            CdiDecodedProbeRmaSlots* dest_slots_ptr = &dest_header_ptr->rma_slots_packet;
+            dest_slots_ptr->base_address = slots_ptr->base_address;
+            dest_slots_ptr->key = slots_ptr->key;
+            dest_slots_ptr->slot_size = slots_ptr->slot_size;
+            dest_slots_ptr->slot_count = CDI_MIN(slots_ptr->slot_count, CDI_MAX_RMA_SLOTS);
+            dest_slots_ptr->held_mask = slots_ptr->held_mask;
+            memcpy(dest_slots_ptr->release_count_array, slots_ptr->release_count_array,
+                   sizeof(dest_slots_ptr->release_count_array));
+            header_size += (int)sizeof(ControlPacketRmaSlots);
+        } else if (common_hdr_ptr->command != kProbeCommandAck) {
             // Encode command data.
             const ControlPacketCommand* cmd_ptr = &union_ptr->command_packet;
             dest_header_ptr->command_packet.requires_ack = cmd_ptr->requires_ack;
@@ -380,6 +406,7 @@ static CdiReturnStatus ProbeHeaderDecode(const void* encoded_data_ptr, int encod
             case kProbeCommandConnected:
             case kProbeCommandAck:
             case kProbeCommandProtocolVersion:
+            case kProbeCommandRmaSlots:
                 valid = true;
                 break;
         }
@@ -436,7 +463,19 @@ static int ProbeHeaderEncode(const CdiDecodedProbeHeader* src_header_ptr, CdiRaw
     common_hdr_ptr->control_packet_num = src_header_ptr->control_packet_num;
 
     int header_size = (int)sizeof(ControlPacketCommonHeader);
-    if (src_header_ptr->command != kProbeCommandAck) {
+    if (src_header_ptr->command == kProbeCommandRmaSlots) {
+        // Encode receive buffer slots data.
+        ControlPacketRmaSlots* slots_ptr = &union_ptr->rma_slots_packet;
+        const CdiDecodedProbeRmaSlots* src_slots_ptr = &src_header_ptr->rma_slots_packet;
+        slots_ptr->base_address = src_slots_ptr->base_address;
+        slots_ptr->key = src_slots_ptr->key;
+        slots_ptr->slot_size = src_slots_ptr->slot_size;
+        slots_ptr->slot_count = src_slots_ptr->slot_count;
+        slots_ptr->held_mask = src_slots_ptr->held_mask;
+        memcpy(slots_ptr->release_count_array, src_slots_ptr->release_count_array,
+               sizeof(slots_ptr->release_count_array));
+        header_size += (int)sizeof(ControlPacketRmaSlots);
+    } else if (src_header_ptr->command != kProbeCommandAck) {
         // Encode command data.
         ControlPacketCommand* cmd_ptr = &union_ptr->command_packet;
         cmd_ptr->requires_ack = src_header_ptr->command_packet.requires_ack;
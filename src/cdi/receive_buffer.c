@@ -31,6 +31,7 @@ struct ReceiveBufferState {
     CdiLogHandle log_handle; ///< Logger handle used for this connection. If NULL, the global logger is used.
     CdiPoolHandle error_message_pool; ///< Pool used to hold error message strings.
     CdiQueueHandle output_queue_handle; ///< Configured handle of where payloads are to be sent after being delayed.
+    WorkerPoolTask* output_task_ptr; ///< Worker pool task to schedule after sending payloads to output_queue_handle.
     CdiPoolHandle delay_pool_handle; ///< @brief Pool used to hold payload state data (AppPayloadCallbackData) that is
                                      /// stored in the thread's delay list ordered by send time.
     CdiQueueHandle input_queue_handle; ///< Handle of the input queue to the receive delay buffer.
@@ -111,7 +112,9 @@ CDI_THREAD ReceiveBufferThread(void* ptr)
             // Put the payload into the output queue if it's already late.
             if (send_time <= now) {
                 app_cb_data.receive_buffer_send_time = send_time;
-                CdiQueuePush(state_ptr->output_queue_handle, &app_cb_data);
+                if (CdiQueuePush(state_ptr->output_queue_handle, &app_cb_data)) {
+                    WorkerPoolTaskSchedule(state_ptr->output_task_ptr);
+                }
             } else {
                 // Cap send time to now + delay.
                 app_cb_data.receive_buffer_send_time = CDI_MIN(send_time, now + state_ptr->buffer_delay_microseconds);
@@ -158,6 +161,8 @@ CDI_THREAD ReceiveBufferThread(void* ptr)
             if (send_time <= now || send_time > now + state_ptr->buffer_delay_microseconds) {
                 if (!CdiQueuePush(state_ptr->output_queue_handle, app_cb_data_ptr)) {
                     PayloadErrorFreeBuffer(state_ptr->error_message_pool, app_cb_data_ptr);
+                } else {
+                    WorkerPoolTaskSchedule(state_ptr->output_task_ptr);
                 }
                 // Free the pool storage now that its data has been copied into the queue item's storage.
                 CdiPoolPut(state_ptr->delay_pool_handle, app_cb_data_ptr);
@@ -191,6 +196,8 @@ CDI_THREAD ReceiveBufferThread(void* ptr)
     while (NULL != (item_ptr = CdiListPop(&delay_list))) {
         if (!CdiQueuePush(state_ptr->output_queue_handle, item_ptr)) {
             PayloadErrorFreeBuffer(state_ptr->error_message_pool, (AppPayloadCallbackData*)item_ptr);
+        } else {
+            WorkerPoolTaskSchedule(state_ptr->output_task_ptr);
         }
         CdiPoolPut(state_ptr->delay_pool_handle, item_ptr);
     }
@@ -203,7 +210,7 @@ CDI_THREAD ReceiveBufferThread(void* ptr)
 //*********************************************************************************************************************
 
 CdiReturnStatus RxBufferInit(CdiLogHandle log_handle, CdiPoolHandle error_message_pool, int buffer_delay_ms,
-                             int max_rx_payloads, CdiQueueHandle output_queue_handle,
+                             int max_rx_payloads, CdiQueueHandle output_queue_handle, WorkerPoolTask* output_task_ptr,
                              ReceiveBufferHandle* receive_buffer_handle_ptr, CdiQueueHandle* input_queue_handle_ptr)
 {
     CdiReturnStatus rs = kCdiStatusOk;
@@ -215,6 +222,7 @@ CdiReturnStatus RxBufferInit(CdiLogHandle log_handle, CdiPoolHandle error_messag
     if (kCdiStatusOk == rs) {
         state_ptr->buffer_delay_microseconds = buffer_delay_ms * 1000;
         state_ptr->output_queue_handle = output_queue_handle;
+        state_ptr->output_task_ptr = output_task_ptr;
         state_ptr->log_handle = log_handle;
         state_ptr->error_message_pool = error_message_pool;
 
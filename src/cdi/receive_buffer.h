@@ -28,6 +28,7 @@ typedef struct ReceiveBufferState* ReceiveBufferHandle; ///< Forward declaration
  *                        timestamp value.
  * @param max_rx_payloads The number of objects to allocate for holding payloads in the delay buffer.
  * @param output_queue_handle Handle to which the receive delay buffer is to send payloads after they've been delayed.
+ * @param output_task_ptr Pointer to the worker pool task to schedule after sending payloads to output_queue_handle.
  * @param receive_buffer_handle_ptr Address of where to write the receive delay buffer's handle if successfully created.
  * @param input_queue_handle_ptr Address to write the handle for the receive delay buffer's input queue if creation was
  *                               successful.
@@ -36,7 +37,7 @@ typedef struct ReceiveBufferState* ReceiveBufferHandle; ///< Forward declaration
  *         kCdiStatusNotEnoughMemory if memory was insufficient to allocate all of the required resources.
  */
 CdiReturnStatus RxBufferInit(CdiLogHandle log_handle, CdiPoolHandle error_message_pool, int buffer_delay_ms,
-                             int max_rx_payloads, CdiQueueHandle output_queue_handle,
+                             int max_rx_payloads, CdiQueueHandle output_queue_handle, WorkerPoolTask* output_task_ptr,
                              ReceiveBufferHandle* receive_buffer_handle_ptr, CdiQueueHandle* input_queue_handle_ptr);
 
 /**
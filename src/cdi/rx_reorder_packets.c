@@ -168,9 +168,24 @@
  * At this point there is one list (0-7), which represents the entire example payload.
  * <br><br><br><br>
  *
+ * @section bitmap_reorder Bitmap reorder
+ *
+ * Under heavy reordering, walking and merging RxReorderLists costs pointer chasing and pool traffic for every packet.
+ * So when an RxReorderBitmap is available for a payload, it is used instead. It holds a bit for each sequence number
+ * that has been received and an array of slots, addressed by sequence number, that hold the SgList of each packet. The
+ * packets received from sequence number 0 without a gap are linked together as they arrive, so when the last missing
+ * packet arrives, the slots that follow it are attached by walking the bitmap and the payload is a single SgList.
+ *
+ * The slots are held in blocks of RX_REORDER_BITMAP_BLOCK_PACKETS, one for each word of the bitmap, that are taken from
+ * a pool when the first packet of a block arrives. So a payload of a few packets only uses a single block, while the
+ * bitmap can cover payloads of up to RX_REORDER_BITMAP_MAX_PACKETS packets.
+ *
+ * If a sequence number is received that does not fit in the bitmap, or no block is available for it, the runs of
+ * received packets in the bitmap are converted to RxReorderLists and the payload continues using them.
  */
 
 #include <stdbool.h>
+#include <string.h>
 
 #include "rx_reorder_packets.h"
 
@@ -185,6 +200,9 @@
 //***************************************** START OF DEFINITIONS AND TYPES ********************************************
 //*********************************************************************************************************************
 
+CDI_STATIC_ASSERT(64 == RX_REORDER_BITMAP_BLOCK_PACKETS, "A block must cover one uint64_t word of the bitmap.");
+CDI_STATIC_ASSERT(0 == (RX_REORDER_BITMAP_MAX_PACKETS % 64), "The define must be a multiple of 64.");
+
 //*********************************************************************************************************************
 //*********************************************** START OF VARIABLES **************************************************
 //*********************************************************************************************************************
@@ -531,6 +549,215 @@ static bool ProcessList(CdiProtocolHandle protocol_handle, CdiPoolHandle reorder
     return ret;
 }
 
+/**
+ * @brief Checks if the packet with the specified sequence number has been received by a payload that uses a bitmap.
+ *
+ * @param bitmap_ptr Pointer to the reorder bitmap of the payload.
+ * @param sequence_num The sequence number to check. Must be less than RX_REORDER_BITMAP_MAX_PACKETS.
+ *
+ * @return True if the packet has been received.
+ */
+static inline bool BitmapIsReceived(const RxReorderBitmap* bitmap_ptr, int sequence_num)
+{
+    return 0 != (bitmap_ptr->received_bitmap[sequence_num / 64] & ((uint64_t)1 << (sequence_num % 64)));
+}
+
+/**
+ * @brief Gets the slot of a bitmap for the specified sequence number. Its block must have been obtained using
+ * BitmapBlockGet().
+ *
+ * @param bitmap_ptr Pointer to the reorder bitmap of the payload.
+ * @param sequence_num The sequence number of the slot. Must be less than RX_REORDER_BITMAP_MAX_PACKETS.
+ *
+ * @return Pointer to the slot.
+ */
+static inline RxReorderSlot* BitmapSlot(const RxReorderBitmap* bitmap_ptr, int sequence_num)
+{
+    return &bitmap_ptr->block_ptr_array[sequence_num / RX_REORDER_BITMAP_BLOCK_PACKETS]->
+            slot_array[sequence_num % RX_REORDER_BITMAP_BLOCK_PACKETS];
+}
+
+/**
+ * @brief Makes sure that the block of slots for the specified sequence number has been taken from its pool.
+ *
+ * @param reorder_bitmap_block_pool_handle Handle for free rx reorder bitmap block memory.
+ * @param bitmap_ptr Pointer to the reorder bitmap of the payload.
+ * @param sequence_num The sequence number. Must be less than RX_REORDER_BITMAP_MAX_PACKETS.
+ *
+ * @return True if the block is available, false if the pool is empty.
+ */
+static bool BitmapBlockGet(CdiPoolHandle reorder_bitmap_block_pool_handle, RxReorderBitmap* bitmap_ptr,
+                           int sequence_num)
+{
+    RxReorderBitmapBlock** block_ptr_ptr = &bitmap_ptr->block_ptr_array[sequence_num / RX_REORDER_BITMAP_BLOCK_PACKETS];
+    return *block_ptr_ptr || CdiPoolGet(reorder_bitmap_block_pool_handle, (void**)block_ptr_ptr);
+}
+
+/**
+ * @brief Returns the blocks of a bitmap and then the bitmap itself to their pools. The payload SGL entries held in the
+ * slots must have been freed or moved elsewhere.
+ *
+ * @param reorder_bitmap_pool_handle Handle for free rx reorder bitmap memory.
+ * @param reorder_bitmap_block_pool_handle Handle for free rx reorder bitmap block memory.
+ * @param bitmap_ptr Pointer to the reorder bitmap to free.
+ */
+static void BitmapFree(CdiPoolHandle reorder_bitmap_pool_handle, CdiPoolHandle reorder_bitmap_block_pool_handle,
+                       RxReorderBitmap* bitmap_ptr)
+{
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(bitmap_ptr->block_ptr_array); i++) {
+        if (bitmap_ptr->block_ptr_array[i]) {
+            CdiPoolPut(reorder_bitmap_block_pool_handle, bitmap_ptr->block_ptr_array[i]);
+        }
+    }
+    CdiPoolPut(reorder_bitmap_pool_handle, bitmap_ptr);
+}
+
+/**
+ * @brief Returns the payload SGL entries held in the slots of a bitmap to their pool, starting with the specified
+ * sequence number. Each slot is detached from the slot that follows it before its entries are freed, so it doesn't
+ * matter which slots have already been linked together.
+ *
+ * @param payload_sgl_entry_pool_handle Handle for free SGL memory.
+ * @param bitmap_ptr Pointer to the reorder bitmap of the payload.
+ * @param first_sequence_num Sequence number of the first slot to free.
+ */
+static void BitmapFreeSlots(CdiPoolHandle payload_sgl_entry_pool_handle, RxReorderBitmap* bitmap_ptr,
+                            int first_sequence_num)
+{
+    for (int i = first_sequence_num; i <= bitmap_ptr->highest_sequence_num; i++) {
+        if (BitmapIsReceived(bitmap_ptr, i)) {
+            RxReorderSlot* slot_ptr = BitmapSlot(bitmap_ptr, i);
+            slot_ptr->sgl_tail_ptr->next_ptr = NULL;
+            if (!FreeSglEntries(payload_sgl_entry_pool_handle, slot_ptr->sgl_head_ptr)) {
+                CDI_LOG_THREAD(kLogError, "Failed to return SGL entry to free pool.");
+            }
+        }
+    }
+    bitmap_ptr->highest_sequence_num = -1;
+    bitmap_ptr->contiguous_count = 0;
+}
+
+/**
+ * @brief Adds an SGL list to the slot of a bitmap for its sequence number. If it extends the packets received without a
+ * gap from sequence number zero, it and any slots that follow it without a gap are linked to them. First SGL entry of
+ * the SGL list may have an offset. The block of the slot must have been obtained using BitmapBlockGet().
+ *
+ * @param protocol_handle Handle for protocol being used.
+ * @param payload_sgl_entry_pool_handle Handle for free SGL memory.
+ * @param bitmap_ptr Pointer to the reorder bitmap of the payload.
+ * @param new_sglist_ptr Pointer to entry to be added.
+ * @param sequence_num The sequence number of this SGL list. Must be less than RX_REORDER_BITMAP_MAX_PACKETS.
+ * @param initial_offset First SGL entry will have this offset applied.
+ * @param num_bytes_added_ptr Pointer to the number of bytes that were successfully added.
+ * @return True if adding SGL list is successful.
+ */
+static bool AddSgListToRxReorderBitmap(CdiProtocolHandle protocol_handle, CdiPoolHandle payload_sgl_entry_pool_handle,
+                                       RxReorderBitmap* bitmap_ptr, const CdiSgList* new_sglist_ptr, int sequence_num,
+                                       int initial_offset, int* num_bytes_added_ptr)
+{
+    *num_bytes_added_ptr = 0;
+    if (BitmapIsReceived(bitmap_ptr, sequence_num)) {
+        // The packet's data is not used, so it doesn't affect the payload.
+        CDI_LOG_THREAD(kLogWarning, "Sequence number[%d] has already been received! Skipping.", sequence_num);
+        return true;
+    }
+
+    CdiSgList sglist = { 0 };
+    if (!AddSgListToReorderList(protocol_handle, payload_sgl_entry_pool_handle, &sglist, new_sglist_ptr,
+                                initial_offset, num_bytes_added_ptr)) {
+        FreeSglEntries(payload_sgl_entry_pool_handle, sglist.sgl_head_ptr);
+        *num_bytes_added_ptr = 0;
+        return false;
+    }
+
+    RxReorderSlot* slot_ptr = BitmapSlot(bitmap_ptr, sequence_num);
+    slot_ptr->sgl_head_ptr = sglist.sgl_head_ptr;
+    slot_ptr->sgl_tail_ptr = sglist.sgl_tail_ptr;
+    slot_ptr->size_in_bytes = *num_bytes_added_ptr;
+    bitmap_ptr->received_bitmap[sequence_num / 64] |= (uint64_t)1 << (sequence_num % 64);
+    bitmap_ptr->highest_sequence_num = CDI_MAX(bitmap_ptr->highest_sequence_num, sequence_num);
+
+    if (sequence_num == bitmap_ptr->contiguous_count) {
+        // Link this packet and the packets that follow it without a gap to the packets already in order.
+        int i = sequence_num;
+        do {
+            if (i > 0) {
+                BitmapSlot(bitmap_ptr, i - 1)->sgl_tail_ptr->next_ptr = BitmapSlot(bitmap_ptr, i)->sgl_head_ptr;
+            }
+            i++;
+        } while (i <= bitmap_ptr->highest_sequence_num && BitmapIsReceived(bitmap_ptr, i));
+        bitmap_ptr->contiguous_count = i;
+    }
+#ifdef DEBUG_RX_REORDER_ALL
+    CDI_LOG_THREAD(kLogInfo, "Got sequence[%d]. In order [0-%d].", sequence_num, bitmap_ptr->contiguous_count - 1);
+#endif
+    return true;
+}
+
+/**
+ * @brief Moves a payload from its reorder bitmap to reorder lists, creating a list for each run of packets received
+ * without a gap. The bitmap and its blocks are returned to their pools.
+ *
+ * @param payload_sgl_entry_pool_handle Handle for free SGL memory.
+ * @param reorder_entries_pool_handle Handle for free rx reorder list memory.
+ * @param reorder_bitmap_pool_handle Handle for free rx reorder bitmap memory.
+ * @param reorder_bitmap_block_pool_handle Handle for free rx reorder bitmap block memory.
+ * @param payload_state_ptr Current state of the payload.
+ * @return True if successful. If false, the SGL entries of the payload have been freed.
+ */
+static bool ConvertRxReorderBitmapToLists(CdiPoolHandle payload_sgl_entry_pool_handle,
+                                          CdiPoolHandle reorder_entries_pool_handle,
+                                          CdiPoolHandle reorder_bitmap_pool_handle,
+                                          CdiPoolHandle reorder_bitmap_block_pool_handle,
+                                          RxPayloadState* payload_state_ptr)
+{
+    bool ret = true;
+    RxReorderBitmap* bitmap_ptr = payload_state_ptr->reorder_bitmap_ptr;
+    CdiReorderList* prev_reorder_list_ptr = NULL;
+#ifdef DEBUG_RX_REORDER_MIN
+    CDI_LOG_THREAD(kLogInfo, "Payload[%d] exceeds the reorder bitmap. Moving to reorder lists.",
+                   payload_state_ptr->payload_num);
+#endif
+
+    int i = 0;
+    while (ret && i <= bitmap_ptr->highest_sequence_num) {
+        if (BitmapIsReceived(bitmap_ptr, i)) {
+            CdiReorderList* new_reorder_list_ptr = NULL;
+            if (!CdiPoolGet(reorder_entries_pool_handle, (void**)&new_reorder_list_ptr)) {
+                // Free the lists created so far and then the slots that have not been moved to a list.
+                RxReorderPacketFreeLists(payload_state_ptr->reorder_list_ptr, payload_sgl_entry_pool_handle,
+                                         reorder_entries_pool_handle);
+                payload_state_ptr->reorder_list_ptr = NULL;
+                BitmapFreeSlots(payload_sgl_entry_pool_handle, bitmap_ptr, i);
+                ret = false;
+            } else {
+                new_reorder_list_ptr->next_ptr = NULL;
+                new_reorder_list_ptr->top_sequence_num = i;
+                new_reorder_list_ptr->sglist.sgl_head_ptr = BitmapSlot(bitmap_ptr, i)->sgl_head_ptr;
+                new_reorder_list_ptr->sglist.total_data_size = BitmapSlot(bitmap_ptr, i)->size_in_bytes;
+                while (i < bitmap_ptr->highest_sequence_num && BitmapIsReceived(bitmap_ptr, i + 1)) {
+                    BitmapSlot(bitmap_ptr, i)->sgl_tail_ptr->next_ptr = BitmapSlot(bitmap_ptr, i + 1)->sgl_head_ptr;
+                    new_reorder_list_ptr->sglist.total_data_size += BitmapSlot(bitmap_ptr, i + 1)->size_in_bytes;
+                    i++;
+                }
+                new_reorder_list_ptr->bot_sequence_num = i;
+                new_reorder_list_ptr->sglist.sgl_tail_ptr = BitmapSlot(bitmap_ptr, i)->sgl_tail_ptr;
+                InsertRxReorderList(prev_reorder_list_ptr, NULL, new_reorder_list_ptr);
+                if (NULL == prev_reorder_list_ptr) {
+                    payload_state_ptr->reorder_list_ptr = new_reorder_list_ptr;
+                }
+                prev_reorder_list_ptr = new_reorder_list_ptr;
+            }
+        }
+        i++;
+    }
+
+    BitmapFree(reorder_bitmap_pool_handle, reorder_bitmap_block_pool_handle, bitmap_ptr);
+    payload_state_ptr->reorder_bitmap_ptr = NULL;
+
+    return ret;
+}
+
 //*********************************************************************************************************************
 //******************************************* START OF PUBLIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
@@ -555,50 +782,173 @@ void RxReorderPacketFreeLists(CdiReorderList* reorder_list_ptr, CdiPoolHandle pa
 }
 
 bool RxReorderPacketPayloadStateInit(CdiProtocolHandle protocol_handle, CdiPoolHandle payload_sgl_entry_pool_handle,
-                                     CdiPoolHandle reorder_entries_pool_handle, RxPayloadState* payload_state_ptr,
+                                     CdiPoolHandle reorder_entries_pool_handle,
+                                     CdiPoolHandle reorder_bitmap_pool_handle,
+                                     CdiPoolHandle reorder_bitmap_block_pool_handle, RxPayloadState* payload_state_ptr,
                                      const CdiSgList* new_sglist_ptr, int initial_offset, int sequence_num)
 {
     bool ret = true;
     CdiReorderList* new_reorder_list_ptr = NULL;
+    RxReorderBitmap* bitmap_ptr = NULL;
     int num_bytes_added = 0;
 
-    // Because this is initialization, need only create a new rxreorder list and finish.
-    if (CreateAndInsertRxReorderList(protocol_handle, reorder_entries_pool_handle, payload_sgl_entry_pool_handle,
-                                     new_sglist_ptr, sequence_num, initial_offset, &num_bytes_added,
-                                     NULL, NULL, &new_reorder_list_ptr)) {
-        payload_state_ptr->reorder_list_ptr = new_reorder_list_ptr;
-        payload_state_ptr->data_bytes_received = num_bytes_added;
+    if (reorder_bitmap_pool_handle && sequence_num < RX_REORDER_BITMAP_MAX_PACKETS &&
+        CdiPoolGet(reorder_bitmap_pool_handle, (void**)&bitmap_ptr)) {
+        // This memory is not initialized for performance reasons. Only the bitmap and the block pointers need to be
+        // cleared, since the slots are only used once their bits have been set.
+        bitmap_ptr->contiguous_count = 0;
+        bitmap_ptr->highest_sequence_num = -1;
+        memset(bitmap_ptr->received_bitmap, 0, sizeof(bitmap_ptr->received_bitmap));
+        memset(bitmap_ptr->block_ptr_array, 0, sizeof(bitmap_ptr->block_ptr_array));
+        if (!BitmapBlockGet(reorder_bitmap_block_pool_handle, bitmap_ptr, sequence_num)) {
+            CdiPoolPut(reorder_bitmap_pool_handle, bitmap_ptr);
+            bitmap_ptr = NULL;
+        }
+    }
+
+    if (bitmap_ptr) {
+        payload_state_ptr->reorder_bitmap_ptr = bitmap_ptr;
+        ret = AddSgListToRxReorderBitmap(protocol_handle, payload_sgl_entry_pool_handle, bitmap_ptr, new_sglist_ptr,
+                                         sequence_num, initial_offset, &num_bytes_added);
     } else {
-        ret = false;
+        // Because this is initialization, need only create a new rxreorder list and finish.
+        ret = CreateAndInsertRxReorderList(protocol_handle, reorder_entries_pool_handle, payload_sgl_entry_pool_handle,
+                                           new_sglist_ptr, sequence_num, initial_offset, &num_bytes_added,
+                                           NULL, NULL, &new_reorder_list_ptr);
+        if (ret) {
+            payload_state_ptr->reorder_list_ptr = new_reorder_list_ptr;
+        }
     }
 
-    if (!ret) {
-        RxReorderPacketFreeLists(payload_state_ptr->reorder_list_ptr, payload_sgl_entry_pool_handle,
-                                 reorder_entries_pool_handle);
-        payload_state_ptr->reorder_list_ptr = NULL; // List freed and no longer valid, so clear it.
+    if (ret) {
+        payload_state_ptr->data_bytes_received = num_bytes_added;
+    } else {
+        RxReorderPacketPayloadStateFree(payload_sgl_entry_pool_handle, reorder_entries_pool_handle,
+                                        reorder_bitmap_pool_handle, reorder_bitmap_block_pool_handle,
+                                        payload_state_ptr);
     }
 
     return ret;
 }
 
 bool RxReorderPacket(CdiProtocolHandle protocol_handle, CdiPoolHandle payload_sgl_entry_pool_handle,
-                     CdiPoolHandle reorder_entries_pool_handle, RxPayloadState* payload_state_ptr,
+                     CdiPoolHandle reorder_entries_pool_handle, CdiPoolHandle reorder_bitmap_pool_handle,
+                     CdiPoolHandle reorder_bitmap_block_pool_handle, RxPayloadState* payload_state_ptr,
                      const CdiSgList* new_sglist_ptr, int initial_offset, int sequence_num)
 {
     bool ret = true;
     int num_bytes_added = 0;
+    RxReorderBitmap* bitmap_ptr = payload_state_ptr->reorder_bitmap_ptr;
+
+    if (bitmap_ptr && (sequence_num >= RX_REORDER_BITMAP_MAX_PACKETS ||
+                       !BitmapBlockGet(reorder_bitmap_block_pool_handle, bitmap_ptr, sequence_num))) {
+        // The payload has more packets than fit in the bitmap or there is no block for the packet's slot, so continue
+        // with the reorder lists.
+        ret = ConvertRxReorderBitmapToLists(payload_sgl_entry_pool_handle, reorder_entries_pool_handle,
+                                            reorder_bitmap_pool_handle, reorder_bitmap_block_pool_handle,
+                                            payload_state_ptr);
+    }
+
+    if (ret) {
+        if (payload_state_ptr->reorder_bitmap_ptr) {
+            ret = AddSgListToRxReorderBitmap(protocol_handle, payload_sgl_entry_pool_handle,
+                                             payload_state_ptr->reorder_bitmap_ptr, new_sglist_ptr, sequence_num,
+                                             initial_offset, &num_bytes_added);
+        } else {
+            // Search for a place to put this sequence number.
+            ret = ProcessList(protocol_handle, reorder_entries_pool_handle, payload_sgl_entry_pool_handle,
+                              &num_bytes_added, &payload_state_ptr->reorder_list_ptr, new_sglist_ptr,
+                              sequence_num, initial_offset);
+        }
+    }
 
-    // Search for a place to put this sequence number.
-    ret = ProcessList(protocol_handle, reorder_entries_pool_handle, payload_sgl_entry_pool_handle,
-                      &num_bytes_added, &payload_state_ptr->reorder_list_ptr, new_sglist_ptr,
-                      sequence_num, initial_offset);
     if (ret) {
         payload_state_ptr->data_bytes_received += num_bytes_added;
     } else {
-        RxReorderPacketFreeLists(payload_state_ptr->reorder_list_ptr, payload_sgl_entry_pool_handle,
-                                 reorder_entries_pool_handle);
-        payload_state_ptr->reorder_list_ptr = NULL; // List freed and no longer valid, so clear it.
+        RxReorderPacketPayloadStateFree(payload_sgl_entry_pool_handle, reorder_entries_pool_handle,
+                                        reorder_bitmap_pool_handle, reorder_bitmap_block_pool_handle,
+                                        payload_state_ptr);
     }
 
     return ret;
 }
+
+bool RxReorderPacketPayloadSglGet(CdiPoolHandle reorder_entries_pool_handle, CdiPoolHandle reorder_bitmap_pool_handle,
+                                  CdiPoolHandle reorder_bitmap_block_pool_handle, RxPayloadState* payload_state_ptr,
+                                  CdiSgList* sgl_ptr)
+{
+    bool ret = true;
+    RxReorderBitmap* bitmap_ptr = payload_state_ptr->reorder_bitmap_ptr;
+
+    if (bitmap_ptr) {
+        // All of the packets must have been linked in order from sequence number zero.
+        if (0 == bitmap_ptr->contiguous_count ||
+            bitmap_ptr->contiguous_count != bitmap_ptr->highest_sequence_num + 1) {
+#ifdef DEBUG_RX_REORDER_ERROR
+            CDI_LOG_THREAD(kLogError, "In order [0-%d]. Highest sequence number received[%d].",
+                           bitmap_ptr->contiguous_count - 1, bitmap_ptr->highest_sequence_num);
+#endif
+            ret = false;
+        } else {
+            sgl_ptr->sgl_head_ptr = BitmapSlot(bitmap_ptr, 0)->sgl_head_ptr;
+            sgl_ptr->sgl_tail_ptr = BitmapSlot(bitmap_ptr, bitmap_ptr->highest_sequence_num)->sgl_tail_ptr;
+            BitmapFree(reorder_bitmap_pool_handle, reorder_bitmap_block_pool_handle, bitmap_ptr);
+            payload_state_ptr->reorder_bitmap_ptr = NULL;
+        }
+    } else {
+        // If all data received, then there can only be one list and the next and prev pointers must be NULL.
+        CdiReorderList* reorder_list_ptr = payload_state_ptr->reorder_list_ptr;
+        if (NULL == reorder_list_ptr || reorder_list_ptr->next_ptr || reorder_list_ptr->prev_ptr) {
+#ifdef DEBUG_RX_REORDER_ERROR
+            while (reorder_list_ptr) {
+                CDI_LOG_THREAD(kLogError, "Unattached list [%d-%d].", reorder_list_ptr->top_sequence_num,
+                               reorder_list_ptr->bot_sequence_num);
+                reorder_list_ptr = reorder_list_ptr->next_ptr;
+            }
+#endif
+            ret = false;
+        } else {
+            sgl_ptr->sgl_head_ptr = reorder_list_ptr->sglist.sgl_head_ptr;
+            sgl_ptr->sgl_tail_ptr = reorder_list_ptr->sglist.sgl_tail_ptr;
+
+            // Free the reorder list memory entry.
+            CdiPoolPut(reorder_entries_pool_handle, reorder_list_ptr);
+            payload_state_ptr->reorder_list_ptr = NULL;
+        }
+    }
+
+    return ret;
+}
+
+const CdiSglEntry* RxReorderPacketInOrderSglGet(const RxPayloadState* payload_state_ptr)
+{
+    const CdiSglEntry* sgl_entry_ptr = NULL;
+    const RxReorderBitmap* bitmap_ptr = payload_state_ptr->reorder_bitmap_ptr;
+
+    if (bitmap_ptr) {
+        if (bitmap_ptr->contiguous_count) {
+            sgl_entry_ptr = BitmapSlot(bitmap_ptr, 0)->sgl_head_ptr;
+        }
+    } else if (payload_state_ptr->reorder_list_ptr && 0 == payload_state_ptr->reorder_list_ptr->top_sequence_num) {
+        // The first reorder list holds the packets received in order from packet #0.
+        sgl_entry_ptr = payload_state_ptr->reorder_list_ptr->sglist.sgl_head_ptr;
+    }
+
+    return sgl_entry_ptr;
+}
+
+void RxReorderPacketPayloadStateFree(CdiPoolHandle payload_sgl_entry_pool_handle,
+                                     CdiPoolHandle reorder_entries_pool_handle,
+                                     CdiPoolHandle reorder_bitmap_pool_handle,
+                                     CdiPoolHandle reorder_bitmap_block_pool_handle, RxPayloadState* payload_state_ptr)
+{
+    RxReorderPacketFreeLists(payload_state_ptr->reorder_list_ptr, payload_sgl_entry_pool_handle,
+                             reorder_entries_pool_handle);
+    payload_state_ptr->reorder_list_ptr = NULL; // List freed and no longer valid, so clear it.
+
+    if (payload_state_ptr->reorder_bitmap_ptr) {
+        BitmapFreeSlots(payload_sgl_entry_pool_handle, payload_state_ptr->reorder_bitmap_ptr, 0);
+        BitmapFree(reorder_bitmap_pool_handle, reorder_bitmap_block_pool_handle, payload_state_ptr->reorder_bitmap_ptr);
+        payload_state_ptr->reorder_bitmap_ptr = NULL; // Bitmap freed and no longer valid, so clear it.
+    }
+}
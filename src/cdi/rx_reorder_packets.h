@@ -26,11 +26,16 @@
 //*********************************************************************************************************************
 
 /**
- * @brief Adds initial entry to payload_state_ptr->reorder_list_ptr.
+ * @brief Adds initial entry to the reorder state of payload_state_ptr. If reorder_bitmap_pool_handle is not NULL and an
+ * RxReorderBitmap can be obtained from it, the payload is put in order using the bitmap, otherwise the reorder lists in
+ * payload_state_ptr->reorder_list_ptr are used.
  *
  * @param protocol_handle Handle for protocol being used.
  * @param payload_sgl_entry_pool_handle Handle to memory pool of payload SGL entries.
  * @param reorder_entries_pool_handle Handle to memory pool of rx_reorder entries.
+ * @param reorder_bitmap_pool_handle Handle to memory pool of RxReorderBitmap entries. May be NULL.
+ * @param reorder_bitmap_block_pool_handle Handle to memory pool of RxReorderBitmapBlock entries. May be NULL if
+ *                                         reorder_bitmap_pool_handle is NULL.
  * @param payload_state_ptr Current state of the payload, specifically a single rx_reorder entry.
  * @param new_sglist_ptr An SGL to be added to the end of the payload sgl.
  * @param initial_offset First SGL entry will have this offset applied.
@@ -39,21 +44,27 @@
  * @return True if successful.
  */
 bool RxReorderPacketPayloadStateInit(CdiProtocolHandle protocol_handle, CdiPoolHandle payload_sgl_entry_pool_handle,
-                                     CdiPoolHandle reorder_entries_pool_handle, RxPayloadState* payload_state_ptr,
+                                     CdiPoolHandle reorder_entries_pool_handle,
+                                     CdiPoolHandle reorder_bitmap_pool_handle,
+                                     CdiPoolHandle reorder_bitmap_block_pool_handle, RxPayloadState* payload_state_ptr,
                                      const CdiSgList* new_sglist_ptr, int initial_offset, int sequence_num);
 
 /**
  * @brief Adds an entry to the payload sgl. Also checks for and maintains outstanding packets that are received out of
- * order. If an SGL arrives that is out of order, it will be added to a doubly linked list (reorder list) of
- * outstanding dangling lists.
+ * order. If the payload is using the reorder lists and an SGL arrives that is out of order, it will be added to a
+ * doubly linked list (reorder list) of outstanding dangling lists. If the payload is using a bitmap, the SGL is stored
+ * in the slot for its sequence number. A payload using a bitmap is moved to the reorder lists if a sequence number is
+ * received that does not fit in the bitmap or no block of slots is available for it.
  *
- * Once all of the data for a payload is received, then the entries for payload_state_ptr->reorder_list_ptr->next_ptr
- * and payload_state_ptr->reorder_list_ptr->prev_ptr will be NULL, otherwise there are dangling lists that have
- * not been attached to the single payload list.
+ * Once all of the data for a payload is received, use RxReorderPacketPayloadSglGet() to get the single SGL that
+ * comprises the payload.
  *
  * @param protocol_handle Handle for protocol being used.
  * @param payload_sgl_entry_pool_handle Handle to memory pool of payload SGL entries.
  * @param reorder_entries_pool_handle Handle to memory pool of rx_reorder entries.
+ * @param reorder_bitmap_pool_handle Handle to memory pool of RxReorderBitmap entries. May be NULL.
+ * @param reorder_bitmap_block_pool_handle Handle to memory pool of RxReorderBitmapBlock entries. May be NULL if
+ *                                         reorder_bitmap_pool_handle is NULL.
  * @param payload_state_ptr Current state of the payload, specifically a single rx_reorder entry.
  * @param new_sglist_ptr An SGL to be added to the end of the payload sgl.
  * @param initial_offset First SGL entry will have this offset applied
@@ -62,9 +73,40 @@ bool RxReorderPacketPayloadStateInit(CdiProtocolHandle protocol_handle, CdiPoolH
  * @return True if successful.
  */
 bool RxReorderPacket(CdiProtocolHandle protocol_handle, CdiPoolHandle payload_sgl_entry_pool_handle,
-                     CdiPoolHandle reorder_entries_pool_handle, RxPayloadState* payload_state_ptr,
+                     CdiPoolHandle reorder_entries_pool_handle, CdiPoolHandle reorder_bitmap_pool_handle,
+                     CdiPoolHandle reorder_bitmap_block_pool_handle, RxPayloadState* payload_state_ptr,
                      const CdiSgList* new_sglist_ptr, int initial_offset, int sequence_num);
 
+/**
+ * @brief Gets the single SGL that comprises a payload once all of its data has been received. If successful, the
+ * payload SGL entries are now owned by sgl_ptr and the reorder state of the payload is released. Otherwise, there are
+ * packets that have not been attached to the payload SGL and the reorder state is left as is, so it must be freed using
+ * RxReorderPacketPayloadStateFree().
+ *
+ * @param reorder_entries_pool_handle Handle to memory pool of rx_reorder entries.
+ * @param reorder_bitmap_pool_handle Handle to memory pool of RxReorderBitmap entries. May be NULL.
+ * @param reorder_bitmap_block_pool_handle Handle to memory pool of RxReorderBitmapBlock entries. May be NULL if
+ *                                         reorder_bitmap_pool_handle is NULL.
+ * @param payload_state_ptr Current state of the payload.
+ * @param sgl_ptr Pointer to SGL whose head and tail pointers are set to the payload SGL.
+ *
+ * @return True if successful.
+ */
+bool RxReorderPacketPayloadSglGet(CdiPoolHandle reorder_entries_pool_handle, CdiPoolHandle reorder_bitmap_pool_handle,
+                                  CdiPoolHandle reorder_bitmap_block_pool_handle, RxPayloadState* payload_state_ptr,
+                                  CdiSgList* sgl_ptr);
+
+/**
+ * @brief Gets the first payload SGL entry of the packets received in order so far, starting with the first packet of
+ * the payload. The entries are linked, so the data received without a gap can be read by following their next
+ * pointers.
+ *
+ * @param payload_state_ptr Current state of the payload.
+ *
+ * @return Pointer to the first SGL entry, or NULL if none are available.
+ */
+const CdiSglEntry* RxReorderPacketInOrderSglGet(const RxPayloadState* payload_state_ptr);
+
 /**
  * @brief removes all lists and sgls used in processing the out of order packets
  *
@@ -75,4 +117,20 @@ bool RxReorderPacket(CdiProtocolHandle protocol_handle, CdiPoolHandle payload_sg
 void RxReorderPacketFreeLists(CdiReorderList* reorder_list_ptr, CdiPoolHandle payload_sgl_entry_pool_handle,
                               CdiPoolHandle reorder_entries_pool_handle);
 
+/**
+ * @brief Frees the reorder state of a payload, whether it uses the reorder lists or a bitmap, along with the payload
+ * SGL entries held by it.
+ *
+ * @param payload_sgl_entry_pool_handle Handle to memory pool of payload SGL entries.
+ * @param reorder_entries_pool_handle Handle to memory pool of rx_reorder entries.
+ * @param reorder_bitmap_pool_handle Handle to memory pool of RxReorderBitmap entries. May be NULL.
+ * @param reorder_bitmap_block_pool_handle Handle to memory pool of RxReorderBitmapBlock entries. May be NULL if
+ *                                         reorder_bitmap_pool_handle is NULL.
+ * @param payload_state_ptr Current state of the payload.
+ */
+void RxReorderPacketPayloadStateFree(CdiPoolHandle payload_sgl_entry_pool_handle,
+                                     CdiPoolHandle reorder_entries_pool_handle,
+                                     CdiPoolHandle reorder_bitmap_pool_handle,
+                                     CdiPoolHandle reorder_bitmap_block_pool_handle, RxPayloadState* payload_state_ptr);
+
 #endif  // RX_REORDER_H__
@@ -30,7 +30,8 @@
 /// @brief Ensure define is a power of 2.
 CDI_STATIC_ASSERT((0 == (CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER % 2)), "The define must be a power of 2.");
 
-/// @brief Ensure the packet out of order window is less than or equal to the payload out of order buffer.
+/// @brief Ensure the packet out of order window is less than or equal to the payload out of order buffer. The same is
+/// checked at runtime for the values configured for each connection.
 CDI_STATIC_ASSERT((CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW <= CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER), "...WINDOW must be <= ...BUFFER.");
 
 //*********************************************************************************************************************
@@ -44,14 +45,15 @@ CDI_STATIC_ASSERT((CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW <= CDI_MAX_RX_PAYLOAD_O
 /**
  * @brief Advance the specified state array index value by 1. If a maximum limit is reached, the value wraps to zero.
  *
+ * @param endpoint_state_ptr Pointer to endpoint state data.
  * @param payload_num_max Maximum value for payload number (protocol dependent).
  * @param index Current index value.
  *
  * @return New index value.
  */
-static inline int AdvanceStateArrayIndex(int payload_num_max, int index)
+static inline int AdvanceStateArrayIndex(const RxEndpointState* endpoint_state_ptr, int payload_num_max, int index)
 {
-    int max_value = CDI_MIN(payload_num_max, CDI_ARRAY_ELEMENT_COUNT(((RxEndpointState*)0)->payload_state_array_ptr)-1);
+    int max_value = CDI_MIN(payload_num_max, endpoint_state_ptr->payload_state_array_size-1);
     if (++index > max_value) {
         index = 0;
     }
@@ -131,7 +133,8 @@ static bool SendPayloadIfCompleteOrError(CdiEndpointState* endpoint_ptr, int ind
     if (sent) {
         int payload_num_max = endpoint_ptr->adapter_endpoint_ptr->protocol_handle->payload_num_max;
         // Set current index to next value, taking into account maximum limits.
-        endpoint_ptr->rx_state.rxreorder_current_index = AdvanceStateArrayIndex(payload_num_max, index);
+        endpoint_ptr->rx_state.rxreorder_current_index = AdvanceStateArrayIndex(&endpoint_ptr->rx_state,
+                                                                                payload_num_max, index);
     }
 
     return sent;
@@ -139,35 +142,40 @@ static bool SendPayloadIfCompleteOrError(CdiEndpointState* endpoint_ptr, int ind
 
 /**
  * Starting at the window start index, flush partial payloads or erred payloads freeing up enough Rx packet reorder
- * resources to get below the packet limit of MAX_RX_PACKET_OUT_OF_ORDER_WINDOW packets.
+ * resources to get below the packet limit of CdiRxConfigData.packet_reorder_window packets.
  *
  * @param endpoint_ptr Pointer to endpoint state structure.
  */
 static void FlushPartialPayload(CdiEndpointState* endpoint_ptr)
 {
     int payload_num_max = endpoint_ptr->adapter_endpoint_ptr->protocol_handle->payload_num_max;
+    const int packet_window = endpoint_ptr->connection_state_ptr->rx_state.config_data.packet_reorder_window;
+    CdiPayloadCounterStats* counter_stats_ptr = &endpoint_ptr->transfer_stats.payload_counter_stats;
+
+    CdiOsAtomicInc64(&counter_stats_ptr->num_rx_reorder_window_flushes);
 
     int idx = endpoint_ptr->rx_state.rxreorder_current_index;
     int starting_idx = idx;
-    while (endpoint_ptr->rx_state.rxreorder_buffered_packet_count >= CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW) {
+    while (endpoint_ptr->rx_state.rxreorder_buffered_packet_count >= packet_window) {
         RxPayloadState* payload_state_ptr = endpoint_ptr->rx_state.payload_state_array_ptr[idx];
         if (payload_state_ptr) {
             // If this payload is in progress, change it to the error state.
             if ((payload_state_ptr->payload_state == kPayloadInProgress) ||
                 (payload_state_ptr->payload_state == kPayloadPacketZeroPending)) {
                 RxReorderPayloadError(endpoint_ptr, payload_state_ptr);
+                CdiOsAtomicInc64(&counter_stats_ptr->num_rx_reorder_payloads_flushed);
             }
             // Send payload if state is complete or error, which reduces rxreorder_buffered_packet_count.
             SendPayloadIfCompleteOrError(endpoint_ptr, idx);
         }
 
         // Advance the index, taking into account maximum limits.
-        idx = AdvanceStateArrayIndex(payload_num_max, idx);
+        idx = AdvanceStateArrayIndex(&endpoint_ptr->rx_state, payload_num_max, idx);
 
         if (idx == starting_idx) {
             // Wrapped.
             CDI_LOG_THREAD(kLogError, "Failed to reduce Rx packet count[%d] below limit[%d]",
-                           endpoint_ptr->rx_state.rxreorder_buffered_packet_count, CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW);
+                           endpoint_ptr->rx_state.rxreorder_buffered_packet_count, packet_window);
             assert(false); // Should never occur.
             break;
         }
@@ -217,14 +225,14 @@ bool RxReorderPayloadIsStale(CdiEndpointState* endpoint_ptr, RxPayloadState* pay
         diff = UINT32_MAX - payload_state_ptr->last_total_packet_count + endpoint_state_ptr->total_packet_count;
     }
 
-    return (diff > CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW);
+    return (diff > (uint32_t)endpoint_ptr->connection_state_ptr->rx_state.config_data.packet_reorder_window);
 }
 
 RxPayloadState* RxReorderPayloadStateGet(CdiEndpointState* endpoint_ptr, CdiPoolHandle rx_payload_state_pool_handle,
                                          int payload_num)
 {
     // Get masked version of payload number (only use LSBs).
-    int current_payload_index = payload_num & (CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER-1);
+    int current_payload_index = payload_num & (endpoint_ptr->rx_state.payload_state_array_size-1);
 
     RxPayloadState* payload_state_ptr = endpoint_ptr->rx_state.payload_state_array_ptr[current_payload_index];
 
@@ -254,17 +262,18 @@ void RxReorderPayloadSendReadyPayloads(CdiEndpointState* endpoint_ptr)
     while (NULL != endpoint_ptr->rx_state.payload_state_array_ptr[idx] &&
         SendPayloadIfCompleteOrError(endpoint_ptr, idx)) {
         // Advance the index, taking into account maximum limits.
-        idx = AdvanceStateArrayIndex(payload_num_max, idx);
+        idx = AdvanceStateArrayIndex(&endpoint_ptr->rx_state, payload_num_max, idx);
     }
 
     // Now, check if we are at or above the maximum number of buffered packets used to reorder payloads.
-    if (endpoint_ptr->rx_state.rxreorder_buffered_packet_count >= CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW) {
+    CdiConnectionState* con_state_ptr = endpoint_ptr->connection_state_ptr;
+    const int packet_window = con_state_ptr->rx_state.config_data.packet_reorder_window;
+    if (endpoint_ptr->rx_state.rxreorder_buffered_packet_count >= packet_window) {
         // At the limit, so walk the payload state array and flush payload(s) until we get back below the limit.
-        CdiConnectionState* con_state_ptr = endpoint_ptr->connection_state_ptr;
         CdiLogLevel log_level = con_state_ptr->rx_state.received_first_payload ? kLogError : kLogDebug;
         CDI_LOG_THREAD(log_level,
                        "Connection[%s] Exceeded rx-reorder packet cache window size[%d]. Flushing payload(s).",
-                       con_state_ptr->saved_connection_name_str, CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW);
+                       con_state_ptr->saved_connection_name_str, packet_window);
         FlushPartialPayload(endpoint_ptr);
     }
 }
@@ -277,7 +286,7 @@ void RxReorderPayloadSeekFirstPayload(CdiEndpointState* endpoint_ptr) {
 
     while (NULL == endpoint_ptr->rx_state.payload_state_array_ptr[idx]) {
         // Advance the index, taking into account maximum limits.
-        idx = AdvanceStateArrayIndex(payload_num_max, idx);
+        idx = AdvanceStateArrayIndex(&endpoint_ptr->rx_state, payload_num_max, idx);
         if (idx == endpoint_ptr->rx_state.rxreorder_current_index) {
             break;
         }
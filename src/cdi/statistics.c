@@ -19,6 +19,7 @@
 #include "cdi_os_api.h"
 #include "cloudwatch.h"
 #include "endpoint_manager.h"
+#include "internal.h"
 #include "internal_log.h"
 #include "t_digest.h"
 
@@ -30,27 +31,19 @@
 //*********************************************************************************************************************
 
 /**
- * Function pointer used for sending metrics from the StatsThread().
+ * Function pointer used for sending metrics from StatsSchedulerThread().
  */
-typedef void (*SendStatsMessage)(StatisticsState* stats_state_ptr, int stats_path_number);
-
-/**
- * Arguments to the StatsThread().
- */
-typedef struct {
-    StatisticsState* stats_state_ptr; ///< Pointer to the StatsState to be managed by the thread.
-    SendStatsMessage send_stats_message_ptr; ///< Pointer to the function for sending statistics.
-    int metrics_destination_idx;      ///< The index into StatisticsState.destination_info array to use for this thread.
-} StatsThreadArgs;
+typedef void (*SendStatsMessage)(StatisticsState* stats_state_ptr, int stats_path_number, uint64_t timestamp_ms);
 
 /**
  * @brief Structure that holds the parts of StatisticsState structure required per statistics gathering path.
  */
 typedef struct {
+    StatsSchedulerEntry scheduler_entry; ///< Used to schedule this destination with the stats scheduler.
     TDigestHandle td_handle;          ///< Handle for accessing this connection's percentile tracking t-Digest.
-    CdiSignalType thread_exit_signal; ///< Signal used for dynamic thread exit.
-    CdiThreadID stats_thread_id;      ///< Stats thread ID. The thread is dynamically created/destroyed as needed.
-    StatsThreadArgs* stats_thread_args_ptr; ///< Stats thread argument pointer (malloced instance data).
+    StatisticsState* stats_state_ptr; ///< Pointer to the statistics state this destination belongs to.
+    SendStatsMessage send_stats_message_ptr; ///< Pointer to the function for sending statistics.
+    int metrics_destination_idx;      ///< The index of this entry in the StatisticsState.destination_info array.
 } MetricsDestinationInfo;
 
 /**
@@ -85,6 +78,28 @@ struct StatisticsState {
     CloudWatchHandle metrics_gatherer_handle; ///< Handle of object to send metrics to gathering service.
 };
 
+/// @brief Forward reference of structure to create pointers later.
+typedef struct StatsSchedulerState StatsSchedulerState;
+
+/**
+ * @brief Structure used to hold state data for the stats scheduler. A single scheduler thread gathers and sends the
+ * statistics for all connections. Each metrics destination is sent on boundaries of its period relative to the UTC
+ * epoch, so statistics for all connections that use the same period are gathered at the same time and carry the same
+ * timestamp. The statistics are sent without holding the lock, so user callbacks are free to reconfigure statistics.
+ */
+struct StatsSchedulerState {
+    CdiCsID lock;                     ///< Lock used to protect access to the lists and sending_dest_ptr.
+    CdiList destination_list;         ///< List of StatsSchedulerEntry entries being scheduled.
+    CdiList due_list;                 ///< List of StatsSchedulerEntry entries whose statistics are due now.
+    StatsSchedulerEntry* sending_dest_ptr; ///< Destination whose statistics are being sent, NULL if none.
+    CdiSignalType send_done_signal;   ///< Signal set when the statistics of sending_dest_ptr have been sent.
+    CdiThreadData thread_data;        ///< Thread-local slot, set to this structure on the scheduler thread.
+    bool thread_data_allocated;       ///< True if thread_data has been allocated.
+    CdiSignalType shutdown_signal;    ///< Signal used to shutdown the scheduler thread.
+    CdiSignalType wake_signal;        ///< Signal used to wake up the scheduler thread when the list changes.
+    CdiThreadID thread_id;            ///< Scheduler thread identifier.
+};
+
 //*********************************************************************************************************************
 //*********************************************** START OF VARIABLES **************************************************
 //*********************************************************************************************************************
@@ -101,48 +116,109 @@ static const int metrics_gathering_period_ms = 60000;
  *
  * @param endpoint_ptr Pointer to endpoint state data.
  * @param ret_stats_ptr Address where to write returned statistics data.
- * @param destination_idx The index into the destination info array within the statistics state.
+ * @param percentiles_ptr Pointer to the percentile values computed for the connection for this time interval.
+ * @param timestamp_ms Timestamp of the stats in milliseconds since epoch.
  */
-static void GetStats(CdiEndpointState* endpoint_ptr, CdiTransferStats* ret_stats_ptr, int destination_idx)
+static void GetStats(CdiEndpointState* endpoint_ptr, CdiTransferStats* ret_stats_ptr,
+                     const CdiPayloadTimeIntervalStats* percentiles_ptr, uint64_t timestamp_ms)
 {
     StatisticsState* stats_state_ptr = endpoint_ptr->connection_state_ptr->stats_state_ptr;
-    MetricsDestinationInfo* stats_path_members_ptr = &stats_state_ptr->destination_info[destination_idx];
 
     CdiOsCritSectionReserve(stats_state_ptr->stats_data_lock); // Synchronize with the writer.
 
     // Set timestamp of the stats, in milliseconds since epoch.
-    struct timespec tm;
-    CdiOsGetUtcTime(&tm);
-    endpoint_ptr->transfer_stats.timestamp_in_ms_since_epoch = (tm.tv_sec * 1000) + (tm.tv_nsec / 1000000);
+    endpoint_ptr->transfer_stats.timestamp_in_ms_since_epoch = timestamp_ms;
 
-    // Get percentile values for P50, P90, P99. Also get min and max, which are P0 and P100, respectively.
-    TDigestHandle td_handle = stats_path_members_ptr->td_handle;
+    // Apply the percentile values. The transfer time sum, count and maximum, and the reorder window occupancy are kept
+    // per endpoint.
     CdiPayloadTimeIntervalStats* interval_ptr = &endpoint_ptr->transfer_stats.payload_time_interval_stats;
-    TDigestGetPercentileValue(td_handle, 0, &interval_ptr->transfer_time_min);
-    TDigestGetPercentileValue(td_handle, 50, &interval_ptr->transfer_time_P50);
-    TDigestGetPercentileValue(td_handle, 90, &interval_ptr->transfer_time_P90);
-    TDigestGetPercentileValue(td_handle, 99, &interval_ptr->transfer_time_P99);
-    TDigestGetPercentileValue(td_handle, 100, &interval_ptr->transfer_time_max);
-    interval_ptr->transfer_count = TDigestGetCount(td_handle);
+    const uint64_t transfer_time_sum = interval_ptr->transfer_time_sum;
+    const int endpoint_transfer_count = interval_ptr->endpoint_transfer_count;
+    const uint32_t endpoint_transfer_time_max = interval_ptr->endpoint_transfer_time_max;
+    const int rx_reorder_window_packets_max = interval_ptr->rx_reorder_window_packets_max;
+    *interval_ptr = *percentiles_ptr;
+    interval_ptr->transfer_time_sum = transfer_time_sum;
+    interval_ptr->endpoint_transfer_count = endpoint_transfer_count;
+    interval_ptr->endpoint_transfer_time_max = endpoint_transfer_time_max;
+    interval_ptr->rx_reorder_window_packets_max = rx_reorder_window_packets_max;
 
     // Copy the stats series to returned stats.
     *ret_stats_ptr = endpoint_ptr->transfer_stats;
 
     // Reset the payload time interval stats.
     memset(interval_ptr, 0, sizeof(*interval_ptr));
+
+    CdiOsCritSectionRelease(stats_state_ptr->stats_data_lock);
+}
+
+/**
+ * Compute the percentile values for the specified metrics destination of a connection and then reset its t-Digest.
+ * The t-Digest holds the samples of all endpoints of the connection, so this is done once per time interval.
+ *
+ * @param stats_state_ptr Pointer to stats state data.
+ * @param destination_idx The index into the destination info array within the statistics state.
+ * @param ret_percentiles_ptr Address where to write the percentile values.
+ */
+static void GetPercentiles(StatisticsState* stats_state_ptr, int destination_idx,
+                           CdiPayloadTimeIntervalStats* ret_percentiles_ptr)
+{
+    TDigestHandle td_handle = stats_state_ptr->destination_info[destination_idx].td_handle;
+
+    memset(ret_percentiles_ptr, 0, sizeof(*ret_percentiles_ptr));
+
+    CdiOsCritSectionReserve(stats_state_ptr->stats_data_lock); // Synchronize with the writer.
+
+    // Get percentile values for P50, P90, P99. Also get min and max, which are P0 and P100, respectively.
+    TDigestGetPercentileValue(td_handle, 0, &ret_percentiles_ptr->transfer_time_min);
+    TDigestGetPercentileValue(td_handle, 50, &ret_percentiles_ptr->transfer_time_P50);
+    TDigestGetPercentileValue(td_handle, 90, &ret_percentiles_ptr->transfer_time_P90);
+    TDigestGetPercentileValue(td_handle, 99, &ret_percentiles_ptr->transfer_time_P99);
+    TDigestGetPercentileValue(td_handle, 100, &ret_percentiles_ptr->transfer_time_max);
+    ret_percentiles_ptr->transfer_count = TDigestGetCount(td_handle);
+
     // Reset the t-Digest.
     TDigestClear(td_handle);
 
     CdiOsCritSectionRelease(stats_state_ptr->stats_data_lock);
 }
 
+/**
+ * Collect a snapshot of the statistics of all endpoints of a connection for the specified metrics destination.
+ *
+ * @param stats_state_ptr Pointer to stats state data.
+ * @param destination_idx The index into the destination info array within the statistics state.
+ * @param timestamp_ms Timestamp of the stats in milliseconds since epoch.
+ * @param transfer_stats_array Array of CDI_MAX_ENDPOINTS_PER_CONNECTION entries where to write the statistics.
+ *
+ * @return Number of entries written to transfer_stats_array.
+ */
+static int GetConnectionStats(StatisticsState* stats_state_ptr, int destination_idx, uint64_t timestamp_ms,
+                              CdiTransferStats* transfer_stats_array)
+{
+    int stats_count = 0;
+
+    CdiPayloadTimeIntervalStats percentiles;
+    GetPercentiles(stats_state_ptr, destination_idx, &percentiles);
+
+    // Collect the stats from all of the endpoints of the connection.
+    CdiEndpointHandle endpoint_handle =
+        EndpointManagerGetFirstEndpoint(stats_state_ptr->con_state_ptr->endpoint_manager_handle);
+    while (endpoint_handle && stats_count < CDI_MAX_ENDPOINTS_PER_CONNECTION) {
+        GetStats(endpoint_handle, transfer_stats_array + stats_count++, &percentiles, timestamp_ms);
+        endpoint_handle = EndpointManagerGetNextEndpoint(endpoint_handle);
+    }
+
+    return stats_count;
+}
+
 /**
  * Get latest transfer statistics data and provide to users by invoking all registered callbacks.
  *
  * @param stats_state_ptr Pointer to stats state data.
  * @param destination_idx The index into the destination info array within the statistics state.
+ * @param timestamp_ms Timestamp of the stats in milliseconds since epoch.
  */
-static void SendUserStatsMessage(StatisticsState* stats_state_ptr, int destination_idx)
+static void SendUserStatsMessage(StatisticsState* stats_state_ptr, int destination_idx, uint64_t timestamp_ms)
 {
     CdiTransferStats transfer_stats_array[CDI_MAX_ENDPOINTS_PER_CONNECTION];
     CdiCoreStatsCbData cb_data = {
@@ -151,16 +227,8 @@ static void SendUserStatsMessage(StatisticsState* stats_state_ptr, int destinati
         .stats_user_cb_param = stats_state_ptr->user_cb_param,
     };
 
-    // Collect the stats from all of the endpoints of the connection.
-    CdiEndpointHandle endpoint_handle =
-        EndpointManagerGetFirstEndpoint(stats_state_ptr->con_state_ptr->endpoint_manager_handle);
-
-    if (endpoint_handle) {
-        while (endpoint_handle) {
-            GetStats(endpoint_handle, cb_data.transfer_stats_array + cb_data.stats_count++, destination_idx);
-            endpoint_handle = EndpointManagerGetNextEndpoint(endpoint_handle);
-        }
-
+    cb_data.stats_count = GetConnectionStats(stats_state_ptr, destination_idx, timestamp_ms, transfer_stats_array);
+    if (cb_data.stats_count) {
         if (stats_state_ptr->user_cb_ptr) {
             (stats_state_ptr->user_cb_ptr)(&cb_data);
         }
@@ -178,19 +246,12 @@ static void SendUserStatsMessage(StatisticsState* stats_state_ptr, int destinati
  *
  * @param stats_state_ptr Pointer to stats state data.
  * @param destination_idx The index into the destination info array within the statistics state.
+ * @param timestamp_ms Timestamp of the stats in milliseconds since epoch.
  */
-static void SendToCdiMetricsService(StatisticsState* stats_state_ptr, int destination_idx)
+static void SendToCdiMetricsService(StatisticsState* stats_state_ptr, int destination_idx, uint64_t timestamp_ms)
 {
     CdiTransferStats transfer_stats_array[CDI_MAX_ENDPOINTS_PER_CONNECTION];
-    int stats_count = 0;
-
-    // Collect the stats from all of the endpoints of the connection.
-    CdiEndpointHandle endpoint_handle =
-        EndpointManagerGetFirstEndpoint(stats_state_ptr->con_state_ptr->endpoint_manager_handle);
-    while (endpoint_handle) {
-        GetStats(endpoint_handle, transfer_stats_array + stats_count++, destination_idx);
-        endpoint_handle = EndpointManagerGetNextEndpoint(endpoint_handle);
-    }
+    int stats_count = GetConnectionStats(stats_state_ptr, destination_idx, timestamp_ms, transfer_stats_array);
 
     if (stats_state_ptr->metrics_gatherer_handle) {
         CloudWatchStatisticsMessage(stats_state_ptr->metrics_gatherer_handle, stats_count, transfer_stats_array);
@@ -199,133 +260,195 @@ static void SendToCdiMetricsService(StatisticsState* stats_state_ptr, int destin
 #endif  // METRICS_GATHERING_SERVICE_ENABLED
 
 /**
- * Statistic gathering thread used to invoke registered callback functions when new statistics are available.
+ * Get the current UTC time in milliseconds since epoch.
+ *
+ * @return Current time in milliseconds.
+ */
+static uint64_t UtcTimeMilliseconds(void)
+{
+    struct timespec tm;
+    CdiOsGetUtcTime(&tm);
+    return ((uint64_t)tm.tv_sec * 1000) + (tm.tv_nsec / 1000000);
+}
+
+/**
+ * Get the first boundary of the specified period, relative to the UTC epoch, that is later than the specified time.
+ *
+ * @param now_ms Current UTC time in milliseconds.
+ * @param period_ms Period in milliseconds.
+ *
+ * @return UTC time in milliseconds of the next period boundary.
+ */
+static inline uint64_t NextPeriodBoundary(uint64_t now_ms, uint32_t period_ms)
+{
+    return ((now_ms / period_ms) + 1) * period_ms;
+}
+
+/**
+ * Send the statistics of all destinations in the stats scheduler's due list. The lock is only held while taking a
+ * destination off the due list, so the send functions, which invoke user callbacks and queue CloudWatch messages, can
+ * add or remove destinations without deadlocking or disturbing the scheduler's iteration.
+ *
+ * @param scheduler_ptr Pointer to stats scheduler state data.
+ */
+static void SendDueStats(StatsSchedulerState* scheduler_ptr)
+{
+    while (true) {
+        CdiOsCritSectionReserve(scheduler_ptr->lock);
+        CdiListEntry* entry_ptr = CdiListPop(&scheduler_ptr->due_list);
+        StatsSchedulerEntry* dest_ptr = NULL;
+        if (entry_ptr) {
+            // Put it back into the scheduled list before sending, so it can be removed from within the send function.
+            dest_ptr = CONTAINER_OF(entry_ptr, StatsSchedulerEntry, list_entry);
+            dest_ptr->due = false;
+            CdiListAddTail(&scheduler_ptr->destination_list, &dest_ptr->list_entry);
+            scheduler_ptr->sending_dest_ptr = dest_ptr;
+            CdiOsSignalClear(scheduler_ptr->send_done_signal);
+        }
+        CdiOsCritSectionRelease(scheduler_ptr->lock);
+
+        if (NULL == dest_ptr) {
+            break;
+        }
+
+        // Use the connection's log while working on its behalf.
+        CdiLoggerThreadLogSet(dest_ptr->log_handle);
+        (dest_ptr->send_func_ptr)(dest_ptr->send_param_ptr, dest_ptr->due_timestamp_ms);
+        CdiLoggerThreadLogUnset();
+
+        // Let StatsSchedulerRemove() know it is safe to release the destination.
+        CdiOsCritSectionReserve(scheduler_ptr->lock);
+        scheduler_ptr->sending_dest_ptr = NULL;
+        CdiOsSignalSet(scheduler_ptr->send_done_signal);
+        CdiOsCritSectionRelease(scheduler_ptr->lock);
+    }
+}
+
+/**
+ * Stats scheduler thread. Invokes the send function of each scheduled metrics destination when its period boundary
+ * has been reached. All destinations that are due at the same time are gathered together in a single pass.
  *
- * @param ptr Pointer to thread specific data. In this case, a pointer to StatisticsState.
+ * @param ptr Pointer to thread specific data. In this case, a pointer to StatsSchedulerState.
  *
  * @return The return value is not used.
  */
-static CDI_THREAD StatsThread(void* ptr)
+static CDI_THREAD StatsSchedulerThread(void* ptr)
 {
-    StatsThreadArgs* args_ptr = (StatsThreadArgs*)ptr;
-    StatisticsState* stats_state_ptr = args_ptr->stats_state_ptr;
-    CdiConnectionState* con_state_ptr = stats_state_ptr->con_state_ptr;
+    StatsSchedulerState* scheduler_ptr = (StatsSchedulerState*)ptr;
 
-    // Set this thread to use the connection's log. Can now use CDI_LOG_THREAD() for logging within this thread.
-    CdiLoggerThreadLogSet(con_state_ptr->log_handle);
+    // Lets StatsSchedulerRemove() detect that it was called from a send function on this thread.
+    CdiOsThreadSetData(scheduler_ptr->thread_data, scheduler_ptr);
 
     // Setup an array of signals to wait on.
     CdiSignalType signal_array[2];
-    signal_array[0] = con_state_ptr->shutdown_signal;
-    signal_array[1] = stats_state_ptr->destination_info[args_ptr->metrics_destination_idx].thread_exit_signal;
+    signal_array[0] = scheduler_ptr->shutdown_signal;
+    signal_array[1] = scheduler_ptr->wake_signal;
 
-    uint64_t base_time = CdiOsGetMilliseconds();
-    uint64_t interval_counter = 0;
-
-    uint32_t wait_time_ms = stats_state_ptr->stats_period_ms;
+    uint32_t wait_time_ms = CDI_INFINITE;
     uint32_t signal_index = 0;
     while (CdiOsSignalsWait(signal_array, 2, false, wait_time_ms, &signal_index)) {
-        wait_time_ms = stats_state_ptr->stats_period_ms;
-        if (0 == signal_index || 1 == signal_index) {
-            // Got shutdown or thread exit signal, so exit.
+        if (0 == signal_index) {
+            // Got shutdown signal, so exit.
             break;
-        } else {
-            // Got timeout (CDI_OS_SIG_TIMEOUT). Send latest stats to all registered callbacks.
-            args_ptr->send_stats_message_ptr(stats_state_ptr, args_ptr->metrics_destination_idx);
-            interval_counter++;
-            uint64_t next_start_time = base_time + (interval_counter * (uint64_t)stats_state_ptr->stats_period_ms) +
-                                       (uint64_t)stats_state_ptr->stats_period_ms;
-
-            uint64_t current_time = CdiOsGetMilliseconds();
-            if (current_time > next_start_time) {
-                uint32_t late_time_ms = (uint32_t)(current_time - next_start_time);
-                CDI_LOG_THREAD(kLogError, "Connection[%s] Gather stats late by [%"PRIu32"]ms.",
-                               con_state_ptr->saved_connection_name_str, late_time_ms);
-                // Set new base time, reset interval counter and set wait time to zero (process next stat immediately).
-                base_time = current_time;
-                interval_counter = 0;
-                wait_time_ms = 0;
-            } else {
-                // Calculate remaining wait time in order to stay on cadence.
-                wait_time_ms = next_start_time - current_time;
-
-                // Assure wait time is never greater than stats_period_ms.
-                if (wait_time_ms > stats_state_ptr->stats_period_ms) {
-                    CDI_LOG_THREAD(kLogWarning, "Connection[%s] Wait time rolled. Wait time [%"PRIu32"]ms versus"
-                                   " stats period [%"PRIu32"]ms.", con_state_ptr->saved_connection_name_str,
-                                   wait_time_ms, stats_state_ptr->stats_period_ms);
-                    wait_time_ms = stats_state_ptr->stats_period_ms;
-                    base_time = current_time;
-                    interval_counter = 0;
+        } else if (1 == signal_index) {
+            // The list of destinations changed, so just recompute the wait time.
+            CdiOsSignalClear(scheduler_ptr->wake_signal);
+        }
+
+        CdiOsCritSectionReserve(scheduler_ptr->lock);
+
+        uint64_t now_ms = UtcTimeMilliseconds();
+        wait_time_ms = CDI_INFINITE;
+
+        CdiListIterator list_iterator;
+        CdiListIteratorInit(&scheduler_ptr->destination_list, &list_iterator);
+        CdiListEntry* entry_ptr = NULL;
+        while (NULL != (entry_ptr = CdiListIteratorGetNext(&list_iterator))) {
+            StatsSchedulerEntry* dest_ptr = CONTAINER_OF(entry_ptr, StatsSchedulerEntry, list_entry);
+
+            if (now_ms >= dest_ptr->next_due_ms) {
+                uint64_t late_time_ms = now_ms - dest_ptr->next_due_ms;
+                if (late_time_ms > dest_ptr->period_ms) {
+                    CdiLoggerThreadLogSet(dest_ptr->log_handle);
+                    CDI_LOG_THREAD(kLogError, "Connection[%s] Gather stats late by [%"PRIu64"]ms.",
+                                   dest_ptr->name_str, late_time_ms);
+                    CdiLoggerThreadLogUnset();
                 }
+
+                // Timestamp the stats using the period boundary so they line up across all connections. They are sent
+                // by SendDueStats() once the lock has been released.
+                dest_ptr->due_timestamp_ms = dest_ptr->next_due_ms;
+                dest_ptr->next_due_ms = NextPeriodBoundary(now_ms, dest_ptr->period_ms);
+                CdiListRemove(&scheduler_ptr->destination_list, &dest_ptr->list_entry);
+                CdiListAddTail(&scheduler_ptr->due_list, &dest_ptr->list_entry);
+                dest_ptr->due = true;
+            } else if (dest_ptr->next_due_ms - now_ms > dest_ptr->period_ms) {
+                // The host clock was set backwards, so re-align to the current time.
+                dest_ptr->next_due_ms = NextPeriodBoundary(now_ms, dest_ptr->period_ms);
+            }
+
+            uint64_t remaining_ms = dest_ptr->next_due_ms - now_ms;
+            if (remaining_ms < wait_time_ms) {
+                wait_time_ms = (uint32_t)remaining_ms;
             }
         }
-    }
 
-    // Thread is exiting. Send last set of stats, if any.
-    args_ptr->send_stats_message_ptr(stats_state_ptr, args_ptr->metrics_destination_idx);
+        CdiOsCritSectionRelease(scheduler_ptr->lock);
+
+        SendDueStats(scheduler_ptr);
+    }
 
     return 0; // Return code not used.
 }
 
 /**
- * Destroy stats thread. Used for both dynamic and shutdown destruction.
+ * Send the statistics of a metrics destination. Used as the send function of its stats scheduler entry.
  *
- * @param destination_info_ptr Pointer to the information applicable to the metrics destination managed by the thread.
+ * @param param_ptr Pointer to the MetricsDestinationInfo of the destination.
+ * @param timestamp_ms Timestamp of the stats in milliseconds since epoch.
  */
-static void StatsThreadDestroy(MetricsDestinationInfo* destination_info_ptr)
+static void SendDestinationStats(void* param_ptr, uint64_t timestamp_ms)
 {
-    if (destination_info_ptr->stats_thread_id) {
-        // Stats thread exist, so signal it to exit and then wait for it to actually exit.
-        if (destination_info_ptr->thread_exit_signal) {
-            CdiOsSignalSet(destination_info_ptr->thread_exit_signal);
-        }
-        CdiOsThreadJoin(destination_info_ptr->stats_thread_id, CDI_INFINITE, NULL);
-        destination_info_ptr->stats_thread_id = NULL;
-
-        if (destination_info_ptr->thread_exit_signal) {
-            CdiOsSignalClear(destination_info_ptr->thread_exit_signal); // Done with the signal so clear it.
-        }
-
-        CdiOsMemFree(destination_info_ptr->stats_thread_args_ptr);
-        destination_info_ptr->stats_thread_args_ptr = NULL;
-    }
+    MetricsDestinationInfo* dest_ptr = (MetricsDestinationInfo*)param_ptr;
+    (dest_ptr->send_stats_message_ptr)(dest_ptr->stats_state_ptr, dest_ptr->metrics_destination_idx, timestamp_ms);
 }
 
 /**
- * @brief Allocate statistics thread instance data and create the thread.
+ * Add a metrics destination to the SDK's stats scheduler.
  *
  * @param stats_state_ptr Pointer to statistics state data.
  * @param message_api_ptr Pointer to API to call with statistics messages.
  * @param dest_index Destination index.
+ * @param period_ms Period at which to send statistics to the destination.
  *
  * @return A value from the CdiReturnStatus enumeration.
  */
-static CdiReturnStatus CreateStatsThread(StatisticsState* stats_state_ptr, SendStatsMessage message_api_ptr,
-                                         MetricsDestinations dest_index)
+static CdiReturnStatus DestinationAdd(StatisticsState* stats_state_ptr, SendStatsMessage message_api_ptr,
+                                      MetricsDestinations dest_index, uint32_t period_ms)
 {
-    CdiReturnStatus rs = kCdiStatusOk;
-    MetricsDestinationInfo* dest_info_ptr = &stats_state_ptr->destination_info[dest_index];
-
-    // The args need to be allocated on the heap since the thread needs access to it after this block ends.
-    dest_info_ptr->stats_thread_args_ptr = CdiOsMemAlloc(sizeof(*dest_info_ptr->stats_thread_args_ptr));
-    if (NULL == dest_info_ptr->stats_thread_args_ptr) {
-        rs = kCdiStatusNotEnoughMemory;
-    } else {
-        dest_info_ptr->stats_thread_args_ptr->stats_state_ptr = stats_state_ptr;
-        dest_info_ptr->stats_thread_args_ptr->send_stats_message_ptr = message_api_ptr;
-        dest_info_ptr->stats_thread_args_ptr->metrics_destination_idx = dest_index;
-        if (!CdiOsThreadCreate(StatsThread, &dest_info_ptr->stats_thread_id, "StatsThread",
-                dest_info_ptr->stats_thread_args_ptr, stats_state_ptr->con_state_ptr->start_signal)) {
-            CdiOsMemFree(dest_info_ptr->stats_thread_args_ptr);
-            dest_info_ptr->stats_thread_args_ptr = NULL;
-            rs = kCdiStatusCreateThreadFailed;
-        }
-    }
-
-    return rs;
+    MetricsDestinationInfo* dest_ptr = &stats_state_ptr->destination_info[dest_index];
+    dest_ptr->stats_state_ptr = stats_state_ptr;
+    dest_ptr->send_stats_message_ptr = message_api_ptr;
+    dest_ptr->metrics_destination_idx = dest_index;
+
+    StatsSchedulerEntry* entry_ptr = &dest_ptr->scheduler_entry;
+    entry_ptr->send_func_ptr = SendDestinationStats;
+    entry_ptr->send_param_ptr = dest_ptr;
+    entry_ptr->log_handle = stats_state_ptr->con_state_ptr->log_handle;
+    entry_ptr->name_str = stats_state_ptr->con_state_ptr->saved_connection_name_str;
+
+    return StatsSchedulerAdd(cdi_global_context.stats_scheduler_handle, entry_ptr, period_ms);
 }
 
+/**
+ * Remove a metrics destination from the SDK's stats scheduler and then send its last set of stats, if any.
+ *
+ * @param dest_ptr Pointer to the information applicable to the metrics destination.
+ */
+static void DestinationRemove(MetricsDestinationInfo* dest_ptr)
+{
+    StatsSchedulerRemove(cdi_global_context.stats_scheduler_handle, &dest_ptr->scheduler_entry);
+}
 
 //*********************************************************************************************************************
 //******************************************* START OF PUBLIC FUNCTIONS ***********************************************
@@ -352,14 +475,11 @@ CdiReturnStatus StatsCreate(CdiConnectionState* con_state_ptr, CdiCoreStatsCallb
         stats_state_ptr->stats_period_ms = metrics_gathering_period_ms;
     }
 
-    // Create t-Digest instances and exit signals.
+    // Create t-Digest instances.
     for (int i = 0 ; kCdiStatusOk == rs && i < kMetricsDestinationsCount ; i++) {
         if (!TDigestCreate(&stats_state_ptr->destination_info[i].td_handle)) {
             rs = kCdiStatusAllocationFailed;
         }
-        if (!CdiOsSignalCreate(&stats_state_ptr->destination_info[i].thread_exit_signal)) {
-            rs = kCdiStatusAllocationFailed;
-        }
     }
 
     if (kCdiStatusOk == rs) {
@@ -390,14 +510,15 @@ CdiReturnStatus StatsCreate(CdiConnectionState* con_state_ptr, CdiCoreStatsCallb
     }
 
 #ifdef METRICS_GATHERING_SERVICE_ENABLED
-    // Create the statistics update thread that feeds the queue for the metrics gathering service.
+    // Schedule the statistics updates that feed the queue for the metrics gathering service.
     if (kCdiStatusOk == rs) {
-        rs = CreateStatsThread(stats_state_ptr, SendToCdiMetricsService, kMetricsDestinationGatheringService);
+        rs = DestinationAdd(stats_state_ptr, SendToCdiMetricsService, kMetricsDestinationGatheringService,
+                            metrics_gathering_period_ms);
     }
 #endif  // METRICS_GATHERING_SERVICE_ENABLED
 
-    // NOTE: The worker thread StatsThread() is created/destroyed dynamically by StatsConfigure(), depending if stats
-    // is enabled or disabled.
+    // NOTE: The user statistics destination is added to/removed from the stats scheduler dynamically by
+    // StatsConfigure(), depending if stats is enabled or disabled.
     if (kCdiStatusOk != rs) {
         StatsDestroy((StatisticsHandle)stats_state_ptr);
         stats_state_ptr = NULL;
@@ -414,9 +535,9 @@ CdiReturnStatus StatsDestroy(StatisticsHandle handle)
     StatisticsState* stats_state_ptr = (StatisticsState*)handle;
     if (stats_state_ptr) {
         for (int i = 0 ; i < kMetricsDestinationsCount ; i++) {
-            StatsThreadDestroy(&stats_state_ptr->destination_info[i]);
+            DestinationRemove(&stats_state_ptr->destination_info[i]);
         }
-        // Now that the thread has stopped, it is safe to clean up the remaining resources.
+        // Now that the stats scheduler is no longer using this object, it is safe to clean up the remaining resources.
 
         CloudWatchDestroy(stats_state_ptr->metrics_gatherer_handle);
         stats_state_ptr->metrics_gatherer_handle = NULL;
@@ -428,9 +549,6 @@ CdiReturnStatus StatsDestroy(StatisticsHandle handle)
         stats_state_ptr->stats_data_lock = NULL;
 
         for (int i = 0 ; i < kMetricsDestinationsCount ; i++) {
-            CdiOsSignalDelete(stats_state_ptr->destination_info[i].thread_exit_signal);
-            stats_state_ptr->destination_info[i].thread_exit_signal = NULL;
-
             TDigestDestroy(stats_state_ptr->destination_info[i].td_handle);
             stats_state_ptr->destination_info[i].td_handle = NULL;
         }
@@ -448,18 +566,19 @@ CdiReturnStatus StatsConfigure(StatisticsHandle handle, const CdiStatsConfigData
     CdiReturnStatus rs = kCdiStatusOk;
     StatisticsState* stats_state_ptr = (StatisticsState*)handle;
 
-    // The StatsThread() is created/destroyed here dynamically as needed in order to minimize thread resources. Other
-    // than during system startup, this function will typically not be used very often.
-    StatsThreadDestroy(&stats_state_ptr->destination_info[kMetricsDestinationCloudWatch]);
+    // The destination is added to/removed from the stats scheduler here dynamically as needed. Other than during
+    // system startup, this function will typically not be used very often.
+    DestinationRemove(&stats_state_ptr->destination_info[kMetricsDestinationCloudWatch]);
 
     // Set stats period, converting seconds to milliseconds.
     stats_state_ptr->stats_period_ms = stats_config_ptr->stats_period_seconds * 1000;
 
     // If stats period is non-zero and either the user-registered callback exists or CloudWatch exist and is not
-    // disabled, then create the stats thread.
+    // disabled, then add the destination to the stats scheduler.
     if (stats_state_ptr->stats_period_ms && (stats_state_ptr->user_cb_ptr ||
         (stats_state_ptr->cloudwatch_handle && !stats_config_ptr->disable_cloudwatch_stats))) {
-        rs = CreateStatsThread(stats_state_ptr, SendUserStatsMessage, kMetricsDestinationCloudWatch);
+        rs = DestinationAdd(stats_state_ptr, SendUserStatsMessage, kMetricsDestinationCloudWatch,
+                            stats_state_ptr->stats_period_ms);
     }
 
     if (kCdiStatusOk == rs && stats_state_ptr->cloudwatch_handle) {
@@ -498,7 +617,7 @@ void StatsGatherPayloadStatsFromConnection(CdiEndpointState* endpoint_ptr, bool
     }
 
     // Update stats. NOTE: Need to synchronize with reads/writes of data used here since it is also used by
-    // StatsThread().
+    // StatsSchedulerThread().
     CdiOsCritSectionReserve(stats_state_ptr->stats_data_lock);
 
     // Add sample to the t-Digests.
@@ -508,6 +627,9 @@ void StatsGatherPayloadStatsFromConnection(CdiEndpointState* endpoint_ptr, bool
 
     // Keep running sum of all payload times this interval.
     interval_stats_ptr->transfer_time_sum += elapsed_time;
+    interval_stats_ptr->endpoint_transfer_count++;
+    interval_stats_ptr->endpoint_transfer_time_max =
+        (uint32_t)CDI_MIN(CDI_MAX(elapsed_time, interval_stats_ptr->endpoint_transfer_time_max), UINT32_MAX);
 
     if (payload_late) {
         counter_stats_ptr->num_payloads_late++;
@@ -525,3 +647,138 @@ void StatsGatherPayloadStatsFromConnection(CdiEndpointState* endpoint_ptr, bool
     // Done with stats data, so release the lock.
     CdiOsCritSectionRelease(stats_state_ptr->stats_data_lock);
 }
+
+void StatsGatherRxReorderWindowStats(CdiEndpointState* endpoint_ptr, int buffered_packet_count)
+{
+    StatisticsState* stats_state_ptr = endpoint_ptr->connection_state_ptr->stats_state_ptr;
+    if (NULL == stats_state_ptr) {
+        return;
+    }
+
+    CdiPayloadTimeIntervalStats* interval_stats_ptr = &endpoint_ptr->transfer_stats.payload_time_interval_stats;
+
+    CdiOsCritSectionReserve(stats_state_ptr->stats_data_lock);
+    interval_stats_ptr->rx_reorder_window_packets_max =
+        CDI_MAX(interval_stats_ptr->rx_reorder_window_packets_max, buffered_packet_count);
+    CdiOsCritSectionRelease(stats_state_ptr->stats_data_lock);
+}
+
+CdiReturnStatus StatsSchedulerCreate(StatsSchedulerHandle* ret_handle_ptr)
+{
+    // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
+    CdiReturnStatus rs = kCdiStatusOk;
+
+    StatsSchedulerState* scheduler_ptr = CdiOsMemAllocZero(sizeof(StatsSchedulerState));
+    if (NULL == scheduler_ptr) {
+        rs = kCdiStatusNotEnoughMemory;
+    }
+
+    if (kCdiStatusOk == rs) {
+        CdiListInit(&scheduler_ptr->destination_list);
+        CdiListInit(&scheduler_ptr->due_list);
+        if (!CdiOsCritSectionCreate(&scheduler_ptr->lock)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        if (!CdiOsSignalCreate(&scheduler_ptr->shutdown_signal) || !CdiOsSignalCreate(&scheduler_ptr->wake_signal) ||
+            !CdiOsSignalCreate(&scheduler_ptr->send_done_signal)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        scheduler_ptr->thread_data_allocated = CdiOsThreadAllocData(&scheduler_ptr->thread_data);
+        if (!scheduler_ptr->thread_data_allocated) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        if (!CdiOsThreadCreate(StatsSchedulerThread, &scheduler_ptr->thread_id, "StatsScheduler", scheduler_ptr,
+                               NULL)) { // NULL= Start thread immediately.
+            rs = kCdiStatusCreateThreadFailed;
+        }
+    }
+
+    if (kCdiStatusOk != rs) {
+        StatsSchedulerDestroy(scheduler_ptr);
+        scheduler_ptr = NULL;
+    }
+
+    *ret_handle_ptr = scheduler_ptr;
+
+    return rs;
+}
+
+void StatsSchedulerDestroy(StatsSchedulerHandle handle)
+{
+    StatsSchedulerState* scheduler_ptr = (StatsSchedulerState*)handle;
+    if (scheduler_ptr) {
+        if (!CdiListIsEmpty(&scheduler_ptr->destination_list)) {
+            SDK_LOG_GLOBAL(kLogError, "Stats scheduler is being destroyed while statistics are still scheduled.");
+        }
+
+        SdkThreadJoin(scheduler_ptr->thread_id, scheduler_ptr->shutdown_signal);
+        scheduler_ptr->thread_id = NULL;
+
+        if (scheduler_ptr->thread_data_allocated) {
+            CdiOsThreadFreeData(scheduler_ptr->thread_data);
+        }
+        CdiOsSignalDelete(scheduler_ptr->send_done_signal);
+        CdiOsSignalDelete(scheduler_ptr->wake_signal);
+        CdiOsSignalDelete(scheduler_ptr->shutdown_signal);
+        CdiOsCritSectionDelete(scheduler_ptr->lock);
+        CdiOsMemFree(scheduler_ptr);
+    }
+}
+
+CdiReturnStatus StatsSchedulerAdd(StatsSchedulerHandle handle, StatsSchedulerEntry* entry_ptr, uint32_t period_ms)
+{
+    StatsSchedulerState* scheduler_ptr = handle;
+    if (NULL == scheduler_ptr) {
+        return kCdiStatusNotInitialized;
+    }
+
+    entry_ptr->period_ms = period_ms;
+    entry_ptr->next_due_ms = NextPeriodBoundary(UtcTimeMilliseconds(), period_ms);
+    entry_ptr->due = false;
+
+    CdiOsCritSectionReserve(scheduler_ptr->lock);
+    CdiListAddTail(&scheduler_ptr->destination_list, &entry_ptr->list_entry);
+    entry_ptr->scheduled = true;
+    CdiOsCritSectionRelease(scheduler_ptr->lock);
+
+    // Wake up the scheduler so it includes the new entry when computing its wait time.
+    CdiOsSignalSet(scheduler_ptr->wake_signal);
+
+    return kCdiStatusOk;
+}
+
+void StatsSchedulerRemove(StatsSchedulerHandle handle, StatsSchedulerEntry* entry_ptr)
+{
+    StatsSchedulerState* scheduler_ptr = handle;
+    if (NULL == scheduler_ptr || !entry_ptr->scheduled) {
+        return;
+    }
+
+    CdiOsCritSectionReserve(scheduler_ptr->lock);
+    CdiListRemove(entry_ptr->due ? &scheduler_ptr->due_list : &scheduler_ptr->destination_list,
+                  &entry_ptr->list_entry);
+    entry_ptr->scheduled = false;
+    entry_ptr->due = false;
+
+    // If the scheduler thread is sending this entry's stats, wait for it to finish unless this was called from within
+    // that send function. Once it is done, the scheduler thread no longer references this entry.
+    void* thread_data_ptr = NULL;
+    CdiOsThreadGetData(scheduler_ptr->thread_data, &thread_data_ptr);
+    while (scheduler_ptr->sending_dest_ptr == entry_ptr && thread_data_ptr != scheduler_ptr) {
+        CdiOsCritSectionRelease(scheduler_ptr->lock);
+        CdiOsSignalWait(scheduler_ptr->send_done_signal, CDI_INFINITE, NULL);
+        CdiOsCritSectionReserve(scheduler_ptr->lock);
+    }
+    CdiOsCritSectionRelease(scheduler_ptr->lock);
+
+    (entry_ptr->send_func_ptr)(entry_ptr->send_param_ptr, UtcTimeMilliseconds());
+}
@@ -29,10 +29,76 @@
  */
 typedef struct StatisticsState* StatisticsHandle;
 
+/**
+ * Prototype of function used by the stats scheduler to send the statistics of one of its entries.
+ *
+ * @param param_ptr Value of the entry's send_param_ptr.
+ * @param timestamp_ms Timestamp of the statistics in milliseconds since epoch. It is the period boundary at which they
+ *                     were due, or the current time for the final send when the entry is removed.
+ */
+typedef void (*StatsSchedulerSendFunc)(void* param_ptr, uint64_t timestamp_ms);
+
+/**
+ * @brief An entry of the stats scheduler. The owner sets send_func_ptr, send_param_ptr, log_handle and name_str before
+ * adding it with StatsSchedulerAdd(). The remaining members are private to the stats scheduler.
+ */
+typedef struct {
+    StatsSchedulerSendFunc send_func_ptr; ///< Function to call when statistics are due.
+    void* send_param_ptr;             ///< Parameter passed to send_func_ptr.
+    CdiLogHandle log_handle;          ///< Log used while sending statistics and to report late statistics.
+    const char* name_str;             ///< Name used to report late statistics.
+
+    CdiListEntry list_entry;          ///< Used to store this entry in one of the stats scheduler's lists.
+    uint32_t period_ms;               ///< Period at which statistics are sent.
+    uint64_t next_due_ms;             ///< UTC time in milliseconds when statistics are next due.
+    uint64_t due_timestamp_ms;        ///< Timestamp to use for the statistics while this entry is in due_list.
+    bool scheduled;                   ///< True if this entry is in one of the stats scheduler's lists.
+    bool due;                         ///< True if in the stats scheduler's due_list rather than its destination_list.
+} StatsSchedulerEntry;
+
 //*********************************************************************************************************************
 //******************************************* START OF PUBLIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
 
+/**
+ * Create the stats scheduler. A single scheduler thread gathers and sends the statistics of all connections, so the
+ * statistics of connections that use the same period are aligned in time.
+ *
+ * @param ret_handle_ptr Address where to write returned stats scheduler handle.
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CdiReturnStatus StatsSchedulerCreate(StatsSchedulerHandle* ret_handle_ptr);
+
+/**
+ * Destroy the stats scheduler. All statistics instances must have been destroyed first.
+ *
+ * @param handle Handle of the stats scheduler.
+ */
+void StatsSchedulerDestroy(StatsSchedulerHandle handle);
+
+/**
+ * Add an entry to the stats scheduler. Its statistics are first sent at the next multiple of period_ms since epoch and
+ * then every period_ms.
+ *
+ * @param handle Handle of the stats scheduler.
+ * @param entry_ptr Pointer to the entry, which must remain valid until StatsSchedulerRemove() is called.
+ * @param period_ms Period at which to send the entry's statistics.
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CdiReturnStatus StatsSchedulerAdd(StatsSchedulerHandle handle, StatsSchedulerEntry* entry_ptr, uint32_t period_ms);
+
+/**
+ * Remove an entry from the stats scheduler and then send its last set of statistics. Once this returns, the scheduler
+ * thread no longer references the entry. May be called from within the entry's send function. Does nothing if the
+ * entry is not scheduled.
+ *
+ * @param handle Handle of the stats scheduler.
+ * @param entry_ptr Pointer to the entry.
+ */
+void StatsSchedulerRemove(StatsSchedulerHandle handle, StatsSchedulerEntry* entry_ptr);
+
 /**
  * Create an instance of the statistics component for the specified connection.
  *
@@ -81,4 +147,12 @@ CdiReturnStatus StatsConfigure(StatisticsHandle handle, const CdiStatsConfigData
 void StatsGatherPayloadStatsFromConnection(CdiEndpointState* endpoint_ptr, bool payload_ok, uint64_t start_time,
                                            uint64_t max_latency_microsecs, uint64_t bytes_transferred);
 
+/**
+ * Gather the occupancy of the packet reorder window of an Rx endpoint.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param buffered_packet_count Highest number of packets buffered by the endpoint since the previous call.
+ */
+void StatsGatherRxReorderWindowStats(CdiEndpointState* endpoint_ptr, int buffered_packet_count);
+
 #endif  // CDI_STATISTICS_H__
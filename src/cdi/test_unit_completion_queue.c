@@ -0,0 +1,196 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the completion queue functionality.
+ */
+
+#include "completion_queue.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Depth of the completion queue used by the test.
+#define TEST_QUEUE_DEPTH        (4)
+
+/// Time in milliseconds given to the waiting writer to push its event, if it were not blocked.
+#define TEST_WAIT_MS            (50)
+
+/// Value of the payload user data of the event pushed by the waiting writer.
+#define TEST_WAIT_USER_DATA     (0x1234)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return kCdiStatusFatal; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the writer thread that waits for room in the completion queue.
+ */
+typedef struct {
+    CdiCompletionQueueHandle handle;        ///< The completion queue.
+    CdiSignalType abort_signal;             ///< Signal used to abort the wait.
+    uint32_t done;                          ///< Set to 1 once the push returned. Only accessed atomically.
+    bool pushed;                            ///< Value returned by CompletionQueuePushWait().
+} TestWriterState;
+
+/**
+ * Thread that pushes a Tx event, waiting for room in the queue.
+ *
+ * @param ptr Pointer to TestWriterState.
+ *
+ * @return The return value is not used.
+ */
+static CDI_THREAD TestWriterThread(void* ptr)
+{
+    TestWriterState* writer_ptr = (TestWriterState*)ptr;
+    CdiRawTxCbData raw_tx_cb_data = {
+        .core_cb_data.status_code = kCdiStatusOk,
+        .core_cb_data.core_extra_data.payload_user_data = TEST_WAIT_USER_DATA,
+    };
+    writer_ptr->pushed = CompletionQueuePushWait(writer_ptr->handle, kCdiCompletionEventRawTx, &raw_tx_cb_data,
+                                                 writer_ptr->abort_signal);
+    CdiOsAtomicStore32(&writer_ptr->done, 1);
+
+    return 0; // Return code not used.
+}
+
+/**
+ * Test that a writer waits while the queue is full and pushes its event once the application polls, and that the wait
+ * can be aborted.
+ *
+ * @param writer_ptr Pointer to the writer state, with the queue handle and abort signal set.
+ *
+ * @return kCdiStatusOk if the test passed, otherwise kCdiStatusFatal.
+ */
+static CdiReturnStatus TestPushWait(TestWriterState* writer_ptr)
+{
+    CdiCompletionEvent event_array[TEST_QUEUE_DEPTH];
+    CdiRawTxCbData raw_tx_cb_data = {
+        .core_cb_data.status_code = kCdiStatusOk,
+    };
+    for (int i = 0; i < TEST_QUEUE_DEPTH; i++) {
+        CHECK(CompletionQueuePushWait(writer_ptr->handle, kCdiCompletionEventRawTx, &raw_tx_cb_data,
+                                      writer_ptr->abort_signal));
+    }
+
+    CdiThreadID thread_id = NULL;
+    CHECK(CdiOsThreadCreate(TestWriterThread, &thread_id, "CompQueueTest", writer_ptr, NULL));
+    CdiOsSleep(TEST_WAIT_MS);
+    const bool blocked = (0 == CdiOsAtomicLoad32(&writer_ptr->done));
+
+    // Polling makes room for the waiting event, which must then be the last one in the queue.
+    const int first_count = CdiCompletionQueuePoll(writer_ptr->handle, event_array, 1);
+    bool timed_out = false;
+    CdiOsThreadJoin(thread_id, 1000, &timed_out);
+    if (timed_out) {
+        CdiOsSignalSet(writer_ptr->abort_signal);
+        CdiOsThreadJoin(thread_id, CDI_INFINITE, NULL);
+    }
+    CHECK(blocked);
+    CHECK(1 == first_count);
+    CHECK(!timed_out);
+    CHECK(writer_ptr->pushed);
+    CHECK(TEST_QUEUE_DEPTH == CdiCompletionQueuePoll(writer_ptr->handle, event_array, TEST_QUEUE_DEPTH));
+    for (int i = 0; i < TEST_QUEUE_DEPTH; i++) {
+        CHECK(kCdiCompletionEventRawTx == event_array[i].event_type);
+        CHECK((TEST_QUEUE_DEPTH - 1 == i ? TEST_WAIT_USER_DATA : 0) ==
+              event_array[i].cb_data.raw_tx.core_cb_data.core_extra_data.payload_user_data);
+    }
+
+    // Once the abort signal is set, a writer no longer waits for room in a full queue.
+    for (int i = 0; i < TEST_QUEUE_DEPTH; i++) {
+        CHECK(CompletionQueuePush(writer_ptr->handle, kCdiCompletionEventRawTx, &raw_tx_cb_data));
+    }
+    CdiOsSignalSet(writer_ptr->abort_signal);
+    CHECK(!CompletionQueuePushWait(writer_ptr->handle, kCdiCompletionEventRawTx, &raw_tx_cb_data,
+                                   writer_ptr->abort_signal));
+    CHECK(TEST_QUEUE_DEPTH == CdiCompletionQueuePoll(writer_ptr->handle, event_array, TEST_QUEUE_DEPTH));
+
+    return kCdiStatusOk;
+}
+
+CdiReturnStatus TestUnitCompletionQueue(void)
+{
+    CdiCompletionQueueHandle handle = NULL;
+    CHECK(kCdiStatusInvalidParameter == CdiCompletionQueueCreate(-1, &handle));
+    CHECK(kCdiStatusOk == CdiCompletionQueueCreate(TEST_QUEUE_DEPTH, &handle));
+
+    CdiCompletionEvent event_array[TEST_QUEUE_DEPTH + 1];
+    CHECK(0 == CdiCompletionQueuePoll(handle, event_array, TEST_QUEUE_DEPTH));
+
+    // The error string and AVM configuration must be copied, so use data that goes out of scope before polling.
+    {
+        char err_msg_array[] = "Test error";
+        CdiAvmConfig avm_config = { .uri = "https://test", .data_size = 0 };
+        CdiAvmRxCbData avm_rx_cb_data = {
+            .core_cb_data.status_code = kCdiStatusRxPayloadError,
+            .core_cb_data.err_msg_str = err_msg_array,
+            .avm_extra_data.stream_identifier = 7,
+            .config_ptr = &avm_config,
+        };
+        CHECK(CompletionQueuePush(handle, kCdiCompletionEventAvmRx, &avm_rx_cb_data));
+        memset(err_msg_array, 0, sizeof(err_msg_array));
+        memset(&avm_config, 0, sizeof(avm_config));
+    }
+    CdiRawTxCbData raw_tx_cb_data = {
+        .core_cb_data.status_code = kCdiStatusOk,
+        .core_cb_data.err_msg_str = NULL,
+    };
+    for (int i = 1; i < TEST_QUEUE_DEPTH; i++) {
+        CHECK(CompletionQueuePush(handle, kCdiCompletionEventRawTx, &raw_tx_cb_data));
+    }
+    // The queue is fixed size, so pushing to a full queue must fail.
+    CHECK(!CompletionQueuePush(handle, kCdiCompletionEventRawTx, &raw_tx_cb_data));
+
+    // Poll in two batches to check that events are returned in order.
+    CHECK(1 == CdiCompletionQueuePoll(handle, event_array, 1));
+    CHECK(kCdiCompletionEventAvmRx == event_array[0].event_type);
+    CHECK(7 == event_array[0].cb_data.avm_rx.avm_extra_data.stream_identifier);
+    CHECK(event_array[0].cb_data.avm_rx.core_cb_data.err_msg_str == event_array[0].err_msg_array);
+    CHECK(0 == strcmp("Test error", event_array[0].cb_data.avm_rx.core_cb_data.err_msg_str));
+    CHECK(event_array[0].cb_data.avm_rx.config_ptr == &event_array[0].avm_config);
+    CHECK(0 == strcmp("https://test", event_array[0].cb_data.avm_rx.config_ptr->uri));
+
+    CHECK(TEST_QUEUE_DEPTH - 1 == CdiCompletionQueuePoll(handle, event_array, TEST_QUEUE_DEPTH + 1));
+    for (int i = 0; i < TEST_QUEUE_DEPTH - 1; i++) {
+        CHECK(kCdiCompletionEventRawTx == event_array[i].event_type);
+        CHECK(NULL == event_array[i].cb_data.raw_tx.core_cb_data.err_msg_str);
+    }
+    CHECK(0 == CdiCompletionQueuePoll(handle, event_array, TEST_QUEUE_DEPTH));
+
+    TestWriterState writer = {
+        .handle = handle,
+    };
+    CHECK(CdiOsSignalCreate(&writer.abort_signal));
+    CdiReturnStatus rs = TestPushWait(&writer);
+    CdiOsSignalDelete(writer.abort_signal);
+    CHECK(kCdiStatusOk == rs);
+
+    // Events left in the queue are discarded when it is destroyed.
+    CHECK(CompletionQueuePush(handle, kCdiCompletionEventRawTx, &raw_tx_cb_data));
+    CHECK(kCdiStatusOk == CdiCompletionQueueDestroy(handle));
+
+    return kCdiStatusOk;
+}
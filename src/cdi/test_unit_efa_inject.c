@@ -0,0 +1,187 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the completion of the small packets that EFA Tx endpoints send with fi_inject().
+ */
+
+#include "adapter_efa.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "adapter_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "rdma/fi_eq.h"
+#include "rdma/fi_errno.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of injected packets used by the test.
+#define TEST_PACKET_COUNT   (5)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the test, passed to the endpoint's message functions.
+ */
+typedef struct {
+    struct fid_cq cq;                           ///< Empty completion queue of the endpoint. Must be first.
+    struct fi_ops_cq cq_ops;                    ///< Functions of cq.
+    AdapterEndpointState adapter_endpoint;      ///< Adapter endpoint of the EFA endpoint.
+    EfaEndpointState endpoint;                  ///< The EFA endpoint.
+    Packet packet_array[TEST_PACKET_COUNT];     ///< Packets that are injected.
+    Packet* completed_array[TEST_PACKET_COUNT]; ///< Packets in the order that they were completed.
+    int completed_count;                        ///< Number of packets in completed_array.
+    int single_call_count;                      ///< Number of calls to the message function for one packet.
+    int list_call_count;                        ///< Number of calls to the message function for a list of packets.
+} TestInjectState;
+
+/**
+ * Read completions from the test's completion queue, which never has any.
+ *
+ * @param cq_ptr Pointer to the completion queue.
+ * @param buf Not used.
+ * @param count Not used.
+ *
+ * @return Always -FI_EAGAIN.
+ */
+static ssize_t TestCqRead(struct fid_cq* cq_ptr, void* buf, size_t count)
+{
+    (void)cq_ptr;
+    (void)buf;
+    (void)count;
+    return -FI_EAGAIN;
+}
+
+/**
+ * Message function of the endpoint for one packet. Records the packet.
+ *
+ * @param param_ptr Pointer to test state.
+ * @param packet_ptr Pointer to the packet.
+ * @param message_type Endpoint message type.
+ */
+static void TestMessageFromEndpoint(void* param_ptr, Packet* packet_ptr, EndpointMessageType message_type)
+{
+    TestInjectState* test_ptr = (TestInjectState*)param_ptr;
+    (void)message_type;
+    test_ptr->single_call_count++;
+    CdiAdapterTxPacketComplete(&test_ptr->adapter_endpoint, packet_ptr);
+    test_ptr->completed_array[test_ptr->completed_count++] = packet_ptr;
+}
+
+/**
+ * Message function of the endpoint for a list of packets. Records the packets.
+ *
+ * @param param_ptr Pointer to test state.
+ * @param packet_list_ptr Pointer to the list of packets.
+ * @param message_type Endpoint message type.
+ */
+static void TestMessagesFromEndpoint(void* param_ptr, CdiSinglyLinkedList* packet_list_ptr,
+                                     EndpointMessageType message_type)
+{
+    TestInjectState* test_ptr = (TestInjectState*)param_ptr;
+    (void)message_type;
+    test_ptr->list_call_count++;
+    CdiAdapterTxPacketsComplete(&test_ptr->adapter_endpoint, packet_list_ptr);
+    CdiSinglyLinkedListEntry* entry_ptr = NULL;
+    while (NULL != (entry_ptr = CdiSinglyLinkedListPopHead(packet_list_ptr))) {
+        test_ptr->completed_array[test_ptr->completed_count++] = CONTAINER_OF(entry_ptr, Packet, list_entry);
+    }
+}
+
+/**
+ * Add the test's packets to the endpoint's list of injected packets, as InjectSend() does. The last one ends a
+ * payload.
+ *
+ * @param test_ptr Pointer to test state.
+ */
+static void TestPacketsInject(TestInjectState* test_ptr)
+{
+    EfaTxState* tx_state_ptr = &test_ptr->endpoint.tx_state;
+    for (int i = 0; i < TEST_PACKET_COUNT; i++) {
+        Packet* packet_ptr = &test_ptr->packet_array[i];
+        packet_ptr->payload_last_packet = (TEST_PACKET_COUNT - 1 == i);
+        packet_ptr->tx_state.ack_status = kAdapterPacketStatusFailed;
+        CdiSinglyLinkedListPushTail(&tx_state_ptr->injected_packet_list, &packet_ptr->list_entry);
+        tx_state_ptr->tx_packets_in_process++;
+    }
+    // Each packet holds one in-flight reference, and the payload one more.
+    CdiOsAtomicStore32(&test_ptr->adapter_endpoint.tx_in_flight_ref_count, TEST_PACKET_COUNT + 1);
+    test_ptr->completed_count = 0;
+    test_ptr->single_call_count = 0;
+    test_ptr->list_call_count = 0;
+}
+
+/**
+ * Test that the next poll completes all injected packets, in the order they were sent and with a single call to the
+ * message function for lists of packets if the endpoint has one.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param use_list True to test with a message function for lists of packets.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestInjectedComplete(TestInjectState* test_ptr, bool use_list)
+{
+    EfaEndpointState* endpoint_ptr = &test_ptr->endpoint;
+    test_ptr->adapter_endpoint.msgs_from_endpoint_func_ptr = use_list ? TestMessagesFromEndpoint : NULL;
+
+    TestPacketsInject(test_ptr);
+    CHECK(kCdiStatusOk == EfaTxEndpointPoll(endpoint_ptr));
+    CHECK(TEST_PACKET_COUNT == test_ptr->completed_count);
+    CHECK((use_list ? 1 : 0) == test_ptr->list_call_count);
+    CHECK((use_list ? 0 : TEST_PACKET_COUNT) == test_ptr->single_call_count);
+    for (int i = 0; i < TEST_PACKET_COUNT; i++) {
+        CHECK(&test_ptr->packet_array[i] == test_ptr->completed_array[i]);
+        CHECK(kAdapterPacketStatusOk == test_ptr->packet_array[i].tx_state.ack_status);
+    }
+    CHECK(0 == endpoint_ptr->tx_state.tx_packets_in_process);
+    CHECK(CdiSinglyLinkedListIsEmpty(&endpoint_ptr->tx_state.injected_packet_list));
+    CHECK(0 == CdiOsAtomicLoad32(&test_ptr->adapter_endpoint.tx_in_flight_ref_count));
+
+    // Packets are only completed once.
+    CHECK(kCdiStatusInternalIdle == EfaTxEndpointPoll(endpoint_ptr));
+    CHECK(TEST_PACKET_COUNT == test_ptr->completed_count);
+
+    return true;
+}
+
+CdiReturnStatus TestUnitEfaInject(void)
+{
+    TestInjectState* test_ptr = CdiOsMemAllocZero(sizeof(TestInjectState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    test_ptr->cq_ops.size = sizeof(test_ptr->cq_ops);
+    test_ptr->cq_ops.read = TestCqRead;
+    test_ptr->cq.ops = &test_ptr->cq_ops;
+    test_ptr->adapter_endpoint.msg_from_endpoint_func_ptr = TestMessageFromEndpoint;
+    test_ptr->adapter_endpoint.msg_from_endpoint_param_ptr = test_ptr;
+    test_ptr->endpoint.adapter_endpoint_ptr = &test_ptr->adapter_endpoint;
+    test_ptr->endpoint.completion_queue_ptr = &test_ptr->cq;
+
+    bool pass = TestInjectedComplete(test_ptr, true) && TestInjectedComplete(test_ptr, false);
+
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
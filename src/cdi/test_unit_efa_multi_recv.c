@@ -0,0 +1,155 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the FI_MULTI_RECV receive buffers of EFA Rx endpoints and for the optional
+ * libfabric capabilities that endpoints fall back from.
+ */
+
+#include "adapter_efa.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of FI_MULTI_RECV buffers used by the test.
+#define TEST_BUFFER_COUNT   (3)
+
+/// Size in bytes of each FI_MULTI_RECV buffer used by the test.
+#define TEST_BUFFER_SIZE    (1000)
+
+/// Capabilities needed for RMA direct placement by a receiver.
+#define TEST_RMA_CAPS       (FI_RMA | FI_REMOTE_WRITE)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/// Memory of the FI_MULTI_RECV buffers used by the test, with room for one more buffer before and after them.
+static uint8_t test_memory_array[TEST_BUFFER_SIZE * (TEST_BUFFER_COUNT + 2)];
+
+/**
+ * Get the optional capabilities that an endpoint ends up with, as LibFabricEndpointOpen() does with a provider that
+ * only accepts the given optional capabilities.
+ *
+ * @param provider_caps Optional capabilities that the provider supports.
+ * @param rma_caps Capabilities needed for RMA direct placement. Zero if not needed.
+ * @param multi_recv_caps Capabilities needed for FI_MULTI_RECV buffers. Zero if not needed.
+ *
+ * @return The optional capabilities of the endpoint.
+ */
+static uint64_t TestProviderCaps(uint64_t provider_caps, uint64_t rma_caps, uint64_t multi_recv_caps)
+{
+    uint64_t caps_array[EFA_OPTIONAL_CAPS_SET_COUNT];
+    const int count = EfaAdapterOptionalCapsGet(rma_caps, multi_recv_caps, caps_array);
+    for (int i = 0; i < count; i++) {
+        if (caps_array[i] == (caps_array[i] & provider_caps)) {
+            return caps_array[i];
+        }
+    }
+    return UINT64_MAX; // Not reached, since the last set is always empty.
+}
+
+/**
+ * Test the order in which optional capabilities are dropped when the provider does not support them.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestOptionalCaps(void)
+{
+    uint64_t caps_array[EFA_OPTIONAL_CAPS_SET_COUNT];
+
+    // Each capability is dropped on its own before both are.
+    CHECK(4 == EfaAdapterOptionalCapsGet(TEST_RMA_CAPS, FI_MULTI_RECV, caps_array));
+    CHECK((TEST_RMA_CAPS | FI_MULTI_RECV) == caps_array[0]);
+    CHECK(TEST_RMA_CAPS == caps_array[1]);
+    CHECK(FI_MULTI_RECV == caps_array[2]);
+    CHECK(0 == caps_array[3]);
+
+    // Sets are not repeated when only one of the capabilities is needed.
+    CHECK(2 == EfaAdapterOptionalCapsGet(0, FI_MULTI_RECV, caps_array));
+    CHECK(FI_MULTI_RECV == caps_array[0] && 0 == caps_array[1]);
+    CHECK(2 == EfaAdapterOptionalCapsGet(TEST_RMA_CAPS, 0, caps_array));
+    CHECK(TEST_RMA_CAPS == caps_array[0] && 0 == caps_array[1]);
+    CHECK(1 == EfaAdapterOptionalCapsGet(0, 0, caps_array));
+    CHECK(0 == caps_array[0]);
+
+    // A provider that lacks one of the capabilities keeps the other one.
+    CHECK(FI_MULTI_RECV == TestProviderCaps(FI_MULTI_RECV, TEST_RMA_CAPS, FI_MULTI_RECV));
+    CHECK(TEST_RMA_CAPS == TestProviderCaps(TEST_RMA_CAPS, TEST_RMA_CAPS, FI_MULTI_RECV));
+    CHECK((TEST_RMA_CAPS | FI_MULTI_RECV) ==
+          TestProviderCaps(TEST_RMA_CAPS | FI_MULTI_RECV, TEST_RMA_CAPS, FI_MULTI_RECV));
+    CHECK(0 == TestProviderCaps(FI_RMA, TEST_RMA_CAPS, FI_MULTI_RECV));
+
+    return true;
+}
+
+/**
+ * Test that packets are found in the FI_MULTI_RECV buffer they were received into, and that the state of a buffer
+ * does not overlap the part of its context that libfabric may write to in FI_CONTEXT mode.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestBufferFind(EfaEndpointState* endpoint_ptr)
+{
+    CHECK(offsetof(EfaRxMultiRecvBuffer, buffer_ptr) >= sizeof(struct fi_context));
+
+    EfaRxState* rx_state_ptr = &endpoint_ptr->rx_state;
+    uint8_t* memory_ptr = test_memory_array + TEST_BUFFER_SIZE;
+    CHECK(NULL == EfaRxMultiRecvBufferFind(endpoint_ptr, memory_ptr));
+
+    rx_state_ptr->multi_recv_buffer_size = TEST_BUFFER_SIZE;
+    rx_state_ptr->multi_recv_buffer_count = TEST_BUFFER_COUNT;
+    for (int i = 0; i < TEST_BUFFER_COUNT; i++) {
+        rx_state_ptr->multi_recv_buffer_array[i].buffer_ptr = memory_ptr + i * TEST_BUFFER_SIZE;
+    }
+    EfaRxMultiRecvBuffer* buffer_array = rx_state_ptr->multi_recv_buffer_array;
+
+    CHECK(&buffer_array[0] == EfaRxMultiRecvBufferFind(endpoint_ptr, memory_ptr));
+    CHECK(&buffer_array[0] == EfaRxMultiRecvBufferFind(endpoint_ptr, memory_ptr + TEST_BUFFER_SIZE - 1));
+    CHECK(&buffer_array[1] == EfaRxMultiRecvBufferFind(endpoint_ptr, memory_ptr + TEST_BUFFER_SIZE));
+    CHECK(&buffer_array[2] ==
+          EfaRxMultiRecvBufferFind(endpoint_ptr, memory_ptr + TEST_BUFFER_COUNT * TEST_BUFFER_SIZE - 1));
+
+    // Addresses outside of the buffers, such as the ones of receive buffer slots, are not found.
+    CHECK(NULL == EfaRxMultiRecvBufferFind(endpoint_ptr, memory_ptr + TEST_BUFFER_COUNT * TEST_BUFFER_SIZE));
+    CHECK(NULL == EfaRxMultiRecvBufferFind(endpoint_ptr, memory_ptr - 1));
+
+    return true;
+}
+
+CdiReturnStatus TestUnitEfaMultiRecv(void)
+{
+    EfaEndpointState* endpoint_ptr = CdiOsMemAllocZero(sizeof(EfaEndpointState));
+    if (NULL == endpoint_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+
+    bool pass = TestOptionalCaps() && TestBufferFind(endpoint_ptr);
+
+    CdiOsMemFree(endpoint_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
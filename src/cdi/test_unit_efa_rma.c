@@ -0,0 +1,158 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the receive buffer slots that EFA Tx endpoints write payloads into when the
+ * receiver uses RMA direct placement.
+ */
+
+#include "adapter_efa.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "protocol.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of slots advertised by the receiver in the test.
+#define TEST_SLOT_COUNT     (2)
+
+/// Size in bytes of each slot advertised by the receiver in the test.
+#define TEST_SLOT_SIZE      (10000)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * Get the slot for a packet of a payload, as RmaSend() does for packets whose header is in its own SGL entry.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param packet_ptr Pointer to the packet.
+ * @param payload_num Payload number of the packet.
+ * @param sequence_num Packet sequence number of the packet.
+ * @param payload_size Size of the payload in bytes. Only used by packet #0.
+ *
+ * @return Index of the slot. -1 if the packet must be sent.
+ */
+static int TestSlotGet(EfaEndpointState* endpoint_ptr, const Packet* packet_ptr, int payload_num, int sequence_num,
+                       int payload_size)
+{
+    CdiDecodedPacketHeader header = {
+        .payload_type = (0 == sequence_num) ? kPayloadTypeData : kPayloadTypeDataOffset,
+        .packet_sequence_num = sequence_num,
+        .payload_num = payload_num
+    };
+    if (0 == sequence_num) {
+        header.num0_info.total_payload_size = payload_size;
+    }
+    return EfaTxRmaSlotGet(endpoint_ptr, packet_ptr, &header, true);
+}
+
+/**
+ * Advertise the slots of the receiver to the endpoint. Only slot 0 is ever freed by the receiver in the test.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ * @param release_count Number of times the receiver has freed slot 0.
+ */
+static void TestSlotsAdvertise(EfaEndpointState* endpoint_ptr, uint8_t release_count)
+{
+    CdiDecodedProbeRmaSlots rma_slots = {
+        .base_address = 0x100000,
+        .key = 1,
+        .slot_size = TEST_SLOT_SIZE,
+        .slot_count = TEST_SLOT_COUNT
+    };
+    rma_slots.release_count_array[0] = release_count;
+    EfaTxRmaSlotsUpdate(endpoint_ptr, &rma_slots);
+}
+
+/**
+ * Test that packets of payloads that are interleaved get the slot of their own payload, and that packets of payloads
+ * that don't use a slot are sent.
+ *
+ * @param endpoint_ptr Pointer to endpoint state data.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestInterleavedPayloads(EfaEndpointState* endpoint_ptr)
+{
+    EfaTxRmaState* rma_ptr = &endpoint_ptr->tx_state.rma_state;
+    Packet packet_array[4] = { 0 };
+
+    // Nothing is written before the receiver has advertised its slots.
+    CHECK(-1 == TestSlotGet(endpoint_ptr, &packet_array[0], 1, 0, 1000));
+    TestSlotsAdvertise(endpoint_ptr, 0);
+    CHECK(rma_ptr->slots_valid);
+
+    // Payloads 1 and 2 are started before either is finished. Each gets its own slot.
+    CHECK(0 == TestSlotGet(endpoint_ptr, &packet_array[0], 1, 0, 1000));
+    CHECK(1 == TestSlotGet(endpoint_ptr, &packet_array[1], 2, 0, 1000));
+    CHECK(2 == endpoint_ptr->tx_state.tx_packets_in_process);
+    CHECK(&packet_array[0] == rma_ptr->payload_array[0].packet0_ptr);
+    CHECK(0x100000 + TEST_SLOT_SIZE == rma_ptr->payload_array[1].remote_address);
+    CHECK(1 == TestSlotGet(endpoint_ptr, &packet_array[2], 2, 1, 0));
+    CHECK(0 == TestSlotGet(endpoint_ptr, &packet_array[2], 1, 1, 0));
+
+    // No slot is free for payload 3, so all of its packets are sent, even while other payloads are being written.
+    CHECK(-1 == TestSlotGet(endpoint_ptr, &packet_array[3], 3, 0, 1000));
+    CHECK(-1 == TestSlotGet(endpoint_ptr, &packet_array[3], 3, 1, 0));
+    CHECK(2 == endpoint_ptr->tx_state.tx_packets_in_process);
+
+    // Once the last packet of payload 1 has been written, its later packets are not for the slot anymore.
+    rma_ptr->payload_array[0].last_packet_written = true;
+    CHECK(-1 == TestSlotGet(endpoint_ptr, &packet_array[2], 1, 2, 0));
+    CHECK(1 == TestSlotGet(endpoint_ptr, &packet_array[2], 2, 2, 0));
+
+    // A packet #0 that shares its SGL entry with data is sent.
+    CdiDecodedPacketHeader header = {
+        .payload_type = kPayloadTypeData,
+        .payload_num = 4,
+        .num0_info.total_payload_size = 1000
+    };
+    CHECK(-1 == EfaTxRmaSlotGet(endpoint_ptr, &packet_array[3], &header, false));
+
+    // Slot 0 is only used again once the receiver has released it, and payloads larger than a slot are always sent.
+    rma_ptr->payload_array[0].active = false;
+    CHECK(-1 == TestSlotGet(endpoint_ptr, &packet_array[3], 4, 0, 1000));
+    TestSlotsAdvertise(endpoint_ptr, 1);
+    CHECK(-1 == TestSlotGet(endpoint_ptr, &packet_array[3], 4, 0, TEST_SLOT_SIZE + 1));
+    CHECK(0 == TestSlotGet(endpoint_ptr, &packet_array[3], 4, 0, TEST_SLOT_SIZE));
+    CHECK(4 == rma_ptr->payload_array[0].payload_num);
+
+    return true;
+}
+
+CdiReturnStatus TestUnitEfaRma(void)
+{
+    EfaEndpointState* endpoint_ptr = CdiOsMemAllocZero(sizeof(EfaEndpointState));
+    if (NULL == endpoint_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    endpoint_ptr->rma_supported = true;
+
+    bool pass = CdiOsCritSectionCreate(&endpoint_ptr->tx_state.rma_state.lock) && TestInterleavedPayloads(endpoint_ptr);
+
+    CdiOsCritSectionDelete(endpoint_ptr->tx_state.rma_state.lock);
+    CdiOsMemFree(endpoint_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
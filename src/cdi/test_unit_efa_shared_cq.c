@@ -0,0 +1,225 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the completion queues that EFA Rx endpoints of the connections of a poll thread
+ * share.
+ */
+
+#include "adapter_efa.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "configuration.h"
+#include "list_api.h"
+#include "rdma/fi_eq.h"
+#include "rdma/fi_errno.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Maximum number of completions held by the completion queue used by the test.
+#define TEST_MAX_COMPLETIONS    (3 * MAX_RX_BULK_COMPLETION_QUEUE_MESSAGES)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief Completion queue used by the test in place of a libfabric one. Only reading completions is supported.
+ */
+typedef struct {
+    struct fid_cq cq;                                          ///< Must be first. Passed to libfabric functions.
+    struct fi_ops_cq ops;                                      ///< Functions of cq.
+    struct fi_cq_data_entry entry_array[TEST_MAX_COMPLETIONS]; ///< Completions that have not been read.
+    int count;                                                 ///< Number of completions in entry_array.
+} TestCompletionQueue;
+
+/**
+ * @brief State of the endpoints used by the test. Only the members used to drain the completion queue are set.
+ */
+typedef struct {
+    TestCompletionQueue test_cq;                ///< The completion queue shared by the endpoints.
+    EfaEndpointState endpoint_a;                ///< First endpoint.
+    EfaEndpointState endpoint_b;                ///< Second endpoint.
+    EfaRxCompletionContext context_a;           ///< Context of the receive buffers of endpoint_a.
+    EfaRxCompletionContext context_b;           ///< Context of the receive buffers of endpoint_b.
+} TestSharedCqState;
+
+/**
+ * Read completions from the test's completion queue, like fi_cq_read() does.
+ *
+ * @param cq_ptr Pointer to the completion queue.
+ * @param buf Address where to write the completions.
+ * @param count Maximum number of completions to read.
+ *
+ * @return Number of completions read. -FI_EAGAIN if the completion queue is empty.
+ */
+static ssize_t TestCqRead(struct fid_cq* cq_ptr, void* buf, size_t count)
+{
+    TestCompletionQueue* test_cq_ptr = (TestCompletionQueue*)cq_ptr;
+    if (0 == test_cq_ptr->count) {
+        return -FI_EAGAIN;
+    }
+    const int read_count = CDI_MIN((int)count, test_cq_ptr->count);
+    memcpy(buf, test_cq_ptr->entry_array, read_count * sizeof(test_cq_ptr->entry_array[0]));
+    test_cq_ptr->count -= read_count;
+    memmove(test_cq_ptr->entry_array, test_cq_ptr->entry_array + read_count,
+            test_cq_ptr->count * sizeof(test_cq_ptr->entry_array[0]));
+    return read_count;
+}
+
+/**
+ * Read an error completion from the test's completion queue, which never has any.
+ *
+ * @param cq_ptr Pointer to the completion queue.
+ * @param buf Address where to write the error completion.
+ * @param flags Not used.
+ *
+ * @return Always -FI_EAGAIN.
+ */
+static ssize_t TestCqReadErr(struct fid_cq* cq_ptr, struct fi_cq_err_entry* buf, uint64_t flags)
+{
+    (void)cq_ptr;
+    (void)buf;
+    (void)flags;
+    return -FI_EAGAIN;
+}
+
+/**
+ * Add a completion to the test's completion queue. Its length identifies it.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param context_ptr Pointer to the context of the receive buffer of the completion.
+ * @param len Length of the completion.
+ */
+static void TestCompletionAdd(TestSharedCqState* test_ptr, EfaRxCompletionContext* context_ptr, size_t len)
+{
+    TestCompletionQueue* test_cq_ptr = &test_ptr->test_cq;
+    struct fi_cq_data_entry* entry_ptr = &test_cq_ptr->entry_array[test_cq_ptr->count++];
+    memset(entry_ptr, 0, sizeof(*entry_ptr));
+    entry_ptr->op_context = &context_ptr->fi_context;
+    entry_ptr->len = len;
+}
+
+/**
+ * Test that the Rx connections of a poll thread share one completion queue, and that the connections of other poll
+ * threads don't.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestSharedCqGet(void)
+{
+    CdiList list;
+    CdiListInit(&list);
+    PollThreadState poll_thread_array[2] = { 0 };
+
+    EfaSharedCompletionQueue* first_ptr = NULL;
+    EfaSharedCompletionQueue* second_ptr = NULL;
+    EfaSharedCompletionQueue* other_ptr = NULL;
+    CHECK(kCdiStatusOk == EfaRxSharedCompletionQueueGet(&list, &poll_thread_array[0], &first_ptr));
+    CHECK(kCdiStatusOk == EfaRxSharedCompletionQueueGet(&list, &poll_thread_array[1], &other_ptr));
+    CHECK(kCdiStatusOk == EfaRxSharedCompletionQueueGet(&list, &poll_thread_array[0], &second_ptr));
+    CHECK(first_ptr == second_ptr && first_ptr != other_ptr);
+    CHECK(2 == first_ptr->connection_count && 1 == other_ptr->connection_count);
+    CHECK(2 == CdiListCount(&list));
+
+    // A shared completion queue is only freed once all of its connections have released it.
+    EfaRxSharedCompletionQueuePut(&list, first_ptr);
+    CHECK(2 == CdiListCount(&list));
+    EfaRxSharedCompletionQueuePut(&list, other_ptr);
+    CHECK(1 == CdiListCount(&list));
+    EfaRxSharedCompletionQueuePut(&list, second_ptr);
+    CHECK(CdiListIsEmpty(&list));
+
+    return true;
+}
+
+/**
+ * Test that closing an endpoint drains its completions from the shared completion queue, and that the completions of
+ * the other endpoint are kept in order in the backlog, however many there are.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestDrain(TestSharedCqState* test_ptr)
+{
+    EfaSharedCompletionQueue* shared_cq_ptr = test_ptr->endpoint_a.shared_cq_ptr;
+
+    // Completions of endpoint B, several reads' worth of them, are interleaved with the ones of endpoint A.
+    for (int i = 0; i < TEST_MAX_COMPLETIONS; i++) {
+        TestCompletionAdd(test_ptr, (i % 3) ? &test_ptr->context_b : &test_ptr->context_a, i);
+    }
+    EfaRxSharedCompletionQueueDrain(&test_ptr->endpoint_a);
+    CHECK(0 == test_ptr->test_cq.count);
+    CHECK(TEST_MAX_COMPLETIONS * 2 / 3 == shared_cq_ptr->backlog_count);
+    CHECK(shared_cq_ptr->backlog_count <= shared_cq_ptr->backlog_size);
+    for (int i = 0; i < shared_cq_ptr->backlog_count; i++) {
+        const struct fi_cq_data_entry* entry_ptr = &shared_cq_ptr->backlog_array_ptr[i];
+        CHECK(&test_ptr->context_b.fi_context == entry_ptr->op_context);
+        CHECK((size_t)(i / 2 * 3 + 1 + i % 2) == entry_ptr->len);
+    }
+
+    // Draining endpoint B removes its completions from the backlog as well as from the completion queue.
+    TestCompletionAdd(test_ptr, &test_ptr->context_b, 1000);
+    TestCompletionAdd(test_ptr, &test_ptr->context_a, 1001);
+    EfaRxSharedCompletionQueueDrain(&test_ptr->endpoint_b);
+    CHECK(0 == test_ptr->test_cq.count);
+    CHECK(1 == shared_cq_ptr->backlog_count);
+    CHECK(&test_ptr->context_a.fi_context == shared_cq_ptr->backlog_array_ptr[0].op_context);
+    CHECK(1001 == shared_cq_ptr->backlog_array_ptr[0].len);
+
+    return true;
+}
+
+CdiReturnStatus TestUnitEfaSharedCq(void)
+{
+    TestSharedCqState* test_ptr = CdiOsMemAllocZero(sizeof(TestSharedCqState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    test_ptr->test_cq.ops.size = sizeof(test_ptr->test_cq.ops);
+    test_ptr->test_cq.ops.read = TestCqRead;
+    test_ptr->test_cq.ops.readerr = TestCqReadErr;
+    test_ptr->test_cq.cq.ops = &test_ptr->test_cq.ops;
+    test_ptr->context_a.endpoint_ptr = &test_ptr->endpoint_a;
+    test_ptr->context_b.endpoint_ptr = &test_ptr->endpoint_b;
+
+    bool pass = TestSharedCqGet();
+
+    CdiList list;
+    CdiListInit(&list);
+    EfaSharedCompletionQueue* shared_cq_ptr = NULL;
+    pass = pass && kCdiStatusOk == EfaRxSharedCompletionQueueGet(&list, NULL, &shared_cq_ptr);
+    if (pass) {
+        shared_cq_ptr->completion_queue_ptr = &test_ptr->test_cq.cq;
+        test_ptr->endpoint_a.shared_cq_ptr = shared_cq_ptr;
+        test_ptr->endpoint_b.shared_cq_ptr = shared_cq_ptr;
+        pass = TestDrain(test_ptr);
+        EfaRxSharedCompletionQueuePut(&list, shared_cq_ptr);
+    }
+
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
@@ -0,0 +1,143 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the receive packet buffers that EFA adapters share between Rx connections.
+ */
+
+#include "adapter_efa.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "configuration.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of packet buffers in the pool used by the test.
+#define TEST_PACKET_COUNT       (10)
+
+/// Size in bytes of each packet buffer in the pool used by the test.
+#define TEST_PACKET_SIZE        (9000)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * Test that connections take buffers from the pool up to their quota, and that buffers put back can be taken again.
+ *
+ * @param pool_ptr Pointer to the pool.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestQuota(EfaRxSharedPacketPool* pool_ptr)
+{
+    uint8_t* first_array[TEST_PACKET_COUNT];
+    uint8_t* second_array[TEST_PACKET_COUNT];
+    int first_held = 0;
+    int second_held = 0;
+
+    // The first connection is limited by its quota, the second one by what is left in the pool.
+    CHECK(4 == EfaRxSharedPacketPoolGet(pool_ptr, 4, &first_held, first_array, TEST_PACKET_COUNT));
+    CHECK(4 == first_held);
+    CHECK(0 == EfaRxSharedPacketPoolGet(pool_ptr, 4, &first_held, first_array + 4, 1));
+    CHECK(6 == EfaRxSharedPacketPoolGet(pool_ptr, TEST_PACKET_COUNT, &second_held, second_array, TEST_PACKET_COUNT));
+    CHECK(0 == pool_ptr->free_count);
+    CHECK(0 == EfaRxSharedPacketPoolGet(pool_ptr, TEST_PACKET_COUNT, &second_held, second_array + 6, 1));
+
+    // Every buffer of the pool is taken once.
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 6; j++) {
+            CHECK(first_array[i] != second_array[j]);
+        }
+    }
+
+    // Buffers put back by one connection can be taken by the other.
+    EfaRxSharedPacketPoolPut(pool_ptr, &first_held, first_array, 2);
+    CHECK(2 == first_held && 2 == pool_ptr->free_count);
+    CHECK(2 == EfaRxSharedPacketPoolGet(pool_ptr, TEST_PACKET_COUNT, &second_held, second_array + 6, 3));
+    CHECK(8 == second_held);
+
+    EfaRxSharedPacketPoolPut(pool_ptr, &first_held, first_array + 2, 2);
+    EfaRxSharedPacketPoolPut(pool_ptr, &second_held, second_array, 8);
+    CHECK(0 == first_held && 0 == second_held);
+    CHECK(TEST_PACKET_COUNT == pool_ptr->free_count);
+
+    return true;
+}
+
+/**
+ * Test that polls skip refilling for longer after each refill in a row that gets no buffers, and refill every time
+ * again once a refill gets some.
+ *
+ * @param rx_state_ptr Pointer to Rx state of an endpoint.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestRefillBackoff(EfaRxState* rx_state_ptr)
+{
+    CHECK(EfaRxSharedPoolRefillDue(rx_state_ptr));
+    EfaRxSharedPoolRefillBackoff(rx_state_ptr, true);
+    CHECK(EfaRxSharedPoolRefillDue(rx_state_ptr));
+
+    int expected_backoff = 1;
+    for (int refill = 0; refill < 10; refill++) {
+        EfaRxSharedPoolRefillBackoff(rx_state_ptr, false);
+        CHECK(expected_backoff == rx_state_ptr->shared_refill_backoff);
+        for (int poll = 0; poll < expected_backoff; poll++) {
+            CHECK(!EfaRxSharedPoolRefillDue(rx_state_ptr));
+        }
+        CHECK(EfaRxSharedPoolRefillDue(rx_state_ptr));
+        expected_backoff = CDI_MIN(2 * expected_backoff, EFA_RX_SHARED_POOL_MAX_REFILL_BACKOFF);
+    }
+    CHECK(EFA_RX_SHARED_POOL_MAX_REFILL_BACKOFF == rx_state_ptr->shared_refill_backoff);
+
+    // A refill that gets buffers, such as after the endpoint freed some of its own, ends the backoff.
+    EfaRxSharedPoolRefillBackoff(rx_state_ptr, false);
+    CHECK(!EfaRxSharedPoolRefillDue(rx_state_ptr));
+    EfaRxSharedPoolRefillBackoff(rx_state_ptr, true);
+    CHECK(0 == rx_state_ptr->shared_refill_backoff);
+    CHECK(EfaRxSharedPoolRefillDue(rx_state_ptr));
+    CHECK(EfaRxSharedPoolRefillDue(rx_state_ptr));
+
+    return true;
+}
+
+CdiReturnStatus TestUnitEfaSharedPool(void)
+{
+    EfaRxSharedPacketPool* pool_ptr = NULL;
+    CdiReturnStatus rs = EfaRxSharedPacketPoolCreate(TEST_PACKET_SIZE, TEST_PACKET_COUNT, &pool_ptr);
+    if (kCdiStatusOk != rs) {
+        return rs;
+    }
+    EfaRxState* rx_state_ptr = CdiOsMemAllocZero(sizeof(EfaRxState));
+    if (NULL == rx_state_ptr) {
+        EfaRxSharedPacketPoolDestroy(pool_ptr);
+        return kCdiStatusNotEnoughMemory;
+    }
+
+    bool pass = TestQuota(pool_ptr) && TestRefillBackoff(rx_state_ptr);
+
+    CdiOsMemFree(rx_state_ptr);
+    EfaRxSharedPacketPoolDestroy(pool_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
@@ -0,0 +1,185 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the application memory regions registered with an adapter.
+ */
+
+#include "adapter_api.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "utilities_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Size in bytes of each memory region used by the test.
+#define TEST_REGION_SIZE    (256)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief Memory region user that records the regions it is asked to release.
+ */
+typedef struct {
+    AdapterMemoryRegionUser user; ///< Must be first, so a pointer to it is a pointer to this structure.
+    int release_count;            ///< Number of times the release function was called.
+    AdapterMemoryRegion released_region; ///< Copy of the last region released.
+} TestMemoryRegionUser;
+
+/// Memory used as the Tx payload buffer of the test adapter, followed by the memory used for the regions.
+static uint8_t test_memory_array[TEST_REGION_SIZE * (CDI_MAX_ADAPTER_MEMORY_REGIONS + 2)];
+
+/**
+ * Release function of TestMemoryRegionUser.
+ *
+ * @param user_ptr Pointer to the memory region user.
+ * @param region_ptr Pointer to the region that is being unregistered.
+ */
+static void TestRelease(AdapterMemoryRegionUser* user_ptr, const AdapterMemoryRegion* region_ptr)
+{
+    TestMemoryRegionUser* test_user_ptr = (TestMemoryRegionUser*)user_ptr;
+    test_user_ptr->release_count++;
+    test_user_ptr->released_region = *region_ptr;
+}
+
+/**
+ * Get the address of the memory used for a region. Region 0 follows the Tx payload buffer.
+ *
+ * @param index Index of the region.
+ *
+ * @return Starting address of the region.
+ */
+static uint8_t* RegionAddress(int index)
+{
+    return test_memory_array + TEST_REGION_SIZE * (index + 1);
+}
+
+/**
+ * Run the test using an adapter that only has the state used by the memory region functions.
+ *
+ * @param adapter Handle of the adapter.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestMemoryRegions(CdiAdapterHandle adapter)
+{
+    AdapterMemoryRegion region;
+
+    // Regions can't overlap the Tx payload buffer or each other.
+    CHECK(kCdiStatusInvalidParameter ==
+          CdiAdapterMemoryRegister(adapter, test_memory_array + TEST_REGION_SIZE / 2, TEST_REGION_SIZE));
+    CHECK(kCdiStatusOk == CdiAdapterMemoryRegister(adapter, RegionAddress(0), TEST_REGION_SIZE));
+    CHECK(kCdiStatusInvalidParameter ==
+          CdiAdapterMemoryRegister(adapter, RegionAddress(0) + TEST_REGION_SIZE - 1, TEST_REGION_SIZE));
+
+    // Blocks are only found if they are entirely within a region.
+    CHECK(CdiAdapterMemoryRegionFind(adapter, RegionAddress(0) + 16, 32, &region));
+    CHECK(RegionAddress(0) == region.address_ptr);
+    CHECK(TEST_REGION_SIZE == region.size_in_bytes);
+    CHECK(0 != region.region_id);
+    const uint32_t first_region_id = region.region_id;
+    CHECK(CdiAdapterMemoryRegionFind(adapter, RegionAddress(0), TEST_REGION_SIZE, &region));
+    CHECK(!CdiAdapterMemoryRegionFind(adapter, RegionAddress(0) + 1, TEST_REGION_SIZE, &region));
+    CHECK(!CdiAdapterMemoryRegionFind(adapter, test_memory_array, 16, &region));
+
+    // Fill the table. Registering one more region must fail.
+    for (int i = 1; i < CDI_MAX_ADAPTER_MEMORY_REGIONS; i++) {
+        CHECK(kCdiStatusOk == CdiAdapterMemoryRegister(adapter, RegionAddress(i), TEST_REGION_SIZE));
+    }
+    CHECK(CDI_MAX_ADAPTER_MEMORY_REGIONS == adapter->memory_region_count);
+    CHECK(kCdiStatusArraySizeExceeded ==
+          CdiAdapterMemoryRegister(adapter, RegionAddress(CDI_MAX_ADAPTER_MEMORY_REGIONS), TEST_REGION_SIZE));
+
+    TestMemoryRegionUser user_array[2];
+    memset(user_array, 0, sizeof(user_array));
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(user_array); i++) {
+        user_array[i].user.release_ptr = TestRelease;
+        CdiAdapterMemoryRegionUserAdd(adapter, &user_array[i].user);
+    }
+
+    // Unregistering a region releases it from every user before returning, and it can no longer be found.
+    CHECK(kCdiStatusInvalidParameter == CdiAdapterMemoryUnregister(adapter, RegionAddress(0) + 1));
+    CHECK(0 == user_array[0].release_count);
+    CHECK(kCdiStatusOk == CdiAdapterMemoryUnregister(adapter, RegionAddress(0)));
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(user_array); i++) {
+        CHECK(1 == user_array[i].release_count);
+        CHECK(first_region_id == user_array[i].released_region.region_id);
+        CHECK(RegionAddress(0) == user_array[i].released_region.address_ptr);
+    }
+    CHECK(!CdiAdapterMemoryRegionFind(adapter, RegionAddress(0), 16, &region));
+    CHECK(kCdiStatusInvalidParameter == CdiAdapterMemoryUnregister(adapter, RegionAddress(0)));
+
+    // The other regions are still found. The last one was moved into the free entry.
+    const int last_index = CDI_MAX_ADAPTER_MEMORY_REGIONS - 1;
+    CHECK(CdiAdapterMemoryRegionFind(adapter, RegionAddress(last_index), 16, &region));
+    CHECK(CdiAdapterMemoryRegionFind(adapter, RegionAddress(1), 16, &region));
+
+    // A region registered again gets a new identifier.
+    CHECK(kCdiStatusOk == CdiAdapterMemoryRegister(adapter, RegionAddress(0), TEST_REGION_SIZE));
+    CHECK(CdiAdapterMemoryRegionFind(adapter, RegionAddress(0), 16, &region));
+    CHECK(first_region_id != region.region_id);
+
+    // A removed user is not called anymore. Removing it again does nothing.
+    CdiAdapterMemoryRegionUserRemove(adapter, &user_array[0].user);
+    CdiAdapterMemoryRegionUserRemove(adapter, &user_array[0].user);
+    CHECK(kCdiStatusOk == CdiAdapterMemoryUnregister(adapter, RegionAddress(1)));
+    CHECK(1 == user_array[0].release_count);
+    CHECK(2 == user_array[1].release_count);
+    CHECK(RegionAddress(1) == user_array[1].released_region.address_ptr);
+    CdiAdapterMemoryRegionUserRemove(adapter, &user_array[1].user);
+    CHECK(CdiListIsEmpty(&adapter->memory_region_user_list));
+
+    // Unregister the remaining regions.
+    CHECK(kCdiStatusOk == CdiAdapterMemoryUnregister(adapter, RegionAddress(0)));
+    for (int i = 2; i < CDI_MAX_ADAPTER_MEMORY_REGIONS; i++) {
+        CHECK(kCdiStatusOk == CdiAdapterMemoryUnregister(adapter, RegionAddress(i)));
+    }
+    CHECK(0 == adapter->memory_region_count);
+
+    return true;
+}
+
+CdiReturnStatus TestUnitMemoryRegion(void)
+{
+    CdiAdapterState* adapter = CdiOsMemAllocZero(sizeof(CdiAdapterState));
+    if (NULL == adapter) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    if (!CdiOsCritSectionCreate(&adapter->memory_region_lock)) {
+        CdiOsMemFree(adapter);
+        return kCdiStatusNotEnoughMemory;
+    }
+    CdiListInit(&adapter->memory_region_user_list);
+    adapter->adapter_data.ret_tx_buffer_ptr = test_memory_array;
+    adapter->tx_buffer_allocated_size = TEST_REGION_SIZE;
+
+    bool pass = TestMemoryRegions(adapter);
+
+    CdiOsCritSectionDelete(adapter->memory_region_lock);
+    CdiOsMemFree(adapter);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
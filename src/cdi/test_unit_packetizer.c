@@ -0,0 +1,452 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the Tx payload packetizer.
+ */
+
+#include "payload.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "adapter_api.h"
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "cdi_pool_api.h"
+#include "internal.h"
+#include "private.h"
+#include "protocol.h"
+#include "utilities_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Maximum size in bytes of each packet, including its header.
+#define TEST_PACKET_SIZE            (1000)
+
+/// Maximum number of SGL entries of each packet, including its header.
+#define TEST_PACKET_SGL_ENTRIES     (4)
+
+/// Size in bytes of the small fragments of the test payload.
+#define TEST_SMALL_FRAGMENT_SIZE    (40)
+
+/// Size in bytes of the large fragment of the test payload.
+#define TEST_LARGE_FRAGMENT_SIZE    (3000)
+
+/// Number of small fragments before the large fragment of the test payload.
+#define TEST_SMALL_FRAGMENTS_BEFORE (64)
+
+/// Number of small fragments after the large fragment of the test payload.
+#define TEST_SMALL_FRAGMENTS_AFTER  (10)
+
+/// Number of SGL entries of the test payload.
+#define TEST_FRAGMENT_COUNT         (TEST_SMALL_FRAGMENTS_BEFORE + 1 + TEST_SMALL_FRAGMENTS_AFTER)
+
+/// Size in bytes of the test payload.
+#define TEST_PAYLOAD_SIZE           \
+    ((TEST_SMALL_FRAGMENTS_BEFORE + TEST_SMALL_FRAGMENTS_AFTER) * TEST_SMALL_FRAGMENT_SIZE + TEST_LARGE_FRAGMENT_SIZE)
+
+/// Number of items in each of the pools used by the test.
+#define TEST_POOL_ITEM_COUNT        (TEST_FRAGMENT_COUNT * 2)
+
+/// Maximum number of packets of the test payload.
+#define TEST_MAX_PACKETS            (TEST_FRAGMENT_COUNT + TEST_PAYLOAD_SIZE / 100)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief The state of a Tx connection that is used by the packetizer. Only the members that the packetizer uses are
+ * set.
+ */
+typedef struct {
+    CdiAdapterState adapter;                  ///< Adapter of the connection.
+    AdapterConnectionState adapter_con;       ///< Adapter connection.
+    AdapterEndpointState adapter_endpoint;    ///< Adapter endpoint.
+    CdiEndpointState endpoint;                ///< Endpoint the payload is sent on.
+    CdiConnectionState con;                   ///< Connection.
+    TxPayloadState payload;                   ///< The payload being packetized.
+    CdiProtocolHandle protocol_handle;        ///< Protocol used for the packet headers.
+    CdiPacketizerStateHandle packetizer_state_handle; ///< Packetizer.
+    CdiPoolHandle bounce_buffer_pool_handle;  ///< Bounce buffers used when coalescing.
+    char header[MAX_MSG_PREFIX_SIZE + sizeof(CdiRawPacketHeader)]; ///< Header of the packet being built.
+    uint8_t payload_data_array[TEST_PAYLOAD_SIZE]; ///< Data of the payload.
+    CdiSglEntry source_entry_array[TEST_FRAGMENT_COUNT]; ///< Source SGL entries of the payload.
+    CdiSgList source_sgl;                     ///< Source SGL of the payload.
+} TestPacketizerState;
+
+/**
+ * @brief Results of packetizing a payload.
+ */
+typedef struct {
+    int packet_count;        ///< Number of packets of the payload.
+    int short_packet_count;  ///< Number of packets other than the last one that were not filled up.
+    int bounced_byte_count;  ///< Number of payload bytes copied into bounce buffers.
+    int zero_copy_byte_count; ///< Number of payload bytes sent directly from the source SGL.
+    /// Number of packets built by PayloadPacketizationPlanPacketBuild() from the stream's plan.
+    int plan_packet_count;
+    int packet_size_array[TEST_MAX_PACKETS];   ///< Size in bytes of each packet, including its header.
+    int packet_entry_array[TEST_MAX_PACKETS];  ///< Number of SGL entries of each packet, including its header.
+} TestPacketizeResults;
+
+/**
+ * Create the state used by the test.
+ *
+ * @param state_ptr Pointer to the zeroed state.
+ *
+ * @return true if successful, otherwise false.
+ */
+static bool TestStateCreate(TestPacketizerState* state_ptr)
+{
+    state_ptr->adapter.maximum_payload_bytes = TEST_PACKET_SIZE;
+    state_ptr->adapter.maximum_tx_sgl_entries = TEST_PACKET_SGL_ENTRIES;
+    state_ptr->adapter_con.adapter_state_ptr = &state_ptr->adapter;
+    state_ptr->adapter_endpoint.adapter_con_state_ptr = &state_ptr->adapter_con;
+    state_ptr->endpoint.adapter_endpoint_ptr = &state_ptr->adapter_endpoint;
+    state_ptr->con.adapter_state_ptr = &state_ptr->adapter;
+    state_ptr->payload.cdi_endpoint_handle = &state_ptr->endpoint;
+
+    CdiProtocolVersionNumber version = {
+        .version_num = CDI_PROTOCOL_VERSION,
+        .major_version_num = CDI_PROTOCOL_MAJOR_VERSION,
+        .probe_version_num = CDI_PROBE_VERSION
+    };
+    ProtocolVersionSet(&version, &state_ptr->protocol_handle);
+    state_ptr->packetizer_state_handle = PayloadPacketizerCreate();
+    CHECK(NULL != state_ptr->protocol_handle && NULL != state_ptr->packetizer_state_handle);
+    CHECK(CdiPoolCreate("TestPayloadSglEntries", TEST_POOL_ITEM_COUNT, NO_GROW_SIZE, NO_GROW_COUNT,
+                        sizeof(CdiSglEntry), false, &state_ptr->con.tx_state.payload_sgl_entry_pool_handle));
+    CHECK(CdiPoolCreate("TestPacketSglEntries", TEST_POOL_ITEM_COUNT, NO_GROW_SIZE, NO_GROW_COUNT,
+                        sizeof(CdiSglEntry), false, &state_ptr->con.tx_state.packet_sgl_entry_pool_handle));
+    CHECK(CdiPoolCreate("TestBounceBuffers", TEST_POOL_ITEM_COUNT, NO_GROW_SIZE, NO_GROW_COUNT, TEST_PACKET_SIZE,
+                        false, &state_ptr->bounce_buffer_pool_handle));
+
+    // Build the payload: small fragments, then a large one, then small ones again. Each byte holds a different value,
+    // so data that is out of place is detected.
+    for (int i = 0; i < TEST_PAYLOAD_SIZE; i++) {
+        state_ptr->payload_data_array[i] = (uint8_t)(i * 7 + i / 256);
+    }
+    int offset = 0;
+    for (int i = 0; i < TEST_FRAGMENT_COUNT; i++) {
+        CdiSglEntry* entry_ptr = &state_ptr->source_entry_array[i];
+        entry_ptr->address_ptr = state_ptr->payload_data_array + offset;
+        entry_ptr->size_in_bytes = (TEST_SMALL_FRAGMENTS_BEFORE == i) ? TEST_LARGE_FRAGMENT_SIZE :
+                                                                        TEST_SMALL_FRAGMENT_SIZE;
+        entry_ptr->next_ptr = (i + 1 < TEST_FRAGMENT_COUNT) ? &state_ptr->source_entry_array[i + 1] : NULL;
+        offset += entry_ptr->size_in_bytes;
+    }
+    state_ptr->source_sgl.sgl_head_ptr = &state_ptr->source_entry_array[0];
+    state_ptr->source_sgl.sgl_tail_ptr = &state_ptr->source_entry_array[TEST_FRAGMENT_COUNT - 1];
+    state_ptr->source_sgl.total_data_size = TEST_PAYLOAD_SIZE;
+
+    return true;
+}
+
+/**
+ * Destroy the resources of the state used by the test.
+ *
+ * @param state_ptr Pointer to the state.
+ */
+static void TestStateDestroy(TestPacketizerState* state_ptr)
+{
+    // A failed test can leave items in use.
+    CdiPoolPutAll(state_ptr->bounce_buffer_pool_handle);
+    CdiPoolPutAll(state_ptr->con.tx_state.packet_sgl_entry_pool_handle);
+    CdiPoolPutAll(state_ptr->con.tx_state.payload_sgl_entry_pool_handle);
+    CdiPoolDestroy(state_ptr->bounce_buffer_pool_handle);
+    CdiPoolDestroy(state_ptr->con.tx_state.packet_sgl_entry_pool_handle);
+    CdiPoolDestroy(state_ptr->con.tx_state.payload_sgl_entry_pool_handle);
+    PayloadPacketizerDestroy(state_ptr->packetizer_state_handle);
+    ProtocolVersionDestroy(state_ptr->protocol_handle);
+}
+
+/**
+ * Check that a packet holds the next part of the test payload's data and add it to the results.
+ *
+ * @param state_ptr Pointer to the state used by the test.
+ * @param packet_sgl_ptr Pointer to the packet's SGL.
+ * @param is_last_packet True if the packet is the last one of the payload.
+ * @param payload_offset_ptr Pointer to the offset in the payload of the packet's data. Advanced past the packet.
+ * @param results_ptr Pointer to the results to update.
+ *
+ * @return true if successful, otherwise false.
+ */
+static bool PacketCheck(TestPacketizerState* state_ptr, const CdiSgList* packet_sgl_ptr, bool is_last_packet,
+                        int* payload_offset_ptr, TestPacketizeResults* results_ptr)
+{
+    int entry_count = 0;
+    for (const CdiSglEntry* entry_ptr = packet_sgl_ptr->sgl_head_ptr; entry_ptr; entry_ptr = entry_ptr->next_ptr) {
+        // The first entry is the header, the others hold the payload's data.
+        if (entry_count) {
+            CHECK(*payload_offset_ptr + entry_ptr->size_in_bytes <= TEST_PAYLOAD_SIZE);
+            CHECK(0 == memcmp(state_ptr->payload_data_array + *payload_offset_ptr, entry_ptr->address_ptr,
+                              entry_ptr->size_in_bytes));
+            *payload_offset_ptr += entry_ptr->size_in_bytes;
+        } else {
+            CHECK(state_ptr->header == (char*)entry_ptr->address_ptr);
+        }
+        entry_count++;
+    }
+    CHECK(entry_count <= TEST_PACKET_SGL_ENTRIES);
+    CHECK(packet_sgl_ptr->total_data_size <= TEST_PACKET_SIZE);
+    if (!is_last_packet && packet_sgl_ptr->total_data_size < TEST_PACKET_SIZE) {
+        results_ptr->short_packet_count++;
+    }
+    CHECK(results_ptr->packet_count < TEST_MAX_PACKETS);
+    results_ptr->packet_size_array[results_ptr->packet_count] = packet_sgl_ptr->total_data_size;
+    results_ptr->packet_entry_array[results_ptr->packet_count] = entry_count;
+    results_ptr->packet_count++;
+
+    return true;
+}
+
+/**
+ * Build the remaining packets of the test payload from its stream's plan, the way the packetizer's helpers do, and
+ * check them.
+ *
+ * @param state_ptr Pointer to the state used by the test.
+ * @param plan_handle Packetization plan of the payload's stream.
+ * @param packets_left Number of packets left, as returned by PayloadPacketizerParallelPacketsLeft().
+ * @param payload_offset_ptr Pointer to the offset in the payload of the next packet's data.
+ * @param results_ptr Pointer to the results to update.
+ *
+ * @return true if successful, otherwise false.
+ */
+static bool PacketizeFromPlan(TestPacketizerState* state_ptr, PacketizationPlanHandle plan_handle, int packets_left,
+                              int* payload_offset_ptr, TestPacketizeResults* results_ptr)
+{
+    CdiPoolHandle entry_pool_handle = state_ptr->con.tx_state.packet_sgl_entry_pool_handle;
+    const int first_packet_index = results_ptr->packet_count;
+    for (int i = first_packet_index; i < first_packet_index + packets_left; i++) {
+        // Each packet is built using a private copy of the payload state, as the helpers do.
+        TxPayloadState payload_state = state_ptr->payload;
+        PayloadPacketizationPlanSeek(plan_handle, i, &payload_state);
+
+        CdiSgList packet_sgl = { 0 };
+        const int entry_count = PayloadPacketizationPlanPacketEntryCount(plan_handle, i);
+        for (int j = 0; j < entry_count; j++) {
+            CdiSglEntry* entry_ptr = NULL;
+            CHECK(CdiPoolGet(entry_pool_handle, (void**)&entry_ptr));
+            entry_ptr->next_ptr = NULL;
+            SglAppend(&packet_sgl, entry_ptr);
+        }
+        PayloadPacketizationPlanPacketBuild(state_ptr->protocol_handle, plan_handle, i, state_ptr->header,
+                                            &payload_state, &packet_sgl);
+        CHECK(PacketCheck(state_ptr, &packet_sgl, i + 1 == first_packet_index + packets_left, payload_offset_ptr,
+                          results_ptr));
+        results_ptr->plan_packet_count++;
+        CdiPoolPutAll(entry_pool_handle);
+    }
+
+    return true;
+}
+
+/**
+ * Split the test payload into packets and check that the packets hold the payload's data, in order.
+ *
+ * @param state_ptr Pointer to the state used by the test.
+ * @param plan_handle Packetization plan to use. NULL to packetize without a plan.
+ * @param bounce_buffer_pool_handle Pool of bounce buffers to coalesce small fragments. NULL to not coalesce.
+ * @param ret_results_ptr Pointer to returned results.
+ *
+ * @return true if successful, otherwise false.
+ */
+static bool Packetize(TestPacketizerState* state_ptr, PacketizationPlanHandle plan_handle,
+                      CdiPoolHandle bounce_buffer_pool_handle, TestPacketizeResults* ret_results_ptr)
+{
+    TxPayloadState* payload_state_ptr = &state_ptr->payload;
+    memset(ret_results_ptr, 0, sizeof(*ret_results_ptr));
+    memset(&payload_state_ptr->payload_packet_state, 0, sizeof(payload_state_ptr->payload_packet_state));
+    CHECK(PayloadInit(&state_ptr->con, &state_ptr->source_sgl, payload_state_ptr));
+    PayloadPacketizerStateInit(state_ptr->packetizer_state_handle, plan_handle, payload_state_ptr);
+
+    int payload_offset = 0;
+    bool last_packet = false;
+    while (!last_packet) {
+        CdiSgList packet_sgl = { 0 };
+        void* bounce_buffer_ptr = NULL;
+        CHECK(PayloadPacketizerPacketGet(state_ptr->protocol_handle, state_ptr->packetizer_state_handle,
+                                         state_ptr->header, state_ptr->con.tx_state.packet_sgl_entry_pool_handle,
+                                         bounce_buffer_pool_handle, payload_state_ptr, &packet_sgl,
+                                         &bounce_buffer_ptr, &last_packet));
+        CHECK(PacketCheck(state_ptr, &packet_sgl, last_packet, &payload_offset, ret_results_ptr));
+        CdiPoolPutAll(state_ptr->con.tx_state.packet_sgl_entry_pool_handle);
+        if (bounce_buffer_ptr) {
+            CHECK(NULL != bounce_buffer_pool_handle);
+            CdiPoolPut(bounce_buffer_pool_handle, bounce_buffer_ptr);
+        }
+
+        // Once this returns a non-zero value, the rest of the payload must be built from the plan.
+        const int packets_left = PayloadPacketizerParallelPacketsLeft(state_ptr->packetizer_state_handle);
+        if (packets_left) {
+            CHECK(!last_packet);
+            CHECK(PacketizeFromPlan(state_ptr, plan_handle, packets_left, &payload_offset, ret_results_ptr));
+            last_packet = true;
+        }
+    }
+    CHECK(TEST_PAYLOAD_SIZE == payload_offset);
+    CdiPoolPutAll(state_ptr->con.tx_state.payload_sgl_entry_pool_handle);
+
+    ret_results_ptr->bounced_byte_count = payload_state_ptr->payload_packet_state.bounced_byte_count;
+    ret_results_ptr->zero_copy_byte_count = payload_state_ptr->payload_packet_state.zero_copy_byte_count;
+
+    return true;
+}
+
+/**
+ * Check that two payloads were split into the same packets.
+ *
+ * @param results1_ptr Pointer to the results of the first payload.
+ * @param results2_ptr Pointer to the results of the second payload.
+ *
+ * @return true if the packets are the same, otherwise false.
+ */
+static bool SamePackets(const TestPacketizeResults* results1_ptr, const TestPacketizeResults* results2_ptr)
+{
+    CHECK(results1_ptr->packet_count == results2_ptr->packet_count);
+    for (int i = 0; i < results1_ptr->packet_count; i++) {
+        CHECK(results1_ptr->packet_size_array[i] == results2_ptr->packet_size_array[i]);
+        CHECK(results1_ptr->packet_entry_array[i] == results2_ptr->packet_entry_array[i]);
+    }
+    return true;
+}
+
+/**
+ * Test that coalescing small fragments into bounce buffers fills every packet, while large fragments are still sent
+ * without being copied.
+ *
+ * @param state_ptr Pointer to the state used by the test.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestCoalescing(TestPacketizerState* state_ptr)
+{
+    // Without coalescing, the packets of the small fragments are limited by the number of SGL entries.
+    TestPacketizeResults direct_results;
+    CHECK(Packetize(state_ptr, NULL, NULL, &direct_results));
+    CHECK(0 == direct_results.bounced_byte_count);
+    CHECK(TEST_PAYLOAD_SIZE == direct_results.zero_copy_byte_count);
+    CHECK(direct_results.short_packet_count > 0);
+
+    // With coalescing, every packet but the last is full and fewer packets are needed.
+    TestPacketizeResults coalesced_results;
+    CHECK(Packetize(state_ptr, NULL, state_ptr->bounce_buffer_pool_handle, &coalesced_results));
+    CHECK(0 == coalesced_results.short_packet_count);
+    CHECK(coalesced_results.packet_count < direct_results.packet_count);
+    CHECK(TEST_PAYLOAD_SIZE == coalesced_results.bounced_byte_count + coalesced_results.zero_copy_byte_count);
+    CHECK(coalesced_results.bounced_byte_count >=
+          (TEST_SMALL_FRAGMENTS_BEFORE + TEST_SMALL_FRAGMENTS_AFTER) * TEST_SMALL_FRAGMENT_SIZE);
+    CHECK(coalesced_results.zero_copy_byte_count > 0);
+
+    // All of the bounce buffers were returned.
+    CHECK(TEST_POOL_ITEM_COUNT == CdiPoolGetFreeItemCount(state_ptr->bounce_buffer_pool_handle));
+
+    return true;
+}
+
+/**
+ * Test that payloads with the same shape as the previous one are built from the stream's packetization plan, and that
+ * a change of shape causes the plan to be recorded again. The packets must be the same as without a plan.
+ *
+ * @param state_ptr Pointer to the state used by the test.
+ * @param plan_handle Packetization plan of the stream.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestPlanCacheWithPlan(TestPacketizerState* state_ptr, PacketizationPlanHandle plan_handle)
+{
+    TestPacketizeResults direct_results;
+    TestPacketizeResults plan_results;
+    CHECK(Packetize(state_ptr, NULL, NULL, &direct_results));
+    CHECK(direct_results.packet_count > 2);
+
+    // The first payload is recorded, the second one replayed. Only the first two packets of a replayed payload are
+    // obtained from the packetizer.
+    CHECK(Packetize(state_ptr, plan_handle, NULL, &plan_results));
+    CHECK(0 == plan_results.plan_packet_count);
+    CHECK(SamePackets(&direct_results, &plan_results));
+    for (int i = 0; i < 2; i++) {
+        CHECK(Packetize(state_ptr, plan_handle, NULL, &plan_results));
+        CHECK(direct_results.packet_count - 2 == plan_results.plan_packet_count);
+        CHECK(SamePackets(&direct_results, &plan_results));
+    }
+
+    // Changing the size of SGL entries changes the shape, even if the total size is the same.
+    CdiSglEntry* entry_array = state_ptr->source_entry_array;
+    entry_array[0].size_in_bytes -= 8;
+    entry_array[1].size_in_bytes += 8;
+    entry_array[1].address_ptr = (uint8_t*)entry_array[1].address_ptr - 8;
+    CHECK(Packetize(state_ptr, NULL, NULL, &direct_results));
+    CHECK(Packetize(state_ptr, plan_handle, NULL, &plan_results));
+    CHECK(0 == plan_results.plan_packet_count);
+    CHECK(SamePackets(&direct_results, &plan_results));
+    CHECK(Packetize(state_ptr, plan_handle, NULL, &plan_results));
+    CHECK(direct_results.packet_count - 2 == plan_results.plan_packet_count);
+    CHECK(SamePackets(&direct_results, &plan_results));
+
+    // So does changing the group size.
+    state_ptr->payload.group_size_bytes = 8;
+    CHECK(Packetize(state_ptr, NULL, NULL, &direct_results));
+    CHECK(Packetize(state_ptr, plan_handle, NULL, &plan_results));
+    CHECK(0 == plan_results.plan_packet_count);
+    CHECK(SamePackets(&direct_results, &plan_results));
+
+    // Restore the original shape.
+    state_ptr->payload.group_size_bytes = 0;
+    entry_array[0].size_in_bytes += 8;
+    entry_array[1].size_in_bytes -= 8;
+    entry_array[1].address_ptr = (uint8_t*)entry_array[1].address_ptr + 8;
+
+    return true;
+}
+
+/**
+ * Test the packetization plan cache using a new plan.
+ *
+ * @param state_ptr Pointer to the state used by the test.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestPlanCache(TestPacketizerState* state_ptr)
+{
+    PacketizationPlanHandle plan_handle = PayloadPacketizationPlanCreate();
+    CHECK(NULL != plan_handle);
+
+    bool pass = TestPlanCacheWithPlan(state_ptr, plan_handle);
+
+    PayloadPacketizationPlanDestroy(plan_handle);
+    return pass;
+}
+
+CdiReturnStatus TestUnitPacketizer(void)
+{
+    TestPacketizerState* state_ptr = CdiOsMemAllocZero(sizeof(TestPacketizerState));
+    if (NULL == state_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+
+    bool pass = TestStateCreate(state_ptr) && TestCoalescing(state_ptr) && TestPlanCache(state_ptr);
+
+    TestStateDestroy(state_ptr);
+    CdiOsMemFree(state_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
@@ -0,0 +1,158 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for pushing batches of items to a queue.
+ */
+
+#include "cdi_queue_api.h"
+
+#include <stdbool.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "utilities_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of items the fixed size queues used by the test are created with.
+#define TEST_QUEUE_ITEM_COUNT   (8)
+
+/// Number of items by which the growable queue used by the test grows.
+#define TEST_QUEUE_GROW_COUNT   (4)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * Pop the specified number of items from a queue and check that they hold consecutive values.
+ *
+ * @param handle Queue handle.
+ * @param first_value Value expected in the first item.
+ * @param count Number of items to pop.
+ *
+ * @return true if all of the items were popped and held the expected values, otherwise false.
+ */
+static bool PopAndCheck(CdiQueueHandle handle, int first_value, int count)
+{
+    for (int i = 0; i < count; i++) {
+        int value = -1;
+        CHECK(CdiQueuePop(handle, &value));
+        CHECK(first_value + i == value);
+    }
+    return true;
+}
+
+/**
+ * Test batch pushes to a fixed size queue, including batches that wrap around the end of the queue's entries and
+ * batches that fill it up.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestFixedQueue(void)
+{
+    CdiQueueHandle handle = NULL;
+    CHECK(CdiQueueCreate("TestQueueBatch", TEST_QUEUE_ITEM_COUNT, CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE,
+                         sizeof(int), kQueueSignalPopWait, &handle));
+
+    // Find how many items the queue holds by filling it with single pushes.
+    int capacity = 0;
+    while (CdiQueuePush(handle, &capacity)) {
+        capacity++;
+    }
+    CHECK(capacity >= TEST_QUEUE_ITEM_COUNT - 1);
+    CHECK(PopAndCheck(handle, 0, capacity));
+    CHECK(CdiQueueIsEmpty(handle));
+
+    int item_array[TEST_QUEUE_ITEM_COUNT * 2];
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(item_array); i++) {
+        item_array[i] = i;
+    }
+
+    // An empty batch does nothing and doesn't set the pop signal.
+    CdiOsSignalClear(CdiQueueGetPopWaitSignal(handle));
+    CHECK(0 == CdiQueuePushBatch(handle, item_array, 0));
+    CHECK(!CdiOsSignalGet(CdiQueueGetPopWaitSignal(handle)));
+
+    // Move the read and write pointers part way through the entries, so the next batch wraps around the end.
+    const int offset = capacity / 2 + 1;
+    CHECK(offset == CdiQueuePushBatch(handle, item_array, offset));
+    CHECK(CdiOsSignalGet(CdiQueueGetPopWaitSignal(handle)));
+    CHECK(PopAndCheck(handle, 0, offset));
+    CHECK(CdiQueueIsEmpty(handle));
+
+    // Fill the queue completely with a batch that wraps around. Only the items that fit are pushed.
+    CHECK(capacity == CdiQueuePushBatch(handle, item_array, CDI_ARRAY_ELEMENT_COUNT(item_array)));
+    CHECK(0 == CdiQueuePushBatch(handle, item_array, 1));
+    CHECK(!CdiQueuePush(handle, item_array));
+    CHECK(PopAndCheck(handle, 0, capacity));
+    CHECK(CdiQueueIsEmpty(handle));
+
+    // A batch that is larger than the room left is partially pushed, and the remaining items can then be pushed once
+    // the reader has made room.
+    CHECK(2 == CdiQueuePushBatch(handle, item_array, 2));
+    const int pushed_count = CdiQueuePushBatch(handle, item_array + 2, capacity);
+    CHECK(capacity - 2 == pushed_count);
+    CHECK(PopAndCheck(handle, 0, 2));
+    CHECK(2 == CdiQueuePushBatch(handle, item_array + 2 + pushed_count, capacity - pushed_count));
+    CHECK(PopAndCheck(handle, 2, capacity));
+    CHECK(CdiQueueIsEmpty(handle));
+
+    CdiQueueDestroy(handle);
+    return true;
+}
+
+/**
+ * Test a batch push to a queue that has to grow to hold the whole batch.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestGrowableQueue(void)
+{
+    CdiQueueHandle handle = NULL;
+    CHECK(CdiQueueCreate("TestQueueBatchGrow", TEST_QUEUE_ITEM_COUNT, TEST_QUEUE_GROW_COUNT, 2, sizeof(int),
+                         kQueueSignalNone, &handle));
+
+    // Start part way through the entries, so the queue grows while the batch wraps around the end.
+    int item_array[TEST_QUEUE_ITEM_COUNT + TEST_QUEUE_GROW_COUNT];
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(item_array); i++) {
+        item_array[i] = i;
+    }
+    CHECK(3 == CdiQueuePushBatch(handle, item_array, 3));
+    CHECK(PopAndCheck(handle, 0, 3));
+
+    // The whole batch is pushed, since the queue grows as needed. The items pushed before it grew must stay in order
+    // with the ones pushed after.
+    CHECK(CDI_ARRAY_ELEMENT_COUNT(item_array) ==
+          CdiQueuePushBatch(handle, item_array, CDI_ARRAY_ELEMENT_COUNT(item_array)));
+    CHECK(PopAndCheck(handle, 0, CDI_ARRAY_ELEMENT_COUNT(item_array)));
+    CHECK(CdiQueueIsEmpty(handle));
+
+    CdiQueueDestroy(handle);
+    return true;
+}
+
+CdiReturnStatus TestUnitQueue(void)
+{
+    if (!TestFixedQueue() || !TestGrowableQueue()) {
+        return kCdiStatusFatal;
+    }
+    return kCdiStatusOk;
+}
@@ -0,0 +1,293 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the tracking and reporting of partially received Rx payloads.
+ */
+
+#include "internal_rx.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "private.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Size in bytes of the payloads used by the test.
+#define TEST_PAYLOAD_SIZE       (4000)
+
+/// Size in bytes of the CDI header of the packets used by the test. It is not part of the payload's data.
+#define TEST_HEADER_SIZE        (20)
+
+/// Value of the core extra data sent with every payload.
+#define TEST_PAYLOAD_USER_DATA  (0x1234)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the test. Only the members used to track the progress of a payload are set.
+ */
+typedef struct {
+    CdiConnectionState con_state;           ///< The connection.
+    RxPayloadState payload_state;           ///< State of the payload being received.
+    uint8_t data_array[TEST_PAYLOAD_SIZE];  ///< Linear receive buffer of the payload.
+    int callback_count;                     ///< Number of times the progress callback function was invoked.
+    CdiCoreRxProgressCbData last_cb_data;   ///< Copy of the data passed to the progress callback function last.
+} TestProgressState;
+
+/**
+ * Progress callback function of the test. Records the data it is invoked with.
+ *
+ * @param data_ptr Pointer to progress callback data.
+ */
+static void TestProgressCallback(const CdiCoreRxProgressCbData* data_ptr)
+{
+    TestProgressState* test_ptr = (TestProgressState*)data_ptr->core_cb_data.user_cb_param;
+    test_ptr->callback_count++;
+    test_ptr->last_cb_data = *data_ptr;
+}
+
+/**
+ * Reset the payload state and the recorded callback data for the next payload.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param payload_state Initial state of the payload.
+ */
+static void TestPayloadStart(TestProgressState* test_ptr, CdiPayloadState payload_state)
+{
+    RxPayloadState* payload_state_ptr = &test_ptr->payload_state;
+    memset(payload_state_ptr, 0, sizeof(*payload_state_ptr));
+    payload_state_ptr->payload_state = payload_state;
+    payload_state_ptr->expected_payload_data_size = TEST_PAYLOAD_SIZE;
+    payload_state_ptr->linear_buffer_ptr = test_ptr->data_array;
+    payload_state_ptr->work_request_state.app_payload_cb_data.core_extra_data.payload_user_data =
+        TEST_PAYLOAD_USER_DATA;
+    test_ptr->callback_count = 0;
+    memset(&test_ptr->last_cb_data, 0, sizeof(test_ptr->last_cb_data));
+}
+
+/**
+ * Pass a packet to RxProgressUpdate().
+ *
+ * @param test_ptr Pointer to test state.
+ * @param offset Offset in the payload of the packet's data. Packet #0 is used for offset 0.
+ * @param size Number of bytes of payload data in the packet.
+ */
+static void TestPacketReceive(TestProgressState* test_ptr, int offset, int size)
+{
+    Packet packet;
+    memset(&packet, 0, sizeof(packet));
+    packet.sg_list.total_data_size = TEST_HEADER_SIZE + size;
+
+    CdiDecodedPacketHeader header;
+    memset(&header, 0, sizeof(header));
+    header.encoded_header_size = TEST_HEADER_SIZE;
+    if (offset) {
+        header.payload_type = kPayloadTypeDataOffset;
+        header.data_offset_info.payload_data_offset = offset;
+    } else {
+        header.payload_type = kPayloadTypeData;
+        header.num0_info.total_payload_size = TEST_PAYLOAD_SIZE;
+    }
+    RxProgressUpdate(&test_ptr->con_state, &packet, &test_ptr->payload_state, &header);
+}
+
+/**
+ * Test a payload whose packets arrive in order.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestInOrder(TestProgressState* test_ptr)
+{
+    TestPayloadStart(test_ptr, kPayloadInProgress);
+
+    // Progress is only reported once the received part has grown by the step size.
+    TestPacketReceive(test_ptr, 0, 500);
+    CHECK(0 == test_ptr->callback_count);
+    TestPacketReceive(test_ptr, 500, 500);
+    CHECK(1 == test_ptr->callback_count);
+    const CdiCoreRxProgressCbData* cb_data_ptr = &test_ptr->last_cb_data;
+    CHECK(1000 == cb_data_ptr->received_byte_count);
+    CHECK(TEST_PAYLOAD_SIZE == cb_data_ptr->payload_size);
+    CHECK(kCdiStatusOk == cb_data_ptr->core_cb_data.status_code);
+    CHECK((CdiConnectionHandle)&test_ptr->con_state == cb_data_ptr->core_cb_data.connection_handle);
+    CHECK(TEST_PAYLOAD_USER_DATA == cb_data_ptr->core_cb_data.core_extra_data.payload_user_data);
+    CHECK(test_ptr->data_array == cb_data_ptr->linear_buffer_ptr);
+    CHECK(NULL == cb_data_ptr->sgl_head_ptr);
+
+    TestPacketReceive(test_ptr, 1000, 700);
+    CHECK(1 == test_ptr->callback_count);
+    TestPacketReceive(test_ptr, 1700, 700);
+    CHECK(2 == test_ptr->callback_count);
+    CHECK(2400 == test_ptr->last_cb_data.received_byte_count);
+    TestPacketReceive(test_ptr, 2400, 1000);
+    CHECK(3 == test_ptr->callback_count);
+    CHECK(3400 == test_ptr->last_cb_data.received_byte_count);
+
+    // Completing the payload is not reported; the payload is delivered as usual.
+    TestPacketReceive(test_ptr, 3400, 600);
+    CHECK(3 == test_ptr->callback_count);
+    CHECK(TEST_PAYLOAD_SIZE == test_ptr->payload_state.progress_byte_count);
+
+    return true;
+}
+
+/**
+ * Test a payload whose packets arrive out of order, using scatter-gather receive buffers.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestOutOfOrder(TestProgressState* test_ptr)
+{
+    TestPayloadStart(test_ptr, kPayloadInProgress);
+    RxPayloadState* payload_state_ptr = &test_ptr->payload_state;
+    payload_state_ptr->linear_buffer_ptr = NULL;
+
+    // The first reorder list holds the packets received in order from packet #0.
+    CdiSglEntry sgl_entry = { .address_ptr = test_ptr->data_array, .size_in_bytes = 500 };
+    CdiReorderList reorder_list;
+    memset(&reorder_list, 0, sizeof(reorder_list));
+    reorder_list.sglist.sgl_head_ptr = &sgl_entry;
+    reorder_list.sglist.sgl_tail_ptr = &sgl_entry;
+    payload_state_ptr->reorder_list_ptr = &reorder_list;
+
+    // Ranges received ahead of a gap are remembered, but don't count.
+    TestPacketReceive(test_ptr, 0, 500);
+    TestPacketReceive(test_ptr, 1500, 500);
+    TestPacketReceive(test_ptr, 1000, 500);
+    TestPacketReceive(test_ptr, 2500, 500);
+    CHECK(0 == test_ptr->callback_count);
+    CHECK(500 == payload_state_ptr->progress_byte_count);
+    CHECK(3 == payload_state_ptr->progress_range_count);
+
+    // Filling the first gap moves the received part up to the second gap, in a single report.
+    TestPacketReceive(test_ptr, 500, 500);
+    CHECK(1 == test_ptr->callback_count);
+    CHECK(2000 == test_ptr->last_cb_data.received_byte_count);
+    CHECK(NULL == test_ptr->last_cb_data.linear_buffer_ptr);
+    CHECK(&sgl_entry == test_ptr->last_cb_data.sgl_head_ptr);
+    CHECK(1 == payload_state_ptr->progress_range_count);
+
+    TestPacketReceive(test_ptr, 2000, 500);
+    CHECK(2 == test_ptr->callback_count);
+    CHECK(3000 == test_ptr->last_cb_data.received_byte_count);
+    CHECK(0 == payload_state_ptr->progress_range_count);
+
+    return true;
+}
+
+/**
+ * Test a payload whose packet #0 arrives after other packets. Its size is not known until then.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestPacketZeroLate(TestProgressState* test_ptr)
+{
+    TestPayloadStart(test_ptr, kPayloadPacketZeroPending);
+    RxPayloadState* payload_state_ptr = &test_ptr->payload_state;
+    payload_state_ptr->expected_payload_data_size = 0;
+
+    TestPacketReceive(test_ptr, 500, 1000);
+    TestPacketReceive(test_ptr, 1500, 1000);
+    CHECK(0 == test_ptr->callback_count);
+
+    // Receiving packet #0 makes the payload's size known (done by the caller of RxProgressUpdate()).
+    payload_state_ptr->payload_state = kPayloadInProgress;
+    payload_state_ptr->expected_payload_data_size = TEST_PAYLOAD_SIZE;
+    TestPacketReceive(test_ptr, 0, 500);
+    CHECK(1 == test_ptr->callback_count);
+    CHECK(2500 == test_ptr->last_cb_data.received_byte_count);
+
+    return true;
+}
+
+/**
+ * Test a payload that has more ranges received ahead of a gap than can be remembered. Progress must stop at the start
+ * of the first range that was not remembered, never go beyond it.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestTooManyRanges(TestProgressState* test_ptr)
+{
+    const int packet_size = 10;
+    TestPayloadStart(test_ptr, kPayloadInProgress);
+    test_ptr->con_state.rx_state.config_data.progress_step_bytes = packet_size;
+    RxPayloadState* payload_state_ptr = &test_ptr->payload_state;
+
+    // Receive every other packet after packet #0, one more than can be remembered.
+    TestPacketReceive(test_ptr, 0, packet_size);
+    CHECK(1 == test_ptr->callback_count);
+    for (int i = 0; i <= RX_PROGRESS_MAX_PENDING_RANGES; i++) {
+        TestPacketReceive(test_ptr, (2 + 2 * i) * packet_size, packet_size);
+    }
+    CHECK(RX_PROGRESS_MAX_PENDING_RANGES == payload_state_ptr->progress_range_count);
+
+    // Fill the gaps in order. Each one moves the received part up to the end of the range that follows it.
+    for (int i = 0; i < RX_PROGRESS_MAX_PENDING_RANGES; i++) {
+        TestPacketReceive(test_ptr, (1 + 2 * i) * packet_size, packet_size);
+        CHECK(2 + i == test_ptr->callback_count);
+        CHECK((3 + 2 * i) * packet_size == test_ptr->last_cb_data.received_byte_count);
+    }
+    CHECK(0 == payload_state_ptr->progress_range_count);
+
+    // Filling the last gap only reaches the start of the range that was not remembered.
+    const int gap_offset = (1 + 2 * RX_PROGRESS_MAX_PENDING_RANGES) * packet_size;
+    TestPacketReceive(test_ptr, gap_offset, packet_size);
+    CHECK(RX_PROGRESS_MAX_PENDING_RANGES + 2 == test_ptr->callback_count);
+    CHECK(gap_offset + packet_size == test_ptr->last_cb_data.received_byte_count);
+    CHECK(gap_offset + packet_size == payload_state_ptr->progress_byte_count);
+
+    return true;
+}
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+CdiReturnStatus TestUnitRxProgress(void)
+{
+    TestProgressState* test_ptr = CdiOsMemAllocZero(sizeof(TestProgressState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    CdiRxConfigData* config_data_ptr = &test_ptr->con_state.rx_state.config_data;
+    config_data_ptr->progress_cb_ptr = TestProgressCallback;
+    config_data_ptr->progress_step_bytes = 1000;
+    config_data_ptr->user_cb_param = test_ptr;
+
+    bool pass = TestInOrder(test_ptr) && TestOutOfOrder(test_ptr) && TestPacketZeroLate(test_ptr) &&
+                TestTooManyRanges(test_ptr);
+
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
@@ -31,6 +31,38 @@
 /// @brief A modulus used for generating a random list length.
 #define TEST_UNIT_RX_REORDER_RAND_LEN 3
 
+/// @brief Number of packets of the payload that is too large for a reorder bitmap.
+#define TEST_UNIT_RX_REORDER_BITMAP_LARGE_PACKETS (RX_REORDER_BITMAP_MAX_PACKETS + 100)
+
+/// @brief Size in bytes of the packets used by the reorder bitmap tests. The packets only hold a CDI header.
+#define TEST_UNIT_RX_REORDER_BITMAP_PACKET_SIZE CDI_RAW_PACKET_HEADER_SIZE_V1
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief Pools and packets used by the reorder bitmap tests.
+ */
+typedef struct {
+    CdiProtocolHandle protocol_handle;      ///< Handle of the protocol used to read the packet headers.
+    CdiPoolHandle sgl_entry_pool_handle;    ///< Pool of payload SGL entries.
+    CdiPoolHandle list_pool_handle;         ///< Pool of reorder lists.
+    CdiPoolHandle bitmap_pool_handle;       ///< Pool of reorder bitmaps.
+    CdiPoolHandle block_pool_handle;        ///< Pool of reorder bitmap blocks.
+    uint8_t* packet_data_ptr;               ///< Memory of the packets, in sequence number order.
+    CdiSglEntry packet_entry;               ///< SGL entry of the packet being added.
+    CdiSgList packet_sgl;                   ///< SGL of the packet being added.
+} TestBitmapState;
+
 //*********************************************************************************************************************
 //*********************************************** START OF VARIABLES **************************************************
 //*********************************************************************************************************************
@@ -39,6 +71,260 @@
 //******************************************* START OF STATIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
 
+/**
+ * Create the pools used by a reorder bitmap test. The pools don't grow.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param bitmap_count Number of reorder bitmaps.
+ * @param block_count Number of reorder bitmap blocks.
+ *
+ * @return True if the pools were created.
+ */
+static bool TestBitmapPoolsCreate(TestBitmapState* test_ptr, int bitmap_count, int block_count)
+{
+    // Every packet may end up in its own reorder list.
+    return CdiPoolCreate("Test SGL Entry Pool", TEST_UNIT_RX_REORDER_BITMAP_LARGE_PACKETS, NO_GROW_SIZE, NO_GROW_COUNT,
+                         sizeof(CdiSglEntry), false, &test_ptr->sgl_entry_pool_handle) &&
+           CdiPoolCreate("Test Reorder List Pool", TEST_UNIT_RX_REORDER_BITMAP_LARGE_PACKETS, NO_GROW_SIZE,
+                         NO_GROW_COUNT, sizeof(CdiReorderList), false, &test_ptr->list_pool_handle) &&
+           CdiPoolCreate("Test Reorder Bitmap Pool", bitmap_count, NO_GROW_SIZE, NO_GROW_COUNT,
+                         sizeof(RxReorderBitmap), false, &test_ptr->bitmap_pool_handle) &&
+           CdiPoolCreate("Test Reorder Bitmap Block Pool", block_count, NO_GROW_SIZE, NO_GROW_COUNT,
+                         sizeof(RxReorderBitmapBlock), false, &test_ptr->block_pool_handle);
+}
+
+/**
+ * Check that all of the items of the pools used by a reorder bitmap test have been returned and destroy the pools.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return True if no item was leaked.
+ */
+static bool TestBitmapPoolsDestroy(TestBitmapState* test_ptr)
+{
+    CdiPoolHandle pool_array[] = {
+        test_ptr->sgl_entry_pool_handle, test_ptr->list_pool_handle, test_ptr->bitmap_pool_handle,
+        test_ptr->block_pool_handle
+    };
+    bool ret = true;
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(pool_array); i++) {
+        if (pool_array[i]) {
+            if (CdiPoolGetFreeItemCount(pool_array[i]) != CdiPoolGetTotalItemCount(pool_array[i])) {
+                CDI_LOG_THREAD(kLogError, "Pool[%s] has items in use.", CdiPoolGetName(pool_array[i]));
+                ret = false;
+            }
+            CdiPoolDestroy(pool_array[i]);
+        }
+    }
+    test_ptr->sgl_entry_pool_handle = NULL;
+    test_ptr->list_pool_handle = NULL;
+    test_ptr->bitmap_pool_handle = NULL;
+    test_ptr->block_pool_handle = NULL;
+    return ret;
+}
+
+/**
+ * Add a packet to a payload. The first packet of a payload initializes its reorder state.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param payload_state_ptr Pointer to the state of the payload.
+ * @param sequence_num Sequence number of the packet.
+ *
+ * @return The value returned by RxReorderPacketPayloadStateInit() or RxReorderPacket().
+ */
+static bool TestBitmapPacketAdd(TestBitmapState* test_ptr, RxPayloadState* payload_state_ptr, int sequence_num)
+{
+    test_ptr->packet_entry.address_ptr = test_ptr->packet_data_ptr +
+                                         sequence_num * TEST_UNIT_RX_REORDER_BITMAP_PACKET_SIZE;
+    test_ptr->packet_entry.size_in_bytes = TEST_UNIT_RX_REORDER_BITMAP_PACKET_SIZE;
+    test_ptr->packet_entry.next_ptr = NULL;
+    test_ptr->packet_sgl.total_data_size = TEST_UNIT_RX_REORDER_BITMAP_PACKET_SIZE;
+    test_ptr->packet_sgl.sgl_head_ptr = &test_ptr->packet_entry;
+    test_ptr->packet_sgl.sgl_tail_ptr = &test_ptr->packet_entry;
+
+    // The whole packet is used as payload data, so the SGL entries can be checked using their addresses.
+    if (NULL == payload_state_ptr->reorder_bitmap_ptr && NULL == payload_state_ptr->reorder_list_ptr) {
+        return RxReorderPacketPayloadStateInit(test_ptr->protocol_handle, test_ptr->sgl_entry_pool_handle,
+                                               test_ptr->list_pool_handle, test_ptr->bitmap_pool_handle,
+                                               test_ptr->block_pool_handle, payload_state_ptr, &test_ptr->packet_sgl,
+                                               0, sequence_num);
+    }
+    return RxReorderPacket(test_ptr->protocol_handle, test_ptr->sgl_entry_pool_handle, test_ptr->list_pool_handle,
+                           test_ptr->bitmap_pool_handle, test_ptr->block_pool_handle, payload_state_ptr,
+                           &test_ptr->packet_sgl, 0, sequence_num);
+}
+
+/**
+ * Get the SGL of a complete payload, check that it holds all of its packets in order and free it.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param payload_state_ptr Pointer to the state of the payload.
+ * @param packet_count Number of packets in the payload.
+ *
+ * @return True if the SGL is correct.
+ */
+static bool TestBitmapPayloadCheck(TestBitmapState* test_ptr, RxPayloadState* payload_state_ptr, int packet_count)
+{
+    CHECK(packet_count * TEST_UNIT_RX_REORDER_BITMAP_PACKET_SIZE == payload_state_ptr->data_bytes_received);
+    CdiSgList payload_sgl = { 0 };
+    CHECK(RxReorderPacketPayloadSglGet(test_ptr->list_pool_handle, test_ptr->bitmap_pool_handle,
+                                       test_ptr->block_pool_handle, payload_state_ptr, &payload_sgl));
+    CHECK(NULL == payload_state_ptr->reorder_bitmap_ptr && NULL == payload_state_ptr->reorder_list_ptr);
+
+    int i = 0;
+    bool ordered = true;
+    for (const CdiSglEntry* entry_ptr = payload_sgl.sgl_head_ptr; entry_ptr; entry_ptr = entry_ptr->next_ptr) {
+        ordered = ordered && entry_ptr->address_ptr ==
+                             test_ptr->packet_data_ptr + i * TEST_UNIT_RX_REORDER_BITMAP_PACKET_SIZE;
+        ordered = ordered && (NULL != entry_ptr->next_ptr || entry_ptr == payload_sgl.sgl_tail_ptr);
+        i++;
+    }
+    FreeSglEntries(test_ptr->sgl_entry_pool_handle, payload_sgl.sgl_head_ptr);
+    CHECK(ordered);
+    CHECK(packet_count == i);
+    return true;
+}
+
+/**
+ * Test that duplicate packets are ignored by a payload using a reorder bitmap.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return True if the test passed.
+ */
+static bool TestBitmapDuplicates(TestBitmapState* test_ptr)
+{
+    RxPayloadState payload_state = { 0 };
+    CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, 2));
+    CHECK(NULL != payload_state.reorder_bitmap_ptr);
+    CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, 0));
+    const int free_count = CdiPoolGetFreeItemCount(test_ptr->sgl_entry_pool_handle);
+
+    // Both a packet linked in order and one waiting for a gap to be filled.
+    CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, 0));
+    CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, 2));
+    CHECK(free_count == CdiPoolGetFreeItemCount(test_ptr->sgl_entry_pool_handle));
+    CHECK(2 * TEST_UNIT_RX_REORDER_BITMAP_PACKET_SIZE == payload_state.data_bytes_received);
+
+    CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, 1));
+    CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, 1));
+    return TestBitmapPayloadCheck(test_ptr, &payload_state, 3);
+}
+
+/**
+ * Test a payload with more packets than fit in a reorder bitmap. It must be moved to the reorder lists when the first
+ * packet beyond the bitmap arrives, keeping the packets received so far.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return True if the test passed.
+ */
+static bool TestBitmapTooManyPackets(TestBitmapState* test_ptr)
+{
+    RxPayloadState payload_state = { 0 };
+
+    // Every other packet, so each one becomes its own reorder list.
+    for (int i = 1; i < RX_REORDER_BITMAP_MAX_PACKETS; i += 2) {
+        CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, i));
+    }
+    CHECK(NULL != payload_state.reorder_bitmap_ptr);
+    for (int i = RX_REORDER_BITMAP_MAX_PACKETS; i < TEST_UNIT_RX_REORDER_BITMAP_LARGE_PACKETS; i++) {
+        CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, i));
+        CHECK(NULL == payload_state.reorder_bitmap_ptr);
+    }
+    // The bitmap and all of its blocks have been returned.
+    CHECK(CdiPoolGetTotalItemCount(test_ptr->bitmap_pool_handle) ==
+          CdiPoolGetFreeItemCount(test_ptr->bitmap_pool_handle));
+    CHECK(CdiPoolGetTotalItemCount(test_ptr->block_pool_handle) ==
+          CdiPoolGetFreeItemCount(test_ptr->block_pool_handle));
+
+    for (int i = 0; i < RX_REORDER_BITMAP_MAX_PACKETS; i += 2) {
+        CHECK(TestBitmapPacketAdd(test_ptr, &payload_state, i));
+    }
+    return TestBitmapPayloadCheck(test_ptr, &payload_state, TEST_UNIT_RX_REORDER_BITMAP_LARGE_PACKETS);
+}
+
+/**
+ * Test that payloads use the reorder lists when no reorder bitmap is available, and that a payload using a bitmap is
+ * moved to the reorder lists when no block is available for a packet.
+ *
+ * @param test_ptr Pointer to test state. Its pools must have one bitmap and two blocks.
+ *
+ * @return True if the test passed.
+ */
+static bool TestBitmapPoolsExhausted(TestBitmapState* test_ptr)
+{
+    const int packet_count = 3 * RX_REORDER_BITMAP_BLOCK_PACKETS;
+    RxPayloadState first_payload_state = { 0 };
+    RxPayloadState second_payload_state = { 0 };
+
+    CHECK(TestBitmapPacketAdd(test_ptr, &first_payload_state, 1));
+    CHECK(NULL != first_payload_state.reorder_bitmap_ptr);
+    CHECK(TestBitmapPacketAdd(test_ptr, &second_payload_state, 1));
+    CHECK(NULL == second_payload_state.reorder_bitmap_ptr && NULL != second_payload_state.reorder_list_ptr);
+
+    // The packet of the second block takes the last block, the one of the third block finds none.
+    CHECK(TestBitmapPacketAdd(test_ptr, &first_payload_state, RX_REORDER_BITMAP_BLOCK_PACKETS + 1));
+    CHECK(NULL != first_payload_state.reorder_bitmap_ptr);
+    CHECK(0 == CdiPoolGetFreeItemCount(test_ptr->block_pool_handle));
+    CHECK(TestBitmapPacketAdd(test_ptr, &first_payload_state, 2 * RX_REORDER_BITMAP_BLOCK_PACKETS + 1));
+    CHECK(NULL == first_payload_state.reorder_bitmap_ptr);
+    CHECK(2 == CdiPoolGetFreeItemCount(test_ptr->block_pool_handle));
+
+    for (int i = 0; i < packet_count; i++) {
+        if (1 != i % RX_REORDER_BITMAP_BLOCK_PACKETS) {
+            CHECK(TestBitmapPacketAdd(test_ptr, &first_payload_state, i));
+        }
+    }
+    CHECK(TestBitmapPayloadCheck(test_ptr, &first_payload_state, packet_count));
+
+    // The second payload is still complete using the reorder lists, in reverse order.
+    for (int i = packet_count - 1; i >= 0; i--) {
+        if (1 != i) {
+            CHECK(TestBitmapPacketAdd(test_ptr, &second_payload_state, i));
+        }
+    }
+    CHECK(TestBitmapPayloadCheck(test_ptr, &second_payload_state, packet_count));
+
+    // Freeing a payload that is not complete returns its bitmap and blocks.
+    CHECK(TestBitmapPacketAdd(test_ptr, &first_payload_state, RX_REORDER_BITMAP_BLOCK_PACKETS));
+    CHECK(TestBitmapPacketAdd(test_ptr, &first_payload_state, 0));
+    CHECK(NULL != first_payload_state.reorder_bitmap_ptr);
+    RxReorderPacketPayloadStateFree(test_ptr->sgl_entry_pool_handle, test_ptr->list_pool_handle,
+                                    test_ptr->bitmap_pool_handle, test_ptr->block_pool_handle,
+                                    &first_payload_state);
+    CHECK(NULL == first_payload_state.reorder_bitmap_ptr);
+    return true;
+}
+
+/**
+ * Run the tests of the reorder bitmap, each with its own pools.
+ *
+ * @param protocol_handle Handle of the protocol used to read the packet headers.
+ *
+ * @return True if the tests passed.
+ */
+static bool TestBitmap(CdiProtocolHandle protocol_handle)
+{
+    TestBitmapState test = { .protocol_handle = protocol_handle };
+    test.packet_data_ptr = CdiOsMemAllocZero(TEST_UNIT_RX_REORDER_BITMAP_LARGE_PACKETS *
+                                             TEST_UNIT_RX_REORDER_BITMAP_PACKET_SIZE);
+    if (NULL == test.packet_data_ptr) {
+        return false;
+    }
+
+    const int all_blocks = RX_REORDER_BITMAP_MAX_PACKETS / RX_REORDER_BITMAP_BLOCK_PACKETS;
+    bool pass = TestBitmapPoolsCreate(&test, 1, all_blocks) && TestBitmapDuplicates(&test);
+    pass = TestBitmapPoolsDestroy(&test) && pass;
+    pass = pass && TestBitmapPoolsCreate(&test, 1, all_blocks) && TestBitmapTooManyPackets(&test);
+    pass = TestBitmapPoolsDestroy(&test) && pass;
+    pass = pass && TestBitmapPoolsCreate(&test, 1, 2) && TestBitmapPoolsExhausted(&test);
+    pass = TestBitmapPoolsDestroy(&test) && pass;
+
+    CdiOsMemFree(test.packet_data_ptr);
+    return pass;
+}
+
 //*********************************************************************************************************************
 //******************************************* START OF PUBLIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
@@ -98,13 +384,30 @@ CdiReturnStatus TestUnitRxReorderPackets(void)
     }
 
     if (kCdiStatusOk == rs) {
-        if (!CdiPoolCreate("Rx CdiReorderList Out of Order Pool", MAX_RX_OUT_OF_ORDER, MAX_RX_OUT_OF_ORDER_GROW,
-                           MAX_POOL_GROW_COUNT, sizeof(CdiReorderList), true, // true= Make thread-safe
+        if (!CdiPoolCreate("Rx CdiReorderList Out of Order Pool", CDI_RX_REORDER_LIST_POOL_DEFAULT_SIZE,
+                           MAX_RX_OUT_OF_ORDER_GROW, MAX_POOL_GROW_COUNT, sizeof(CdiReorderList),
+                           true, // true= Make thread-safe
                            &con_state_ptr->rx_state.reorder_entries_pool_handle)) {
             rs = kCdiStatusNotEnoughMemory;
         }
     }
 
+    if (kCdiStatusOk == rs) {
+        if (!CdiPoolCreate("Rx RxReorderBitmap Pool", 1, NO_GROW_SIZE, NO_GROW_COUNT, sizeof(RxReorderBitmap),
+                           true, // true= Make thread-safe
+                           &con_state_ptr->rx_state.reorder_bitmap_pool_handle)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        if (!CdiPoolCreate("Rx RxReorderBitmapBlock Pool", 1, NO_GROW_SIZE, NO_GROW_COUNT,
+                           sizeof(RxReorderBitmapBlock), true, // true= Make thread-safe
+                           &con_state_ptr->rx_state.reorder_bitmap_block_pool_handle)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
     if (kCdiStatusOk == ret) {
         // Initialize the sequence numbers.
         int j=0;
@@ -174,61 +477,87 @@ CdiReturnStatus TestUnitRxReorderPackets(void)
             }
         }
 
-        new_sgl_list_ptr = &sgl_list_pool[0];
-        CdiDecodedPacketHeader decoded_header = { 0 };
-        ProtocolPayloadHeaderDecode(protocol_handle, new_sgl_list_ptr->sgl_head_ptr->address_ptr,
-                                    new_sgl_list_ptr->sgl_head_ptr->size_in_bytes, &decoded_header);
-        int cdi_header_size = decoded_header.encoded_header_size;
-        int packet_sequence_num = decoded_header.packet_sequence_num;
-
-        rx_ret = RxReorderPacketPayloadStateInit(protocol_handle,
-                                                 con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
-                                                 con_state_ptr->rx_state.reorder_entries_pool_handle,
-                                                 payload_state_ptr, new_sgl_list_ptr, cdi_header_size,
-                                                 packet_sequence_num);
-
-        for (int i=1; rx_ret && i!=TEST_UNIT_RX_REORDER_NUM_SGLS; i++) {
-            new_sgl_list_ptr = &sgl_list_pool[i];
-            CdiPacketRxReorderInfo reorder_info;
-            ProtocolPayloadPacketRxReorderInfo(protocol_handle, new_sgl_list_ptr->sgl_head_ptr->address_ptr,
-                                               &reorder_info);
-            int packet_sequence_num = reorder_info.packet_sequence_num;
-            rx_ret = RxReorderPacket(protocol_handle, con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
-                                     con_state_ptr->rx_state.reorder_entries_pool_handle, payload_state_ptr,
-                                     new_sgl_list_ptr, cdi_header_size, packet_sequence_num);
-        }
-        if (NULL != payload_state_ptr->reorder_list_ptr->next_ptr &&
-            NULL != payload_state_ptr->reorder_list_ptr->prev_ptr) {
-            CDI_LOG_THREAD(kLogError, "Test finished and there are dangling lists.");
-            CdiReorderList* reorder_list_ptr = payload_state_ptr->reorder_list_ptr;
-            while (reorder_list_ptr) {
-                CDI_LOG_THREAD(kLogDebug, "Dangling list [%d-%d].", reorder_list_ptr->top_sequence_num,
-                               reorder_list_ptr->bot_sequence_num);
-                reorder_list_ptr = reorder_list_ptr->next_ptr;
+        // Run the test using the reorder lists first and then using a reorder bitmap.
+        for (int pass = 0; kCdiStatusOk == rs && pass != 2; pass++) {
+            CdiPoolHandle reorder_bitmap_pool_handle = (0 == pass) ? NULL :
+                                                       con_state_ptr->rx_state.reorder_bitmap_pool_handle;
+            new_sgl_list_ptr = &sgl_list_pool[0];
+            CdiDecodedPacketHeader decoded_header = { 0 };
+            ProtocolPayloadHeaderDecode(protocol_handle, new_sgl_list_ptr->sgl_head_ptr->address_ptr,
+                                        new_sgl_list_ptr->sgl_head_ptr->size_in_bytes, &decoded_header);
+            int cdi_header_size = decoded_header.encoded_header_size;
+            int packet_sequence_num = decoded_header.packet_sequence_num;
+
+            rx_ret = RxReorderPacketPayloadStateInit(protocol_handle,
+                                                     con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
+                                                     con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                                     reorder_bitmap_pool_handle,
+                                                     con_state_ptr->rx_state.reorder_bitmap_block_pool_handle,
+                                                     payload_state_ptr, new_sgl_list_ptr, cdi_header_size,
+                                                     packet_sequence_num);
+            if (rx_ret && (NULL == reorder_bitmap_pool_handle) != (NULL == payload_state_ptr->reorder_bitmap_ptr)) {
+                CDI_LOG_THREAD(kLogError, "Pass[%d] is not using the expected reorder engine.", pass);
+                rs = kCdiStatusFatal;
+            }
+
+            for (int i=1; rx_ret && i!=TEST_UNIT_RX_REORDER_NUM_SGLS; i++) {
+                new_sgl_list_ptr = &sgl_list_pool[i];
+                CdiPacketRxReorderInfo reorder_info;
+                ProtocolPayloadPacketRxReorderInfo(protocol_handle, new_sgl_list_ptr->sgl_head_ptr->address_ptr,
+                                                   &reorder_info);
+                int packet_sequence_num = reorder_info.packet_sequence_num;
+                rx_ret = RxReorderPacket(protocol_handle, con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
+                                         con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                         reorder_bitmap_pool_handle,
+                                         con_state_ptr->rx_state.reorder_bitmap_block_pool_handle, payload_state_ptr,
+                                         new_sgl_list_ptr, cdi_header_size, packet_sequence_num);
+            }
+
+            CdiSgList payload_sgl = { 0 };
+            if (!rx_ret) {
+                CDI_LOG_THREAD(kLogError, "Pass[%d] failed to reorder packets.", pass);
+                rs = kCdiStatusFatal;
+            } else if (!RxReorderPacketPayloadSglGet(con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                                     reorder_bitmap_pool_handle,
+                                                     con_state_ptr->rx_state.reorder_bitmap_block_pool_handle,
+                                                     payload_state_ptr, &payload_sgl)) {
+                CDI_LOG_THREAD(kLogError, "Pass[%d] finished and there are dangling packets.", pass);
+                CdiReorderList* reorder_list_ptr = payload_state_ptr->reorder_list_ptr;
+                while (reorder_list_ptr) {
+                    CDI_LOG_THREAD(kLogDebug, "Dangling list [%d-%d].", reorder_list_ptr->top_sequence_num,
+                                   reorder_list_ptr->bot_sequence_num);
+                    reorder_list_ptr = reorder_list_ptr->next_ptr;
+                }
+                rs = kCdiStatusFatal;
             }
-            rs = kCdiStatusFatal;
+            // get rid of everything
+            FreeSglEntries(con_state_ptr->rx_state.payload_sgl_entry_pool_handle, payload_sgl.sgl_head_ptr);
+            RxReorderPacketPayloadStateFree(con_state_ptr->rx_state.payload_sgl_entry_pool_handle,
+                                            con_state_ptr->rx_state.reorder_entries_pool_handle,
+                                            reorder_bitmap_pool_handle,
+                                            con_state_ptr->rx_state.reorder_bitmap_block_pool_handle,
+                                            payload_state_ptr);
         }
     }
-    // get rid of everything
-    ProtocolVersionDestroy(protocol_handle);
-    CdiReorderList* reorder_list_ptr = payload_state_ptr->reorder_list_ptr;
-    while (reorder_list_ptr) {
-        CdiSglEntry* entry_ptr = reorder_list_ptr->sglist.sgl_head_ptr;
-        while (entry_ptr) {
-            CdiSglEntry *next_entry_ptr = entry_ptr->next_ptr; // Save next entry, since Put() will free its memory.
-            CdiPoolPut(con_state_ptr->rx_state.payload_sgl_entry_pool_handle, entry_ptr);
-            entry_ptr = next_entry_ptr;
-        }
-        CdiReorderList *next_ptr = reorder_list_ptr->next_ptr; // Save next entry, since Put() will free its memory.
-        CdiPoolPut(con_state_ptr->rx_state.reorder_entries_pool_handle, reorder_list_ptr);
-        reorder_list_ptr = next_ptr;
+
+    // Test the reorder bitmap with payloads that don't fit in it, duplicate packets and exhausted pools.
+    if (kCdiStatusOk == rs && !TestBitmap(protocol_handle)) {
+        rs = kCdiStatusFatal;
     }
+
+    ProtocolVersionDestroy(protocol_handle);
     if (con_state_ptr->rx_state.payload_sgl_entry_pool_handle) {
         CdiPoolDestroy(con_state_ptr->rx_state.payload_sgl_entry_pool_handle);
     }
     if (con_state_ptr->rx_state.reorder_entries_pool_handle) {
         CdiPoolDestroy(con_state_ptr->rx_state.reorder_entries_pool_handle);
     }
+    if (con_state_ptr->rx_state.reorder_bitmap_pool_handle) {
+        CdiPoolDestroy(con_state_ptr->rx_state.reorder_bitmap_pool_handle);
+    }
+    if (con_state_ptr->rx_state.reorder_bitmap_block_pool_handle) {
+        CdiPoolDestroy(con_state_ptr->rx_state.reorder_bitmap_block_pool_handle);
+    }
 
     return rs;
 }
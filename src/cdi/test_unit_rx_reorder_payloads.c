@@ -34,6 +34,12 @@
 /// @brief Number of expected error application payloads processed.
 #define EXPECTED_APP_PAYLOAD_ERRORS     (1)
 
+/// @brief Number of times the packet reorder window is expected to be exceeded.
+#define EXPECTED_REORDER_WINDOW_FLUSHES (1)
+
+/// @brief Number of in progress payloads expected to be flushed when the packet reorder window is exceeded.
+#define EXPECTED_REORDER_PAYLOADS_FLUSHED (1)
+
 /// @brief Number of expected ignore payloads remaining in state array when test completes.
 #define EXPECTED_IGNORE_PAYLOADS        (2)
 
@@ -65,6 +71,12 @@ CdiReturnStatus TestUnitRxReorderPayloads(void)
     CdiConnectionState con_state = { 0 };
     CdiConnectionState* con_state_ptr = &con_state;
     endpoint_ptr->connection_state_ptr = con_state_ptr;
+    con_state_ptr->rx_state.config_data.packet_reorder_window = CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW;
+    con_state_ptr->rx_state.config_data.payload_reorder_buffer_size = CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER;
+
+    RxPayloadState* payload_state_array[CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER] = { 0 };
+    endpoint_ptr->rx_state.payload_state_array_ptr = payload_state_array;
+    endpoint_ptr->rx_state.payload_state_array_size = CDI_ARRAY_ELEMENT_COUNT(payload_state_array);
 
     if (kCdiStatusOk == rs) {
         rs = CdiOsSignalCreate(&con_state_ptr->shutdown_signal);
@@ -230,11 +242,20 @@ CdiReturnStatus TestUnitRxReorderPayloads(void)
         }
 
         // Get masked version of payload index.
-        int current_payload_index = payload_state_ptr->payload_num & (CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER-1);
+        int current_payload_index = payload_state_ptr->payload_num & (CDI_ARRAY_ELEMENT_COUNT(payload_state_array)-1);
         endpoint_ptr->rx_state.payload_state_array_ptr[current_payload_index] = NULL;
         CdiPoolPut(con_state_ptr->rx_state.rx_payload_state_pool_handle, payload_state_ptr);
     }
 
+    const CdiPayloadCounterStats* counter_stats_ptr = &endpoint_ptr->transfer_stats.payload_counter_stats;
+    if (EXPECTED_REORDER_WINDOW_FLUSHES != counter_stats_ptr->num_rx_reorder_window_flushes ||
+        EXPECTED_REORDER_PAYLOADS_FLUSHED != counter_stats_ptr->num_rx_reorder_payloads_flushed) {
+        CDI_LOG_THREAD(kLogError, "Wrong reorder window flush stats. Flushes[%d]!=[%d]. Payloads[%d]!=[%d].",
+                       EXPECTED_REORDER_WINDOW_FLUSHES, (int)counter_stats_ptr->num_rx_reorder_window_flushes,
+                       EXPECTED_REORDER_PAYLOADS_FLUSHED, (int)counter_stats_ptr->num_rx_reorder_payloads_flushed);
+        rs = kCdiStatusFatal;
+    }
+
     if (EXPECTED_IGNORE_PAYLOADS != payload_ignore_count) {
         CDI_LOG_THREAD(kLogError, "Wrong expected number of ignore payloads in state array. [%d]!=[%d].",
                        EXPECTED_IGNORE_PAYLOADS, payload_ignore_count);
@@ -242,7 +263,7 @@ CdiReturnStatus TestUnitRxReorderPayloads(void)
     }
 
     // Should not find any entries in the payload state array.
-    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(endpoint_ptr->rx_state.payload_state_array_ptr); i++) {
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(payload_state_array); i++) {
         RxPayloadState* payload_state_ptr = endpoint_ptr->rx_state.payload_state_array_ptr[i];
         if (payload_state_ptr) {
             CDI_LOG_THREAD(kLogError, "Payload state array is not empty at index[%d].", i);
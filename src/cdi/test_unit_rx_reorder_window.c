@@ -0,0 +1,267 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the Rx packet reorder window and payload reorder buffer sizes set through
+ * CdiRxConfigData.
+ */
+
+#include "rx_reorder_payloads.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "cdi_pool_api.h"
+#include "cdi_queue_api.h"
+#include "internal.h"
+#include "internal_rx.h"
+#include "payload.h"
+#include "private.h"
+#include "protocol.h"
+#include "statistics.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of entries in the payload reorder buffer used by the test. Must be a power of 2.
+#define TEST_BUFFER_SIZE        (8)
+
+/// Packet reorder window used by the test.
+#define TEST_PACKET_WINDOW      (6)
+
+/// Number of packets in every payload.
+#define TEST_PAYLOAD_PACKETS    (2)
+
+/// Maximum number of payloads that can be queued for the application.
+#define TEST_APP_PAYLOADS_MAX   (32)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the connection and endpoint used by the test. Only the members used to reorder payloads are set.
+ */
+typedef struct {
+    CdiConnectionState con_state;                          ///< The connection.
+    CdiEndpointState endpoint;                             ///< The connection's endpoint.
+    AdapterEndpointState adapter_endpoint;                 ///< The endpoint's adapter endpoint.
+    RxPayloadState* payload_state_array[TEST_BUFFER_SIZE]; ///< The payload reorder buffer.
+    int ok_count;                                          ///< Number of payloads delivered without error.
+    int error_count;                                       ///< Number of payloads delivered with an error.
+} TestWindowState;
+
+/**
+ * Test that the reorder sizes of an Rx configuration get the right defaults and that invalid sizes are refused.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestConfigResolve(void)
+{
+    // Defaults.
+    CdiRxConfigData config = { 0 };
+    CHECK(kCdiStatusOk == RxReorderConfigResolve(&config));
+    CHECK(CDI_MAX_RX_PACKET_OUT_OF_ORDER_WINDOW == config.packet_reorder_window);
+    CHECK(CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER == config.payload_reorder_buffer_size);
+    CHECK(CDI_RX_REORDER_LIST_POOL_DEFAULT_SIZE == config.reorder_list_pool_size);
+
+    // A larger window alone gets the smallest power of 2 buffer that covers it.
+    memset(&config, 0, sizeof(config));
+    config.packet_reorder_window = CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER + 1;
+    CHECK(kCdiStatusOk == RxReorderConfigResolve(&config));
+    CHECK(2 * CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER == config.payload_reorder_buffer_size);
+
+    // Sizes set by the application are kept.
+    memset(&config, 0, sizeof(config));
+    config.packet_reorder_window = TEST_PACKET_WINDOW;
+    config.payload_reorder_buffer_size = TEST_BUFFER_SIZE;
+    config.reorder_list_pool_size = 3;
+    CHECK(kCdiStatusOk == RxReorderConfigResolve(&config));
+    CHECK(TEST_PACKET_WINDOW == config.packet_reorder_window);
+    CHECK(TEST_BUFFER_SIZE == config.payload_reorder_buffer_size);
+    CHECK(3 == config.reorder_list_pool_size);
+
+    // The buffer must be a power of 2 no larger than the limit, and must cover the window.
+    config.payload_reorder_buffer_size = TEST_BUFFER_SIZE + 2;
+    CHECK(kCdiStatusInvalidParameter == RxReorderConfigResolve(&config));
+    config.payload_reorder_buffer_size = 2 * CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER_LIMIT;
+    CHECK(kCdiStatusInvalidParameter == RxReorderConfigResolve(&config));
+    config.payload_reorder_buffer_size = TEST_BUFFER_SIZE;
+    config.packet_reorder_window = TEST_BUFFER_SIZE + 1;
+    CHECK(kCdiStatusInvalidParameter == RxReorderConfigResolve(&config));
+    memset(&config, 0, sizeof(config));
+    config.packet_reorder_window = CDI_MAX_RX_PAYLOAD_OUT_OF_ORDER_BUFFER_LIMIT + 1;
+    CHECK(kCdiStatusInvalidParameter == RxReorderConfigResolve(&config));
+
+    // Negative sizes are refused.
+    memset(&config, 0, sizeof(config));
+    config.reorder_list_pool_size = -1;
+    CHECK(kCdiStatusInvalidParameter == RxReorderConfigResolve(&config));
+
+    return true;
+}
+
+/**
+ * Simulate the last packet of a payload being received and send the payloads that are ready, counting the ones that
+ * were delivered to the application.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param payload_num Number of the payload.
+ * @param payload_state State of the payload after its last packet.
+ *
+ * @return Pointer to the state of the payload.
+ */
+static RxPayloadState* TestPayloadReceive(TestWindowState* test_ptr, int payload_num, CdiPayloadState payload_state)
+{
+    CdiEndpointState* endpoint_ptr = &test_ptr->endpoint;
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    RxPayloadState* payload_state_ptr =
+        RxReorderPayloadStateGet(endpoint_ptr, con_state_ptr->rx_state.rx_payload_state_pool_handle, payload_num);
+    if (NULL == payload_state_ptr) {
+        return NULL;
+    }
+    payload_state_ptr->payload_state = payload_state;
+    payload_state_ptr->packet_count = TEST_PAYLOAD_PACKETS;
+    payload_state_ptr->work_request_state.start_time = CdiOsGetMicroseconds();
+    endpoint_ptr->rx_state.rxreorder_buffered_packet_count += TEST_PAYLOAD_PACKETS;
+    endpoint_ptr->rx_state.total_packet_count += TEST_PAYLOAD_PACKETS;
+    RxReorderPayloadSendReadyPayloads(endpoint_ptr);
+
+    AppPayloadCallbackData app_cb_data;
+    while (CdiQueuePop(con_state_ptr->app_payload_message_queue_handle, (void**)&app_cb_data)) {
+        (kCdiStatusOk == app_cb_data.payload_status_code) ? test_ptr->ok_count++ : test_ptr->error_count++;
+        PayloadErrorFreeBuffer(con_state_ptr->error_message_pool, &app_cb_data);
+    }
+    return payload_state_ptr;
+}
+
+/**
+ * Test that payload numbers wrap around a payload reorder buffer smaller than the payload number range, and that
+ * payloads are flushed once the configured packet window is reached.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestSmallWindow(TestWindowState* test_ptr)
+{
+    CdiEndpointState* endpoint_ptr = &test_ptr->endpoint;
+    const CdiPayloadCounterStats* counter_stats_ptr = &endpoint_ptr->transfer_stats.payload_counter_stats;
+
+    // Payloads received in order are delivered right away. Payload numbers are masked to the buffer size.
+    for (int payload_num = 0; payload_num < TEST_BUFFER_SIZE + 2; payload_num++) {
+        CHECK(NULL != TestPayloadReceive(test_ptr, payload_num, kPayloadComplete));
+        CHECK(payload_num + 1 == test_ptr->ok_count);
+        CHECK(((payload_num + 1) & (TEST_BUFFER_SIZE - 1)) == endpoint_ptr->rx_state.rxreorder_current_index);
+    }
+    CHECK(0 == endpoint_ptr->rx_state.rxreorder_buffered_packet_count);
+
+    // Payload 10 is missing and payload 11 is still in progress. The packets of the complete payloads that follow
+    // are held until the window is reached, at which point payload 11 is flushed as an error.
+    RxPayloadState* in_progress_ptr = TestPayloadReceive(test_ptr, 11, kPayloadInProgress);
+    CHECK(NULL != in_progress_ptr);
+    CHECK(in_progress_ptr == test_ptr->payload_state_array[11 & (TEST_BUFFER_SIZE - 1)]);
+    CHECK(NULL != TestPayloadReceive(test_ptr, 12, kPayloadComplete));
+    CHECK(0 == counter_stats_ptr->num_rx_reorder_window_flushes);
+    CHECK(NULL != TestPayloadReceive(test_ptr, 13, kPayloadComplete));
+    CHECK(1 == counter_stats_ptr->num_rx_reorder_window_flushes);
+    CHECK(1 == counter_stats_ptr->num_rx_reorder_payloads_flushed);
+    CHECK(1 == test_ptr->error_count);
+    CHECK(kPayloadIgnore == in_progress_ptr->payload_state);
+    CHECK(TEST_PACKET_WINDOW - TEST_PAYLOAD_PACKETS == endpoint_ptr->rx_state.rxreorder_buffered_packet_count);
+
+    // The next payload releases the ones held behind the flushed payload.
+    CHECK(NULL != TestPayloadReceive(test_ptr, 14, kPayloadComplete));
+    CHECK(TEST_BUFFER_SIZE + 2 + 3 == test_ptr->ok_count);
+    CHECK((15 & (TEST_BUFFER_SIZE - 1)) == endpoint_ptr->rx_state.rxreorder_current_index);
+    CHECK(0 == endpoint_ptr->rx_state.rxreorder_buffered_packet_count);
+
+    // A payload is stale once more packets than the configured window have been received since its last packet.
+    RxPayloadState stale_state = { .last_total_packet_count = 100 };
+    endpoint_ptr->rx_state.total_packet_count = 100 + TEST_PACKET_WINDOW;
+    CHECK(!RxReorderPayloadIsStale(endpoint_ptr, &stale_state));
+    endpoint_ptr->rx_state.total_packet_count++;
+    CHECK(RxReorderPayloadIsStale(endpoint_ptr, &stale_state));
+
+    return true;
+}
+
+CdiReturnStatus TestUnitRxReorderWindow(void)
+{
+    if (!TestConfigResolve()) {
+        return kCdiStatusFatal;
+    }
+
+    TestWindowState* test_ptr = CdiOsMemAllocZero(sizeof(TestWindowState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    CdiEndpointState* endpoint_ptr = &test_ptr->endpoint;
+    CdiOsStrCpy(con_state_ptr->saved_connection_name_str, sizeof(con_state_ptr->saved_connection_name_str),
+                "TestReorderWindow");
+    con_state_ptr->rx_state.config_data.packet_reorder_window = TEST_PACKET_WINDOW;
+    con_state_ptr->rx_state.config_data.payload_reorder_buffer_size = TEST_BUFFER_SIZE;
+    endpoint_ptr->connection_state_ptr = con_state_ptr;
+    endpoint_ptr->adapter_endpoint_ptr = &test_ptr->adapter_endpoint;
+    endpoint_ptr->rx_state.payload_state_array_ptr = test_ptr->payload_state_array;
+    endpoint_ptr->rx_state.payload_state_array_size = TEST_BUFFER_SIZE;
+
+    CdiProtocolVersionNumber version = {
+        .version_num = 1,
+        .major_version_num = 0,
+        .probe_version_num = 0
+    };
+    ProtocolVersionSet(&version, &test_ptr->adapter_endpoint.protocol_handle);
+
+    bool pass = NULL != test_ptr->adapter_endpoint.protocol_handle &&
+                CdiOsSignalCreate(&con_state_ptr->shutdown_signal) &&
+                kCdiStatusOk == StatsCreate(con_state_ptr, NULL, NULL, NULL, NULL, &con_state_ptr->stats_state_ptr) &&
+                CdiQueueCreate("TestReorderWindowAppPayloads", TEST_APP_PAYLOADS_MAX, CDI_FIXED_QUEUE_SIZE,
+                               CDI_FIXED_QUEUE_SIZE, sizeof(AppPayloadCallbackData), kQueueSignalPopWait,
+                               &con_state_ptr->app_payload_message_queue_handle) &&
+                CdiPoolCreate("TestReorderWindowErrors", TEST_APP_PAYLOADS_MAX, NO_GROW_SIZE, NO_GROW_COUNT,
+                              MAX_ERROR_STRING_LENGTH, true, &con_state_ptr->error_message_pool) &&
+                CdiPoolCreate("TestReorderWindowPayloadStates", TEST_BUFFER_SIZE, NO_GROW_SIZE, NO_GROW_COUNT,
+                              sizeof(RxPayloadState), true, &con_state_ptr->rx_state.rx_payload_state_pool_handle);
+    if (pass) {
+        con_state_ptr->rx_state.active_payload_complete_queue_handle = con_state_ptr->app_payload_message_queue_handle;
+        // Use a payload number range larger than the buffer, so payload numbers must wrap around it.
+        test_ptr->adapter_endpoint.protocol_handle->payload_num_max = 255;
+        pass = TestSmallWindow(test_ptr);
+    }
+
+    // Return the payload states that were left in the buffer.
+    for (int i = 0; i < TEST_BUFFER_SIZE; i++) {
+        if (test_ptr->payload_state_array[i]) {
+            CdiPoolPut(con_state_ptr->rx_state.rx_payload_state_pool_handle, test_ptr->payload_state_array[i]);
+        }
+    }
+
+    CdiPoolDestroy(con_state_ptr->rx_state.rx_payload_state_pool_handle);
+    CdiPoolDestroy(con_state_ptr->error_message_pool);
+    CdiQueueDestroy(con_state_ptr->app_payload_message_queue_handle);
+    StatsDestroy(con_state_ptr->stats_state_ptr);
+    CdiOsSignalDelete(con_state_ptr->shutdown_signal);
+    ProtocolVersionDestroy(test_ptr->adapter_endpoint.protocol_handle);
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
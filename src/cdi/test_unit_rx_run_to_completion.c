@@ -0,0 +1,183 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for Rx connections that invoke the application's payload callback function directly
+ * from the packet receive poll thread.
+ */
+
+#include "internal_rx.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "cdi_raw_api.h"
+#include "private.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Callback budget in microseconds used by the test.
+#define TEST_BUDGET_US          (2000)
+
+/// Time in milliseconds that the slow callback takes. Well over TEST_BUDGET_US.
+#define TEST_SLOW_CALLBACK_MS   (20)
+
+/// Value of the core extra data sent with every payload.
+#define TEST_PAYLOAD_USER_DATA  (0x5678)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the test. Only the members used to invoke the payload callback function are set.
+ */
+typedef struct {
+    CdiConnectionState con_state;           ///< The connection.
+    CdiEndpointState endpoint;              ///< The connection's endpoint.
+    bool slow;                              ///< True to make the callback take TEST_SLOW_CALLBACK_MS.
+    int callback_count;                     ///< Number of times the callback was invoked.
+    bool callback_user_data_ok;             ///< True if the callback got the expected payload user data.
+} TestRunToCompletionState;
+
+/**
+ * Raw Rx callback function of the test. Records the call and, if configured to, takes longer than the budget.
+ *
+ * @param cb_data_ptr Pointer to Rx callback data.
+ */
+static void TestRxCallback(const CdiRawRxCbData* cb_data_ptr)
+{
+    TestRunToCompletionState* test_ptr = (TestRunToCompletionState*)cb_data_ptr->core_cb_data.user_cb_param;
+    test_ptr->callback_count++;
+    test_ptr->callback_user_data_ok =
+        (TEST_PAYLOAD_USER_DATA == cb_data_ptr->core_cb_data.core_extra_data.payload_user_data);
+    if (test_ptr->slow) {
+        CdiOsSleep(TEST_SLOW_CALLBACK_MS);
+    }
+}
+
+/**
+ * Invoke the callback for one payload and check that it ran and how the over budget counter changed.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param slow True to make the callback exceed the budget.
+ * @param expected_over_budget_count Expected value of the over budget counter afterwards.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestInvoke(TestRunToCompletionState* test_ptr, bool slow, uint64_t expected_over_budget_count)
+{
+    AppPayloadCallbackData cb_data = {
+        .payload_status_code = kCdiStatusOk,
+    };
+    cb_data.core_extra_data.payload_user_data = TEST_PAYLOAD_USER_DATA;
+
+    int callback_count = test_ptr->callback_count;
+    test_ptr->slow = slow;
+    test_ptr->callback_user_data_ok = false;
+    RxInvokeAppPayloadCallbackInline(&test_ptr->endpoint, &cb_data);
+
+    // The callback was invoked directly, before returning.
+    CHECK(callback_count + 1 == test_ptr->callback_count);
+    CHECK(test_ptr->callback_user_data_ok);
+    CHECK(expected_over_budget_count ==
+          CdiOsAtomicLoad64(&test_ptr->endpoint.transfer_stats.payload_counter_stats.num_callbacks_over_budget));
+
+    return true;
+}
+
+/**
+ * Test that fast callbacks are not counted and slow ones are.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestBudget(TestRunToCompletionState* test_ptr)
+{
+    CHECK(TestInvoke(test_ptr, false, 0));
+    CHECK(TestInvoke(test_ptr, true, 1));
+    CHECK(TestInvoke(test_ptr, false, 1));
+    CHECK(TestInvoke(test_ptr, true, 2));
+    return true;
+}
+
+/**
+ * Test the validation of the run to completion settings of an Rx configuration.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestConfig(void)
+{
+    CdiRxConfigData config = { 0 };
+
+    // Settings are ignored when not running to completion.
+    config.buffer_delay_ms = CDI_ENABLED_RX_BUFFER_DELAY_DEFAULT_MS;
+    config.run_to_completion_budget_us = -1;
+    CHECK(kCdiStatusOk == RxRunToCompletionConfigResolve(&config));
+
+    // A buffer delay holds payloads back, so it cannot be used when they are delivered inline.
+    config.run_to_completion = true;
+    config.run_to_completion_budget_us = 0;
+    CHECK(kCdiStatusInvalidParameter == RxRunToCompletionConfigResolve(&config));
+
+    config.buffer_delay_ms = 0;
+    config.run_to_completion_budget_us = -1;
+    CHECK(kCdiStatusInvalidParameter == RxRunToCompletionConfigResolve(&config));
+
+    // Zero selects the default budget.
+    config.run_to_completion_budget_us = 0;
+    CHECK(kCdiStatusOk == RxRunToCompletionConfigResolve(&config));
+    CHECK(CDI_RX_RUN_TO_COMPLETION_DEFAULT_BUDGET_US == config.run_to_completion_budget_us);
+
+    config.run_to_completion_budget_us = TEST_BUDGET_US;
+    CHECK(kCdiStatusOk == RxRunToCompletionConfigResolve(&config));
+    CHECK(TEST_BUDGET_US == config.run_to_completion_budget_us);
+
+    return true;
+}
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+CdiReturnStatus TestUnitRxRunToCompletion(void)
+{
+    TestRunToCompletionState* test_ptr = CdiOsMemAllocZero(sizeof(TestRunToCompletionState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    con_state_ptr->handle_type = kHandleTypeRx;
+    con_state_ptr->protocol_type = kProtocolTypeRaw;
+    con_state_ptr->rx_state.cb_ptr = (CdiCallback)TestRxCallback;
+    CdiRxConfigData* config_data_ptr = &con_state_ptr->rx_state.config_data;
+    config_data_ptr->user_cb_param = test_ptr;
+    config_data_ptr->run_to_completion = true;
+    config_data_ptr->run_to_completion_budget_us = TEST_BUDGET_US;
+    test_ptr->endpoint.connection_state_ptr = con_state_ptr;
+
+    bool pass = TestConfig() && TestBudget(test_ptr);
+
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
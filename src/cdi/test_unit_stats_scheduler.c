@@ -0,0 +1,201 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the stats scheduler that sends the statistics of all connections.
+ */
+
+#include "statistics.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of scheduler entries used by the test.
+#define TEST_ENTRY_COUNT        (3)
+
+/// Index of the entry that removes itself from within its send function.
+#define TEST_SELF_REMOVE_INDEX  (2)
+
+/// Number of sends after which the self removing entry removes itself.
+#define TEST_SELF_REMOVE_SENDS  (2)
+
+/// How long to let the scheduler run, in milliseconds.
+#define TEST_RUN_TIME_MS        (350)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+struct TestSchedulerState;
+
+/**
+ * @brief State of one of the test's scheduler entries, passed to its send function.
+ */
+typedef struct {
+    StatsSchedulerEntry entry;              ///< The scheduler entry.
+    struct TestSchedulerState* test_ptr;    ///< Pointer to the test state.
+    uint32_t period_ms;                     ///< Period of the entry.
+    int send_count;                         ///< Number of periodic sends.
+    int final_send_count;                   ///< Number of sends made by StatsSchedulerRemove().
+    int misaligned_count;                   ///< Number of periodic sends whose timestamp is not a period boundary.
+    int out_of_order_count;                 ///< Number of periodic sends whose timestamp did not increase.
+    uint64_t last_timestamp_ms;             ///< Timestamp of the last periodic send.
+    bool removing;                          ///< True while StatsSchedulerRemove() is being called for this entry.
+    bool removed;                           ///< True once the entry has been removed.
+    int send_after_remove_count;            ///< Number of sends after the entry was removed.
+} TestEntryState;
+
+/**
+ * @brief State of the test.
+ */
+typedef struct TestSchedulerState {
+    StatsSchedulerHandle scheduler_handle;  ///< Handle of the stats scheduler being tested.
+    TestEntryState entry_array[TEST_ENTRY_COUNT]; ///< The scheduler entries.
+} TestSchedulerState;
+
+/**
+ * Send function of the test's scheduler entries. Records the send and, for the self removing entry, removes it from
+ * within the scheduler thread once it has been sent enough times.
+ *
+ * @param param_ptr Pointer to the TestEntryState of the entry.
+ * @param timestamp_ms Timestamp of the statistics.
+ */
+static void TestSend(void* param_ptr, uint64_t timestamp_ms)
+{
+    TestEntryState* state_ptr = (TestEntryState*)param_ptr;
+    if (state_ptr->removed) {
+        state_ptr->send_after_remove_count++;
+        return;
+    }
+    if (state_ptr->removing) {
+        state_ptr->final_send_count++;
+        return;
+    }
+
+    state_ptr->send_count++;
+    if (0 != timestamp_ms % state_ptr->period_ms) {
+        state_ptr->misaligned_count++;
+    }
+    if (timestamp_ms <= state_ptr->last_timestamp_ms) {
+        state_ptr->out_of_order_count++;
+    }
+    state_ptr->last_timestamp_ms = timestamp_ms;
+
+    if (&state_ptr->test_ptr->entry_array[TEST_SELF_REMOVE_INDEX] == state_ptr &&
+            TEST_SELF_REMOVE_SENDS == state_ptr->send_count) {
+        state_ptr->removing = true;
+        StatsSchedulerRemove(state_ptr->test_ptr->scheduler_handle, &state_ptr->entry);
+        state_ptr->removing = false;
+        state_ptr->removed = true;
+    }
+}
+
+/**
+ * Remove an entry from the scheduler from the test's thread.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param state_ptr Pointer to the entry's state.
+ */
+static void TestRemove(TestSchedulerState* test_ptr, TestEntryState* state_ptr)
+{
+    state_ptr->removing = true;
+    StatsSchedulerRemove(test_ptr->scheduler_handle, &state_ptr->entry);
+    state_ptr->removing = false;
+    state_ptr->removed = true;
+}
+
+/**
+ * Run the test's entries through the scheduler.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestScheduler(TestSchedulerState* test_ptr)
+{
+    const uint32_t period_array[TEST_ENTRY_COUNT] = { 50, 100, 50 };
+
+    CHECK(kCdiStatusNotInitialized == StatsSchedulerAdd(NULL, &test_ptr->entry_array[0].entry, 50));
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        TestEntryState* state_ptr = &test_ptr->entry_array[i];
+        state_ptr->test_ptr = test_ptr;
+        state_ptr->period_ms = period_array[i];
+        state_ptr->entry.send_func_ptr = TestSend;
+        state_ptr->entry.send_param_ptr = state_ptr;
+        state_ptr->entry.name_str = "stats scheduler test";
+        CHECK(kCdiStatusOk == StatsSchedulerAdd(test_ptr->scheduler_handle, &state_ptr->entry, period_array[i]));
+        // The first send is due at the next period boundary.
+        CHECK(0 == state_ptr->entry.next_due_ms % period_array[i]);
+    }
+
+    CdiOsSleep(TEST_RUN_TIME_MS);
+
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        if (TEST_SELF_REMOVE_INDEX != i) {
+            TestRemove(test_ptr, &test_ptr->entry_array[i]);
+        }
+    }
+
+    // Make sure the scheduler no longer sends statistics of removed entries.
+    CdiOsSleep(2 * period_array[0]);
+
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        TestEntryState* state_ptr = &test_ptr->entry_array[i];
+        CHECK(!state_ptr->entry.scheduled);
+        CHECK(0 == state_ptr->misaligned_count);
+        CHECK(0 == state_ptr->out_of_order_count);
+        CHECK(1 == state_ptr->final_send_count);
+        CHECK(0 == state_ptr->send_after_remove_count);
+        // Loose lower bound on the number of period boundaries passed, to allow for a slow test host.
+        if (TEST_SELF_REMOVE_INDEX == i) {
+            CHECK(TEST_SELF_REMOVE_SENDS == state_ptr->send_count);
+        } else {
+            CHECK(state_ptr->send_count >= (int)(TEST_RUN_TIME_MS / state_ptr->period_ms) / 2);
+        }
+    }
+
+    // Removing an entry that is not scheduled does nothing.
+    TestRemove(test_ptr, &test_ptr->entry_array[0]);
+    CHECK(0 == test_ptr->entry_array[0].send_after_remove_count);
+
+    return true;
+}
+
+CdiReturnStatus TestUnitStatsScheduler(void)
+{
+    TestSchedulerState* test_ptr = CdiOsMemAllocZero(sizeof(TestSchedulerState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+
+    CdiReturnStatus rs = StatsSchedulerCreate(&test_ptr->scheduler_handle);
+    if (kCdiStatusOk == rs) {
+        bool pass = TestScheduler(test_ptr);
+        StatsSchedulerDestroy(test_ptr->scheduler_handle);
+        rs = pass ? kCdiStatusOk : kCdiStatusFatal;
+    }
+
+    CdiOsMemFree(test_ptr);
+
+    return rs;
+}
@@ -0,0 +1,138 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the Tx batch policies and the batch size histogram.
+ */
+
+#include "internal_tx.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "configuration.h"
+#include "utilities_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Maximum latency in microseconds of the payloads used by the test.
+#define TEST_MAX_LATENCY_US     (1000)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * Test the batch policies that don't depend on the adapter or on the payload's deadline.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestFixedPolicies(void)
+{
+    // The doubling policy starts each payload with a single packet.
+    CHECK(1 == TxBatchSizeGet(kCdiTxBatchPolicyDoubling, 64, true, kEndpointTransmitQueueNa, 0, 0));
+    int batch_size = 1;
+    for (int i = 0; i < 5; i++) {
+        const int next_size = TxBatchSizeGet(kCdiTxBatchPolicyDoubling, batch_size, false, kEndpointTransmitQueueNa,
+                                             0, 0);
+        CHECK(batch_size * 2 == next_size);
+        batch_size = next_size;
+    }
+
+    // The other fixed policies ignore the previous batch and the queue level.
+    CHECK(1 == TxBatchSizeGet(kCdiTxBatchPolicyLatency, 64, false, kEndpointTransmitQueueFull, 0, 0));
+    CHECK(TX_BATCH_THROUGHPUT_PACKETS ==
+          TxBatchSizeGet(kCdiTxBatchPolicyThroughput, 1, true, kEndpointTransmitQueueEmpty, 0, 0));
+    CHECK(TX_BATCH_THROUGHPUT_PACKETS ==
+          TxBatchSizeGet(kCdiTxBatchPolicyThroughput, 1, false, kEndpointTransmitQueueFull, 0, 0));
+
+    return true;
+}
+
+/**
+ * Test the adaptive batch policy.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestAdaptivePolicy(void)
+{
+    const CdiTxBatchPolicy policy = kCdiTxBatchPolicyAdaptive;
+
+    // Packets are handed over one at a time while the adapter is idle and in large batches while it is busy.
+    CHECK(1 == TxBatchSizeGet(policy, 32, false, kEndpointTransmitQueueEmpty, 0, TEST_MAX_LATENCY_US));
+    CHECK(TX_BATCH_ADAPTIVE_MAX_PACKETS ==
+          TxBatchSizeGet(policy, 1, true, kEndpointTransmitQueueFull, 0, TEST_MAX_LATENCY_US));
+
+    // In between, batches double up to the maximum.
+    CHECK(1 == TxBatchSizeGet(policy, 32, true, kEndpointTransmitQueueIntermediate, 0, TEST_MAX_LATENCY_US));
+    CHECK(16 == TxBatchSizeGet(policy, 8, false, kEndpointTransmitQueueIntermediate, 0, TEST_MAX_LATENCY_US));
+    CHECK(TX_BATCH_ADAPTIVE_MAX_PACKETS == TxBatchSizeGet(policy, TX_BATCH_ADAPTIVE_MAX_PACKETS, false,
+                                                          kEndpointTransmitQueueNa, 0, TEST_MAX_LATENCY_US));
+
+    // Batches are kept small once half of the payload's maximum latency has elapsed, whatever the queue level.
+    const uint64_t half_latency_us = TEST_MAX_LATENCY_US / 2;
+    CHECK(TX_BATCH_ADAPTIVE_MAX_PACKETS ==
+          TxBatchSizeGet(policy, 1, false, kEndpointTransmitQueueFull, half_latency_us - 1, TEST_MAX_LATENCY_US));
+    CHECK(TX_BATCH_ADAPTIVE_URGENT_MAX_PACKETS ==
+          TxBatchSizeGet(policy, 1, false, kEndpointTransmitQueueFull, half_latency_us, TEST_MAX_LATENCY_US));
+    CHECK(1 == TxBatchSizeGet(policy, 1, false, kEndpointTransmitQueueEmpty, half_latency_us, TEST_MAX_LATENCY_US));
+
+    // Payloads without a maximum latency are never urgent.
+    CHECK(TX_BATCH_ADAPTIVE_MAX_PACKETS ==
+          TxBatchSizeGet(policy, 1, false, kEndpointTransmitQueueFull, UINT32_MAX, 0));
+
+    return true;
+}
+
+/**
+ * Test that batches are counted in the histogram bucket of their size.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestHistogram(void)
+{
+    uint64_t histogram_array[CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS] = { 0 };
+    const int batch_size_array[] = { 1, 2, 3, 4, 7, 8, 1 << (CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS - 1), 1 << 20 };
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(batch_size_array); i++) {
+        TxBatchSizeHistogramAdd(histogram_array, batch_size_array[i]);
+    }
+
+    // Bucket N counts batches of 2^N to 2^(N+1)-1 packets and the last bucket counts all larger batches.
+    CHECK(1 == histogram_array[0]);
+    CHECK(2 == histogram_array[1]);
+    CHECK(2 == histogram_array[2]);
+    CHECK(1 == histogram_array[3]);
+    CHECK(2 == histogram_array[CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS - 1]);
+    uint64_t total = 0;
+    for (int i = 0; i < CDI_TX_BATCH_SIZE_HISTOGRAM_BUCKETS; i++) {
+        total += histogram_array[i];
+    }
+    CHECK(CDI_ARRAY_ELEMENT_COUNT(batch_size_array) == total);
+
+    return true;
+}
+
+CdiReturnStatus TestUnitTxBatchPolicy(void)
+{
+    if (!TestFixedPolicies() || !TestAdaptivePolicy() || !TestHistogram()) {
+        return kCdiStatusFatal;
+    }
+    return kCdiStatusOk;
+}
@@ -0,0 +1,144 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the Tx frame allocator.
+ */
+
+#include "tx_frame_allocator.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "adapter_api.h"
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "private.h"
+#include "utilities_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of frames of the first stream used by the test.
+#define TEST_FRAME_COUNT        (4)
+
+/// Size in bytes of the frames of the first stream used by the test. Not a multiple of the frame alignment.
+#define TEST_FRAME_SIZE         (1000)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * Run the test using an adapter that only has the state used by the memory region functions.
+ *
+ * @param adapter Handle of the adapter.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestTxFrameAllocator(CdiAdapterHandle adapter)
+{
+    const CdiTxFrameAllocatorStreamConfig stream_config_array[] = {
+        { .frame_size_bytes = TEST_FRAME_SIZE, .frame_count = TEST_FRAME_COUNT },
+        { .frame_size_bytes = 64, .frame_count = 1 },
+    };
+    CdiTxFrameAllocatorHandle handle = NULL;
+    CHECK(kCdiStatusOk == CdiTxFrameAllocatorCreate(adapter, stream_config_array,
+                                                    CDI_ARRAY_ELEMENT_COUNT(stream_config_array), &handle));
+    // All of the streams share one memory region.
+    CHECK(1 == adapter->memory_region_count);
+
+    // Allocate all of the frames of the first stream. The stream starts on a huge page boundary, even if the memory
+    // didn't come from huge pages.
+    CdiSgList* sgl_ptr_array[TEST_FRAME_COUNT] = { NULL };
+    for (int i = 0; i < TEST_FRAME_COUNT; i++) {
+        CHECK(kCdiStatusOk == CdiTxFrameAlloc(handle, 0, &sgl_ptr_array[i]));
+        CHECK(TEST_FRAME_SIZE == sgl_ptr_array[i]->total_data_size);
+        CHECK(TEST_FRAME_SIZE == sgl_ptr_array[i]->sgl_head_ptr->size_in_bytes);
+        CHECK(CdiAdapterMemoryRegionFind(adapter, sgl_ptr_array[i]->sgl_head_ptr->address_ptr, TEST_FRAME_SIZE,
+                                         &(AdapterMemoryRegion){ 0 }));
+    }
+    CHECK(0 == (uintptr_t)sgl_ptr_array[0]->sgl_head_ptr->address_ptr % CDI_HUGE_PAGES_BYTE_SIZE);
+    CHECK(kCdiStatusAllocationFailed == CdiTxFrameAlloc(handle, 0, &(CdiSgList*){ NULL }));
+    CHECK(kCdiStatusInvalidParameter == CdiTxFrameAlloc(handle, 2, &(CdiSgList*){ NULL }));
+
+    // Lists that don't come from an allocator are ignored, whatever their internal_data_ptr points to.
+    uint32_t app_data_array[64] = { 0 };
+    app_data_array[0] = kMagicTxFrame;
+    CdiSgList app_sgl = { .internal_data_ptr = app_data_array };
+    CHECK(!TxFrameAllocatorSglIsFrame(&app_sgl));
+    CHECK(!TxFrameAllocatorRelease(&app_sgl));
+    app_sgl.internal_data_ptr = NULL;
+    CHECK(!TxFrameAllocatorRelease(&app_sgl));
+    app_sgl.internal_data_ptr = (uint8_t*)sgl_ptr_array[1]->internal_data_ptr + 1;
+    CHECK(!TxFrameAllocatorRelease(&app_sgl));
+    CHECK(kCdiStatusInvalidHandle == CdiTxFrameFree(&app_sgl));
+    CHECK(!TxFrameAllocatorSglIsFrame(&app_sgl));
+    for (int i = 0; i < TEST_FRAME_COUNT; i++) {
+        CHECK(TxFrameAllocatorSglIsFrame(sgl_ptr_array[i]));
+    }
+
+    // A frame can be allocated again once it is returned, using the SDK's copy of the list like the Tx logic does. Its
+    // full size is restored.
+    CdiSgList sgl_copy = *sgl_ptr_array[1];
+    sgl_ptr_array[1]->total_data_size = 10;
+    sgl_ptr_array[1]->sgl_head_ptr->size_in_bytes = 10;
+    CHECK(TxFrameAllocatorRelease(&sgl_copy));
+    CdiSgList* sgl_ptr = NULL;
+    CHECK(kCdiStatusOk == CdiTxFrameAlloc(handle, 0, &sgl_ptr));
+    CHECK(sgl_ptr_array[1] == sgl_ptr);
+    CHECK(TEST_FRAME_SIZE == sgl_ptr->total_data_size);
+    CHECK(TEST_FRAME_SIZE == sgl_ptr->sgl_head_ptr->size_in_bytes);
+
+    // The second stream is independent of the first.
+    CHECK(kCdiStatusOk == CdiTxFrameAlloc(handle, 1, &sgl_ptr));
+    CHECK(kCdiStatusAllocationFailed == CdiTxFrameAlloc(handle, 1, &(CdiSgList*){ NULL }));
+    CHECK(kCdiStatusOk == CdiTxFrameFree(sgl_ptr));
+
+    for (int i = 0; i < TEST_FRAME_COUNT; i++) {
+        CHECK(kCdiStatusOk == CdiTxFrameFree(sgl_ptr_array[i]));
+    }
+    CHECK(kCdiStatusOk == CdiTxFrameAllocatorDestroy(handle));
+    CHECK(0 == adapter->memory_region_count);
+
+    // Once the allocator is destroyed, a stale copy of one of its lists is ignored without being dereferenced.
+    CHECK(!TxFrameAllocatorRelease(&sgl_copy));
+
+    return true;
+}
+
+CdiReturnStatus TestUnitTxFrameAllocator(void)
+{
+    CdiAdapterState* adapter = CdiOsMemAllocZero(sizeof(CdiAdapterState));
+    if (NULL == adapter) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    if (!CdiOsCritSectionCreate(&adapter->memory_region_lock)) {
+        CdiOsMemFree(adapter);
+        return kCdiStatusNotEnoughMemory;
+    }
+    adapter->magic = kMagicAdapter;
+    CdiListInit(&adapter->memory_region_user_list);
+
+    bool pass = TestTxFrameAllocator(adapter);
+
+    CdiOsCritSectionDelete(adapter->memory_region_lock);
+    CdiOsMemFree(adapter);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
@@ -0,0 +1,378 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for Tx connections that packetize payloads from the adapter's poll thread instead of
+ * from a payload thread.
+ */
+
+#include "internal_tx.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "adapter_api.h"
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "cdi_pool_api.h"
+#include "cdi_queue_api.h"
+#include "private.h"
+#include "protocol.h"
+#include "utilities_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of payloads used by the test.
+#define TEST_PAYLOAD_COUNT          (2)
+
+/// Size in bytes of the payloads used by the test. Each one takes more packets than a single poll builds.
+#define TEST_PAYLOAD_SIZE           (40000)
+
+/// Maximum size in bytes of the packets built by the test.
+#define TEST_PACKET_SIZE            (1000)
+
+/// Number of work requests of the connection. Too few to build all the packets of both payloads.
+#define TEST_WORK_REQUEST_COUNT     (48)
+
+/// Number of packet SGL entries of the connection. Enough for every work request.
+#define TEST_PACKET_SGL_ENTRY_COUNT (4 * TEST_WORK_REQUEST_COUNT)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the connection used by the test. Only the members used to packetize payloads are set.
+ */
+typedef struct {
+    struct AdapterVirtualFunctionPtrTable functions; ///< Functions of the adapter.
+    CdiAdapterState adapter;                ///< The adapter.
+    AdapterConnectionState adapter_con;     ///< The connection's adapter connection.
+    AdapterEndpointState adapter_endpoint;  ///< Adapter endpoint of the connection's endpoint.
+    CdiConnectionState con_state;           ///< The connection.
+    CdiEndpointState endpoint;              ///< The connection's endpoint.
+    CdiProtocolHandle protocol_handle;      ///< Protocol used by the adapter endpoint.
+    EndpointTransmitQueueLevel queue_level; ///< Transmit queue level reported by the adapter endpoint.
+    uint8_t data_array[TEST_PAYLOAD_SIZE];  ///< Data of every payload.
+    CdiSglEntry sgl_entry;                  ///< SGL entry of every payload.
+    TxPayloadState* payload_array[TEST_PAYLOAD_COUNT]; ///< The payloads.
+    /// Packets handed to the adapter endpoint, in the order they were enqueued.
+    Packet* sent_packet_array[TEST_PAYLOAD_COUNT * TEST_PAYLOAD_SIZE / TEST_PACKET_SIZE];
+    int sent_packet_count;                  ///< Number of packets in sent_packet_array.
+} TestTxPollState;
+
+/**
+ * Get the transmit queue level of the test's adapter endpoint.
+ *
+ * @param handle Handle of the adapter endpoint.
+ *
+ * @return The level set by the test.
+ */
+static EndpointTransmitQueueLevel TestGetTransmitQueueLevel(AdapterEndpointHandle handle)
+{
+    TestTxPollState* test_ptr = CONTAINER_OF(handle, TestTxPollState, adapter_endpoint);
+    return test_ptr->queue_level;
+}
+
+/**
+ * Take a payload state from the connection's pool, initialize it and put it in the connection's payload queue, as
+ * TxPayloadInternal() does.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param index Index of the payload in payload_array.
+ *
+ * @return true if the payload was queued, otherwise false.
+ */
+static bool TestPayloadQueue(TestTxPollState* test_ptr, int index)
+{
+    TxPayloadState* payload_state_ptr = NULL;
+    if (!CdiPoolGet(test_ptr->con_state.tx_state.payload_state_pool_handle, (void**)&payload_state_ptr)) {
+        return false;
+    }
+    memset(payload_state_ptr, 0, sizeof(*payload_state_ptr));
+    payload_state_ptr->cdi_endpoint_handle = &test_ptr->endpoint;
+    payload_state_ptr->start_time = CdiOsGetMicroseconds();
+    payload_state_ptr->source_sgl.total_data_size = TEST_PAYLOAD_SIZE;
+    payload_state_ptr->source_sgl.sgl_head_ptr = &test_ptr->sgl_entry;
+    payload_state_ptr->source_sgl.sgl_tail_ptr = &test_ptr->sgl_entry;
+    // Initialized as PayloadInit() does, but using the SGL of the test rather than a copy of it.
+    CdiPayloadPacketState* packet_state_ptr = &payload_state_ptr->payload_packet_state;
+    packet_state_ptr->payload_type = kPayloadTypeData;
+    packet_state_ptr->maximum_packet_byte_size = test_ptr->adapter.maximum_payload_bytes;
+    packet_state_ptr->maximum_tx_sgl_entries = test_ptr->adapter.maximum_tx_sgl_entries;
+    packet_state_ptr->source_entry_ptr = &test_ptr->sgl_entry;
+    payload_state_ptr->app_payload_cb_data.core_extra_data.payload_user_data = index;
+    CdiSinglyLinkedListInit(&payload_state_ptr->completed_packets_list);
+    test_ptr->payload_array[index] = payload_state_ptr;
+
+    CdiOsAtomicInc32(&test_ptr->adapter_endpoint.tx_in_flight_ref_count);
+    return CdiQueuePush(test_ptr->con_state.tx_state.payload_queue_handle, &payload_state_ptr);
+}
+
+/**
+ * Take the packets that were handed to the adapter endpoint since the last call.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return Number of packets taken.
+ */
+static int TestPacketsSent(TestTxPollState* test_ptr)
+{
+    int count = 0;
+    CdiSinglyLinkedList packet_list;
+    while (CdiQueuePop(test_ptr->adapter_endpoint.tx_packet_queue_handle, (void**)&packet_list)) {
+        CdiSinglyLinkedListEntry* entry_ptr = NULL;
+        while (NULL != (entry_ptr = CdiSinglyLinkedListPopHead(&packet_list))) {
+            Packet* packet_ptr = CONTAINER_OF(entry_ptr, Packet, list_entry);
+            test_ptr->sent_packet_array[test_ptr->sent_packet_count++] = packet_ptr;
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * Get the payload whose packet was sent.
+ *
+ * @param packet_ptr Pointer to the packet.
+ *
+ * @return Pointer to the payload state data.
+ */
+static TxPayloadState* TestPacketPayloadGet(const Packet* packet_ptr)
+{
+    const TxPacketWorkRequest* work_request_ptr = (const TxPacketWorkRequest*)packet_ptr->sg_list.internal_data_ptr;
+    return work_request_ptr->payload_state_ptr;
+}
+
+/**
+ * Pop the next message queued for the application and check its status and payload.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param status_code Expected status of the payload.
+ * @param index Index of the expected payload in payload_array.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestAppMessageCheck(TestTxPollState* test_ptr, CdiReturnStatus status_code, int index)
+{
+    AppPayloadCallbackData app_cb_data;
+    CHECK(CdiQueuePop(test_ptr->con_state.app_payload_message_queue_handle, (void**)&app_cb_data));
+    CHECK(status_code == app_cb_data.payload_status_code);
+    CHECK((uint64_t)index == app_cb_data.core_extra_data.payload_user_data);
+    CHECK(CdiQueueIsEmpty(test_ptr->con_state.app_payload_message_queue_handle));
+    return true;
+}
+
+/**
+ * Test polling a connection through payloads that are queued, partially packetized, completed and flushed.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestPoll(TestTxPollState* test_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    CdiPoolHandle work_request_pool_handle = con_state_ptr->tx_state.work_request_pool_handle;
+
+    // Nothing to do.
+    CHECK(!TxPollPacketize(con_state_ptr));
+    CHECK(0 == TestPacketsSent(test_ptr));
+
+    // A poll only builds part of a payload. The next payload isn't started.
+    CHECK(TestPayloadQueue(test_ptr, 0));
+    CHECK(TestPayloadQueue(test_ptr, 1));
+    TxPayloadState* first_ptr = test_ptr->payload_array[0];
+    TxPayloadState* second_ptr = test_ptr->payload_array[1];
+    CHECK(TxPollPacketize(con_state_ptr));
+    CHECK(TX_RUN_TO_COMPLETION_PACKETS_PER_POLL == TestPacketsSent(test_ptr));
+    CHECK(0 != first_ptr->packetize_start_time);
+    CHECK(0 == second_ptr->packetize_start_time);
+
+    // No packets are built while the adapter's queue is full.
+    test_ptr->queue_level = kEndpointTransmitQueueFull;
+    CHECK(!TxPollPacketize(con_state_ptr));
+    CHECK(0 == TestPacketsSent(test_ptr));
+    test_ptr->queue_level = kEndpointTransmitQueueIntermediate;
+
+    // The next poll finishes the payload.
+    CHECK(TxPollPacketize(con_state_ptr));
+    const int first_packet_count = TX_RUN_TO_COMPLETION_PACKETS_PER_POLL + TestPacketsSent(test_ptr);
+    CHECK(first_packet_count > TX_RUN_TO_COMPLETION_PACKETS_PER_POLL);
+    CHECK(first_packet_count < TEST_WORK_REQUEST_COUNT);
+    CHECK(test_ptr->sent_packet_array[first_packet_count - 1]->payload_last_packet);
+    CHECK(0 == second_ptr->packetize_start_time);
+    for (int i = 0; i < first_packet_count; i++) {
+        CHECK(first_ptr == TestPacketPayloadGet(test_ptr->sent_packet_array[i]));
+    }
+
+    // The next payload is started and built until the connection runs out of work requests.
+    CHECK(TxPollPacketize(con_state_ptr));
+    CHECK(TEST_WORK_REQUEST_COUNT - first_packet_count == TestPacketsSent(test_ptr));
+    CHECK(0 != second_ptr->packetize_start_time);
+    CHECK(0 == CdiPoolGetFreeItemCount(work_request_pool_handle));
+    CHECK(!TxPollPacketize(con_state_ptr));
+    CHECK(0 == TestPacketsSent(test_ptr));
+
+    // Acknowledging the packets of the first payload completes it.
+    for (int i = 0; i < first_packet_count; i++) {
+        Packet* packet_ptr = test_ptr->sent_packet_array[i];
+        packet_ptr->tx_state.ack_status = kAdapterPacketStatusOk;
+        TxPacketWorkRequestComplete(&test_ptr->endpoint, packet_ptr, kEndpointMessageTypePacketSent);
+    }
+    CHECK(TestAppMessageCheck(test_ptr, kCdiStatusOk, 0));
+
+    // The next poll frees its work requests and continues building the second payload.
+    CHECK(TxPollPacketize(con_state_ptr));
+    CHECK(TX_RUN_TO_COMPLETION_PACKETS_PER_POLL == TestPacketsSent(test_ptr));
+    CHECK(second_ptr == TestPacketPayloadGet(test_ptr->sent_packet_array[test_ptr->sent_packet_count - 1]));
+    CHECK(CdiQueueIsEmpty(con_state_ptr->tx_state.work_req_comp_queue_handle));
+    CHECK(first_packet_count - TX_RUN_TO_COMPLETION_PACKETS_PER_POLL ==
+          CdiPoolGetFreeItemCount(work_request_pool_handle));
+
+    // Flushing fails the payload in process and returns all of its resources.
+    TxPayloadThreadFlushResources(&test_ptr->endpoint);
+    CHECK(TestAppMessageCheck(test_ptr, kCdiStatusSendFailed, 1));
+    CHECK(TEST_WORK_REQUEST_COUNT == CdiPoolGetFreeItemCount(work_request_pool_handle));
+    CHECK(TEST_PACKET_SGL_ENTRY_COUNT ==
+          CdiPoolGetFreeItemCount(con_state_ptr->tx_state.packet_sgl_entry_pool_handle));
+    CHECK(TEST_PAYLOAD_COUNT == CdiPoolGetFreeItemCount(con_state_ptr->tx_state.payload_state_pool_handle));
+    CHECK(!TxPollPacketize(con_state_ptr));
+    CHECK(0 == TestPacketsSent(test_ptr));
+
+    return true;
+}
+
+/**
+ * Create the pools and queues of the test's connection.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if successful, otherwise false.
+ */
+static bool TestResourcesCreate(TestTxPollState* test_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    TxConState* tx_state_ptr = &con_state_ptr->tx_state;
+
+    CdiProtocolVersionNumber version = {
+        .version_num = CDI_PROTOCOL_VERSION,
+        .major_version_num = CDI_PROTOCOL_MAJOR_VERSION,
+        .probe_version_num = CDI_PROBE_VERSION
+    };
+    ProtocolVersionSet(&version, &test_ptr->protocol_handle);
+    test_ptr->adapter_endpoint.protocol_handle = test_ptr->protocol_handle;
+
+    return NULL != test_ptr->protocol_handle &&
+        CdiOsCritSectionCreate(&test_ptr->endpoint.tx_state.payload_num_lock) &&
+        CdiOsCritSectionCreate(&tx_state_ptr->stream_lock) &&
+        CdiQueueCreate("TestTxPollPacket", TEST_WORK_REQUEST_COUNT, CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE,
+                       sizeof(CdiSinglyLinkedList), kQueueSignalNone,
+                       &test_ptr->adapter_endpoint.tx_packet_queue_handle) &&
+        CdiQueueCreate("TestTxPollAppPayload", TEST_PAYLOAD_COUNT, CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE,
+                       sizeof(AppPayloadCallbackData), kQueueSignalNone,
+                       &con_state_ptr->app_payload_message_queue_handle) &&
+        CdiQueueCreate("TestTxPollPayload", TEST_PAYLOAD_COUNT, CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE,
+                       sizeof(TxPayloadState*), kQueueSignalNone, &tx_state_ptr->payload_queue_handle) &&
+        CdiQueueCreate("TestTxPollWorkRequestComplete", TEST_PAYLOAD_COUNT, CDI_FIXED_QUEUE_SIZE,
+                       CDI_FIXED_QUEUE_SIZE, sizeof(CdiSinglyLinkedList), kQueueSignalNone,
+                       &tx_state_ptr->work_req_comp_queue_handle) &&
+        CdiPoolCreate("TestTxPollWorkRequest", TEST_WORK_REQUEST_COUNT, NO_GROW_SIZE, NO_GROW_COUNT,
+                      sizeof(TxPacketWorkRequest), false, &tx_state_ptr->work_request_pool_handle) &&
+        CdiPoolCreate("TestTxPollPacketSglEntry", TEST_PACKET_SGL_ENTRY_COUNT, NO_GROW_SIZE, NO_GROW_COUNT,
+                      sizeof(CdiSglEntry), false, &tx_state_ptr->packet_sgl_entry_pool_handle) &&
+        CdiPoolCreate("TestTxPollPayloadState", TEST_PAYLOAD_COUNT, NO_GROW_SIZE, NO_GROW_COUNT,
+                      sizeof(TxPayloadState), true, &tx_state_ptr->payload_state_pool_handle) &&
+        NULL != (tx_state_ptr->poll_packetizer_state_ptr = TxPacketizerStateCreate(con_state_ptr));
+}
+
+/**
+ * Free the resources created by TestResourcesCreate(), including any still in use by a test that failed.
+ *
+ * @param test_ptr Pointer to test state.
+ */
+static void TestResourcesDestroy(TestTxPollState* test_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    TxConState* tx_state_ptr = &con_state_ptr->tx_state;
+
+    TxPacketizerStateDestroy(tx_state_ptr->poll_packetizer_state_ptr);
+    CdiPoolPutAll(tx_state_ptr->payload_state_pool_handle);
+    CdiPoolPutAll(tx_state_ptr->packet_sgl_entry_pool_handle);
+    CdiPoolPutAll(tx_state_ptr->work_request_pool_handle);
+    CdiQueueHandle queue_handle_array[] = {
+        tx_state_ptr->work_req_comp_queue_handle, tx_state_ptr->payload_queue_handle,
+        con_state_ptr->app_payload_message_queue_handle, test_ptr->adapter_endpoint.tx_packet_queue_handle
+    };
+    for (int i = 0; i < CDI_ARRAY_ELEMENT_COUNT(queue_handle_array); i++) {
+        if (queue_handle_array[i]) {
+            CdiQueueFlush(queue_handle_array[i]);
+            CdiQueueDestroy(queue_handle_array[i]);
+        }
+    }
+    CdiPoolDestroy(tx_state_ptr->payload_state_pool_handle);
+    CdiPoolDestroy(tx_state_ptr->packet_sgl_entry_pool_handle);
+    CdiPoolDestroy(tx_state_ptr->work_request_pool_handle);
+    CdiOsCritSectionDelete(tx_state_ptr->stream_lock);
+    CdiOsCritSectionDelete(test_ptr->endpoint.tx_state.payload_num_lock);
+    ProtocolVersionDestroy(test_ptr->protocol_handle);
+}
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+CdiReturnStatus TestUnitTxPoll(void)
+{
+    TestTxPollState* test_ptr = CdiOsMemAllocZero(sizeof(TestTxPollState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    CdiOsStrCpy(con_state_ptr->saved_connection_name_str, sizeof(con_state_ptr->saved_connection_name_str),
+                "TestTxPoll");
+    test_ptr->functions.GetTransmitQueueLevel = TestGetTransmitQueueLevel;
+    test_ptr->adapter.functions_ptr = &test_ptr->functions;
+    test_ptr->adapter.maximum_payload_bytes = TEST_PACKET_SIZE;
+    test_ptr->adapter.maximum_tx_sgl_entries = TEST_PACKET_SGL_ENTRY_COUNT / TEST_WORK_REQUEST_COUNT;
+    test_ptr->adapter_con.adapter_state_ptr = &test_ptr->adapter;
+    test_ptr->adapter_con.direction = kEndpointDirectionSend;
+    test_ptr->adapter_endpoint.adapter_con_state_ptr = &test_ptr->adapter_con;
+    test_ptr->adapter_endpoint.cdi_endpoint_handle = &test_ptr->endpoint;
+    test_ptr->adapter_endpoint.connection_status_code = kCdiConnectionStatusConnected;
+    test_ptr->endpoint.adapter_endpoint_ptr = &test_ptr->adapter_endpoint;
+    test_ptr->endpoint.connection_state_ptr = con_state_ptr;
+    con_state_ptr->adapter_state_ptr = &test_ptr->adapter;
+    con_state_ptr->adapter_connection_ptr = &test_ptr->adapter_con;
+    con_state_ptr->tx_state.config_data.run_to_completion = true;
+    con_state_ptr->tx_state.config_data.max_simultaneous_tx_payloads = TEST_PAYLOAD_COUNT;
+    // Hand every packet to the adapter as soon as it is built.
+    con_state_ptr->tx_state.config_data.batch_policy = kCdiTxBatchPolicyLatency;
+    test_ptr->queue_level = kEndpointTransmitQueueEmpty;
+    test_ptr->sgl_entry.address_ptr = test_ptr->data_array;
+    test_ptr->sgl_entry.size_in_bytes = TEST_PAYLOAD_SIZE;
+
+    bool pass = TestResourcesCreate(test_ptr) && TestPoll(test_ptr);
+
+    TestResourcesDestroy(test_ptr);
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
@@ -0,0 +1,301 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the scheduling and preemption of Tx payloads by payloads of higher priority
+ * streams.
+ */
+
+#include "internal_tx.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "adapter_api.h"
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "cdi_queue_api.h"
+#include "private.h"
+#include "protocol.h"
+#include "utilities_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of payloads used by the test.
+#define TEST_PAYLOAD_COUNT      (4)
+
+/// Number of endpoints used by the test.
+#define TEST_ENDPOINT_COUNT     (3)
+
+/// Size in bytes of the payloads used by the test.
+#define TEST_PAYLOAD_SIZE       (10000)
+
+/// Maximum latency in microseconds of the payloads used by the test that have one.
+#define TEST_MAX_LATENCY_US     (16000)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the connection and endpoints used by the test. Only the members used to start payloads are set.
+ */
+typedef struct {
+    CdiAdapterState adapter;                ///< The adapter.
+    AdapterConnectionState adapter_con;     ///< The connection's adapter connection.
+    CdiConnectionState con_state;           ///< The connection.
+    /// Adapter endpoints of the connection's endpoints.
+    AdapterEndpointState adapter_endpoint_array[TEST_ENDPOINT_COUNT];
+    /// Endpoints of the connection. The first two are of low priority streams, the last one of a high priority stream.
+    CdiEndpointState endpoint_array[TEST_ENDPOINT_COUNT];
+    CdiProtocolHandle protocol_handle;      ///< Protocol used by the adapter endpoints.
+    uint8_t data_array[TEST_PAYLOAD_SIZE];  ///< Data of every payload.
+    CdiSglEntry sgl_entry;                  ///< SGL entry of every payload.
+    TxPayloadState payload_array[TEST_PAYLOAD_COUNT]; ///< The payloads.
+} TestPreemptState;
+
+/**
+ * Initialize a payload and put it in the connection's payload queue.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param payload_state_ptr Pointer to the payload to initialize.
+ * @param endpoint_ptr Pointer to the endpoint of the payload's stream.
+ *
+ * @return true if the payload was queued, otherwise false.
+ */
+static bool TestPayloadQueue(TestPreemptState* test_ptr, TxPayloadState* payload_state_ptr,
+                             CdiEndpointState* endpoint_ptr)
+{
+    memset(payload_state_ptr, 0, sizeof(*payload_state_ptr));
+    payload_state_ptr->cdi_endpoint_handle = endpoint_ptr;
+    payload_state_ptr->start_time = CdiOsGetMicroseconds();
+    payload_state_ptr->source_sgl.total_data_size = TEST_PAYLOAD_SIZE;
+    payload_state_ptr->source_sgl.sgl_head_ptr = &test_ptr->sgl_entry;
+    payload_state_ptr->source_sgl.sgl_tail_ptr = &test_ptr->sgl_entry;
+    payload_state_ptr->payload_packet_state.maximum_packet_byte_size = test_ptr->adapter.maximum_payload_bytes;
+
+    return CdiQueuePush(test_ptr->con_state.tx_state.payload_queue_handle, &payload_state_ptr);
+}
+
+/**
+ * Test that stream priorities take precedence over deadlines in the order in which waiting payloads are started.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestSchedulerOrder(TestPreemptState* test_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    TxPayloadState* low_ptr = &test_ptr->payload_array[0];
+    TxPayloadState* low_no_latency_ptr = &test_ptr->payload_array[1];
+    TxPayloadState* high_ptr = &test_ptr->payload_array[2];
+    const uint64_t now = CdiOsGetMicroseconds();
+    for (int i = 0; i < 3; i++) {
+        TxPayloadState* payload_state_ptr = &test_ptr->payload_array[i];
+        memset(payload_state_ptr, 0, sizeof(*payload_state_ptr));
+        payload_state_ptr->cdi_endpoint_handle = &test_ptr->endpoint_array[2 == i ? 2 : 0];
+        payload_state_ptr->start_time = now;
+        payload_state_ptr->source_sgl.total_data_size = TEST_PAYLOAD_SIZE;
+    }
+    // The low priority payload has the earlier deadline.
+    low_ptr->max_latency_microsecs = TEST_MAX_LATENCY_US;
+    high_ptr->max_latency_microsecs = TEST_MAX_LATENCY_US * 2;
+    // The payload without a maximum latency has waited long enough to go ahead of payloads with a deadline.
+    low_no_latency_ptr->start_time = now - TX_SCHEDULER_NO_LATENCY_MAX_WAIT_MICROSECS;
+
+    // Priorities are used with and without deadline scheduling.
+    for (int i = 0; i < 2; i++) {
+        con_state_ptr->tx_state.config_data.deadline_scheduling = (0 == i);
+        CHECK(TxSchedulerPayloadIsBefore(con_state_ptr, high_ptr, low_ptr));
+        CHECK(!TxSchedulerPayloadIsBefore(con_state_ptr, low_ptr, high_ptr));
+        CHECK(TxSchedulerPayloadIsBefore(con_state_ptr, high_ptr, low_no_latency_ptr));
+        CHECK(!TxSchedulerPayloadIsBefore(con_state_ptr, low_no_latency_ptr, high_ptr));
+    }
+
+    return true;
+}
+
+/**
+ * Test interrupting a payload of a low priority stream with one of a high priority stream, and resuming it.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param state_ptr Pointer to the connection's packetizer state data.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestPreempt(TestPreemptState* test_ptr, TxPacketizerState* state_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    TxPayloadState* low_a_ptr = &test_ptr->payload_array[0];
+    TxPayloadState* low_b_ptr = &test_ptr->payload_array[1];
+    TxPayloadState* high_c_ptr = &test_ptr->payload_array[2];
+    TxPayloadState* high_d_ptr = &test_ptr->payload_array[3];
+    const int low_priority = test_ptr->endpoint_array[0].tx_state.priority;
+
+    // Nothing is waiting, so nothing is started.
+    CHECK(!TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, INT_MIN));
+    CHECK(NULL == TxPacketizerPayloadGet(state_ptr, false));
+
+    // With no payload in process, any waiting payload is started and nothing is suspended.
+    CHECK(TestPayloadQueue(test_ptr, low_a_ptr, &test_ptr->endpoint_array[0]));
+    CHECK(TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, INT_MIN));
+    CHECK(low_a_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    CHECK(NULL == TxPacketizerPayloadGet(state_ptr, true));
+    CHECK(0 == low_a_ptr->payload_packet_state.payload_num);
+    CHECK(0 != low_a_ptr->packetize_start_time);
+
+    // A payload of a stream with the same priority doesn't interrupt the one in process. It stays queued.
+    CHECK(TestPayloadQueue(test_ptr, low_b_ptr, &test_ptr->endpoint_array[0]));
+    CHECK(!TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, low_priority));
+    CHECK(low_a_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    CHECK(NULL == TxPacketizerPayloadGet(state_ptr, true));
+    CHECK(0 == low_b_ptr->packetize_start_time);
+
+    // A payload of a higher priority stream does, even though it was queued last. It is numbered by its own stream.
+    CHECK(TestPayloadQueue(test_ptr, high_c_ptr, &test_ptr->endpoint_array[2]));
+    CHECK(TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, low_priority));
+    CHECK(high_c_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    CHECK(low_a_ptr == TxPacketizerPayloadGet(state_ptr, true));
+    CHECK(0 == high_c_ptr->payload_packet_state.payload_num);
+    CHECK(0 == low_b_ptr->packetize_start_time);
+
+    // Only one payload can be suspended, so another high priority payload waits for the one in process.
+    CHECK(TestPayloadQueue(test_ptr, high_d_ptr, &test_ptr->endpoint_array[2]));
+    CHECK(!TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, low_priority));
+    CHECK(high_c_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    CHECK(0 == high_d_ptr->packetize_start_time);
+
+    // Swapping exchanges the payloads. While one is suspended, nothing interrupts the payload in process, whatever
+    // its priority.
+    TxPacketizerPayloadSwap(state_ptr);
+    CHECK(low_a_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    CHECK(high_c_ptr == TxPacketizerPayloadGet(state_ptr, true));
+    CHECK(!TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, low_priority));
+    CHECK(low_a_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    TxPacketizerPayloadSwap(state_ptr);
+    CHECK(high_c_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    CHECK(low_a_ptr == TxPacketizerPayloadGet(state_ptr, true));
+
+    // None of the waiting payloads was started. The last one is still queued, since the scheduler isn't consulted
+    // while a payload is suspended.
+    CHECK(0 == low_b_ptr->packetize_start_time);
+    CHECK(0 == high_d_ptr->packetize_start_time);
+    TxPayloadState* payload_state_ptr = NULL;
+    CHECK(CdiQueuePop(con_state_ptr->tx_state.payload_queue_handle, (void**)&payload_state_ptr));
+    CHECK(high_d_ptr == payload_state_ptr);
+    CHECK(CdiQueueIsEmpty(con_state_ptr->tx_state.payload_queue_handle));
+
+    return true;
+}
+
+/**
+ * Test that a payload which has to wait, such as a streaming payload waiting for data, only lets payloads of other
+ * endpoints use the packetizer, so the packets of two payloads are never interleaved on one endpoint.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param state_ptr Pointer to the connection's packetizer state data.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestSameEndpoint(TestPreemptState* test_ptr, TxPacketizerState* state_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    TxPayloadState* first_ptr = &test_ptr->payload_array[0];
+    TxPayloadState* same_endpoint_ptr = &test_ptr->payload_array[1];
+    TxPayloadState* other_endpoint_ptr = &test_ptr->payload_array[2];
+
+    CHECK(TestPayloadQueue(test_ptr, first_ptr, &test_ptr->endpoint_array[0]));
+    CHECK(TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, INT_MIN));
+    CHECK(first_ptr == TxPacketizerPayloadGet(state_ptr, false));
+
+    // A payload of the same endpoint is not started while the first one is in process, whatever the minimum priority.
+    CHECK(TestPayloadQueue(test_ptr, same_endpoint_ptr, &test_ptr->endpoint_array[0]));
+    CHECK(!TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, INT_MIN));
+    CHECK(first_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    CHECK(NULL == TxPacketizerPayloadGet(state_ptr, true));
+    CHECK(0 == same_endpoint_ptr->packetize_start_time);
+
+    // A payload of another endpoint of the same priority is.
+    CHECK(TestPayloadQueue(test_ptr, other_endpoint_ptr, &test_ptr->endpoint_array[1]));
+    CHECK(TxPacketizerPayloadPreempt(con_state_ptr, state_ptr, INT_MIN));
+    CHECK(other_endpoint_ptr == TxPacketizerPayloadGet(state_ptr, false));
+    CHECK(first_ptr == TxPacketizerPayloadGet(state_ptr, true));
+    CHECK(0 == same_endpoint_ptr->packetize_start_time);
+
+    return true;
+}
+
+CdiReturnStatus TestUnitTxPreempt(void)
+{
+    TestPreemptState* test_ptr = CdiOsMemAllocZero(sizeof(TestPreemptState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    CdiOsStrCpy(test_ptr->con_state.saved_connection_name_str, sizeof(test_ptr->con_state.saved_connection_name_str),
+                "TestPreempt");
+    test_ptr->adapter.maximum_payload_bytes = TEST_PAYLOAD_SIZE / 4;
+    test_ptr->con_state.adapter_state_ptr = &test_ptr->adapter;
+    test_ptr->con_state.adapter_connection_ptr = &test_ptr->adapter_con;
+    test_ptr->con_state.tx_state.config_data.max_simultaneous_tx_payloads = TEST_PAYLOAD_COUNT;
+    test_ptr->sgl_entry.address_ptr = test_ptr->data_array;
+    test_ptr->sgl_entry.size_in_bytes = TEST_PAYLOAD_SIZE;
+
+    CdiProtocolVersionNumber version = {
+        .version_num = CDI_PROTOCOL_VERSION,
+        .major_version_num = CDI_PROTOCOL_MAJOR_VERSION,
+        .probe_version_num = CDI_PROBE_VERSION
+    };
+    ProtocolVersionSet(&version, &test_ptr->protocol_handle);
+    bool pass = NULL != test_ptr->protocol_handle;
+    for (int i = 0; i < TEST_ENDPOINT_COUNT; i++) {
+        test_ptr->adapter_endpoint_array[i].protocol_handle = test_ptr->protocol_handle;
+        test_ptr->endpoint_array[i].adapter_endpoint_ptr = &test_ptr->adapter_endpoint_array[i];
+        test_ptr->endpoint_array[i].tx_state.priority = (TEST_ENDPOINT_COUNT - 1 == i) ? 1 : 0;
+        pass = pass && CdiOsCritSectionCreate(&test_ptr->endpoint_array[i].tx_state.payload_num_lock);
+    }
+    pass = pass && CdiQueueCreate("TestPreemptPayload", TEST_PAYLOAD_COUNT, CDI_FIXED_QUEUE_SIZE,
+                                  CDI_FIXED_QUEUE_SIZE, sizeof(TxPayloadState*), kQueueSignalNone,
+                                  &test_ptr->con_state.tx_state.payload_queue_handle);
+
+    pass = pass && TestSchedulerOrder(test_ptr);
+
+    // Each test uses its own packetizer state.
+    for (int i = 0; pass && i < 2; i++) {
+        TxPacketizerState* state_ptr = TxPacketizerStateCreate(&test_ptr->con_state);
+        // Payloads are started as if by the poll thread, so the scheduler doesn't signal it.
+        test_ptr->con_state.tx_state.poll_packetizer_state_ptr = state_ptr;
+        pass = NULL != state_ptr;
+        pass = pass && (0 == i ? TestPreempt(test_ptr, state_ptr) : TestSameEndpoint(test_ptr, state_ptr));
+        TxPacketizerStateDestroy(state_ptr);
+        test_ptr->con_state.tx_state.poll_packetizer_state_ptr = NULL;
+        CdiQueueFlush(test_ptr->con_state.tx_state.payload_queue_handle);
+    }
+
+    CdiQueueDestroy(test_ptr->con_state.tx_state.payload_queue_handle);
+    for (int i = 0; i < TEST_ENDPOINT_COUNT; i++) {
+        CdiOsCritSectionDelete(test_ptr->endpoint_array[i].tx_state.payload_num_lock);
+    }
+    ProtocolVersionDestroy(test_ptr->protocol_handle);
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
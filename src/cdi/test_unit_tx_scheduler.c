@@ -0,0 +1,216 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the deadline based Tx payload scheduler.
+ */
+
+#include "internal_tx.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "adapter_api.h"
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "cdi_pool_api.h"
+#include "cdi_queue_api.h"
+#include "configuration.h"
+#include "private.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Maximum latency in microseconds of the payloads used by the test that have one.
+#define TEST_MAX_LATENCY_US     (16000)
+
+/// Size in bytes of the payloads used by the test.
+#define TEST_PAYLOAD_SIZE       (100000)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the connection and endpoint used by the test. Only the members used by the scheduler are set.
+ */
+typedef struct {
+    CdiConnectionState con_state;       ///< The connection.
+    CdiEndpointState endpoint;          ///< The connection's endpoint.
+    AdapterEndpointState adapter_endpoint; ///< The endpoint's adapter endpoint.
+} TestSchedulerState;
+
+/**
+ * Initialize a payload of the test endpoint.
+ *
+ * @param test_ptr Pointer to test state.
+ * @param payload_state_ptr Pointer to the payload to initialize.
+ * @param start_time Time the payload was queued.
+ * @param max_latency_us Maximum latency of the payload, zero if none.
+ */
+static void TestPayloadInit(TestSchedulerState* test_ptr, TxPayloadState* payload_state_ptr, uint64_t start_time,
+                            uint32_t max_latency_us)
+{
+    memset(payload_state_ptr, 0, sizeof(*payload_state_ptr));
+    payload_state_ptr->cdi_endpoint_handle = &test_ptr->endpoint;
+    payload_state_ptr->start_time = start_time;
+    payload_state_ptr->max_latency_microsecs = max_latency_us;
+    payload_state_ptr->source_sgl.total_data_size = TEST_PAYLOAD_SIZE;
+}
+
+/**
+ * Test the order in which waiting payloads are started.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestOrder(TestSchedulerState* test_ptr)
+{
+    const CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    const uint64_t now = CdiOsGetMicroseconds();
+    TxPayloadState early = { 0 };
+    TxPayloadState late = { 0 };
+    TxPayloadState no_latency = { 0 };
+    TestPayloadInit(test_ptr, &early, now, TEST_MAX_LATENCY_US);
+    TestPayloadInit(test_ptr, &late, now, TEST_MAX_LATENCY_US * 2);
+    TestPayloadInit(test_ptr, &no_latency, now, 0);
+
+    // Without deadline scheduling, payloads are started in the order they were queued.
+    test_ptr->con_state.tx_state.config_data.deadline_scheduling = false;
+    CHECK(!TxSchedulerPayloadIsBefore(con_state_ptr, &early, &late));
+    CHECK(!TxSchedulerPayloadIsBefore(con_state_ptr, &late, &early));
+
+    test_ptr->con_state.tx_state.config_data.deadline_scheduling = true;
+    CHECK(TxSchedulerPayloadIsBefore(con_state_ptr, &early, &late));
+    CHECK(!TxSchedulerPayloadIsBefore(con_state_ptr, &late, &early));
+    CHECK(!TxSchedulerPayloadIsBefore(con_state_ptr, &early, &early));
+    CHECK(TxSchedulerPayloadIsBefore(con_state_ptr, &late, &no_latency));
+
+    // A payload without a maximum latency that has waited long enough goes ahead of payloads with a deadline that
+    // were queued after it, so it can't be held back indefinitely.
+    no_latency.start_time = now - TX_SCHEDULER_NO_LATENCY_MAX_WAIT_MICROSECS;
+    CHECK(TxSchedulerPayloadIsBefore(con_state_ptr, &no_latency, &early));
+    CHECK(!TxSchedulerPayloadIsBefore(con_state_ptr, &early, &no_latency));
+
+    return true;
+}
+
+/**
+ * Test the estimate of whether a payload can meet its deadline.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestHopeless(TestSchedulerState* test_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    const uint64_t now = CdiOsGetMicroseconds();
+    TxPayloadState payload_state = { 0 };
+
+    // Payloads without a maximum latency are never hopeless.
+    TestPayloadInit(test_ptr, &payload_state, now - 1000000, 0);
+    CHECK(!TxPayloadIsHopeless(con_state_ptr, &payload_state));
+
+    // A payload whose deadline has passed is hopeless, even before the send rate is known.
+    TestPayloadInit(test_ptr, &payload_state, now - TEST_MAX_LATENCY_US * 2, TEST_MAX_LATENCY_US);
+    CdiOsAtomicStore32(&con_state_ptr->tx_state.deadline_bytes_per_millisec, 0);
+    CHECK(TxPayloadIsHopeless(con_state_ptr, &payload_state));
+
+    // A fresh payload can meet its deadline at 1 GB per second when little is in flight. The payload takes 100us.
+    TestPayloadInit(test_ptr, &payload_state, now, TEST_MAX_LATENCY_US);
+    CdiOsAtomicStore32(&con_state_ptr->tx_state.deadline_bytes_per_millisec, 1000000);
+    CdiOsAtomicStore32(&con_state_ptr->tx_state.deadline_in_flight_bytes, TEST_PAYLOAD_SIZE);
+    CHECK(!TxPayloadIsHopeless(con_state_ptr, &payload_state));
+
+    // It can't once the data in flight takes longer than its maximum latency to send.
+    CdiOsAtomicStore32(&con_state_ptr->tx_state.deadline_in_flight_bytes, TEST_MAX_LATENCY_US * 1000);
+    CHECK(TxPayloadIsHopeless(con_state_ptr, &payload_state));
+
+    // Nor if the connection is much slower.
+    CdiOsAtomicStore32(&con_state_ptr->tx_state.deadline_in_flight_bytes, 0);
+    CdiOsAtomicStore32(&con_state_ptr->tx_state.deadline_bytes_per_millisec, TEST_PAYLOAD_SIZE / 100);
+    CHECK(TxPayloadIsHopeless(con_state_ptr, &payload_state));
+
+    return true;
+}
+
+/**
+ * Test dropping a payload before it is packetized.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestDropEarly(TestSchedulerState* test_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    const int free_count = CdiPoolGetFreeItemCount(con_state_ptr->tx_state.payload_state_pool_handle);
+    TxPayloadState* payload_state_ptr = NULL;
+    CHECK(CdiPoolGet(con_state_ptr->tx_state.payload_state_pool_handle, (void**)&payload_state_ptr));
+    TestPayloadInit(test_ptr, payload_state_ptr, CdiOsGetMicroseconds(), TEST_MAX_LATENCY_US);
+    payload_state_ptr->app_payload_cb_data.core_extra_data.payload_user_data = 1234;
+    CdiOsAtomicStore32(&test_ptr->adapter_endpoint.tx_in_flight_ref_count, 1);
+
+    TxPayloadDropEarly(con_state_ptr, payload_state_ptr);
+
+    // The application is notified with the payload's source SGL, so it can free it.
+    AppPayloadCallbackData app_cb_data = { 0 };
+    CHECK(CdiQueuePop(con_state_ptr->app_payload_message_queue_handle, &app_cb_data));
+    CHECK(kCdiStatusMaxLatencyExceeded == app_cb_data.payload_status_code);
+    CHECK(TEST_PAYLOAD_SIZE == app_cb_data.tx_source_sgl.total_data_size);
+    CHECK(1234 == app_cb_data.core_extra_data.payload_user_data);
+    CHECK(CdiQueueIsEmpty(con_state_ptr->app_payload_message_queue_handle));
+
+    // The drop is counted separately and the payload's resources are released.
+    const CdiPayloadCounterStats* stats_ptr = &test_ptr->endpoint.transfer_stats.payload_counter_stats;
+    CHECK(1 == stats_ptr->num_payloads_dropped_early);
+    CHECK(0 == stats_ptr->num_payloads_dropped);
+    CHECK(0 == CdiOsAtomicLoad32(&test_ptr->adapter_endpoint.tx_in_flight_ref_count));
+    CHECK(free_count == CdiPoolGetFreeItemCount(con_state_ptr->tx_state.payload_state_pool_handle));
+
+    return true;
+}
+
+CdiReturnStatus TestUnitTxScheduler(void)
+{
+    TestSchedulerState* test_ptr = CdiOsMemAllocZero(sizeof(TestSchedulerState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    CdiOsStrCpy(test_ptr->con_state.saved_connection_name_str, sizeof(test_ptr->con_state.saved_connection_name_str),
+                "TestScheduler");
+    CdiOsStrCpy(test_ptr->endpoint.stream_name_str, sizeof(test_ptr->endpoint.stream_name_str), "TestStream");
+    test_ptr->endpoint.adapter_endpoint_ptr = &test_ptr->adapter_endpoint;
+
+    bool pass = CdiQueueCreate("TestSchedulerAppPayloadMessage", 4, CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE,
+                               sizeof(AppPayloadCallbackData), kQueueSignalNone,
+                               &test_ptr->con_state.app_payload_message_queue_handle) &&
+                CdiPoolCreate("TestSchedulerPayloadState", 2, 0, 0, sizeof(TxPayloadState), false,
+                              &test_ptr->con_state.tx_state.payload_state_pool_handle);
+
+    pass = pass && TestOrder(test_ptr) && TestHopeless(test_ptr) && TestDropEarly(test_ptr);
+
+    CdiPoolDestroy(test_ptr->con_state.tx_state.payload_state_pool_handle);
+    CdiQueueDestroy(test_ptr->con_state.app_payload_message_queue_handle);
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
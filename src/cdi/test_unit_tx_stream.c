@@ -0,0 +1,227 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for appending data to streaming Tx payloads through their handles.
+ */
+
+#include "internal_tx.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "cdi_pool_api.h"
+#include "internal.h"
+#include "private.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Size in bytes of the payloads used by the test.
+#define TEST_PAYLOAD_SIZE       (3000)
+
+/// Number of SGL entries in the pool used by the test.
+#define TEST_SGL_ENTRY_COUNT    (8)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return false; \
+        } \
+    } while (false);
+
+/**
+ * @brief State of the connection and endpoint used by the test. Only the members used to append data are set.
+ */
+typedef struct {
+    CdiConnectionState con_state;           ///< The connection.
+    CdiEndpointState endpoint;              ///< The connection's endpoint.
+    uint8_t data_array[TEST_PAYLOAD_SIZE];  ///< Data of every payload.
+    TxPayloadState payload_state;           ///< State used by every payload.
+} TestStreamState;
+
+/**
+ * Initialize the payload state and open a streaming payload with it.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return Handle of the payload.
+ */
+static CdiTxPayloadHandle TestPayloadOpen(TestStreamState* test_ptr)
+{
+    TxPayloadState* payload_state_ptr = &test_ptr->payload_state;
+    memset(payload_state_ptr, 0, sizeof(*payload_state_ptr));
+    payload_state_ptr->cdi_endpoint_handle = &test_ptr->endpoint;
+    return TxPayloadStreamOpen(&test_ptr->con_state, payload_state_ptr, TEST_PAYLOAD_SIZE);
+}
+
+/**
+ * Append data to a payload using an SGL of one or two entries.
+ *
+ * @param handle Handle of the payload.
+ * @param data_ptr Pointer to the data.
+ * @param size Number of bytes in the first entry.
+ * @param second_size Number of bytes in the second entry, zero for a single entry.
+ *
+ * @return The status returned by TxPayloadAppendInternal().
+ */
+static CdiReturnStatus TestAppend(CdiTxPayloadHandle handle, uint8_t* data_ptr, int size, int second_size)
+{
+    CdiSglEntry entry_array[2] = {
+        { .address_ptr = data_ptr, .size_in_bytes = size },
+        { .address_ptr = data_ptr + size, .size_in_bytes = second_size }
+    };
+    CdiSgList sgl = {
+        .total_data_size = size + second_size,
+        .sgl_head_ptr = &entry_array[0],
+        .sgl_tail_ptr = second_size ? &entry_array[1] : &entry_array[0]
+    };
+    if (second_size) {
+        entry_array[0].next_ptr = &entry_array[1];
+    }
+    return TxPayloadAppendInternal(handle, &sgl);
+}
+
+/**
+ * Free the SGL entries appended to the payload.
+ *
+ * @param test_ptr Pointer to test state.
+ */
+static void TestPayloadRelease(TestStreamState* test_ptr)
+{
+    FreeSglEntries(test_ptr->con_state.tx_state.payload_sgl_entry_pool_handle,
+                   test_ptr->payload_state.source_sgl.sgl_head_ptr);
+    test_ptr->payload_state.source_sgl.sgl_head_ptr = NULL;
+}
+
+/**
+ * Test appending a whole payload in parts.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestAppendParts(TestStreamState* test_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    const TxPayloadState* payload_state_ptr = &test_ptr->payload_state;
+    CdiPoolHandle pool_handle = con_state_ptr->tx_state.payload_sgl_entry_pool_handle;
+    const CdiTxPayloadHandle handle = TestPayloadOpen(test_ptr);
+    CHECK(payload_state_ptr->streaming);
+    CHECK(TEST_PAYLOAD_SIZE == payload_state_ptr->source_sgl.total_data_size);
+    CHECK(0 != handle.generation);
+
+    // Appending wakes up the payload thread.
+    CdiOsSignalClear(con_state_ptr->tx_state.payload_data_signal);
+    CHECK(kCdiStatusOk == TestAppend(handle, test_ptr->data_array, 1000, 0));
+    CHECK(1000 == CdiOsAtomicLoad32(&payload_state_ptr->stream_appended_bytes));
+    CHECK(CdiOsSignalGet(con_state_ptr->tx_state.payload_data_signal));
+
+    // Data beyond the payload's size is refused and none of it is appended.
+    const int free_count = CdiPoolGetFreeItemCount(pool_handle);
+    CHECK(kCdiStatusInvalidParameter == TestAppend(handle, test_ptr->data_array + 1000, 1000, 1001));
+    CHECK(1000 == CdiOsAtomicLoad32(&payload_state_ptr->stream_appended_bytes));
+    CHECK(free_count == CdiPoolGetFreeItemCount(pool_handle));
+
+    // Empty appends are accepted, and the entries of the last part are linked after the first one.
+    CHECK(kCdiStatusOk == TestAppend(handle, test_ptr->data_array + 1000, 0, 0));
+    CHECK(kCdiStatusOk == TestAppend(handle, test_ptr->data_array + 1000, 1500, 500));
+    CHECK(TEST_PAYLOAD_SIZE == CdiOsAtomicLoad32(&payload_state_ptr->stream_appended_bytes));
+    const CdiSglEntry* entry_ptr = payload_state_ptr->source_sgl.sgl_head_ptr;
+    CHECK(test_ptr->data_array == entry_ptr->address_ptr && 1000 == entry_ptr->size_in_bytes);
+    entry_ptr = entry_ptr->next_ptr;
+    CHECK(test_ptr->data_array + 1000 == entry_ptr->address_ptr && 1500 == entry_ptr->size_in_bytes);
+    CHECK(entry_ptr->next_ptr == payload_state_ptr->source_sgl.sgl_tail_ptr);
+
+    // Once the whole payload has been appended, the handle can't be used anymore, even for an empty append.
+    CHECK(kCdiStatusInvalidHandle == TestAppend(handle, test_ptr->data_array, 0, 0));
+
+    TestPayloadRelease(test_ptr);
+    return true;
+}
+
+/**
+ * Test that data can't be appended once a payload has been closed or flushed, nor through the handle of a payload
+ * whose state has been reused.
+ *
+ * @param test_ptr Pointer to test state.
+ *
+ * @return true if the test passed, otherwise false.
+ */
+static bool TestStaleHandles(TestStreamState* test_ptr)
+{
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    TxPayloadState* payload_state_ptr = &test_ptr->payload_state;
+    CdiPoolHandle pool_handle = con_state_ptr->tx_state.payload_sgl_entry_pool_handle;
+    const int free_count = CdiPoolGetFreeItemCount(pool_handle);
+
+    // A payload that was dropped or failed is closed before its SGL is handed back to the application.
+    const CdiTxPayloadHandle closed_handle = TestPayloadOpen(test_ptr);
+    CHECK(kCdiStatusOk == TestAppend(closed_handle, test_ptr->data_array, 100, 0));
+    TxPayloadStreamClose(con_state_ptr, payload_state_ptr);
+    CHECK(kCdiStatusInvalidHandle == TestAppend(closed_handle, test_ptr->data_array + 100, 100, 0));
+    CHECK(100 == CdiOsAtomicLoad32(&payload_state_ptr->stream_appended_bytes));
+    TestPayloadRelease(test_ptr);
+    CHECK(free_count == CdiPoolGetFreeItemCount(pool_handle));
+
+    // The same payload state is reused for the next payload. Only the new handle can append to it.
+    const CdiTxPayloadHandle new_handle = TestPayloadOpen(test_ptr);
+    CHECK(closed_handle.payload_state_ptr == new_handle.payload_state_ptr);
+    CHECK(kCdiStatusInvalidHandle == TestAppend(closed_handle, test_ptr->data_array, 100, 0));
+    CHECK(kCdiStatusOk == TestAppend(new_handle, test_ptr->data_array, 200, 0));
+    CHECK(200 == CdiOsAtomicLoad32(&payload_state_ptr->stream_appended_bytes));
+
+    // Flushing the connection's resources closes every payload opened so far, but not the ones opened later.
+    TxPayloadStreamFlush(con_state_ptr);
+    CHECK(kCdiStatusInvalidHandle == TestAppend(new_handle, test_ptr->data_array + 200, 100, 0));
+    TestPayloadRelease(test_ptr);
+    const CdiTxPayloadHandle flushed_later_handle = TestPayloadOpen(test_ptr);
+    CHECK(kCdiStatusOk == TestAppend(flushed_later_handle, test_ptr->data_array, 300, 0));
+    CHECK(300 == CdiOsAtomicLoad32(&payload_state_ptr->stream_appended_bytes));
+    TxPayloadStreamClose(con_state_ptr, payload_state_ptr);
+    TestPayloadRelease(test_ptr);
+    CHECK(free_count == CdiPoolGetFreeItemCount(pool_handle));
+
+    return true;
+}
+
+CdiReturnStatus TestUnitTxStream(void)
+{
+    TestStreamState* test_ptr = CdiOsMemAllocZero(sizeof(TestStreamState));
+    if (NULL == test_ptr) {
+        return kCdiStatusNotEnoughMemory;
+    }
+    CdiConnectionState* con_state_ptr = &test_ptr->con_state;
+    CdiOsStrCpy(con_state_ptr->saved_connection_name_str, sizeof(con_state_ptr->saved_connection_name_str),
+                "TestStream");
+    test_ptr->endpoint.connection_state_ptr = con_state_ptr;
+
+    bool pass = CdiOsCritSectionCreate(&con_state_ptr->tx_state.stream_lock) &&
+                CdiOsSignalCreate(&con_state_ptr->tx_state.payload_data_signal) &&
+                CdiPoolCreate("TestStreamSglEntries", TEST_SGL_ENTRY_COUNT, 0, 0, sizeof(CdiSglEntry), true,
+                              &con_state_ptr->tx_state.payload_sgl_entry_pool_handle);
+
+    pass = pass && TestAppendParts(test_ptr) && TestStaleHandles(test_ptr);
+
+    CdiPoolDestroy(con_state_ptr->tx_state.payload_sgl_entry_pool_handle);
+    CdiOsSignalDelete(con_state_ptr->tx_state.payload_data_signal);
+    CdiOsCritSectionDelete(con_state_ptr->tx_state.stream_lock);
+    CdiOsMemFree(test_ptr);
+
+    return pass ? kCdiStatusOk : kCdiStatusFatal;
+}
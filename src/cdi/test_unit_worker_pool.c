@@ -0,0 +1,297 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains a unit test for the worker pool functionality.
+ */
+
+#include "worker_pool.h"
+
+#include <stdbool.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "cdi_queue_api.h"
+
+static const bool verbose = false;  ///< Set to true to see passing test results.
+
+/// Number of tasks used by the test. More than the number of worker threads so threads are shared.
+#define TEST_TASK_COUNT         (5)
+
+/// Number of worker threads used by the test.
+#define TEST_THREAD_COUNT       (2)
+
+/// Number of work items pushed to each task.
+#define TEST_ITEMS_PER_TASK     (2000)
+
+/// Maximum number of work items a task processes each time it runs.
+#define TEST_ITEMS_PER_RUN      (3)
+
+/// Maximum time to wait for the worker pool to process all of the work items.
+#define TEST_TIMEOUT_MS         (5000)
+
+/// Number of join tasks used by the join tests.
+#define TEST_JOIN_TASK_COUNT    (4)
+
+/// Number of times the join tasks are started and waited for by the join test that uses several worker threads.
+#define TEST_JOIN_ITERATIONS    (2000)
+
+/**
+ * This macro performs a test. Call it with a conditional expression that must be true in order for the unit test to
+ * pass.
+ */
+#define CHECK(condition) \
+    do { \
+        if (condition) { \
+            if (verbose) CDI_LOG_THREAD(kLogInfo, "%s OK", #condition); \
+        } else { \
+            CDI_LOG_THREAD(kLogError, "%s failed", #condition); \
+            return kCdiStatusFatal; \
+        } \
+    } while (false);
+
+/**
+ * @brief State data for a single test task.
+ */
+typedef struct {
+    WorkerPoolTask task;        ///< The worker pool task.
+    CdiQueueHandle queue_handle; ///< Queue of work items (sequence numbers) for the task.
+    uint32_t running;           ///< Non-zero while the task function is running. Only accessed atomically.
+    int next_expected;          ///< The next sequence number the task expects to receive.
+    int processed_count;        ///< Number of work items processed.
+    int error_count;            ///< Number of overlapping runs or out of order work items detected.
+} TestTaskState;
+
+/**
+ * Task function used by the test. Processes up to TEST_ITEMS_PER_RUN work items, checking that they arrive in order
+ * and that the function is never run concurrently for the same task.
+ *
+ * @param arg_ptr Pointer to TestTaskState.
+ *
+ * @return true if work items may remain in the task's queue.
+ */
+static bool TestTaskFunction(void* arg_ptr)
+{
+    TestTaskState* state_ptr = (TestTaskState*)arg_ptr;
+
+    if (1 != CdiOsAtomicInc32(&state_ptr->running)) {
+        state_ptr->error_count++;
+    }
+
+    bool more_work = true;
+    for (int i = 0; i < TEST_ITEMS_PER_RUN && more_work; i++) {
+        int sequence_num = 0;
+        if (CdiQueuePop(state_ptr->queue_handle, &sequence_num)) {
+            if (sequence_num != state_ptr->next_expected) {
+                state_ptr->error_count++;
+            }
+            state_ptr->next_expected = sequence_num + 1;
+            state_ptr->processed_count++;
+        } else {
+            more_work = false;
+        }
+    }
+
+    CdiOsAtomicDec32(&state_ptr->running);
+
+    return more_work;
+}
+
+/**
+ * @brief State data for a single test join task.
+ */
+typedef struct {
+    WorkerPoolJoinTask join_task; ///< The join task.
+    int input;                    ///< Value set before the task is started.
+    int output;                   ///< Copy of input made by the task's function.
+    uint32_t run_count;           ///< Number of times the task's function ran. Only accessed atomically.
+} TestJoinTaskState;
+
+/**
+ * Join task function used by the test.
+ *
+ * @param arg_ptr Pointer to TestJoinTaskState.
+ */
+static void TestJoinTaskFunction(void* arg_ptr)
+{
+    TestJoinTaskState* state_ptr = (TestJoinTaskState*)arg_ptr;
+    state_ptr->output = state_ptr->input;
+    CdiOsAtomicInc32(&state_ptr->run_count);
+}
+
+/**
+ * Task function that keeps its worker thread busy until a signal is set.
+ *
+ * @param arg_ptr The signal.
+ *
+ * @return Always false.
+ */
+static bool TestBlockingTaskFunction(void* arg_ptr)
+{
+    CdiOsSignalWait((CdiSignalType)arg_ptr, CDI_INFINITE, NULL);
+    return false;
+}
+
+/**
+ * Test that waiting for join tasks doesn't depend on a worker thread being free. The pool's only thread is kept busy,
+ * so the joining thread must do the work of every join task itself.
+ *
+ * @return kCdiStatusOk if the test passed.
+ */
+static CdiReturnStatus TestJoinBlockedPool(void)
+{
+    WorkerPoolHandle pool_handle = NULL;
+    CHECK(kCdiStatusOk == WorkerPoolCreate(1, NULL, &pool_handle));
+    CdiSignalType release_signal = NULL;
+    CHECK(CdiOsSignalCreate(&release_signal));
+    WorkerPoolTask blocking_task = { 0 };
+    WorkerPoolTaskInit(pool_handle, &blocking_task, TestBlockingTaskFunction, release_signal, NULL);
+    WorkerPoolTaskSchedule(&blocking_task);
+
+    WorkerPoolJoin join = { 0 };
+    CHECK(WorkerPoolJoinCreate(&join));
+    TestJoinTaskState task_array[TEST_JOIN_TASK_COUNT] = { 0 };
+    for (int i = 0; i < TEST_JOIN_TASK_COUNT; i++) {
+        WorkerPoolJoinTaskInit(pool_handle, &join, &task_array[i].join_task, TestJoinTaskFunction, &task_array[i],
+                               NULL);
+        task_array[i].input = i + 1;
+        WorkerPoolJoinTaskStart(&task_array[i].join_task);
+    }
+    WorkerPoolJoinWait(&join);
+    for (int i = 0; i < TEST_JOIN_TASK_COUNT; i++) {
+        CHECK(i + 1 == task_array[i].output);
+        CHECK(1 == CdiOsAtomicLoad32(&task_array[i].run_count));
+    }
+
+    // Once the worker thread is free, the requests it had queued for the join tasks must not run their work again.
+    CdiOsSignalSet(release_signal);
+    WorkerPoolTaskStop(&blocking_task);
+    for (int i = 0; i < TEST_JOIN_TASK_COUNT; i++) {
+        uint64_t start_ms = CdiOsGetMilliseconds();
+        while (0 != CdiOsAtomicLoad32(&task_array[i].join_task.task.pending_count) &&
+               CdiOsGetMilliseconds() - start_ms < TEST_TIMEOUT_MS) {
+            CdiOsSleep(1);
+        }
+        WorkerPoolJoinTaskStop(&task_array[i].join_task);
+        CHECK(1 == CdiOsAtomicLoad32(&task_array[i].run_count));
+    }
+
+    WorkerPoolJoinDestroy(&join);
+    WorkerPoolDestroy(pool_handle);
+    CdiOsSignalDelete(release_signal);
+
+    return kCdiStatusOk;
+}
+
+/**
+ * Test that the work of each join task is done exactly once each time it is started, with the data written before it
+ * was started, whether it is done by a worker thread or by the joining thread.
+ *
+ * @return kCdiStatusOk if the test passed.
+ */
+static CdiReturnStatus TestJoinIterations(void)
+{
+    WorkerPoolHandle pool_handle = NULL;
+    CHECK(kCdiStatusOk == WorkerPoolCreate(TEST_THREAD_COUNT, NULL, &pool_handle));
+
+    WorkerPoolJoin join = { 0 };
+    CHECK(WorkerPoolJoinCreate(&join));
+    TestJoinTaskState task_array[TEST_JOIN_TASK_COUNT] = { 0 };
+    for (int i = 0; i < TEST_JOIN_TASK_COUNT; i++) {
+        WorkerPoolJoinTaskInit(pool_handle, &join, &task_array[i].join_task, TestJoinTaskFunction, &task_array[i],
+                               NULL);
+    }
+
+    for (int n = 1; n <= TEST_JOIN_ITERATIONS; n++) {
+        for (int i = 0; i < TEST_JOIN_TASK_COUNT; i++) {
+            task_array[i].input = n * TEST_JOIN_TASK_COUNT + i;
+            WorkerPoolJoinTaskStart(&task_array[i].join_task);
+        }
+        WorkerPoolJoinWait(&join);
+        for (int i = 0; i < TEST_JOIN_TASK_COUNT; i++) {
+            CHECK(n * TEST_JOIN_TASK_COUNT + i == task_array[i].output);
+            CHECK((uint32_t)n == CdiOsAtomicLoad32(&task_array[i].run_count));
+        }
+    }
+
+    for (int i = 0; i < TEST_JOIN_TASK_COUNT; i++) {
+        WorkerPoolJoinTaskStop(&task_array[i].join_task);
+        CHECK(TEST_JOIN_ITERATIONS == CdiOsAtomicLoad32(&task_array[i].run_count));
+    }
+    WorkerPoolJoinDestroy(&join);
+    WorkerPoolDestroy(pool_handle);
+
+    return kCdiStatusOk;
+}
+
+CdiReturnStatus TestUnitWorkerPool(void)
+{
+    WorkerPoolHandle pool_handle = NULL;
+    CHECK(kCdiStatusOk == WorkerPoolCreate(TEST_THREAD_COUNT, NULL, &pool_handle));
+
+    // Scheduling a task that was never initialized must be harmless.
+    WorkerPoolTask unused_task = { 0 };
+    WorkerPoolTaskSchedule(&unused_task);
+    WorkerPoolTaskStop(&unused_task);
+
+    TestTaskState task_array[TEST_TASK_COUNT] = { 0 };
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        CHECK(CdiQueueCreate("Test Task Queue", TEST_ITEMS_PER_TASK, CDI_FIXED_QUEUE_SIZE, CDI_FIXED_QUEUE_SIZE,
+                             sizeof(int), kQueueSignalNone, &task_array[i].queue_handle));
+        WorkerPoolTaskInit(pool_handle, &task_array[i].task, TestTaskFunction, &task_array[i], NULL);
+    }
+
+    // Push work items to all of the tasks, scheduling each task after every push like the SDK does.
+    for (int n = 0; n < TEST_ITEMS_PER_TASK; n++) {
+        for (int i = 0; i < TEST_TASK_COUNT; i++) {
+            CHECK(CdiQueuePush(task_array[i].queue_handle, &n));
+            WorkerPoolTaskSchedule(&task_array[i].task);
+        }
+    }
+
+    // Wait for all of the scheduling requests to drain.
+    uint64_t start_ms = CdiOsGetMilliseconds();
+    bool done = false;
+    while (!done && CdiOsGetMilliseconds() - start_ms < TEST_TIMEOUT_MS) {
+        done = true;
+        for (int i = 0; i < TEST_TASK_COUNT; i++) {
+            done = done && (0 == CdiOsAtomicLoad32(&task_array[i].task.pending_count));
+        }
+        if (!done) {
+            CdiOsSleep(1);
+        }
+    }
+    CHECK(done);
+
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        WorkerPoolTaskStop(&task_array[i].task);
+        CHECK(0 == task_array[i].error_count);
+        CHECK(TEST_ITEMS_PER_TASK == task_array[i].processed_count);
+        CHECK(CdiQueueIsEmpty(task_array[i].queue_handle));
+
+        // A stopped task must ignore scheduling requests.
+        int n = 0;
+        CHECK(CdiQueuePush(task_array[i].queue_handle, &n));
+        WorkerPoolTaskSchedule(&task_array[i].task);
+        CHECK(0 == (CdiOsAtomicLoad32(&task_array[i].task.pending_count) & ~0x80000000u));
+        CHECK(CdiQueuePop(task_array[i].queue_handle, &n));
+    }
+
+    WorkerPoolDestroy(pool_handle);
+
+    for (int i = 0; i < TEST_TASK_COUNT; i++) {
+        CHECK(TEST_ITEMS_PER_TASK == task_array[i].processed_count);
+        CdiQueueDestroy(task_array[i].queue_handle);
+    }
+
+    CHECK(kCdiStatusOk == TestJoinBlockedPool());
+    CHECK(kCdiStatusOk == TestJoinIterations());
+
+    return kCdiStatusOk;
+}
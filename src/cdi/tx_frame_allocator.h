@@ -0,0 +1,48 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * The declarations in this header file correspond to the internal definitions in cdi_tx_frame_allocator_api.c. They
+ * are used by the Tx logic to return frames to their allocator once the payloads that use them have been transmitted.
+ */
+
+#ifndef CDI_TX_FRAME_ALLOCATOR_H__
+#define CDI_TX_FRAME_ALLOCATOR_H__
+
+#include <stdbool.h>
+
+#include "cdi_tx_frame_allocator_api.h"
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+/**
+ * Check whether a scatter-gather list looks like a frame that was allocated using CdiTxFrameAlloc(), without using the
+ * allocator list or its lock. Frame lists are self-referencing: internal_data_ptr points to the frame's state and the
+ * list's only entry is part of that state. Used when a Tx payload is queued, so the SDK's copy of the list only keeps
+ * internal_data_ptr for frames and TxFrameAllocatorRelease() returns right away for all other payloads.
+ *
+ * @param sgl_ptr Pointer to the application's scatter-gather list. Its internal_data_ptr is not dereferenced.
+ *
+ * @return true if the list may be a frame, false if it is not one.
+ */
+bool TxFrameAllocatorSglIsFrame(const CdiSgList* sgl_ptr);
+
+/**
+ * If a Tx payload's scatter-gather list is a frame that was allocated using CdiTxFrameAlloc(), return the frame to its
+ * stream. Otherwise do nothing.
+ *
+ * @param sgl_ptr Pointer to the payload's scatter-gather list. Only its internal_data_ptr is used, so the SDK's copy of
+ *                the application's list can be used.
+ *
+ * @return true if the list was a frame and it was returned, otherwise false.
+ */
+bool TxFrameAllocatorRelease(const CdiSgList* sgl_ptr);
+
+#endif // CDI_TX_FRAME_ALLOCATOR_H__
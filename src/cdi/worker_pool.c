@@ -0,0 +1,361 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * This file contains the definitions for the SDK worker pool. The pool contains a fixed number of threads. Each thread
+ * has its own queue of tasks that are ready to run. A task is bound to a single thread when it is initialized and a
+ * counter within the task ensures that it is in its thread's queue at most once. Together this means a task's function
+ * is never invoked concurrently and the work for a task is processed in the order it was scheduled.
+ */
+
+// Include headers in the following order: Related header, C system headers, other libraries' headers, your project's
+// headers.
+
+#include "worker_pool.h"
+
+#include <assert.h>
+
+#include "cdi_os_api.h"
+#include "cdi_queue_api.h"
+#include "internal_log.h"
+
+//*********************************************************************************************************************
+//***************************************** START OF DEFINITIONS AND TYPES ********************************************
+//*********************************************************************************************************************
+
+/// Bit set in WorkerPoolTask.pending_count once a task has been stopped.
+#define TASK_STOPPED_FLAG       (0x80000000u)
+
+/// Mask used to get the scheduling count from WorkerPoolTask.pending_count.
+#define TASK_PENDING_COUNT_MASK (~TASK_STOPPED_FLAG)
+
+/**
+ * @brief State data for a single thread in the worker pool.
+ */
+struct WorkerThreadState {
+    WorkerPoolHandle pool_handle;     ///< Handle of the pool this thread belongs to.
+    CdiThreadID thread_id;            ///< Thread identifier.
+    CdiQueueHandle ready_queue_handle; ///< Queue of WorkerPoolTask pointers that are ready to run on this thread.
+};
+
+/// @brief Forward reference of structure to create pointers later.
+typedef struct WorkerPoolState WorkerPoolState;
+
+/**
+ * @brief State data for a worker pool.
+ */
+struct WorkerPoolState {
+    CdiSignalType shutdown_signal;    ///< Signal used to stop the worker threads.
+    int thread_count;                 ///< Number of entries in worker_array.
+    uint32_t next_worker_index;       ///< Used to distribute tasks across the threads. Only accessed atomically.
+    WorkerThreadState* worker_array;  ///< Array of worker thread state data.
+};
+
+//*********************************************************************************************************************
+//*********************************************** START OF VARIABLES **************************************************
+//*********************************************************************************************************************
+
+//*********************************************************************************************************************
+//******************************************* START OF STATIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+/**
+ * Put a task in the ready queue of the worker thread it is bound to.
+ *
+ * @param task_ptr Pointer to task.
+ */
+static void TaskEnqueue(WorkerPoolTask* task_ptr)
+{
+    if (!CdiQueuePush(task_ptr->worker_ptr->ready_queue_handle, &task_ptr)) {
+        // Each task is in the queue at most once, so this only happens if the queue cannot grow to hold every task
+        // bound to the thread.
+        SDK_LOG_GLOBAL(kLogError, "Failed to push task to queue[%s].",
+                       CdiQueueGetName(task_ptr->worker_ptr->ready_queue_handle));
+        assert(false);
+    }
+}
+
+/**
+ * Run a task that was taken from a worker thread's ready queue.
+ *
+ * @param task_ptr Pointer to task.
+ */
+static void TaskRun(WorkerPoolTask* task_ptr)
+{
+    // Capture the number of scheduling requests that this run will satisfy. Requests that arrive while the function is
+    // running are left in the count so the task gets queued again below.
+    uint32_t pending_count = CdiOsAtomicLoad32(&task_ptr->pending_count);
+    uint32_t run_count = pending_count & TASK_PENDING_COUNT_MASK;
+
+    bool more_work = false;
+    if (0 == (pending_count & TASK_STOPPED_FLAG)) {
+        CdiLoggerThreadLogSet(task_ptr->log_handle);
+        more_work = (task_ptr->func_ptr)(task_ptr->arg_ptr);
+    }
+    if (more_work) {
+        // Leave one request in the count so the task is queued again. Putting it at the back of the queue keeps a busy
+        // task from starving the other tasks bound to this thread.
+        run_count--;
+    }
+
+    uint32_t remaining_count = CdiOsAtomicAdd32(&task_ptr->pending_count, (uint32_t)0 - run_count);
+    if (remaining_count & TASK_PENDING_COUNT_MASK) {
+        TaskEnqueue(task_ptr);
+    }
+}
+
+/**
+ * Worker thread that runs tasks from its ready queue until the pool is shutdown.
+ *
+ * @param ptr Pointer to thread specific data. In this case, a pointer to WorkerThreadState.
+ *
+ * @return The return value is not used.
+ */
+static CDI_THREAD WorkerThread(void* ptr)
+{
+    WorkerThreadState* worker_ptr = (WorkerThreadState*)ptr;
+    CdiSignalType shutdown_signal = worker_ptr->pool_handle->shutdown_signal;
+
+    while (!CdiOsSignalReadState(shutdown_signal)) {
+        WorkerPoolTask* task_ptr = NULL;
+        if (CdiQueuePopWait(worker_ptr->ready_queue_handle, CDI_INFINITE, shutdown_signal, (void**)&task_ptr)) {
+            TaskRun(task_ptr);
+        }
+    }
+
+    return 0; // Return code not used.
+}
+
+/**
+ * Do the work of a join task if no other thread has taken it, and signal the joining thread if it was the last work of
+ * the join.
+ *
+ * @param join_task_ptr Pointer to join task.
+ */
+static void JoinTaskClaimAndRun(WorkerPoolJoinTask* join_task_ptr)
+{
+    if (CdiOsAtomicCompareAndSwap32(&join_task_ptr->claimed, 0, 1)) {
+        WorkerPoolJoin* join_ptr = join_task_ptr->join_ptr;
+        (join_task_ptr->func_ptr)(join_task_ptr->arg_ptr);
+        if (0 == CdiOsAtomicDec32(&join_ptr->busy_count)) {
+            CdiOsSignalSet(join_ptr->done_signal);
+        }
+    }
+}
+
+/**
+ * Worker pool task function of a join task.
+ *
+ * @param arg_ptr Pointer to WorkerPoolJoinTask.
+ *
+ * @return Always false, since all of the work is done.
+ */
+static bool JoinTaskFunction(void* arg_ptr)
+{
+    // If the joining thread already did the work, this does nothing.
+    JoinTaskClaimAndRun((WorkerPoolJoinTask*)arg_ptr);
+    return false;
+}
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+CdiReturnStatus WorkerPoolCreate(int thread_count, const int* core_array, WorkerPoolHandle* ret_handle_ptr)
+{
+    // NOTE: Since the caller is the application's thread, use SDK_LOG_GLOBAL() for any logging in this function.
+    CdiReturnStatus rs = kCdiStatusOk;
+
+    if (thread_count <= 0 || thread_count > MAX_WORKER_POOL_THREADS) {
+        SDK_LOG_GLOBAL(kLogError, "Worker pool thread count[%d] must be between 1 and [%d].", thread_count,
+                       MAX_WORKER_POOL_THREADS);
+        rs = kCdiStatusInvalidParameter;
+    }
+
+    WorkerPoolState* pool_ptr = NULL;
+    if (kCdiStatusOk == rs) {
+        pool_ptr = CdiOsMemAllocZero(sizeof(WorkerPoolState));
+        if (NULL == pool_ptr) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        pool_ptr->worker_array = CdiOsMemAllocZero(sizeof(WorkerThreadState) * thread_count);
+        if (NULL == pool_ptr->worker_array) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    if (kCdiStatusOk == rs) {
+        if (!CdiOsSignalCreate(&pool_ptr->shutdown_signal)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+    }
+
+    for (int i = 0; kCdiStatusOk == rs && i < thread_count; i++) {
+        WorkerThreadState* worker_ptr = &pool_ptr->worker_array[i];
+        worker_ptr->pool_handle = pool_ptr;
+        // Any number of threads can schedule a task, so the ready queue needs multiple writer support.
+        if (!CdiQueueCreate("WorkerPool Ready Task Queue", WORKER_POOL_READY_QUEUE_SIZE, WORKER_POOL_READY_QUEUE_GROW,
+                            MAX_QUEUE_GROW_COUNT, sizeof(WorkerPoolTask*),
+                            kQueueSignalPopWait | kQueueMultipleWritersFlag, &worker_ptr->ready_queue_handle)) {
+            rs = kCdiStatusNotEnoughMemory;
+        }
+        if (kCdiStatusOk == rs) {
+            pool_ptr->thread_count++; // Only count threads that need to be cleaned up.
+            int core_num = core_array ? core_array[i] : -1;
+            if (!CdiOsThreadCreatePinned(WorkerThread, &worker_ptr->thread_id, "WorkerPool", worker_ptr,
+                                         NULL, // NULL= Start thread immediately.
+                                         core_num)) {
+                rs = kCdiStatusCreateThreadFailed;
+            }
+        }
+    }
+
+    if (kCdiStatusOk != rs) {
+        WorkerPoolDestroy(pool_ptr);
+        pool_ptr = NULL;
+    }
+
+    *ret_handle_ptr = pool_ptr;
+
+    return rs;
+}
+
+void WorkerPoolDestroy(WorkerPoolHandle handle)
+{
+    WorkerPoolState* pool_ptr = (WorkerPoolState*)handle;
+    if (pool_ptr) {
+        if (pool_ptr->shutdown_signal) {
+            CdiOsSignalSet(pool_ptr->shutdown_signal);
+        }
+        for (int i = 0; i < pool_ptr->thread_count; i++) {
+            WorkerThreadState* worker_ptr = &pool_ptr->worker_array[i];
+            if (worker_ptr->thread_id) {
+                CdiOsThreadJoin(worker_ptr->thread_id, CDI_INFINITE, NULL);
+                worker_ptr->thread_id = NULL;
+            }
+            CdiQueueDestroy(worker_ptr->ready_queue_handle);
+            worker_ptr->ready_queue_handle = NULL;
+        }
+        CdiOsSignalDelete(pool_ptr->shutdown_signal);
+        pool_ptr->shutdown_signal = NULL;
+
+        CdiOsMemFree(pool_ptr->worker_array);
+        CdiOsMemFree(pool_ptr);
+    }
+}
+
+void WorkerPoolTaskInit(WorkerPoolHandle handle, WorkerPoolTask* task_ptr, WorkerPoolTaskFunction func_ptr,
+                        void* arg_ptr, CdiLogHandle log_handle)
+{
+    WorkerPoolState* pool_ptr = (WorkerPoolState*)handle;
+    uint32_t index = CdiOsAtomicInc32(&pool_ptr->next_worker_index);
+
+    task_ptr->func_ptr = func_ptr;
+    task_ptr->arg_ptr = arg_ptr;
+    task_ptr->log_handle = log_handle;
+    CdiOsAtomicStore32(&task_ptr->pending_count, 0);
+    task_ptr->worker_ptr = &pool_ptr->worker_array[index % pool_ptr->thread_count];
+}
+
+void WorkerPoolTaskSchedule(WorkerPoolTask* task_ptr)
+{
+    if (NULL == task_ptr->worker_ptr) {
+        return; // Task not initialized (worker pool not in use).
+    }
+
+    uint32_t pending_count = 0;
+    do {
+        pending_count = CdiOsAtomicLoad32(&task_ptr->pending_count);
+        if (pending_count & TASK_STOPPED_FLAG) {
+            return;
+        }
+    } while (!CdiOsAtomicCompareAndSwap32(&task_ptr->pending_count, pending_count, pending_count + 1));
+
+    // Only the request that takes the count from zero queues the task. Otherwise it is either already queued or
+    // running, in which case TaskRun() will queue it again.
+    if (0 == pending_count) {
+        TaskEnqueue(task_ptr);
+    }
+}
+
+void WorkerPoolTaskStop(WorkerPoolTask* task_ptr)
+{
+    if (NULL == task_ptr->worker_ptr) {
+        return;
+    }
+
+    uint32_t pending_count = 0;
+    do {
+        pending_count = CdiOsAtomicLoad32(&task_ptr->pending_count);
+    } while (!CdiOsAtomicCompareAndSwap32(&task_ptr->pending_count, pending_count,
+                                          pending_count | TASK_STOPPED_FLAG));
+
+    // Wait for the worker thread to drain any requests that are still queued or running.
+    while (CdiOsAtomicLoad32(&task_ptr->pending_count) & TASK_PENDING_COUNT_MASK) {
+        CdiOsSleepMicroseconds(WORKER_POOL_STOP_POLL_MICROSECONDS);
+    }
+}
+
+bool WorkerPoolJoinCreate(WorkerPoolJoin* join_ptr)
+{
+    CdiOsAtomicStore32(&join_ptr->busy_count, 0);
+    CdiSinglyLinkedListInit(&join_ptr->started_list);
+    return CdiOsSignalCreate(&join_ptr->done_signal);
+}
+
+void WorkerPoolJoinDestroy(WorkerPoolJoin* join_ptr)
+{
+    if (join_ptr->done_signal) {
+        CdiOsSignalDelete(join_ptr->done_signal);
+        join_ptr->done_signal = NULL;
+    }
+}
+
+void WorkerPoolJoinTaskInit(WorkerPoolHandle handle, WorkerPoolJoin* join_ptr, WorkerPoolJoinTask* join_task_ptr,
+                            WorkerPoolJoinFunction func_ptr, void* arg_ptr, CdiLogHandle log_handle)
+{
+    join_task_ptr->join_ptr = join_ptr;
+    join_task_ptr->func_ptr = func_ptr;
+    join_task_ptr->arg_ptr = arg_ptr;
+    CdiOsAtomicStore32(&join_task_ptr->claimed, 1); // Nothing to claim until the task is started.
+    WorkerPoolTaskInit(handle, &join_task_ptr->task, JoinTaskFunction, join_task_ptr, log_handle);
+}
+
+void WorkerPoolJoinTaskStart(WorkerPoolJoinTask* join_task_ptr)
+{
+    WorkerPoolJoin* join_ptr = join_task_ptr->join_ptr;
+    CdiOsAtomicInc32(&join_ptr->busy_count);
+    CdiSinglyLinkedListPushTail(&join_ptr->started_list, &join_task_ptr->list_entry);
+    // The compare and swap is a full barrier, so the caller's data is visible to the thread that claims the work.
+    CdiOsAtomicCompareAndSwap32(&join_task_ptr->claimed, 1, 0);
+    WorkerPoolTaskSchedule(&join_task_ptr->task);
+}
+
+void WorkerPoolJoinTaskStop(WorkerPoolJoinTask* join_task_ptr)
+{
+    WorkerPoolTaskStop(&join_task_ptr->task);
+}
+
+void WorkerPoolJoinWait(WorkerPoolJoin* join_ptr)
+{
+    // Do the work that no worker thread has started yet, then wait for the work that is running.
+    CdiSinglyLinkedListEntry* entry_ptr = NULL;
+    while (NULL != (entry_ptr = CdiSinglyLinkedListPopHead(&join_ptr->started_list))) {
+        JoinTaskClaimAndRun((WorkerPoolJoinTask*)entry_ptr);
+    }
+
+    // The signal may have been left set by the last wait, so clear it and check the count again after each wake up.
+    // The count is decremented before the signal is set, so a signal cleared here is never missed.
+    while (0 != CdiOsAtomicLoad32(&join_ptr->busy_count)) {
+        CdiOsSignalWait(join_ptr->done_signal, CDI_INFINITE, NULL);
+        CdiOsSignalClear(join_ptr->done_signal);
+    }
+}
@@ -0,0 +1,210 @@
+// -------------------------------------------------------------------------------------------
+// Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+// This file is part of the AWS CDI-SDK, licensed under the BSD 2-Clause "Simplified" License.
+// License details at: https://github.com/aws/aws-cdi-sdk/blob/mainline/LICENSE
+// -------------------------------------------------------------------------------------------
+
+/**
+ * @file
+ * @brief
+ * The declarations in this header file correspond to the definitions in worker_pool.c.
+ *
+ * The worker pool is a fixed-size set of SDK threads, optionally pinned to CPU cores, that run per-connection work as
+ * tasks instead of using a dedicated thread per connection. Each task is bound to a single worker thread when it is
+ * initialized and is never queued more than once, so the work for a given task is always processed in order and never
+ * concurrently.
+ */
+
+#ifndef CDI_WORKER_POOL_H__
+#define CDI_WORKER_POOL_H__
+
+// The configuration.h file must be included first since it can have defines that affect subsequent files.
+#include "configuration.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cdi_core_api.h"
+#include "cdi_logger_api.h"
+#include "cdi_os_api.h"
+#include "singly_linked_list_api.h"
+
+//*********************************************************************************************************************
+//***************************************** START OF DEFINITIONS AND TYPES ********************************************
+//*********************************************************************************************************************
+
+/**
+ * @brief Type used as the handle (pointer to an opaque structure) for a worker pool.
+ */
+typedef struct WorkerPoolState* WorkerPoolHandle;
+
+/// @brief Forward reference of structure to create pointers later.
+typedef struct WorkerThreadState WorkerThreadState;
+
+/**
+ * Prototype of the function that is invoked by a worker thread to service a task. The function should process the work
+ * that is currently available without blocking.
+ *
+ * @param arg_ptr The argument provided to WorkerPoolTaskInit().
+ *
+ * @return true if the function stopped before all of the available work was processed and it wants to be invoked
+ *         again, otherwise false.
+ */
+typedef bool (*WorkerPoolTaskFunction)(void* arg_ptr);
+
+/**
+ * @brief A unit of work that is run by the worker pool. Normally this structure is embedded in the state data of the
+ * object that owns the work (ie. a connection), so its memory remains valid until the object is freed. A zeroed
+ * structure is valid and WorkerPoolTaskSchedule() will ignore it.
+ */
+typedef struct {
+    WorkerThreadState* worker_ptr;     ///< Pointer to the worker thread this task is bound to. NULL if not initialized.
+    WorkerPoolTaskFunction func_ptr;   ///< Function to invoke when the task is run.
+    void* arg_ptr;                     ///< Argument passed to func_ptr.
+    CdiLogHandle log_handle;           ///< Log to use while running the task. If NULL, the global logger is used.
+
+    /// @brief Number of times the task has been scheduled since it was last run. Bit 31 is set once the task has been
+    /// stopped. Only accessed using atomic operations.
+    uint32_t pending_count;
+} WorkerPoolTask;
+
+/**
+ * Prototype of the function that is invoked to do the work of a join task. See WorkerPoolJoinTaskInit().
+ *
+ * @param arg_ptr The argument provided to WorkerPoolJoinTaskInit().
+ */
+typedef void (*WorkerPoolJoinFunction)(void* arg_ptr);
+
+/**
+ * @brief A set of join tasks that a thread starts and then waits for, so work can be split across the worker threads.
+ * Since worker threads may be busy with other tasks, WorkerPoolJoinWait() does the work of any join task that no
+ * worker thread has started yet itself instead of waiting for a worker thread to become free.
+ */
+typedef struct {
+    CdiSignalType done_signal;        ///< Set when the busy count drops to zero.
+    uint32_t busy_count;              ///< Number of started join tasks that are not done. Only accessed atomically.
+    CdiSinglyLinkedList started_list; ///< Join tasks started since the last wait. Only used by the joining thread.
+} WorkerPoolJoin;
+
+/**
+ * @brief A unit of work that is run by a worker thread or by the thread that waits for it. See WorkerPoolJoin.
+ */
+typedef struct {
+    CdiSinglyLinkedListEntry list_entry; ///< Entry in WorkerPoolJoin.started_list. Must be first.
+    WorkerPoolTask task;                 ///< Task used to run the work on a worker thread.
+    WorkerPoolJoin* join_ptr;            ///< Pointer to the join this task belongs to.
+    WorkerPoolJoinFunction func_ptr;     ///< Function that does the work.
+    void* arg_ptr;                       ///< Argument passed to func_ptr.
+    /// @brief Zero once the task is started, until a thread takes its work. Only accessed atomically.
+    uint32_t claimed;
+} WorkerPoolJoinTask;
+
+//*********************************************************************************************************************
+//******************************************* START OF PUBLIC FUNCTIONS ***********************************************
+//*********************************************************************************************************************
+
+/**
+ * Create a worker pool and start its threads.
+ *
+ * @param thread_count Number of worker threads to create. Must be greater than zero.
+ * @param core_array Optional array of thread_count CPU core numbers used to pin the worker threads. If NULL, the
+ *                   threads are not pinned. An entry of -1 disables pinning for the related thread.
+ * @param ret_handle_ptr Address where to write the handle of the new worker pool.
+ *
+ * @return A value from the CdiReturnStatus enumeration.
+ */
+CdiReturnStatus WorkerPoolCreate(int thread_count, const int* core_array, WorkerPoolHandle* ret_handle_ptr);
+
+/**
+ * Stop all worker threads and free resources used by the worker pool. All tasks must have been stopped using
+ * WorkerPoolTaskStop() before calling this function.
+ *
+ * @param handle Handle of worker pool to destroy. May be NULL.
+ */
+void WorkerPoolDestroy(WorkerPoolHandle handle);
+
+/**
+ * Initialize a task and bind it to one of the threads in the worker pool. Tasks are distributed across the threads
+ * round-robin.
+ *
+ * @param handle Handle of worker pool.
+ * @param task_ptr Pointer to task to initialize.
+ * @param func_ptr Function to invoke when the task is run.
+ * @param arg_ptr Argument to pass to func_ptr.
+ * @param log_handle Log to use while the task is running. If NULL, the global logger is used.
+ */
+void WorkerPoolTaskInit(WorkerPoolHandle handle, WorkerPoolTask* task_ptr, WorkerPoolTaskFunction func_ptr,
+                        void* arg_ptr, CdiLogHandle log_handle);
+
+/**
+ * Request that a task be run. If the task is not already waiting to run, it is queued to its worker thread. If the task
+ * is currently running, it will be run again after it returns. This function is thread-safe and never blocks. It does
+ * nothing if the task was not initialized or has been stopped.
+ *
+ * @param task_ptr Pointer to task to schedule.
+ */
+void WorkerPoolTaskSchedule(WorkerPoolTask* task_ptr);
+
+/**
+ * Stop a task. Once this function returns, the task's function is not running and will not be invoked again. Later
+ * calls to WorkerPoolTaskSchedule() for the task are ignored, but the task's memory must remain valid until no other
+ * thread can call it.
+ *
+ * @param task_ptr Pointer to task to stop.
+ */
+void WorkerPoolTaskStop(WorkerPoolTask* task_ptr);
+
+/**
+ * Initialize a join.
+ *
+ * @param join_ptr Pointer to join to initialize.
+ *
+ * @return true if successful, false if its resources could not be created.
+ */
+bool WorkerPoolJoinCreate(WorkerPoolJoin* join_ptr);
+
+/**
+ * Free the resources of a join. All of its join tasks must have been stopped using WorkerPoolJoinTaskStop().
+ *
+ * @param join_ptr Pointer to join. Does nothing if the join was zeroed and not created.
+ */
+void WorkerPoolJoinDestroy(WorkerPoolJoin* join_ptr);
+
+/**
+ * Initialize a join task and bind it to one of the threads in the worker pool.
+ *
+ * @param handle Handle of worker pool.
+ * @param join_ptr Pointer to the join the task belongs to.
+ * @param join_task_ptr Pointer to join task to initialize.
+ * @param func_ptr Function that does the work of the task.
+ * @param arg_ptr Argument to pass to func_ptr.
+ * @param log_handle Log to use while the task is running on a worker thread. If NULL, the global logger is used.
+ */
+void WorkerPoolJoinTaskInit(WorkerPoolHandle handle, WorkerPoolJoin* join_ptr, WorkerPoolJoinTask* join_task_ptr,
+                            WorkerPoolJoinFunction func_ptr, void* arg_ptr, CdiLogHandle log_handle);
+
+/**
+ * Start the work of a join task. Its function is invoked once, either by a worker thread or by WorkerPoolJoinWait().
+ * Data written by the caller before this call is visible to the function. Must only be called by the joining thread
+ * and not again for the same task before WorkerPoolJoinWait() has returned.
+ *
+ * @param join_task_ptr Pointer to join task.
+ */
+void WorkerPoolJoinTaskStart(WorkerPoolJoinTask* join_task_ptr);
+
+/**
+ * Stop a join task. Once this function returns, its function is not running on a worker thread.
+ *
+ * @param join_task_ptr Pointer to join task.
+ */
+void WorkerPoolJoinTaskStop(WorkerPoolJoinTask* join_task_ptr);
+
+/**
+ * Wait until the work of all of the join tasks started since the last wait is done. The work of tasks that no worker
+ * thread has started yet is done by the calling thread, so this function only waits for work that is already running.
+ *
+ * @param join_ptr Pointer to join.
+ */
+void WorkerPoolJoinWait(WorkerPoolJoin* join_ptr);
+
+#endif  // CDI_WORKER_POOL_H__
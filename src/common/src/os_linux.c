@@ -25,7 +25,12 @@
 #include <assert.h>
 #include <dirent.h>
 #include <errno.h>
+#include <linux/net_tstamp.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 #include <malloc.h>
+#include <net/if.h>
+#include <net/route.h>
 #include <netdb.h>
 #include <netinet/ip.h>
 #include <poll.h>
@@ -38,6 +43,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/uio.h>
@@ -123,6 +129,7 @@ struct SocketInfo
 {
     int fd; ///< Socket file descriptor
     struct sockaddr_in addr; ///< IP address and port
+    bool txtime_enabled; ///< True if SO_TXTIME has been enabled on the socket.
 };
 
 /// @brief Macro used within this file to handle generation of error messages either to the logger or stderr.
@@ -272,6 +279,114 @@ static bool SocketWrite(CdiSocket socket_handle, const struct msghdr* msg_ptr, i
     }
 }
 
+/**
+ * Get the index of the network interface through which IPv4 packets to an address leave the host, using the longest
+ * matching prefix of the kernel's main routing table.
+ *
+ * @param address Destination address, in network byte order.
+ *
+ * @return The interface index, or zero if it could not be determined.
+ */
+static unsigned int EgressInterfaceIndexGet(in_addr_t address)
+{
+    // Loopback addresses are routed through the local routing table, which /proc/net/route doesn't show.
+    if (127 == (ntohl(address) >> 24)) {
+        return if_nametoindex("lo");
+    }
+
+    FILE* file_ptr = fopen("/proc/net/route", "r");
+    if (NULL == file_ptr) {
+        return 0;
+    }
+
+    // Destinations and masks are printed as hexadecimal values of the network byte order addresses, so they compare
+    // directly with the address.
+    char line_str[256];
+    char best_name_str[IF_NAMESIZE] = { 0 };
+    int best_prefix_length = -1;
+    while (fgets(line_str, sizeof(line_str), file_ptr)) {
+        char name_str[IF_NAMESIZE] = { 0 };
+        unsigned int destination = 0;
+        unsigned int flags = 0;
+        unsigned int mask = 0;
+        if (4 == sscanf(line_str, "%15s %x %*x %x %*d %*d %*d %x", name_str, &destination, &flags, &mask) &&
+                (flags & RTF_UP) && (address & mask) == destination &&
+                __builtin_popcount(mask) > best_prefix_length) {
+            best_prefix_length = __builtin_popcount(mask);
+            CdiOsStrCpy(best_name_str, sizeof(best_name_str), name_str);
+        }
+    }
+    fclose(file_ptr);
+
+    return (best_prefix_length < 0) ? 0 : if_nametoindex(best_name_str);
+}
+
+/**
+ * Check the queuing disciplines of a network interface for one that honors the launch times set by SO_TXTIME (fq or
+ * etf), using a netlink dump of all of the queuing disciplines of the host.
+ *
+ * @param interface_index Index of the network interface.
+ * @param ret_found_ptr Address where to write true if such a queuing discipline was found.
+ *
+ * @return true if the queuing disciplines could be read, otherwise false.
+ */
+static bool InterfaceTxTimeQdiscFind(unsigned int interface_index, bool* ret_found_ptr)
+{
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct {
+        struct nlmsghdr header;
+        struct tcmsg message;
+    } request = {
+        .header = {
+            .nlmsg_len = NLMSG_LENGTH(sizeof(struct tcmsg)),
+            .nlmsg_type = RTM_GETQDISC,
+            .nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP,
+            .nlmsg_seq = 1,
+        },
+        .message = { .tcm_family = AF_UNSPEC },
+    };
+    bool ok = (send(fd, &request, request.header.nlmsg_len, 0) == (ssize_t)request.header.nlmsg_len);
+
+    *ret_found_ptr = false;
+    bool done = false;
+    uint32_t buffer_array[8192 / sizeof(uint32_t)]; // Aligned for struct nlmsghdr.
+    while (ok && !done) {
+        ssize_t byte_count = recv(fd, buffer_array, sizeof(buffer_array), 0);
+        ok = byte_count > 0;
+        int remaining = ok ? (int)byte_count : 0;
+        for (struct nlmsghdr* header_ptr = (struct nlmsghdr*)buffer_array; !done && NLMSG_OK(header_ptr, remaining);
+                header_ptr = NLMSG_NEXT(header_ptr, remaining)) {
+            if (NLMSG_DONE == header_ptr->nlmsg_type) {
+                done = true;
+            } else if (NLMSG_ERROR == header_ptr->nlmsg_type) {
+                ok = false;
+                done = true;
+            } else if (RTM_NEWQDISC == header_ptr->nlmsg_type) {
+                const struct tcmsg* message_ptr = NLMSG_DATA(header_ptr);
+                if ((unsigned int)message_ptr->tcm_ifindex != interface_index) {
+                    continue;
+                }
+                int attribute_length = header_ptr->nlmsg_len - NLMSG_LENGTH(sizeof(*message_ptr));
+                for (struct rtattr* attribute_ptr = TCA_RTA(message_ptr); RTA_OK(attribute_ptr, attribute_length);
+                        attribute_ptr = RTA_NEXT(attribute_ptr, attribute_length)) {
+                    if (TCA_KIND == attribute_ptr->rta_type) {
+                        const char* kind_str = RTA_DATA(attribute_ptr);
+                        *ret_found_ptr = *ret_found_ptr || 0 == strcmp(kind_str, "fq") ||
+                                         0 == strcmp(kind_str, "etf");
+                    }
+                }
+            }
+        }
+    }
+    close(fd);
+
+    return ok;
+}
+
 //*********************************************************************************************************************
 //******************************************* START OF PUBLIC FUNCTIONS ***********************************************
 //*********************************************************************************************************************
@@ -911,6 +1026,46 @@ bool CdiOsSignalsWait(CdiSignalType* signal_array, uint8_t num_signals, bool wai
     return return_val;
 }
 
+// -- Notification file descriptors --
+bool CdiOsNotificationFdCreate(int* ret_fd_ptr)
+{
+    assert(NULL != ret_fd_ptr);
+
+    // Non-blocking, so CdiOsNotificationFdClear() does not block if the descriptor is not set.
+    *ret_fd_ptr = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (-1 == *ret_fd_ptr) {
+        ERROR_MESSAGE("eventfd() failed. Error[%s]", strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+void CdiOsNotificationFdDelete(int fd)
+{
+    if (-1 != fd) {
+        close(fd);
+    }
+}
+
+void CdiOsNotificationFdSet(int fd)
+{
+    uint64_t value = 1;
+    // Adds to the eventfd's counter. The only possible error is the counter overflowing, which leaves it set.
+    if (sizeof(value) != write(fd, &value, sizeof(value))) {
+        // Nothing else to do.
+    }
+}
+
+void CdiOsNotificationFdClear(int fd)
+{
+    uint64_t value = 0;
+    // Reading resets the eventfd's counter to zero. Fails with EAGAIN if it was not set, which is fine.
+    if (sizeof(value) != read(fd, &value, sizeof(value))) {
+        // Nothing else to do.
+    }
+}
+
 // -- Memory --
 void* CdiOsMemAlloc(int32_t mem_size)
 {
@@ -1436,6 +1591,74 @@ bool CdiOsSocketWriteTo(CdiSocket socket_handle, struct iovec* iov, int iovcnt,
     return SocketWrite(socket_handle, &msg, byte_count_ptr);
 }
 
+bool CdiOsSocketTxTimeEnable(CdiSocket socket_handle)
+{
+#ifdef SO_TXTIME
+    SocketInfo* info_ptr = (SocketInfo*)socket_handle;
+
+    // Launch times are in the same time base as CdiOsGetMicroseconds().
+    const struct sock_txtime txtime_config = {
+        .clockid = kPreferredClock,
+        .flags = 0
+    };
+    info_ptr->txtime_enabled =
+        (0 == setsockopt(info_ptr->fd, SOL_SOCKET, SO_TXTIME, &txtime_config, sizeof(txtime_config)));
+    return info_ptr->txtime_enabled;
+#else
+    (void)socket_handle;
+    return false;
+#endif
+}
+
+bool CdiOsSocketTxTimeHonored(CdiSocket socket_handle)
+{
+    SocketInfo* info_ptr = (SocketInfo*)socket_handle;
+
+    // Only fq and etf use the launch times, other queuing disciplines send the packets right away. Multiqueue devices
+    // have one child queuing discipline per queue, so any fq or etf qdisc on the interface counts.
+    const unsigned int interface_index = EgressInterfaceIndexGet(info_ptr->addr.sin_addr.s_addr);
+    bool found = false;
+    if (0 == interface_index || !InterfaceTxTimeQdiscFind(interface_index, &found)) {
+        return true; // Unknown, so assume the host was set up for it.
+    }
+    return found;
+}
+
+bool CdiOsSocketWriteAt(CdiSocket socket_handle, struct iovec* iov, int iovcnt,
+                        const struct sockaddr_in* destination_address_ptr, uint64_t launch_time_microsecs,
+                        int* byte_count_ptr)
+{
+    SocketInfo* info_ptr = (SocketInfo*)socket_handle;
+
+    // Make a copy since msghdr.msg_name is non-const.
+    struct sockaddr_in address_copy = destination_address_ptr ? *destination_address_ptr : info_ptr->addr;
+    struct msghdr msg = {
+        .msg_name = &address_copy,
+        .msg_namelen = sizeof address_copy,
+        .msg_iov = iov,
+        .msg_iovlen = iovcnt
+    };
+
+#ifdef SO_TXTIME
+    // The kernel rejects SCM_TXTIME on sockets that SO_TXTIME has not been enabled on, so only add it when enabled.
+    char control_buffer[CMSG_SPACE(sizeof(uint64_t))] = { 0 };
+    if (info_ptr->txtime_enabled) {
+        msg.msg_control = control_buffer;
+        msg.msg_controllen = sizeof(control_buffer);
+        struct cmsghdr* cmsg_ptr = CMSG_FIRSTHDR(&msg);
+        cmsg_ptr->cmsg_level = SOL_SOCKET;
+        cmsg_ptr->cmsg_type = SCM_TXTIME;
+        cmsg_ptr->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        const uint64_t launch_time_nanosecs = launch_time_microsecs * 1000;
+        memcpy(CMSG_DATA(cmsg_ptr), &launch_time_nanosecs, sizeof(launch_time_nanosecs));
+    }
+#else
+    (void)launch_time_microsecs;
+#endif
+
+    return SocketWrite(socket_handle, &msg, byte_count_ptr);
+}
+
 bool CdiOsEnvironmentVariableSet(const char* name_str, const char* value_str)
 {
     if (NULL == value_str) {
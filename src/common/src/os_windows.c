@@ -793,6 +793,29 @@ bool CdiOsSignalsWait(CdiSignalType *signal_array, uint8_t num_signals, bool wai
     return return_val;
 }
 
+// -- Notification file descriptors --
+bool CdiOsNotificationFdCreate(int* ret_fd_ptr)
+{
+    assert(NULL != ret_fd_ptr);
+    *ret_fd_ptr = -1; // Not supported on Windows.
+    return true;
+}
+
+void CdiOsNotificationFdDelete(int fd)
+{
+    (void)fd;
+}
+
+void CdiOsNotificationFdSet(int fd)
+{
+    (void)fd;
+}
+
+void CdiOsNotificationFdClear(int fd)
+{
+    (void)fd;
+}
+
 // -- Memory --
 void* CdiOsMemAlloc(int32_t mem_size)
 {
@@ -1325,6 +1348,26 @@ bool CdiOsSocketWriteTo(CdiSocket socket_handle, struct iovec* iov, int iovcnt,
     }
 }
 
+bool CdiOsSocketTxTimeEnable(CdiSocket socket_handle)
+{
+    (void)socket_handle;
+    return false; // Scheduled transmission is not supported on Windows.
+}
+
+bool CdiOsSocketTxTimeHonored(CdiSocket socket_handle)
+{
+    (void)socket_handle;
+    return false; // Scheduled transmission is not supported on Windows.
+}
+
+bool CdiOsSocketWriteAt(CdiSocket socket_handle, struct iovec* iov, int iovcnt,
+                        const struct sockaddr_in* destination_address_ptr, uint64_t launch_time_microsecs,
+                        int* byte_count_ptr)
+{
+    (void)launch_time_microsecs;
+    return CdiOsSocketWriteTo(socket_handle, iov, iovcnt, destination_address_ptr, byte_count_ptr);
+}
+
 bool CdiOsEnvironmentVariableSet(const char* name_str, const char* value_str)
 {
     if (NULL == value_str) {
@@ -479,6 +479,76 @@ bool CdiQueuePush(CdiQueueHandle handle, const void* data_ptr)
     return ret;
 }
 
+int CdiQueuePushBatch(CdiQueueHandle handle, const void* item_array, int item_count)
+{
+    int count = 0;
+    QueueState* state_ptr = (QueueState*)handle;
+    const uint8_t* item_src_ptr = (const uint8_t*)item_array;
+
+    if (state_ptr->multiple_writer_cs) {
+        CdiOsCritSectionReserve(state_ptr->multiple_writer_cs);
+    }
+
+    // Use atomic operations to ensure latest memory is being read from.
+    CdiSinglyLinkedListEntry* entry_read_ptr =
+        (CdiSinglyLinkedListEntry*)CdiOsAtomicLoadPointer(&state_ptr->entry_read_ptr);
+    CdiSinglyLinkedListEntry* entry_write_ptr =
+        (CdiSinglyLinkedListEntry*)CdiOsAtomicLoadPointer(&state_ptr->entry_write_ptr);
+
+    while (count < item_count) {
+        CdiSinglyLinkedListEntry* new_write_ptr = CdiSinglyLinkedListNextEntry(entry_write_ptr);
+        if (new_write_ptr == entry_read_ptr) {
+            // Queue appears full. The reader may have made room since the read pointer was loaded, so check again.
+            entry_read_ptr = (CdiSinglyLinkedListEntry*)CdiOsAtomicLoadPointer(&state_ptr->entry_read_ptr);
+            if (new_write_ptr == entry_read_ptr) {
+                // Queue is full. Growing it inserts entries after the current write pointer, so first make the items
+                // copied so far visible to the reader. Then try to grow it.
+                CdiOsAtomicStorePointer(&state_ptr->entry_write_ptr, entry_write_ptr);
+                if (!QueueIncrease(handle)) {
+                    break;
+                }
+                new_write_ptr = CdiSinglyLinkedListNextEntry(entry_write_ptr);
+            }
+        }
+
+        uint8_t* item_dest_ptr = GetDataItemFromListEntry(entry_write_ptr);
+        memcpy(item_dest_ptr, item_src_ptr, state_ptr->queue_item_data_byte_size);
+        item_src_ptr += state_ptr->queue_item_data_byte_size;
+
+#ifdef DEBUG
+        const int current_occupancy = CdiOsAtomicInc32(&state_ptr->occupancy);
+
+        if (state_ptr->debug_cb_ptr) {
+            CdiQueueCbData cb_data = {
+                .is_pop = false,
+                .read_ptr = entry_read_ptr,
+                .write_ptr = entry_write_ptr,
+                .item_data_ptr = item_dest_ptr,
+                .occupancy = current_occupancy,
+            };
+            (state_ptr->debug_cb_ptr)(&cb_data);
+        }
+#endif
+        entry_write_ptr = new_write_ptr;
+        count++;
+    }
+
+    // Update the write pointer once for all of the items. Use an atomic operation to ensure the data written above by
+    // the memcpy has been completely written to memory before this variable gets changed.
+    CdiOsAtomicStorePointer(&state_ptr->entry_write_ptr, entry_write_ptr);
+
+    // If blockable pop was enabled upon creation, set the signal once to wake-up any waiting threads.
+    if (count && state_ptr->wake_pop_waiters_signal) {
+        CdiOsSignalSet(state_ptr->wake_pop_waiters_signal);
+    }
+
+    if (state_ptr->multiple_writer_cs) {
+        CdiOsCritSectionRelease(state_ptr->multiple_writer_cs);
+    }
+
+    return count;
+}
+
 bool CdiQueuePushWait(CdiQueueHandle handle, int timeout_ms, CdiSignalType abort_wait_signal, const void* item_ptr)
 {
     return CdiQueuePushWaitMultiple(handle, timeout_ms, &abort_wait_signal, 1, NULL, item_ptr);
@@ -496,15 +566,19 @@ bool CdiQueuePushWaitMultiple(CdiQueueHandle handle, int timeout_ms, CdiSignalTy
         return false;
     }
 
-    // Clear signal and then use the entry write/read pointers, in case another thread is using one of the Pop API
-    // functions.
-    CdiOsSignalClear(state_ptr->wake_push_waiters_signal);
-
-    CdiSinglyLinkedListEntry* new_write_ptr = CdiSinglyLinkedListNextEntry(state_ptr->entry_write_ptr);
-
     // Wait here until the entry is pushed, get an abort signal or a timeout.
-    while (ret && CdiQueuePush(handle, item_ptr)) {
-        // Queue is full, so setup to wait for an item to be popped from it.
+    while (ret) {
+        // Clear signal and then use the entry write/read pointers, in case another thread is using one of the Pop API
+        // functions.
+        CdiOsSignalClear(state_ptr->wake_push_waiters_signal);
+        if (CdiQueuePush(handle, item_ptr)) {
+            break;
+        }
+
+        // Queue is full, so setup to wait for an item to be popped from it. Other writers may have pushed since the
+        // write pointer was last read, so read it again.
+        CdiSinglyLinkedListEntry* new_write_ptr = CdiSinglyLinkedListNextEntry(
+            (CdiSinglyLinkedListEntry*)CdiOsAtomicLoadPointer(&state_ptr->entry_write_ptr));
         ret = WaitForSignals(&state_ptr->entry_read_ptr, new_write_ptr, state_ptr->wake_push_waiters_signal,
                              timeout_ms, signal_array, num_signals, ret_signal_index_ptr);
     }
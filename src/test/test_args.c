@@ -360,6 +360,11 @@ static OptDef my_options[] =
         "Refer to API documentation for a description of each buffer type."},
     { "lip",  "local_ip",     1, "<ip address>",     NULL,
         "Global option. Set the IP address of the local network adapter."},
+    { "rsb",  "rx_shared_buffers", 1, "<count>",     NULL,
+        "Global option. Set the number of receive packet buffers in the pool that the adapter\n"
+        "shares between the Rx connections that use --rx_shared_quota. This option sets\n"
+        "rx_shared_packet_buffers in the CdiAdapterData used to initialize the adapter. Its\n"
+        "default is 0, which has every connection reserve its own packet buffers."},
     { "dpt",  "dest_port",    1, "<port num>",       NULL,
         "Set a connection-specific destination port."},
     { "rip",  "remote_ip",    1, "<ip address>",     NULL,
@@ -382,12 +387,39 @@ static OptDef my_options[] =
         "Set the transmit timeout for a payload in this connection in microseconds. This\n"
         "option directly controls the max_latency_microsecs parameter in the\n"
         "Cdi..Tx..Payload() API function calls, and its default is set by --rate.\n"},
+    { "trc",  "tx_run_to_completion", 0, NULL,      NULL,
+        "For Tx connections, packetize payloads from the connection's poll thread just before\n"
+        "the adapter can send their packets, instead of from a separate payload thread. This\n"
+        "option sets run_to_completion in the CdiTxConfigData used when creating a connection."},
+    { "txs",  "tx_slices",    1, "<count>",          NULL,
+        "Send each payload of this AVM connection by opening it with CdiAvm..TxPayloadOpen()\n"
+        "and appending its data in <count> slices of about the same size with\n"
+        "CdiAvmTxPayloadAppend(), like a frame that is produced in horizontal slices. Its\n"
+        "default is 0, which sends each payload whole."},
     { "rbd",  "rx_buffer_delay",   1, "<milliseconds>",   NULL,
         "Set the receive buffer delay for a payload in this connection in milliseconds. This\n"
         "option directly controls the buffer_delay_ms setting in the CdiRxConfigData used when\n"
         "creating a connection, and its default is 0 or \"disabled\" (no buffer). To enable and\n"
         "use the SDK default value specify \"automatic\" (see CDI_ENABLED_RX_BUFFER_DELAY_DEFAULT_MS).\n"
         "The maximum allowable value is defined by CDI_MAXIMUM_RX_BUFFER_DELAY_MS."},
+    { "rrc",  "rx_run_to_completion", 1, "<microseconds>", NULL,
+        "For Rx connections, invoke the payload callback directly from the connection's poll\n"
+        "thread instead of from a separate callback thread. <microseconds> is the time budget\n"
+        "of the callback, or 0 for the SDK default (see CDI_RX_RUN_TO_COMPLETION_DEFAULT_BUDGET_US).\n"
+        "Callbacks over budget are reported in the final Rx stats. This option sets run_to_completion\n"
+        "and run_to_completion_budget_us in the CdiRxConfigData used when creating a connection. It\n"
+        "cannot be used with --rx_buffer_delay."},
+    { "rma",  "rx_rma_placement",  0, NULL,               NULL,
+        "For Rx connections that use the LINEAR buffer type, let the transmitter write the data\n"
+        "of each payload directly into a receive buffer using RMA writes. This option sets\n"
+        "rma_direct_placement in the CdiRxConfigData used when creating a connection. It is only\n"
+        "used by the EFA and SOCKET_LIBFABRIC adapters."},
+    { "rsq",  "rx_shared_quota",   1, "<count>",          NULL,
+        "For Rx connections, receive packets into buffers taken from the pool that the adapter\n"
+        "shares between connections (see --rx_shared_buffers) instead of reserving packet buffers\n"
+        "for the connection. <count> is the most buffers of the pool that the connection may hold\n"
+        "at once. This option sets shared_rx_packet_quota in the CdiRxConfigData used when\n"
+        "creating a connection. It is only used by the EFA and SOCKET_LIBFABRIC adapters."},
     { "pat",  "pattern",      1, "<pattern choice>", patterns_key_array,
         "Choose a pattern mode for a stream's test data.\n"
         "All payloads will contain this same repeating pattern starting at the value given\n"
@@ -946,6 +978,13 @@ static bool VerifyTestSettings(TestSettings* const test_settings_ptr) {
                                     test_settings_ptr->tx_timeout);
     }
 
+    // Payloads are only sent in slices by the AVM API.
+    if (test_settings_ptr->tx_slices && kProtocolTypeAvm != test_settings_ptr->connection_protocol) {
+        TestConsoleLog(kLogError, "Connection[%s]: The --tx_slices (-txs) option can only be used with AVM "
+                                  "connections.", connection_name_str);
+        arg_error = true;
+    }
+
     // Check the log file name.
     if (GetGlobalTestSettings()->base_log_filename_str) {
         TestConsoleLog(kLogInfo, "Connection[%s]: No --log argument given, logging to console.", connection_name_str);
@@ -994,6 +1033,33 @@ static bool VerifyTestSettings(TestSettings* const test_settings_ptr) {
         test_settings_ptr->buffer_type = kCdiSgl;
     }
 
+    if (test_settings_ptr->tx_run_to_completion && !test_settings_ptr->tx) {
+        TestConsoleLog(kLogError, "Connection[%s]: The --tx_run_to_completion (-trc) option can only be used with Tx "
+                                  "connections.", connection_name_str);
+        arg_error = true;
+    }
+
+    if (test_settings_ptr->rx_run_to_completion &&
+        (!test_settings_ptr->rx || 0 != test_settings_ptr->rx_buffer_delay_ms)) {
+        TestConsoleLog(kLogError, "Connection[%s]: The --rx_run_to_completion (-rrc) option can only be used with Rx "
+                                  "connections that don't use --rx_buffer_delay (-rbd).", connection_name_str);
+        arg_error = true;
+    }
+
+    // Payloads are only written directly into linear receive buffers.
+    if (test_settings_ptr->rx_rma_placement &&
+        (!test_settings_ptr->rx || kCdiLinearBuffer != test_settings_ptr->buffer_type)) {
+        TestConsoleLog(kLogError, "Connection[%s]: The --rx_rma_placement (-rma) option can only be used with Rx "
+                                  "connections that use the LINEAR buffer type.", connection_name_str);
+        arg_error = true;
+    }
+
+    if (test_settings_ptr->rx_shared_quota && !test_settings_ptr->rx) {
+        TestConsoleLog(kLogError, "Connection[%s]: The --rx_shared_quota (-rsq) option can only be used with Rx "
+                                  "connections.", connection_name_str);
+        arg_error = true;
+    }
+
     if (0 == test_settings_ptr->number_of_streams) {
         TestConsoleLog(kLogError, "Connection[%s]: You must create at least one stream for this connection using the "
                                   "--new_stream (-S) option", connection_name_str);
@@ -1267,6 +1333,14 @@ static bool ParseGlobalOptions(int argc, const char** argv_ptr, OptArg* opt_ptr)
                     }
                 }
                 break;
+            case kTestOptionRxSharedBuffers:
+                if (!IsBase10Number(opt_ptr->args_array[0], &adapter_data_ptr->rx_shared_packet_buffers) ||
+                        adapter_data_ptr->rx_shared_packet_buffers < 0) {
+                    TestConsoleLog(kLogError, "Invalid --rx_shared_buffers (-rsb) argument [%s].",
+                                   opt_ptr->args_array[0]);
+                    arg_error = true;
+                }
+                break;
             case kTestOptionConnectionTimeout:
                 if(!IsIntStringValid(opt_ptr->args_array[0], &global_test_settings_ptr->connection_timeout_seconds)) {
                     TestConsoleLog(kLogWarning, "Invalid --conn_timeout (-ct) argument [%s].", opt_ptr->args_array[0]);
@@ -1482,11 +1556,28 @@ void PrintTestSettings(const TestSettings* const test_settings_ptr, const int nu
         TestConsoleLog(kLogInfo, "    Rate         : %d/%d", test_settings_ptr[i].rate_numerator,
                        test_settings_ptr[i].rate_denominator);
         TestConsoleLog(kLogInfo, "    Tx Timeout   : %d", test_settings_ptr[i].tx_timeout);
+        if (test_settings_ptr[i].tx_run_to_completion) {
+            TestConsoleLog(kLogInfo, "    Tx Packetize : inline");
+        }
+        if (test_settings_ptr[i].tx_slices) {
+            TestConsoleLog(kLogInfo, "    Tx Slices    : %d", test_settings_ptr[i].tx_slices);
+        }
         if (-1 == test_settings_ptr[i].rx_buffer_delay_ms) {
             TestConsoleLog(kLogInfo, "    Rx Buf Delay : -1 (enabled automatic default [%d]ms)", CDI_ENABLED_RX_BUFFER_DELAY_DEFAULT_MS);
         } else {
             TestConsoleLog(kLogInfo, "    Rx Buf Delay : %d", test_settings_ptr[i].rx_buffer_delay_ms);
         }
+        if (test_settings_ptr[i].rx_run_to_completion) {
+            TestConsoleLog(kLogInfo, "    Rx Callback  : inline, budget[%d]us",
+                           test_settings_ptr[i].rx_run_to_completion_budget_us);
+        }
+        if (test_settings_ptr[i].rx_rma_placement) {
+            TestConsoleLog(kLogInfo, "    Rx RMA       : %s", CdiUtilityBoolToString(true));
+        }
+        if (test_settings_ptr[i].rx_shared_quota) {
+            TestConsoleLog(kLogInfo, "    Rx Quota     : %d of [%d] shared buffers",
+                           test_settings_ptr[i].rx_shared_quota, adapter_data_ptr->rx_shared_packet_buffers);
+        }
         TestConsoleLog(kLogInfo, "    Stats Period : %d", test_settings_ptr[i].stats_period_seconds);
         TestConsoleLog(kLogInfo, "    # of Streams : %d", test_settings_ptr[i].number_of_streams);
         for (int j=0; j<test_settings_ptr[i].number_of_streams; j++) {
@@ -2050,6 +2141,16 @@ ProgramExecutionStatus GetArgs(int argc, const char** argv_ptr, TestSettings* te
                     arg_error = true;
                 }
                 break;
+            case kTestOptionTxRunToCompletion:
+                test_settings_ptr[connection_index].tx_run_to_completion = true;
+                break;
+            case kTestOptionTxSlices:
+                if (!IsBase10Number(opt.args_array[0], &test_settings_ptr[connection_index].tx_slices) ||
+                        test_settings_ptr[connection_index].tx_slices < 0) {
+                    TestConsoleLog(kLogError, "Invalid --tx_slices (-txs) argument [%s].", opt.args_array[0]);
+                    arg_error = true;
+                }
+                break;
             case kTestOptionRxBufferDelay:
                 if (0 == CdiOsStrCaseCmp(opt.args_array[0], "automatic")) {
                     test_settings_ptr[connection_index].rx_buffer_delay_ms = -1; // -1= Use automatic SDK value.
@@ -2066,6 +2167,26 @@ ProgramExecutionStatus GetArgs(int argc, const char** argv_ptr, TestSettings* te
                     }
                 }
                 break;
+            case kTestOptionRxRunToCompletion:
+                test_settings_ptr[connection_index].rx_run_to_completion = true;
+                if (!IsBase10Number(opt.args_array[0],
+                                    &test_settings_ptr[connection_index].rx_run_to_completion_budget_us) ||
+                        test_settings_ptr[connection_index].rx_run_to_completion_budget_us < 0) {
+                    TestConsoleLog(kLogError, "Invalid --rx_run_to_completion (-rrc) argument [%s].",
+                                   opt.args_array[0]);
+                    arg_error = true;
+                }
+                break;
+            case kTestOptionRxRmaPlacement:
+                test_settings_ptr[connection_index].rx_rma_placement = true;
+                break;
+            case kTestOptionRxSharedQuota:
+                if (!IsBase10Number(opt.args_array[0], &test_settings_ptr[connection_index].rx_shared_quota) ||
+                        test_settings_ptr[connection_index].rx_shared_quota < 0) {
+                    TestConsoleLog(kLogError, "Invalid --rx_shared_quota (-rsq) argument [%s].", opt.args_array[0]);
+                    arg_error = true;
+                }
+                break;
             case kTestOptionPattern:
                 stream_settings_ptr->pattern_type = TestPatternStringToEnum(opt.args_array[0]);
                 if (CDI_INVALID_ENUM_VALUE == (int)stream_settings_ptr->pattern_type) {
@@ -2164,6 +2285,7 @@ ProgramExecutionStatus GetArgs(int argc, const char** argv_ptr, TestSettings* te
             case kTestOptionUseStderr:
             case kTestOptionMultiWindowConsole:
             case kTestOptionLocalIP:
+            case kTestOptionRxSharedBuffers:
             case kTestOptionAdapter:
             case kTestOptionHelp:
             case kTestOptionHelpVideo:
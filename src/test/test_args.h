@@ -81,6 +81,7 @@ typedef enum {
     kTestOptionAdapter,
     kTestOptionBufferType,
     kTestOptionLocalIP,
+    kTestOptionRxSharedBuffers,
     kTestOptionDestPort,
     kTestOptionRemoteIP,
     kTestOptionShareThread,
@@ -89,7 +90,12 @@ typedef enum {
     kTestOptionNumTransactions,
     kTestOptionRate,
     kTestOptionTxTimeout,
+    kTestOptionTxRunToCompletion,
+    kTestOptionTxSlices,
     kTestOptionRxBufferDelay,
+    kTestOptionRxRunToCompletion,
+    kTestOptionRxRmaPlacement,
+    kTestOptionRxSharedQuota,
     kTestOptionPattern,
     kTestOptionPatternStart,
     kTestOptionUseRiffFile,
@@ -197,8 +203,23 @@ typedef struct {
     int video_anc_ptp_periods_per_payload;
     /// The transmit timeout in microseconds for a tx payload.
     int tx_timeout;
+    /// When true, tx payloads are packetized by the connection's poll thread instead of by a separate payload thread.
+    bool tx_run_to_completion;
+    /// The number of slices in which the data of each tx payload is appended to it after it has been opened. Zero if
+    /// payloads are sent whole.
+    int tx_slices;
     /// The receive buffer delay in milliseconds for a rx payload.
     int rx_buffer_delay_ms;
+    /// When true, the rx payload callback is invoked directly from the connection's poll thread.
+    bool rx_run_to_completion;
+    /// Time budget in microseconds of the rx payload callback when rx_run_to_completion is true. Zero for the SDK
+    /// default.
+    int rx_run_to_completion_budget_us;
+    /// When true, the transmitter writes rx payloads directly into linear receive buffers using RMA.
+    bool rx_rma_placement;
+    /// The most buffers of the adapter's shared receive pool that the rx connection may hold. Zero if it reserves its
+    /// own packet buffers.
+    int rx_shared_quota;
     /// When true, there was an error in one or more of the command line arguments that are used to create this data
     /// structure.
     bool arg_error;
@@ -1086,6 +1086,11 @@ CDI_THREAD TestRxCreateThread(void* arg_ptr)
     connection_info_ptr->config_data.rx.thread_core_num = test_settings_ptr->thread_core_num;
     connection_info_ptr->config_data.rx.rx_buffer_type = test_settings_ptr->buffer_type;
     connection_info_ptr->config_data.rx.buffer_delay_ms = test_settings_ptr->rx_buffer_delay_ms;
+    connection_info_ptr->config_data.rx.run_to_completion = test_settings_ptr->rx_run_to_completion;
+    connection_info_ptr->config_data.rx.run_to_completion_budget_us =
+        test_settings_ptr->rx_run_to_completion_budget_us;
+    connection_info_ptr->config_data.rx.rma_direct_placement = test_settings_ptr->rx_rma_placement;
+    connection_info_ptr->config_data.rx.shared_rx_packet_quota = test_settings_ptr->rx_shared_quota;
     // Find the largest payload size of all of the streams, and set the linear_buffer_size to be that size.
     int max_payload_size = test_settings_ptr->stream_settings[0].payload_size;
     for (int i=1; i<test_settings_ptr->number_of_streams; i++) {
@@ -1227,6 +1232,10 @@ CDI_THREAD TestRxCreateThread(void* arg_ptr)
         total_stats.num_payloads_transferred += connection_info_ptr->payload_counter_stats_array[i].num_payloads_transferred;
         total_stats.num_payloads_dropped += connection_info_ptr->payload_counter_stats_array[i].num_payloads_dropped;
         total_stats.num_payloads_late += connection_info_ptr->payload_counter_stats_array[i].num_payloads_late;
+        total_stats.num_callbacks_over_budget +=
+            connection_info_ptr->payload_counter_stats_array[i].num_callbacks_over_budget;
+        total_stats.num_payloads_rma_placed +=
+            connection_info_ptr->payload_counter_stats_array[i].num_payloads_rma_placed;
     }
     const CdiPayloadCounterStats* counter_stats_ptr = &total_stats;
 
@@ -1239,7 +1248,13 @@ CDI_THREAD TestRxCreateThread(void* arg_ptr)
     CDI_LOG_MULTILINE(&handle, "Number of payloads transferred[%"PRIu64"]", counter_stats_ptr->num_payloads_transferred);
     CDI_LOG_MULTILINE(&handle, "Number of payloads dropped    [%"PRIu64"]", counter_stats_ptr->num_payloads_dropped);
     CDI_LOG_MULTILINE(&handle, "Number of payloads late       [%"PRIu64"]", counter_stats_ptr->num_payloads_late);
+    CDI_LOG_MULTILINE(&handle, "Callbacks over budget         [%"PRIu64"]",
+                      counter_stats_ptr->num_callbacks_over_budget);
     CDI_LOG_MULTILINE(&handle, "Number of payload errors      [%"PRIu64"]", connection_info_ptr->num_payload_errors);
+    if (test_settings_ptr->rx_rma_placement) {
+        CDI_LOG_MULTILINE(&handle, "Number of payloads RMA placed [%"PRIu64"]",
+                          counter_stats_ptr->num_payloads_rma_placed);
+    }
     CDI_LOG_MULTILINE_END(&handle);
 
     // Destroy resources if they got created above.
@@ -201,6 +201,60 @@ static bool ValidateSgl(CdiSgList const* sgl_ptr, CdiBufferType buffer_type, int
     return sgl_ok;
 }
 
+/**
+ * Append the data of a payload that was opened with CdiAvmTxPayloadOpen() or CdiAvmEndpointTxPayloadOpen() in slices
+ * of about the same size, like a frame that is produced in horizontal slices. A slice that spans several SGL entries is
+ * appended one entry at a time.
+ *
+ * @param   payload_handle  Handle of the opened payload.
+ * @param   sgl_ptr  Pointer to the SGL holding the payload's data.
+ * @param   slice_count  Number of slices.
+ *
+ * @return  True if all of the data was appended, false if the payload was dropped or flushed meanwhile or an error
+ *          occurred. Either way, the Tx callback for the payload is made.
+ */
+static bool TestTxAppendSlices(CdiTxPayloadHandle payload_handle, const CdiSgList* sgl_ptr, int slice_count)
+{
+    const int total_size = sgl_ptr->total_data_size;
+    int slice_index = 0;
+    int offset = 0; // Offset in the payload of the data that is appended next.
+    for (const CdiSglEntry* entry_ptr = sgl_ptr->sgl_head_ptr; entry_ptr; entry_ptr = entry_ptr->next_ptr) {
+        int entry_offset = 0;
+        while (entry_offset < entry_ptr->size_in_bytes) {
+            const int slice_end = (int)(((int64_t)total_size * (slice_index + 1)) / slice_count);
+            const int size = cdi_min(entry_ptr->size_in_bytes - entry_offset, slice_end - offset);
+            if (size <= 0) {
+                slice_index++;
+                continue;
+            }
+            CdiSglEntry slice_entry = {
+                .address_ptr = (uint8_t*)entry_ptr->address_ptr + entry_offset,
+                .size_in_bytes = size
+            };
+            CdiSgList slice_sgl = {
+                .total_data_size = size,
+                .sgl_head_ptr = &slice_entry,
+                .sgl_tail_ptr = &slice_entry
+            };
+            CdiReturnStatus rs = CdiAvmTxPayloadAppend(payload_handle, &slice_sgl);
+            while (kCdiStatusAllocationFailed == rs) {
+                // Wait for the SDK to free the SGL entries of payloads that have completed.
+                CdiOsSleepMicroseconds(100);
+                rs = CdiAvmTxPayloadAppend(payload_handle, &slice_sgl);
+            }
+            if (kCdiStatusOk != rs) {
+                CDI_LOG_THREAD(kLogError, "Failed to append a slice of a payload. Reason[%s].",
+                               CdiCoreStatusToString(rs));
+                return false;
+            }
+            entry_offset += size;
+            offset += size;
+        }
+    }
+
+    return true;
+}
+
 /**
  * Construct a payload of the requested type and send it to the SDK.
  *
@@ -340,7 +394,23 @@ static CdiReturnStatus TestTxSendPayload(TestConnectionInfo* connection_info_ptr
 
             CdiAvmConfig* avm_config_ptr = send_config ? &stream_settings_ptr->avm_config : NULL;
 
-            if (test_settings_ptr->multiple_endpoints) {
+            if (test_settings_ptr->tx_slices) {
+                // Open the payload before any of its data is appended, then append it in slices. Once the payload is
+                // open, the Tx callback frees its resources, even if not all of the data could be appended.
+                CdiTxPayloadHandle payload_handle;
+                if (test_settings_ptr->multiple_endpoints) {
+                    rs = CdiAvmEndpointTxPayloadOpen(
+                        connection_info_ptr->tx_stream_endpoint_handle_array[stream_index], &payload_cfg_data,
+                        avm_config_ptr, sgl_ptr->total_data_size, test_settings_ptr->tx_timeout, &payload_handle);
+                } else {
+                    rs = CdiAvmTxPayloadOpen(connection_info_ptr->connection_handle, &payload_cfg_data, avm_config_ptr,
+                                             sgl_ptr->total_data_size, test_settings_ptr->tx_timeout,
+                                             &payload_handle);
+                }
+                if (kCdiStatusOk == rs) {
+                    TestTxAppendSlices(payload_handle, sgl_ptr, test_settings_ptr->tx_slices);
+                }
+            } else if (test_settings_ptr->multiple_endpoints) {
                 rs = CdiAvmEndpointTxPayload(connection_info_ptr->tx_stream_endpoint_handle_array[stream_index],
                                              &payload_cfg_data, avm_config_ptr, sgl_ptr, test_settings_ptr->tx_timeout);
             } else {
@@ -914,6 +984,7 @@ CDI_THREAD TestTxCreateThread(void* arg_ptr)
         connection_info_ptr->config_data.tx.shared_thread_id = test_settings_ptr->shared_thread_id;
         connection_info_ptr->config_data.tx.thread_core_num = test_settings_ptr->thread_core_num;
         connection_info_ptr->config_data.tx.connection_log_method_data_ptr = &log_method_data;
+        connection_info_ptr->config_data.tx.run_to_completion = test_settings_ptr->tx_run_to_completion;
 
         // Configure connection callback.
         connection_info_ptr->config_data.tx.connection_cb_ptr = TestConnectionCallback;
@@ -1036,6 +1107,8 @@ CDI_THREAD TestTxCreateThread(void* arg_ptr)
         total_stats.num_payloads_transferred += connection_info_ptr->payload_counter_stats_array[i].num_payloads_transferred;
         total_stats.num_payloads_dropped += connection_info_ptr->payload_counter_stats_array[i].num_payloads_dropped;
         total_stats.num_payloads_late += connection_info_ptr->payload_counter_stats_array[i].num_payloads_late;
+        total_stats.num_payloads_dropped_early +=
+            connection_info_ptr->payload_counter_stats_array[i].num_payloads_dropped_early;
     }
     const CdiPayloadCounterStats* counter_stats_ptr = &total_stats;
 
@@ -1052,6 +1125,11 @@ CDI_THREAD TestTxCreateThread(void* arg_ptr)
     // actually complete the transfer.
     CDI_LOG_MULTILINE(&handle, "Number of payloads late       [%"PRIu64"]", counter_stats_ptr->num_payloads_late);
 
+    // This value is the number of payloads that the SDK dropped before sending them because they could no longer
+    // arrive in time (only when deadline scheduling is enabled).
+    CDI_LOG_MULTILINE(&handle, "Number of payloads dropped early [%"PRIu64"]",
+                      counter_stats_ptr->num_payloads_dropped_early);
+
     // This value is the number of payloads that were delayed from being queued to be sent because a previous payload
     // being transmitted did not complete the transfer in time. We currently don't have a way to cancel a pending
     // transfer, so we had to wait for it to complete before starting transfer of the next payload.